@@ -68,7 +68,7 @@ public:
 
     // Sanity check.
     static_assert(
-        std::is_arithmetic<T>::value,
+        std::is_arithmetic<simd_value_type_t<T>>::value,
         "T must be arithmetic");
 
     /**
@@ -85,7 +85,8 @@ public:
      * @brief Float type.
      */
     typedef std::conditional_t<
-            std::is_floating_point<T>::value, T, double> float_type;
+            std::is_floating_point<
+            simd_value_type_t<T>>::value, T, double> float_type;
 
 public:
 
@@ -434,7 +435,7 @@ template <typename T, std::size_t N>
 __attribute__((always_inline))
 inline aabb<T, N> operator|(const aabb<T, N>& box0, const aabb<T, N>& box1)
 {
-    if constexpr (std::is_floating_point<T>::value) {
+    if constexpr (std::is_floating_point<simd_value_type_t<T>>::value) {
         return {
             pre::fmin(box0[0], box1[0]),
             pre::fmax(box0[1], box1[1])
@@ -455,7 +456,7 @@ template <typename T, std::size_t N>
 __attribute__((always_inline))
 inline aabb<T, N> operator&(const aabb<T, N>& box0, const aabb<T, N>& box1)
 {
-    if constexpr (std::is_floating_point<T>::value) {
+    if constexpr (std::is_floating_point<simd_value_type_t<T>>::value) {
         return {
             pre::fmax(box0[0], box1[0]),
             pre::fmin(box0[1], box1[1])
@@ -39,14 +39,23 @@
 #ifndef PREFORM_AABBTREE_USE_THREADS
 #define PREFORM_AABBTREE_USE_THREADS 1
 #endif // PREFORM_AABBTREE_USE_THREADS
+#ifndef PREFORM_AABBTREE_COUNTERS
+#define PREFORM_AABBTREE_COUNTERS 0
+#endif // #ifndef PREFORM_AABBTREE_COUNTERS
 #endif // #if !DOXYGEN
 
 // for assert
 #include <cassert>
 
-// for std::uint32_t, std::uint8_t
+// for std::uint32_t, std::uint8_t, std::uint64_t, std::uintptr_t
 #include <cstdint>
 
+// for std::memcmp, std::memcpy, std::memset
+#include <cstring>
+
+// for std::signbit, std::floor, std::ceil
+#include <cmath>
+
 // for std::array
 #include <array>
 
@@ -56,19 +65,34 @@
 // for std::vector
 #include <vector>
 
-// for std::pair
+// for std::min, std::partition, std::partition_point
+#include <algorithm>
+
+// for std::is_invocable_r
+#include <type_traits>
+
+// for std::pair, std::swap, std::forward
 #include <utility>
 
-#if PREFORM_AABBTREE_USE_THREADS
+// for std::tie
+#include <tuple>
+
+// for std::istream
+#include <istream>
+
+// for std::ostream
+#include <ostream>
+
+// for std::runtime_error
+#include <stdexcept>
 
-// for std::thread
-#include <thread>
+#if PREFORM_AABBTREE_USE_THREADS
 
 // for std::mutex
 #include <mutex>
 
-// for std::future, std::async
-#include <future>
+// for pre::thread_pool, pre::task_group
+#include <preform/thread_pool.hpp>
 
 #endif // #if PREFORM_AABBTREE_USE_THREADS
 
@@ -78,11 +102,28 @@
 // for pre::static_stack
 #include <preform/static_stack.hpp>
 
+// for pre::first1, pre::morton_encode2, pre::morton_encode3
+#include <preform/misc_int.hpp>
+
 // for pre::aabb, pre::multi
 #include <preform/aabb.hpp>
 
+// for pre::byte_order, pre::byte_stream, pre::byte_swap
+#include <preform/byte_order.hpp>
+
+// for PREFORM_PROFILE_ZONE
+#include <preform/profile.hpp>
+
 namespace pre {
 
+#if !PREFORM_AABBTREE_USE_THREADS && !DOXYGEN
+
+class thread_pool;
+
+class task_group;
+
+#endif // #if !PREFORM_AABBTREE_USE_THREADS && !DOXYGEN
+
 /**
  * @defgroup aabbtree Axis-aligned bounding box tree
  *
@@ -92,6 +133,220 @@ namespace pre {
  */
 /**@{*/
 
+/**
+ * @brief Tree statistics.
+ *
+ * Reported by `aabbtree::stats()`, to compare split modes and
+ * leaf cutoffs by measurement.
+ */
+struct aabbtree_stats
+{
+    /**
+     * @brief Branch count.
+     */
+    std::size_t branch_count = 0;
+
+    /**
+     * @brief Leaf count.
+     */
+    std::size_t leaf_count = 0;
+
+    /**
+     * @brief Proxy count, over all leaves.
+     */
+    std::size_t proxy_count = 0;
+
+    /**
+     * @brief Maximum leaf depth, where the root is at depth 0.
+     */
+    std::size_t max_depth = 0;
+
+    /**
+     * @brief Surface area heuristic cost.
+     *
+     * That is,
+     * @f[
+     *      C = \frac{1}{S_{\text{root}}} \left(
+     *          c_t \sum_{\text{branches}} S +
+     *          c_i \sum_{\text{leaves}} S n \right)
+     * @f]
+     * for traversal cost @f$ c_t @f$, intersection cost @f$ c_i @f$,
+     * and leaf proxy counts @f$ n @f$. This is the expected cost of
+     * a random ray through the root box.
+     */
+    double sah_cost = 0;
+
+    /**
+     * @brief Overlap ratio.
+     *
+     * The surface area of the overlap of the children of each branch,
+     * summed over branches, relative to the summed surface area of the
+     * branches themselves. This is 0 if no siblings overlap.
+     */
+    double overlap_ratio = 0;
+
+    /**
+     * @brief Leaf count at each depth.
+     */
+    std::vector<std::size_t> depth_histogram;
+
+    /**
+     * @brief Leaf count at each proxy count.
+     */
+    std::vector<std::size_t> leaf_size_histogram;
+};
+
+/**
+ * @brief Per-thread traversal counters.
+ *
+ * Queries on `aabbtree`, `linear_aabbtree`, `wide_aabbtree`,
+ * and `quantized_linear_aabbtree` accumulate into the counters
+ * of the calling thread only if `PREFORM_AABBTREE_COUNTERS` is
+ * defined to 1. By default it is 0, and the counting compiles
+ * out entirely.
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~{cpp}
+ * pre::aabbtree_counters::local().clear();
+ * tree.ray_closest_hit(ray_org, ray_dir, 0, ray_tmax, func);
+ * std::cout << pre::aabbtree_counters::local().nodes_visited;
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+struct aabbtree_counters
+{
+    /**
+     * @brief Nodes visited, that is, tested against the query.
+     */
+    std::uint64_t nodes_visited = 0;
+
+    /**
+     * @brief Primitives tested, that is, calls to the query function.
+     */
+    std::uint64_t primitives_tested = 0;
+
+    /**
+     * @brief Maximum traversal stack depth.
+     */
+    std::uint64_t max_stack_depth = 0;
+
+    /**
+     * @brief Clear.
+     */
+    void clear()
+    {
+        *this = aabbtree_counters();
+    }
+
+    /**
+     * @brief Counters of calling thread.
+     */
+    static aabbtree_counters& local()
+    {
+        thread_local aabbtree_counters counters;
+        return counters;
+    }
+};
+
+#if !DOXYGEN
+
+/**
+ * @brief Count node visit, if counters enabled.
+ */
+__attribute__((always_inline))
+inline void aabbtree_count_node_(std::size_t stack_depth)
+{
+#if PREFORM_AABBTREE_COUNTERS
+    aabbtree_counters& counters = aabbtree_counters::local();
+    counters.nodes_visited++;
+    if (counters.max_stack_depth < stack_depth) {
+        counters.max_stack_depth = stack_depth;
+    }
+#else
+    (void) stack_depth;
+#endif // #if PREFORM_AABBTREE_COUNTERS
+}
+
+/**
+ * @brief Count primitive test, if counters enabled.
+ */
+__attribute__((always_inline))
+inline void aabbtree_count_primitive_()
+{
+#if PREFORM_AABBTREE_COUNTERS
+    aabbtree_counters::local().primitives_tested++;
+#endif // #if PREFORM_AABBTREE_COUNTERS
+}
+
+/**
+ * @brief Traversal stack.
+ *
+ * Static stack of `Nstatic` entries, spilling onto the heap only if
+ * full. Trees built in one pass rarely exceed the static capacity,
+ * but trees grown by dynamic inserts have no depth bound.
+ */
+template <typename T, std::size_t Nstatic>
+class aabbtree_stack_
+{
+public:
+
+    /**
+     * @brief Empty?
+     */
+    bool empty() const noexcept
+    {
+        return stack_.empty();
+    }
+
+    /**
+     * @brief Size.
+     */
+    std::size_t size() const noexcept
+    {
+        return stack_.size() + heap_.size();
+    }
+
+    /**
+     * @brief Push.
+     */
+    void push(const T& val)
+    {
+        if (!stack_.full()) {
+            stack_.push(val);
+        }
+        else {
+            heap_.push_back(val);
+        }
+    }
+
+    /**
+     * @brief Pop.
+     */
+    T pop()
+    {
+        if (heap_.empty()) {
+            return stack_.pop();
+        }
+        else {
+            T val = heap_.back();
+            heap_.pop_back();
+            return val;
+        }
+    }
+
+private:
+
+    /**
+     * @brief Static stack, filled first.
+     */
+    static_stack<T, Nstatic> stack_;
+
+    /**
+     * @brief Heap stack, used only while static stack is full.
+     */
+    std::vector<T> heap_;
+};
+
+#endif // #if !DOXYGEN
+
 /**
  * @brief Axis-aligned bounding box tree.
  *
@@ -206,6 +461,11 @@ public:
          * @brief If leaf, proxy count.
          */
         size_type count;
+
+        /**
+         * @brief Parent, maintained only after the first dynamic update.
+         */
+        node_type* parent;
     };
 
     /**
@@ -233,6 +493,12 @@ public:
 
 public:
 
+    /**
+     * @brief Proxy count above which builds given a thread pool
+     * divide work into tasks.
+     */
+    static constexpr size_type parallel_cutoff = 16384;
+
     /**
      * @brief Default constructor.
      */
@@ -300,43 +566,41 @@ public:
             Tinput_itr to,
             Tfunc&& func)
     {
-        // Clear.
-        clear();
-
-        // Count.
-        typename
-        std::iterator_traits<Tinput_itr>::difference_type
-            count = std::distance(from, to);
-        if (count < decltype(count)(1)) {
-            return;
-        }
+        init_<false>(nullptr, from, to, std::forward<Tfunc>(func));
+    }
 
-        // Initialize proxies.
-        size_type value_index = 0;
-        proxies_.reserve(count);
-        while (from != to) {
-            aabb_type box = std::forward<Tfunc>(func)(*from);
-            assert((box[0] < box[1]).all());
-            proxies_.emplace_back(
-            proxy_type{
-                value_index,
-                box,
-                box.center()
-            });
-            ++value_index;
-            ++from;
-        }
+#if PREFORM_AABBTREE_USE_THREADS || DOXYGEN
 
-        // Initialize.
-        size_type first_index = 0;
-        root_ =
-        init_recursive(
-            first_index,
-            {&proxies_[0],
-             &proxies_[0] + proxies_.size()});
-        assert(first_index == proxies_.size());
+    /**
+     * @brief Initialize in parallel.
+     *
+     * @param[in] pool
+     * Thread pool. Subtrees above `parallel_cutoff` proxies
+     * are built as tasks, and bounds and split binning at the
+     * upper levels are divided into chunks.
+     *
+     * @param[in] from
+     * Input from.
+     *
+     * @param[in] to
+     * Input to.
+     *
+     * @param[in] func
+     * Function constructing an instance of `aabb_type` for each
+     * input element, as in `init()`.
+     */
+    template <typename Tinput_itr, typename Tfunc>
+    void init(
+            thread_pool& pool,
+            Tinput_itr from,
+            Tinput_itr to,
+            Tfunc&& func)
+    {
+        init_<false>(&pool, from, to, std::forward<Tfunc>(func));
     }
 
+#endif // #if PREFORM_AABBTREE_USE_THREADS || DOXYGEN
+
     /**
      * @brief Initialize with implicit conversion.
      */
@@ -349,57 +613,533 @@ public:
     }
 
     /**
-     * @brief Clear.
+     * @brief Initialize as linear bounding volume hierarchy.
+     *
+     * Sorts proxies by the Morton codes of their box centers, then
+     * splits each node at the highest bit in which the codes of its
+     * proxies differ. This ignores `Tsplit_mode`, and is much cheaper
+     * than surface area splits, at some cost in tree quality, so is
+     * suited to trees rebuilt every frame.
+     *
+     * @param[in] from
+     * Input from.
+     *
+     * @param[in] to
+     * Input to.
+     *
+     * @param[in] func
+     * Function constructing an instance of `aabb_type` for each
+     * input element, as in `init()`.
      */
-    void clear()
+    template <typename Tinput_itr, typename Tfunc>
+    void init_morton(
+            Tinput_itr from,
+            Tinput_itr to,
+            Tfunc&& func)
     {
-        // Destroy root.
-        deallocate_recursive(root_);
-        root_ = nullptr;
-        node_count_ = 0;
-
-        // Destroy proxies.
-        proxies_.clear();
-        proxies_.shrink_to_fit();
+        init_<true>(nullptr, from, to, std::forward<Tfunc>(func));
     }
 
+#if PREFORM_AABBTREE_USE_THREADS || DOXYGEN
+
     /**
-     * @brief Sort values to match proxies.
+     * @brief Initialize as linear bounding volume hierarchy in parallel.
+     *
+     * @param[in] pool
+     * Thread pool. The radix sort of Morton codes runs in chunks, and
+     * subtrees above `parallel_cutoff` proxies are built as tasks.
      *
      * @param[in] from
-     * Forward from.
+     * Input from.
      *
      * @param[in] to
-     * Forward to.
+     * Input to.
+     *
+     * @param[in] func
+     * Function constructing an instance of `aabb_type` for each
+     * input element, as in `init()`.
      */
-    template <typename Tforward_itr>
-    void sort(
-            Tforward_itr from,
-            Tforward_itr to)
+    template <typename Tinput_itr, typename Tfunc>
+    void init_morton(
+            thread_pool& pool,
+            Tinput_itr from,
+            Tinput_itr to,
+            Tfunc&& func)
     {
-        assert(size_type(std::distance(from, to)) == proxies_.size());
-        std::vector<
-            typename std::iterator_traits<Tforward_itr>::value_type,
-            typename std::allocator_traits<Talloc>::
-            template rebind_alloc<
-                typename std::iterator_traits<Tforward_itr>::value_type>>
-                    values(from, to, node_alloc_);
-        for (size_type pos = 0; pos < proxies_.size(); pos++) {
-            *from++ = values[proxies_[pos].value_index];
+        init_<true>(&pool, from, to, std::forward<Tfunc>(func));
+    }
+
+#endif // #if PREFORM_AABBTREE_USE_THREADS || DOXYGEN
+
+    /**
+     * @brief Clear.
+     */
+    void clear()
+    {
+        // Destroy nodes.
+        for (auto& [block, block_size] : node_blocks_) {
+            node_alloc_.deallocate(block, block_size);
         }
+        node_blocks_.clear();
+        node_count_ = 0;
+        root_ = nullptr;
+
+        // Destroy proxies.
+        proxies_.clear();
+        proxies_.shrink_to_fit();
+
+        // Destroy dynamic state.
+        dynamic_ = false;
+        dynamic_cursor_ = node_cursor();
+        free_nodes_.clear();
+        free_proxies_.clear();
+        proxy_leaves_.clear();
+        value_proxies_.clear();
     }
 
 public:
 
     /**
-     * @name Accessors
+     * @name Dynamic updates
      */
     /**@{*/
 
     /**
-     * @brief Leaf cutoff.
+     * @brief Index meaning no proxy.
      */
-    size_type leaf_cutoff() const
+    static constexpr size_type npos = size_type(-1);
+
+    /**
+     * @brief Refit.
+     *
+     * Recomputes all node boxes bottom-up from proxy boxes, keeping
+     * the tree topology. This is linear in the node count, and
+     * appropriate after many proxies move a little.
+     */
+    void refit()
+    {
+        if (root_) {
+            refit_recursive(root_);
+        }
+    }
+
+    /**
+     * @brief Refit with new boxes.
+     *
+     * @param[in] from
+     * Input from, as in `init()`, which must be random access.
+     *
+     * @param[in] to
+     * Input to.
+     *
+     * @param[in] func
+     * Function constructing an instance of `aabb_type` for each
+     * input element, as in `init()`.
+     */
+    template <typename Tinput_itr, typename Tfunc>
+    void refit(
+            Tinput_itr from,
+            Tinput_itr to,
+            Tfunc&& func)
+    {
+        (void) to;
+        for (proxy_type& proxy : proxies_) {
+            if (proxy.value_index != npos) {
+                assert(proxy.value_index < size_type(to - from));
+                aabb_type box =
+                    std::forward<Tfunc>(func)(from[proxy.value_index]);
+                proxy.box = box;
+                proxy.box_center = box.center();
+            }
+        }
+        refit();
+    }
+
+    /**
+     * @brief Insert.
+     *
+     * Descends greedily towards the sibling which least increases
+     * surface area, pairs the new leaf with it, then refits and
+     * rotates back up to the root.
+     *
+     * @param[in] box
+     * Box.
+     *
+     * @returns
+     * Value index of new proxy, one past the largest value index
+     * previously used.
+     */
+    size_type insert(const aabb_type& box)
+    {
+        init_dynamic();
+
+        // Initialize proxy.
+        size_type value_index = value_proxies_.size();
+        size_type proxy_index;
+        if (!free_proxies_.empty()) {
+            proxy_index = free_proxies_.back();
+            free_proxies_.pop_back();
+            proxies_[proxy_index] = proxy_type{
+                value_index,
+                box,
+                box.center()
+            };
+        }
+        else {
+            proxy_index = proxies_.size();
+            proxies_.emplace_back(
+            proxy_type{
+                value_index,
+                box,
+                box.center()
+            });
+            proxy_leaves_.emplace_back();
+        }
+        value_proxies_.push_back(proxy_index);
+
+        // Initialize leaf.
+        node_type* leaf = allocate_dynamic();
+        *leaf = node_type{
+            box,
+            nullptr,
+            nullptr,
+            size_type(0),
+            proxy_index,
+            size_type(1),
+            nullptr
+        };
+        proxy_leaves_[proxy_index] = leaf;
+        if (!root_) {
+            root_ = leaf;
+            return value_index;
+        }
+
+        // Find sibling.
+        node_type* sibling = root_;
+        while (!sibling->count) {
+            float_type area = sibling->box.surface_area();
+            float_type combined_area = (sibling->box | box).surface_area();
+            float_type cost = 2 * combined_area;
+            float_type inherited_cost = 2 * (combined_area - area);
+            auto child_cost = [&](const node_type* child) {
+                float_type child_area = (child->box | box).surface_area();
+                if (!child->count) {
+                    child_area -= child->box.surface_area();
+                }
+                return child_area + inherited_cost;
+            };
+            float_type cost_left = child_cost(sibling->left);
+            float_type cost_right = child_cost(sibling->right);
+            if (cost < cost_left &&
+                cost < cost_right) {
+                break;
+            }
+            sibling = cost_left < cost_right ?
+                      sibling->left : sibling->right;
+        }
+
+        // Pair with sibling.
+        node_type* parent = sibling->parent;
+        node_type* branch = allocate_dynamic();
+        *branch = node_type{
+            aabb_type(),
+            nullptr,
+            nullptr,
+            size_type(0),
+            size_type(0),
+            size_type(0),
+            parent
+        };
+        init_branch(branch, sibling, leaf);
+        replace_child(parent, sibling, branch);
+
+        // Refit and rotate.
+        refit_upward(parent);
+        return value_index;
+    }
+
+    /**
+     * @brief Remove.
+     *
+     * @param[in] value_index
+     * Value index, as given in the initial input order or
+     * returned by `insert()`.
+     */
+    void remove(size_type value_index)
+    {
+        init_dynamic();
+        assert(value_index < value_proxies_.size());
+        size_type proxy_index = value_proxies_[value_index];
+        assert(proxy_index != npos);
+        node_type* leaf = proxy_leaves_[proxy_index];
+
+        // Move last proxy of leaf into place, then free last.
+        size_type last_index = leaf->first_index + leaf->count - 1;
+        if (proxy_index != last_index) {
+            proxies_[proxy_index] = proxies_[last_index];
+            value_proxies_[proxies_[proxy_index].value_index] = proxy_index;
+        }
+        proxies_[last_index].value_index = npos;
+        proxy_leaves_[last_index] = nullptr;
+        value_proxies_[value_index] = npos;
+        free_proxies_.push_back(last_index);
+        leaf->count--;
+
+        if (leaf->count) {
+            // Refit and rotate.
+            refit_leaf(leaf);
+            refit_upward(leaf->parent);
+        }
+        else {
+            // Replace parent with sibling.
+            node_type* parent = leaf->parent;
+            deallocate_dynamic(leaf);
+            if (!parent) {
+                root_ = nullptr;
+                return;
+            }
+            node_type* sibling =
+                parent->left == leaf ? parent->right : parent->left;
+            node_type* grandparent = parent->parent;
+            sibling->parent = grandparent;
+            replace_child(grandparent, parent, sibling);
+            deallocate_dynamic(parent);
+
+            // Refit and rotate.
+            refit_upward(grandparent);
+        }
+    }
+
+    /**
+     * @brief Update.
+     *
+     * Replaces box of proxy, then refits and rotates from its leaf
+     * up to the root.
+     *
+     * @param[in] value_index
+     * Value index.
+     *
+     * @param[in] box
+     * Box.
+     */
+    void update(size_type value_index, const aabb_type& box)
+    {
+        init_dynamic();
+        assert(value_index < value_proxies_.size());
+        size_type proxy_index = value_proxies_[value_index];
+        assert(proxy_index != npos);
+        proxies_[proxy_index].box = box;
+        proxies_[proxy_index].box_center = box.center();
+        node_type* leaf = proxy_leaves_[proxy_index];
+        refit_leaf(leaf);
+        refit_upward(leaf->parent);
+    }
+
+    /**@}*/
+
+public:
+
+    /**
+     * @name Overlap queries
+     */
+    /**@{*/
+
+    /**
+     * @brief Overlap query.
+     *
+     * @param[in] box
+     * Box.
+     *
+     * @param[in] func
+     * Function called with the value index of each proxy whose box
+     * overlaps the given box, as by `aabb::overlaps<true, true>()`.
+     */
+    template <typename Tfunc>
+    void overlap(const aabb_type& box, Tfunc&& func) const
+    {
+        if (!root_) {
+            return;
+        }
+        aabbtree_stack_<const node_type*, 64> todo;
+        const node_type* node = root_;
+        while (1) {
+            aabbtree_count_node_(todo.size());
+            if (node->box.template overlaps<true, true>(box)) {
+                if (!node->count) {
+                    todo.push(node->right);
+                    node = node->left;
+                    continue;
+                }
+                for (size_type pos = node->first_index;
+                               pos < node->first_index + node->count; pos++) {
+                    aabbtree_count_primitive_();
+                    if (proxies_[pos].box.template
+                            overlaps<true, true>(box)) {
+                        std::forward<Tfunc>(func)(proxies_[pos].value_index);
+                    }
+                }
+            }
+            if (todo.empty()) {
+                break;
+            }
+            node = todo.pop();
+        }
+    }
+
+    /**
+     * @brief Overlapping pairs query, self.
+     *
+     * @param[in] func
+     * Function called with the value indices of each unordered pair
+     * of distinct proxies whose boxes overlap, once per pair.
+     */
+    template <typename Tfunc>
+    void overlapping_pairs(Tfunc&& func) const
+    {
+        if (root_) {
+            self_pairs_recursive(root_, func);
+        }
+    }
+
+    /**
+     * @brief Overlapping pairs query, against other tree.
+     *
+     * Descends both trees simultaneously, opening the node with the
+     * larger surface area.
+     *
+     * @param[in] other
+     * Other tree.
+     *
+     * @param[in] func
+     * Function called with the value indices, in this tree and in the
+     * other tree, of each pair of proxies whose boxes overlap.
+     */
+    template <typename... Tother, typename Tfunc>
+    void overlapping_pairs(
+            const aabbtree<Tfloat, N, Tother...>& other,
+            Tfunc&& func) const
+    {
+        if (root_ && other.root()) {
+            pairs_recursive(root_, other, other.root(), func);
+        }
+    }
+
+#if PREFORM_AABBTREE_USE_THREADS || DOXYGEN
+
+    /**
+     * @brief Overlapping pairs query, self, in parallel.
+     *
+     * Expands the top levels of the descent into independent tasks,
+     * then runs them with `thread_pool::parallel_for()`.
+     *
+     * @param[in] pool
+     * Thread pool.
+     *
+     * @param[in] func
+     * Function as in `overlapping_pairs()`, which must be
+     * safe to call concurrently.
+     */
+    template <typename Tfunc>
+    void overlapping_pairs(thread_pool& pool, Tfunc&& func) const
+    {
+        if (!root_) {
+            return;
+        }
+        std::vector<std::pair<const node_type*, const node_type*>> tasks;
+        self_pairs_tasks(root_, pairs_task_depth(pool), tasks);
+        pool.parallel_for(
+            size_type(0), size_type(tasks.size()), size_type(1),
+            [&](size_type pos) {
+                auto [node0, node1] = tasks[pos];
+                if (node1) {
+                    pairs_recursive(node0, *this, node1, func);
+                }
+                else {
+                    self_pairs_recursive(node0, func);
+                }
+            });
+    }
+
+    /**
+     * @brief Overlapping pairs query, against other tree, in parallel.
+     *
+     * @param[in] pool
+     * Thread pool.
+     *
+     * @param[in] other
+     * Other tree.
+     *
+     * @param[in] func
+     * Function as in `overlapping_pairs()`, which must be
+     * safe to call concurrently.
+     */
+    template <typename... Tother, typename Tfunc>
+    void overlapping_pairs(
+            thread_pool& pool,
+            const aabbtree<Tfloat, N, Tother...>& other,
+            Tfunc&& func) const
+    {
+        typedef typename
+            aabbtree<Tfloat, N, Tother...>::node_type other_node_type;
+        if (!root_ || !other.root()) {
+            return;
+        }
+        std::vector<std::pair<const node_type*, const other_node_type*>> tasks;
+        pairs_tasks(root_, other.root(), pairs_task_depth(pool), tasks);
+        pool.parallel_for(
+            size_type(0), size_type(tasks.size()), size_type(1),
+            [&](size_type pos) {
+                pairs_recursive(tasks[pos].first, other, tasks[pos].second, func);
+            });
+    }
+
+#endif // #if PREFORM_AABBTREE_USE_THREADS || DOXYGEN
+
+    /**@}*/
+
+    /**
+     * @brief Sort values to match proxies.
+     *
+     * @note
+     * This is not available after dynamic updates, which
+     * leave unused proxies. Instead, look up the value index
+     * of each proxy.
+     *
+     * @param[in] from
+     * Forward from.
+     *
+     * @param[in] to
+     * Forward to.
+     */
+    template <typename Tforward_itr>
+    void sort(
+            Tforward_itr from,
+            Tforward_itr to)
+    {
+        assert(!dynamic_);
+        assert(size_type(std::distance(from, to)) == proxies_.size());
+        std::vector<
+            typename std::iterator_traits<Tforward_itr>::value_type,
+            typename std::allocator_traits<Talloc>::
+            template rebind_alloc<
+                typename std::iterator_traits<Tforward_itr>::value_type>>
+                    values(from, to, node_alloc_);
+        for (size_type pos = 0; pos < proxies_.size(); pos++) {
+            *from++ = values[proxies_[pos].value_index];
+        }
+    }
+
+public:
+
+    /**
+     * @name Accessors
+     */
+    /**@{*/
+
+    /**
+     * @brief Leaf cutoff.
+     */
+    size_type leaf_cutoff() const
     {
         return leaf_cutoff_;
     }
@@ -438,6 +1178,81 @@ public:
 
     /**@}*/
 
+public:
+
+    /**
+     * @name Statistics
+     */
+    /**@{*/
+
+    /**
+     * @brief Statistics.
+     *
+     * Walks the whole tree, so this is for tuning rather than for
+     * use in inner loops.
+     *
+     * @param[in] traversal_cost
+     * Traversal cost, per branch, for the surface area heuristic.
+     *
+     * @param[in] intersection_cost
+     * Intersection cost, per proxy, for the surface area heuristic.
+     */
+    aabbtree_stats stats(
+            double traversal_cost = 1,
+            double intersection_cost = 1) const
+    {
+        aabbtree_stats res;
+        if (!root_) {
+            return res;
+        }
+        double root_area = double(root_->box.surface_area());
+        double branch_area = 0;
+        double overlap_area = 0;
+        double cost = 0;
+        std::vector<std::pair<const node_type*, size_type>> todo;
+        todo.emplace_back(root_, 0);
+        while (!todo.empty()) {
+            auto [node, depth] = todo.back();
+            todo.pop_back();
+            double area = double(node->box.surface_area());
+            if (!node->count) {
+                res.branch_count++;
+                branch_area += area;
+                cost += traversal_cost * area;
+                if (node->left->box.template overlaps<true, true>(
+                    node->right->box)) {
+                    overlap_area += double(
+                        (node->left->box & node->right->box).surface_area());
+                }
+                todo.emplace_back(node->right, depth + 1);
+                todo.emplace_back(node->left, depth + 1);
+            }
+            else {
+                res.leaf_count++;
+                res.proxy_count += node->count;
+                res.max_depth = std::max(res.max_depth, depth);
+                cost += intersection_cost * area * double(node->count);
+                if (res.depth_histogram.size() <= depth) {
+                    res.depth_histogram.resize(depth + 1);
+                }
+                if (res.leaf_size_histogram.size() <= node->count) {
+                    res.leaf_size_histogram.resize(node->count + 1);
+                }
+                res.depth_histogram[depth]++;
+                res.leaf_size_histogram[node->count]++;
+            }
+        }
+        if (root_area > 0) {
+            res.sah_cost = cost / root_area;
+        }
+        if (branch_area > 0) {
+            res.overlap_ratio = overlap_area / branch_area;
+        }
+        return res;
+    }
+
+    /**@}*/
+
 private:
 
     /**
@@ -459,6 +1274,11 @@ private:
 
 #endif // #if PREFORM_AABBTREE_USE_THREADS || DOXYGEN
 
+    /**
+     * @brief Node blocks.
+     */
+    std::vector<std::pair<node_type*, size_type>> node_blocks_;
+
     /**
      * @brief Node count.
      */
@@ -474,75 +1294,467 @@ private:
      */
     std::vector<proxy_type, proxy_allocator_type> proxies_;
 
-private:
-
     /**
-     * @brief Allocate.
+     * @brief Dynamic? That is, are parents and lookups maintained?
      */
-    node_type* allocate()
-    {
-        #if PREFORM_AABBTREE_USE_THREADS
-        std::unique_lock<std::mutex> lock(node_alloc_mutex_);
-        #endif // #if PREFORM_AABBTREE_USE_THREADS
+    bool dynamic_ = false;
 
-        node_count_++; // Protected by mutex, doesn't need to be atomic
-        return node_alloc_.allocate(1);
-    }
+#if !DOXYGEN
 
     /**
-     * @brief Deallocate.
+     * @brief Node cursor.
+     *
+     * Each build task allocates nodes from blocks of its own,
+     * so that the node allocator lock is only taken once per block.
      */
-    void deallocate(node_type* node)
+    struct node_cursor
     {
-        if (node) {
-            #if PREFORM_AABBTREE_USE_THREADS
-            std::unique_lock<std::mutex> lock(node_alloc_mutex_);
-            #endif // #if PREFORM_AABBTREE_USE_THREADS
+        node_type* next = nullptr;
 
-            node_count_--; // Protected by mutex, doesn't need to be atomic
-            node_alloc_.deallocate(node, 1);
-        }
-    }
+        node_type* last = nullptr;
+
+        size_type count = 0;
+    };
+
+#endif // #if !DOXYGEN
 
     /**
-     * @brief Deallocate recursively.
+     * @brief Node cursor for dynamic updates.
      */
-    void deallocate_recursive(node_type* node)
-    {
-        if (node) {
-            // Recurse.
-            deallocate_recursive(node->left);
-            deallocate_recursive(node->right);
+    node_cursor dynamic_cursor_;
 
-            // Deallocate.
-            deallocate(node);
-        }
-    }
+    /**
+     * @brief Free nodes, for reuse by dynamic updates.
+     */
+    std::vector<node_type*> free_nodes_;
 
     /**
-     * @brief Initialize recursively.
+     * @brief Free proxies, for reuse by dynamic updates.
      */
-    node_type* init_recursive(
-            size_type& first_index,
-            iterator_range<proxy_type*> proxies)
-    {
-        // Allocate.
-        node_type* node = allocate();
+    std::vector<size_type> free_proxies_;
 
-        // Surround boxes and box centers.
-        aabb_type box;
-        aabb_type box_center;
-        assert((box[0] > box[1]).all());
-        for (const proxy_type& proxy : proxies) {
-            box |= proxy.box;
-            box_center |= proxy.box_center;
-        }
+    /**
+     * @brief Leaf of each proxy.
+     */
+    std::vector<node_type*> proxy_leaves_;
 
-        // Proxies count.
-        size_type count = proxies.size();
-        assert(count);
+    /**
+     * @brief Proxy of each value, or `npos` if removed.
+     */
+    std::vector<size_type> value_proxies_;
 
-        if (count <= leaf_cutoff_) {
+private:
+
+    /**
+     * @brief Initialize.
+     */
+    template <bool Tmorton, typename Tinput_itr, typename Tfunc>
+    void init_(
+            thread_pool* pool,
+            Tinput_itr from,
+            Tinput_itr to,
+            Tfunc&& func)
+    {
+        PREFORM_PROFILE_ZONE("aabbtree::init");
+
+        // Clear.
+        clear();
+
+        // Count.
+        typename
+        std::iterator_traits<Tinput_itr>::difference_type
+            count = std::distance(from, to);
+        if (count < decltype(count)(1)) {
+            return;
+        }
+
+        // Initialize proxies.
+        size_type value_index = 0;
+        proxies_.reserve(count);
+        while (from != to) {
+            aabb_type box = std::forward<Tfunc>(func)(*from);
+            assert((box[0] < box[1]).all());
+            proxies_.emplace_back(
+            proxy_type{
+                value_index,
+                box,
+                box.center()
+            });
+            ++value_index;
+            ++from;
+        }
+
+        // Sort by Morton codes.
+        std::vector<morton_key> keys;
+        if constexpr (Tmorton) {
+            keys = morton_sort(pool);
+        }
+
+        // Initialize.
+        size_type first_index = 0;
+        node_cursor cursor;
+        task_group* group = nullptr;
+        #if PREFORM_AABBTREE_USE_THREADS
+        std::unique_ptr<task_group> group_holder;
+        if (pool) {
+            group_holder.reset(new task_group(*pool));
+            group = group_holder.get();
+        }
+        #endif // #if PREFORM_AABBTREE_USE_THREADS
+        if constexpr (Tmorton) {
+            root_ =
+            init_morton_recursive(
+                cursor,
+                first_index,
+                {&proxies_[0],
+                 &proxies_[0] + proxies_.size()},
+                keys.data(),
+                morton_bits,
+                pool, group);
+        }
+        else {
+            root_ =
+            init_recursive(
+                cursor,
+                first_index,
+                {&proxies_[0],
+                 &proxies_[0] + proxies_.size()},
+                pool, group);
+        }
+        #if PREFORM_AABBTREE_USE_THREADS
+        if (group) {
+            group->wait();
+        }
+        #endif // #if PREFORM_AABBTREE_USE_THREADS
+        retire(cursor);
+        assert(first_index == proxies_.size());
+    }
+
+#if !DOXYGEN
+
+    /**
+     * @brief Morton code bits per dimension.
+     *
+     * @note
+     * At most 63, so that shifting by it is defined for `N == 1`.
+     */
+    static constexpr size_type morton_dim =
+        N == 1 ? 63 : (N < 64 ? 64 / N : 1);
+
+    /**
+     * @brief Morton code bits, at most 64.
+     */
+    static constexpr size_type morton_bits =
+        morton_dim * N < 64 ? morton_dim * N : 64;
+
+    /**
+     * @brief Morton key, as Morton code and proxy index.
+     */
+    typedef std::pair<std::uint64_t, size_type> morton_key;
+
+#endif // #if !DOXYGEN
+
+    /**
+     * @brief Morton code.
+     *
+     * @param[in] point
+     * Point, normalized to the unit hypercube.
+     *
+     * @note
+     * Interleaves `morton_dim` bits of each quantized coordinate,
+     * such that code bit `i` belongs to coordinate `(N - 1) - i % N`.
+     */
+    static std::uint64_t morton_code(const multi<float_type, N>& point)
+    {
+        std::uint64_t code = 0;
+        std::uint64_t quant[N];
+        for (size_type k = 0; k < N; k++) {
+            float_type x = point[k] * float_type(std::uint64_t(1) << morton_dim);
+            x = x < 0 ? 0 : x;
+            quant[k] = std::uint64_t(x);
+            quant[k] = std::min(
+                       quant[k], (std::uint64_t(1) << morton_dim) - 1);
+        }
+        if constexpr (N == 2) {
+            code = morton_encode2(quant[1], quant[0]);
+        }
+        else if constexpr (N == 3) {
+            code = morton_encode3(quant[2], quant[1], quant[0]);
+        }
+        else {
+            for (size_type b = morton_dim; b-- > 0;) {
+                for (size_type k = 0; k < N; k++) {
+                    code = (code << 1) | ((quant[k] >> b) & 1);
+                }
+            }
+        }
+        return code;
+    }
+
+    /**
+     * @brief Sort proxies by Morton codes.
+     *
+     * Uses least significant digit radix sort, with 8-bit digits.
+     * Given a thread pool, each pass histograms and scatters chunks
+     * in parallel, and is still stable.
+     *
+     * @returns
+     * Sorted keys, with proxy indices relative to sorted proxies.
+     */
+    std::vector<morton_key> morton_sort(thread_pool* pool)
+    {
+        size_type count = proxies_.size();
+
+        // Box center bounds.
+        aabb_type box;
+        aabb_type box_center;
+        surround(pool, {&proxies_[0], &proxies_[0] + count}, box, box_center);
+        multi<float_type, N> box_center_scale;
+        for (size_type k = 0; k < N; k++) {
+            float_type diag = box_center[1][k] - box_center[0][k];
+            box_center_scale[k] = diag > 0 ? 1 / diag : 0;
+        }
+
+        // Chunks.
+        size_type chunk_count = 1;
+        #if PREFORM_AABBTREE_USE_THREADS
+        if (pool &&
+            count > parallel_cutoff) {
+            chunk_count = std::min<size_type>(
+                          pool->size() * 4, count / (parallel_cutoff / 4));
+        }
+        #endif // #if PREFORM_AABBTREE_USE_THREADS
+        auto for_each_chunk = [&](auto&& chunk_func) {
+            #if PREFORM_AABBTREE_USE_THREADS
+            if (chunk_count > 1) {
+                pool->parallel_for(
+                    size_type(0), chunk_count, size_type(1),
+                    [&](size_type chunk) {
+                        chunk_func(
+                            chunk,
+                            count * chunk / chunk_count,
+                            count * (chunk + 1) / chunk_count);
+                    });
+                return;
+            }
+            #endif // #if PREFORM_AABBTREE_USE_THREADS
+            chunk_func(size_type(0), size_type(0), count);
+        };
+
+        // Compute codes.
+        std::vector<morton_key> keys(count);
+        std::vector<morton_key> keys_swap(count);
+        for_each_chunk([&](size_type, size_type from, size_type to) {
+            for (size_type pos = from; pos < to; pos++) {
+                keys[pos] = {
+                    morton_code(
+                        (proxies_[pos].box_center - box_center[0]) *
+                         box_center_scale),
+                    pos
+                };
+            }
+        });
+
+        // Radix sort.
+        std::vector<std::array<size_type, 256>> chunk_offsets(chunk_count);
+        for (size_type shift = 0; shift < morton_bits; shift += 8) {
+
+            // Histogram.
+            for_each_chunk([&](size_type chunk, size_type from, size_type to) {
+                std::array<size_type, 256>& offsets = chunk_offsets[chunk];
+                offsets.fill(0);
+                for (size_type pos = from; pos < to; pos++) {
+                    offsets[(keys[pos].first >> shift) & 255]++;
+                }
+            });
+
+            // Exclusive prefix sum, digit major and chunk minor.
+            size_type offset = 0;
+            for (size_type digit = 0; digit < 256; digit++) {
+                for (size_type chunk = 0; chunk < chunk_count; chunk++) {
+                    size_type digit_count = chunk_offsets[chunk][digit];
+                    chunk_offsets[chunk][digit] = offset;
+                    offset += digit_count;
+                }
+            }
+
+            // Scatter.
+            for_each_chunk([&](size_type chunk, size_type from, size_type to) {
+                std::array<size_type, 256>& offsets = chunk_offsets[chunk];
+                for (size_type pos = from; pos < to; pos++) {
+                    keys_swap[offsets[(keys[pos].first >> shift) & 255]++] =
+                        keys[pos];
+                }
+            });
+            keys.swap(keys_swap);
+        }
+
+        // Permute proxies.
+        std::vector<proxy_type, proxy_allocator_type> proxies(
+                count, proxies_.get_allocator());
+        for_each_chunk([&](size_type, size_type from, size_type to) {
+            for (size_type pos = from; pos < to; pos++) {
+                proxies[pos] = proxies_[keys[pos].second];
+                keys[pos].second = pos;
+            }
+        });
+        proxies_.swap(proxies);
+        return keys;
+    }
+
+    /**
+     * @brief Allocate.
+     *
+     * @param[inout] cursor
+     * Node cursor.
+     *
+     * @param[in] count
+     * Proxy count of the subtree being built, which limits
+     * the size of any new block.
+     */
+    node_type* allocate(node_cursor& cursor, size_type count)
+    {
+        if (cursor.next == cursor.last) {
+            #if PREFORM_AABBTREE_USE_THREADS
+            std::unique_lock<std::mutex> lock(node_alloc_mutex_);
+            #endif // #if PREFORM_AABBTREE_USE_THREADS
+
+            // A subtree of count proxies has at most 2 * count - 1 nodes.
+            size_type block_size = std::min<size_type>(2 * count - 1, 256);
+            node_type* block = node_alloc_.allocate(block_size);
+            node_blocks_.emplace_back(block, block_size);
+            cursor.next = block;
+            cursor.last = block + block_size;
+        }
+        cursor.count++;
+        return cursor.next++;
+    }
+
+    /**
+     * @brief Retire node cursor, adding its nodes to the node count.
+     */
+    void retire(node_cursor& cursor)
+    {
+        #if PREFORM_AABBTREE_USE_THREADS
+        std::unique_lock<std::mutex> lock(node_alloc_mutex_);
+        #endif // #if PREFORM_AABBTREE_USE_THREADS
+
+        node_count_ += cursor.count; // Protected by mutex
+        cursor = node_cursor();
+    }
+
+    /**
+     * @brief Surround boxes and box centers.
+     */
+    void surround(
+            thread_pool* pool,
+            iterator_range<proxy_type*> proxies,
+            aabb_type& box,
+            aabb_type& box_center) const
+    {
+        #if PREFORM_AABBTREE_USE_THREADS
+        if (pool &&
+            size_type(proxies.size()) > parallel_cutoff) {
+            // Surround chunks in parallel.
+            size_type chunk_count = proxies.size() / (parallel_cutoff / 4);
+            std::vector<std::pair<aabb_type, aabb_type>> chunks(chunk_count);
+            pool->parallel_for(
+                size_type(0), chunk_count, size_type(1),
+                [&](size_type chunk) {
+                    auto& [chunk_box, chunk_box_center] = chunks[chunk];
+                    proxy_type* from =
+                        proxies.begin() +
+                        proxies.size() * chunk / chunk_count;
+                    proxy_type* to =
+                        proxies.begin() +
+                        proxies.size() * (chunk + 1) / chunk_count;
+                    for (; from < to; ++from) {
+                        chunk_box |= from->box;
+                        chunk_box_center |= from->box_center;
+                    }
+                });
+            for (auto& [chunk_box, chunk_box_center] : chunks) {
+                box |= chunk_box;
+                box_center |= chunk_box_center;
+            }
+            return;
+        }
+        #endif // #if PREFORM_AABBTREE_USE_THREADS
+
+        (void) pool;
+        for (const proxy_type& proxy : proxies) {
+            box |= proxy.box;
+            box_center |= proxy.box_center;
+        }
+    }
+
+    /**
+     * @brief Split.
+     *
+     * If the split mode accepts a thread pool, as
+     * `aabbtree_split_surface_area` does, upper levels pass it along.
+     */
+    proxy_type* split(
+            thread_pool* pool,
+            const aabb_type& box,
+            const aabb_type& box_center,
+            size_type split_dim,
+            iterator_range<proxy_type*> proxies) const
+    {
+        #if PREFORM_AABBTREE_USE_THREADS
+        if constexpr (
+                std::is_invocable_r<
+                    proxy_type*,
+                    const Tsplit_mode&,
+                    const aabb_type&,
+                    const aabb_type&,
+                    const std::size_t,
+                    iterator_range<proxy_type*>,
+                    thread_pool&>::value) {
+            if (pool &&
+                size_type(proxies.size()) > parallel_cutoff) {
+                return Tsplit_mode()(
+                        box,
+                        box_center,
+                        split_dim,
+                        proxies,
+                        *pool);
+            }
+        }
+        #endif // #if PREFORM_AABBTREE_USE_THREADS
+
+        (void) pool;
+        return Tsplit_mode()(
+                box,
+                box_center,
+                split_dim,
+                proxies);
+    }
+
+    /**
+     * @brief Initialize recursively.
+     */
+    node_type* init_recursive(
+            node_cursor& cursor,
+            size_type& first_index,
+            iterator_range<proxy_type*> proxies,
+            thread_pool* pool,
+            task_group* group)
+    {
+        // Proxies count.
+        size_type count = proxies.size();
+        assert(count);
+
+        // Allocate.
+        node_type* node = allocate(cursor, count);
+
+        // Surround boxes and box centers.
+        aabb_type box;
+        aabb_type box_center;
+        assert((box[0] > box[1]).all());
+        surround(pool, proxies, box, box_center);
+
+        if (count <= leaf_cutoff_) {
             // Initialize leaf.
             *node = node_type{
                 box,
@@ -550,7 +1762,8 @@ private:
                 nullptr,
                 size_type(0),
                 first_index,
-                count
+                count,
+                nullptr
             };
 
             // Shift first index.
@@ -563,92 +1776,598 @@ private:
                         box_center.diag().argmax();
 
             // Split.
-            proxy_type* split = Tsplit_mode()(
+            proxy_type* split_proxy = split(
+                    pool,
                     box,
                     box_center,
                     split_dim,
                     proxies);
-            assert(split &&
-                   proxies.begin() <= split &&
-                   proxies.end() > split);
+            assert(split_proxy &&
+                   proxies.begin() <= split_proxy &&
+                   proxies.end() > split_proxy);
 
-            // Children.
-            node_type* left;
-            node_type* right;
+            // Initialize.
+            *node = node_type{
+                box,
+                nullptr,
+                nullptr,
+                split_dim,
+                size_type(0),
+                size_type(0),
+                nullptr
+            };
 
             #if PREFORM_AABBTREE_USE_THREADS
-            // Count sufficiently small?
-            if (count <= 16384) {
-            #endif // #if PREFORM_AABBTREE_USE_THREADS
+            // Count sufficiently large?
+            if (group &&
+                count > parallel_cutoff) {
+
+                // Recurse as task.
+                size_type first_index_left = first_index;
+                first_index += std::distance(proxies.begin(), split_proxy);
+                proxy_type* from = proxies.begin();
+                group->run(
+                [this, node, from, split_proxy,
+                       first_index_left, pool, group]() {
+                    node_cursor cursor_left;
+                    size_type first_index_left_copy = first_index_left;
+                    node->left =
+                    init_recursive(
+                        cursor_left,
+                        first_index_left_copy,
+                        {from, split_proxy},
+                        pool, group);
+                    retire(cursor_left);
+                });
 
                 // Recurse.
-                left =
+                node->right =
                 init_recursive(
+                    cursor,
                     first_index,
-                    {proxies.begin(), split});
-
+                    {split_proxy, proxies.end()},
+                    pool, group);
+            }
+            else
+            #endif // #if PREFORM_AABBTREE_USE_THREADS
+            {
                 // Recurse.
-                right =
+                node->left =
                 init_recursive(
+                    cursor,
                     first_index,
-                    {split, proxies.end()});
-
-            #if PREFORM_AABBTREE_USE_THREADS
-            }
-            else {
-
-                // Recurse async.
-                size_type first_index_left = first_index;
-                first_index += std::distance(proxies.begin(), split);
-                std::future<node_type*> future_left =
-                std::async([&]() {
-                    return init_recursive(
-                                first_index_left,
-                                {proxies.begin(), split});
-                });
+                    {proxies.begin(), split_proxy},
+                    pool, group);
 
                 // Recurse.
-                right =
+                node->right =
                 init_recursive(
+                    cursor,
                     first_index,
-                    {split, proxies.end()});
+                    {split_proxy, proxies.end()},
+                    pool, group);
+            }
+        }
+        return node;
+    }
+
+    /**
+     * @brief Initialize linear bounding volume hierarchy recursively.
+     *
+     * @param[in] keys
+     * Morton keys corresponding to proxies.
+     *
+     * @param[in] bit
+     * Bit count above which all codes are known to agree.
+     */
+    node_type* init_morton_recursive(
+            node_cursor& cursor,
+            size_type& first_index,
+            iterator_range<proxy_type*> proxies,
+            const morton_key* keys,
+            size_type bit,
+            thread_pool* pool,
+            task_group* group)
+    {
+        // Proxies count.
+        size_type count = proxies.size();
+        assert(count);
+
+        // Allocate.
+        node_type* node = allocate(cursor, count);
 
-                // Wait.
-                left = future_left.get();
+        if (count <= leaf_cutoff_) {
+            // Surround boxes.
+            aabb_type box;
+            for (const proxy_type& proxy : proxies) {
+                box |= proxy.box;
             }
-            #endif // #if PREFORM_AABBTREE_USE_THREADS
 
-            // Initialize.
+            // Initialize leaf.
             *node = node_type{
                 box,
-                left,
-                right,
-                split_dim,
+                nullptr,
+                nullptr,
                 size_type(0),
-                size_type(0)
+                first_index,
+                count,
+                nullptr
             };
+
+            // Shift first index.
+            first_index += count;
+            return node;
         }
-        return node;
-    }
 
-    template <typename, std::size_t, typename>
-    friend class linear_aabbtree;
-};
+        // Find highest differing bit.
+        std::uint64_t code_diff = keys[0].first ^ keys[count - 1].first;
+        while (bit > 0 && !((code_diff >> (bit - 1)) & 1)) {
+            bit--;
+        }
 
-/**
- * @brief Template alias for convenience.
- */
-template <
-    typename Tfloat,
-    typename Tsplit_mode,
-    typename Talloc = std::allocator<char>
-    >
-using aabbtree2 = aabbtree<Tfloat, 2, Tsplit_mode, Talloc>;
+        // Split.
+        size_type split_dim = 0;
+        size_type split_count = count / 2;
+        if (bit > 0) {
+            split_dim = (N - 1) - (bit - 1) % N;
+            split_count =
+                std::partition_point(
+                    keys, keys + count,
+                    [=](const morton_key& key) {
+                        return !((key.first >> (bit - 1)) & 1);
+                    }) - keys;
+            bit--;
+        }
+        assert(split_count > 0 && split_count < count);
+        proxy_type* split_proxy = proxies.begin() + split_count;
 
-/**
- * @brief Template alias for convenience.
- */
-template <
+        // Initialize.
+        *node = node_type{
+            aabb_type(),
+            nullptr,
+            nullptr,
+            split_dim,
+            size_type(0),
+            size_type(0),
+            nullptr
+        };
+
+        #if PREFORM_AABBTREE_USE_THREADS
+        // Count sufficiently large?
+        if (group &&
+            count > parallel_cutoff) {
+
+            // Surround boxes, since children finish asynchronously.
+            aabb_type box_center;
+            surround(pool, proxies, node->box, box_center);
+
+            // Recurse as task.
+            size_type first_index_left = first_index;
+            first_index += split_count;
+            proxy_type* from = proxies.begin();
+            group->run(
+            [this, node, from, split_proxy, keys, bit,
+                   first_index_left, pool, group]() {
+                node_cursor cursor_left;
+                size_type first_index_left_copy = first_index_left;
+                node->left =
+                init_morton_recursive(
+                    cursor_left,
+                    first_index_left_copy,
+                    {from, split_proxy},
+                    keys, bit,
+                    pool, group);
+                retire(cursor_left);
+            });
+
+            // Recurse.
+            node->right =
+            init_morton_recursive(
+                cursor,
+                first_index,
+                {split_proxy, proxies.end()},
+                keys + split_count, bit,
+                pool, group);
+        }
+        else
+        #endif // #if PREFORM_AABBTREE_USE_THREADS
+        {
+            // Recurse.
+            node->left =
+            init_morton_recursive(
+                cursor,
+                first_index,
+                {proxies.begin(), split_proxy},
+                keys, bit,
+                pool, group);
+
+            // Recurse.
+            node->right =
+            init_morton_recursive(
+                cursor,
+                first_index,
+                {split_proxy, proxies.end()},
+                keys + split_count, bit,
+                pool, group);
+
+            // Surround child boxes.
+            node->box = node->left->box | node->right->box;
+        }
+        return node;
+    }
+
+    /**
+     * @brief Initialize dynamic updates, if not yet initialized.
+     *
+     * Links parents, and builds lookups from values to proxies and from
+     * proxies to leaves.
+     */
+    void init_dynamic()
+    {
+        if (dynamic_) {
+            return;
+        }
+        dynamic_ = true;
+        proxy_leaves_.assign(proxies_.size(), nullptr);
+        value_proxies_.assign(proxies_.size(), npos);
+        for (size_type pos = 0; pos < proxies_.size(); pos++) {
+            value_proxies_[proxies_[pos].value_index] = pos;
+        }
+        if (root_) {
+            root_->parent = nullptr;
+            init_dynamic_recursive(root_);
+        }
+    }
+
+    /**
+     * @brief Initialize dynamic updates recursively.
+     */
+    void init_dynamic_recursive(node_type* node)
+    {
+        if (node->count) {
+            for (size_type pos = node->first_index;
+                           pos < node->first_index + node->count; pos++) {
+                proxy_leaves_[pos] = node;
+            }
+        }
+        else {
+            node->left->parent = node;
+            node->right->parent = node;
+            init_dynamic_recursive(node->left);
+            init_dynamic_recursive(node->right);
+        }
+    }
+
+    /**
+     * @brief Allocate for dynamic updates.
+     */
+    node_type* allocate_dynamic()
+    {
+        node_type* node;
+        if (!free_nodes_.empty()) {
+            node = free_nodes_.back();
+            free_nodes_.pop_back();
+        }
+        else {
+            node = allocate(dynamic_cursor_, 128);
+        }
+        node_count_++;
+        return node;
+    }
+
+    /**
+     * @brief Deallocate for dynamic updates.
+     */
+    void deallocate_dynamic(node_type* node)
+    {
+        free_nodes_.push_back(node);
+        node_count_--;
+    }
+
+    /**
+     * @brief Initialize branch from children.
+     *
+     * Chooses the split dimension as the dimension of greatest
+     * separation between child box centers, and orders children along
+     * it, as traversal expects.
+     */
+    static void init_branch(
+            node_type* node,
+            node_type* child0,
+            node_type* child1)
+    {
+        auto center0 = child0->box.center();
+        auto center1 = child1->box.center();
+        size_type split_dim = 0;
+        float_type split_diff = -1;
+        for (size_type k = 0; k < N; k++) {
+            float_type diff = center1[k] - center0[k];
+            diff = diff < 0 ? -diff : diff;
+            if (split_diff < diff) {
+                split_diff = diff;
+                split_dim = k;
+            }
+        }
+        if (center1[split_dim] < center0[split_dim]) {
+            std::swap(child0, child1);
+        }
+        node->box = child0->box | child1->box;
+        node->left = child0;
+        node->right = child1;
+        node->split_dim = split_dim;
+        node->first_index = 0;
+        node->count = 0;
+        child0->parent = node;
+        child1->parent = node;
+    }
+
+    /**
+     * @brief Replace child of parent, or root if no parent.
+     */
+    void replace_child(
+            node_type* parent,
+            node_type* child,
+            node_type* other_child)
+    {
+        if (!parent) {
+            root_ = other_child;
+        }
+        else if (parent->left == child) {
+            parent->left = other_child;
+        }
+        else {
+            assert(parent->right == child);
+            parent->right = other_child;
+        }
+    }
+
+    /**
+     * @brief Refit leaf to its proxies.
+     */
+    void refit_leaf(node_type* leaf)
+    {
+        aabb_type box;
+        for (size_type pos = leaf->first_index;
+                       pos < leaf->first_index + leaf->count; pos++) {
+            box |= proxies_[pos].box;
+        }
+        leaf->box = box;
+    }
+
+    /**
+     * @brief Refit recursively.
+     */
+    void refit_recursive(node_type* node)
+    {
+        if (node->count) {
+            refit_leaf(node);
+        }
+        else {
+            refit_recursive(node->left);
+            refit_recursive(node->right);
+            node->box = node->left->box | node->right->box;
+        }
+    }
+
+    /**
+     * @brief Refit and rotate from node up to root.
+     */
+    void refit_upward(node_type* node)
+    {
+        while (node) {
+            node->box = node->left->box | node->right->box;
+            rotate(node);
+            node = node->parent;
+        }
+    }
+
+    /**
+     * @brief Rotate.
+     *
+     * Considers swapping either child with either grandchild on the
+     * other side, and applies the swap which most reduces the surface
+     * area of the child that changes, if any.
+     */
+    void rotate(node_type* node)
+    {
+        node_type* best_child = nullptr;
+        node_type* best_grandchild = nullptr;
+        float_type best_gain = 0;
+        for (int side = 0; side < 2; side++) {
+            node_type* child = side == 0 ? node->left : node->right;
+            node_type* other = side == 0 ? node->right : node->left;
+            if (other->count) {
+                continue;
+            }
+            float_type other_area = other->box.surface_area();
+            for (int other_side = 0; other_side < 2; other_side++) {
+                node_type* grandchild =
+                    other_side == 0 ? other->left : other->right;
+                node_type* keep =
+                    other_side == 0 ? other->right : other->left;
+                float_type gain =
+                    other_area - (keep->box | child->box).surface_area();
+                if (best_gain < gain) {
+                    best_gain = gain;
+                    best_child = child;
+                    best_grandchild = grandchild;
+                }
+            }
+        }
+        if (!best_child) {
+            return;
+        }
+
+        // Swap child with grandchild.
+        node_type* other = best_grandchild->parent;
+        node_type* keep =
+            other->left == best_grandchild ? other->right : other->left;
+        node_type* grandchild = best_grandchild;
+        node_type* child = best_child;
+        init_branch(other, keep, child);
+        init_branch(node, other, grandchild);
+    }
+
+    /**
+     * @brief Overlapping pairs query, self, recursively.
+     */
+    template <typename Tfunc>
+    void self_pairs_recursive(const node_type* node, Tfunc& func) const
+    {
+        if (node->count) {
+            for (size_type pos0 = node->first_index;
+                           pos0 < node->first_index + node->count; pos0++)
+            for (size_type pos1 = pos0 + 1;
+                           pos1 < node->first_index + node->count; pos1++) {
+                if (proxies_[pos0].box.template
+                        overlaps<true, true>(proxies_[pos1].box)) {
+                    func(
+                        proxies_[pos0].value_index,
+                        proxies_[pos1].value_index);
+                }
+            }
+        }
+        else {
+            self_pairs_recursive(node->left, func);
+            self_pairs_recursive(node->right, func);
+            pairs_recursive(node->left, *this, node->right, func);
+        }
+    }
+
+    /**
+     * @brief Overlapping pairs query, against other tree, recursively.
+     */
+    template <typename Tother_tree, typename Tother_node, typename Tfunc>
+    void pairs_recursive(
+            const node_type* node,
+            const Tother_tree& other,
+            const Tother_node* other_node,
+            Tfunc& func) const
+    {
+        if (!node->box.template overlaps<true, true>(other_node->box)) {
+            return;
+        }
+        if (node->count && other_node->count) {
+            for (size_type pos0 = node->first_index;
+                           pos0 < node->first_index + node->count; pos0++) {
+                const proxy_type& proxy0 = proxies_[pos0];
+                if (!proxy0.box.template
+                        overlaps<true, true>(other_node->box)) {
+                    continue;
+                }
+                for (size_type pos1 = other_node->first_index;
+                               pos1 < other_node->first_index +
+                                      other_node->count; pos1++) {
+                    const auto& proxy1 = other.proxies()[pos1];
+                    if (proxy0.box.template
+                            overlaps<true, true>(proxy1.box)) {
+                        func(proxy0.value_index, proxy1.value_index);
+                    }
+                }
+            }
+        }
+        else if (other_node->count ||
+                (!node->count &&
+                  node->box.surface_area() >
+                  other_node->box.surface_area())) {
+            pairs_recursive(node->left, other, other_node, func);
+            pairs_recursive(node->right, other, other_node, func);
+        }
+        else {
+            pairs_recursive(node, other, other_node->left, func);
+            pairs_recursive(node, other, other_node->right, func);
+        }
+    }
+
+#if PREFORM_AABBTREE_USE_THREADS || DOXYGEN
+
+    /**
+     * @brief Descent depth to expand into tasks.
+     */
+    static size_type pairs_task_depth(const thread_pool& pool)
+    {
+        // About 8 tasks per thread, if the trees are balanced.
+        size_type depth = 3;
+        while ((size_type(1) << depth) < pool.size() * 8) {
+            depth++;
+        }
+        return depth;
+    }
+
+    /**
+     * @brief Expand overlapping pairs query, self, into tasks.
+     *
+     * Each task is a pair of nodes, or a node and nullptr to
+     * represent a self query.
+     */
+    void self_pairs_tasks(
+            const node_type* node,
+            size_type depth,
+            std::vector<
+                std::pair<const node_type*, const node_type*>>& tasks) const
+    {
+        if (node->count || depth == 0) {
+            tasks.emplace_back(node, nullptr);
+        }
+        else {
+            self_pairs_tasks(node->left, depth - 1, tasks);
+            self_pairs_tasks(node->right, depth - 1, tasks);
+            pairs_tasks(node->left, node->right, depth - 1, tasks);
+        }
+    }
+
+    /**
+     * @brief Expand overlapping pairs query, against other tree,
+     * into tasks.
+     */
+    template <typename Tother_node>
+    static void pairs_tasks(
+            const node_type* node,
+            const Tother_node* other_node,
+            size_type depth,
+            std::vector<
+                std::pair<const node_type*, const Tother_node*>>& tasks)
+    {
+        if (!node->box.template overlaps<true, true>(other_node->box)) {
+            return;
+        }
+        if (depth == 0 ||
+            (node->count && other_node->count)) {
+            tasks.emplace_back(node, other_node);
+        }
+        else if (other_node->count ||
+                (!node->count &&
+                  node->box.surface_area() >
+                  other_node->box.surface_area())) {
+            pairs_tasks(node->left, other_node, depth - 1, tasks);
+            pairs_tasks(node->right, other_node, depth - 1, tasks);
+        }
+        else {
+            pairs_tasks(node, other_node->left, depth - 1, tasks);
+            pairs_tasks(node, other_node->right, depth - 1, tasks);
+        }
+    }
+
+#endif // #if PREFORM_AABBTREE_USE_THREADS || DOXYGEN
+
+    template <typename, std::size_t, typename>
+    friend class linear_aabbtree;
+};
+
+/**
+ * @brief Template alias for convenience.
+ */
+template <
+    typename Tfloat,
+    typename Tsplit_mode,
+    typename Talloc = std::allocator<char>
+    >
+using aabbtree2 = aabbtree<Tfloat, 2, Tsplit_mode, Talloc>;
+
+/**
+ * @brief Template alias for convenience.
+ */
+template <
     typename Tfloat,
     typename Tsplit_mode,
     typename Talloc = std::allocator<char>
@@ -776,11 +2495,93 @@ struct aabbtree_split_surface_area
                         proxies);
         }
 
-        // Bin type.
-        typedef std::pair<aabb<Tfloat, N>, std::size_t> bin;
-
         // Initialize bins.
-        std::array<bin, Nbins> bins = {};
+        std::array<bin<Tfloat, N>, Nbins> bins = {};
+        init_bins(box_center, split_dim, proxies, bins);
+        return split_bins(box, box_center, split_dim, proxies, bins);
+    }
+
+#if PREFORM_AABBTREE_USE_THREADS || DOXYGEN
+
+    /**
+     * @brief Split, binning chunks of proxies in parallel.
+     */
+    template <
+        typename Tfloat, std::size_t N,
+        typename Tproxy
+        >
+    Tproxy* operator()(
+            const aabb<Tfloat, N>& box,
+            const aabb<Tfloat, N>& box_center,
+            const std::size_t split_dim,
+            iterator_range<Tproxy*> proxies,
+            thread_pool& pool) const
+    {
+        // Degenerate?
+        if (box_center[0][split_dim] ==
+            box_center[1][split_dim]) {
+            // Default to equal counts.
+            return aabbtree_split_equal_counts()(
+                        box,
+                        box_center,
+                        split_dim,
+                        proxies);
+        }
+
+        // Initialize bins of each chunk in parallel.
+        std::size_t chunk_count = pool.size() * 4;
+        if (chunk_count > std::size_t(proxies.size()) / 1024) {
+            chunk_count = std::size_t(proxies.size()) / 1024 + 1;
+        }
+        std::vector<std::array<bin<Tfloat, N>, Nbins>> chunk_bins(chunk_count);
+        pool.parallel_for(
+            std::size_t(0), chunk_count, std::size_t(1),
+            [&](std::size_t chunk) {
+                init_bins(
+                    box_center,
+                    split_dim,
+                    iterator_range<Tproxy*>{
+                        proxies.begin() +
+                        proxies.size() * chunk / chunk_count,
+                        proxies.begin() +
+                        proxies.size() * (chunk + 1) / chunk_count},
+                    chunk_bins[chunk]);
+            });
+
+        // Merge bins.
+        std::array<bin<Tfloat, N>, Nbins> bins = {};
+        for (const auto& each_bins : chunk_bins) {
+            for (std::size_t pos = 0; pos < Nbins; pos++) {
+                bins[pos].first |= each_bins[pos].first;
+                bins[pos].second += each_bins[pos].second;
+            }
+        }
+        return split_bins(box, box_center, split_dim, proxies, bins);
+    }
+
+#endif // #if PREFORM_AABBTREE_USE_THREADS || DOXYGEN
+
+private:
+
+    /**
+     * @brief Bin type.
+     */
+    template <typename Tfloat, std::size_t N>
+    using bin = std::pair<aabb<Tfloat, N>, std::size_t>;
+
+    /**
+     * @brief Initialize bins.
+     */
+    template <
+        typename Tfloat, std::size_t N,
+        typename Tproxy
+        >
+    static void init_bins(
+            const aabb<Tfloat, N>& box_center,
+            const std::size_t split_dim,
+            iterator_range<Tproxy*> proxies,
+            std::array<bin<Tfloat, N>, Nbins>& bins)
+    {
         for (const Tproxy& proxy : proxies) {
             Tfloat cen = proxy.box_center[split_dim];
             Tfloat cenmin = box_center[0][split_dim];
@@ -790,84 +2591,1918 @@ struct aabbtree_split_surface_area
                 Nbins * ((cen - cenmin) / (cenmax - cenmin)),
                 Nbins - 1);
 
-            bins[pos].first |= proxy.box;
-            bins[pos].second++;
+            bins[pos].first |= proxy.box;
+            bins[pos].second++;
+        }
+    }
+
+    /**
+     * @brief Split given bins.
+     */
+    template <
+        typename Tfloat, std::size_t N,
+        typename Tproxy
+        >
+    static Tproxy* split_bins(
+            const aabb<Tfloat, N>& box,
+            const aabb<Tfloat, N>& box_center,
+            const std::size_t split_dim,
+            iterator_range<Tproxy*> proxies,
+            const std::array<bin<Tfloat, N>, Nbins>& bins)
+    {
+        // Initialize sweeps.
+        std::array<bin<Tfloat, N>, Nbins - 1> lsweep;
+        std::array<bin<Tfloat, N>, Nbins - 1> rsweep; {
+            auto itrlsweep = lsweep.begin(), itrlbins = bins.begin();
+            auto itrrsweep = rsweep.rbegin(), itrrbins = bins.rbegin();
+            *itrlsweep++ = *itrlbins++;
+            *itrrsweep++ = *itrrbins++;
+            for (; itrlsweep < lsweep.end();
+                    ++itrlsweep, ++itrlbins,
+                    ++itrrsweep, ++itrrbins) {
+                itrlsweep->first = (itrlsweep - 1)->first | itrlbins->first;
+                itrrsweep->first = (itrrsweep - 1)->first | itrrbins->first;
+                itrlsweep->second = (itrlsweep - 1)->second + itrlbins->second;
+                itrrsweep->second = (itrrsweep - 1)->second + itrrbins->second;
+            }
+        }
+
+        // Compute costs.
+        std::array<Tfloat, Nbins - 1> costs; {
+            auto itrcosts = costs.begin();
+            auto itrlsweep = lsweep.begin();
+            auto itrrsweep = rsweep.begin();
+            for (; itrrsweep < rsweep.end();
+                    ++itrcosts,
+                    ++itrlsweep,
+                    ++itrrsweep) {
+                *itrcosts =
+                    (itrlsweep->first.surface_area() * itrlsweep->second +
+                     itrrsweep->first.surface_area() * itrrsweep->second);
+            }
+        }
+
+        // Compute costs argmin.
+        std::size_t costs_argmin =
+            std::distance(
+                costs.begin(),
+                std::min_element(
+                    costs.begin(),
+                    costs.end()));
+
+        // Partition.
+        Tproxy* split =
+            std::partition(
+                proxies.begin(),
+                proxies.end(),
+                [=](const Tproxy& proxy) {
+                    Tfloat cen = proxy.box_center[split_dim];
+                    Tfloat cenmin = box_center[0][split_dim];
+                    Tfloat cenmax = box_center[1][split_dim];
+                    std::size_t pos =
+                    std::min<std::size_t>(
+                        Nbins * ((cen - cenmin) / (cenmax - cenmin)),
+                        Nbins - 1);
+                    return pos <= costs_argmin;
+                });
+
+        // Partition successful?
+        if (split != proxies.begin() &&
+            split != proxies.end()) {
+            return split;
+        }
+        else {
+            // Default to equal counts.
+            return aabbtree_split_equal_counts()(
+                        box,
+                        box_center,
+                        split_dim,
+                        proxies);
+        }
+    }
+};
+
+/**
+ * @brief Linear axis-aligned bounding box tree.
+ *
+ * @tparam Tfloat
+ * Float type.
+ *
+ * @tparam N
+ * Dimension.
+ *
+ * @tparam Talloc
+ * Allocator type.
+ */
+template <
+    typename Tfloat, std::size_t N,
+    typename Talloc = std::allocator<char>
+    >
+class linear_aabbtree
+{
+public:
+
+    // Sanity check.
+    static_assert(
+        std::is_floating_point<Tfloat>::value,
+        "Tfloat must be floating point");
+
+#if !DOXYGEN
+
+    struct node_type;
+
+#endif // #if !DOXYGEN
+
+    /**
+     * @name Container typedefs
+     */
+    /**@{*/
+
+    /**
+     * @brief Size type.
+     */
+    typedef std::size_t size_type;
+
+    /**
+     * @brief Float type.
+     */
+    typedef Tfloat float_type;
+
+    /**
+     * @brief Axis-aligned bounding box type.
+     */
+    typedef aabb<Tfloat, N> aabb_type;
+
+    /**
+     * @brief Node allocator type.
+     */
+    typedef typename std::allocator_traits<Talloc>::
+            template rebind_alloc<node_type> node_allocator_type;
+
+    /**@}*/
+
+public:
+
+    /**
+     * @brief Node type.
+     */
+    struct node_type
+    {
+    public:
+
+        /**
+         * @brief Box.
+         */
+        aabb_type box;
+
+        union {
+
+            /**
+             * @brief If branch, right child index.
+             */
+            std::uint32_t right_offset;
+
+            /**
+             * @brief If leaf, first proxy index.
+             */
+            std::uint32_t first_index;
+        };
+
+        /**
+         * @brief Proxy count.
+         */
+        std::uint8_t count;
+
+        /**
+         * @brief If branch, split dimension.
+         */
+        std::uint8_t split_dim;
+
+    public:
+
+        /**
+         * @name Traversal helpers
+         */
+        /**@{*/
+
+        /**
+         * @brief Is branch?
+         */
+        __attribute__((always_inline))
+        bool is_branch() const noexcept
+        {
+            return count == 0;
+        }
+
+        /**
+         * @brief Left child.
+         *
+         * @note
+         * This is only valid for branch nodes.
+         *
+         * @note
+         * This function assumes that `this` is a valid pointer
+         * to a node inside the parent node array. Hence, calling this
+         * on a copy is ill-defined.
+         */
+        __attribute__((always_inline))
+        const node_type* left_child() const noexcept
+        {
+            assert(count == 0);
+            return this + 1;
+        }
+
+        /**
+         * @brief Right child.
+         *
+         * @note
+         * This is only valid for branch nodes.
+         *
+         * @note
+         * This function assumes that `this` is a valid pointer
+         * to a node inside the parent node array. Hence, calling this
+         * on a copy is ill-defined.
+         */
+        __attribute__((always_inline))
+        const node_type* right_child() const noexcept
+        {
+            assert(count == 0);
+            return this + right_offset;
+        }
+
+        /**@}*/
+    };
+
+public:
+
+    /**
+     * @name Constructors
+     */
+    /**@{*/
+
+    /**
+     * @brief Default constructor.
+     */
+    linear_aabbtree() = default;
+
+    /**
+     * @brief Constructor.
+     */
+    template <typename... Tother>
+    linear_aabbtree(
+            const aabbtree<Tfloat, N, Tother...>& tree,
+            const Talloc& alloc = Talloc()) :
+                nodes_(alloc)
+    {
+        // Reserve memory.
+        nodes_.reserve(
+            size_type(tree.node_count_));
+
+        // Initialize.
+        if (tree.root_) {
+            init_recursive(tree.root_);
+            assert(nodes_.size() ==
+                   size_type(tree.node_count_));
+            nodes_.shrink_to_fit();
+        }
+    }
+
+    /**@}*/
+
+public:
+
+    /**
+     * @name Container interface
+     */
+    /**@{*/
+
+    /**
+     * @brief Empty?
+     */
+    __attribute__((always_inline))
+    bool empty() const noexcept
+    {
+        return size() == 0;
+    }
+
+    /**
+     * @brief Size.
+     */
+    __attribute__((always_inline))
+    size_type size() const noexcept
+    {
+        return mapped_nodes_ ? mapped_size_ : nodes_.size();
+    }
+
+    /**
+     * @brief Begin iterator.
+     *
+     * @note
+     * If empty, returns nullptr.
+     */
+    __attribute__((always_inline))
+    const node_type* begin() const noexcept
+    {
+        if (mapped_nodes_) {
+            return mapped_nodes_;
+        }
+        else if (nodes_.empty()) {
+            return nullptr;
+        }
+        else {
+            return &nodes_[0];
+        }
+    }
+
+    /**
+     * @brief End iterator.
+     *
+     * @note
+     * If empty, returns nullptr.
+     */
+    __attribute__((always_inline))
+    const node_type* end() const noexcept
+    {
+        if (empty()) {
+            return nullptr;
+        }
+        else {
+            return begin() + size();
+        }
+    }
+
+    /**
+     * @brief Index accessor.
+     */
+    __attribute__((always_inline))
+    const node_type& operator[](size_type pos) const noexcept
+    {
+        return begin()[pos];
+    }
+
+    /**@}*/
+
+public:
+
+    /**
+     * @name Ray traversal
+     */
+    /**@{*/
+
+    /**
+     * @brief Index meaning no proxy.
+     */
+    static constexpr size_type npos = size_type(-1);
+
+    /**
+     * @brief Ray traversal, any hit.
+     *
+     * @param[in] ray_org
+     * Ray origin.
+     *
+     * @param[in] ray_dir
+     * Ray direction.
+     *
+     * @param[in] ray_tmin
+     * Ray parameter minimum.
+     *
+     * @param[in] ray_tmax
+     * Ray parameter maximum.
+     *
+     * @param[in] func
+     * Proxy intersection function.
+     *
+     * @note
+     * Function must have signature equivalent to
+     * ~~~~~~~~~~~~~~~~~~~~~~~~~{cpp}
+     * bool(size_type index, float_type ray_tmin, float_type& ray_tmax)
+     * ~~~~~~~~~~~~~~~~~~~~~~~~~
+     * where `index` is the proxy index, in the order given by
+     * `aabbtree::sort()`. On hit, the function must return true, and
+     * should shorten `ray_tmax` to the hit parameter.
+     *
+     * @returns
+     * If any proxy is hit, returns true and stops immediately.
+     */
+    template <typename Tfunc>
+    bool ray_any_hit(
+            const multi<float_type, N>& ray_org,
+            const multi<float_type, N>& ray_dir,
+            float_type ray_tmin,
+            float_type ray_tmax,
+            Tfunc&& func) const
+    {
+        return ray_traverse_<true>(
+                ray_org, ray_dir,
+                ray_tmin, ray_tmax,
+                std::forward<Tfunc>(func)) != npos;
+    }
+
+    /**
+     * @brief Ray traversal, closest hit.
+     *
+     * @param[in] ray_org
+     * Ray origin.
+     *
+     * @param[in] ray_dir
+     * Ray direction.
+     *
+     * @param[in] ray_tmin
+     * Ray parameter minimum.
+     *
+     * @param[inout] ray_tmax
+     * Ray parameter maximum. On hit, shortened to the closest hit
+     * parameter by the proxy intersection function.
+     *
+     * @param[in] func
+     * Proxy intersection function, as in `ray_any_hit()`.
+     *
+     * @returns
+     * Index of closest proxy hit, or `npos` if none.
+     */
+    template <typename Tfunc>
+    size_type ray_closest_hit(
+            const multi<float_type, N>& ray_org,
+            const multi<float_type, N>& ray_dir,
+            float_type ray_tmin,
+            float_type& ray_tmax,
+            Tfunc&& func) const
+    {
+        return ray_traverse_<false>(
+                ray_org, ray_dir,
+                ray_tmin, ray_tmax,
+                std::forward<Tfunc>(func));
+    }
+
+    /**
+     * @brief Ray test against box.
+     *
+     * @param[in] box
+     * Box.
+     *
+     * @param[in] ray_org
+     * Ray origin.
+     *
+     * @param[in] ray_dir_inv
+     * Ray direction inverse.
+     *
+     * @param[in] ray_dir_neg
+     * Ray direction sign bits, as 0 or 1.
+     *
+     * @param[in] ray_tmin
+     * Ray parameter minimum.
+     *
+     * @param[in] ray_tmax
+     * Ray parameter maximum.
+     *
+     * @note
+     * The far parameter is scaled up by a few ulps, so the test is
+     * conservative under rounding. Slabs which yield NaN, because the
+     * origin is on the slab and the direction is parallel, are ignored.
+     */
+    __attribute__((always_inline))
+    static bool ray_test(
+            const aabb_type& box,
+            const multi<float_type, N>& ray_org,
+            const multi<float_type, N>& ray_dir_inv,
+            const multi<int, N>& ray_dir_neg,
+            float_type ray_tmin,
+            float_type ray_tmax) noexcept
+    {
+        for (size_type k = 0; k < N; k++) {
+            float_type t0 =
+                (box[    ray_dir_neg[k]][k] - ray_org[k]) * ray_dir_inv[k];
+            float_type t1 =
+                (box[1 - ray_dir_neg[k]][k] - ray_org[k]) * ray_dir_inv[k];
+            t1 *= 1 + 4 * pre::numeric_limits<float_type>::epsilon();
+            ray_tmin = t0 > ray_tmin ? t0 : ray_tmin;
+            ray_tmax = t1 < ray_tmax ? t1 : ray_tmax;
+        }
+        return ray_tmin <= ray_tmax;
+    }
+
+    /**@}*/
+
+public:
+
+    /**
+     * @name Packet ray traversal
+     */
+    /**@{*/
+
+    /**
+     * @brief Ray packet.
+     *
+     * Structure-of-arrays layout, such that each node box is
+     * tested against all lanes at once. With `-march=native`, the
+     * lane loops compile to packed SIMD instructions.
+     */
+    template <size_type P>
+    struct ray_packet
+    {
+        // Sanity check.
+        static_assert(
+            P > 0 && P <= 32,
+            "P must be in [1, 32]");
+
+        /**
+         * @brief Ray origins.
+         */
+        multi<multi<float_type, P>, N> org;
+
+        /**
+         * @brief Ray directions.
+         */
+        multi<multi<float_type, P>, N> dir;
+
+        /**
+         * @brief Ray parameter minimums.
+         */
+        multi<float_type, P> tmin;
+
+        /**
+         * @brief Ray parameter maximums.
+         */
+        multi<float_type, P> tmax;
+    };
+
+    /**
+     * @brief Packet ray traversal, any hit.
+     *
+     * @param[in] packet
+     * Ray packet.
+     *
+     * @param[in] mask
+     * Active lane mask.
+     *
+     * @param[in] func
+     * Proxy intersection function.
+     *
+     * @note
+     * Function must have signature equivalent to
+     * ~~~~~~~~~~~~~~~~~~~~~~~~~{cpp}
+     * bool(size_type index, size_type lane,
+     *      float_type ray_tmin, float_type& ray_tmax)
+     * ~~~~~~~~~~~~~~~~~~~~~~~~~
+     * as in `ray_any_hit()`, where `lane` is the packet lane. Lanes
+     * retire from the active mask on their first hit.
+     *
+     * @returns
+     * Mask of lanes which hit any proxy.
+     */
+    template <size_type P, typename Tfunc>
+    std::uint32_t ray_packet_any_hit(
+            const ray_packet<P>& packet,
+            std::uint32_t mask,
+            Tfunc&& func) const
+    {
+        multi<float_type, P> ray_tmax = packet.tmax;
+        multi<size_type, P> hit_index;
+        return ray_packet_traverse_<true>(
+                packet, ray_tmax, hit_index, mask,
+                std::forward<Tfunc>(func));
+    }
+
+    /**
+     * @brief Packet ray traversal, closest hit.
+     *
+     * @param[inout] packet
+     * Ray packet. On hit, parameter maximums are shortened
+     * by the proxy intersection function.
+     *
+     * @param[out] hit_index
+     * Index of closest proxy hit for each lane, or `npos` if none.
+     *
+     * @param[in] mask
+     * Active lane mask.
+     *
+     * @param[in] func
+     * Proxy intersection function, as in `ray_packet_any_hit()`.
+     *
+     * @returns
+     * Mask of lanes which hit any proxy.
+     */
+    template <size_type P, typename Tfunc>
+    std::uint32_t ray_packet_closest_hit(
+            ray_packet<P>& packet,
+            multi<size_type, P>& hit_index,
+            std::uint32_t mask,
+            Tfunc&& func) const
+    {
+        return ray_packet_traverse_<false>(
+                packet, packet.tmax, hit_index, mask,
+                std::forward<Tfunc>(func));
+    }
+
+    /**
+     * @brief Stream ray traversal, any hit.
+     *
+     * Regroups incoherent rays into packets of `P` rays sharing
+     * the same direction octant, then traverses packet by packet.
+     *
+     * @param[in] count
+     * Ray count.
+     *
+     * @param[in] ray_org
+     * Ray origins.
+     *
+     * @param[in] ray_dir
+     * Ray directions.
+     *
+     * @param[in] ray_tmin
+     * Ray parameter minimums.
+     *
+     * @param[in] ray_tmax
+     * Ray parameter maximums.
+     *
+     * @param[out] hit_index
+     * Index of proxy hit for each ray, or `npos` if none.
+     *
+     * @param[in] func
+     * Proxy intersection function, as in `ray_packet_any_hit()`,
+     * except that `lane` is the index of the ray in the stream.
+     *
+     * @returns
+     * Number of rays which hit any proxy.
+     */
+    template <size_type P = 8, typename Tfunc>
+    size_type ray_stream_any_hit(
+            size_type count,
+            const multi<float_type, N>* ray_org,
+            const multi<float_type, N>* ray_dir,
+            const float_type* ray_tmin,
+            const float_type* ray_tmax,
+            size_type* hit_index,
+            Tfunc&& func) const
+    {
+        return ray_stream_traverse_<true, P>(
+                count,
+                ray_org, ray_dir,
+                ray_tmin, ray_tmax,
+                hit_index,
+                std::forward<Tfunc>(func));
+    }
+
+    /**
+     * @brief Stream ray traversal, closest hit.
+     *
+     * @param[in] count
+     * Ray count.
+     *
+     * @param[in] ray_org
+     * Ray origins.
+     *
+     * @param[in] ray_dir
+     * Ray directions.
+     *
+     * @param[in] ray_tmin
+     * Ray parameter minimums.
+     *
+     * @param[inout] ray_tmax
+     * Ray parameter maximums. On hit, shortened to the closest hit
+     * parameter by the proxy intersection function.
+     *
+     * @param[out] hit_index
+     * Index of closest proxy hit for each ray, or `npos` if none.
+     *
+     * @param[in] func
+     * Proxy intersection function, as in `ray_stream_any_hit()`.
+     *
+     * @returns
+     * Number of rays which hit any proxy.
+     */
+    template <size_type P = 8, typename Tfunc>
+    size_type ray_stream_closest_hit(
+            size_type count,
+            const multi<float_type, N>* ray_org,
+            const multi<float_type, N>* ray_dir,
+            const float_type* ray_tmin,
+            float_type* ray_tmax,
+            size_type* hit_index,
+            Tfunc&& func) const
+    {
+        return ray_stream_traverse_<false, P>(
+                count,
+                ray_org, ray_dir,
+                ray_tmin, ray_tmax,
+                hit_index,
+                std::forward<Tfunc>(func));
+    }
+
+    /**@}*/
+
+public:
+
+    /**
+     * @name Serialization
+     *
+     * Flat binary layout, with all fields in the recorded byte order:
+     *
+     * Bytes | Field
+     * ------|-------
+     * 8     | Magic `"PREFORMB"`
+     * 4     | Version, currently 1
+     * 4     | Byte order, 0 for little or 1 for big endian
+     * 4     | Dimensions
+     * 4     | Float size, in bytes
+     * 4     | Node size, in bytes
+     * 4     | Reserved, 0
+     * 8     | Node count
+     * 24    | Padding, 0
+     *
+     * Nodes follow at byte offset 64 in their in-memory layout, with
+     * padding zeroed. Child offsets and proxy indices are relative,
+     * so nodes written in host byte order can be read in place, e.g.,
+     * from a `mapped_file`, without any fixup.
+     */
+    /**@{*/
+
+    /**
+     * @brief Header size, in bytes.
+     */
+    static constexpr size_type header_size = 64;
+
+    /**
+     * @brief Write.
+     *
+     * @param[in] os
+     * Output stream, in binary mode.
+     *
+     * @param[in] order
+     * Byte order. By default, host byte order.
+     *
+     * @throw std::runtime_error
+     * If writing fails.
+     */
+    void write(std::ostream& os, byte_order order = host_byte_order()) const
+    {
+        bool rev = order != host_byte_order();
+
+        // Header.
+        char padding[24] = {};
+        os.write("PREFORMB", 8);
+        byte_stream(os, order)
+            << std::uint32_t(1)
+            << std::uint32_t(order)
+            << std::uint32_t(N)
+            << std::uint32_t(sizeof(float_type))
+            << std::uint32_t(sizeof(node_type))
+            << std::uint32_t(0)
+            << std::uint64_t(size());
+        os.write(padding, sizeof(padding));
+
+        // Nodes, in buffered chunks.
+        constexpr size_type chunk = 256;
+        node_type buffer[chunk];
+        for (size_type k = 0; k < size(); k += chunk) {
+            size_type n = std::min(chunk, size() - k);
+            std::memset(static_cast<void*>(&buffer[0]), 0, sizeof(buffer));
+            for (size_type l = 0; l < n; l++) {
+                const node_type& node = begin()[k + l];
+                buffer[l].box = node.box;
+                buffer[l].right_offset = node.right_offset;
+                buffer[l].count = node.count;
+                buffer[l].split_dim = node.split_dim;
+                if (rev) {
+                    byte_swap_node_(buffer[l]);
+                }
+            }
+            os.write(
+                static_cast<const char*>(
+                static_cast<const void*>(&buffer[0])),
+                n * sizeof(node_type));
+        }
+        if (!os) {
+            throw std::runtime_error(__PRETTY_FUNCTION__);
+        }
+    }
+
+    /**
+     * @brief Read, into owned storage.
+     *
+     * @param[in] is
+     * Input stream, in binary mode.
+     *
+     * @throw std::runtime_error
+     * If reading fails or the header does not match.
+     */
+    void read(std::istream& is)
+    {
+        char header[header_size];
+        if (!is.read(header, header_size)) {
+            throw std::runtime_error(__PRETTY_FUNCTION__);
+        }
+        bool rev = false;
+        size_type count = read_header_(header, rev);
+        std::vector<
+                node_type,
+                node_allocator_type> nodes(count, nodes_.get_allocator());
+        if (count > 0 &&
+            !is.read(
+                static_cast<char*>(static_cast<void*>(nodes.data())),
+                count * sizeof(node_type))) {
+            throw std::runtime_error(__PRETTY_FUNCTION__);
+        }
+        if (rev) {
+            for (node_type& node : nodes) {
+                byte_swap_node_(node);
+            }
+        }
+        nodes_.swap(nodes);
+        mapped_nodes_ = nullptr;
+        mapped_size_ = 0;
+    }
+
+    /**
+     * @brief Map, in place.
+     *
+     * If the data is in host byte order and suitably aligned, as
+     * in a `mapped_file`, refers to the nodes in place, so the
+     * data must outlive the tree or the next call to `map()` or
+     * `read()`. Otherwise, copies the nodes into owned storage,
+     * swapping byte order if necessary.
+     *
+     * @param[in] data
+     * Data, as written by `write()`.
+     *
+     * @param[in] data_size
+     * Data size, in bytes.
+     *
+     * @throw std::runtime_error
+     * If the data is too small or the header does not match.
+     *
+     * @note
+     * Nodes are not otherwise validated, so the data must come
+     * from a trusted source.
+     */
+    void map(const char* data, size_type data_size)
+    {
+        if (data == nullptr || data_size < header_size) {
+            throw std::runtime_error(__PRETTY_FUNCTION__);
+        }
+        bool rev = false;
+        size_type count = read_header_(data, rev);
+        if ((data_size - header_size) / sizeof(node_type) < count) {
+            throw std::runtime_error(__PRETTY_FUNCTION__);
+        }
+        const char* first = data + header_size;
+        std::vector<
+                node_type,
+                node_allocator_type> nodes(nodes_.get_allocator());
+        mapped_nodes_ = nullptr;
+        mapped_size_ = 0;
+        if (!rev &&
+            reinterpret_cast<std::uintptr_t>(first) %
+                    alignof(node_type) == 0) {
+            if (count > 0) {
+                mapped_nodes_ = reinterpret_cast<const node_type*>(first);
+                mapped_size_ = count;
+            }
+        }
+        else {
+            nodes.resize(count);
+            std::memcpy(
+                static_cast<void*>(nodes.data()), first,
+                count * sizeof(node_type));
+            if (rev) {
+                for (node_type& node : nodes) {
+                    byte_swap_node_(node);
+                }
+            }
+        }
+        nodes_.swap(nodes);
+    }
+
+    /**
+     * @brief Refers to mapped nodes in place?
+     */
+    bool mapped() const noexcept
+    {
+        return mapped_nodes_ != nullptr;
+    }
+
+    /**@}*/
+
+private:
+
+    /**
+     * @brief Nodes.
+     */
+    std::vector<
+            node_type,
+            node_allocator_type> nodes_;
+
+    /**
+     * @brief Mapped nodes, or nullptr if nodes are owned.
+     */
+    const node_type* mapped_nodes_ = nullptr;
+
+    /**
+     * @brief Mapped node count.
+     */
+    size_type mapped_size_ = 0;
+
+    /**
+     * @brief Read header, return node count.
+     *
+     * @param[in] header
+     * Header, of `header_size` bytes.
+     *
+     * @param[out] rev
+     * Written in the other byte order?
+     *
+     * @throw std::runtime_error
+     * If the header does not match.
+     */
+    static size_type read_header_(const char* header, bool& rev)
+    {
+        if (std::memcmp(header, "PREFORMB", 8) != 0) {
+            throw std::runtime_error(__PRETTY_FUNCTION__);
+        }
+        std::uint32_t fields[6];
+        std::uint64_t count = 0;
+        std::memcpy(fields, header + 8, sizeof(fields));
+        std::memcpy(&count, header + 32, sizeof(count));
+
+        // Written in the other byte order?
+        std::uint32_t order = std::uint32_t(host_byte_order());
+        rev = fields[1] != order;
+        if (rev) {
+            byte_swap(&fields[0], 6);
+            byte_swap(&count, 1);
+            order = 1 - order;
+        }
+        if (fields[0] != 1 ||
+            fields[1] != order ||
+            fields[2] != N ||
+            fields[3] != sizeof(float_type) ||
+            fields[4] != sizeof(node_type)) {
+            throw std::runtime_error(__PRETTY_FUNCTION__);
+        }
+        return size_type(count);
+    }
+
+    /**
+     * @brief Byte swap node fields.
+     */
+    static void byte_swap_node_(node_type& node) noexcept
+    {
+        byte_swap(&node.box[0][0], N);
+        byte_swap(&node.box[1][0], N);
+        byte_swap(&node.right_offset, 1);
+    }
+
+    /**
+     * @brief Ray traversal.
+     *
+     * Visits the near child first, according to the sign of
+     * the ray direction along the split dimension, and keeps far
+     * children on a fixed-size stack.
+     */
+    template <bool Tany_hit, typename Tfunc>
+    size_type ray_traverse_(
+            const multi<float_type, N>& ray_org,
+            const multi<float_type, N>& ray_dir,
+            float_type ray_tmin,
+            float_type& ray_tmax,
+            Tfunc&& func) const
+    {
+        if (empty()) {
+            return npos;
+        }
+
+        // Precompute inverse direction and sign bits.
+        multi<float_type, N> ray_dir_inv;
+        multi<int, N> ray_dir_neg;
+        for (size_type k = 0; k < N; k++) {
+            ray_dir_inv[k] = 1 / ray_dir[k];
+            ray_dir_neg[k] = std::signbit(ray_dir[k]) ? 1 : 0;
+        }
+
+        // Traverse.
+        size_type hit_index = npos;
+        aabbtree_stack_<const node_type*, 64> todo;
+        const node_type* node = begin();
+        while (1) {
+            aabbtree_count_node_(todo.size());
+            if (ray_test(
+                    node->box,
+                    ray_org,
+                    ray_dir_inv,
+                    ray_dir_neg,
+                    ray_tmin,
+                    ray_tmax)) {
+                if (node->is_branch()) {
+                    // Visit near child first.
+                    const node_type* child0 = node->left_child();
+                    const node_type* child1 = node->right_child();
+                    if (ray_dir_neg[node->split_dim]) {
+                        std::swap(child0, child1);
+                    }
+                    todo.push(child1);
+                    node = child0;
+                    continue;
+                }
+                else {
+                    // Test proxies.
+                    for (size_type index = node->first_index;
+                                   index < size_type(node->first_index) +
+                                           size_type(node->count);
+                                   index++) {
+                        aabbtree_count_primitive_();
+                        if (std::forward<Tfunc>(func)(
+                                index, ray_tmin, ray_tmax)) {
+                            hit_index = index;
+                            if constexpr (Tany_hit) {
+                                return hit_index;
+                            }
+                        }
+                    }
+                }
+            }
+            if (todo.empty()) {
+                break;
+            }
+            node = todo.pop();
+        }
+        return hit_index;
+    }
+
+    /**
+     * @brief Packet ray test against box.
+     *
+     * @note
+     * Unlike `ray_test()`, this takes the minimum and maximum of
+     * each slab rather than selecting planes by sign, so that the
+     * lane loops are branch-free.
+     */
+    template <size_type P>
+    __attribute__((always_inline))
+    static std::uint32_t ray_packet_test_(
+            const aabb_type& box,
+            const ray_packet<P>& packet,
+            const multi<multi<float_type, P>, N>& ray_dir_inv,
+            const multi<float_type, P>& ray_tmax) noexcept
+    {
+        multi<float_type, P> tnear = packet.tmin;
+        multi<float_type, P> tfar = ray_tmax;
+        for (size_type k = 0; k < N; k++) {
+            for (size_type lane = 0; lane < P; lane++) {
+                float_type t0 =
+                    (box[0][k] - packet.org[k][lane]) * ray_dir_inv[k][lane];
+                float_type t1 =
+                    (box[1][k] - packet.org[k][lane]) * ray_dir_inv[k][lane];
+                float_type tmin = t0 < t1 ? t0 : t1;
+                float_type tmax = t0 < t1 ? t1 : t0;
+                tmax *= 1 + 4 * pre::numeric_limits<float_type>::epsilon();
+                tnear[lane] = tmin > tnear[lane] ? tmin : tnear[lane];
+                tfar[lane] = tmax < tfar[lane] ? tmax : tfar[lane];
+            }
+        }
+        std::uint32_t mask = 0;
+        for (size_type lane = 0; lane < P; lane++) {
+            mask |= std::uint32_t(tnear[lane] <= tfar[lane]) << lane;
+        }
+        return mask;
+    }
+
+    /**
+     * @brief Packet ray traversal.
+     *
+     * Visits the near child first, according to the sign of the
+     * first active lane direction along the split dimension. Popped
+     * nodes are retested, so that lanes which have since hit something
+     * closer, or retired, drop out.
+     */
+    template <bool Tany_hit, size_type P, typename Tfunc>
+    std::uint32_t ray_packet_traverse_(
+            const ray_packet<P>& packet,
+            multi<float_type, P>& ray_tmax,
+            multi<size_type, P>& hit_index,
+            std::uint32_t mask,
+            Tfunc&& func) const
+    {
+        for (size_type lane = 0; lane < P; lane++) {
+            hit_index[lane] = npos;
+        }
+        mask &= std::uint32_t((std::uint64_t(1) << P) - 1);
+        if (empty() || !mask) {
+            return 0;
+        }
+
+        // Precompute inverse directions.
+        multi<multi<float_type, P>, N> ray_dir_inv;
+        for (size_type k = 0; k < N; k++) {
+            for (size_type lane = 0; lane < P; lane++) {
+                ray_dir_inv[k][lane] = 1 / packet.dir[k][lane];
+            }
+        }
+
+        // Traverse.
+        std::uint32_t hit_mask = 0;
+        aabbtree_stack_<const node_type*, 64> todo;
+        const node_type* node = begin();
+        while (1) {
+            aabbtree_count_node_(todo.size());
+            std::uint32_t node_mask =
+                ray_packet_test_(
+                    node->box,
+                    packet,
+                    ray_dir_inv,
+                    ray_tmax) & mask;
+            if (node_mask) {
+                if (node->is_branch()) {
+                    // Visit near child first.
+                    const node_type* child0 = node->left_child();
+                    const node_type* child1 = node->right_child();
+                    if (std::signbit(
+                            packet.dir[node->split_dim]
+                                      [pre::first1(node_mask)])) {
+                        std::swap(child0, child1);
+                    }
+                    todo.push(child1);
+                    node = child0;
+                    continue;
+                }
+                else {
+                    // Test proxies.
+                    for (size_type index = node->first_index;
+                                   index < size_type(node->first_index) +
+                                           size_type(node->count);
+                                   index++) {
+                        for (std::uint32_t bits = node_mask; bits;
+                                           bits &= bits - 1) {
+                            size_type lane = pre::first1(bits);
+                            aabbtree_count_primitive_();
+                            if (std::forward<Tfunc>(func)(
+                                    index, lane,
+                                    packet.tmin[lane],
+                                    ray_tmax[lane])) {
+                                hit_mask |= std::uint32_t(1) << lane;
+                                hit_index[lane] = index;
+                                if constexpr (Tany_hit) {
+                                    node_mask &= ~(std::uint32_t(1) << lane);
+                                    mask &= ~(std::uint32_t(1) << lane);
+                                }
+                            }
+                        }
+                    }
+                    if constexpr (Tany_hit) {
+                        if (!mask) {
+                            return hit_mask;
+                        }
+                    }
+                }
+            }
+            if (todo.empty()) {
+                break;
+            }
+            node = todo.pop();
+        }
+        return hit_mask;
+    }
+
+    /**
+     * @brief Stream ray traversal.
+     */
+    template <
+        bool Tany_hit, size_type P,
+        typename Tfloat_ptr, typename Tfunc
+        >
+    size_type ray_stream_traverse_(
+            size_type count,
+            const multi<float_type, N>* ray_org,
+            const multi<float_type, N>* ray_dir,
+            const float_type* ray_tmin,
+            Tfloat_ptr ray_tmax,
+            size_type* hit_index,
+            Tfunc&& func) const
+    {
+        // Sort rays by direction octant.
+        static_assert(N < 16, "N must be less than 16");
+        std::vector<size_type> octant_offset((size_type(1) << N) + 1);
+        std::vector<size_type> order(count);
+        auto octant = [&](size_type ray) {
+            size_type code = 0;
+            for (size_type k = 0; k < N; k++) {
+                code |= size_type(std::signbit(ray_dir[ray][k])) << k;
+            }
+            return code;
+        };
+        for (size_type ray = 0; ray < count; ray++) {
+            octant_offset[octant(ray) + 1]++;
+        }
+        for (size_type code = 1; code < octant_offset.size(); code++) {
+            octant_offset[code] += octant_offset[code - 1];
+        }
+        {
+            std::vector<size_type> octant_next(
+                    octant_offset.begin(),
+                    octant_offset.end() - 1);
+            for (size_type ray = 0; ray < count; ray++) {
+                order[octant_next[octant(ray)]++] = ray;
+            }
+        }
+
+        // Traverse packet by packet.
+        size_type hit_count = 0;
+        for (size_type code = 0; code + 1 < octant_offset.size(); code++) {
+            for (size_type first = octant_offset[code];
+                           first < octant_offset[code + 1]; first += P) {
+                size_type lanes = octant_offset[code + 1] - first;
+                if (lanes > P) {
+                    lanes = P;
+                }
+
+                // Gather.
+                ray_packet<P> packet;
+                multi<size_type, P> packet_hit_index;
+                for (size_type lane = 0; lane < P; lane++) {
+                    // Pad with copies of the first ray, masked off.
+                    size_type ray = order[first + (lane < lanes ? lane : 0)];
+                    for (size_type k = 0; k < N; k++) {
+                        packet.org[k][lane] = ray_org[ray][k];
+                        packet.dir[k][lane] = ray_dir[ray][k];
+                    }
+                    packet.tmin[lane] = ray_tmin[ray];
+                    packet.tmax[lane] = ray_tmax[ray];
+                }
+                std::uint32_t hit_mask =
+                    ray_packet_traverse_<Tany_hit>(
+                        packet,
+                        packet.tmax,
+                        packet_hit_index,
+                        std::uint32_t((std::uint64_t(1) << lanes) - 1),
+                        [&](size_type index, size_type lane,
+                            float_type tmin, float_type& tmax) {
+                            return std::forward<Tfunc>(func)(
+                                    index, order[first + lane], tmin, tmax);
+                        });
+
+                // Scatter.
+                for (size_type lane = 0; lane < lanes; lane++) {
+                    size_type ray = order[first + lane];
+                    if constexpr (!Tany_hit) {
+                        ray_tmax[ray] = packet.tmax[lane];
+                    }
+                    hit_index[ray] = packet_hit_index[lane];
+                    hit_count += (hit_mask >> lane) & 1;
+                }
+            }
+        }
+        return hit_count;
+    }
+
+private:
+
+    /**
+     * @brief Flatten.
+     */
+    template <typename Ttree_node>
+    void init_recursive(Ttree_node* tree_node)
+    {
+        // Sanity check.
+        assert(tree_node);
+
+        // Next node.
+        nodes_.emplace_back();
+        size_type node_index = nodes_.size() - 1; // Remember index.
+        node_type& node = nodes_.back();
+        node.box = tree_node->box;
+
+        if (tree_node->count) {
+            // Sanity check.
+            assert(
+                !tree_node->left &&
+                !tree_node->right);
+            assert(
+                tree_node->count <
+                size_type(256));
+
+            // Initialize.
+            node.first_index = tree_node->first_index;
+            node.count = tree_node->count;
+        }
+        else {
+            // Sanity check.
+            assert(
+                tree_node->left &&
+                tree_node->right);
+
+            // Initialize left branch.
+            init_recursive(tree_node->left);
+
+            // Initialize.
+            node.right_offset = nodes_.size() - node_index;
+            node.split_dim = tree_node->split_dim;
+
+            // Initialize right branch.
+            init_recursive(tree_node->right);
+        }
+    }
+};
+
+/**
+ * @brief Template alias for convenience.
+ */
+template <
+    typename Tfloat,
+    typename Talloc = std::allocator<char>
+    >
+using linear_aabbtree2 = pre::linear_aabbtree<Tfloat, 2, Talloc>;
+
+/**
+ * @brief Template alias for convenience.
+ */
+template <
+    typename Tfloat,
+    typename Talloc = std::allocator<char>
+    >
+using linear_aabbtree3 = pre::linear_aabbtree<Tfloat, 3, Talloc>;
+
+/**
+ * @brief Wide axis-aligned bounding box tree.
+ *
+ * Collapses the binary `aabbtree` into `W`-wide nodes, storing
+ * child boxes in structure-of-arrays layout, such that all children
+ * of a node are tested against a ray at once. With `-march=native`,
+ * the child loops compile to packed SIMD instructions.
+ *
+ * @tparam Tfloat
+ * Float type.
+ *
+ * @tparam N
+ * Dimension.
+ *
+ * @tparam W
+ * Width, typically 4 or 8.
+ *
+ * @tparam Talloc
+ * Allocator type.
+ */
+template <
+    typename Tfloat, std::size_t N,
+    std::size_t W = 4,
+    typename Talloc = std::allocator<char>
+    >
+class wide_aabbtree
+{
+public:
+
+    // Sanity check.
+    static_assert(
+        std::is_floating_point<Tfloat>::value,
+        "Tfloat must be floating point");
+
+    // Sanity check.
+    static_assert(
+        W >= 2 && W <= 32,
+        "W must be in [2, 32]");
+
+#if !DOXYGEN
+
+    struct node_type;
+
+#endif // #if !DOXYGEN
+
+    /**
+     * @name Container typedefs
+     */
+    /**@{*/
+
+    /**
+     * @brief Size type.
+     */
+    typedef std::size_t size_type;
+
+    /**
+     * @brief Float type.
+     */
+    typedef Tfloat float_type;
+
+    /**
+     * @brief Axis-aligned bounding box type.
+     */
+    typedef aabb<Tfloat, N> aabb_type;
+
+    /**
+     * @brief Node allocator type.
+     */
+    typedef typename std::allocator_traits<Talloc>::
+            template rebind_alloc<node_type> node_allocator_type;
+
+    /**@}*/
+
+public:
+
+    /**
+     * @brief Node type.
+     */
+    struct node_type
+    {
+    public:
+
+        /**
+         * @brief Child boxes.
+         *
+         * Indexed as `child_box[0 or 1][dimension][child]`. Empty
+         * child slots, at and beyond `size`, hold empty boxes.
+         */
+        multi<multi<multi<float_type, W>, N>, 2> child_box;
+
+        /**
+         * @brief If branch child, node index, else first proxy index.
+         */
+        multi<std::uint32_t, W> child_index;
+
+        /**
+         * @brief If branch child, 0, else proxy count.
+         */
+        multi<std::uint8_t, W> child_count;
+
+        /**
+         * @brief Child count.
+         */
+        std::uint8_t size;
+
+    public:
+
+        /**
+         * @name Traversal helpers
+         */
+        /**@{*/
+
+        /**
+         * @brief Is child branch?
+         */
+        __attribute__((always_inline))
+        bool is_branch(size_type pos) const noexcept
+        {
+            return child_count[pos] == 0;
+        }
+
+        /**
+         * @brief Child box.
+         */
+        aabb_type box(size_type pos) const noexcept
+        {
+            aabb_type res;
+            for (size_type k = 0; k < N; k++) {
+                res[0][k] = child_box[0][k][pos];
+                res[1][k] = child_box[1][k][pos];
+            }
+            return res;
+        }
+
+        /**@}*/
+    };
+
+public:
+
+    /**
+     * @name Constructors
+     */
+    /**@{*/
+
+    /**
+     * @brief Default constructor.
+     */
+    wide_aabbtree() = default;
+
+    /**
+     * @brief Constructor.
+     */
+    template <typename... Tother>
+    wide_aabbtree(
+            const aabbtree<Tfloat, N, Tother...>& tree,
+            const Talloc& alloc = Talloc()) :
+                nodes_(alloc)
+    {
+        // Reserve memory, at worst one wide node per binary branch.
+        nodes_.reserve(
+            size_type(tree.node_count()) / 2 + 1);
+
+        // Initialize.
+        if (tree.root()) {
+            init_recursive(tree.root());
+            nodes_.shrink_to_fit();
+        }
+    }
+
+    /**@}*/
+
+public:
+
+    /**
+     * @name Container interface
+     */
+    /**@{*/
+
+    /**
+     * @brief Empty?
+     */
+    __attribute__((always_inline))
+    bool empty() const noexcept
+    {
+        return nodes_.empty();
+    }
+
+    /**
+     * @brief Size.
+     */
+    __attribute__((always_inline))
+    size_type size() const noexcept
+    {
+        return nodes_.size();
+    }
+
+    /**
+     * @brief Begin iterator.
+     *
+     * @note
+     * If `nodes_` is empty, returns nullptr.
+     */
+    __attribute__((always_inline))
+    const node_type* begin() const noexcept
+    {
+        if (nodes_.empty()) {
+            return nullptr;
+        }
+        else {
+            return &nodes_[0];
+        }
+    }
+
+    /**
+     * @brief End iterator.
+     *
+     * @note
+     * If `nodes_` is empty, returns nullptr.
+     */
+    __attribute__((always_inline))
+    const node_type* end() const noexcept
+    {
+        if (nodes_.empty()) {
+            return nullptr;
+        }
+        else {
+            return &nodes_[0] + nodes_.size();
+        }
+    }
+
+    /**
+     * @brief Index accessor.
+     */
+    __attribute__((always_inline))
+    const node_type& operator[](size_type pos) const noexcept
+    {
+        return nodes_[pos];
+    }
+
+    /**@}*/
+
+public:
+
+    /**
+     * @name Ray traversal
+     */
+    /**@{*/
+
+    /**
+     * @brief Index meaning no proxy.
+     */
+    static constexpr size_type npos = size_type(-1);
+
+    /**
+     * @brief Ray traversal, any hit.
+     *
+     * @param[in] ray_org
+     * Ray origin.
+     *
+     * @param[in] ray_dir
+     * Ray direction.
+     *
+     * @param[in] ray_tmin
+     * Ray parameter minimum.
+     *
+     * @param[in] ray_tmax
+     * Ray parameter maximum.
+     *
+     * @param[in] func
+     * Proxy intersection function, as in
+     * `linear_aabbtree::ray_any_hit()`.
+     *
+     * @returns
+     * If any proxy is hit, returns true and stops immediately.
+     */
+    template <typename Tfunc>
+    bool ray_any_hit(
+            const multi<float_type, N>& ray_org,
+            const multi<float_type, N>& ray_dir,
+            float_type ray_tmin,
+            float_type ray_tmax,
+            Tfunc&& func) const
+    {
+        return ray_traverse_<true>(
+                ray_org, ray_dir,
+                ray_tmin, ray_tmax,
+                std::forward<Tfunc>(func)) != npos;
+    }
+
+    /**
+     * @brief Ray traversal, closest hit.
+     *
+     * @param[in] ray_org
+     * Ray origin.
+     *
+     * @param[in] ray_dir
+     * Ray direction.
+     *
+     * @param[in] ray_tmin
+     * Ray parameter minimum.
+     *
+     * @param[inout] ray_tmax
+     * Ray parameter maximum. On hit, shortened to the closest hit
+     * parameter by the proxy intersection function.
+     *
+     * @param[in] func
+     * Proxy intersection function, as in
+     * `linear_aabbtree::ray_any_hit()`.
+     *
+     * @returns
+     * Index of closest proxy hit, or `npos` if none.
+     */
+    template <typename Tfunc>
+    size_type ray_closest_hit(
+            const multi<float_type, N>& ray_org,
+            const multi<float_type, N>& ray_dir,
+            float_type ray_tmin,
+            float_type& ray_tmax,
+            Tfunc&& func) const
+    {
+        return ray_traverse_<false>(
+                ray_org, ray_dir,
+                ray_tmin, ray_tmax,
+                std::forward<Tfunc>(func));
+    }
+
+    /**@}*/
+
+private:
+
+    /**
+     * @brief Nodes.
+     */
+    std::vector<
+            node_type,
+            node_allocator_type> nodes_;
+
+    /**
+     * @brief Ray test against all children of node.
+     *
+     * @returns
+     * Mask of children hit, with entry parameters in `tnear`.
+     */
+    __attribute__((always_inline))
+    static std::uint32_t ray_test_(
+            const node_type& node,
+            const multi<float_type, N>& ray_org,
+            const multi<float_type, N>& ray_dir_inv,
+            float_type ray_tmin,
+            float_type ray_tmax,
+            multi<float_type, W>& tnear) noexcept
+    {
+        multi<float_type, W> tfar;
+        for (size_type pos = 0; pos < W; pos++) {
+            tnear[pos] = ray_tmin;
+            tfar[pos] = ray_tmax;
+        }
+        for (size_type k = 0; k < N; k++) {
+            for (size_type pos = 0; pos < W; pos++) {
+                float_type t0 =
+                    (node.child_box[0][k][pos] - ray_org[k]) * ray_dir_inv[k];
+                float_type t1 =
+                    (node.child_box[1][k][pos] - ray_org[k]) * ray_dir_inv[k];
+                float_type tmin = t0 < t1 ? t0 : t1;
+                float_type tmax = t0 < t1 ? t1 : t0;
+                tmax *= 1 + 4 * pre::numeric_limits<float_type>::epsilon();
+                tnear[pos] = tmin > tnear[pos] ? tmin : tnear[pos];
+                tfar[pos] = tmax < tfar[pos] ? tmax : tfar[pos];
+            }
+        }
+        std::uint32_t mask = 0;
+        for (size_type pos = 0; pos < W; pos++) {
+            mask |= std::uint32_t(tnear[pos] <= tfar[pos]) << pos;
+        }
+        return mask;
+    }
+
+    /**
+     * @brief Ray traversal.
+     *
+     * Pushes children hit in far-to-near order, along with their
+     * entry parameters, such that popped children entered beyond the
+     * current closest hit are skipped.
+     */
+    template <bool Tany_hit, typename Tfunc>
+    size_type ray_traverse_(
+            const multi<float_type, N>& ray_org,
+            const multi<float_type, N>& ray_dir,
+            float_type ray_tmin,
+            float_type& ray_tmax,
+            Tfunc&& func) const
+    {
+        if (nodes_.empty()) {
+            return npos;
+        }
+
+        // Precompute inverse direction.
+        multi<float_type, N> ray_dir_inv;
+        for (size_type k = 0; k < N; k++) {
+            ray_dir_inv[k] = 1 / ray_dir[k];
         }
 
-        // Initialize sweeps.
-        std::array<bin, Nbins - 1> lsweep;
-        std::array<bin, Nbins - 1> rsweep; {
-            auto itrlsweep = lsweep.begin(), itrlbins = bins.begin();
-            auto itrrsweep = rsweep.rbegin(), itrrbins = bins.rbegin();
-            *itrlsweep++ = *itrlbins++;
-            *itrrsweep++ = *itrrbins++;
-            for (; itrlsweep < lsweep.end();
-                    ++itrlsweep, ++itrlbins,
-                    ++itrrsweep, ++itrrbins) {
-                itrlsweep->first = (itrlsweep - 1)->first | itrlbins->first;
-                itrrsweep->first = (itrrsweep - 1)->first | itrrbins->first;
-                itrlsweep->second = (itrlsweep - 1)->second + itrlbins->second;
-                itrrsweep->second = (itrrsweep - 1)->second + itrrbins->second;
+        // Traverse.
+        size_type hit_index = npos;
+        aabbtree_stack_<
+            std::pair<const node_type*, float_type>, 64 * W> todo;
+        todo.push({&nodes_[0], ray_tmin});
+        while (!todo.empty()) {
+            auto [node, node_tmin] = todo.pop();
+            if (node_tmin > ray_tmax) {
+                continue;
+            }
+            aabbtree_count_node_(todo.size() + 1);
+            multi<float_type, W> tnear;
+            std::uint32_t mask =
+                ray_test_(
+                    *node,
+                    ray_org,
+                    ray_dir_inv,
+                    ray_tmin,
+                    ray_tmax,
+                    tnear) &
+                    std::uint32_t((std::uint64_t(1) << node->size) - 1);
+
+            // Sort children hit far to near.
+            size_type order[W];
+            size_type order_size = 0;
+            for (; mask; mask &= mask - 1) {
+                size_type pos = pre::first1(mask);
+                size_type ins = order_size++;
+                for (; ins > 0 && tnear[order[ins - 1]] < tnear[pos]; ins--) {
+                    order[ins] = order[ins - 1];
+                }
+                order[ins] = pos;
             }
-        }
 
-        // Compute costs.
-        std::array<Tfloat, Nbins - 1> costs; {
-            auto itrcosts = costs.begin();
-            auto itrlsweep = lsweep.begin();
-            auto itrrsweep = rsweep.begin();
-            for (; itrrsweep < rsweep.end();
-                    ++itrcosts,
-                    ++itrlsweep,
-                    ++itrrsweep) {
-                *itrcosts =
-                    (itrlsweep->first.surface_area() * itrlsweep->second +
-                     itrrsweep->first.surface_area() * itrrsweep->second);
+            // Visit leaves now, push branches.
+            for (size_type ord = order_size; ord-- > 0;) {
+                size_type pos = order[ord];
+                if (node->is_branch(pos)) {
+                    continue;
+                }
+                if (tnear[pos] > ray_tmax) {
+                    continue;
+                }
+                for (size_type index = node->child_index[pos];
+                               index < size_type(node->child_index[pos]) +
+                                       size_type(node->child_count[pos]);
+                               index++) {
+                    aabbtree_count_primitive_();
+                    if (std::forward<Tfunc>(func)(
+                            index, ray_tmin, ray_tmax)) {
+                        hit_index = index;
+                        if constexpr (Tany_hit) {
+                            return hit_index;
+                        }
+                    }
+                }
+            }
+            for (size_type ord = 0; ord < order_size; ord++) {
+                size_type pos = order[ord];
+                if (node->is_branch(pos)) {
+                    todo.push({
+                        &nodes_[node->child_index[pos]],
+                        tnear[pos]
+                    });
+                }
             }
         }
+        return hit_index;
+    }
 
-        // Compute costs argmin.
-        std::size_t costs_argmin =
-            std::distance(
-                costs.begin(),
-                std::min_element(
-                    costs.begin(),
-                    costs.end()));
+private:
 
-        // Partition.
-        Tproxy* split =
-            std::partition(
-                proxies.begin(),
-                proxies.end(),
-                [=](const Tproxy& proxy) {
-                    Tfloat cen = proxy.box_center[split_dim];
-                    Tfloat cenmin = box_center[0][split_dim];
-                    Tfloat cenmax = box_center[1][split_dim];
-                    std::size_t pos =
-                    std::min<std::size_t>(
-                        Nbins * ((cen - cenmin) / (cenmax - cenmin)),
-                        Nbins - 1);
-                    return pos <= costs_argmin;
-                });
+    /**
+     * @brief Collapse.
+     */
+    template <typename Ttree_node>
+    void init_recursive(const Ttree_node* tree_node)
+    {
+        // Sanity check.
+        assert(tree_node);
 
-        // Partition successful?
-        if (split != proxies.begin() &&
-            split != proxies.end()) {
-            return split;
+        // Next node.
+        nodes_.emplace_back();
+        size_type node_index = nodes_.size() - 1; // Remember index.
+
+        // Gather children, repeatedly opening the branch child
+        // with the largest surface area.
+        const Ttree_node* children[W];
+        size_type size = 0;
+        if (tree_node->count) {
+            children[size++] = tree_node;
         }
         else {
-            // Default to equal counts.
-            return aabbtree_split_equal_counts()(
-                        box,
-                        box_center,
-                        split_dim,
-                        proxies);
+            children[size++] = tree_node->left;
+            children[size++] = tree_node->right;
+        }
+        while (size < W) {
+            size_type best = size;
+            float_type best_area = -1;
+            for (size_type pos = 0; pos < size; pos++) {
+                if (!children[pos]->count) {
+                    float_type area = children[pos]->box.surface_area();
+                    if (best_area < area) {
+                        best_area = area;
+                        best = pos;
+                    }
+                }
+            }
+            if (best == size) {
+                break;
+            }
+            const Ttree_node* child = children[best];
+            children[best] = child->left;
+            children[size++] = child->right;
+        }
+
+        // Initialize.
+        {
+            node_type& node = nodes_[node_index];
+            aabb_type empty_box;
+            for (size_type pos = 0; pos < W; pos++) {
+                const aabb_type& box =
+                    pos < size ? children[pos]->box : empty_box;
+                for (size_type k = 0; k < N; k++) {
+                    node.child_box[0][k][pos] = box[0][k];
+                    node.child_box[1][k][pos] = box[1][k];
+                }
+                node.child_index[pos] = 0;
+                node.child_count[pos] = 0;
+            }
+            node.size = size;
+        }
+
+        // Initialize children.
+        for (size_type pos = 0; pos < size; pos++) {
+            if (children[pos]->count) {
+                // Sanity check.
+                assert(
+                    children[pos]->count <
+                    size_type(256));
+                nodes_[node_index].child_index[pos] =
+                    children[pos]->first_index;
+                nodes_[node_index].child_count[pos] =
+                    children[pos]->count;
+            }
+            else {
+                nodes_[node_index].child_index[pos] = nodes_.size();
+                init_recursive(children[pos]);
+            }
         }
     }
 };
 
 /**
- * @brief Linear axis-aligned bounding box tree.
+ * @brief Template alias for convenience.
+ */
+template <
+    typename Tfloat,
+    std::size_t W = 4,
+    typename Talloc = std::allocator<char>
+    >
+using wide_aabbtree2 = pre::wide_aabbtree<Tfloat, 2, W, Talloc>;
+
+/**
+ * @brief Template alias for convenience.
+ */
+template <
+    typename Tfloat,
+    std::size_t W = 4,
+    typename Talloc = std::allocator<char>
+    >
+using wide_aabbtree3 = pre::wide_aabbtree<Tfloat, 3, W, Talloc>;
+
+/**
+ * @brief Quantized linear axis-aligned bounding box tree.
+ *
+ * Like `linear_aabbtree`, except that each node stores its box
+ * quantized to `Tquant` relative to the box of its parent, rounded
+ * outward such that decoded boxes always contain exact boxes. With
+ * 8-bit quantization in 3 dimensions, nodes are 12 bytes, rather than
+ * 32 bytes with `float` or 56 bytes with `double`.
  *
  * @tparam Tfloat
  * Float type.
@@ -875,14 +4510,18 @@ struct aabbtree_split_surface_area
  * @tparam N
  * Dimension.
  *
+ * @tparam Tquant
+ * Quantized type, either `std::uint8_t` or `std::uint16_t`.
+ *
  * @tparam Talloc
  * Allocator type.
  */
 template <
     typename Tfloat, std::size_t N,
+    typename Tquant = std::uint8_t,
     typename Talloc = std::allocator<char>
     >
-class linear_aabbtree
+class quantized_linear_aabbtree
 {
 public:
 
@@ -891,6 +4530,12 @@ public:
         std::is_floating_point<Tfloat>::value,
         "Tfloat must be floating point");
 
+    // Sanity check.
+    static_assert(
+        std::is_same<Tquant, std::uint8_t>::value ||
+        std::is_same<Tquant, std::uint16_t>::value,
+        "Tquant must be std::uint8_t or std::uint16_t");
+
 #if !DOXYGEN
 
     struct node_type;
@@ -935,9 +4580,19 @@ public:
     public:
 
         /**
-         * @brief Box.
+         * @brief Box, quantized relative to parent box.
          */
-        aabb_type box;
+        Tquant box[2][N];
+
+        /**
+         * @brief If branch, split dimension.
+         */
+        std::uint8_t split_dim;
+
+        /**
+         * @brief Proxy count.
+         */
+        std::uint8_t count;
 
         union {
 
@@ -952,16 +4607,6 @@ public:
             std::uint32_t first_index;
         };
 
-        /**
-         * @brief Proxy count.
-         */
-        std::uint8_t count;
-
-        /**
-         * @brief If branch, split dimension.
-         */
-        std::uint8_t split_dim;
-
     public:
 
         /**
@@ -982,12 +4627,8 @@ public:
          * @brief Left child.
          *
          * @note
-         * This is only valid for branch nodes.
-         *
-         * @note
-         * This function assumes that `this` is a valid pointer
-         * to a node inside the parent node array. Hence, calling this
-         * on a copy is ill-defined.
+         * This is only valid for branch nodes, and assumes that `this`
+         * is a valid pointer to a node inside the parent node array.
          */
         __attribute__((always_inline))
         const node_type* left_child() const noexcept
@@ -1000,12 +4641,8 @@ public:
          * @brief Right child.
          *
          * @note
-         * This is only valid for branch nodes.
-         *
-         * @note
-         * This function assumes that `this` is a valid pointer
-         * to a node inside the parent node array. Hence, calling this
-         * on a copy is ill-defined.
+         * This is only valid for branch nodes, and assumes that `this`
+         * is a valid pointer to a node inside the parent node array.
          */
         __attribute__((always_inline))
         const node_type* right_child() const noexcept
@@ -1014,6 +4651,20 @@ public:
             return this + right_offset;
         }
 
+        /**
+         * @brief Decode box, given decoded parent box.
+         */
+        __attribute__((always_inline))
+        aabb_type decode(const aabb_type& parent_box) const noexcept
+        {
+            aabb_type res;
+            for (size_type k = 0; k < N; k++) {
+                res[0][k] = decode_(parent_box, k, box[0][k]);
+                res[1][k] = decode_(parent_box, k, box[1][k]);
+            }
+            return res;
+        }
+
         /**@}*/
     };
 
@@ -1027,26 +4678,27 @@ public:
     /**
      * @brief Default constructor.
      */
-    linear_aabbtree() = default;
+    quantized_linear_aabbtree() = default;
 
     /**
      * @brief Constructor.
      */
     template <typename... Tother>
-    linear_aabbtree(
+    quantized_linear_aabbtree(
             const aabbtree<Tfloat, N, Tother...>& tree,
             const Talloc& alloc = Talloc()) :
                 nodes_(alloc)
     {
         // Reserve memory.
         nodes_.reserve(
-            size_type(tree.node_count_));
+            size_type(tree.node_count()));
 
         // Initialize.
-        if (tree.root_) {
-            init_recursive(tree.root_);
+        if (tree.root()) {
+            root_box_ = tree.root()->box;
+            init_recursive(tree.root(), root_box_);
             assert(nodes_.size() ==
-                   size_type(tree.node_count_));
+                   size_type(tree.node_count()));
             nodes_.shrink_to_fit();
         }
     }
@@ -1121,6 +4773,102 @@ public:
         return nodes_[pos];
     }
 
+    /**
+     * @brief Root box, relative to which the root node is quantized.
+     */
+    __attribute__((always_inline))
+    const aabb_type& root_box() const noexcept
+    {
+        return root_box_;
+    }
+
+    /**@}*/
+
+public:
+
+    /**
+     * @name Ray traversal
+     */
+    /**@{*/
+
+    /**
+     * @brief Index meaning no proxy.
+     */
+    static constexpr size_type npos = size_type(-1);
+
+    /**
+     * @brief Ray traversal, any hit.
+     *
+     * @param[in] ray_org
+     * Ray origin.
+     *
+     * @param[in] ray_dir
+     * Ray direction.
+     *
+     * @param[in] ray_tmin
+     * Ray parameter minimum.
+     *
+     * @param[in] ray_tmax
+     * Ray parameter maximum.
+     *
+     * @param[in] func
+     * Proxy intersection function, as in
+     * `linear_aabbtree::ray_any_hit()`.
+     *
+     * @returns
+     * If any proxy is hit, returns true and stops immediately.
+     */
+    template <typename Tfunc>
+    bool ray_any_hit(
+            const multi<float_type, N>& ray_org,
+            const multi<float_type, N>& ray_dir,
+            float_type ray_tmin,
+            float_type ray_tmax,
+            Tfunc&& func) const
+    {
+        return ray_traverse_<true>(
+                ray_org, ray_dir,
+                ray_tmin, ray_tmax,
+                std::forward<Tfunc>(func)) != npos;
+    }
+
+    /**
+     * @brief Ray traversal, closest hit.
+     *
+     * @param[in] ray_org
+     * Ray origin.
+     *
+     * @param[in] ray_dir
+     * Ray direction.
+     *
+     * @param[in] ray_tmin
+     * Ray parameter minimum.
+     *
+     * @param[inout] ray_tmax
+     * Ray parameter maximum. On hit, shortened to the closest hit
+     * parameter by the proxy intersection function.
+     *
+     * @param[in] func
+     * Proxy intersection function, as in
+     * `linear_aabbtree::ray_any_hit()`.
+     *
+     * @returns
+     * Index of closest proxy hit, or `npos` if none.
+     */
+    template <typename Tfunc>
+    size_type ray_closest_hit(
+            const multi<float_type, N>& ray_org,
+            const multi<float_type, N>& ray_dir,
+            float_type ray_tmin,
+            float_type& ray_tmax,
+            Tfunc&& func) const
+    {
+        return ray_traverse_<false>(
+                ray_org, ray_dir,
+                ray_tmin, ray_tmax,
+                std::forward<Tfunc>(func));
+    }
+
     /**@}*/
 
 private:
@@ -1132,13 +4880,156 @@ private:
             node_type,
             node_allocator_type> nodes_;
 
+    /**
+     * @brief Root box.
+     */
+    aabb_type root_box_;
+
+    /**
+     * @brief Quantized maximum.
+     */
+    static constexpr Tquant quant_max_ = Tquant(-1);
+
+    /**
+     * @brief Decode coordinate.
+     *
+     * @note
+     * The endpoints decode to the parent box exactly.
+     */
+    __attribute__((always_inline))
+    static float_type decode_(
+            const aabb_type& parent_box,
+            size_type k,
+            Tquant q) noexcept
+    {
+        if (q == quant_max_) {
+            return parent_box[1][k];
+        }
+        return parent_box[0][k] +
+               (parent_box[1][k] - parent_box[0][k]) *
+               (float_type(q) / float_type(quant_max_));
+    }
+
+    /**
+     * @brief Encode coordinate, rounding down or up.
+     */
+    static Tquant encode_(
+            const aabb_type& parent_box,
+            size_type k,
+            float_type x,
+            bool round_up) noexcept
+    {
+        float_type extent = parent_box[1][k] - parent_box[0][k];
+        if (!(extent > 0)) {
+            return round_up ? quant_max_ : Tquant(0);
+        }
+        float_type t = (x - parent_box[0][k]) / extent * quant_max_;
+        t = round_up ? std::ceil(t) : std::floor(t);
+        t = std::max(t, float_type(0));
+        t = std::min(t, float_type(quant_max_));
+        Tquant q = Tquant(t);
+
+        // Fix any rounding in decode.
+        if (round_up) {
+            while (q < quant_max_ && decode_(parent_box, k, q) < x) {
+                q++;
+            }
+        }
+        else {
+            while (q > 0 && decode_(parent_box, k, q) > x) {
+                q--;
+            }
+        }
+        return q;
+    }
+
+    /**
+     * @brief Ray traversal.
+     *
+     * As in `linear_aabbtree`, except that the stack also holds
+     * the decoded box of each far child.
+     */
+    template <bool Tany_hit, typename Tfunc>
+    size_type ray_traverse_(
+            const multi<float_type, N>& ray_org,
+            const multi<float_type, N>& ray_dir,
+            float_type ray_tmin,
+            float_type& ray_tmax,
+            Tfunc&& func) const
+    {
+        if (nodes_.empty()) {
+            return npos;
+        }
+
+        // Precompute inverse direction and sign bits.
+        multi<float_type, N> ray_dir_inv;
+        multi<int, N> ray_dir_neg;
+        for (size_type k = 0; k < N; k++) {
+            ray_dir_inv[k] = 1 / ray_dir[k];
+            ray_dir_neg[k] = std::signbit(ray_dir[k]) ? 1 : 0;
+        }
+
+        // Traverse.
+        size_type hit_index = npos;
+        aabbtree_stack_<
+            std::pair<const node_type*, aabb_type>, 64> todo;
+        const node_type* node = &nodes_[0];
+        aabb_type node_box = node->decode(root_box_);
+        while (1) {
+            aabbtree_count_node_(todo.size());
+            if (linear_aabbtree<Tfloat, N, Talloc>::ray_test(
+                    node_box,
+                    ray_org,
+                    ray_dir_inv,
+                    ray_dir_neg,
+                    ray_tmin,
+                    ray_tmax)) {
+                if (node->is_branch()) {
+                    // Visit near child first.
+                    const node_type* child0 = node->left_child();
+                    const node_type* child1 = node->right_child();
+                    if (ray_dir_neg[node->split_dim]) {
+                        std::swap(child0, child1);
+                    }
+                    todo.push({child1, child1->decode(node_box)});
+                    node_box = child0->decode(node_box);
+                    node = child0;
+                    continue;
+                }
+                else {
+                    // Test proxies.
+                    for (size_type index = node->first_index;
+                                   index < size_type(node->first_index) +
+                                           size_type(node->count);
+                                   index++) {
+                        aabbtree_count_primitive_();
+                        if (std::forward<Tfunc>(func)(
+                                index, ray_tmin, ray_tmax)) {
+                            hit_index = index;
+                            if constexpr (Tany_hit) {
+                                return hit_index;
+                            }
+                        }
+                    }
+                }
+            }
+            if (todo.empty()) {
+                break;
+            }
+            std::tie(node, node_box) = todo.pop();
+        }
+        return hit_index;
+    }
+
 private:
 
     /**
-     * @brief Flatten.
+     * @brief Flatten and quantize.
      */
     template <typename Ttree_node>
-    void init_recursive(Ttree_node* tree_node)
+    void init_recursive(
+            const Ttree_node* tree_node,
+            const aabb_type& parent_box)
     {
         // Sanity check.
         assert(tree_node);
@@ -1147,13 +5038,18 @@ private:
         nodes_.emplace_back();
         size_type node_index = nodes_.size() - 1; // Remember index.
         node_type& node = nodes_.back();
-        node.box = tree_node->box;
+        for (size_type k = 0; k < N; k++) {
+            node.box[0][k] =
+                encode_(parent_box, k, tree_node->box[0][k], false);
+            node.box[1][k] =
+                encode_(parent_box, k, tree_node->box[1][k], true);
+        }
+        node.split_dim = 0;
+        node.count = 0;
+        aabb_type node_box = node.decode(parent_box);
 
         if (tree_node->count) {
             // Sanity check.
-            assert(
-                !tree_node->left &&
-                !tree_node->right);
             assert(
                 tree_node->count <
                 size_type(256));
@@ -1163,20 +5059,15 @@ private:
             node.count = tree_node->count;
         }
         else {
-            // Sanity check.
-            assert(
-                tree_node->left &&
-                tree_node->right);
-
             // Initialize left branch.
-            init_recursive(tree_node->left);
+            init_recursive(tree_node->left, node_box);
 
             // Initialize.
-            node.right_offset = nodes_.size() - node_index;
-            node.split_dim = tree_node->split_dim;
+            nodes_[node_index].right_offset = nodes_.size() - node_index;
+            nodes_[node_index].split_dim = tree_node->split_dim;
 
             // Initialize right branch.
-            init_recursive(tree_node->right);
+            init_recursive(tree_node->right, node_box);
         }
     }
 };
@@ -1186,18 +5077,22 @@ private:
  */
 template <
     typename Tfloat,
+    typename Tquant = std::uint8_t,
     typename Talloc = std::allocator<char>
     >
-using linear_aabbtree2 = pre::linear_aabbtree<Tfloat, 2, Talloc>;
+using quantized_linear_aabbtree2 =
+      pre::quantized_linear_aabbtree<Tfloat, 2, Tquant, Talloc>;
 
 /**
  * @brief Template alias for convenience.
  */
 template <
     typename Tfloat,
+    typename Tquant = std::uint8_t,
     typename Talloc = std::allocator<char>
     >
-using linear_aabbtree3 = pre::linear_aabbtree<Tfloat, 3, Talloc>;
+using quantized_linear_aabbtree3 =
+      pre::quantized_linear_aabbtree<Tfloat, 3, Tquant, Talloc>;
 
 /**@}*/
 
@@ -47,9 +47,28 @@
 // for std::memcpy
 #include <cstring>
 
+// for std::bad_alloc
+#include <new>
+
 // for std::invalid_argument
 #include <stdexcept>
 
+#if defined(__linux__)
+
+// for mmap, munmap, madvise
+#include <sys/mman.h>
+
+// for SYS_mbind
+#include <sys/syscall.h>
+
+// for syscall
+#include <unistd.h>
+
+#endif // #if defined(__linux__)
+
+// for pre::allocator_stats
+#include <preform/allocator_stats.hpp>
+
 namespace pre {
 
 /**
@@ -198,8 +217,203 @@ inline void aligned_delete(void* ptr_aligned)
 #endif // #if (__cplusplus >= 201703L)
 }
 
+/**
+ * @brief Huge page mode.
+ */
+enum class huge_page_mode
+{
+    /**
+     * @brief No huge pages.
+     */
+    none,
+
+    /**
+     * @brief Transparent huge pages, by `madvise()`.
+     */
+    transparent,
+
+    /**
+     * @brief Explicit huge pages, by `MAP_HUGETLB`, falling back
+     * to transparent huge pages if none are reserved.
+     */
+    explicit_
+};
+
+/**
+ * @brief Huge page size, 2MB.
+ */
+constexpr std::size_t huge_page_size = std::size_t(1) << 21;
+
+/**
+ * @brief Huge page new.
+ *
+ * @param[in] size
+ * Size of allocation in bytes, rounded up to a multiple of
+ * `huge_page_size`.
+ *
+ * @param[in] mode
+ * Huge page mode.
+ *
+ * @param[in] numa_node
+ * Preferred NUMA node, or -1 for none.
+ *
+ * @throw std::bad_alloc
+ * If allocation fails.
+ *
+ * @note
+ * On Linux, this maps anonymous memory aligned to `huge_page_size`,
+ * then advises or binds it as requested. Failure to obtain huge pages
+ * or to bind is not an error, since the memory still works. On other
+ * platforms, this delegates to `aligned_new()` with `huge_page_size`
+ * alignment, and the mode and node are hints only.
+ */
+inline void* huge_page_new(
+                std::size_t size,
+                huge_page_mode mode = huge_page_mode::transparent,
+                int numa_node = -1)
+{
+    if (size == 0) {
+        return nullptr;
+    }
+
+    // Round size up to multiple of huge page size.
+    size = (size + huge_page_size - 1) & ~(huge_page_size - 1);
+
+#if defined(__linux__)
+
+    void* ptr = MAP_FAILED;
+#if defined(MAP_HUGETLB)
+    if (mode == huge_page_mode::explicit_) {
+        ptr = ::mmap(
+                nullptr, size,
+                PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    }
+#endif // #if defined(MAP_HUGETLB)
+    if (ptr == MAP_FAILED) {
+
+        // Over-map, then trim to huge page boundary.
+        char* base = static_cast<char*>(::mmap(
+                nullptr, size + huge_page_size,
+                PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+        if (static_cast<void*>(base) == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        std::uintptr_t base_addr = pointer_to_address(base);
+        std::size_t head =
+            ((base_addr + huge_page_size - 1) & ~(huge_page_size - 1)) -
+              base_addr;
+        if (head > 0) {
+            ::munmap(base, head);
+        }
+        ::munmap(base + head + size, huge_page_size - head);
+        ptr = base + head;
+
+#if defined(MADV_HUGEPAGE)
+        if (mode != huge_page_mode::none) {
+            ::madvise(ptr, size, MADV_HUGEPAGE);
+        }
+#endif // #if defined(MADV_HUGEPAGE)
+    }
+
+#if defined(SYS_mbind)
+    if (numa_node >= 0 &&
+        numa_node < int(8 * sizeof(unsigned long))) {
+        // Prefer node, without requiring libnuma.
+        const int mpol_preferred = 1;
+        unsigned long nodemask = 1ul << numa_node;
+        ::syscall(
+                SYS_mbind, ptr, size, mpol_preferred,
+                &nodemask, 8 * sizeof(unsigned long), 0u);
+    }
+#endif // #if defined(SYS_mbind)
+    return ptr;
+
+#else
+
+    (void) mode;
+    (void) numa_node;
+    void* ptr = aligned_new(huge_page_size, size);
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+
+#endif // #if defined(__linux__)
+}
+
+/**
+ * @brief Huge page delete.
+ *
+ * @param[in] ptr
+ * Pointer returned by `huge_page_new()`.
+ *
+ * @param[in] size
+ * Size passed to `huge_page_new()`.
+ */
+inline void huge_page_delete(void* ptr, std::size_t size)
+{
+    if (ptr == nullptr) {
+        return;
+    }
+
+#if defined(__linux__)
+
+    // Round size up to multiple of huge page size.
+    size = (size + huge_page_size - 1) & ~(huge_page_size - 1);
+    ::munmap(ptr, size);
+
+#else
+
+    (void) size;
+    aligned_delete(ptr);
+
+#endif // #if defined(__linux__)
+}
+
+#if PREFORM_ALLOCATOR_STATS || DOXYGEN
+
+#if !DOXYGEN
+
+// Aligned allocator statistics recorder.
+inline allocator_stats_recorder& aligned_allocator_stats_recorder_()
+{
+    static allocator_stats_recorder recorder;
+    return recorder;
+}
+
+#endif // #if !DOXYGEN
+
+/**
+ * @brief Aligned allocator statistics, shared by all instances.
+ *
+ * Every allocation is its own block from the system allocator.
+ *
+ * @note
+ * Only if `PREFORM_ALLOCATOR_STATS`.
+ */
+inline allocator_stats aligned_allocator_stats()
+{
+    return aligned_allocator_stats_recorder_().snapshot();
+}
+
+#endif // #if PREFORM_ALLOCATOR_STATS || DOXYGEN
+
 /**
  * @brief Aligned allocator.
+ *
+ * With a huge page mode other than `huge_page_mode::none`, each
+ * allocation maps its own run of huge pages by `huge_page_new()`,
+ * which also satisfies any alignment up to `huge_page_size`. This
+ * suits large, long-lived allocations such as the blocks of a
+ * `memory_arena` or `memory_pool`, e.g.,
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~{cpp}
+ * pre::memory_arena<pre::aligned_allocator<char>> arena(
+ *         pre::huge_page_size,
+ *         pre::aligned_allocator<char>(
+ *              16, pre::huge_page_mode::transparent, numa_node));
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
  */
 template <typename T>
 class aligned_allocator
@@ -244,12 +458,44 @@ public:
     {
     }
 
+    /**
+     * @brief Constructor.
+     *
+     * @param[in] alignment
+     * Alignment boundary.
+     *
+     * @param[in] mode
+     * Huge page mode.
+     *
+     * @param[in] numa_node
+     * Preferred NUMA node, or -1 for none.
+     *
+     * @throw std::invalid_argument
+     * If huge pages are requested with `alignment` greater
+     * than `huge_page_size`.
+     */
+    aligned_allocator(
+            std::size_t alignment,
+            huge_page_mode mode,
+            int numa_node = -1) :
+                alignment_(alignment),
+                huge_page_mode_(mode),
+                numa_node_(numa_node)
+    {
+        if (huge_page_mode_ != huge_page_mode::none &&
+            alignment_ > huge_page_size) {
+            throw std::invalid_argument(__PRETTY_FUNCTION__);
+        }
+    }
+
     /**
      * @brief Copy constructor.
      */
     template <typename U>
     aligned_allocator(const aligned_allocator<U>& other) :
-            alignment_(other.alignment_)
+            alignment_(other.alignment_),
+            huge_page_mode_(other.huge_page_mode_),
+            numa_node_(other.numa_node_)
     {
     }
 
@@ -258,7 +504,9 @@ public:
      */
     template <typename U>
     aligned_allocator(aligned_allocator<U>&& other) :
-            alignment_(std::move(other.alignment_))
+            alignment_(std::move(other.alignment_)),
+            huge_page_mode_(other.huge_page_mode_),
+            numa_node_(other.numa_node_)
     {
     }
 
@@ -270,6 +518,8 @@ public:
     {
         if (this != &other) {
             this->alignment_ = other.alignment_;
+            this->huge_page_mode_ = other.huge_page_mode_;
+            this->numa_node_ = other.numa_node_;
         }
         return *this;
     }
@@ -281,6 +531,8 @@ public:
     aligned_allocator& operator=(aligned_allocator<U>&& other)
     {
         this->alignment_ = std::move(other.alignment_);
+        this->huge_page_mode_ = other.huge_page_mode_;
+        this->numa_node_ = other.numa_node_;
         return *this;
     }
 
@@ -293,6 +545,15 @@ public:
     [[nodiscard]]
     T* allocate(std::size_t n)
     {
+        #if PREFORM_ALLOCATOR_STATS
+        aligned_allocator_stats_recorder_().request(
+                sizeof(T) * n, sizeof(T) * n);
+        aligned_allocator_stats_recorder_().reserve(sizeof(T) * n);
+        #endif // #if PREFORM_ALLOCATOR_STATS
+        if (huge_page_mode_ != huge_page_mode::none) {
+            return static_cast<T*>(pre::huge_page_new(
+                    sizeof(T) * n, huge_page_mode_, numa_node_));
+        }
         return static_cast<T*>(pre::aligned_new(alignment_, sizeof(T) * n));
     }
 
@@ -307,6 +568,16 @@ public:
      */
     void deallocate(T* ptr, std::size_t n)
     {
+        #if PREFORM_ALLOCATOR_STATS
+        if (ptr) {
+            aligned_allocator_stats_recorder_().release(sizeof(T) * n);
+            aligned_allocator_stats_recorder_().unreserve(sizeof(T) * n);
+        }
+        #endif // #if PREFORM_ALLOCATOR_STATS
+        if (huge_page_mode_ != huge_page_mode::none) {
+            pre::huge_page_delete(ptr, sizeof(T) * n);
+            return;
+        }
         (void) n;
         pre::aligned_delete(ptr);
     }
@@ -317,7 +588,9 @@ public:
     template <typename U>
     bool operator==(const aligned_allocator<U>& other) const
     {
-        return alignment_ == other.alignment_;
+        return alignment_ == other.alignment_ &&
+               huge_page_mode_ == other.huge_page_mode_ &&
+               numa_node_ == other.numa_node_;
     }
 
     /**
@@ -326,7 +599,7 @@ public:
     template <typename U>
     bool operator!=(const aligned_allocator<U>& other) const
     {
-        return alignment_ != other.alignment_;
+        return !operator==(other);
     }
 
 private:
@@ -336,6 +609,16 @@ private:
      */
     std::size_t alignment_;
 
+    /**
+     * @brief Huge page mode.
+     */
+    huge_page_mode huge_page_mode_ = huge_page_mode::none;
+
+    /**
+     * @brief Preferred NUMA node, or -1 for none.
+     */
+    int numa_node_ = -1;
+
     // Declare friend.
     template <typename>
     friend class aligned_allocator;
@@ -0,0 +1,300 @@
+/* Copyright (c) 2018-20 M. Grady Saunders
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer.
+ *
+ *   2. Redistributions in binary form must reproduce the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer in the documentation and/or other materials
+ *      provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*+-+*/
+#if !DOXYGEN
+#if !(__cplusplus >= 201103L)
+#error "preform/allocator_stats.hpp requires >=C++11"
+#endif // #if !(__cplusplus >= 201103L)
+#endif // #if !DOXYGEN
+#pragma once
+#ifndef PREFORM_ALLOCATOR_STATS_HPP
+#define PREFORM_ALLOCATOR_STATS_HPP
+
+#if !DOXYGEN
+#ifndef PREFORM_ALLOCATOR_STATS
+#define PREFORM_ALLOCATOR_STATS 0
+#endif // #ifndef PREFORM_ALLOCATOR_STATS
+#endif // #if !DOXYGEN
+
+// for std::atomic
+#include <atomic>
+
+// for std::size_t
+#include <cstddef>
+
+namespace pre {
+
+/**
+ * @defgroup allocator_stats Allocator statistics
+ *
+ * `<preform/allocator_stats.hpp>`
+ *
+ * __C++ version__: >=C++11
+ *
+ * Statistics are recorded by `memory_arena`, `memory_pool`, and
+ * `aligned_allocator` only if `PREFORM_ALLOCATOR_STATS` is defined
+ * to 1 before including them. Otherwise, no counters exist and
+ * no code is generated.
+ */
+/**@{*/
+
+/**
+ * @brief Allocator statistics.
+ */
+struct allocator_stats
+{
+    /**
+     * @brief Bytes requested by callers, cumulative.
+     */
+    std::size_t bytes_requested = 0;
+
+    /**
+     * @brief Bytes handed out to callers, after rounding, and not
+     * yet released.
+     */
+    std::size_t bytes_in_use = 0;
+
+    /**
+     * @brief Peak of `bytes_in_use`.
+     */
+    std::size_t peak_bytes_in_use = 0;
+
+    /**
+     * @brief Bytes reserved from the underlying allocator.
+     */
+    std::size_t bytes_reserved = 0;
+
+    /**
+     * @brief Peak of `bytes_reserved`.
+     */
+    std::size_t peak_bytes_reserved = 0;
+
+    /**
+     * @brief Blocks reserved from the underlying allocator.
+     */
+    std::size_t block_count = 0;
+
+    /**
+     * @brief Peak of `block_count`.
+     */
+    std::size_t peak_block_count = 0;
+
+    /**
+     * @brief Calls to the underlying allocator, cumulative.
+     */
+    std::size_t block_allocations = 0;
+
+    /**
+     * @brief Calls to `clear()` or `reset()`, cumulative.
+     */
+    std::size_t reset_count = 0;
+
+    /**
+     * @brief Fragmentation, the fraction of reserved bytes
+     * not in use.
+     */
+    double fragmentation() const
+    {
+        return bytes_reserved == 0 ? 0.0 :
+            1.0 - double(bytes_in_use) / double(bytes_reserved);
+    }
+};
+
+/**
+ * @brief Allocator statistics recorder.
+ *
+ * Counters are relaxed atomics, so that one recorder may be shared
+ * by allocators in different threads.
+ */
+class allocator_stats_recorder
+{
+public:
+
+    /**
+     * @brief Record request.
+     *
+     * @param[in] requested
+     * Bytes requested.
+     *
+     * @param[in] used
+     * Bytes handed out, after rounding.
+     */
+    void request(std::size_t requested, std::size_t used)
+    {
+        bytes_requested_.fetch_add(requested, std::memory_order_relaxed);
+        update_peak(
+            peak_bytes_in_use_,
+            bytes_in_use_.fetch_add(used, std::memory_order_relaxed) + used);
+    }
+
+    /**
+     * @brief Record release.
+     *
+     * @param[in] used
+     * Bytes released, after rounding.
+     */
+    void release(std::size_t used)
+    {
+        bytes_in_use_.fetch_sub(used, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Record release of everything in use.
+     */
+    void release_all()
+    {
+        bytes_in_use_.store(0, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Record block reserved from underlying allocator.
+     */
+    void reserve(std::size_t size)
+    {
+        block_allocations_.fetch_add(1, std::memory_order_relaxed);
+        update_peak(
+            peak_block_count_,
+            block_count_.fetch_add(1, std::memory_order_relaxed) + 1);
+        update_peak(
+            peak_bytes_reserved_,
+            bytes_reserved_.fetch_add(size, std::memory_order_relaxed) + size);
+    }
+
+    /**
+     * @brief Record block returned to underlying allocator.
+     */
+    void unreserve(std::size_t size)
+    {
+        block_count_.fetch_sub(1, std::memory_order_relaxed);
+        bytes_reserved_.fetch_sub(size, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Record clear or reset.
+     */
+    void reset()
+    {
+        reset_count_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Snapshot.
+     */
+    allocator_stats snapshot() const
+    {
+        allocator_stats stats;
+        stats.bytes_requested =
+            bytes_requested_.load(std::memory_order_relaxed);
+        stats.bytes_in_use =
+            bytes_in_use_.load(std::memory_order_relaxed);
+        stats.peak_bytes_in_use =
+            peak_bytes_in_use_.load(std::memory_order_relaxed);
+        stats.bytes_reserved =
+            bytes_reserved_.load(std::memory_order_relaxed);
+        stats.peak_bytes_reserved =
+            peak_bytes_reserved_.load(std::memory_order_relaxed);
+        stats.block_count =
+            block_count_.load(std::memory_order_relaxed);
+        stats.peak_block_count =
+            peak_block_count_.load(std::memory_order_relaxed);
+        stats.block_allocations =
+            block_allocations_.load(std::memory_order_relaxed);
+        stats.reset_count =
+            reset_count_.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+private:
+
+    /**
+     * @brief Update peak.
+     */
+    static void update_peak(
+                    std::atomic<std::size_t>& peak,
+                    std::size_t value)
+    {
+        std::size_t prev = peak.load(std::memory_order_relaxed);
+        while (prev < value &&
+              !peak.compare_exchange_weak(
+                    prev, value, std::memory_order_relaxed)) {
+        }
+    }
+
+private:
+
+    /**
+     * @brief Bytes requested.
+     */
+    std::atomic<std::size_t> bytes_requested_ = {0};
+
+    /**
+     * @brief Bytes in use.
+     */
+    std::atomic<std::size_t> bytes_in_use_ = {0};
+
+    /**
+     * @brief Peak bytes in use.
+     */
+    std::atomic<std::size_t> peak_bytes_in_use_ = {0};
+
+    /**
+     * @brief Bytes reserved.
+     */
+    std::atomic<std::size_t> bytes_reserved_ = {0};
+
+    /**
+     * @brief Peak bytes reserved.
+     */
+    std::atomic<std::size_t> peak_bytes_reserved_ = {0};
+
+    /**
+     * @brief Block count.
+     */
+    std::atomic<std::size_t> block_count_ = {0};
+
+    /**
+     * @brief Peak block count.
+     */
+    std::atomic<std::size_t> peak_block_count_ = {0};
+
+    /**
+     * @brief Block allocations.
+     */
+    std::atomic<std::size_t> block_allocations_ = {0};
+
+    /**
+     * @brief Reset count.
+     */
+    std::atomic<std::size_t> reset_count_ = {0};
+};
+
+/**@}*/
+
+} // namespace pre
+
+#endif // #ifndef PREFORM_ALLOCATOR_STATS_HPP
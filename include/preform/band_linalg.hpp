@@ -0,0 +1,333 @@
+/* Copyright (c) 2018-20 M. Grady Saunders
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *   1. Redistributions of source code must retain the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer.
+ * 
+ *   2. Redistributions in binary form must reproduce the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer in the documentation and/or other materials
+ *      provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*+-+*/
+#if !DOXYGEN
+#if !(__cplusplus >= 201402L)
+#error "preform/band_linalg.hpp requires >=C++14"
+#endif // #if !(__cplusplus >= 201402L)
+#endif // #if !DOXYGEN
+#pragma once
+#ifndef PREFORM_BAND_LINALG_HPP
+#define PREFORM_BAND_LINALG_HPP
+
+#include <algorithm>
+#include <preform/math.hpp>
+#include <preform/dense_matrix_view.hpp>
+
+namespace pre {
+
+/**
+ * @defgroup band_linalg Band linear algebra
+ *
+ * `<preform/band_linalg.hpp>`
+ *
+ * __C++ version__: >=C++14
+ */
+/**@{*/
+
+/**
+ * @brief Band linear algebra.
+ *
+ * A band matrix @f$ \mathbf{A} @f$ of size @f$ n \times n @f$, with
+ * @f$ k_l @f$ subdiagonals and @f$ k_u @f$ superdiagonals, is stored
+ * by diagonals in a matrix @f$ \mathbf{B} @f$ of size
+ * @f$ (k_l + k_u + 1) \times n @f$, such that
+ * @f[
+ *      B_{[k_u + i - j, j]} = A_{[i, j]}
+ * @f]
+ * for @f$ -k_u \le i - j \le k_l @f$. That is, each column of
+ * @f$ \mathbf{B} @f$ holds the band of the corresponding column of
+ * @f$ \mathbf{A} @f$, and entries outside the matrix are unused.
+ * Hermitian matrices store the lower triangle only, with
+ * @f$ k_u = 0 @f$. Factorizations and solves are then
+ * @f$ O(n k_l (k_l + k_u)) @f$ rather than @f$ O(n^3) @f$.
+ *
+ * @tparam Tvalue
+ * Value type, must be either floating point or complex.
+ */
+template <typename Tvalue>
+struct band_linalg
+{
+public:
+
+    // Sanity check.
+    static_assert(
+        std::is_floating_point<Tvalue>::value || is_complex<Tvalue>::value,
+        "Tvalue must be floating point or complex");
+
+    /**
+     * @brief Value type.
+     */
+    typedef Tvalue value_type;
+
+    /**
+     * @brief Float type.
+     */
+    typedef decltype(pre::real(Tvalue())) float_type;
+
+    /**
+     * @brief Cholesky decomposition.
+     *
+     * @param[inout] b
+     * Band matrix @f$ \mathbf{B} \to \mathbf{L} @f$, of size
+     * @f$ (k_l + 1) \times n @f$, holding the lower triangle of
+     * a Hermitian positive definite matrix, with
+     * @f$ \mathbf{A} = \mathbf{L}\mathbf{L}^H @f$.
+     *
+     * @throw std::invalid_argument
+     * If `b.empty()`.
+     *
+     * @throw std::runtime_error
+     * Unless positive definite.
+     */
+    static void chol(dense_matrix_view<value_type*> b)
+    {
+        // Ensure valid.
+        if (b.empty()) {
+            throw std::invalid_argument(__PRETTY_FUNCTION__);
+        }
+
+        const int n = b.size1();
+        const int kl = b.size0() - 1;
+        for (int j = 0; j < n; j++) {
+
+            // Update diagonal entry.
+            float_type bjj = pre::real(at_(b, 0, j));
+            if (!(bjj > 0) || !pre::isfinite(bjj)) {
+                throw std::runtime_error(__PRETTY_FUNCTION__);
+            }
+            bjj = pre::sqrt(bjj);
+            at_(b, 0, j) = bjj;
+
+            // Update off-diagonal entries.
+            const int m = std::min(kl, n - 1 - j);
+            float_type invbjj = 1 / bjj;
+            for (int l = 1; l <= m; l++) {
+                at_(b, l, j) *= invbjj;
+            }
+
+            // Update trailing triangle within band.
+            for (int l1 = 1; l1 <= m; l1++) {
+                value_type fac = pre::conj(at_(b, l1, j));
+                for (int l0 = l1; l0 <= m; l0++) {
+                    at_(b, l0 - l1, j + l1) -= at_(b, l0, j) * fac;
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Solve with Cholesky decomposition.
+     *
+     * @param[in] b
+     * Band matrix @f$ \mathbf{L} @f$, as computed by `chol()`.
+     *
+     * @param[inout] x
+     * Matrix @f$ \mathbf{X} \to \mathbf{A}^{-1} \mathbf{X} @f$, of size
+     * @f$ n \times k @f$, holding @f$ k @f$ right-hand sides as
+     * columns.
+     *
+     * @throw std::invalid_argument
+     * Unless `b.size1() == x.size0()`.
+     */
+    static void chol_solve(
+                dense_matrix_view<const value_type*> b,
+                dense_matrix_view<value_type*> x)
+    {
+        // Ensure valid.
+        if (b.empty() ||
+            b.size1() != x.size0()) {
+            throw std::invalid_argument(__PRETTY_FUNCTION__);
+        }
+
+        const int n = b.size1();
+        const int kl = b.size0() - 1;
+        const int k = x.size1();
+
+        // Forward substitution, X <- L^-1 X.
+        for (int j = 0; j < n; j++) {
+            const int m = std::min(kl, n - 1 - j);
+            float_type invbjj = 1 / pre::real(at_(b, 0, j));
+            for (int c = 0; c < k; c++) {
+                value_type xjc = at_(x, j, c) * invbjj;
+                at_(x, j, c) = xjc;
+                for (int l = 1; l <= m; l++) {
+                    at_(x, j + l, c) -= at_(b, l, j) * xjc;
+                }
+            }
+        }
+
+        // Back substitution, X <- L^-H X.
+        for (int j = n - 1; j >= 0; j--) {
+            const int m = std::min(kl, n - 1 - j);
+            float_type invbjj = 1 / pre::real(at_(b, 0, j));
+            for (int c = 0; c < k; c++) {
+                value_type xjc = at_(x, j, c);
+                for (int l = 1; l <= m; l++) {
+                    xjc -= pre::conj(at_(b, l, j)) * at_(x, j + l, c);
+                }
+                at_(x, j, c) = xjc * invbjj;
+            }
+        }
+    }
+
+    /**
+     * @brief LU-decomposition, without pivoting.
+     *
+     * @param[inout] b
+     * Band matrix @f$ \mathbf{B} \to \mathbf{L}\mathbf{U} @f$, of size
+     * @f$ (k_l + k_u + 1) \times n @f$, with
+     * @f$ \mathbf{A} = \mathbf{L}\mathbf{U} @f$, where
+     * @f$ \mathbf{L} @f$ is unit lower triangular, stored below
+     * the diagonal, and @f$ \mathbf{U} @f$ is upper triangular.
+     *
+     * @param[in] kl
+     * Number of subdiagonals @f$ k_l @f$.
+     *
+     * @note
+     * Without pivoting, the bandwidth does not grow. This is stable
+     * for diagonally dominant or totally positive matrices, such as
+     * B-spline collocation matrices, but not in general.
+     *
+     * @throw std::invalid_argument
+     * Unless `kl >= 0` and `kl < b.size0()`.
+     *
+     * @throw std::runtime_error
+     * If zero pivot.
+     */
+    static void lu(dense_matrix_view<value_type*> b, int kl)
+    {
+        // Ensure valid.
+        if (b.empty() ||
+            !(kl >= 0 && kl < b.size0())) {
+            throw std::invalid_argument(__PRETTY_FUNCTION__);
+        }
+
+        const int n = b.size1();
+        const int ku = b.size0() - 1 - kl;
+        for (int j = 0; j < n; j++) {
+
+            // Pivot.
+            value_type bjj = at_(b, ku, j);
+            if (!(bjj != value_type()) || !pre::isfinite(bjj)) {
+                throw std::runtime_error(__PRETTY_FUNCTION__);
+            }
+
+            // Update multipliers.
+            const int ml = std::min(kl, n - 1 - j);
+            const int mu = std::min(ku, n - 1 - j);
+            value_type invbjj = value_type(1) / bjj;
+            for (int l = 1; l <= ml; l++) {
+                at_(b, ku + l, j) *= invbjj;
+            }
+
+            // Update trailing block within band.
+            for (int c = 1; c <= mu; c++) {
+                value_type fac = at_(b, ku - c, j + c);
+                for (int l = 1; l <= ml; l++) {
+                    at_(b, ku + l - c, j + c) -= at_(b, ku + l, j) * fac;
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Solve with LU-decomposition.
+     *
+     * @param[in] b
+     * Band matrix @f$ \mathbf{L}\mathbf{U} @f$, as computed by `lu()`.
+     *
+     * @param[in] kl
+     * Number of subdiagonals @f$ k_l @f$.
+     *
+     * @param[inout] x
+     * Matrix @f$ \mathbf{X} \to \mathbf{A}^{-1} \mathbf{X} @f$, of size
+     * @f$ n \times k @f$, holding @f$ k @f$ right-hand sides as
+     * columns.
+     *
+     * @throw std::invalid_argument
+     * Unless `kl >= 0`, `kl < b.size0()`, and `b.size1() == x.size0()`.
+     */
+    static void lu_solve(
+                dense_matrix_view<const value_type*> b, int kl,
+                dense_matrix_view<value_type*> x)
+    {
+        // Ensure valid.
+        if (b.empty() ||
+            b.size1() != x.size0() ||
+            !(kl >= 0 && kl < b.size0())) {
+            throw std::invalid_argument(__PRETTY_FUNCTION__);
+        }
+
+        const int n = b.size1();
+        const int ku = b.size0() - 1 - kl;
+        const int k = x.size1();
+
+        // Forward substitution, X <- L^-1 X.
+        for (int j = 0; j < n; j++) {
+            const int ml = std::min(kl, n - 1 - j);
+            for (int c = 0; c < k; c++) {
+                value_type xjc = at_(x, j, c);
+                for (int l = 1; l <= ml; l++) {
+                    at_(x, j + l, c) -= at_(b, ku + l, j) * xjc;
+                }
+            }
+        }
+
+        // Back substitution, X <- U^-1 X.
+        for (int j = n - 1; j >= 0; j--) {
+            const int mu = std::min(ku, j);
+            value_type invbjj = value_type(1) / at_(b, ku, j);
+            for (int c = 0; c < k; c++) {
+                value_type xjc = at_(x, j, c) * invbjj;
+                at_(x, j, c) = xjc;
+                for (int l = 1; l <= mu; l++) {
+                    at_(x, j - l, c) -= at_(b, ku - l, j) * xjc;
+                }
+            }
+        }
+    }
+
+private:
+
+    /**
+     * @brief Unchecked access.
+     */
+    template <typename Tptr>
+    __attribute__((always_inline))
+    static auto& at_(dense_matrix_view<Tptr> x, int i, int j)
+    {
+        return x.begin_itr_[x.begin_inc0_ * i + x.begin_inc1_ * j];
+    }
+};
+
+/**@}*/
+
+} // namespace pre
+
+#endif // #ifndef PREFORM_BAND_LINALG_HPP
@@ -339,13 +339,20 @@ struct terminal_dims
      *
      * @note
      * On Linux, uses `ioctl` to fetch terminal size. Otherwise,
-     * defaults to 24 rows by 80 columns.
+     * or if standard output is not a terminal, defaults to 24 rows
+     * by 80 columns.
      */
     static terminal_dims get()
     {
     #if __linux__
-        struct winsize winsz;
-        ioctl(STDOUT_FILENO, TIOCGWINSZ, &winsz);
+        struct winsize winsz = {};
+        if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &winsz) != 0 ||
+            winsz.ws_col == 0) {
+            return {
+                24,
+                80
+            };
+        }
         return {
             int(winsz.ws_row),
             int(winsz.ws_col)
@@ -374,7 +381,9 @@ public:
     /**
      * @brief Constructor.
      */
-    terminal_progress_bar(double amount) : amount(amount)
+    terminal_progress_bar(double amount, int width = 0) :
+            amount(amount),
+            width(width)
     {
     }
 
@@ -383,6 +392,12 @@ public:
      */
     double amount = 0.0;
 
+    /**
+     * @brief Width in columns, including brackets, or 0 for the
+     * terminal width.
+     */
+    int width = 0;
+
     /**
      * @brief Write into `std::basic_ostream`.
      */
@@ -397,6 +412,9 @@ public:
         // Terminal dimensions.
         terminal_dims dims =
         terminal_dims::get();
+        if (bar.width > 0) {
+            dims.cols = bar.width;
+        }
         if (dims.cols < 8) {
             // Error?
             dims = {
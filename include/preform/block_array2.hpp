@@ -35,15 +35,37 @@
 #ifndef PREFORM_BLOCK_ARRAY2_HPP
 #define PREFORM_BLOCK_ARRAY2_HPP
 
+#if !DOXYGEN
+#ifndef PREFORM_BLOCK_ARRAY2_USE_THREADS
+#define PREFORM_BLOCK_ARRAY2_USE_THREADS 1
+#endif // PREFORM_BLOCK_ARRAY2_USE_THREADS
+#endif // #if !DOXYGEN
+
+// for std::min
+#include <algorithm>
+
+// for std::invalid_argument, std::out_of_range
+#include <stdexcept>
+
+// for std::as_const
+#include <utility>
+
 // for std::vector
 #include <vector>
 
 // for pre::multi
 #include <preform/multi.hpp>
 
-// for pre::first1, pre::roundpow2, ...
+// for pre::first1, pre::roundpow2, pre::clamp, pre::repeat, ...
 #include <preform/misc_int.hpp>
 
+#if PREFORM_BLOCK_ARRAY2_USE_THREADS
+
+// for pre::thread_pool
+#include <preform/thread_pool.hpp>
+
+#endif // #if PREFORM_BLOCK_ARRAY2_USE_THREADS
+
 #if !DOXYGEN
 #ifndef L1_LINE
 #define L1_LINE 64
@@ -52,6 +74,12 @@
 
 namespace pre {
 
+#if !PREFORM_BLOCK_ARRAY2_USE_THREADS && !DOXYGEN
+
+class thread_pool;
+
+#endif // #if !PREFORM_BLOCK_ARRAY2_USE_THREADS && !DOXYGEN
+
 /**
  * @defgroup block_array2 Block array (2-dimensional)
  *
@@ -70,10 +98,29 @@ namespace pre {
  * line which, by default, the implementation assumes to be 64 bytes. To
  * change this assumption, define `L1_LINE` to the appropriate
  * size before including the data structure.
+ *
+ * By default, blocks are stored in row-major order, so that stepping
+ * in the 1st dimension skips a whole row of blocks. If `Ntile` is
+ * nonzero, blocks are instead grouped in @f$ T \times T @f$ tiles for
+ * @f$ T = @f$ `Ntile`, with tiles in row-major order and blocks in
+ * Morton order within each tile. Lookups with 2-dimensional locality,
+ * as in filtered texture fetches, then stay within a few pages and
+ * cache lines in either dimension.
+ *
+ * @tparam T
+ * Value type.
+ *
+ * @tparam Talloc
+ * Allocator type.
+ *
+ * @tparam Ntile
+ * Tile size, either 0 for no tiles or a power of 2 no less than
+ * the block size, e.g., 32.
  */
 template <
     typename T,
-    typename Talloc = std::allocator<T>
+    typename Talloc = std::allocator<T>,
+    std::size_t Ntile = 0
     >
 class block_array2
 {
@@ -173,16 +220,39 @@ public:
     size_type block_area = 1 << block_area_log2;
 
     /**
-     * @brief Round `num` up to multiple of `block_size`.
+     * @brief Tile size @f$ T @f$, or block size if no tiles.
+     */
+    static constexpr
+    size_type tile_size = Ntile == 0 ? block_size : Ntile;
+
+    // Sanity check.
+    static_assert(
+        ispow2(tile_size) && tile_size >= block_size,
+        "Ntile must be 0 or a power of 2 no less than block size");
+
+    /**
+     * @brief Binary log of the tile size @f$ \log_{2}{T} @f$.
+     */
+    static constexpr
+    size_type tile_size_log2 = first1(tile_size);
+
+    /**
+     * @brief Binary log of the tile area @f$ \log_{2}{T^{2}} @f$.
+     */
+    static constexpr
+    size_type tile_area_log2 = tile_size_log2 * 2;
+
+    /**
+     * @brief Round `num` up to multiple of `tile_size`.
      */
     static constexpr
     size_type round_size(size_type num) noexcept
     {
-        return (num + (block_size - 1)) & ~(block_size - 1);
+        return (num + (tile_size - 1)) & ~(tile_size - 1);
     }
 
     /**
-     * @brief Round `num` up to multiple of `block_size`.
+     * @brief Round `num` up to multiple of `tile_size`.
      */
     static constexpr
     multi<size_type, 2> round_size(multi<size_type, 2> num) noexcept
@@ -499,10 +569,34 @@ public:
      *      j = B^2 (q_0 + (n_0 / B) q_1) + (r_0 + B r_1)
      * @f]
      * where the @f$ q_k, r_k @f$ denote the quotients and
-     * remainders of the @f$ l_k / B @f$ respectively.
+     * remainders of the @f$ l_k / B @f$ respectively. With tiles,
+     * @f[
+     *      j = T^2 (t_0 + (n_0 / T) t_1) +
+     *          B^2 z(b_0, b_1) + (r_0 + B r_1)
+     * @f]
+     * where the @f$ t_k @f$ denote the quotients of the @f$ l_k / T @f$,
+     * the @f$ b_k @f$ denote the block indices within the tile, and
+     * @f$ z @f$ denotes bit interleaving.
      */
     size_type convert(multi<size_type, 2> loc) const noexcept
     {
+        if constexpr (Ntile != 0) {
+            // Tile, block in tile, and remainder.
+            multi<size_type, 2> loc_til = loc >> tile_size_log2;
+            multi<size_type, 2> loc_blk =
+               (loc >> block_size_log2) & 
+                    ((size_type(1) << 
+                     (tile_size_log2 - block_size_log2)) - 1);
+            multi<size_type, 2> loc_rem = loc & (block_size - 1);
+            return
+                ((loc_til[0] + loc_til[1] *
+                 (data_size_[0] >> tile_size_log2)) << tile_area_log2) +
+                (size_type(bit_interleave<std::uint32_t>(
+                        loc_blk[0], 
+                        loc_blk[1])) << block_area_log2) +
+                 loc_rem[0] + (loc_rem[1] << block_size_log2);
+        }
+
         // Quotient and remainder with respect to block size.
         multi<size_type, 2> loc_quo = loc >> block_size_log2;
         multi<size_type, 2> loc_rem = loc & (block_size - 1);
@@ -534,6 +628,28 @@ public:
      */
     multi<size_type, 2> convert(size_type pos) const noexcept
     {
+        if constexpr (Ntile != 0) {
+            // Tile, block in tile, and remainder.
+            size_type pos_til = pos >> tile_area_log2;
+            size_type pos_blk = 
+                (pos & ((size_type(1) << tile_area_log2) - 1)) >> 
+                block_area_log2;
+            size_type pos_rem = pos & (block_area - 1);
+
+            // Number of tiles in dimension 0.
+            size_type num = data_size_[0] >> tile_size_log2;
+
+            // Recover index.
+            return {
+                (pos_til % num) << tile_size_log2 |
+                bit_deinterleave_(pos_blk) << block_size_log2 |
+                (pos_rem & (block_size - 1)),
+                (pos_til / num) << tile_size_log2 |
+                bit_deinterleave_(pos_blk >> 1) << block_size_log2 |
+                (pos_rem >> block_size_log2)
+            };
+        }
+
         // Quotient and remainder with respect to block area.
         size_type pos_quo = pos >> block_area_log2;
         size_type pos_rem = pos & (block_area - 1);
@@ -691,6 +807,283 @@ public:
 
     /**@}*/
 
+public:
+
+    /**
+     * @brief Stencil accessor.
+     *
+     * Reads entries of a source array at offsets from the current
+     * index. Out of range indices follow the cycle mode of each
+     * dimension, as in `image2::cycle_mode()`: 0 to clamp, +1 to
+     * repeat, or -1 to mirror.
+     *
+     * @tparam Tother
+     * Source array type.
+     */
+    template <typename Tother>
+    class stencil_accessor
+    {
+    public:
+
+        /**
+         * @brief Constructor.
+         */
+        stencil_accessor(
+                const Tother& src,
+                multi<int, 2> cycle_mode) :
+                    src_(src),
+                    cycle_mode_(cycle_mode)
+        {
+        }
+
+        /**
+         * @brief Current index.
+         */
+        const multi<size_type, 2>& loc() const noexcept
+        {
+            return loc_;
+        }
+
+        /**
+         * @brief Access entry at offset from current index.
+         */
+        typename Tother::const_reference operator()(
+                int offset0, int offset1) const
+        {
+            int ind0 = int(loc_[0]) + offset0;
+            int ind1 = int(loc_[1]) + offset1;
+            if (!interior_) {
+                ind0 = cycle(ind0, int(src_.user_size()[0]), cycle_mode_[0]);
+                ind1 = cycle(ind1, int(src_.user_size()[1]), cycle_mode_[1]);
+            }
+            return src_(size_type(ind0), size_type(ind1));
+        }
+
+        /**
+         * @brief Access entry at offset from current index.
+         */
+        typename Tother::const_reference operator()(
+                multi<int, 2> offset) const
+        {
+            return (*this)(offset[0], offset[1]);
+        }
+
+        /**
+         * @brief Cycle index.
+         */
+        static int cycle(int ind, int num, int mode)
+        {
+            switch (mode) {
+                default:
+                case 0:
+                    return clamp(ind, num);
+                case +1:
+                    return repeat(ind, num);
+                case -1:
+                    return mirror(ind, num);
+            }
+        }
+
+    private:
+
+        /**
+         * @brief Source.
+         */
+        const Tother& src_;
+
+        /**
+         * @brief Cycle mode.
+         */
+        multi<int, 2> cycle_mode_ = {};
+
+        /**
+         * @brief Current index.
+         */
+        multi<size_type, 2> loc_ = {};
+
+        /**
+         * @brief Current block within radius of no boundary?
+         */
+        bool interior_ = false;
+
+        friend class block_array2;
+    };
+
+    /**
+     * @name Algorithms
+     *
+     * Algorithms visit entries block by block in storage order,
+     * and skip padding beyond the user size. Parallel variants
+     * split blocks into runs of `task_blocks`, which never split
+     * a tile, and hand the runs out to the thread pool.
+     */
+    /**@{*/
+
+    /**
+     * @brief Blocks per task, a whole number of tiles.
+     */
+    static constexpr size_type task_blocks =
+        (size_type(1) << (tile_area_log2 - block_area_log2)) > 64 ?
+        (size_type(1) << (tile_area_log2 - block_area_log2)) : 64;
+
+    /**
+     * @brief For each index.
+     *
+     * @param[in] func
+     * Function with signature equivalent to
+     * `void(multi<size_type, 2>, reference)`, called once with each
+     * index in the user size and the corresponding entry.
+     */
+    template <typename Tfunc>
+    void for_each_index(Tfunc&& func)
+    {
+        for_each_index_(nullptr, func);
+    }
+
+    /**
+     * @brief Transform.
+     *
+     * Resizes to the user size of `src`, then sets each entry to
+     * `func` of the corresponding entry of `src`. The source may be
+     * this array.
+     *
+     * @param[in] src
+     * Source array, e.g., a `block_array2` or `image2`.
+     *
+     * @param[in] func
+     * Function with signature equivalent to
+     * `T(typename Tother::const_reference)`.
+     */
+    template <typename Tother, typename Tfunc>
+    void transform(const Tother& src, Tfunc&& func)
+    {
+        transform_(nullptr, src, func);
+    }
+
+    /**
+     * @brief Reduce.
+     *
+     * Accumulates `combine(acc, func(loc, value))` within each task
+     * starting from `identity`, then combines task results in order.
+     * Tasks depend only on the size, so the result is the same
+     * sequentially and in parallel, for any thread count.
+     *
+     * @param[in] identity
+     * Identity value of `combine`.
+     *
+     * @param[in] func
+     * Function with signature equivalent to
+     * `Tresult(multi<size_type, 2>, const_reference)`.
+     *
+     * @param[in] combine
+     * Associative function with signature equivalent to
+     * `Tresult(const Tresult&, const Tresult&)`.
+     */
+    template <typename Tresult, typename Tfunc, typename Tcombine>
+    Tresult reduce(
+            Tresult identity,
+            Tfunc&& func,
+            Tcombine&& combine) const
+    {
+        return reduce_(nullptr, identity, func, combine);
+    }
+
+    /**
+     * @brief Stencil.
+     *
+     * Resizes to the user size of `src`, then sets each entry to
+     * `func` of the corresponding index and a `stencil_accessor` on
+     * `src`. Blocks further than `radius` from every boundary skip
+     * cycling, so `func` must not read offsets beyond `radius`.
+     *
+     * @param[in] src
+     * Source array, e.g., a `block_array2` or `image2`, other than
+     * this array.
+     *
+     * @param[in] radius
+     * Maximum absolute offset in each dimension.
+     *
+     * @param[in] cycle_mode
+     * Cycle mode in each dimension, as in `stencil_accessor`.
+     *
+     * @param[in] func
+     * Function with signature equivalent to
+     * `T(multi<size_type, 2>, const stencil_accessor<Tother>&)`.
+     *
+     * @throw std::invalid_argument
+     * If `src` is this array, or unless `(radius >= 0).all()`.
+     */
+    template <typename Tother, typename Tfunc>
+    void stencil(
+            const Tother& src,
+            multi<int, 2> radius,
+            multi<int, 2> cycle_mode,
+            Tfunc&& func)
+    {
+        stencil_(nullptr, src, radius, cycle_mode, func);
+    }
+
+#if PREFORM_BLOCK_ARRAY2_USE_THREADS || DOXYGEN
+
+    /**
+     * @brief For each index, in parallel.
+     *
+     * As above, except that tasks are spread over the thread
+     * pool, so `func` must be safe to call concurrently for
+     * different indices.
+     */
+    template <typename Tfunc>
+    void for_each_index(thread_pool& pool, Tfunc&& func)
+    {
+        for_each_index_(&pool, func);
+    }
+
+    /**
+     * @brief Transform, in parallel.
+     *
+     * As above, except that tasks are spread over the thread pool.
+     */
+    template <typename Tother, typename Tfunc>
+    void transform(thread_pool& pool, const Tother& src, Tfunc&& func)
+    {
+        transform_(&pool, src, func);
+    }
+
+    /**
+     * @brief Reduce, in parallel.
+     *
+     * As above, except that tasks are spread over the thread pool.
+     */
+    template <typename Tresult, typename Tfunc, typename Tcombine>
+    Tresult reduce(
+            thread_pool& pool,
+            Tresult identity,
+            Tfunc&& func,
+            Tcombine&& combine) const
+    {
+        return reduce_(&pool, identity, func, combine);
+    }
+
+    /**
+     * @brief Stencil, in parallel.
+     *
+     * As above, except that tasks are spread over the thread pool.
+     */
+    template <typename Tother, typename Tfunc>
+    void stencil(
+            thread_pool& pool,
+            const Tother& src,
+            multi<int, 2> radius,
+            multi<int, 2> cycle_mode,
+            Tfunc&& func)
+    {
+        stencil_(&pool, src, radius, cycle_mode, func);
+    }
+
+#endif // #if PREFORM_BLOCK_ARRAY2_USE_THREADS || DOXYGEN
+
+    /**@}*/
+
 protected:
 
     /**
@@ -707,6 +1100,184 @@ protected:
      * @brief Data array.
      */
     std::vector<T, Talloc> data_;
+
+#if !DOXYGEN
+
+    // Gather even bits.
+    static constexpr size_type bit_deinterleave_(size_type val) noexcept
+    {
+        size_type res = 0;
+        for (size_type k = 0;
+                       k < tile_size_log2 - block_size_log2; k++) {
+            res |= ((val >> (2 * k)) & 1) << k;
+        }
+        return res;
+    }
+
+
+    // Task count.
+    size_type task_count_() const noexcept
+    {
+        size_type blocks = data_.size() >> block_area_log2;
+        return (blocks + task_blocks - 1) / task_blocks;
+    }
+
+    // Visit tasks, in parallel if pool is non-null.
+    template <typename Tfunc>
+    void for_each_task_(thread_pool* pool, Tfunc&& func) const
+    {
+        size_type blocks = data_.size() >> block_area_log2;
+        size_type tasks = task_count_();
+        auto task_func = [&](size_type task) {
+            size_type from = task * task_blocks;
+            size_type to = std::min(from + task_blocks, blocks);
+            func(task, from, to);
+        };
+        #if PREFORM_BLOCK_ARRAY2_USE_THREADS
+        if (pool) {
+            pool->parallel_for(size_type(0), tasks, size_type(1), task_func);
+            return;
+        }
+        #else
+        (void) pool;
+        #endif // #if PREFORM_BLOCK_ARRAY2_USE_THREADS
+        for (size_type task = 0; task < tasks; task++) {
+            task_func(task);
+        }
+    }
+
+    // Visit indices and positions in block, within user size.
+    template <typename Tfunc>
+    void for_each_in_block_(size_type block, Tfunc&& func) const
+    {
+        size_type pos = block << block_area_log2;
+        multi<size_type, 2> origin = convert(pos);
+        if (origin[0] >= user_size_[0] ||
+            origin[1] >= user_size_[1]) {
+            return;
+        }
+        size_type count0 = std::min(user_size_[0] - origin[0], block_size);
+        size_type count1 = std::min(user_size_[1] - origin[1], block_size);
+        for (size_type r1 = 0; r1 < count1; r1++)
+        for (size_type r0 = 0; r0 < count0; r0++) {
+            func(multi<size_type, 2>{
+                     origin[0] + r0,
+                     origin[1] + r1
+                 },
+                 pos + r0 + (r1 << block_size_log2));
+        }
+    }
+
+    // For each index, in parallel if pool is non-null.
+    template <typename Tfunc>
+    void for_each_index_(thread_pool* pool, Tfunc& func)
+    {
+        for_each_task_(pool, [&](size_type, size_type from, size_type to) {
+            for (size_type block = from; block < to; block++) {
+                for_each_in_block_(block, [&](const auto& loc, size_type pos) {
+                    func(loc, data_[pos]);
+                });
+            }
+        });
+    }
+
+    // Transform, in parallel if pool is non-null.
+    template <typename Tother, typename Tfunc>
+    void transform_(thread_pool* pool, const Tother& src, Tfunc& func)
+    {
+        if (!(user_size_ == src.user_size()).all()) {
+            resize(src.user_size());
+        }
+        for_each_task_(pool, [&](size_type, size_type from, size_type to) {
+            for (size_type block = from; block < to; block++) {
+                for_each_in_block_(block, [&](const auto& loc, size_type pos) {
+                    if constexpr (
+                            Tother::block_size == block_size &&
+                            Tother::tile_size == tile_size) {
+                        // Same layout.
+                        data_[pos] = func(src[pos]);
+                    }
+                    else {
+                        data_[pos] = func(src[loc]);
+                    }
+                });
+            }
+        });
+    }
+
+    // Reduce, in parallel if pool is non-null.
+    template <typename Tresult, typename Tfunc, typename Tcombine>
+    Tresult reduce_(
+            thread_pool* pool,
+            const Tresult& identity,
+            Tfunc& func,
+            Tcombine& combine) const
+    {
+        // Task results, wrapped so that each is a distinct object.
+        struct result_type {
+            Tresult value;
+        };
+        std::vector<result_type> results(
+                task_count_(), result_type{identity});
+        for_each_task_(pool, [&](
+                size_type task, size_type from, size_type to) {
+            Tresult result = identity;
+            for (size_type block = from; block < to; block++) {
+                for_each_in_block_(block, [&](const auto& loc, size_type pos) {
+                    result = combine(result, func(loc, data_[pos]));
+                });
+            }
+            results[task].value = std::move(result);
+        });
+
+        // Combine in order.
+        Tresult result = identity;
+        for (const result_type& task_result : results) {
+            result = combine(result, task_result.value);
+        }
+        return result;
+    }
+
+    // Stencil, in parallel if pool is non-null.
+    template <typename Tother, typename Tfunc>
+    void stencil_(
+            thread_pool* pool,
+            const Tother& src,
+            multi<int, 2> radius,
+            multi<int, 2> cycle_mode,
+            Tfunc& func)
+    {
+        if (static_cast<const void*>(&src) ==
+            static_cast<const void*>(this) ||
+            radius[0] < 0 ||
+            radius[1] < 0) {
+            throw std::invalid_argument(__PRETTY_FUNCTION__);
+        }
+        if (!(user_size_ == src.user_size()).all()) {
+            resize(src.user_size());
+        }
+        for_each_task_(pool, [&](size_type, size_type from, size_type to) {
+            stencil_accessor<Tother> accessor(src, cycle_mode);
+            for (size_type block = from; block < to; block++) {
+                multi<size_type, 2> origin =
+                        convert(block << block_area_log2);
+                accessor.interior_ = true;
+                for (int l = 0; l < 2; l++) {
+                    if (int(origin[l]) < radius[l] ||
+                        origin[l] + block_size + radius[l] >
+                            user_size_[l]) {
+                        accessor.interior_ = false;
+                    }
+                }
+                for_each_in_block_(block, [&](const auto& loc, size_type pos) {
+                    accessor.loc_ = loc;
+                    data_[pos] = func(loc, std::as_const(accessor));
+                });
+            }
+        });
+    }
+
+#endif // #if !DOXYGEN
 };
 
 /**@}*/
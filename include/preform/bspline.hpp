@@ -35,6 +35,9 @@
 #ifndef PREFORM_BSPLINE_HPP
 #define PREFORM_BSPLINE_HPP
 
+// for std::max, std::min, std::upper_bound
+#include <algorithm>
+
 // for std::vector
 #include <vector>
 
@@ -50,6 +53,12 @@
 // for pre::dense_matrix_view
 #include <preform/dense_matrix_view.hpp>
 
+// for pre::band_linalg
+#include <preform/band_linalg.hpp>
+
+// for pre::sparse_linalg
+#include <preform/sparse_linalg.hpp>
+
 namespace pre {
 
 /**
@@ -277,8 +286,13 @@ private:
      *
      * @param[in] t
      * Spline argument.
+     *
+     * @param[in] hint
+     * Span hint. If the span of `t` is the hint or its
+     * successor, as along increasing arguments, find it in constant
+     * time rather than by binary search.
      */
-    difference_type update(float_type t) const
+    difference_type update(float_type t, difference_type hint = -1) const
     {
         // Degree.
         difference_type d = degree();
@@ -290,10 +304,17 @@ private:
         t = pre::fmax(domain_min(),
             pre::fmin(domain_max(), t));
 
-        // Compute i such that u[i] <= t < u[i + 1]
-        difference_type i = d;
-        while (i + 1 < n && !(t < u_[i + 1])) {
-            i++;
+        // Compute i such that u[i] <= t < u[i + 1].
+        difference_type i = -1;
+        for (difference_type k = std::max(hint, d);
+                             k <= hint + 1 && k < n; k++) {
+            if (!(t < u_[k]) && (k + 1 == n || t < u_[k + 1])) {
+                i = k;
+                break;
+            }
+        }
+        if (i < 0) {
+            i = std::upper_bound(u_ + d + 1, u_ + n, t) - u_ - 1;
         }
 
         // Update initial entry.
@@ -323,6 +344,368 @@ private:
         return i;
     }
 
+    /**
+     * @brief Basis function values and derivatives.
+     *
+     * After `update()` returns @f$ i @f$, copy @f$ B_{d,k} @f$ and
+     * @f$ B_{d,k}' @f$ for @f$ k \in [i - d, i] @f$, where
+     * @f[
+     *      B_{d,k}' = d \left(
+     *          \frac{B_{d-1,k}}{u_{k+d} - u_k} -
+     *          \frac{B_{d-1,k+1}}{u_{k+d+1} - u_{k+1}} \right).
+     * @f]
+     *
+     * @param[in] i
+     * Span, as returned by `update()`.
+     *
+     * @param[out] b
+     * Values, of size @f$ d + 1 @f$.
+     *
+     * @param[out] db
+     * Derivatives, of size @f$ d + 1 @f$. _Optional_.
+     */
+    void values(difference_type i, float_type* b, float_type* db) const
+    {
+        difference_type d = degree();
+        for (difference_type l = 0; l <= d; l++) {
+            b[l] = b_[d][i - d + l];
+        }
+        if (db) {
+            for (difference_type l = 0; l <= d; l++) {
+                difference_type k = i - d + l;
+                float_type fac0 = 0;
+                float_type fac1 = 0;
+                if (l > 0 && u_[k + d] > u_[k]) {
+                    fac0 = b_[d - 1][k] / (u_[k + d] - u_[k]);
+                }
+                if (l < d && u_[k + d + 1] > u_[k + 1]) {
+                    fac1 = b_[d - 1][k + 1] / (u_[k + d + 1] - u_[k + 1]);
+                }
+                db[l] = float_type(d) * (fac0 - fac1);
+            }
+        }
+    }
+
+    /**
+     * @brief Evaluate curve at many arguments.
+     *
+     * @param[in] basis
+     * Basis functions.
+     *
+     * @param[in] p
+     * Control points.
+     *
+     * @param[in] w
+     * Control point weights. _Optional_. If null, non-rational.
+     *
+     * @param[in] t
+     * Arguments.
+     *
+     * @param[in] count
+     * Count.
+     *
+     * @param[out] res
+     * Results.
+     *
+     * @param[out] dres
+     * Result derivatives. _Optional_.
+     */
+    template <typename Tpoint>
+    static void evaluate_many(
+                const bspline_basis_functions& basis,
+                const Tpoint* p,
+                const float_type* w,
+                const float_type* t, size_type count,
+                Tpoint* res,
+                Tpoint* dres)
+    {
+        difference_type d = basis.degree();
+        std::vector<float_type> tmp(2 * (d + 1));
+        float_type* b = &tmp[0];
+        float_type* db = dres ? &tmp[d + 1] : nullptr;
+        difference_type i = -1;
+        for (size_type k = 0; k < count; k++) {
+            i = basis.update(t[k], i);
+            basis.values(i, b, db);
+            Tpoint a = Tpoint();
+            Tpoint da = Tpoint();
+            float_type aw = 0;
+            float_type daw = 0;
+            for (difference_type l = 0; l <= d; l++) {
+                difference_type j = i - d + l;
+                float_type wj = w ? w[j] : float_type(1);
+                a += (b[l] * wj) * p[j];
+                aw += b[l] * wj;
+                if (db) {
+                    da += (db[l] * wj) * p[j];
+                    daw += db[l] * wj;
+                }
+            }
+            if (w) {
+                a /= aw;
+                da -= daw * a;
+                da /= aw;
+            }
+            res[k] = a;
+            if (dres) {
+                dres[k] = da;
+            }
+        }
+    }
+
+    /**
+     * @brief Evaluate patch at many arguments.
+     *
+     * @param[in] basis0
+     * Basis functions in dimension 0.
+     *
+     * @param[in] basis1
+     * Basis functions in dimension 1.
+     *
+     * @param[in] p
+     * Control points.
+     *
+     * @param[in] w
+     * Control point weights. _Optional_. If null, non-rational.
+     *
+     * @param[in] t
+     * Arguments.
+     *
+     * @param[in] count
+     * Count.
+     *
+     * @param[out] res
+     * Results.
+     *
+     * @param[out] dres0
+     * Result derivatives in dimension 0. _Optional_.
+     *
+     * @param[out] dres1
+     * Result derivatives in dimension 1. _Optional_.
+     */
+    template <typename Tpoint>
+    static void evaluate_many(
+                const bspline_basis_functions& basis0,
+                const bspline_basis_functions& basis1,
+                const Tpoint* p,
+                const float_type* w,
+                const multi<float_type, 2>* t, size_type count,
+                Tpoint* res,
+                Tpoint* dres0,
+                Tpoint* dres1)
+    {
+        difference_type d0 = basis0.degree();
+        difference_type d1 = basis1.degree();
+        difference_type n1 = basis1.num_control_points();
+        std::vector<float_type> tmp(2 * (d0 + 1) + 2 * (d1 + 1));
+        float_type* b0 = &tmp[0];
+        float_type* b1 = &tmp[d0 + 1];
+        float_type* db0 = dres0 ? &tmp[d0 + d1 + 2] : nullptr;
+        float_type* db1 = dres1 ? &tmp[2 * d0 + d1 + 3] : nullptr;
+        difference_type i0 = -1;
+        difference_type i1 = -1;
+        for (size_type k = 0; k < count; k++) {
+            i0 = basis0.update(t[k][0], i0);
+            i1 = basis1.update(t[k][1], i1);
+            basis0.values(i0, b0, db0);
+            basis1.values(i1, b1, db1);
+            Tpoint a = Tpoint();
+            Tpoint da0 = Tpoint();
+            Tpoint da1 = Tpoint();
+            float_type aw = 0;
+            float_type daw0 = 0;
+            float_type daw1 = 0;
+            for (difference_type l0 = 0; l0 <= d0; l0++)
+            for (difference_type l1 = 0; l1 <= d1; l1++) {
+                difference_type j = (i0 - d0 + l0) * n1 + (i1 - d1 + l1);
+                float_type wj = w ? w[j] : float_type(1);
+                a += (b0[l0] * b1[l1] * wj) * p[j];
+                aw += b0[l0] * b1[l1] * wj;
+                if (db0) {
+                    da0 += (db0[l0] * b1[l1] * wj) * p[j];
+                    daw0 += db0[l0] * b1[l1] * wj;
+                }
+                if (db1) {
+                    da1 += (b0[l0] * db1[l1] * wj) * p[j];
+                    daw1 += b0[l0] * db1[l1] * wj;
+                }
+            }
+            if (w) {
+                a /= aw;
+                da0 -= daw0 * a;
+                da0 /= aw;
+                da1 -= daw1 * a;
+                da1 /= aw;
+            }
+            res[k] = a;
+            if (dres0) {
+                dres0[k] = da0;
+            }
+            if (dres1) {
+                dres1[k] = da1;
+            }
+        }
+    }
+
+    /**
+     * @brief Evaluate patch on grid.
+     *
+     * Computes spans and basis functions once per grid line, and
+     * contracts control points in dimension 0 once per row, so
+     * each grid point costs @f$ O(d_1) @f$ rather than
+     * @f$ O(d_0 d_1) @f$. Results are row-major, that is, the
+     * result at @f$ (t_0[k_0], t_1[k_1]) @f$ is at index
+     * @f$ k_0 \cdot \text{count}_1 + k_1 @f$.
+     *
+     * @param[in] basis0
+     * Basis functions in dimension 0.
+     *
+     * @param[in] basis1
+     * Basis functions in dimension 1.
+     *
+     * @param[in] p
+     * Control points.
+     *
+     * @param[in] w
+     * Control point weights. _Optional_. If null, non-rational.
+     *
+     * @param[in] t0
+     * Arguments in dimension 0.
+     *
+     * @param[in] count0
+     * Count in dimension 0.
+     *
+     * @param[in] t1
+     * Arguments in dimension 1.
+     *
+     * @param[in] count1
+     * Count in dimension 1.
+     *
+     * @param[out] res
+     * Results.
+     *
+     * @param[out] dres0
+     * Result derivatives in dimension 0. _Optional_.
+     *
+     * @param[out] dres1
+     * Result derivatives in dimension 1. _Optional_.
+     */
+    template <typename Tpoint>
+    static void evaluate_grid(
+                const bspline_basis_functions& basis0,
+                const bspline_basis_functions& basis1,
+                const Tpoint* p,
+                const float_type* w,
+                const float_type* t0, size_type count0,
+                const float_type* t1, size_type count1,
+                Tpoint* res,
+                Tpoint* dres0,
+                Tpoint* dres1)
+    {
+        if (count0 == 0 || count1 == 0) {
+            return;
+        }
+        difference_type d0 = basis0.degree();
+        difference_type d1 = basis1.degree();
+        difference_type n1 = basis1.num_control_points();
+
+        // Spans and basis functions in dimension 1.
+        std::vector<difference_type> i1s(count1);
+        std::vector<float_type> b1s(count1 * (d1 + 1));
+        std::vector<float_type> db1s(dres1 ? count1 * (d1 + 1) : 0);
+        difference_type i1min = n1;
+        difference_type i1max = 0;
+        difference_type i1 = -1;
+        for (size_type k1 = 0; k1 < count1; k1++) {
+            i1 = basis1.update(t1[k1], i1);
+            basis1.values(i1,
+                    &b1s[k1 * (d1 + 1)],
+                    dres1 ? &db1s[k1 * (d1 + 1)] : nullptr);
+            i1s[k1] = i1;
+            i1min = std::min(i1min, i1 - d1);
+            i1max = std::max(i1max, i1);
+        }
+
+        // Rows, contracted in dimension 0.
+        std::vector<Tpoint> q(n1);
+        std::vector<Tpoint> dq(dres0 ? n1 : 0);
+        std::vector<float_type> qw(n1, float_type(1));
+        std::vector<float_type> dqw(n1);
+        std::vector<float_type> tmp(2 * (d0 + 1));
+        float_type* b0 = &tmp[0];
+        float_type* db0 = dres0 ? &tmp[d0 + 1] : nullptr;
+        difference_type i0 = -1;
+        for (size_type k0 = 0; k0 < count0; k0++) {
+            i0 = basis0.update(t0[k0], i0);
+            basis0.values(i0, b0, db0);
+            for (difference_type j1 = i1min; j1 <= i1max; j1++) {
+                Tpoint a = Tpoint();
+                Tpoint da = Tpoint();
+                float_type aw = 0;
+                float_type daw = 0;
+                for (difference_type l0 = 0; l0 <= d0; l0++) {
+                    difference_type j = (i0 - d0 + l0) * n1 + j1;
+                    float_type wj = w ? w[j] : float_type(1);
+                    a += (b0[l0] * wj) * p[j];
+                    aw += b0[l0] * wj;
+                    if (db0) {
+                        da += (db0[l0] * wj) * p[j];
+                        daw += db0[l0] * wj;
+                    }
+                }
+                q[j1] = a;
+                if (w) {
+                    qw[j1] = aw;
+                }
+                if (db0) {
+                    dq[j1] = da;
+                    dqw[j1] = daw;
+                }
+            }
+
+            // Evaluate row.
+            for (size_type k1 = 0; k1 < count1; k1++) {
+                const float_type* b1 = &b1s[k1 * (d1 + 1)];
+                const float_type* db1 =
+                    dres1 ? &db1s[k1 * (d1 + 1)] : nullptr;
+                Tpoint a = Tpoint();
+                Tpoint da0 = Tpoint();
+                Tpoint da1 = Tpoint();
+                float_type aw = 0;
+                float_type daw0 = 0;
+                float_type daw1 = 0;
+                for (difference_type l1 = 0; l1 <= d1; l1++) {
+                    difference_type j1 = i1s[k1] - d1 + l1;
+                    a += b1[l1] * q[j1];
+                    aw += b1[l1] * qw[j1];
+                    if (db0) {
+                        da0 += b1[l1] * dq[j1];
+                        daw0 += b1[l1] * dqw[j1];
+                    }
+                    if (db1) {
+                        da1 += db1[l1] * q[j1];
+                        daw1 += db1[l1] * qw[j1];
+                    }
+                }
+                if (w) {
+                    a /= aw;
+                    da0 -= daw0 * a;
+                    da0 /= aw;
+                    da1 -= daw1 * a;
+                    da1 /= aw;
+                }
+                size_type k = k0 * count1 + k1;
+                res[k] = a;
+                if (dres0) {
+                    dres0[k] = da0;
+                }
+                if (dres1) {
+                    dres1[k] = da1;
+                }
+            }
+        }
+    }
+
 private:
 
     /**
@@ -361,6 +744,22 @@ private:
     friend class nurbs_patch;
 };
 
+#if !DOXYGEN
+
+template <std::size_t N, typename T>
+inline auto& bspline_coord_(T& p, std::size_t k)
+{
+    if constexpr (N == 1) {
+        (void)k;
+        return p;
+    }
+    else {
+        return p[k];
+    }
+}
+
+#endif // #if !DOXYGEN
+
 /**
  * @brief B-spline curve.
  *
@@ -496,7 +895,7 @@ public:
         // Fix pointers.
         if (basis_vals_.size() > 0) {
             basis_.u_ = &basis_vals_[0];
-            basis_.b_.offset_ = &basis_vals_[basis_.num_knots()];
+            basis_.b_.begin_itr_ = &basis_vals_[basis_.num_knots()];
         }
     }
 
@@ -527,7 +926,7 @@ public:
             // Fix pointers.
             if (basis_vals_.size() > 0) {
                 basis_.u_ = &basis_vals_[0];
-                basis_.b_.offset_ = &basis_vals_[basis_.num_knots()];
+                basis_.b_.begin_itr_ = &basis_vals_[basis_.num_knots()];
             }
         }
 
@@ -692,6 +1091,192 @@ public:
         return res;
     }
 
+    /**
+     * @brief Evaluate at many arguments.
+     *
+     * Finds each span by searching from the previous one, so that
+     * increasing arguments do not need binary search, and computes
+     * derivatives in the same pass.
+     *
+     * @param[in] t
+     * Spline arguments.
+     *
+     * @param[in] count
+     * Count.
+     *
+     * @param[out] res
+     * Results, of size `count`.
+     *
+     * @param[out] dres
+     * Result derivatives, of size `count`. _Optional_.
+     */
+    void evaluate_many(
+            const float_type* t, size_type count,
+            point_type* res,
+            point_type* dres = nullptr) const
+    {
+        bspline_basis_functions<float_type>::evaluate_many(
+                basis_, p_.data(), nullptr,
+                t, count, res, dres);
+    }
+
+    /**
+     * @brief Fit to samples, by regularized least squares.
+     *
+     * Set control points to minimize
+     * @f[
+     *      \sum_k \lVert \mathbf{C}(t_k) - \mathbf{p}_k \rVert^2 +
+     *      \lambda \sum_j \lVert \mathbf{P}_{j+1} - \mathbf{P}_j \rVert^2
+     * @f]
+     * where the knots are as set beforehand. The normal equations
+     * are banded, with bandwidth @f$ \max(d, 1) @f$, so they are
+     * assembled and solved by band Cholesky in
+     * @f$ O((k + n) d^2) @f$ time for @f$ k @f$ samples.
+     *
+     * @param[in] tfrom
+     * Sample arguments range from.
+     *
+     * @param[in] tto
+     * Sample arguments range to.
+     *
+     * @param[in] pfrom
+     * Sample points range from.
+     *
+     * @param[in] lambda
+     * Smoothing weight @f$ \lambda @f$. Should be positive unless
+     * the samples support every basis function.
+     *
+     * @throw std::runtime_error
+     * If the normal equations are singular.
+     */
+    template <typename Tfloat_itr, typename Tpoint_itr>
+    void fit(
+            Tfloat_itr tfrom,
+            Tfloat_itr tto,
+            Tpoint_itr pfrom,
+            float_type lambda = 0)
+    {
+        // Degree.
+        difference_type d = basis_.degree();
+
+        // Number of control points.
+        difference_type n = basis_.num_control_points();
+
+        // Normal equations, band by columns, and right-hand sides.
+        difference_type kl = std::max(d, difference_type(1));
+        std::vector<float_type> tmp((kl + 1 + N) * n);
+        dense_matrix_view<float_type*> a = {
+            &tmp[0], 1, kl + 1, kl + 1, n
+        };
+        dense_matrix_view<float_type*> x = {
+            &tmp[(kl + 1) * n], N, 1, n, N
+        };
+        for (; tfrom != tto; ++tfrom, ++pfrom) {
+            difference_type i = basis_.update(*tfrom);
+            dense_vector_view<float_type*> b = basis_.b_[d];
+            point_type p = *pfrom;
+            for (difference_type j0 = i - d; j0 <= i; j0++) {
+                for (difference_type j1 = j0; j1 <= i; j1++) {
+                    a[j1 - j0][j0] += b[j0] * b[j1];
+                }
+                for (size_type k = 0; k < N; k++) {
+                    x[j0][k] += b[j0] * bspline_coord_<N>(p, k);
+                }
+            }
+        }
+
+        // Smoothing.
+        for (difference_type j = 0; j + 1 < n; j++) {
+            a[0][j] += lambda;
+            a[0][j + 1] += lambda;
+            a[1][j] -= lambda;
+        }
+
+        // Solve.
+        band_linalg<float_type>::chol(a);
+        band_linalg<float_type>::chol_solve(a, x);
+        for (difference_type j = 0; j < n; j++) {
+            for (size_type k = 0; k < N; k++) {
+                bspline_coord_<N>(p_[j], k) = x[j][k];
+            }
+        }
+    }
+
+    /**
+     * @brief Interpolate samples.
+     *
+     * Set control points such that @f$ \mathbf{C}(t_k) = \mathbf{p}_k @f$
+     * for @f$ n @f$ samples, where the knots are as set beforehand.
+     * Sample arguments should be increasing, so that the collocation
+     * matrix is banded. The collocation matrix is then solved by band
+     * LU without pivoting, which is stable because B-spline collocation
+     * matrices are totally positive.
+     *
+     * @param[in] tfrom
+     * Sample arguments range from, of size @f$ n @f$.
+     *
+     * @param[in] pfrom
+     * Sample points range from, of size @f$ n @f$.
+     *
+     * @throw std::runtime_error
+     * If the collocation matrix is singular, that is, unless
+     * the Schoenberg-Whitney conditions hold.
+     */
+    template <typename Tfloat_itr, typename Tpoint_itr>
+    void interpolate(
+            Tfloat_itr tfrom,
+            Tpoint_itr pfrom)
+    {
+        // Degree.
+        difference_type d = basis_.degree();
+
+        // Number of control points.
+        difference_type n = basis_.num_control_points();
+
+        // Collocation rows, and right-hand sides.
+        std::vector<difference_type> spans(n);
+        std::vector<float_type> rows((d + 1 + N) * n);
+        dense_matrix_view<float_type*> x = {
+            &rows[(d + 1) * n], N, 1, n, N
+        };
+        difference_type kl = 0;
+        difference_type ku = 0;
+        for (difference_type r = 0; r < n; r++, ++tfrom, ++pfrom) {
+            difference_type i = basis_.update(*tfrom);
+            dense_vector_view<float_type*> b = basis_.b_[d];
+            for (difference_type l = 0; l <= d; l++) {
+                rows[r * (d + 1) + l] = b[i - d + l];
+            }
+            spans[r] = i;
+            kl = std::max(kl, r - (i - d));
+            ku = std::max(ku, i - r);
+            point_type p = *pfrom;
+            for (size_type k = 0; k < N; k++) {
+                x[r][k] = bspline_coord_<N>(p, k);
+            }
+        }
+
+        // Collocation matrix, band by columns.
+        std::vector<float_type> tmp((kl + ku + 1) * n);
+        dense_matrix_view<float_type*> a = {
+            &tmp[0], 1, kl + ku + 1, kl + ku + 1, n
+        };
+        for (difference_type r = 0; r < n; r++)
+        for (difference_type l = 0; l <= d; l++) {
+            difference_type c = spans[r] - d + l;
+            a[ku + r - c][c] = rows[r * (d + 1) + l];
+        }
+
+        // Solve.
+        band_linalg<float_type>::lu(a, kl);
+        band_linalg<float_type>::lu_solve(a, kl, x);
+        for (difference_type j = 0; j < n; j++) {
+            for (size_type k = 0; k < N; k++) {
+                bspline_coord_<N>(p_[j], k) = x[j][k];
+            }
+        }
+    }
+
 private:
 
     /**
@@ -864,11 +1449,11 @@ public:
             difference_type m1 = basis1_.num_knots();
             basis0_.u_ =
                 &basis_vals_[0];
-            basis0_.b_.offset_ =
+            basis0_.b_.begin_itr_ =
                 &basis_vals_[m0];
             basis1_.u_ =
                 &basis_vals_[m0 + m0 * (d0 + 1)];
-            basis1_.b_.offset_ =
+            basis1_.b_.begin_itr_ =
                 &basis_vals_[m0 + m0 * (d0 + 1) + m1];
         }
     }
@@ -907,11 +1492,11 @@ public:
                 difference_type m1 = basis1_.num_knots();
                 basis0_.u_ =
                     &basis_vals_[0];
-                basis0_.b_.offset_ =
+                basis0_.b_.begin_itr_ =
                     &basis_vals_[m0];
                 basis1_.u_ =
                     &basis_vals_[m0 + m0 * (d0 + 1)];
-                basis1_.b_.offset_ =
+                basis1_.b_.begin_itr_ =
                     &basis_vals_[m0 + m0 * (d0 + 1) + m1];
             }
         }
@@ -1118,6 +1703,239 @@ public:
         return res;
     }
 
+    /**
+     * @brief Evaluate at many arguments.
+     *
+     * Finds each span by searching from the previous one, so that
+     * increasing arguments do not need binary search, and computes
+     * derivatives in the same pass.
+     *
+     * @param[in] t
+     * Spline arguments.
+     *
+     * @param[in] count
+     * Count.
+     *
+     * @param[out] res
+     * Results, of size `count`.
+     *
+     * @param[out] dres0
+     * Result derivatives in dimension 0, of size `count`. _Optional_.
+     *
+     * @param[out] dres1
+     * Result derivatives in dimension 1, of size `count`. _Optional_.
+     */
+    void evaluate_many(
+            const multi<float_type, 2>* t, size_type count,
+            point_type* res,
+            point_type* dres0 = nullptr,
+            point_type* dres1 = nullptr) const
+    {
+        bspline_basis_functions<float_type>::evaluate_many(
+                basis0_, basis1_, p_.data(), nullptr,
+                t, count, res, dres0, dres1);
+    }
+
+    /**
+     * @brief Evaluate on grid.
+     *
+     * Computes spans and basis functions once per grid line, and
+     * combines control points in dimension 0 once per grid row,
+     * so that each grid point costs @f$ O(d_1) @f$ rather than
+     * @f$ O(d_0 d_1) @f$. Derivatives are computed in the same pass.
+     *
+     * @param[in] t0
+     * Spline arguments in dimension 0.
+     *
+     * @param[in] count0
+     * Count in dimension 0.
+     *
+     * @param[in] t1
+     * Spline arguments in dimension 1.
+     *
+     * @param[in] count1
+     * Count in dimension 1.
+     *
+     * @param[out] res
+     * Results, of size `count0 * count1`, in row-major order.
+     *
+     * @param[out] dres0
+     * Result derivatives in dimension 0. _Optional_.
+     *
+     * @param[out] dres1
+     * Result derivatives in dimension 1. _Optional_.
+     */
+    void evaluate_grid(
+            const float_type* t0, size_type count0,
+            const float_type* t1, size_type count1,
+            point_type* res,
+            point_type* dres0 = nullptr,
+            point_type* dres1 = nullptr) const
+    {
+        bspline_basis_functions<float_type>::evaluate_grid(
+                basis0_, basis1_, p_.data(), nullptr,
+                t0, count0, t1, count1, res, dres0, dres1);
+    }
+
+    /**
+     * @brief Fit to samples, by regularized least squares.
+     *
+     * Set control points to minimize
+     * @f[
+     *      \sum_k \lVert \mathbf{S}(\mathbf{t}_k) - \mathbf{p}_k \rVert^2 +
+     *      \lambda \sum_{\mathbf{j} \sim \mathbf{j}'}
+     *      \lVert \mathbf{P}_{\mathbf{j}} - \mathbf{P}_{\mathbf{j}'} \rVert^2
+     * @f]
+     * where @f$ \mathbf{j} \sim \mathbf{j}' @f$ are adjacent control
+     * points, and the knots are as set beforehand. The normal equations
+     * couple only control points within @f$ \max(d_0, 1) @f$ rows and
+     * @f$ \max(d_1, 1) @f$ columns of each other, so they are assembled
+     * in compressed sparse row form and solved by preconditioned
+     * conjugate gradient, starting from the current control points.
+     *
+     * @param[in] tfrom
+     * Sample arguments range from.
+     *
+     * @param[in] tto
+     * Sample arguments range to.
+     *
+     * @param[in] pfrom
+     * Sample points range from.
+     *
+     * @param[in] lambda
+     * Smoothing weight @f$ \lambda @f$. Should be positive unless
+     * the samples support every basis function.
+     *
+     * @param[in] tol
+     * Tolerance on relative residual.
+     *
+     * @param[in] max_iters
+     * Maximum number of iterations.
+     *
+     * @returns
+     * Number of iterations, maximized over coordinates.
+     *
+     * @throw std::runtime_error
+     * If some control point is unconstrained, that is, if
+     * `lambda == 0` and no sample supports its basis function.
+     */
+    template <typename Tfloat_itr, typename Tpoint_itr>
+    int fit(
+            Tfloat_itr tfrom,
+            Tfloat_itr tto,
+            Tpoint_itr pfrom,
+            float_type lambda = 0,
+            float_type tol =
+                pre::sqrt(pre::numeric_limits<float_type>::epsilon()),
+            int max_iters = 1000)
+    {
+        // Degrees.
+        difference_type d0 = basis0_.degree();
+        difference_type d1 = basis1_.degree();
+
+        // Number of control points.
+        difference_type n0 = basis0_.num_control_points();
+        difference_type n1 = basis1_.num_control_points();
+        difference_type n = n0 * n1;
+
+        // Sparsity pattern, sorted by column in each row.
+        difference_type e0 = std::max(d0, difference_type(1));
+        difference_type e1 = std::max(d1, difference_type(1));
+        std::vector<int> row_ptr(n + 1);
+        std::vector<int> col_ind;
+        for (difference_type j0 = 0; j0 < n0; j0++)
+        for (difference_type j1 = 0; j1 < n1; j1++) {
+            difference_type a0 = std::max(j0 - e0, difference_type(0));
+            difference_type a1 = std::max(j1 - e1, difference_type(0));
+            difference_type b0 = std::min(j0 + e0, n0 - 1);
+            difference_type b1 = std::min(j1 + e1, n1 - 1);
+            for (difference_type k0 = a0; k0 <= b0; k0++)
+            for (difference_type k1 = a1; k1 <= b1; k1++) {
+                col_ind.push_back(int(k0 * n1 + k1));
+            }
+            row_ptr[j0 * n1 + j1 + 1] = int(col_ind.size());
+        }
+
+        // Position of entry in row j0 * n1 + j1.
+        auto entry = [&](difference_type j0, difference_type j1,
+                         difference_type k0, difference_type k1) {
+            difference_type a0 = std::max(j0 - e0, difference_type(0));
+            difference_type a1 = std::max(j1 - e1, difference_type(0));
+            difference_type b1 = std::min(j1 + e1, n1 - 1);
+            return row_ptr[j0 * n1 + j1] +
+                   (k0 - a0) * (b1 - a1 + 1) + (k1 - a1);
+        };
+
+        // Normal equations, and right-hand sides.
+        std::vector<float_type> val(col_ind.size());
+        std::vector<float_type> rhs(N * n);
+        for (; tfrom != tto; ++tfrom, ++pfrom) {
+            multi<float_type, 2> t = *tfrom;
+            difference_type i0 = basis0_.update(t[0]);
+            difference_type i1 = basis1_.update(t[1]);
+            dense_vector_view<float_type*> b0 = basis0_.b_[d0];
+            dense_vector_view<float_type*> b1 = basis1_.b_[d1];
+            point_type p = *pfrom;
+            for (difference_type j0 = i0 - d0; j0 <= i0; j0++)
+            for (difference_type j1 = i1 - d1; j1 <= i1; j1++) {
+                float_type bj = b0[j0] * b1[j1];
+                for (difference_type k0 = i0 - d0; k0 <= i0; k0++) {
+                    int pos = entry(j0, j1, k0, i1 - d1);
+                    for (difference_type k1 = i1 - d1; k1 <= i1; k1++) {
+                        val[pos++] += bj * (b0[k0] * b1[k1]);
+                    }
+                }
+                for (size_type k = 0; k < N; k++) {
+                    rhs[k * n + j0 * n1 + j1] +=
+                        bj * bspline_coord_<N>(p, k);
+                }
+            }
+        }
+
+        // Smoothing.
+        for (difference_type j0 = 0; j0 < n0; j0++)
+        for (difference_type j1 = 0; j1 < n1; j1++) {
+            if (j0 + 1 < n0) {
+                val[entry(j0, j1, j0, j1)] += lambda;
+                val[entry(j0 + 1, j1, j0 + 1, j1)] += lambda;
+                val[entry(j0, j1, j0 + 1, j1)] -= lambda;
+                val[entry(j0 + 1, j1, j0, j1)] -= lambda;
+            }
+            if (j1 + 1 < n1) {
+                val[entry(j0, j1, j0, j1)] += lambda;
+                val[entry(j0, j1 + 1, j0, j1 + 1)] += lambda;
+                val[entry(j0, j1, j0, j1 + 1)] -= lambda;
+                val[entry(j0, j1 + 1, j0, j1)] -= lambda;
+            }
+        }
+
+        // Solve each coordinate, starting from current control points.
+        csr_matrix_view<const float_type> a = {
+            &row_ptr[0],
+            &col_ind[0],
+            &val[0],
+            int(n),
+            int(n)
+        };
+        std::vector<float_type> x(n);
+        int iters = 0;
+        for (size_type k = 0; k < N; k++) {
+            for (difference_type j = 0; j < n; j++) {
+                x[j] = bspline_coord_<N>(p_[j], k);
+            }
+            iters = std::max(iters,
+                sparse_linalg<float_type>::cg(
+                    a,
+                    {&rhs[k * n], 1, n},
+                    {&x[0], 1, n},
+                    tol, max_iters));
+            for (difference_type j = 0; j < n; j++) {
+                bspline_coord_<N>(p_[j], k) = x[j];
+            }
+        }
+        return iters;
+    }
+
 private:
 
     /**
@@ -1286,7 +2104,7 @@ public:
         // Fix pointers.
         if (basis_vals_.size() > 0) {
             basis_.u_ = &basis_vals_[0];
-            basis_.b_.offset_ = &basis_vals_[basis_.num_knots()];
+            basis_.b_.begin_itr_ = &basis_vals_[basis_.num_knots()];
         }
     }
 
@@ -1319,7 +2137,7 @@ public:
             // Fix pointers.
             if (basis_vals_.size() > 0) {
                 basis_.u_ = &basis_vals_[0];
-                basis_.b_.offset_ = &basis_vals_[basis_.num_knots()];
+                basis_.b_.begin_itr_ = &basis_vals_[basis_.num_knots()];
             }
         }
 
@@ -1528,6 +2346,35 @@ public:
         return res;
     }
 
+    /**
+     * @brief Evaluate at many arguments.
+     *
+     * Finds each span by searching from the previous one, so that
+     * increasing arguments do not need binary search, and computes
+     * derivatives in the same pass.
+     *
+     * @param[in] t
+     * Spline arguments.
+     *
+     * @param[in] count
+     * Count.
+     *
+     * @param[out] res
+     * Results, of size `count`.
+     *
+     * @param[out] dres
+     * Result derivatives, of size `count`. _Optional_.
+     */
+    void evaluate_many(
+            const float_type* t, size_type count,
+            point_type* res,
+            point_type* dres = nullptr) const
+    {
+        bspline_basis_functions<float_type>::evaluate_many(
+                basis_, p_.data(), w_.data(),
+                t, count, res, dres);
+    }
+
 private:
 
     /**
@@ -1716,11 +2563,11 @@ public:
             difference_type m1 = basis1_.num_knots();
             basis0_.u_ =
                 &basis_vals_[0];
-            basis0_.b_.offset_ =
+            basis0_.b_.begin_itr_ =
                 &basis_vals_[m0];
             basis1_.u_ =
                 &basis_vals_[m0 + m0 * (d0 + 1)];
-            basis1_.b_.offset_ =
+            basis1_.b_.begin_itr_ =
                 &basis_vals_[m0 + m0 * (d0 + 1) + m1];
         }
     }
@@ -1761,11 +2608,11 @@ public:
                 difference_type m1 = basis1_.num_knots();
                 basis0_.u_ =
                     &basis_vals_[0];
-                basis0_.b_.offset_ =
+                basis0_.b_.begin_itr_ =
                     &basis_vals_[m0];
                 basis1_.u_ =
                     &basis_vals_[m0 + m0 * (d0 + 1)];
-                basis1_.b_.offset_ =
+                basis1_.b_.begin_itr_ =
                     &basis_vals_[m0 + m0 * (d0 + 1) + m1];
             }
         }
@@ -2018,6 +2865,80 @@ public:
         return res;
     }
 
+    /**
+     * @brief Evaluate at many arguments.
+     *
+     * Finds each span by searching from the previous one, so that
+     * increasing arguments do not need binary search, and computes
+     * derivatives in the same pass.
+     *
+     * @param[in] t
+     * Spline arguments.
+     *
+     * @param[in] count
+     * Count.
+     *
+     * @param[out] res
+     * Results, of size `count`.
+     *
+     * @param[out] dres0
+     * Result derivatives in dimension 0, of size `count`. _Optional_.
+     *
+     * @param[out] dres1
+     * Result derivatives in dimension 1, of size `count`. _Optional_.
+     */
+    void evaluate_many(
+            const multi<float_type, 2>* t, size_type count,
+            point_type* res,
+            point_type* dres0 = nullptr,
+            point_type* dres1 = nullptr) const
+    {
+        bspline_basis_functions<float_type>::evaluate_many(
+                basis0_, basis1_, p_.data(), w_.data(),
+                t, count, res, dres0, dres1);
+    }
+
+    /**
+     * @brief Evaluate on grid.
+     *
+     * Computes spans and basis functions once per grid line, and
+     * combines control points in dimension 0 once per grid row,
+     * so that each grid point costs @f$ O(d_1) @f$ rather than
+     * @f$ O(d_0 d_1) @f$. Derivatives are computed in the same pass.
+     *
+     * @param[in] t0
+     * Spline arguments in dimension 0.
+     *
+     * @param[in] count0
+     * Count in dimension 0.
+     *
+     * @param[in] t1
+     * Spline arguments in dimension 1.
+     *
+     * @param[in] count1
+     * Count in dimension 1.
+     *
+     * @param[out] res
+     * Results, of size `count0 * count1`, in row-major order.
+     *
+     * @param[out] dres0
+     * Result derivatives in dimension 0. _Optional_.
+     *
+     * @param[out] dres1
+     * Result derivatives in dimension 1. _Optional_.
+     */
+    void evaluate_grid(
+            const float_type* t0, size_type count0,
+            const float_type* t1, size_type count1,
+            point_type* res,
+            point_type* dres0 = nullptr,
+            point_type* dres1 = nullptr) const
+    {
+        bspline_basis_functions<float_type>::evaluate_grid(
+                basis0_, basis1_, p_.data(), w_.data(),
+                t0, count0, t1, count1, res, dres0, dres1);
+    }
+
 private:
 
     /**
@@ -41,9 +41,15 @@
 // for std::size_t
 #include <cstddef>
 
+// for std::uint16_t, std::uint32_t, std::uint64_t
+#include <cstdint>
+
 // for std::memcpy
 #include <cstring>
 
+// for std::invalid_argument
+#include <stdexcept>
+
 // for std::basic_string
 #include <string>
 
@@ -53,6 +59,13 @@
 // for std::is_arithmetic, ...
 #include <type_traits>
 
+#if defined(__SSSE3__) || defined(__AVX2__)
+
+// for _mm_shuffle_epi8, _mm256_shuffle_epi8, ...
+#include <immintrin.h>
+
+#endif // #if defined(__SSSE3__) || defined(__AVX2__)
+
 namespace pre {
 
 /**
@@ -104,6 +117,142 @@ inline byte_order host_byte_order()
     return uc == 1 ? byte_order::little : byte_order::big;
 }
 
+/**
+ * @name Byte swapping
+ */
+/**@{*/
+
+/**
+ * @brief Byte swap 16-bit value.
+ */
+constexpr std::uint16_t byte_swap(std::uint16_t x) noexcept
+{
+    return std::uint16_t((x >> 8) | (x << 8));
+}
+
+/**
+ * @brief Byte swap 32-bit value.
+ */
+constexpr std::uint32_t byte_swap(std::uint32_t x) noexcept
+{
+    return ((x >> 24) & 0x000000FFUL) |
+           ((x >>  8) & 0x0000FF00UL) |
+           ((x <<  8) & 0x00FF0000UL) |
+           ((x << 24) & 0xFF000000UL);
+}
+
+/**
+ * @brief Byte swap 64-bit value.
+ */
+constexpr std::uint64_t byte_swap(std::uint64_t x) noexcept
+{
+    return (std::uint64_t(byte_swap(std::uint32_t(x))) << 32) |
+            std::uint64_t(byte_swap(std::uint32_t(x >> 32)));
+}
+
+#if !DOXYGEN
+
+/**
+ * @brief Byte swap word in place.
+ */
+template <std::size_t Nsize>
+struct byte_swap_word_
+{
+    static void apply(unsigned char* bytes) noexcept
+    {
+        std::reverse(bytes, bytes + Nsize);
+    }
+};
+
+/**
+ * @brief Byte swap word in place, for words with a `byte_swap()`
+ * overload.
+ */
+template <typename Tword>
+struct byte_swap_word_as_
+{
+    static void apply(unsigned char* bytes) noexcept
+    {
+        Tword word;
+        std::memcpy(&word, bytes, sizeof(Tword));
+        word = byte_swap(word);
+        std::memcpy(bytes, &word, sizeof(Tword));
+    }
+};
+
+template <>
+struct byte_swap_word_<2> : byte_swap_word_as_<std::uint16_t> {};
+
+template <>
+struct byte_swap_word_<4> : byte_swap_word_as_<std::uint32_t> {};
+
+template <>
+struct byte_swap_word_<8> : byte_swap_word_as_<std::uint64_t> {};
+
+/**
+ * @brief Byte swap words of given size in place.
+ */
+template <std::size_t Nsize>
+inline void byte_swap_bytes_(unsigned char* bytes, std::size_t count) noexcept
+{
+    std::size_t k = 0;
+    std::size_t total = Nsize * count;
+#if defined(__SSSE3__) || defined(__AVX2__)
+    if (16 % Nsize == 0) {
+        alignas(16) unsigned char order[16];
+        for (std::size_t j = 0; j < 16; j++) {
+            order[j] = static_cast<unsigned char>(
+                       j - j % Nsize + (Nsize - 1 - j % Nsize));
+        }
+        __m128i mask =
+            _mm_load_si128(reinterpret_cast<const __m128i*>(&order[0]));
+#if defined(__AVX2__)
+        __m256i mask2 = _mm256_broadcastsi128_si256(mask);
+        for (; total - k >= 32; k += 32) {
+            __m256i* ptr = reinterpret_cast<__m256i*>(bytes + k);
+            _mm256_storeu_si256(
+                ptr, _mm256_shuffle_epi8(_mm256_loadu_si256(ptr), mask2));
+        }
+#endif // #if defined(__AVX2__)
+        for (; total - k >= 16; k += 16) {
+            __m128i* ptr = reinterpret_cast<__m128i*>(bytes + k);
+            _mm_storeu_si128(
+                ptr, _mm_shuffle_epi8(_mm_loadu_si128(ptr), mask));
+        }
+    }
+#endif // #if defined(__SSSE3__) || defined(__AVX2__)
+    for (; k < total; k += Nsize) {
+        byte_swap_word_<Nsize>::apply(bytes + k);
+    }
+}
+
+#endif // #if !DOXYGEN
+
+/**
+ * @brief Byte swap arithmetic values in place.
+ *
+ * Uses SSSE3 or AVX2 byte shuffles when compiled for them, and
+ * otherwise word-sized swaps, which compilers lower to `bswap`.
+ *
+ * @param[inout] values
+ * Values.
+ *
+ * @param[in] count
+ * Count.
+ */
+template <typename Tvalue>
+inline std::enable_if_t<
+       std::is_arithmetic<Tvalue>::value, void> byte_swap(
+                        Tvalue* values, std::size_t count) noexcept
+{
+    if (sizeof(Tvalue) > 1) {
+        byte_swap_bytes_<sizeof(Tvalue)>(
+            static_cast<unsigned char*>(static_cast<void*>(values)), count);
+    }
+}
+
+/**@}*/
+
 /**
  * @brief Byte stream wrapper.
  *
@@ -157,15 +306,10 @@ public:
         }
         else {
             // Reverse byte order.
-            char_type bytes[sizeof(Tvalue)];
-            std::memcpy(
-                    &bytes[0],
-                    &value,
-                    sizeof(Tvalue));
-            std::reverse(
-                    &bytes[0],
-                    &bytes[0] + sizeof(Tvalue));
-            ref_.get().write(&bytes[0], sizeof(Tvalue));
+            byte_swap(&value, 1);
+            ref_.get().write(
+                static_cast<const char_type*>(
+                static_cast<const void*>(&value)), sizeof(Tvalue));
         }
         return *this;
     }
@@ -178,26 +322,7 @@ public:
     std::is_arithmetic<Tvalue>::value,
             byte_stream_wrapper> operator<<(const Tvalue (&values)[N])
     {
-        if (rev_ == false || sizeof(Tvalue) == 1) {
-            ref_.get().write(
-                static_cast<const char_type*>(
-                static_cast<const void*>(&values[0])), sizeof(Tvalue) * N);
-        }
-        else {
-            // Reverse byte order.
-            char_type bytes[sizeof(Tvalue) * N];
-            std::memcpy(
-                &bytes[0],
-                &values[0],
-                sizeof(Tvalue) * N);
-            for (std::size_t k = 0; k < N; k++) {
-                std::reverse(
-                        &bytes[0] + k * sizeof(Tvalue),
-                        &bytes[0] + k * sizeof(Tvalue) + sizeof(Tvalue));
-            }
-            ref_.get().write(&bytes[0], sizeof(Tvalue) * N);
-        }
-        return *this;
+        return write(&values[0], N);
     }
 
     /**
@@ -226,18 +351,18 @@ public:
                 static_cast<const void*>(&values[0])), sizeof(Tvalue) * count);
         }
         else {
-            // Reverse byte order.
-            char_type bytes[sizeof(Tvalue)];
-            for (const Tvalue* value = values;
-                               value < values + count; value++) {
-                std::memcpy(
-                        &bytes[0],
-                        &value[0],
-                        sizeof(Tvalue));
-                std::reverse(
-                        &bytes[0],
-                        &bytes[0] + sizeof(Tvalue));
-                ref_.get().write(&bytes[0], sizeof(Tvalue));
+            // Reverse byte order, in buffered chunks.
+            constexpr std::size_t chunk =
+                    buffer_size / sizeof(Tvalue) > 0 ?
+                    buffer_size / sizeof(Tvalue) : 1;
+            Tvalue buffer[chunk];
+            for (std::size_t k = 0; k < count; k += chunk) {
+                std::size_t n = std::min(chunk, count - k);
+                std::memcpy(&buffer[0], values + k, sizeof(Tvalue) * n);
+                byte_swap(&buffer[0], n);
+                ref_.get().write(
+                    static_cast<const char_type*>(
+                    static_cast<const void*>(&buffer[0])), sizeof(Tvalue) * n);
             }
         }
         return *this;
@@ -258,15 +383,10 @@ public:
         }
         else {
             // Reverse byte order.
-            char_type bytes[sizeof(Tvalue)];
-            ref_.get().read(&bytes[0], sizeof(Tvalue));
-            std::reverse(
-                    &bytes[0],
-                    &bytes[0] + sizeof(Tvalue));
-            std::memcpy(
-                    &value,
-                    &bytes[0],
-                    sizeof(Tvalue));
+            ref_.get().read(
+                static_cast<char_type*>(
+                static_cast<void*>(&value)), sizeof(Tvalue));
+            byte_swap(&value, 1);
         }
         return *this;
     }
@@ -279,26 +399,7 @@ public:
     std::is_arithmetic<Tvalue>::value,
             byte_stream_wrapper> operator>>(Tvalue (&values)[N])
     {
-        if (rev_ == false || sizeof(Tvalue) == 1) {
-            ref_.get().read(
-                static_cast<char_type*>(
-                static_cast<void*>(&values[0])), sizeof(Tvalue) * N);
-        }
-        else {
-            // Reverse byte order.
-            char_type bytes[sizeof(Tvalue) * N];
-            ref_.get().read(&bytes[0], sizeof(Tvalue) * N);
-            for (std::size_t k = 0; k < N; k++) {
-                std::reverse(
-                        &bytes[0] + k * sizeof(Tvalue),
-                        &bytes[0] + k * sizeof(Tvalue) + sizeof(Tvalue));
-            }
-            std::memcpy(
-                    &values[0],
-                    &bytes[0],
-                    sizeof(Tvalue) * N);
-        }
-        return *this;
+        return read(&values[0], N);
     }
 
     /**
@@ -321,25 +422,12 @@ public:
                 throw std::invalid_argument(__PRETTY_FUNCTION__);
             }
         }
-        if (rev_ == false || sizeof(Tvalue) == 1) {
-            ref_.get().read(
-                static_cast<char_type*>(
-                static_cast<void*>(&values[0])), sizeof(Tvalue) * count);
-        }
-        else {
-            // Reverse byte order.
-            char_type bytes[sizeof(Tvalue)];
-            for (Tvalue* value = values;
-                         value < values + count; value++) {
-                ref_.get().read(&bytes[0], sizeof(Tvalue));
-                std::reverse(
-                        &bytes[0],
-                        &bytes[0] + sizeof(Tvalue));
-                std::memcpy(
-                        &value[0],
-                        &bytes[0],
-                        sizeof(Tvalue));
-            }
+        ref_.get().read(
+            static_cast<char_type*>(
+            static_cast<void*>(&values[0])), sizeof(Tvalue) * count);
+        if (rev_) {
+            // Reverse byte order, all at once.
+            byte_swap(values, count);
         }
         return *this;
     }
@@ -408,6 +496,11 @@ public:
 
 private:
 
+    /**
+     * @brief Buffer size, in bytes, for writing reversed arrays.
+     */
+    static constexpr std::size_t buffer_size = 4096;
+
     /**
      * @brief Stream reference.
      */
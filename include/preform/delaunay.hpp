@@ -35,20 +35,40 @@
 #ifndef PREFORM_DELAUNAY_HPP
 #define PREFORM_DELAUNAY_HPP
 
+#if !DOXYGEN
+#ifndef PREFORM_DELAUNAY_USE_THREADS
+#define PREFORM_DELAUNAY_USE_THREADS 1
+#endif // #ifndef PREFORM_DELAUNAY_USE_THREADS
+#endif // #if !DOXYGEN
+
 #include <cassert>
+#include <cstdint>
+#include <algorithm>
 #include <memory>
+#include <stdexcept>
 #include <vector>
-#include <map>
+#include <unordered_map>
 #include <set>
+#include <preform/exact_predicates.hpp>
 #include <preform/float_interval.hpp>
 #include <preform/memory_arena.hpp>
 #include <preform/memory_arena_allocator.hpp>
 #include <preform/iterator_range.hpp>
 #include <preform/multi.hpp>
 #include <preform/multi_math.hpp>
+#include <preform/random.hpp>
+#if PREFORM_DELAUNAY_USE_THREADS
+#include <preform/thread_pool.hpp>
+#endif // #if PREFORM_DELAUNAY_USE_THREADS
 
 namespace pre {
 
+#if !PREFORM_DELAUNAY_USE_THREADS && !DOXYGEN
+
+class thread_pool;
+
+#endif // #if !PREFORM_DELAUNAY_USE_THREADS && !DOXYGEN
+
 /**
  * @defgroup delaunay Delaunay triangulation (2-dimensional)
  *
@@ -111,6 +131,12 @@ public:
      */
     static constexpr index_type bad_index = -1;
 
+    /**
+     * @brief Point count above which `init_brio()` given a thread
+     * pool divides points into cells.
+     */
+    static constexpr size_type parallel_cutoff = 65536;
+
 public:
 
     /**
@@ -232,6 +258,32 @@ public:
         }
     };
 
+    /**
+     * @brief Edge hash.
+     *
+     * Hashes the sorted indices of each edge, consistent with
+     * `edge_type::operator==`.
+     */
+    class edge_hash
+    {
+    public:
+
+        /**
+         * @brief Hash.
+         */
+        std::size_t operator()(const edge_type& edge) const
+        {
+            auto [a, b] = std::minmax(edge.a, edge.b);
+            std::uint64_t h =
+                std::uint64_t(a) * 0x9e3779b97f4a7c15ULL ^
+                std::uint64_t(b);
+            h ^= h >> 31;
+            h *= 0xbf58476d1ce4e5b9ULL;
+            h ^= h >> 27;
+            return std::size_t(h);
+        }
+    };
+
 private:
 
     /**
@@ -494,53 +546,129 @@ public:
             }
         }
 
-        // Iterate triangles.
-        for (triangle_type& triangle : triangles_) {
+        // Finish.
+        finish_init();
+    }
 
-            // Triangle area negative?
-            if (pre::signbit(
-                signed_area<float_type>(
-                            triangle.a,
-                            triangle.b,
-                            triangle.c))) {
-                // Make counter-clockwise.
-                std::swap(
-                        triangle.b,
-                        triangle.c);
-            }
-        }
+    /**
+     * @brief Initialize with implicit conversion. 
+     *
+     * @param[in] from
+     * Input from.
+     *
+     * @param[in] to
+     * Input to.
+     */
+    template <typename Tinput_itr>
+    void init(
+            Tinput_itr from,
+            Tinput_itr to)
+    {
+        init(from, to, [](const auto& val) { return val; });
+    }
 
-        // Iterate boundary edges.
-        for (const edge_type& edge : boundary_edges_) {
+    /**
+     * @brief Initialize by incremental insertion in BRIO order.
+     *
+     * This shuffles the points, groups them into rounds of doubling
+     * size, and sorts each round along a Hilbert curve (biased
+     * randomized insertion order, or BRIO). It then inserts points
+     * one at a time, locating each by walking from the most recently
+     * created triangle, and re-triangulating the cavity of triangles
+     * whose circumcircles contain it. Points outside the convex hull
+     * are handled with ghost triangles connecting hull edges to a
+     * vertex at infinity. Each insertion costs expected constant
+     * time, independent of hull size, so this scales to millions of
+     * points, whereas `init()` does not.
+     *
+     * @param[in] from
+     * Input from.
+     *
+     * @param[in] to
+     * Input to.
+     *
+     * @param[in] func
+     * Function constructing an instance of `point_type` for each
+     * input element, as in `init()`.
+     *
+     * @post
+     * Same as `init()`. Exact duplicate points are ignored.
+     *
+     * @throw std::runtime_error
+     * If all points are collinear.
+     */
+    template <typename Tinput_itr, typename Tfunc>
+    void init_brio(
+            Tinput_itr from,
+            Tinput_itr to,
+            Tfunc&& func)
+    {
+        // Initialize points.
+        init_points(from, to, std::forward<Tfunc>(func));
 
-            // Associated edge triangles.
-            auto itr = edge_triangles_.find(edge);
-            assert(itr != edge_triangles_.end());
-            assert((itr->second.t1 == bad_index) !=
-                   (itr->second.t2 == bad_index));
+        // Triangulate.
+        init_brio_sequential();
+    }
 
-            // Force t1 to be valid triangle index.
-            if (itr->second.t1 == bad_index) {
-                std::swap(itr->second.t1, itr->second.t2);
-            }
+#if PREFORM_DELAUNAY_USE_THREADS || DOXYGEN
 
-            // Force boundary edge to be (a, b) in triangle.
-            triangle_type& triangle = triangles_[itr->second.t1];
-            if (triangle.a != edge.a ||
-                triangle.b != edge.b) {
-                triangle.swap_cyclical();
-                if (triangle.a != edge.a ||
-                    triangle.b != edge.b) {
-                    triangle.swap_cyclical();
-                }
-            }
-            assert(triangle.a == edge.a &&
-                   triangle.b == edge.b);
-        }
+    /**
+     * @brief Initialize by incremental insertion in BRIO order,
+     * divided and conquered in parallel.
+     *
+     * This partitions the points into rectangular cells by recursive
+     * median bisection, and triangulates each cell as in `init_brio()`
+     * concurrently on the thread pool. A triangle is certified if its
+     * circumcircle is strictly inside its cell, since no other cell
+     * can then have a point inside it. The vertices of all other
+     * triangles, and of each cell hull, are then triangulated together,
+     * and the triangles from this border triangulation filling the
+     * space between certified triangles stitch the cells together.
+     *
+     * Co-circular points, as in regular grids, are resolved by the
+     * same symbolic perturbation everywhere, so the border
+     * triangulation reproduces the edges around the certified
+     * triangles. If round-off ever makes it disagree, this falls back
+     * to the sequential algorithm. Either way, the result is the same
+     * as `init_brio()`, except that which of several exact duplicate
+     * points is kept is unspecified.
+     *
+     * @param[in] pool
+     * Thread pool.
+     *
+     * @param[in] from
+     * Input from.
+     *
+     * @param[in] to
+     * Input to.
+     *
+     * @param[in] func
+     * Function constructing an instance of `point_type` for each
+     * input element, as in `init()`.
+     *
+     * @throw std::runtime_error
+     * If all points are collinear.
+     */
+    template <typename Tinput_itr, typename Tfunc>
+    void init_brio(
+            thread_pool& pool,
+            Tinput_itr from,
+            Tinput_itr to,
+            Tfunc&& func)
+    {
+        // Initialize points.
+        init_points(from, to, std::forward<Tfunc>(func));
+
+        // Triangulate.
+        init_brio_parallel(pool);
     }
 
     /**
-     * @brief Initialize with implicit conversion. 
+     * @brief Initialize by incremental insertion in BRIO order,
+     * divided and conquered in parallel, with implicit conversion.
+     *
+     * @param[in] pool
+     * Thread pool.
      *
      * @param[in] from
      * Input from.
@@ -549,11 +677,32 @@ public:
      * Input to.
      */
     template <typename Tinput_itr>
-    void init(
+    void init_brio(
+            thread_pool& pool,
             Tinput_itr from,
             Tinput_itr to)
     {
-        init(from, to, [](const auto& val) { return val; });
+        init_brio(pool, from, to, [](const auto& val) { return val; });
+    }
+
+#endif // #if PREFORM_DELAUNAY_USE_THREADS || DOXYGEN
+
+    /**
+     * @brief Initialize by incremental insertion in BRIO order
+     * with implicit conversion.
+     *
+     * @param[in] from
+     * Input from.
+     *
+     * @param[in] to
+     * Input to.
+     */
+    template <typename Tinput_itr>
+    void init_brio(
+            Tinput_itr from,
+            Tinput_itr to)
+    {
+        init_brio(from, to, [](const auto& val) { return val; });
     }
 
     /**
@@ -707,91 +856,1155 @@ private:
     }
 
     /**
-     * @brief Add point.
+     * @brief In-circle determinant.
      *
-     * @param[in] p
-     * Index of point.
-     *
-     * @param[in] alloc1
-     * Arena allocator for temporary allocations.
+     * This is positive if the point with index @f$ p @f$ is inside
+     * the circumcircle of the counter-clockwise triangle with indices
+     * @f$ (a, b, c) @f$, negative if outside, and zero if on the
+     * circumcircle.
      *
-     * @param[in] alloc2
-     * Arena allocator for temporary allocations.
+     * @tparam Twhich_float
+     * Which float type to use, either `float_type` or `float_interval_type`.
      */
-    void add_point(
-                index_type p,
-                pre::memory_arena_allocator<char> alloc1,
-                pre::memory_arena_allocator<char> alloc2)
+    template <typename Twhich_float>
+    Twhich_float in_circle(
+                index_type a,
+                index_type b,
+                index_type c,
+                index_type p) const
     {
-        if (!pre::isfinite(points_[p]).all()) {
-            return; // Ignore.
-        }
-
-        {
-
-        // Boundary edges to remove.
-        std::vector<edge_type,
-        pre::memory_arena_allocator<edge_type>>
-                boundary_edges_to_remove(alloc1); // Use allocator 1.
-        boundary_edges_to_remove.reserve(
-        boundary_edges_.size() / 2);
-
-        // Boundary edges to add.
-        std::set<edge_type,
-        std::less<edge_type>,
-        pre::memory_arena_allocator<edge_type>>
-                boundary_edges_to_add(alloc1); // Use allocator 1.
-
-        // Iterate over boundary edges.
-        for (const edge_type& edge : boundary_edges_) {
-
-            // Is edge visible from point?
-            if (signed_area<float_interval_type>(
-                        p, edge.a, edge.b).upper_bound() < 0) {
+        static_assert(
+            std::is_same<Twhich_float, float_type>::value ||
+            std::is_same<Twhich_float, float_interval_type>::value,
+            "Invalid usage");
 
-                // Form (counterclockwise) triangle.
-                index_type t =
-                index_type(triangles_.size());
-                triangles_.push_back({p, edge.b, edge.a});
+        // Compute.
+        multi<Twhich_float, 2> pp = points_[p];
+        multi<Twhich_float, 2> va = multi<Twhich_float, 2>(points_[a]) - pp;
+        multi<Twhich_float, 2> vb = multi<Twhich_float, 2>(points_[b]) - pp;
+        multi<Twhich_float, 2> vc = multi<Twhich_float, 2>(points_[c]) - pp;
+        return dot(va, va) * cross(vb, vc) +
+               dot(vb, vb) * cross(vc, va) +
+               dot(vc, vc) * cross(va, vb);
+    }
 
-                // Form edges.
-                edge_type edge1 = {p, edge.a};
-                edge_type edge2 = {edge.b, p};
-                edge_triangles_[edge].push(t);
-                edge_triangles_[edge1].push(t);
-                edge_triangles_[edge2].push(t);
+    /**
+     * @brief Sign of signed area of parallelogram.
+     *
+     * This is exact, by `orient2d_sign()`, which evaluates in
+     * `float_type` with a forward error bound, and only falls back
+     * to exact arithmetic if the result is too close to zero to be
+     * certain.
+     *
+     * @returns
+     * Positive if @f$ (a, b, c) @f$ is counter-clockwise, negative
+     * if clockwise, and zero if collinear.
+     */
+    int signed_area_sign(
+                index_type a,
+                index_type b,
+                index_type c) const
+    {
+        return orient2d_sign(points_[a], points_[b], points_[c]);
+    }
 
-                // Remember boundary updates.
-                boundary_edges_to_remove.push_back(edge);
-                boundary_edges_to_add.insert(edge1.reverse());
-                boundary_edges_to_add.insert(edge2.reverse());
-            }
-        }
+    /**
+     * @brief Sign of in-circle determinant.
+     *
+     * This is exact, by `incircle_sign()`, which evaluates in
+     * `float_type` with a forward error bound, and only falls back
+     * to exact arithmetic if the result is too close to zero to be
+     * certain.
+     *
+     * @returns
+     * Positive if @f$ p @f$ is inside the circumcircle, negative
+     * if outside, and zero if co-circular.
+     */
+    int in_circle_sign(
+                index_type a,
+                index_type b,
+                index_type c,
+                index_type p) const
+    {
+        return incircle_sign(
+                points_[a], points_[b], points_[c], points_[p]);
+    }
 
-        // Remove boundary edges.
-        for (const edge_type& edge : boundary_edges_to_remove) {
-            boundary_edges_.erase(
-            boundary_edges_.find(edge));
+    /**
+     * @brief Sign of in-circle determinant, with ties broken by
+     * symbolic perturbation.
+     *
+     * If `in_circle_sign()` is zero, the points are co-circular, so
+     * this perturbs each point's lifting onto the
+     * paraboloid by an infinitesimal amount, larger for larger
+     * indices. The sign is then that of the derivative with respect
+     * to the most significant perturbation with a non-zero derivative,
+     * which is the signed area of the other three points. The result
+     * depends only on the four points and their indices, so every
+     * triangulation breaks ties the same way, regardless of insertion
+     * order.
+     */
+    int in_circle_perturbed_sign(
+                index_type a,
+                index_type b,
+                index_type c,
+                index_type p) const
+    {
+        int sign = in_circle_sign(a, b, c, p);
+        if (sign != 0) {
+            return sign;
         }
 
-        // Add boundary edges.
-        for (const edge_type& edge : boundary_edges_to_add) {
-            // Boundary edge to add ended up being an interior edge?
-            if (edge_triangles_[edge].is_full()) {
-                // Disregard.
-                continue;
+        // Derivatives with respect to lifting of a, b, c, and p.
+        std::pair<index_type, int> terms[4] = {
+            {a, 0}, {b, 1}, {c, 2}, {p, 3}
+        };
+        std::sort(
+                &terms[0], &terms[0] + 4,
+                [](const auto& lhs, const auto& rhs) {
+                    return lhs.first > rhs.first;
+                });
+        for (const auto& [q, k] : terms) {
+            (void) q;
+            switch (k) {
+                case 0: sign = +signed_area_sign(b, c, p); break;
+                case 1: sign = +signed_area_sign(c, a, p); break;
+                case 2: sign = +signed_area_sign(a, b, p); break;
+                default: sign = -signed_area_sign(a, b, c); break;
             }
-            else {
-                // Add.
-                boundary_edges_.insert(edge);
+            if (sign != 0) {
+                return sign;
             }
         }
+        return 0;
+    }
 
-        // Leave scope.
-        }
-
-        // Clear allocations.
-        alloc1.clear();
+    /**
+     * @brief Finish initialization.
+     *
+     * Makes triangles counter-clockwise, and then forces each boundary
+     * edge to be the first two vertex indices of its triangle.
+     */
+    void finish_init()
+    {
+        // Iterate triangles.
+        for (triangle_type& triangle : triangles_) {
+
+            // Triangle area negative?
+            if (pre::signbit(
+                signed_area<float_type>(
+                            triangle.a,
+                            triangle.b,
+                            triangle.c))) {
+                // Make counter-clockwise.
+                std::swap(
+                        triangle.b,
+                        triangle.c);
+            }
+        }
+
+        // Iterate boundary edges.
+        for (const edge_type& edge : boundary_edges_) {
+
+            // Associated edge triangles.
+            auto itr = edge_triangles_.find(edge);
+            assert(itr != edge_triangles_.end());
+            assert((itr->second.t1 == bad_index) !=
+                   (itr->second.t2 == bad_index));
+
+            // Force t1 to be valid triangle index.
+            if (itr->second.t1 == bad_index) {
+                std::swap(itr->second.t1, itr->second.t2);
+            }
+
+            // Force boundary edge to be (a, b) in triangle.
+            triangle_type& triangle = triangles_[itr->second.t1];
+            if (triangle.a != edge.a ||
+                triangle.b != edge.b) {
+                triangle.swap_cyclical();
+                if (triangle.a != edge.a ||
+                    triangle.b != edge.b) {
+                    triangle.swap_cyclical();
+                }
+            }
+            assert(triangle.a == edge.a &&
+                   triangle.b == edge.b);
+        }
+    }
+
+    /**
+     * @brief Ghost index, for the vertex at infinity.
+     */
+    static constexpr index_type ghost_index = -2;
+
+    /**
+     * @brief BRIO triangle.
+     *
+     * Vertices are counter-clockwise. The neighbor `n[k]` is
+     * across the edge from `v[k]` to `v[(k + 1) % 3]`. Ghost
+     * triangles have one vertex equal to `ghost_index`, with the
+     * other two forming a hull edge oriented clockwise.
+     */
+    struct brio_triangle
+    {
+        /**
+         * @brief Vertex indices.
+         */
+        index_type v[3];
+
+        /**
+         * @brief Neighbor triangle indices.
+         */
+        index_type n[3];
+    };
+
+    /**
+     * @brief BRIO boundary edge.
+     */
+    struct brio_edge
+    {
+        /**
+         * @brief Index of point @f$ a @f$.
+         */
+        index_type a;
+
+        /**
+         * @brief Index of point @f$ b @f$.
+         */
+        index_type b;
+
+        /**
+         * @brief Index of triangle outside cavity.
+         */
+        index_type t;
+    };
+
+    /**
+     * @brief BRIO state.
+     */
+    struct brio_state
+    {
+        /**
+         * @brief Triangles, including ghost and dead triangles.
+         */
+        std::vector<brio_triangle> mesh;
+
+        /**
+         * @brief Triangle marks, equal to stamp if in cavity.
+         */
+        std::vector<size_type> marks;
+
+        /**
+         * @brief Current stamp.
+         */
+        size_type stamp = 0;
+
+        /**
+         * @brief Most recently created triangle.
+         */
+        index_type last = 0;
+
+        /**
+         * @brief Walk edge counter.
+         */
+        size_type walk = 0;
+
+        /**
+         * @brief Cavity triangles.
+         */
+        std::vector<index_type> cavity;
+
+        /**
+         * @brief Cavity boundary edges.
+         */
+        std::vector<brio_edge> boundary;
+    };
+
+    /**
+     * @brief Hilbert curve index of 16-bit coordinates.
+     */
+    static std::uint32_t hilbert_index(std::uint32_t x, std::uint32_t y)
+    {
+        std::uint32_t d = 0;
+        for (std::uint32_t s = 1U << 15; s > 0; s >>= 1) {
+            std::uint32_t rx = (x & s) > 0;
+            std::uint32_t ry = (y & s) > 0;
+            d += s * s * ((3 * rx) ^ ry);
+            if (ry == 0) {
+                if (rx == 1) {
+                    x = 0xFFFFU - x;
+                    y = 0xFFFFU - y;
+                }
+                std::swap(x, y);
+            }
+        }
+        return d;
+    }
+
+    /**
+     * @brief Initialize points.
+     */
+    template <typename Tinput_itr, typename Tfunc>
+    void init_points(
+            Tinput_itr from,
+            Tinput_itr to,
+            Tfunc&& func)
+    {
+        clear();
+        points_.reserve(std::distance(from, to));
+        while (from != to) {
+            points_.emplace_back(std::forward<Tfunc>(func)(*from++));
+        }
+    }
+
+    /**
+     * @brief Indices of finite points.
+     */
+    std::vector<index_type> finite_indices() const
+    {
+        std::vector<index_type> indices;
+        indices.reserve(points_.size());
+        for (const point_type& point : points_) {
+            if (pre::isfinite(point).all()) {
+                indices.push_back(index_type(&point - &points_[0]));
+            }
+        }
+        return indices;
+    }
+
+    /**
+     * @brief BRIO order.
+     *
+     * @param[in] order
+     * Indices of finite points to order.
+     *
+     * @param[in] seed
+     * Shuffle seed.
+     */
+    std::vector<index_type> brio_order(
+            std::vector<index_type> order,
+            std::uint64_t seed) const
+    {
+        if (order.empty()) {
+            return order;
+        }
+
+        // Bounding box.
+        point_type box0 = points_[order[0]];
+        point_type box1 = points_[order[0]];
+        for (index_type p : order) {
+            box0 = pre::fmin(box0, points_[p]);
+            box1 = pre::fmax(box1, points_[p]);
+        }
+
+        // Shuffle.
+        pcg32 gen(seed);
+        std::shuffle(order.begin(), order.end(), gen);
+
+        // Hilbert keys.
+        point_type scale = box1 - box0;
+        for (float_type& value : scale) {
+            value = value > 0 ? float_type(65535) / value : 0;
+        }
+        std::vector<std::pair<std::uint32_t, index_type>> keys;
+        keys.reserve(order.size());
+        for (index_type p : order) {
+            multi<float_type, 2> q = (points_[p] - box0) * scale;
+            keys.emplace_back(
+                hilbert_index(
+                    std::uint32_t(pre::fmin(q[0], float_type(65535))),
+                    std::uint32_t(pre::fmin(q[1], float_type(65535)))),
+                p);
+        }
+
+        // Sort each round along Hilbert curve, where the last round
+        // is the second half, the round before is the second quarter,
+        // and so on.
+        size_type end = keys.size();
+        while (end > 0) {
+            size_type begin = end > 64 ? end / 2 : 0;
+            std::sort(
+                    keys.begin() + begin,
+                    keys.begin() + end);
+            end = begin;
+        }
+        for (size_type k = 0; k < keys.size(); k++) {
+            order[k] = keys[k].second;
+        }
+        return order;
+    }
+
+    /**
+     * @brief Triangulate points in order.
+     *
+     * @returns
+     * False if all points are collinear.
+     */
+    bool brio_build(brio_state& state, std::vector<index_type>& order) const
+    {
+        // Form initial triangle from first two distinct points and
+        // next non-collinear point.
+        if (order.empty()) {
+            return false;
+        }
+        size_type k1 = 1;
+        while (k1 < order.size() &&
+               (points_[order[k1]] == points_[order[0]]).all()) {
+            k1++;
+        }
+        size_type k2 = k1 + 1;
+        while (k2 < order.size() &&
+               signed_area_sign(order[0], order[k1], order[k2]) == 0) {
+            k2++;
+        }
+
+        // Failed to form initial triangle?
+        if (!(k2 < order.size())) {
+            return false;
+        }
+        std::swap(order[1], order[k1]);
+        std::swap(order[2], order[k2]);
+
+        // Initial triangle, counter-clockwise.
+        index_type a = order[0];
+        index_type b = order[1];
+        index_type c = order[2];
+        if (signed_area_sign(a, b, c) < 0) {
+            std::swap(b, c);
+        }
+
+        // Initial triangle and ghost triangles across each edge.
+        state.mesh.push_back({{a, b, c}, {1, 2, 3}});
+        state.mesh.push_back({{b, a, ghost_index}, {0, 3, 2}});
+        state.mesh.push_back({{c, b, ghost_index}, {0, 1, 3}});
+        state.mesh.push_back({{a, c, ghost_index}, {0, 2, 1}});
+        state.marks.resize(4);
+        state.last = 0;
+
+        // Insert remaining points.
+        for (size_type k = 3; k < order.size(); k++) {
+            brio_insert(state, order[k]);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Extract triangles, edge triangles, and boundary edges.
+     */
+    void brio_extract(const brio_state& state)
+    {
+        std::vector<index_type> mesh_to_triangle(
+                state.mesh.size(), bad_index);
+        triangles_.reserve(state.mesh.size() / 2 + 1);
+        for (const brio_triangle& triangle : state.mesh) {
+            if (triangle.v[0] == bad_index) {
+                continue; // Dead.
+            }
+            int k = brio_ghost(triangle);
+            if (k >= 0) {
+                boundary_edges_.insert(edge_type{
+                    triangle.v[(k + 2) % 3],
+                    triangle.v[(k + 1) % 3]
+                });
+            }
+            else {
+                mesh_to_triangle[&triangle - &state.mesh[0]] =
+                    index_type(triangles_.size());
+                triangles_.push_back({
+                    triangle.v[0],
+                    triangle.v[1],
+                    triangle.v[2]
+                });
+            }
+        }
+
+        // Map each edge once, from the triangle with the greater
+        // index, or from the only triangle if a boundary edge.
+        edge_triangles_.reserve(triangles_.size() * 3 / 2 + 3);
+        for (size_type t = 0; t < state.mesh.size(); t++) {
+            index_type t1 = mesh_to_triangle[t];
+            if (t1 == bad_index) {
+                continue;
+            }
+            const brio_triangle& triangle = state.mesh[t];
+            for (size_type k = 0; k < 3; k++) {
+                index_type t2 = mesh_to_triangle[triangle.n[k]];
+                if (t2 < t1) {
+                    edge_triangles_.emplace(
+                        edge_type{
+                            triangle.v[k],
+                            triangle.v[(k + 1) % 3]
+                        },
+                        edge_triangles_type{t1, t2});
+                }
+            }
+        }
+
+        // Finish.
+        finish_init();
+    }
+
+    /**
+     * @brief Initialize by incremental insertion in BRIO order,
+     * sequentially, given points.
+     */
+    void init_brio_sequential()
+    {
+        triangles_.clear();
+        edge_triangles_.clear();
+        boundary_edges_.clear();
+        std::vector<index_type> order = brio_order(finite_indices(), 0);
+        if (order.empty()) {
+            return;
+        }
+        brio_state state;
+        if (!brio_build(state, order)) {
+            throw std::runtime_error(__PRETTY_FUNCTION__);
+        }
+        brio_extract(state);
+    }
+
+#if PREFORM_DELAUNAY_USE_THREADS
+
+    /**
+     * @brief BRIO cell.
+     */
+    struct brio_cell
+    {
+        /**
+         * @brief Box minimum.
+         */
+        point_type box0;
+
+        /**
+         * @brief Box maximum.
+         */
+        point_type box1;
+
+        /**
+         * @brief Point indices.
+         */
+        std::vector<index_type> order;
+
+        /**
+         * @brief Triangulation.
+         */
+        brio_state state;
+
+        /**
+         * @brief Triangulated successfully?
+         */
+        bool success = false;
+
+        /**
+         * @brief Certified flags, for each mesh triangle.
+         */
+        std::vector<char> certified;
+    };
+
+    /**
+     * @brief Partition points into cells by median bisection.
+     */
+    void brio_partition(
+            std::vector<brio_cell>& cells,
+            std::vector<index_type> order,
+            point_type box0,
+            point_type box1,
+            size_type depth) const
+    {
+        if (depth == 0) {
+            cells.emplace_back();
+            cells.back().box0 = box0;
+            cells.back().box1 = box1;
+            cells.back().order = std::move(order);
+            return;
+        }
+
+        // Split the longer side of the points' extent at the median,
+        // with points on the split value going to the upper cell so
+        // that the cells do not overlap.
+        point_type extent0 = points_[order[0]];
+        point_type extent1 = points_[order[0]];
+        for (index_type p : order) {
+            extent0 = pre::fmin(extent0, points_[p]);
+            extent1 = pre::fmax(extent1, points_[p]);
+        }
+        size_type dim = (extent1 - extent0).argmax();
+        auto mid = order.begin() + order.size() / 2;
+        std::nth_element(
+                order.begin(), mid, order.end(),
+                [&](index_type p, index_type q) {
+                    return points_[p][dim] < points_[q][dim];
+                });
+        float_type split = points_[*mid][dim];
+        mid = std::partition(
+                order.begin(), order.end(),
+                [&](index_type p) {
+                    return points_[p][dim] < split;
+                });
+        std::vector<index_type> order0(order.begin(), mid);
+        std::vector<index_type> order1(mid, order.end());
+        order.clear();
+        order.shrink_to_fit();
+        point_type box_split0 = box0;
+        point_type box_split1 = box1;
+        box_split0[dim] = split;
+        box_split1[dim] = split;
+        brio_partition(cells, std::move(order0), box0, box_split1, depth - 1);
+        brio_partition(cells, std::move(order1), box_split0, box1, depth - 1);
+    }
+
+    /**
+     * @brief Is circumcircle of finite triangle strictly inside box,
+     * with margin?
+     */
+    bool brio_certify(
+            const brio_triangle& triangle,
+            const point_type& box0,
+            const point_type& box1) const
+    {
+        const point_type& pa = points_[triangle.v[0]];
+        point_type vb = points_[triangle.v[1]] - pa;
+        point_type vc = points_[triangle.v[2]] - pa;
+        float_type det = 2 * cross(vb, vc);
+        if (!(det > 0)) {
+            return false;
+        }
+        float_type lb = dot(vb, vb);
+        float_type lc = dot(vc, vc);
+        point_type u = {
+            (vc[1] * lb - vb[1] * lc) / det,
+            (vb[0] * lc - vc[0] * lb) / det
+        };
+        point_type center = pa + u;
+        float_type radius = pre::sqrt(dot(u, u)) * float_type(1.001) +
+            float_type(1e-3) * pre::sqrt(lb + lc);
+        return (center - radius > box0).all() &&
+               (center + radius < box1).all();
+    }
+
+    /**
+     * @brief Initialize by divide and conquer in parallel.
+     */
+    void init_brio_parallel(thread_pool& pool)
+    {
+        std::vector<index_type> order = finite_indices();
+
+        // Too few points?
+        if (order.size() <= parallel_cutoff / 4) {
+            init_brio_sequential();
+            return;
+        }
+
+        // Partition, into about 4 cells per thread, and no fewer than
+        // parallel_cutoff / 16 points per cell.
+        size_type depth = 1;
+        while ((size_type(1) << (depth + 1)) <= 4 * pool.size() &&
+               (order.size() >> (depth + 1)) >= parallel_cutoff / 16) {
+            depth++;
+        }
+        std::vector<brio_cell> cells;
+        point_type box0;
+        point_type box1;
+        box0.fill(-pre::numeric_limits<float_type>::infinity());
+        box1.fill(+pre::numeric_limits<float_type>::infinity());
+        brio_partition(cells, std::move(order), box0, box1, depth);
+
+        // Triangulate and certify cells in parallel.
+        pool.parallel_for(
+            size_type(0), cells.size(), size_type(1),
+            [&](size_type c) {
+                brio_cell& cell = cells[c];
+                cell.order = brio_order(std::move(cell.order), c + 1);
+                cell.success = brio_build(cell.state, cell.order);
+                if (!cell.success) {
+                    return;
+                }
+                const std::vector<brio_triangle>& mesh = cell.state.mesh;
+                cell.certified.resize(mesh.size());
+                for (size_type t = 0; t < mesh.size(); t++) {
+                    const brio_triangle& triangle = mesh[t];
+                    if (triangle.v[0] == bad_index ||
+                        brio_ghost(triangle) >= 0) {
+                        continue;
+                    }
+                    bool hull = false;
+                    for (index_type n : triangle.n) {
+                        hull = hull || brio_ghost(mesh[n]) >= 0;
+                    }
+                    cell.certified[t] = !hull &&
+                        brio_certify(triangle, cell.box0, cell.box1);
+                }
+            });
+
+        // Border points are the vertices of triangles which are not
+        // certified. Border edges separate certified triangles from
+        // triangles which are not, oriented as in the certified
+        // triangle.
+        std::vector<char> is_border(points_.size());
+        std::vector<index_type> border;
+        std::unordered_map<
+            edge_type,
+            std::pair<index_type, bool>, edge_hash> border_edges;
+        size_type certified_count = 0;
+        for (brio_cell& cell : cells) {
+            if (!cell.success) {
+                for (index_type p : cell.order) {
+                    if (!is_border[p]) {
+                        is_border[p] = 1;
+                        border.push_back(p);
+                    }
+                }
+                continue;
+            }
+            const std::vector<brio_triangle>& mesh = cell.state.mesh;
+            for (size_type t = 0; t < mesh.size(); t++) {
+                const brio_triangle& triangle = mesh[t];
+                if (triangle.v[0] == bad_index ||
+                    brio_ghost(triangle) >= 0) {
+                    continue;
+                }
+                if (!cell.certified[t]) {
+                    for (index_type p : triangle.v) {
+                        if (!is_border[p]) {
+                            is_border[p] = 1;
+                            border.push_back(p);
+                        }
+                    }
+                    continue;
+                }
+                certified_count++;
+                for (size_type k = 0; k < 3; k++) {
+                    if (!cell.certified[triangle.n[k]]) {
+                        border_edges.emplace(
+                            edge_type{
+                                triangle.v[k],
+                                triangle.v[(k + 1) % 3]
+                            },
+                            std::make_pair(triangle.v[k], false));
+                    }
+                }
+            }
+        }
+
+        // Nothing certified?
+        if (certified_count == 0) {
+            init_brio_sequential();
+            return;
+        }
+
+        // Triangulate border points.
+        brio_state border_state;
+        border = brio_order(std::move(border), 0);
+        if (!brio_build(border_state, border)) {
+            init_brio_sequential();
+            return;
+        }
+
+        // Find border edges in border triangulation, and seed with
+        // border triangulation triangles outside of them.
+        const std::vector<brio_triangle>& border_mesh = border_state.mesh;
+        std::vector<char> keep(border_mesh.size());
+        std::vector<index_type> stack;
+        for (size_type t = 0; t < border_mesh.size(); t++) {
+            const brio_triangle& triangle = border_mesh[t];
+            if (triangle.v[0] == bad_index ||
+                brio_ghost(triangle) >= 0) {
+                continue;
+            }
+            for (size_type k = 0; k < 3; k++) {
+                auto itr = border_edges.find(edge_type{
+                    triangle.v[k],
+                    triangle.v[(k + 1) % 3]
+                });
+                if (itr != border_edges.end()) {
+                    itr->second.second = true;
+                    if (itr->second.first != triangle.v[k] &&
+                        !keep[t]) {
+                        keep[t] = 1;
+                        stack.push_back(t);
+                    }
+                }
+            }
+        }
+        for (const auto& kv : border_edges) {
+            if (!kv.second.second) {
+                // Inconsistent, due to co-circular points.
+                init_brio_sequential();
+                return;
+            }
+        }
+
+        // Flood fill without crossing border edges.
+        while (!stack.empty()) {
+            index_type t = stack.back();
+            stack.pop_back();
+            const brio_triangle& triangle = border_mesh[t];
+            for (size_type k = 0; k < 3; k++) {
+                index_type n = triangle.n[k];
+                if (keep[n] ||
+                    brio_ghost(border_mesh[n]) >= 0 ||
+                    border_edges.find(edge_type{
+                        triangle.v[k],
+                        triangle.v[(k + 1) % 3]
+                    }) != border_edges.end()) {
+                    continue;
+                }
+                keep[n] = 1;
+                stack.push_back(n);
+            }
+        }
+
+        // Collect triangles.
+        for (const brio_cell& cell : cells) {
+            if (!cell.success) {
+                continue;
+            }
+            const std::vector<brio_triangle>& mesh = cell.state.mesh;
+            for (size_type t = 0; t < mesh.size(); t++) {
+                if (cell.certified[t]) {
+                    triangles_.push_back({
+                        mesh[t].v[0],
+                        mesh[t].v[1],
+                        mesh[t].v[2]
+                    });
+                }
+            }
+        }
+        for (size_type t = 0; t < border_mesh.size(); t++) {
+            if (keep[t]) {
+                triangles_.push_back({
+                    border_mesh[t].v[0],
+                    border_mesh[t].v[1],
+                    border_mesh[t].v[2]
+                });
+            }
+        }
+
+        // Map edges to triangles.
+        edge_triangles_.reserve(triangles_.size() * 3 / 2 + 3);
+        for (size_type t = 0; t < triangles_.size(); t++) {
+            const triangle_type& triangle = triangles_[t];
+            edge_triangles_[{triangle.a, triangle.b}].push(index_type(t));
+            edge_triangles_[{triangle.b, triangle.c}].push(index_type(t));
+            edge_triangles_[{triangle.c, triangle.a}].push(index_type(t));
+        }
+
+        // Boundary edges are those with only one triangle.
+        for (const triangle_type& triangle : triangles_) {
+            edge_type edges[3] = {
+                {triangle.a, triangle.b},
+                {triangle.b, triangle.c},
+                {triangle.c, triangle.a}
+            };
+            for (const edge_type& edge : edges) {
+                if (!edge_triangles_[edge].is_full()) {
+                    boundary_edges_.insert(edge);
+                }
+            }
+        }
+
+        // Finish.
+        finish_init();
+    }
+
+#endif // #if PREFORM_DELAUNAY_USE_THREADS
+
+    /**
+     * @brief Index of ghost vertex in triangle, or -1.
+     */
+    static int brio_ghost(const brio_triangle& triangle)
+    {
+        return triangle.v[0] == ghost_index ? 0 :
+               triangle.v[1] == ghost_index ? 1 :
+               triangle.v[2] == ghost_index ? 2 : -1;
+    }
+
+    /**
+     * @brief Is triangle in conflict with point?
+     *
+     * A finite triangle is in conflict if the point is inside its
+     * circumcircle, with ties broken by `in_circle_perturbed_sign()`.
+     * A ghost triangle is in conflict if
+     * the point is definitely outside its hull edge.
+     */
+    bool brio_conflict(const brio_triangle& triangle, index_type p) const
+    {
+        int k = brio_ghost(triangle);
+        if (k >= 0) {
+            return signed_area_sign(
+                        triangle.v[(k + 1) % 3],
+                        triangle.v[(k + 2) % 3], p) > 0;
+        }
+        else {
+            return in_circle_perturbed_sign(
+                        triangle.v[0],
+                        triangle.v[1],
+                        triangle.v[2], p) > 0;
+        }
+    }
+
+    /**
+     * @brief Locate point by visibility walk.
+     *
+     * @returns
+     * Index of finite triangle containing the point, or of
+     * ghost triangle whose hull edge the point is outside.
+     */
+    index_type brio_locate(brio_state& state, index_type p) const
+    {
+        index_type t = state.last;
+        int k = brio_ghost(state.mesh[t]);
+        if (k >= 0) {
+            // Start from finite triangle across hull edge.
+            t = state.mesh[t].n[(k + 1) % 3];
+        }
+        for (;;) {
+            const brio_triangle& triangle = state.mesh[t];
+            if (brio_ghost(triangle) >= 0) {
+                return t;
+            }
+
+            // Move across first edge the point is definitely
+            // outside of, starting from a different edge each
+            // step to avoid cycling.
+            bool moved = false;
+            state.walk++;
+            for (size_type j = 0; j < 3; j++) {
+                size_type i = (state.walk + j) % 3;
+                if (signed_area_sign(
+                            triangle.v[i],
+                            triangle.v[(i + 1) % 3], p) < 0) {
+                    t = triangle.n[i];
+                    moved = true;
+                    break;
+                }
+            }
+            if (!moved) {
+                return t;
+            }
+        }
+    }
+
+    /**
+     * @brief Insert point.
+     */
+    void brio_insert(brio_state& state, index_type p) const
+    {
+        std::vector<brio_triangle>& mesh = state.mesh;
+        std::vector<index_type>& cavity = state.cavity;
+        std::vector<brio_edge>& boundary = state.boundary;
+
+        // Locate.
+        index_type t0 = brio_locate(state, p);
+
+        // Ignore duplicates.
+        for (index_type v : mesh[t0].v) {
+            if (v != ghost_index &&
+                (points_[v] == points_[p]).all()) {
+                return;
+            }
+        }
+
+        // Grow cavity from located triangle through neighbors
+        // in conflict.
+        size_type stamp = ++state.stamp;
+        cavity.clear();
+        cavity.push_back(t0);
+        state.marks[t0] = stamp;
+        for (size_type i = 0; i < cavity.size(); i++) {
+            for (index_type t : mesh[cavity[i]].n) {
+                if (state.marks[t] != stamp &&
+                    brio_conflict(mesh[t], p)) {
+                    state.marks[t] = stamp;
+                    cavity.push_back(t);
+                }
+            }
+        }
+
+        // Find cavity boundary. If any finite boundary edge is not
+        // definitely visible from the point, due to round-off, grow
+        // the cavity across it so that it remains star-shaped.
+        for (;;) {
+            bool grown = false;
+            boundary.clear();
+            for (size_type i = 0; i < cavity.size(); i++) {
+                const brio_triangle& triangle = mesh[cavity[i]];
+                for (size_type k = 0; k < 3; k++) {
+                    index_type t = triangle.n[k];
+                    if (state.marks[t] == stamp) {
+                        continue;
+                    }
+                    index_type a = triangle.v[k];
+                    index_type b = triangle.v[(k + 1) % 3];
+                    if (a != ghost_index &&
+                        b != ghost_index &&
+                        !(signed_area_sign(a, b, p) > 0)) {
+                        state.marks[t] = stamp;
+                        cavity.push_back(t);
+                        grown = true;
+                    }
+                    else {
+                        boundary.push_back({a, b, t});
+                    }
+                }
+            }
+            if (!grown) {
+                break;
+            }
+        }
+
+        // Form new triangles, reusing cavity triangles first.
+        size_type first_new = mesh.size();
+        for (size_type i = 0; i < boundary.size(); i++) {
+            const brio_edge& edge = boundary[i];
+            index_type t;
+            if (i < cavity.size()) {
+                t = cavity[i];
+            }
+            else {
+                t = index_type(mesh.size());
+                mesh.emplace_back();
+                state.marks.push_back(0);
+            }
+            mesh[t] = {
+                {edge.a, edge.b, p},
+                {edge.t, bad_index, bad_index}
+            };
+
+            // Link outside triangle.
+            brio_triangle& outside = mesh[edge.t];
+            for (size_type k = 0; k < 3; k++) {
+                if (outside.v[k] == edge.b &&
+                    outside.v[(k + 1) % 3] == edge.a) {
+                    outside.n[k] = t;
+                    break;
+                }
+            }
+        }
+
+        // Kill leftover cavity triangles.
+        for (size_type i = boundary.size(); i < cavity.size(); i++) {
+            mesh[cavity[i]] = {
+                {bad_index, bad_index, bad_index},
+                {bad_index, bad_index, bad_index}
+            };
+        }
+
+        // Link new triangles to each other, where the triangle
+        // across (b, p) is the one whose boundary edge begins at b.
+        auto new_triangle = [&](size_type i) -> index_type {
+            return i < cavity.size() ?
+                cavity[i] : index_type(first_new + i - cavity.size());
+        };
+        for (size_type i = 0; i < boundary.size(); i++) {
+            index_type t = new_triangle(i);
+            for (size_type j = 0; j < boundary.size(); j++) {
+                if (boundary[j].a == boundary[i].b) {
+                    index_type u = new_triangle(j);
+                    mesh[t].n[1] = u;
+                    mesh[u].n[2] = t;
+                    break;
+                }
+            }
+        }
+
+        // Remember a finite new triangle to start the next walk.
+        state.last = new_triangle(0);
+        for (size_type i = 0; i < boundary.size(); i++) {
+            if (brio_ghost(mesh[new_triangle(i)]) < 0) {
+                state.last = new_triangle(i);
+                break;
+            }
+        }
+    }
+
+    /**
+     * @brief Add point.
+     *
+     * @param[in] p
+     * Index of point.
+     *
+     * @param[in] alloc1
+     * Arena allocator for temporary allocations.
+     *
+     * @param[in] alloc2
+     * Arena allocator for temporary allocations.
+     */
+    void add_point(
+                index_type p,
+                pre::memory_arena_allocator<char> alloc1,
+                pre::memory_arena_allocator<char> alloc2)
+    {
+        if (!pre::isfinite(points_[p]).all()) {
+            return; // Ignore.
+        }
+
+        {
+
+        // Boundary edges to remove.
+        std::vector<edge_type,
+        pre::memory_arena_allocator<edge_type>>
+                boundary_edges_to_remove(alloc1); // Use allocator 1.
+        boundary_edges_to_remove.reserve(
+        boundary_edges_.size() / 2);
+
+        // Boundary edges to add.
+        std::set<edge_type,
+        std::less<edge_type>,
+        pre::memory_arena_allocator<edge_type>>
+                boundary_edges_to_add(alloc1); // Use allocator 1.
+
+        // Iterate over boundary edges.
+        for (const edge_type& edge : boundary_edges_) {
+
+            // Is edge visible from point?
+            if (signed_area<float_interval_type>(
+                        p, edge.a, edge.b).upper_bound() < 0) {
+
+                // Form (counterclockwise) triangle.
+                index_type t =
+                index_type(triangles_.size());
+                triangles_.push_back({p, edge.b, edge.a});
+
+                // Form edges.
+                edge_type edge1 = {p, edge.a};
+                edge_type edge2 = {edge.b, p};
+                edge_triangles_[edge].push(t);
+                edge_triangles_[edge1].push(t);
+                edge_triangles_[edge2].push(t);
+
+                // Remember boundary updates.
+                boundary_edges_to_remove.push_back(edge);
+                boundary_edges_to_add.insert(edge1.reverse());
+                boundary_edges_to_add.insert(edge2.reverse());
+            }
+        }
+
+        // Remove boundary edges.
+        for (const edge_type& edge : boundary_edges_to_remove) {
+            boundary_edges_.erase(
+            boundary_edges_.find(edge));
+        }
+
+        // Add boundary edges.
+        for (const edge_type& edge : boundary_edges_to_add) {
+            // Boundary edge to add ended up being an interior edge?
+            if (edge_triangles_[edge].is_full()) {
+                // Disregard.
+                continue;
+            }
+            else {
+                // Add.
+                boundary_edges_.insert(edge);
+            }
+        }
+
+        // Leave scope.
+        }
+
+        // Clear allocations.
+        alloc1.clear();
 
         {
 
@@ -995,11 +2208,12 @@ private:
      * `std::pair<const edge_type, edge_triangles_type>`. For brevity, this is
      * not shown in the documentation type signature.
      */
-    std::map<
+    std::unordered_map<
         edge_type,
         edge_triangles_type,
 #if !DOXYGEN
-        std::less<edge_type>,
+        edge_hash,
+        std::equal_to<edge_type>,
         typename std::allocator_traits<Talloc>::
         template rebind_alloc<std::pair<
                  const edge_type, edge_triangles_type>>
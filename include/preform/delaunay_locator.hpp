@@ -0,0 +1,464 @@
+/* Copyright (c) 2018-20 M. Grady Saunders
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer.
+ *
+ *   2. Redistributions in binary form must reproduce the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer in the documentation and/or other materials
+ *      provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*+-+*/
+#if !DOXYGEN
+#if !(__cplusplus >= 201703L)
+#error "preform/delaunay_locator.hpp requires >=C++17"
+#endif // #if !(__cplusplus >= 201703L)
+#endif // #if !DOXYGEN
+#pragma once
+#ifndef PREFORM_DELAUNAY_LOCATOR_HPP
+#define PREFORM_DELAUNAY_LOCATOR_HPP
+
+// for std::min, std::max
+#include <algorithm>
+
+// for std::vector
+#include <vector>
+
+// for pre::delaunay_triangulation, PREFORM_DELAUNAY_USE_THREADS
+#include <preform/delaunay.hpp>
+
+// for pre::orient2d_sign
+#include <preform/exact_predicates.hpp>
+
+// for pre::multi
+#include <preform/multi.hpp>
+
+// for pre::multi wrappers
+#include <preform/multi_math.hpp>
+
+namespace pre {
+
+/**
+ * @addtogroup delaunay
+ */
+/**@{*/
+
+/**
+ * @brief Delaunay triangulation point locator.
+ *
+ * Point-location index over a finished `delaunay_triangulation`.
+ * This stores the neighbor of each triangle across each edge, and
+ * a uniform grid over the bounding box, with about one cell per two
+ * triangles, each of which remembers a triangle near its center.
+ * Queries walk from the grid triangle, or from a hint, towards the
+ * query point through neighbors, with exact orientation tests, so
+ * locating a point takes expected constant time.
+ *
+ * @note
+ * The triangulation must outlive the locator, and must not change
+ * while the locator is in use.
+ *
+ * @tparam Tfloat
+ * Float type.
+ *
+ * @tparam Talloc
+ * Allocator type of triangulation.
+ */
+template <
+    typename Tfloat,
+    typename Talloc = std::allocator<char>
+    >
+class delaunay_locator
+{
+public:
+
+    /**
+     * @brief Triangulation type.
+     */
+    typedef delaunay_triangulation<Tfloat, Talloc> triangulation_type;
+
+    /**
+     * @brief Float type.
+     */
+    typedef Tfloat float_type;
+
+    /**
+     * @brief Size type.
+     */
+    typedef std::size_t size_type;
+
+    /**
+     * @brief Index type.
+     */
+    typedef typename triangulation_type::index_type index_type;
+
+    /**
+     * @brief Point type.
+     */
+    typedef typename triangulation_type::point_type point_type;
+
+    /**
+     * @brief Bad index.
+     */
+    static constexpr index_type bad_index = triangulation_type::bad_index;
+
+    /**
+     * @brief Location.
+     */
+    struct location_type
+    {
+        /**
+         * @brief Index of containing triangle, or `bad_index` if
+         * outside convex hull.
+         */
+        index_type triangle = bad_index;
+
+        /**
+         * @brief Barycentric coordinates, with respect to vertices
+         * @f$ (a, b, c) @f$ of triangle.
+         */
+        multi<float_type, 3> bary = {};
+
+        /**
+         * @brief Found?
+         */
+        explicit operator bool() const noexcept
+        {
+            return triangle != bad_index;
+        }
+    };
+
+public:
+
+    /**
+     * @brief Default constructor.
+     */
+    delaunay_locator() = default;
+
+    /**
+     * @brief Constructor.
+     *
+     * @param[in] triangulation
+     * Finished triangulation.
+     */
+    delaunay_locator(const triangulation_type& triangulation)
+    {
+        init(triangulation);
+    }
+
+    /**
+     * @brief Initialize.
+     *
+     * @param[in] triangulation
+     * Finished triangulation.
+     */
+    void init(const triangulation_type& triangulation)
+    {
+        triangulation_ = &triangulation;
+        auto points = triangulation.points();
+        auto triangles = triangulation.triangles();
+        points_ = points.begin() == points.end() ? nullptr : &*points.begin();
+        triangles_.assign(triangles.begin(), triangles.end());
+
+        // Neighbors.
+        size_type count = triangles_.size();
+        neighbors_.assign(3 * count, bad_index);
+        for (size_type t = 0; t < count; t++)
+        for (size_type k = 0; k < 3; k++) {
+            auto [t1, t2] =
+                triangulation.edge_to_triangles({
+                    triangles_[t][k],
+                    triangles_[t][(k + 1) % 3]});
+            neighbors_[3 * t + k] = t1 == index_type(t) ? t2 : t1;
+        }
+
+        // Bounding box.
+        point_type lo(+pre::numeric_limits<float_type>::infinity());
+        point_type hi(-pre::numeric_limits<float_type>::infinity());
+        for (const point_type& p : points) {
+            lo = pre::min(lo, p);
+            hi = pre::max(hi, p);
+        }
+        if (count == 0) {
+            lo = hi = point_type();
+        }
+
+        // Grid counts, with about one cell per two triangles.
+        point_type ext = hi - lo;
+        for (int l = 0; l < 2; l++) {
+            if (!(ext[l] > 0)) {
+                ext[l] = 1;
+            }
+        }
+        float_type cells = std::max(float_type(count / 2), float_type(1));
+        grid_count_[0] = std::max(1, int(pre::sqrt(cells * ext[0] / ext[1])));
+        grid_count_[1] = std::max(1, int(cells / grid_count_[0]));
+        grid_count_[0] = std::min(grid_count_[0], int(cells));
+        grid_count_[1] = std::min(grid_count_[1], int(cells));
+        grid_lo_ = lo;
+        grid_scale_ = point_type(grid_count_) / ext;
+
+        // Grid triangles, by centroid.
+        grid_.assign(size_type(grid_count_.prod()), bad_index);
+        for (size_type t = 0; t < count; t++) {
+            point_type centroid =
+                (points_[triangles_[t].a] +
+                 points_[triangles_[t].b] +
+                 points_[triangles_[t].c]) / 3;
+            grid_[cell_(centroid)] = index_type(t);
+        }
+
+        // Fill empty cells from neighboring cells, along rows and
+        // then along columns.
+        for (int pass = 0; pass < 2; pass++) {
+            int major = pass == 0 ? grid_count_[0] : grid_count_[1];
+            int minor = pass == 0 ? grid_count_[1] : grid_count_[0];
+            auto at = [&](int i, int j) -> index_type& {
+                return pass == 0 ?
+                    grid_[size_type(i) * grid_count_[1] + j] :
+                    grid_[size_type(j) * grid_count_[1] + i];
+            };
+            for (int i = 0; i < major; i++) {
+                index_type prev = bad_index;
+                for (int j = 0; j < minor; j++) {
+                    if (at(i, j) == bad_index) {
+                        at(i, j) = prev;
+                    }
+                    prev = at(i, j);
+                }
+                for (int j = minor - 1; j >= 0; j--) {
+                    if (at(i, j) == bad_index) {
+                        at(i, j) = prev;
+                    }
+                    prev = at(i, j);
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Locate point.
+     *
+     * @param[in] p
+     * Point.
+     *
+     * @param[in] hint
+     * Index of triangle to start walking from, e.g., the previous
+     * location of a coherent query sequence. _Optional_. If
+     * `bad_index`, starts from the grid.
+     */
+    location_type locate(
+            const point_type& p,
+            index_type hint = bad_index) const
+    {
+        location_type loc;
+        if (triangles_.empty()) {
+            return loc;
+        }
+        index_type t = hint != bad_index ? hint : grid_[cell_(p)];
+        size_type walk = 0;
+        while (true) {
+
+            // Step through first edge with point strictly outside,
+            // starting at rotating edge to avoid cycles.
+            index_type next = t;
+            for (size_type j = 0; j < 3; j++) {
+                size_type k = (walk + j) % 3;
+                index_type a = triangles_[t][k];
+                index_type b = triangles_[t][(k + 1) % 3];
+                if (orient2d_sign(points_[a], points_[b], p) < 0) {
+                    next = neighbors_[3 * size_type(t) + k];
+                    break;
+                }
+            }
+            if (next == t) {
+                break;
+            }
+            if (next == bad_index) {
+                return loc; // Outside convex hull.
+            }
+            t = next;
+            walk++;
+        }
+
+        // Barycentric coordinates.
+        const point_type& pa = points_[triangles_[t].a];
+        const point_type& pb = points_[triangles_[t].b];
+        const point_type& pc = points_[triangles_[t].c];
+        multi<float_type, 3> bary = {
+            cross(pb - p, pc - p),
+            cross(pc - p, pa - p),
+            cross(pa - p, pb - p)
+        };
+        loc.triangle = t;
+        loc.bary = bary / bary.sum();
+        return loc;
+    }
+
+    /**
+     * @brief Locate points, serially.
+     *
+     * Each walk starts from the previous location, if any, so that
+     * coherent query sequences, e.g., scanlines, walk only a few
+     * triangles each.
+     *
+     * @param[in] p
+     * Points.
+     *
+     * @param[in] n
+     * Count.
+     *
+     * @param[out] loc
+     * Locations.
+     */
+    void locate(const point_type* p, size_type n, location_type* loc) const
+    {
+        locate_range_(p, 0, n, loc);
+    }
+
+#if PREFORM_DELAUNAY_USE_THREADS || DOXYGEN
+
+    /**
+     * @brief Locate points, in parallel.
+     *
+     * Same as serial `locate()`, with chunks of `grain` points split
+     * across `pool`. Each chunk walks from its own previous location.
+     */
+    void locate(
+            thread_pool& pool,
+            const point_type* p,
+            size_type n,
+            location_type* loc,
+            size_type grain = 1024) const
+    {
+        grain = std::max<size_type>(grain, 1);
+        size_type chunks = (n + grain - 1) / grain;
+        pool.parallel_for(
+                size_type(0), chunks, size_type(1),
+                [&](size_type chunk) {
+                    size_type from = chunk * grain;
+                    size_type to = std::min(from + grain, n);
+                    locate_range_(p, from, to, loc);
+                });
+    }
+
+#endif // #if PREFORM_DELAUNAY_USE_THREADS || DOXYGEN
+
+    /**
+     * @brief Neighbor of triangle across edge @f$ k @f$, from vertex
+     * @f$ k @f$ to vertex @f$ k + 1 @f$, or `bad_index` if boundary.
+     */
+    index_type neighbor(index_type t, int k) const
+    {
+        return neighbors_[3 * size_type(t) + size_type(k)];
+    }
+
+    /**
+     * @brief Triangulation.
+     */
+    const triangulation_type* triangulation() const noexcept
+    {
+        return triangulation_;
+    }
+
+private:
+
+    /**
+     * @brief Triangulation.
+     */
+    const triangulation_type* triangulation_ = nullptr;
+
+    /**
+     * @brief Points of triangulation.
+     */
+    const point_type* points_ = nullptr;
+
+    /**
+     * @brief Triangles, copied for contiguous indexing.
+     */
+    std::vector<typename triangulation_type::triangle_type> triangles_;
+
+    /**
+     * @brief Neighbors, 3 per triangle.
+     */
+    std::vector<index_type> neighbors_;
+
+    /**
+     * @brief Grid triangles.
+     */
+    std::vector<index_type> grid_;
+
+    /**
+     * @brief Grid counts.
+     */
+    multi<int, 2> grid_count_ = {};
+
+    /**
+     * @brief Grid lower bound.
+     */
+    point_type grid_lo_ = {};
+
+    /**
+     * @brief Grid cells per unit.
+     */
+    point_type grid_scale_ = {};
+
+#if !DOXYGEN
+
+    /**
+     * @brief Grid cell of point.
+     */
+    size_type cell_(const point_type& p) const
+    {
+        multi<int, 2> ind;
+        for (int l = 0; l < 2; l++) {
+            float_type u = (p[l] - grid_lo_[l]) * grid_scale_[l];
+            u = std::min(std::max(u, float_type(0)),
+                         float_type(grid_count_[l] - 1));
+            ind[l] = int(u);
+        }
+        return size_type(ind[0]) * size_type(grid_count_[1]) + ind[1];
+    }
+
+    /**
+     * @brief Locate range of points.
+     */
+    void locate_range_(
+            const point_type* p,
+            size_type from, size_type to,
+            location_type* loc) const
+    {
+        index_type hint = bad_index;
+        for (size_type k = from; k < to; k++) {
+            loc[k] = locate(p[k], hint);
+            if (loc[k]) {
+                hint = loc[k].triangle;
+            }
+        }
+    }
+
+#endif // #if !DOXYGEN
+};
+
+/**@}*/
+
+} // namespace pre
+
+#endif // #ifndef PREFORM_DELAUNAY_LOCATOR_HPP
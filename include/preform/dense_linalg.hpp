@@ -41,6 +41,7 @@
 #include <preform/math.hpp>
 #include <preform/dense_vector_view.hpp>
 #include <preform/dense_matrix_view.hpp>
+#include <preform/thread_pool.hpp>
 
 namespace pre {
 
@@ -382,6 +383,133 @@ public:
         }
     }
 
+public:
+
+    /**
+     * @name Matrix products
+     */
+    /**@{*/
+
+    /**
+     * @brief Matrix-vector product.
+     *
+     * @param[in] alpha
+     * Factor @f$ \alpha @f$.
+     *
+     * @param[in] a
+     * Matrix @f$ \mathbf{A} @f$.
+     *
+     * @param[in] x
+     * Vector @f$ \mathbf{x} @f$.
+     *
+     * @param[in] beta
+     * Factor @f$ \beta @f$.
+     *
+     * @param[inout] y
+     * Vector @f$ \mathbf{y} @f$.
+     *
+     * @par Expression
+     * @f[
+     *      \mathbf{y} \gets
+     *      \alpha \mathbf{A} \mathbf{x} + \beta \mathbf{y}
+     * @f]
+     *
+     * @throw std::invalid_argument
+     * Unless dimensions match.
+     *
+     * @note
+     * If @f$ \beta = 0 @f$, the implementation ignores the
+     * initial contents of `y`, as in BLAS. Views are read in place
+     * with their strides. Rows are dot products when `a` is
+     * row-major, and the columns are accumulated in blocks along
+     * the contiguous dimension otherwise.
+     */
+    static void gemv(
+                value_type alpha,
+                dense_matrix_view<const value_type*> a,
+                dense_vector_view<const value_type*> x,
+                value_type beta,
+                dense_vector_view<value_type*> y)
+    {
+        gemv_(nullptr, alpha, a, x, beta, y);
+    }
+
+    /**
+     * @brief Matrix-vector product, in parallel over rows.
+     */
+    static void gemv(
+                thread_pool& pool,
+                value_type alpha,
+                dense_matrix_view<const value_type*> a,
+                dense_vector_view<const value_type*> x,
+                value_type beta,
+                dense_vector_view<value_type*> y)
+    {
+        gemv_(&pool, alpha, a, x, beta, y);
+    }
+
+    /**
+     * @brief Matrix-matrix product.
+     *
+     * @param[in] alpha
+     * Factor @f$ \alpha @f$.
+     *
+     * @param[in] a
+     * Matrix @f$ \mathbf{A} @f$.
+     *
+     * @param[in] b
+     * Matrix @f$ \mathbf{B} @f$.
+     *
+     * @param[in] beta
+     * Factor @f$ \beta @f$.
+     *
+     * @param[inout] c
+     * Matrix @f$ \mathbf{C} @f$.
+     *
+     * @par Expression
+     * @f[
+     *      \mathbf{C} \gets
+     *      \alpha \mathbf{A} \mathbf{B} + \beta \mathbf{C}
+     * @f]
+     *
+     * @throw std::invalid_argument
+     * Unless dimensions match.
+     *
+     * @note
+     * If @f$ \beta = 0 @f$, the implementation ignores the initial
+     * contents of `c`, as in BLAS. Transposes are free through
+     * `dense_matrix_view::transpose()`. Small products run directly
+     * on the views. Larger products pack cache-sized panels
+     * of @f$ \mathbf{A} @f$ and @f$ \mathbf{B} @f$ into contiguous
+     * slivers for a register-blocked micro-kernel, so that any
+     * strides run at the same speed.
+     */
+    static void gemm(
+                value_type alpha,
+                dense_matrix_view<const value_type*> a,
+                dense_matrix_view<const value_type*> b,
+                value_type beta,
+                dense_matrix_view<value_type*> c)
+    {
+        gemm_(nullptr, alpha, a, b, beta, c);
+    }
+
+    /**
+     * @brief Matrix-matrix product, in parallel over blocks.
+     */
+    static void gemm(
+                thread_pool& pool,
+                value_type alpha,
+                dense_matrix_view<const value_type*> a,
+                dense_matrix_view<const value_type*> b,
+                value_type beta,
+                dense_matrix_view<value_type*> c)
+    {
+        gemm_(&pool, alpha, a, b, beta, c);
+    }
+
+    /**@}*/
+
 public:
 
     /**
@@ -558,6 +686,20 @@ public:
      */
     /**@{*/
 
+    /**
+     * @brief Block size of blocked factorizations.
+     *
+     * Factorizations eliminating more than two blocks of columns
+     * are blocked, such that most of the work happens in matrix
+     * products over cache-sized tiles of the trailing matrix. This
+     * does not apply to pivoted Cholesky decomposition, which must
+     * see every updated diagonal entry to choose the next pivot.
+     */
+    static constexpr int block_size()
+    {
+        return 32;
+    }
+
     /**
      * @brief QR-decomposition.
      *
@@ -572,38 +714,40 @@ public:
      * - `x` is empty,
      * - `q` is non-empty and `q.size0() != x.size0()`, or
      * - `q` is non-empty and `q.size1() != x.size0()`.
+     *
+     * @note
+     * If there are more than `2 * block_size()` columns to eliminate,
+     * the implementation accumulates Householder steps in blocks of
+     * `block_size()` reflectors in compact WY form,
+     * @f$ \mathbf{H}_{k+b-1} \cdots \mathbf{H}_{k} =
+     *     \mathbf{I} - \mathbf{V}\mathbf{T}^\dagger\mathbf{V}^\dagger @f$,
+     * and applies each block to the trailing matrix by matrix products.
      */
     static void qr(
                 dense_matrix_view<value_type*> x,
                 dense_matrix_view<value_type*> q = {})
     {
-        // Ensure valid.
-        if (x.empty()) {
-            throw std::invalid_argument(__PRETTY_FUNCTION__);
-        }
-
-        // Load identity.
-        if (!q.empty()) {
-            // Ensure square.
-            if (q.size0() != x.size0() ||
-                q.size1() != x.size0()) {
-                throw std::invalid_argument(__PRETTY_FUNCTION__);
-            }
-            for (int i = 0; i < x.size0(); i++)
-            for (int j = 0; j < x.size1(); j++) {
-                q[i][j] = value_type(float_type(i == j ? 1 : 0));
-            }
-        }
-
-        // Householder reduction.
-        for (int k = 0; k < x.diag().size() - 1; k++) {
-            hhstepl(k, k, x, q);
-        }
+        qr_(nullptr, x, q);
+    }
 
-        // Adjoint.
-        if (!q.empty()) {
-            adjoint({}, q);
-        }
+    /**
+     * @brief QR-decomposition, in parallel.
+     *
+     * @param[in] pool
+     * Thread pool, for blocked trailing-matrix updates.
+     *
+     * @param[inout] x
+     * Matrix @f$ \mathbf{X} \to \mathbf{R} @f$.
+     *
+     * @param[out] q
+     * Matrix @f$ \mathbf{Q} @f$. _Optional_.
+     */
+    static void qr(
+                thread_pool& pool,
+                dense_matrix_view<value_type*> x,
+                dense_matrix_view<value_type*> q = {})
+    {
+        qr_(&pool, x, q);
     }
 
     /**
@@ -622,9 +766,18 @@ public:
                 dense_matrix_view<value_type*> x,
                 dense_matrix_view<value_type*> q = {})
     {
-        // Delegate.
-        qr(x.block(x.size0(), x.size1(), 0, 0),
-           q.block(q.size0(), q.size1(), 0, 0));
+        ql_(nullptr, x, q);
+    }
+
+    /**
+     * @brief QL-decomposition, in parallel.
+     */
+    static void ql(
+                thread_pool& pool,
+                dense_matrix_view<value_type*> x,
+                dense_matrix_view<value_type*> q = {})
+    {
+        ql_(&pool, x, q);
     }
 
     /**
@@ -642,6 +795,751 @@ public:
     static void rq(
                 dense_matrix_view<value_type*> x,
                 dense_matrix_view<value_type*> q = {})
+    {
+        rq_(nullptr, x, q);
+    }
+
+    /**
+     * @brief RQ-decomposition, in parallel.
+     */
+    static void rq(
+                thread_pool& pool,
+                dense_matrix_view<value_type*> x,
+                dense_matrix_view<value_type*> q = {})
+    {
+        rq_(&pool, x, q);
+    }
+
+    /**
+     * @brief LQ-decomposition.
+     *
+     * @param[inout] x
+     * Matrix @f$ \mathbf{X} \to \mathbf{L} @f$.
+     *
+     * @param[out] q
+     * Matrix @f$ \mathbf{Q} @f$. _Optional_.
+     *
+     * @note
+     * This method calls `qr()` with the appropriate view transform.
+     */
+    static void lq(
+                dense_matrix_view<value_type*> x,
+                dense_matrix_view<value_type*> q = {})
+    {
+        lq_(nullptr, x, q);
+    }
+
+    /**
+     * @brief LQ-decomposition, in parallel.
+     */
+    static void lq(
+                thread_pool& pool,
+                dense_matrix_view<value_type*> x,
+                dense_matrix_view<value_type*> q = {})
+    {
+        lq_(&pool, x, q);
+    }
+
+    /**@}*/
+
+public:
+
+    /**
+     * @name Triangular-triangular decomposition
+     */
+    /**@{*/
+
+    /**
+     * @brief Cholesky decomposition.
+     *
+     * Decomposes Hermitian positive definite @f$ \mathbf{X} @f$ as
+     * @f$ \mathbf{X} = \mathbf{L}\mathbf{L}^\dagger @f$, where
+     * @f$ \mathbf{L} @f$ is lower triangular with positive diagonal.
+     * Only the lower triangle of @f$ \mathbf{X} @f$ is read, along
+     * with the real part of its diagonal, and the upper triangle is
+     * zeroed on output.
+     *
+     * With pivoting, decomposes Hermitian positive semi-definite
+     * @f$ \mathbf{X} @f$ as
+     * @f$ X_{[P_i,P_j]} = (\mathbf{L}\mathbf{L}^\dagger)_{[i,j]} @f$,
+     * choosing the largest remaining diagonal entry at each step.
+     * The decomposition stops once the remaining diagonal entries
+     * are at most @f$ n \varepsilon @f$ times the largest diagonal
+     * entry of the input, zeroing the trailing block, such that the
+     * number of nonzero columns of @f$ \mathbf{L} @f$ is the
+     * numerical rank.
+     *
+     * @param[inout] x
+     * Matrix @f$ \mathbf{X} \to \mathbf{L} @f$.
+     *
+     * @param[out] p
+     * Vector @f$ \mathbf{P} @f$. _Optional_. If non-empty, pivot.
+     *
+     * @throw std::invalid_argument
+     * If
+     * - `x` is empty,
+     * - `x` is not square, or
+     * - `p` is non-empty and `p.size() != x.size0()`.
+     *
+     * @throw std::runtime_error
+     * Unless positive definite, or positive semi-definite with
+     * pivoting.
+     *
+     * @note
+     * Without pivoting, if there are more than `2 * block_size()`
+     * rows, the implementation is right-looking and blocked:
+     * it factors each diagonal block, solves the panel below
+     * it, and updates the trailing lower triangle by matrix
+     * products.
+     */
+    static void chol(
+                dense_matrix_view<value_type*> x,
+                dense_vector_view<int*> p = {})
+    {
+        chol_(nullptr, x, p);
+    }
+
+    /**
+     * @brief Cholesky decomposition, in parallel.
+     *
+     * @param[in] pool
+     * Thread pool, for blocked panel and trailing-matrix updates.
+     *
+     * @param[inout] x
+     * Matrix @f$ \mathbf{X} \to \mathbf{L} @f$.
+     *
+     * @param[out] p
+     * Vector @f$ \mathbf{P} @f$. _Optional_.
+     */
+    static void chol(
+                thread_pool& pool,
+                dense_matrix_view<value_type*> x,
+                dense_vector_view<int*> p = {})
+    {
+        chol_(&pool, x, p);
+    }
+
+    /**@}*/
+
+private:
+
+    /**
+     * @brief Matrix-matrix product, implementation.
+     */
+    static void gemm_(
+                thread_pool* pool,
+                value_type alpha,
+                dense_matrix_view<const value_type*> a,
+                dense_matrix_view<const value_type*> b,
+                value_type beta,
+                dense_matrix_view<value_type*> c)
+    {
+        if (a.size0() != c.size0() ||
+            b.size1() != c.size1() ||
+            a.size1() != b.size0()) {
+            throw std::invalid_argument(__PRETTY_FUNCTION__);
+        }
+
+        // Scale by beta, or zero.
+        if (beta != value_type(float_type(1))) {
+            for (int i = 0; i < c.size0(); i++) {
+                value_type* itrc = c.begin_itr_ + c.begin_inc0_ * i;
+                for (int j = 0; j < c.size1(); j++) {
+                    value_type& cij = itrc[c.begin_inc1_ * j];
+                    cij = beta == value_type() ? value_type() : cij * beta;
+                }
+            }
+        }
+
+        // Delegate.
+        gemm_(pool, alpha, a, false, b, false, c);
+    }
+
+    /**
+     * @brief Matrix-vector product, implementation.
+     */
+    static void gemv_(
+                thread_pool* pool,
+                value_type alpha,
+                dense_matrix_view<const value_type*> a,
+                dense_vector_view<const value_type*> x,
+                value_type beta,
+                dense_vector_view<value_type*> y)
+    {
+        if (a.size0() != y.size() ||
+            a.size1() != x.size()) {
+            throw std::invalid_argument(__PRETTY_FUNCTION__);
+        }
+
+        // Row block size, and column block size.
+        constexpr int block0 = 64;
+        constexpr int block1 = 256;
+        const int m = int(a.size0());
+        const int n = int(a.size1());
+
+        // Update row block.
+        auto block_func = [&](int t) {
+            int i0 = t * block0;
+            int i1 = std::min(i0 + block0, m);
+            value_type tmp[block0];
+            if (a.begin_inc1_ == 1 || a.begin_inc0_ != 1) {
+                // Row dot products.
+                for (int i = i0; i < i1; i++) {
+                    const value_type* itra =
+                        a.begin_itr_ + a.begin_inc0_ * i;
+                    value_type sum = {};
+                    for (int j = 0; j < n; j++) {
+                        sum += itra[a.begin_inc1_ * j] *
+                               x.begin_itr_[x.begin_inc_ * j];
+                    }
+                    tmp[i - i0] = sum;
+                }
+            }
+            else {
+                // Column-major, accumulate columns.
+                std::fill(tmp, tmp + (i1 - i0), value_type());
+                for (int j0 = 0; j0 < n; j0 += block1)
+                for (int j = j0; j < std::min(j0 + block1, n); j++) {
+                    const value_type* itra =
+                        a.begin_itr_ + a.begin_inc1_ * j + i0;
+                    value_type xj = x.begin_itr_[x.begin_inc_ * j];
+                    for (int i = 0; i < i1 - i0; i++) {
+                        tmp[i] += itra[i] * xj;
+                    }
+                }
+            }
+            for (int i = i0; i < i1; i++) {
+                value_type& yi = y.begin_itr_[y.begin_inc_ * i];
+                yi = beta == value_type() ?
+                     alpha * tmp[i - i0] :
+                     alpha * tmp[i - i0] + beta * yi;
+            }
+        };
+
+        // Delegate.
+        int nblocks = (m + block0 - 1) / block0;
+        if (pool && nblocks > 1) {
+            pool->parallel_for(0, nblocks, 1, block_func);
+        }
+        else {
+            for (int t = 0; t < nblocks; t++) {
+                block_func(t);
+            }
+        }
+    }
+
+    /**
+     * @brief Matrix product update.
+     *
+     * @f$ \mathbf{C} \gets \mathbf{C} + \alpha \mathbf{A} \mathbf{B} @f$,
+     * conjugating the entries of @f$ \mathbf{A} @f$ if `conja` and the
+     * entries of @f$ \mathbf{B} @f$ if `conjb`. Dispatches to
+     * `gemm_direct_()` for small products, and to `gemm_packed_()`
+     * otherwise.
+     *
+     * @throw std::invalid_argument
+     * Unless dimensions match.
+     */
+    static void gemm_(
+                thread_pool* pool,
+                value_type alpha,
+                dense_matrix_view<const value_type*> a, bool conja,
+                dense_matrix_view<const value_type*> b, bool conjb,
+                dense_matrix_view<value_type*> c)
+    {
+        if (a.size0() != c.size0() ||
+            b.size1() != c.size1() ||
+            a.size1() != b.size0()) {
+            throw std::invalid_argument(__PRETTY_FUNCTION__);
+        }
+        if (c.empty() || a.size1() == 0) {
+            return;
+        }
+
+        // Small enough that packing does not pay off?
+        if (c.size0() < 16 ||
+            c.size1() < 16 ||
+            a.size1() < 16) {
+            gemm_direct_(pool, alpha, a, conja, b, conjb, c);
+        }
+        else {
+            gemm_packed_(pool, alpha, a, conja, b, conjb, c);
+        }
+    }
+
+    /**
+     * @brief Matrix product update, direct implementation.
+     *
+     * Reads the views in place. The loops run over tiles of
+     * @f$ \mathbf{C} @f$ and @f$ \mathbf{B} @f$ small enough to stay
+     * in cache, and the innermost loop runs along rows, such that
+     * it vectorizes for row-major views. If `pool` is non-null,
+     * column tiles of @f$ \mathbf{C} @f$ run in parallel.
+     */
+    static void gemm_direct_(
+                thread_pool* pool,
+                value_type alpha,
+                dense_matrix_view<const value_type*> a, bool conja,
+                dense_matrix_view<const value_type*> b, bool conjb,
+                dense_matrix_view<value_type*> c)
+    {
+        // Tile sizes.
+        constexpr int tile0 = 64;
+        constexpr int tile1 = 128;
+        constexpr int tilel = 128;
+        const int m = int(c.size0());
+        const int n = int(c.size1());
+        const int l = int(a.size1());
+
+        // Update column tile.
+        auto tile_func = [&](int t) {
+            int j0 = t * tile1;
+            int j1 = std::min(j0 + tile1, n);
+            for (int p0 = 0; p0 < l; p0 += tilel)
+            for (int i0 = 0; i0 < m; i0 += tile0) {
+                int p1 = std::min(p0 + tilel, l);
+                int i1 = std::min(i0 + tile0, m);
+                for (int i = i0; i < i1; i++)
+                for (int p = p0; p < p1; p++) {
+                    value_type fac =
+                        a.begin_itr_[a.begin_inc0_ * i + a.begin_inc1_ * p];
+                    if (conja) {
+                        fac = pre::conj(fac);
+                    }
+                    fac *= alpha;
+                    value_type* itrc =
+                        c.begin_itr_ + c.begin_inc0_ * i;
+                    const value_type* itrb =
+                        b.begin_itr_ + b.begin_inc0_ * p;
+                    if (c.begin_inc1_ == 1 &&
+                        b.begin_inc1_ == 1) {
+                        // Contiguous.
+                        if (conjb) {
+                            for (int j = j0; j < j1; j++) {
+                                itrc[j] += fac * pre::conj(itrb[j]);
+                            }
+                        }
+                        else {
+                            for (int j = j0; j < j1; j++) {
+                                itrc[j] += fac * itrb[j];
+                            }
+                        }
+                    }
+                    else {
+                        for (int j = j0; j < j1; j++) {
+                            value_type tmp = itrb[b.begin_inc1_ * j];
+                            if (conjb) {
+                                tmp = pre::conj(tmp);
+                            }
+                            itrc[c.begin_inc1_ * j] += fac * tmp;
+                        }
+                    }
+                }
+            }
+        };
+
+        // Delegate.
+        int ntiles = (n + tile1 - 1) / tile1;
+        if (pool && ntiles > 1) {
+            pool->parallel_for(0, ntiles, 1, tile_func);
+        }
+        else {
+            for (int t = 0; t < ntiles; t++) {
+                tile_func(t);
+            }
+        }
+    }
+
+    /**
+     * @brief Micro-kernel rows.
+     */
+    static constexpr int gemm_mr_()
+    {
+        return 4;
+    }
+
+    /**
+     * @brief Micro-kernel columns, one or two vector registers.
+     */
+    static constexpr int gemm_nr_()
+    {
+        return sizeof(value_type) > 8 ? 4 : int(64 / sizeof(value_type));
+    }
+
+    /**
+     * @brief Pack block of @f$ \mathbf{A} @f$ into slivers of
+     * `gemm_mr_()` rows, interleaved by column and zero-padded.
+     */
+    static void gemm_pack_a_(
+                dense_matrix_view<const value_type*> a, bool conja,
+                value_type* pack)
+    {
+        constexpr int mr = gemm_mr_();
+        const int mc = int(a.size0());
+        const int kc = int(a.size1());
+        for (int ir = 0; ir < mc; ir += mr)
+        for (int p = 0; p < kc; p++)
+        for (int i = ir; i < ir + mr; i++, pack++) {
+            if (i < mc) {
+                value_type tmp =
+                    a.begin_itr_[a.begin_inc0_ * i + a.begin_inc1_ * p];
+                *pack = conja ? pre::conj(tmp) : tmp;
+            }
+            else {
+                *pack = value_type();
+            }
+        }
+    }
+
+    /**
+     * @brief Pack block of @f$ \mathbf{B} @f$ into slivers of
+     * `gemm_nr_()` columns, interleaved by row and zero-padded.
+     */
+    static void gemm_pack_b_(
+                dense_matrix_view<const value_type*> b, bool conjb,
+                value_type* pack)
+    {
+        constexpr int nr = gemm_nr_();
+        const int kc = int(b.size0());
+        const int nc = int(b.size1());
+        for (int jr = 0; jr < nc; jr += nr)
+        for (int p = 0; p < kc; p++) {
+            const value_type* itrb = b.begin_itr_ + b.begin_inc0_ * p;
+            for (int j = jr; j < jr + nr; j++, pack++) {
+                if (j < nc) {
+                    value_type tmp = itrb[b.begin_inc1_ * j];
+                    *pack = conjb ? pre::conj(tmp) : tmp;
+                }
+                else {
+                    *pack = value_type();
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Micro-kernel.
+     *
+     * Accumulates the `gemm_mr_()` by `gemm_nr_()` product of
+     * packed slivers in local variables, which the compiler keeps
+     * in vector registers, then adds the valid `mr` by `nr` corner
+     * to @f$ \mathbf{C} @f$, scaled by @f$ \alpha @f$.
+     */
+    static void gemm_kernel_(
+                int kc,
+                const value_type* __restrict packa,
+                const value_type* __restrict packb,
+                value_type alpha,
+                int mr,
+                int nr,
+                value_type* itrc,
+                std::ptrdiff_t inc0,
+                std::ptrdiff_t inc1)
+    {
+        constexpr int kmr = gemm_mr_();
+        constexpr int knr = gemm_nr_();
+        value_type acc[kmr][knr] = {};
+        for (int p = 0; p < kc; p++, packa += kmr, packb += knr) {
+            for (int i = 0; i < kmr; i++)
+            for (int j = 0; j < knr; j++) {
+                acc[i][j] += packa[i] * packb[j];
+            }
+        }
+        for (int i = 0; i < mr; i++)
+        for (int j = 0; j < nr; j++) {
+            itrc[inc0 * i + inc1 * j] += alpha * acc[i][j];
+        }
+    }
+
+    /**
+     * @brief Matrix product update, packed implementation.
+     *
+     * Loops over blocks of @f$ \mathbf{C} @f$ sized for the
+     * cache hierarchy. For each block and each slab of the inner
+     * dimension, packs the corresponding blocks of @f$ \mathbf{A} @f$
+     * and @f$ \mathbf{B} @f$ into thread-local buffers, then sweeps
+     * the micro-kernel over the block. If `pool` is non-null,
+     * the blocks of @f$ \mathbf{C} @f$ run in parallel.
+     */
+    static void gemm_packed_(
+                thread_pool* pool,
+                value_type alpha,
+                dense_matrix_view<const value_type*> a, bool conja,
+                dense_matrix_view<const value_type*> b, bool conjb,
+                dense_matrix_view<value_type*> c)
+    {
+        // Block sizes.
+        constexpr int mr = gemm_mr_();
+        constexpr int nr = gemm_nr_();
+        constexpr int mc = 32 * mr;
+        constexpr int nc = 16 * nr;
+        constexpr int kc = 256;
+        const int m = int(c.size0());
+        const int n = int(c.size1());
+        const int l = int(a.size1());
+        const int mblocks = (m + mc - 1) / mc;
+        const int nblocks = (n + nc - 1) / nc;
+
+        // Update block.
+        auto block_func = [&](int t) {
+            // Packing buffers.
+            static thread_local std::vector<value_type> packbufa;
+            static thread_local std::vector<value_type> packbufb;
+            packbufa.resize(std::size_t(mc) * kc);
+            packbufb.resize(std::size_t(nc) * kc);
+            int i0 = (t % mblocks) * mc;
+            int j0 = (t / mblocks) * nc;
+            int i1 = std::min(i0 + mc, m);
+            int j1 = std::min(j0 + nc, n);
+            for (int p0 = 0; p0 < l; p0 += kc) {
+                int p1 = std::min(p0 + kc, l);
+                gemm_pack_a_(a.block(i0, p0, i1, p1), conja, &packbufa[0]);
+                gemm_pack_b_(b.block(p0, j0, p1, j1), conjb, &packbufb[0]);
+                for (int jr = j0; jr < j1; jr += nr)
+                for (int ir = i0; ir < i1; ir += mr) {
+                    gemm_kernel_(
+                        p1 - p0,
+                        &packbufa[std::size_t(ir - i0) * (p1 - p0)],
+                        &packbufb[std::size_t(jr - j0) * (p1 - p0)],
+                        alpha,
+                        std::min(mr, i1 - ir),
+                        std::min(nr, j1 - jr),
+                        c.begin_itr_ +
+                        c.begin_inc0_ * ir +
+                        c.begin_inc1_ * jr,
+                        c.begin_inc0_,
+                        c.begin_inc1_);
+                }
+            }
+        };
+
+        // Delegate.
+        int nblocks_total = mblocks * nblocks;
+        if (pool && nblocks_total > 1) {
+            pool->parallel_for(0, nblocks_total, 1, block_func);
+        }
+        else {
+            for (int t = 0; t < nblocks_total; t++) {
+                block_func(t);
+            }
+        }
+    }
+
+    /**
+     * @brief Apply compact WY block reflector.
+     *
+     * @f$ \mathbf{C} \gets
+     *     (\mathbf{I} - \mathbf{V}\mathbf{T}^\dagger\mathbf{V}^\dagger)
+     *      \mathbf{C} @f$.
+     */
+    static void hhapply_(
+                thread_pool* pool,
+                dense_matrix_view<value_type*> v,
+                dense_matrix_view<value_type*> t,
+                dense_matrix_view<value_type*> c)
+    {
+        // Temporary buffer.
+        static thread_local std::vector<value_type> tmpbuf;
+        tmpbuf.assign(std::size_t(v.size1() * c.size1()), value_type());
+        const int b = int(v.size1());
+        const int n = int(c.size1());
+        dense_matrix_view<value_type*> w = {
+            &tmpbuf[0],
+            n, 1,
+            b, n
+        };
+
+        // Product W = V^H C.
+        gemm_(pool, value_type(float_type(1)),
+              v.transpose(), true, c, false, w);
+
+        // Product W = T^H W, in-place, bottom to top.
+        for (int i = b - 1; i >= 0; i--) {
+            value_type* itrwi = &tmpbuf[std::size_t(i) * n];
+            value_type tii = pre::conj(t[i][i]);
+            for (int j = 0; j < n; j++) {
+                itrwi[j] *= tii;
+            }
+            for (int k = 0; k < i; k++) {
+                value_type* itrwk = &tmpbuf[std::size_t(k) * n];
+                value_type tki = pre::conj(t[k][i]);
+                for (int j = 0; j < n; j++) {
+                    itrwi[j] += tki * itrwk[j];
+                }
+            }
+        }
+
+        // Product C = C - V W.
+        gemm_(pool, value_type(float_type(-1)), v, false, w, false, c);
+    }
+
+    /**
+     * @brief Blocked Householder steps.
+     *
+     * Equivalent to `hhstepl(j, j, x, y)` for @f$ j \in [k, k + b) @f$.
+     * The panel applies each step to its own columns, collecting
+     * the reflectors and the triangular factor of the compact WY
+     * form. Then `hhapply_()` updates the trailing columns of `x` and
+     * the rows of `y` at once.
+     */
+    static void hhblock_(
+                thread_pool* pool,
+                int k,
+                int b,
+                dense_matrix_view<value_type*> x,
+                dense_matrix_view<value_type*> y)
+    {
+        // Temporary buffers.
+        static thread_local std::vector<value_type> tmpbufv;
+        static thread_local std::vector<value_type> tmpbuft;
+        const int m = int(x.size0());
+        const int mk = m - k;
+        tmpbufv.assign(std::size_t(mk) * b, value_type());
+        tmpbuft.assign(std::size_t(b) * b, value_type());
+
+        // Reflectors, contiguous columns.
+        dense_matrix_view<value_type*> v = {
+            &tmpbufv[0],
+            1, mk,
+            mk, b
+        };
+
+        // Triangular factor.
+        dense_matrix_view<value_type*> t = {
+            &tmpbuft[0],
+            b, 1,
+            b, b
+        };
+
+        for (int j = 0; j < b; j++) {
+
+            // Copy column, as in hhstepl().
+            int p = k + j;
+            dense_vector_view<value_type*> w = v.col(j).range(j, mk);
+            std::copy(
+                x.col(p).range(p, m).begin(),
+                x.col(p).range(p, m).end(),
+                w.begin());
+
+            // Compute reflector.
+            value_type alpha = pre::sign(w[0]) * length(w);
+            w[0] += alpha;
+
+            // Normalize.
+            normalize(w);
+
+            // Reflect column.
+            x[p][p] = -alpha;
+            std::fill(
+                x.col(p).range(p + 1, m).begin(),
+                x.col(p).range(p + 1, m).end(),
+                value_type());
+
+            // Reflect remaining panel columns.
+            for (int q = p + 1; q < k + b; q++) {
+                reflect(w, x.col(q).range(p, m));
+            }
+
+            // Triangular factor column, T[0:j,j] = -2 T[0:j,0:j] V^H w.
+            for (int i = 0; i < j; i++) {
+                t[i][j] = dot_conj(v.col(i).range(j, mk), w);
+            }
+            for (int i = 0; i < j; i++) {
+                value_type tmp = {};
+                for (int q = i; q < j; q++) {
+                    tmp += t[i][q] * t[q][j];
+                }
+                t[i][j] = float_type(-2) * tmp;
+            }
+            t[j][j] = float_type(2);
+        }
+
+        // Update trailing columns.
+        if (k + b < x.size1()) {
+            hhapply_(pool, v, t, x.block(k, k + b, m, x.size1()));
+        }
+
+        // Accumulate.
+        if (!y.empty()) {
+
+            // Sanity check.
+            if (x.size0() != y.size0()) {
+                throw std::invalid_argument(__PRETTY_FUNCTION__);
+            }
+
+            hhapply_(pool, v, t, y.block(k, 0, m, y.size1()));
+        }
+    }
+
+    /**
+     * @brief QR-decomposition, implementation.
+     */
+    static void qr_(
+                thread_pool* pool,
+                dense_matrix_view<value_type*> x,
+                dense_matrix_view<value_type*> q)
+    {
+        // Ensure valid.
+        if (x.empty()) {
+            throw std::invalid_argument(__PRETTY_FUNCTION__);
+        }
+
+        // Load identity.
+        if (!q.empty()) {
+            // Ensure square.
+            if (q.size0() != x.size0() ||
+                q.size1() != x.size0()) {
+                throw std::invalid_argument(__PRETTY_FUNCTION__);
+            }
+            for (int i = 0; i < q.size0(); i++)
+            for (int j = 0; j < q.size1(); j++) {
+                q[i][j] = value_type(float_type(i == j ? 1 : 0));
+            }
+        }
+
+        // Columns to eliminate.
+        int kcount = int(std::min(x.size0() - 1, x.size1()));
+        int k = 0;
+
+        // Blocked Householder reduction.
+        if (kcount > 2 * block_size()) {
+            for (; k < kcount; k += block_size()) {
+                hhblock_(pool, k, std::min(block_size(), kcount - k), x, q);
+            }
+        }
+
+        // Householder reduction.
+        for (; k < kcount; k++) {
+            hhstepl(k, k, x, q);
+        }
+
+        // Adjoint.
+        if (!q.empty()) {
+            adjoint({}, q);
+        }
+    }
+
+    /**
+     * @brief QL-decomposition, implementation.
+     */
+    static void ql_(
+                thread_pool* pool,
+                dense_matrix_view<value_type*> x,
+                dense_matrix_view<value_type*> q)
+    {
+        // Delegate.
+        qr_(pool,
+            x.block(x.size0(), x.size1(), 0, 0),
+            q.block(q.size0(), q.size1(), 0, 0));
+    }
+
+    /**
+     * @brief RQ-decomposition, implementation.
+     */
+    static void rq_(
+                thread_pool* pool,
+                dense_matrix_view<value_type*> x,
+                dense_matrix_view<value_type*> q)
     {
         // Conjugate.
         for (int i = 0; i < x.size0(); i++)
@@ -654,8 +1552,9 @@ public:
         }
 
         // Delegate.
-        qr(x.block(x.size0(), x.size1(), 0, 0).transpose(),
-           q.block(q.size0(), q.size1(), 0, 0).transpose());
+        qr_(pool,
+            x.block(x.size0(), x.size1(), 0, 0).transpose(),
+            q.block(q.size0(), q.size1(), 0, 0).transpose());
 
         // Conjugate.
         for (int i = 0; i < x.size0(); i++)
@@ -669,20 +1568,12 @@ public:
     }
 
     /**
-     * @brief LQ-decomposition.
-     *
-     * @param[inout] x
-     * Matrix @f$ \mathbf{X} \to \mathbf{L} @f$.
-     *
-     * @param[out] q
-     * Matrix @f$ \mathbf{Q} @f$. _Optional_.
-     *
-     * @note
-     * This method calls `qr()` with the appropriate view transform.
+     * @brief LQ-decomposition, implementation.
      */
-    static void lq(
+    static void lq_(
+                thread_pool* pool,
                 dense_matrix_view<value_type*> x,
-                dense_matrix_view<value_type*> q = {})
+                dense_matrix_view<value_type*> q)
     {
         // Conjugate.
         for (int i = 0; i < x.size0(); i++)
@@ -695,8 +1586,9 @@ public:
         }
 
         // Delegate.
-        qr(x.transpose(),
-           q.transpose());
+        qr_(pool,
+            x.transpose(),
+            q.transpose());
 
         // Conjugate.
         for (int i = 0; i < x.size0(); i++)
@@ -709,28 +1601,13 @@ public:
         }
     }
 
-    /**@}*/
-
-public:
-
     /**
-     * @name Triangular-triangular decomposition
+     * @brief Cholesky decomposition, implementation.
      */
-    /**@{*/
-
-    // TODO Doc
-    /**
-     * @brief Cholesky decomposition.
-     *
-     * @param[inout] x
-     * Matrix @f$ \mathbf{X} \to \mathbf{L} @f$.
-     *
-     * @param[out] p
-     * Vector @f$ \mathbf{P} @f$. _Optional_.
-     */
-    static void chol(
+    static void chol_(
+                thread_pool* pool,
                 dense_matrix_view<value_type*> x,
-                dense_vector_view<int*> p = {})
+                dense_vector_view<int*> p)
     {
         // Ensure valid.
         if (x.empty() ||
@@ -738,7 +1615,14 @@ public:
             throw std::invalid_argument(__PRETTY_FUNCTION__);
         }
 
+        // Blocked?
+        if (p.empty() && x.size0() > 2 * block_size()) {
+            chol_blocked_(pool, x);
+            return;
+        }
+
         // Initialize pivot.
+        float_type tol = 0;
         if (!p.empty()) {
             // Ensure valid.
             if (p.size() != x.size0()) {
@@ -749,6 +1633,11 @@ public:
                     p.begin(),
                     p.end(),
                     0);
+            // Tolerance, relative to largest diagonal entry.
+            for (int i = 0; i < x.size0(); i++) {
+                tol = pre::fmax(tol, pre::real(x[i][i]));
+            }
+            tol *= x.size0() * pre::numeric_limits<float_type>::epsilon();
         }
 
         // Iterate.
@@ -757,30 +1646,31 @@ public:
             // Pivot.
             if (!p.empty()) {
                 int l = k;
-                float_type fac = 0;
-                float_type tmp = 0;
-                for (int i = k; i < x.size0(); i++) {
-                    tmp = pre::abs(x[i][i]);
-                    if (fac < tmp) {
-                        fac = tmp;
+                for (int i = k + 1; i < x.size0(); i++) {
+                    if (pre::real(x[l][l]) < pre::real(x[i][i])) {
                         l = i;
                     }
                 }
                 if (k != l) {
-                    // Swap.
+                    // Swap, within lower triangle.
                     std::swap(p[k], p[l]);
-                    std::swap_ranges(
-                        x[k].begin(), x[k].end(),
-                        x[l].begin());
-                    std::swap_ranges(
-                        x.transpose()[k].begin(), x.transpose()[k].end(),
-                        x.transpose()[l].begin());
+                    for (int j = 0; j < k; j++) {
+                        std::swap(x[k][j], x[l][j]);
+                    }
+                    std::swap(x[k][k], x[l][l]);
+                    for (int i = k + 1; i < l; i++) {
+                        value_type tmp = x[i][k];
+                        x[i][k] = pre::conj(x[l][i]);
+                        x[l][i] = pre::conj(tmp);
+                    }
+                    x[l][k] = pre::conj(x[l][k]);
+                    for (int i = l + 1; i < x.size0(); i++) {
+                        std::swap(x[i][k], x[i][l]);
+                    }
                 }
 
                 // Positive semi-definite?
-                if (!(pre::abs(x[k][k]) >
-                      pre::abs(x[0][0]) *
-                      pre::numeric_limits<float_type>::epsilon())) {
+                if (!(pre::real(x[k][k]) > tol)) {
                     for (int i = k; i < x.size0(); i++)
                     for (int j = k; j < i + 1; j++) {
                         x[i][j] = value_type();
@@ -789,7 +1679,8 @@ public:
                 }
             }
 
-            if (x[k][k] != pre::real(x[k][k])) {
+            // Positive definite?
+            if (!(pre::real(x[k][k]) > 0)) {
                 throw std::runtime_error(__PRETTY_FUNCTION__);
             }
 
@@ -817,7 +1708,87 @@ public:
         }
     }
 
-    /**@}*/
+    /**
+     * @brief Cholesky decomposition, blocked implementation.
+     */
+    static void chol_blocked_(
+                thread_pool* pool,
+                dense_matrix_view<value_type*> x)
+    {
+        // Temporary buffer.
+        static thread_local std::vector<value_type> tmpbuf;
+        const int n = int(x.size0());
+        tmpbuf.resize(std::size_t(n) * block_size());
+        for (int k = 0; k < n; k += block_size()) {
+            int b = std::min(block_size(), n - k);
+            int kb = k + b;
+
+            // Factor diagonal block.
+            chol_(nullptr, x.block(k, k, kb, kb), {});
+            if (kb == n) {
+                break;
+            }
+
+            // Solve panel rows, X[i,k:kb] <- X[i,k:kb] L^-H.
+            auto row_func = [&](int i) {
+                value_type* itrx = x.begin_itr_ + x.begin_inc0_ * i;
+                for (int j = k; j < kb; j++) {
+                    const value_type* itrl = x.begin_itr_ + x.begin_inc0_ * j;
+                    value_type tmp = itrx[x.begin_inc1_ * j];
+                    for (int l = k; l < j; l++) {
+                        tmp -= itrx[x.begin_inc1_ * l] *
+                               pre::conj(itrl[x.begin_inc1_ * l]);
+                    }
+                    tmp *= 1 / pre::real(itrl[x.begin_inc1_ * j]);
+                    if (!pre::isfinite(tmp)) {
+                        throw std::runtime_error(__PRETTY_FUNCTION__);
+                    }
+                    itrx[x.begin_inc1_ * j] = tmp;
+                }
+            };
+
+            // Update trailing lower triangle by column blocks,
+            // X[j0:n,j0:j1] <- X[j0:n,j0:j1] - X[j0:n,k:kb] X[j0:j1,k:kb]^H,
+            // with the adjoint panel copied to contiguous rows.
+            dense_matrix_view<value_type*> xh = {
+                &tmpbuf[0],
+                n - kb, 1,
+                b, n - kb
+            };
+            auto block_func = [&](int j0) {
+                int j1 = std::min(j0 + block_size(), n);
+                gemm_(
+                    nullptr, value_type(float_type(-1)),
+                    x.block(j0, k, n, kb), false,
+                    xh.block(0, j0 - kb, b, j1 - kb), false,
+                    x.block(j0, j0, n, j1));
+            };
+
+            if (pool) {
+                pool->parallel_for(kb, n, block_size(), row_func);
+                adjoint(x.block(kb, k, n, kb), xh);
+                int nblocks = (n - kb + block_size() - 1) / block_size();
+                pool->parallel_for(0, nblocks, 1, [&](int t) {
+                    block_func(kb + t * block_size());
+                });
+            }
+            else {
+                for (int i = kb; i < n; i++) {
+                    row_func(i);
+                }
+                adjoint(x.block(kb, k, n, kb), xh);
+                for (int j0 = kb; j0 < n; j0 += block_size()) {
+                    block_func(j0);
+                }
+            }
+        }
+
+        // To lower triangular.
+        for (int i = 1; i < x.size0(); i++)
+        for (int j = 0; j < i; j++) {
+            x[j][i] = value_type();
+        }
+    }
 };
 
 /**@}*/
@@ -0,0 +1,1766 @@
+/* Copyright (c) 2018-20 M. Grady Saunders
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer.
+ *
+ *   2. Redistributions in binary form must reproduce the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer in the documentation and/or other materials
+ *      provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*+-+*/
+#if !DOXYGEN
+#if !(__cplusplus >= 201703L)
+#error "preform/double_word.hpp requires >=C++17"
+#endif // #if !(__cplusplus >= 201703L)
+#endif // #if !DOXYGEN
+#pragma once
+#ifndef PREFORM_DOUBLE_WORD_HPP
+#define PREFORM_DOUBLE_WORD_HPP
+
+// for std::basic_istream
+#include <istream>
+
+// for std::basic_ostream
+#include <ostream>
+
+// for std::is_arithmetic, std::enable_if_t, ...
+#include <type_traits>
+
+#include <preform/math.hpp>
+
+namespace pre {
+
+/**
+ * @defgroup double_word Double word
+ *
+ * `<preform/double_word.hpp>`
+ *
+ * __C++ version__: >=C++17
+ *
+ * Unevaluated sum of two floats @f$ x_h + x_l @f$ with
+ * @f$ |x_l| \le \operatorname{ulp}(x_h)/2 @f$, i.e., double-double
+ * for `double` (106 bits) or float-float for `float` (48 bits).
+ * Arithmetic uses the error-free transforms and double-word
+ * algorithms analyzed by Joldes, Muller, and Popescu, with relative
+ * errors of a few @f$ u^2 @f$ where @f$ u @f$ is the unit roundoff
+ * of `T`. Math functions refine the `T` result by Newton steps,
+ * or sum a Taylor series after argument reduction, and are not
+ * correctly rounded. Against `__float128` on random arguments,
+ * relative errors stay below about @f$ 3u^2 @f$ for `sqrt()` and
+ * `cbrt()`, @f$ 8u^2 @f$ for `exp()`, `sin()`, `cos()`, `asin()`,
+ * `acos()`, and `atan()`, and @f$ 16u^2 @f$ for `tan()`, `log()`,
+ * and the other exponential, logarithmic, and hyperbolic functions.
+ * The relative error of `pow()` grows with @f$ |y \log x| @f$, to
+ * about @f$ 140u^2 @f$ for @f$ |y \log x| \le 40 @f$.
+ *
+ * `double_word<double>` costs a few times as much as `double`,
+ * versus about 50 to 100 times for `__float128` in software, so it
+ * may replace `__float128` as a template parameter where 106 bits
+ * are enough. The exponent range is that of `T`, but precision
+ * degrades below `numeric_limits<double_word<T>>::min()`, where
+ * the low part is subnormal.
+ *
+ * @note
+ * The error-free transforms rely on strict IEEE evaluation, so this
+ * does not work with `-ffast-math` or `-fassociative-math`. Where
+ * available, `__FMA__` enables the two-product by fused multiply-add,
+ * otherwise the implementation uses Dekker's split.
+ *
+ * @see
+ * M. Joldes, J.-M. Muller, and V. Popescu, "Tight and rigorous
+ * error bounds for basic building blocks of double-word arithmetic,"
+ * _ACM Transactions on Mathematical Software_, 44(2), 2017.
+ */
+/**@{*/
+
+#if !DOXYGEN
+
+template <typename T>
+class double_word;
+
+template <typename T>
+struct is_double_word : std::false_type
+{
+};
+
+template <typename T>
+struct is_double_word<double_word<T>> : std::true_type
+{
+};
+
+// Sum and error, |a| >= |b| or a = 0.
+template <typename T>
+__attribute__((always_inline))
+inline void double_word_fast_two_sum_(T a, T b, T& s, T& e)
+{
+    s = a + b;
+    e = b - (s - a);
+}
+
+// Sum and error.
+template <typename T>
+__attribute__((always_inline))
+inline void double_word_two_sum_(T a, T b, T& s, T& e)
+{
+    s = a + b;
+    T bb = s - a;
+    e = (a - (s - bb)) + (b - bb);
+}
+
+#if !(__FMA__ || __FP_FAST_FMA)
+
+// Dekker's split, scaled where c * a would overflow.
+template <typename T>
+__attribute__((always_inline))
+inline void double_word_split_(T a, T& ah, T& al)
+{
+    constexpr int s = (pre::numeric_limits<T>::digits + 1) / 2;
+    constexpr T c = T((1ULL << s) + 1);
+    if (pre::fabs(a) > pre::numeric_limits<T>::max() / c) {
+        a = pre::ldexp(a, -(s + 1));
+        T ca = c * a;
+        ah = ca - (ca - a);
+        al = pre::ldexp(a - ah, s + 1);
+        ah = pre::ldexp(ah, s + 1);
+    }
+    else {
+        T ca = c * a;
+        ah = ca - (ca - a);
+        al = a - ah;
+    }
+}
+
+#endif // #if !(__FMA__ || __FP_FAST_FMA)
+
+// Product and error.
+template <typename T>
+__attribute__((always_inline))
+inline void double_word_two_prod_(T a, T b, T& p, T& e)
+{
+    p = a * b;
+#if __FMA__ || __FP_FAST_FMA
+    e = pre::fma(a, b, -p);
+#else
+    T ah, al;
+    T bh, bl;
+    double_word_split_(a, ah, al);
+    double_word_split_(b, bh, bl);
+    e = ((ah * bh - p) + ah * bl + al * bh) + al * bl;
+#endif // #if __FMA__ || __FP_FAST_FMA
+}
+
+// Constants in 4 parts of T, for Cody-Waite argument reduction.
+template <typename T>
+struct double_word_parts_;
+
+template <>
+struct double_word_parts_<double>
+{
+    static constexpr double pi_2[4] = {
+        +0x1.921fb54442d18p+0,
+        +0x1.1a62633145c07p-54,
+        -0x1.f1976b7ed8fbcp-110,
+        +0x1.4cf98e804177dp-164
+    };
+    static constexpr double ln2[4] = {
+        +0x1.62e42fefa39efp-1,
+        +0x1.abc9e3b39803fp-56,
+        +0x1.7b57a079a1934p-111,
+        -0x1.ace93a4ebe5d1p-165
+    };
+};
+
+template <>
+struct double_word_parts_<float>
+{
+    static constexpr float pi_2[4] = {
+        +0x1.921fb6p+0f,
+        -0x1.777a5cp-25f,
+        -0x1.ee59dap-50f,
+        +0x1.98a2e0p-77f
+    };
+    static constexpr float ln2[4] = {
+        +0x1.62e430p-1f,
+        -0x1.05c610p-29f,
+        -0x1.950d88p-54f,
+        +0x1.d9cc02p-79f
+    };
+};
+
+#endif // #if !DOXYGEN
+
+/**
+ * @brief Double word.
+ *
+ * @tparam T
+ * Float type, either `float` or `double`.
+ */
+template <typename T>
+class double_word
+{
+public:
+
+    // Sanity check.
+    static_assert(
+        std::is_same<T, float>::value ||
+        std::is_same<T, double>::value,
+        "T must be float or double");
+
+    /**
+     * @brief Value type.
+     */
+    typedef T value_type;
+
+public:
+
+    /**
+     * @name Constructors
+     */
+    /**@{*/
+
+    /**
+     * @brief Default constructor.
+     */
+    constexpr double_word() = default;
+
+    /**
+     * @brief Constructor.
+     */
+    constexpr double_word(T x) : hi_(x)
+    {
+    }
+
+    /**
+     * @brief Constructor from integer, exact if representable in `T`.
+     */
+    template <
+        typename U,
+        typename = std::enable_if_t<std::is_integral<U>::value>
+        >
+    constexpr double_word(U x) : hi_(T(x))
+    {
+    }
+
+    /**
+     * @brief Constructor from parts.
+     *
+     * @param[in] hi
+     * High part.
+     *
+     * @param[in] lo
+     * Low part, must satisfy @f$ |x_l| \le \operatorname{ulp}(x_h)/2 @f$.
+     */
+    constexpr double_word(T hi, T lo) : hi_(hi), lo_(lo)
+    {
+    }
+
+    /**
+     * @brief Split double word of `double` into double word of `T`.
+     *
+     * For `double`, this is the identity. For `float`, this rounds
+     * the parts to 48 bits.
+     */
+    static constexpr double_word split(double hi, double lo)
+    {
+        return {
+            T(hi),
+            T((hi - double(T(hi))) + lo)
+        };
+    }
+
+    /**
+     * @brief Normalize unordered parts by a two-sum.
+     */
+    static double_word normalize(T hi, T lo)
+    {
+        double_word x;
+        double_word_two_sum_(hi, lo, x.hi_, x.lo_);
+        return x;
+    }
+
+    /**@}*/
+
+public:
+
+    /**
+     * @name Accessors
+     */
+    /**@{*/
+
+    /**
+     * @brief High part.
+     */
+    __attribute__((always_inline))
+    constexpr T hi() const
+    {
+        return hi_;
+    }
+
+    /**
+     * @brief Low part.
+     */
+    __attribute__((always_inline))
+    constexpr T lo() const
+    {
+        return lo_;
+    }
+
+    /**
+     * @brief Cast as `T`, i.e, round to nearest.
+     */
+    __attribute__((always_inline))
+    constexpr explicit operator T() const
+    {
+        return hi_;
+    }
+
+    /**
+     * @brief Cast as other arithmetic type.
+     *
+     * @note
+     * For `long double` or `__float128`, this sums the
+     * parts in the target type.
+     */
+    template <
+        typename U,
+        typename = std::enable_if_t<
+                   !std::is_same<U, T>::value &&
+                   (std::is_arithmetic<U>::value ||
+                    std::is_floating_point<U>::value)>
+        >
+    __attribute__((always_inline))
+    constexpr explicit operator U() const
+    {
+        return U(hi_) + U(lo_);
+    }
+
+    /**@}*/
+
+private:
+
+    /**
+     * @brief High part.
+     */
+    T hi_ = T();
+
+    /**
+     * @brief Low part.
+     */
+    T lo_ = T();
+
+public:
+
+    /**
+     * @name Stream operators
+     */
+    /**@{*/
+
+    /**
+     * @brief Parse from `std::basic_istream`.
+     *
+     * Format is `(hi,lo)`, or a single `T`. Sets
+     * `std::ios_base::failbit` on error.
+     */
+    template <typename C, typename Ctraits>
+    friend
+    inline std::basic_istream<C, Ctraits>& operator>>(
+           std::basic_istream<C, Ctraits>& is, double_word& x)
+    {
+        C ch;
+        if (!(is >> ch) ||
+            !Ctraits::eq(ch,
+             Ctraits::to_char_type('('))) {
+            is.putback(ch);
+            T hi;
+            if (!(is >> hi)) {
+                is.setstate(std::ios_base::failbit);
+                return is;
+            }
+            x = double_word(hi);
+            return is;
+        }
+        T hi;
+        T lo;
+        is >> hi;
+        if (!(is >> ch) ||
+            !Ctraits::eq(ch,
+             Ctraits::to_char_type(','))) {
+            is.setstate(std::ios_base::failbit);
+            return is;
+        }
+        is >> lo;
+        if (!(is >> ch) ||
+            !Ctraits::eq(ch,
+             Ctraits::to_char_type(')'))) {
+            is.setstate(std::ios_base::failbit);
+            return is;
+        }
+        x = normalize(hi, lo);
+        return is;
+    }
+
+    /**
+     * @brief Write into `std::basic_ostream`.
+     *
+     * Format is `(hi,lo)`.
+     */
+    template <typename C, typename Ctraits>
+    friend
+    inline std::basic_ostream<C, Ctraits>& operator<<(
+           std::basic_ostream<C, Ctraits>& os, const double_word& x)
+    {
+        os << '(' << x.hi_ << ',' << x.lo_ << ')';
+        return os;
+    }
+
+    /**@}*/
+};
+
+/**
+ * @brief Specialize `numeric_limits`.
+ */
+template <typename T>
+struct numeric_limits<double_word<T>>
+{
+    /**
+     * @brief Set `is_specialized`.
+     */
+    static constexpr bool is_specialized = true;
+
+    /**
+     * @brief Set `is_signed`.
+     */
+    static constexpr bool is_signed = true;
+
+    /**
+     * @brief Set `has_infinity`.
+     */
+    static constexpr bool has_infinity = true;
+
+    /**
+     * @brief Set `has_quiet_NaN`.
+     */
+    static constexpr bool has_quiet_NaN = true;
+
+    /**
+     * @brief Set `min_exponent`.
+     */
+    static constexpr int min_exponent =
+           pre::numeric_limits<T>::min_exponent +
+           pre::numeric_limits<T>::digits;
+
+    /**
+     * @brief Set `max_exponent`.
+     */
+    static constexpr int max_exponent =
+           pre::numeric_limits<T>::max_exponent;
+
+    /**
+     * @brief Set `digits`.
+     */
+    static constexpr int digits = 2 * pre::numeric_limits<T>::digits;
+
+    /**
+     * @brief Set `digits10`, as @f$ \lfloor (d - 1) \log_{10} 2 \rfloor @f$.
+     */
+    static constexpr int digits10 = (digits - 1) * 301 / 1000;
+
+    /**
+     * @brief Minimum normal value, such that the low part is also normal.
+     */
+    static constexpr double_word<T> min() noexcept
+    {
+        return pre::numeric_limits<T>::min() /
+               pre::numeric_limits<T>::epsilon();
+    }
+
+    /**
+     * @brief Maximum value, to the precision of `T`.
+     */
+    static constexpr double_word<T> max() noexcept
+    {
+        return pre::numeric_limits<T>::max();
+    }
+
+    /**
+     * @brief Machine epsilon, @f$ 2^{1 - d} @f$.
+     */
+    static constexpr double_word<T> epsilon() noexcept
+    {
+        return pre::numeric_limits<T>::epsilon() *
+               pre::numeric_limits<T>::epsilon() / 2;
+    }
+
+    /**
+     * @brief Unit roundoff, for analysis as in `pre::numeric_limits`.
+     */
+    static constexpr double_word<T> machine_epsilon() noexcept
+    {
+        return pre::numeric_limits<T>::epsilon() *
+               pre::numeric_limits<T>::epsilon() / 4;
+    }
+
+    /**
+     * @brief Infinity.
+     */
+    static constexpr double_word<T> infinity() noexcept
+    {
+        return pre::numeric_limits<T>::infinity();
+    }
+
+    /**
+     * @brief Quiet NaN.
+     */
+    static constexpr double_word<T> quiet_NaN() noexcept
+    {
+        return pre::numeric_limits<T>::quiet_NaN();
+    }
+};
+
+/**
+ * @brief Specialize `numeric_constants`.
+ */
+template <typename T>
+struct numeric_constants<double_word<T>>
+{
+    /**
+     * @brief @f$ e @f$.
+     */
+    static constexpr double_word<T> M_e() noexcept
+    {
+        return double_word<T>::split(
+                0x1.5bf0a8b145769p+1,
+                0x1.4d57ee2b1013ap-53);
+    }
+
+    /**
+     * @brief @f$ \log_2(e) @f$.
+     */
+    static constexpr double_word<T> M_log2e() noexcept
+    {
+        return double_word<T>::split(
+                0x1.71547652b82fep+0,
+                0x1.777d0ffda0d24p-56);
+    }
+
+    /**
+     * @brief @f$ \log_{10}(e) @f$.
+     */
+    static constexpr double_word<T> M_log10e() noexcept
+    {
+        return double_word<T>::split(
+                0x1.bcb7b1526e50ep-2,
+                0x1.95355baaafad3p-57);
+    }
+
+    /**
+     * @brief @f$ \log_e(2) @f$.
+     */
+    static constexpr double_word<T> M_ln2() noexcept
+    {
+        return double_word<T>::split(
+                0x1.62e42fefa39efp-1,
+                0x1.abc9e3b39803fp-56);
+    }
+
+    /**
+     * @brief @f$ \log_e(10) @f$.
+     */
+    static constexpr double_word<T> M_ln10() noexcept
+    {
+        return double_word<T>::split(
+                0x1.26bb1bbb55516p+1,
+                -0x1.f48ad494ea3e9p-53);
+    }
+
+    /**
+     * @brief @f$ \pi @f$.
+     */
+    static constexpr double_word<T> M_pi() noexcept
+    {
+        return double_word<T>::split(
+                0x1.921fb54442d18p+1,
+                0x1.1a62633145c07p-53);
+    }
+
+    /**
+     * @brief @f$ \pi/2 @f$.
+     */
+    static constexpr double_word<T> M_pi_2() noexcept
+    {
+        return double_word<T>::split(
+                0x1.921fb54442d18p+0,
+                0x1.1a62633145c07p-54);
+    }
+
+    /**
+     * @brief @f$ \pi/4 @f$.
+     */
+    static constexpr double_word<T> M_pi_4() noexcept
+    {
+        return double_word<T>::split(
+                0x1.921fb54442d18p-1,
+                0x1.1a62633145c07p-55);
+    }
+
+    /**
+     * @brief @f$ 1/\pi @f$.
+     */
+    static constexpr double_word<T> M_1_pi() noexcept
+    {
+        return double_word<T>::split(
+                0x1.45f306dc9c883p-2,
+                -0x1.6b01ec5417056p-56);
+    }
+
+    /**
+     * @brief @f$ 2/\pi @f$.
+     */
+    static constexpr double_word<T> M_2_pi() noexcept
+    {
+        return double_word<T>::split(
+                0x1.45f306dc9c883p-1,
+                -0x1.6b01ec5417056p-55);
+    }
+
+    /**
+     * @brief @f$ 2/\sqrt{\pi} @f$.
+     */
+    static constexpr double_word<T> M_2_sqrtpi() noexcept
+    {
+        return double_word<T>::split(
+                0x1.20dd750429b6dp+0,
+                0x1.1ae3a914fed8p-56);
+    }
+
+    /**
+     * @brief @f$ \sqrt{2} @f$.
+     */
+    static constexpr double_word<T> M_sqrt2() noexcept
+    {
+        return double_word<T>::split(
+                0x1.6a09e667f3bcdp+0,
+                -0x1.bdd3413b26456p-54);
+    }
+
+    /**
+     * @brief @f$ 1/\sqrt{2} @f$.
+     */
+    static constexpr double_word<T> M_sqrt1_2() noexcept
+    {
+        return double_word<T>::split(
+                0x1.6a09e667f3bcdp-1,
+                -0x1.bdd3413b26456p-55);
+    }
+
+    /**
+     * @brief @f$ \gamma @f$.
+     */
+    static constexpr double_word<T> M_gamma() noexcept
+    {
+        return double_word<T>::split(
+                0x1.2788cfc6fb619p-1,
+                -0x1.6cb90701fbfabp-58);
+    }
+
+    /**
+     * @brief @f$ h @f$, to the precision of `T`.
+     */
+    static constexpr double_word<T> M_h() noexcept
+    {
+        return numeric_constants<T>::M_h();
+    }
+
+    /**
+     * @brief @f$ c @f$, exact.
+     */
+    static constexpr double_word<T> M_c() noexcept
+    {
+        return double_word<T>::split(
+                299792458.0,
+                0.0);
+    }
+};
+
+/**
+ * @name Unary operators (double_word)
+ */
+/**@{*/
+
+/**
+ * @brief Identity.
+ */
+template <typename T>
+__attribute__((always_inline))
+constexpr double_word<T> operator+(const double_word<T>& x)
+{
+    return x;
+}
+
+/**
+ * @brief Negate, exact.
+ */
+template <typename T>
+__attribute__((always_inline))
+constexpr double_word<T> operator-(const double_word<T>& x)
+{
+    return {-x.hi(), -x.lo()};
+}
+
+/**@}*/
+
+/**
+ * @name Binary operators (double_word/double_word)
+ */
+/**@{*/
+
+/**
+ * @brief Add, with relative error at most @f$ 3u^2 @f$.
+ */
+template <typename T>
+__attribute__((always_inline))
+inline double_word<T> operator+(
+                const double_word<T>& x,
+                const double_word<T>& y)
+{
+    T sh, sl;
+    T th, tl;
+    double_word_two_sum_(x.hi(), y.hi(), sh, sl);
+    if (!pre::isfinite(sh)) {
+        return sh;
+    }
+    double_word_two_sum_(x.lo(), y.lo(), th, tl);
+    T vh, vl;
+    double_word_fast_two_sum_(sh, sl + th, vh, vl);
+    T zh, zl;
+    double_word_fast_two_sum_(vh, tl + vl, zh, zl);
+    return {zh, zl};
+}
+
+/**
+ * @brief Subtract, with relative error at most @f$ 3u^2 @f$.
+ */
+template <typename T>
+__attribute__((always_inline))
+inline double_word<T> operator-(
+                const double_word<T>& x,
+                const double_word<T>& y)
+{
+    return x + (-y);
+}
+
+/**
+ * @brief Multiply, with relative error at most @f$ 5u^2 @f$.
+ */
+template <typename T>
+__attribute__((always_inline))
+inline double_word<T> operator*(
+                const double_word<T>& x,
+                const double_word<T>& y)
+{
+    T ch, cl;
+    double_word_two_prod_(x.hi(), y.hi(), ch, cl);
+    if (!pre::isfinite(ch)) {
+        return ch;
+    }
+    cl += x.hi() * y.lo() + x.lo() * y.hi();
+    T zh, zl;
+    double_word_fast_two_sum_(ch, cl, zh, zl);
+    return {zh, zl};
+}
+
+/**
+ * @brief Divide, with relative error at most @f$ 15u^2 @f$.
+ */
+template <typename T>
+__attribute__((always_inline))
+inline double_word<T> operator/(
+                const double_word<T>& x,
+                const double_word<T>& y)
+{
+    T th = x.hi() / y.hi();
+    if (!pre::isfinite(th)) {
+        return th;
+    }
+    // r = y * th
+    T rh, rl;
+    double_word_two_prod_(y.hi(), th, rh, rl);
+    rl += y.lo() * th;
+    double_word_fast_two_sum_(rh, rl, rh, rl);
+    // d = x - r
+    T ph, pl;
+    double_word_two_sum_(x.hi(), -rh, ph, pl);
+    T d = ph + ((pl - rl) + x.lo());
+    T zh, zl;
+    double_word_fast_two_sum_(th, d / y.hi(), zh, zl);
+    return {zh, zl};
+}
+
+/**@}*/
+
+/**
+ * @name Binary operators (double_word/num)
+ */
+/**@{*/
+
+/**
+ * @brief Add, with relative error at most @f$ 2u^2 @f$.
+ */
+template <typename T, typename U>
+__attribute__((always_inline))
+inline std::enable_if_t<
+       std::is_arithmetic<U>::value,
+                          double_word<T>> operator+(
+                                const double_word<T>& x, U u)
+{
+    T y = T(u);
+    T sh, sl;
+    double_word_two_sum_(x.hi(), y, sh, sl);
+    if (!pre::isfinite(sh)) {
+        return sh;
+    }
+    T zh, zl;
+    double_word_fast_two_sum_(sh, x.lo() + sl, zh, zl);
+    return {zh, zl};
+}
+
+/**
+ * @brief Subtract, with relative error at most @f$ 2u^2 @f$.
+ */
+template <typename T, typename U>
+__attribute__((always_inline))
+inline std::enable_if_t<
+       std::is_arithmetic<U>::value,
+                          double_word<T>> operator-(
+                                const double_word<T>& x, U u)
+{
+    return x + (-T(u));
+}
+
+/**
+ * @brief Multiply, with relative error at most @f$ 2u^2 @f$.
+ */
+template <typename T, typename U>
+__attribute__((always_inline))
+inline std::enable_if_t<
+       std::is_arithmetic<U>::value,
+                          double_word<T>> operator*(
+                                const double_word<T>& x, U u)
+{
+    T y = T(u);
+    T ch, cl;
+    double_word_two_prod_(x.hi(), y, ch, cl);
+    if (!pre::isfinite(ch)) {
+        return ch;
+    }
+    T zh, zl;
+    double_word_fast_two_sum_(ch, pre::fma(x.lo(), y, cl), zh, zl);
+    return {zh, zl};
+}
+
+/**
+ * @brief Divide, with relative error at most @f$ 3u^2 @f$.
+ */
+template <typename T, typename U>
+__attribute__((always_inline))
+inline std::enable_if_t<
+       std::is_arithmetic<U>::value,
+                          double_word<T>> operator/(
+                                const double_word<T>& x, U u)
+{
+    T y = T(u);
+    T th = x.hi() / y;
+    if (!pre::isfinite(th)) {
+        return th;
+    }
+    T ph, pl;
+    double_word_two_prod_(th, y, ph, pl);
+    T d = ((x.hi() - ph) - pl) + x.lo();
+    T zh, zl;
+    double_word_fast_two_sum_(th, d / y, zh, zl);
+    return {zh, zl};
+}
+
+/**@}*/
+
+/**
+ * @name Binary operators (num/double_word)
+ */
+/**@{*/
+
+/**
+ * @brief Add.
+ */
+template <typename T, typename U>
+__attribute__((always_inline))
+inline std::enable_if_t<
+       std::is_arithmetic<U>::value,
+                          double_word<T>> operator+(
+                                U u, const double_word<T>& x)
+{
+    return x + u;
+}
+
+/**
+ * @brief Subtract.
+ */
+template <typename T, typename U>
+__attribute__((always_inline))
+inline std::enable_if_t<
+       std::is_arithmetic<U>::value,
+                          double_word<T>> operator-(
+                                U u, const double_word<T>& x)
+{
+    return (-x) + u;
+}
+
+/**
+ * @brief Multiply.
+ */
+template <typename T, typename U>
+__attribute__((always_inline))
+inline std::enable_if_t<
+       std::is_arithmetic<U>::value,
+                          double_word<T>> operator*(
+                                U u, const double_word<T>& x)
+{
+    return x * u;
+}
+
+/**
+ * @brief Divide.
+ */
+template <typename T, typename U>
+__attribute__((always_inline))
+inline std::enable_if_t<
+       std::is_arithmetic<U>::value,
+                          double_word<T>> operator/(
+                                U u, const double_word<T>& x)
+{
+    return double_word<T>(T(u)) / x;
+}
+
+/**@}*/
+
+/**
+ * @name Binary operators (double_word/any)
+ */
+/**@{*/
+
+/**
+ * @brief Wrap `operator+=`.
+ */
+template <typename T, typename U>
+__attribute__((always_inline))
+inline double_word<T>& operator+=(double_word<T>& x, const U& any)
+{
+    return x = x + any;
+}
+
+/**
+ * @brief Wrap `operator-=`.
+ */
+template <typename T, typename U>
+__attribute__((always_inline))
+inline double_word<T>& operator-=(double_word<T>& x, const U& any)
+{
+    return x = x - any;
+}
+
+/**
+ * @brief Wrap `operator*=`.
+ */
+template <typename T, typename U>
+__attribute__((always_inline))
+inline double_word<T>& operator*=(double_word<T>& x, const U& any)
+{
+    return x = x * any;
+}
+
+/**
+ * @brief Wrap `operator/=`.
+ */
+template <typename T, typename U>
+__attribute__((always_inline))
+inline double_word<T>& operator/=(double_word<T>& x, const U& any)
+{
+    return x = x / any;
+}
+
+/**@}*/
+
+/**
+ * @name Comparison operators (double_word)
+ *
+ * @note
+ * These assume normalized operands, compare lexicographically by
+ * high part then low part, and promote numbers to `double_word`.
+ */
+/**@{*/
+
+/**
+ * @brief Compare `operator==`.
+ */
+template <typename T>
+__attribute__((always_inline))
+constexpr bool operator==(const double_word<T>& x, const double_word<T>& y)
+{
+    return x.hi() == y.hi() && x.lo() == y.lo();
+}
+
+/**
+ * @brief Compare `operator!=`.
+ */
+template <typename T>
+__attribute__((always_inline))
+constexpr bool operator!=(const double_word<T>& x, const double_word<T>& y)
+{
+    return !(x == y);
+}
+
+/**
+ * @brief Compare `operator<`.
+ */
+template <typename T>
+__attribute__((always_inline))
+constexpr bool operator<(const double_word<T>& x, const double_word<T>& y)
+{
+    return x.hi() < y.hi() || (x.hi() == y.hi() && x.lo() < y.lo());
+}
+
+/**
+ * @brief Compare `operator>`.
+ */
+template <typename T>
+__attribute__((always_inline))
+constexpr bool operator>(const double_word<T>& x, const double_word<T>& y)
+{
+    return y < x;
+}
+
+/**
+ * @brief Compare `operator<=`.
+ */
+template <typename T>
+__attribute__((always_inline))
+constexpr bool operator<=(const double_word<T>& x, const double_word<T>& y)
+{
+    return x.hi() < y.hi() || (x.hi() == y.hi() && x.lo() <= y.lo());
+}
+
+/**
+ * @brief Compare `operator>=`.
+ */
+template <typename T>
+__attribute__((always_inline))
+constexpr bool operator>=(const double_word<T>& x, const double_word<T>& y)
+{
+    return y <= x;
+}
+
+#if !DOXYGEN
+
+#define PREFORM_DOUBLE_WORD_COMPARE_(op) \
+template <typename T, typename U> \
+__attribute__((always_inline)) \
+constexpr std::enable_if_t< \
+          std::is_arithmetic<U>::value, bool> operator op( \
+                    const double_word<T>& x, U u) \
+{ \
+    return x op double_word<T>(T(u)); \
+} \
+template <typename T, typename U> \
+__attribute__((always_inline)) \
+constexpr std::enable_if_t< \
+          std::is_arithmetic<U>::value, bool> operator op( \
+                    U u, const double_word<T>& x) \
+{ \
+    return double_word<T>(T(u)) op x; \
+}
+PREFORM_DOUBLE_WORD_COMPARE_(==)
+PREFORM_DOUBLE_WORD_COMPARE_(!=)
+PREFORM_DOUBLE_WORD_COMPARE_(<)
+PREFORM_DOUBLE_WORD_COMPARE_(>)
+PREFORM_DOUBLE_WORD_COMPARE_(<=)
+PREFORM_DOUBLE_WORD_COMPARE_(>=)
+#undef PREFORM_DOUBLE_WORD_COMPARE_
+
+#endif // #if !DOXYGEN
+
+/**@}*/
+
+/**
+ * @name Float checks and manipulation (double_word)
+ */
+/**@{*/
+
+/**
+ * @brief Is NaN?
+ */
+template <typename T>
+__attribute__((always_inline))
+inline bool isnan(const double_word<T>& x)
+{
+    return pre::isnan(x.hi());
+}
+
+/**
+ * @brief Is Inf?
+ */
+template <typename T>
+__attribute__((always_inline))
+inline bool isinf(const double_word<T>& x)
+{
+    return pre::isinf(x.hi());
+}
+
+/**
+ * @brief Is finite?
+ */
+template <typename T>
+__attribute__((always_inline))
+inline bool isfinite(const double_word<T>& x)
+{
+    return pre::isfinite(x.hi());
+}
+
+/**
+ * @brief Sign bit.
+ */
+template <typename T>
+__attribute__((always_inline))
+inline bool signbit(const double_word<T>& x)
+{
+    return pre::signbit(x.hi());
+}
+
+/**
+ * @brief Copy sign, exact.
+ */
+template <typename T>
+__attribute__((always_inline))
+inline double_word<T> copysign(const double_word<T>& x,
+                               const double_word<T>& y)
+{
+    return pre::signbit(x.hi()) == pre::signbit(y.hi()) ? x : -x;
+}
+
+/**
+ * @brief Sign, @f$ \pm 1 @f$ by `pre::copysign()`.
+ */
+template <typename T>
+__attribute__((always_inline))
+inline double_word<T> sign(const double_word<T>& x)
+{
+    return pre::copysign(T(1), x.hi());
+}
+
+/**
+ * @brief Absolute value, exact.
+ */
+template <typename T>
+__attribute__((always_inline))
+inline double_word<T> fabs(const double_word<T>& x)
+{
+    return pre::signbit(x.hi()) ? -x : x;
+}
+
+/**
+ * @brief Absolute value, exact.
+ */
+template <typename T>
+__attribute__((always_inline))
+inline double_word<T> abs(const double_word<T>& x)
+{
+    return pre::fabs(x);
+}
+
+/**
+ * @brief Minimum, or the other argument if one is NaN.
+ */
+template <typename T>
+__attribute__((always_inline))
+inline double_word<T> fmin(const double_word<T>& x,
+                           const double_word<T>& y)
+{
+    return pre::isnan(x) ? y : pre::isnan(y) ? x : y < x ? y : x;
+}
+
+/**
+ * @brief Maximum, or the other argument if one is NaN.
+ */
+template <typename T>
+__attribute__((always_inline))
+inline double_word<T> fmax(const double_word<T>& x,
+                           const double_word<T>& y)
+{
+    return pre::isnan(x) ? y : pre::isnan(y) ? x : x < y ? y : x;
+}
+
+/**
+ * @brief Multiply by power of 2, exact barring underflow.
+ */
+template <typename T>
+__attribute__((always_inline))
+inline double_word<T> ldexp(const double_word<T>& x, int p)
+{
+    return {pre::ldexp(x.hi(), p), pre::ldexp(x.lo(), p)};
+}
+
+/**
+ * @brief Floor, exact.
+ */
+template <typename T>
+inline double_word<T> floor(const double_word<T>& x)
+{
+    T hi = pre::floor(x.hi());
+    if (hi != x.hi()) {
+        return hi;
+    }
+    return double_word<T>::normalize(hi, pre::floor(x.lo()));
+}
+
+/**
+ * @brief Ceil, exact.
+ */
+template <typename T>
+inline double_word<T> ceil(const double_word<T>& x)
+{
+    T hi = pre::ceil(x.hi());
+    if (hi != x.hi()) {
+        return hi;
+    }
+    return double_word<T>::normalize(hi, pre::ceil(x.lo()));
+}
+
+/**
+ * @brief Truncate, exact.
+ */
+template <typename T>
+inline double_word<T> trunc(const double_word<T>& x)
+{
+    return pre::signbit(x.hi()) ? pre::ceil(x) : pre::floor(x);
+}
+
+/**
+ * @brief Round, halfway cases away from zero, exact.
+ */
+template <typename T>
+inline double_word<T> round(const double_word<T>& x)
+{
+    double_word<T> t = pre::trunc(x);
+    if (pre::fabs(x - t) >= T(0.5)) {
+        t += pre::copysign(T(1), x.hi());
+    }
+    return t;
+}
+
+/**@}*/
+
+/**
+ * @name Math (double_word)
+ */
+/**@{*/
+
+/**
+ * @brief Square root, by one Newton step from `T`.
+ */
+template <typename T>
+inline double_word<T> sqrt(const double_word<T>& x)
+{
+    if (!(x.hi() > T(0)) || !pre::isfinite(x.hi())) {
+        return pre::sqrt(x.hi());
+    }
+    if (x.hi() > pre::numeric_limits<T>::max() / 4) {
+        // Scale, or s * s may overflow.
+        return pre::ldexp(pre::sqrt(pre::ldexp(x, -2)), 1);
+    }
+    T s = pre::sqrt(x.hi());
+    T ph, pl;
+    double_word_two_prod_(s, s, ph, pl);
+    T r = ((x.hi() - ph) - pl) + x.lo();
+    T zh, zl;
+    double_word_fast_two_sum_(s, r / (2 * s), zh, zl);
+    return {zh, zl};
+}
+
+/**
+ * @brief Cube root, by Newton steps from `T`.
+ *
+ * @note
+ * The first step is in `T`, since `cbrt()` of `T` may be off by
+ * a few ulp, and the one step in double word squares that error.
+ */
+template <typename T>
+inline double_word<T> cbrt(const double_word<T>& x)
+{
+    if (x.hi() == T(0) || !pre::isfinite(x.hi())) {
+        return pre::cbrt(x.hi());
+    }
+    if (pre::fabs(x.hi()) > pre::numeric_limits<T>::max() / 8) {
+        // Scale, or y * y * y may overflow.
+        return pre::ldexp(pre::cbrt(pre::ldexp(x, -3)), 1);
+    }
+    T y = pre::cbrt(x.hi());
+    T y2h, y2l;
+    double_word_two_prod_(y, y, y2h, y2l);
+    y -= (double_word<T>(y2h, y2l) * y - x).hi() / (3 * y2h);
+    double_word_two_prod_(y, y, y2h, y2l);
+    double_word<T> y2(y2h, y2l);
+    return y - (y2 * y - x) / (3 * y2);
+}
+
+/**
+ * @brief Hypotenuse.
+ */
+template <typename T>
+inline double_word<T> hypot(const double_word<T>& x,
+                            const double_word<T>& y)
+{
+    return pre::sqrt(x * x + y * y);
+}
+
+#if !DOXYGEN
+
+// Reduce x - k c, where k is an integer and c is in 4 parts. Each
+// product of k and a part is exact as a double word, so the result is
+// accurate to double word precision while k c0 cancels most of x.
+template <typename T>
+inline double_word<T> double_word_reduce_(
+            const double_word<T>& x, T k, const T (&c)[4])
+{
+    double_word<T> r = x;
+    for (int i = 0; i < 4; i++) {
+        T ph, pl;
+        double_word_two_prod_(k, c[i], ph, pl);
+        r = r - double_word<T>(ph, pl);
+    }
+    return r;
+}
+
+// Series for expm1 on |x| <= log(2)/2.
+template <typename T>
+inline double_word<T> double_word_expm1_kernel_(double_word<T> x)
+{
+    // Reduce to |x| <= 2^-10 log(2).
+    constexpr int m = 9;
+    x = pre::ldexp(x, -m);
+
+    // Sum Taylor series.
+    double_word<T> term = x;
+    double_word<T> sum = x;
+    for (int n = 2; n < 20; n++) {
+        term = term * x / T(n);
+        sum += term;
+        if (pre::fabs(term.hi()) <
+            pre::fabs(sum.hi()) *
+            pre::numeric_limits<double_word<T>>::machine_epsilon().hi()) {
+            break;
+        }
+    }
+
+    // Square, (1 + e)^2 - 1 = e (2 + e).
+    for (int k = 0; k < m; k++) {
+        sum = sum * (sum + T(2));
+    }
+    return sum;
+}
+
+// Sine and cosine series on |x| <= pi/4.
+template <typename T>
+inline void double_word_sincos_kernel_(
+            const double_word<T>& x,
+            double_word<T>& s,
+            double_word<T>& c)
+{
+    double_word<T> x2 = x * x;
+    double_word<T> ts = x;
+    double_word<T> tc = T(1);
+    s = ts;
+    c = tc;
+    for (int n = 1; n < 20; n++) {
+        ts = ts * x2 / T(-(2 * n) * (2 * n + 1));
+        tc = tc * x2 / T(-(2 * n - 1) * (2 * n));
+        s += ts;
+        c += tc;
+        if (pre::fabs(tc.hi()) <
+            pre::numeric_limits<double_word<T>>::machine_epsilon().hi()) {
+            break;
+        }
+    }
+}
+
+// Sine and cosine, with reduction by multiples of pi/2.
+template <typename T>
+inline void double_word_sincos_(
+            const double_word<T>& x,
+            double_word<T>& s,
+            double_word<T>& c)
+{
+    if (!pre::isfinite(x.hi())) {
+        s = c = pre::numeric_limits<T>::quiet_NaN();
+        return;
+    }
+    T k = pre::round(x.hi() * pre::numeric_constants<T>::M_2_pi());
+    double_word<T> r =
+        double_word_reduce_(x, k, double_word_parts_<T>::pi_2);
+    double_word<T> sr;
+    double_word<T> cr;
+    double_word_sincos_kernel_(r, sr, cr);
+    switch (int(k - T(4) * pre::floor(k / T(4)))) {
+        case 0: s = +sr; c = +cr; break;
+        case 1: s = +cr; c = -sr; break;
+        case 2: s = -sr; c = -cr; break;
+        default: s = -cr; c = +sr; break;
+    }
+}
+
+#endif // #if !DOXYGEN
+
+/**
+ * @brief Exponential.
+ */
+template <typename T>
+inline double_word<T> exp(const double_word<T>& x)
+{
+    if (!pre::isfinite(x.hi()) ||
+        pre::fabs(x.hi()) > T(pre::numeric_limits<T>::max_exponent)) {
+        return pre::exp(x.hi());
+    }
+    T k = pre::round(x.hi() * pre::numeric_constants<T>::M_log2e());
+    double_word<T> r =
+        double_word_reduce_(x, k, double_word_parts_<T>::ln2);
+    return pre::ldexp(double_word_expm1_kernel_(r) + T(1), int(k));
+}
+
+/**
+ * @brief Exponential minus one.
+ */
+template <typename T>
+inline double_word<T> expm1(const double_word<T>& x)
+{
+    if (pre::fabs(x.hi()) <= T(0.5) * pre::numeric_constants<T>::M_ln2()) {
+        return double_word_expm1_kernel_(x);
+    }
+    return pre::exp(x) - T(1);
+}
+
+/**
+ * @brief Exponential base 2.
+ */
+template <typename T>
+inline double_word<T> exp2(const double_word<T>& x)
+{
+    return pre::exp(x * numeric_constants<double_word<T>>::M_ln2());
+}
+
+#if !DOXYGEN
+
+template <typename T>
+inline double_word<T> log1p(const double_word<T>& x);
+
+#endif // #if !DOXYGEN
+
+/**
+ * @brief Logarithm.
+ *
+ * Splits off the exponent, so that @f$ x = 2^e m @f$ with
+ * @f$ m \in [1/\sqrt{2}, \sqrt{2}) @f$, then sums @f$ e \log(2) @f$
+ * and `log1p()` of @f$ m - 1 @f$, which is exact.
+ */
+template <typename T>
+inline double_word<T> log(const double_word<T>& x)
+{
+    if (!(x.hi() > T(0)) || !pre::isfinite(x.hi())) {
+        return pre::log(x.hi());
+    }
+    int e = 0;
+    pre::frexp(x.hi(), &e);
+    if (pre::ldexp(x.hi(), -e) < pre::numeric_constants<T>::M_sqrt1_2()) {
+        e--;
+    }
+    double_word<T> y = pre::log1p(pre::ldexp(x, -e) - T(1));
+    if (e == 0) {
+        return y;
+    }
+    return numeric_constants<double_word<T>>::M_ln2() * T(e) + y;
+}
+
+/**
+ * @brief Logarithm of one plus argument, by one Newton step from `T`.
+ */
+template <typename T>
+inline double_word<T> log1p(const double_word<T>& x)
+{
+    if (!(x.hi() > T(-1)) || !pre::isfinite(x.hi())) {
+        return pre::log1p(x.hi());
+    }
+    if (!(pre::fabs(x.hi()) < T(0.5))) {
+        return pre::log(x + T(1));
+    }
+    double_word<T> y = pre::log1p(x.hi());
+    double_word<T> e = pre::expm1(y);
+    return y + (x - e) / (e + T(1));
+}
+
+/**
+ * @brief Logarithm base 2.
+ */
+template <typename T>
+inline double_word<T> log2(const double_word<T>& x)
+{
+    return pre::log(x) * numeric_constants<double_word<T>>::M_log2e();
+}
+
+/**
+ * @brief Logarithm base 10.
+ */
+template <typename T>
+inline double_word<T> log10(const double_word<T>& x)
+{
+    return pre::log(x) * numeric_constants<double_word<T>>::M_log10e();
+}
+
+/**
+ * @brief Power.
+ *
+ * @note
+ * For negative `x`, this is only defined for integer `y`.
+ */
+template <typename T>
+inline double_word<T> pow(const double_word<T>& x, const double_word<T>& y)
+{
+    if (y == T(0)) {
+        return T(1);
+    }
+    if (pre::signbit(x.hi())) {
+        if (pre::trunc(y) != y) {
+            return pre::numeric_limits<T>::quiet_NaN();
+        }
+        double_word<T> p = pre::exp(y * pre::log(-x));
+        return pre::fmod(pre::fabs(y.hi()), T(2)) == T(1) ||
+               pre::fmod(pre::fabs(y.lo()), T(2)) == T(1) ? -p : p;
+    }
+    return pre::exp(y * pre::log(x));
+}
+
+/**
+ * @brief Sine.
+ *
+ * @note
+ * The argument reduction subtracts multiples of @f$ \pi/2 @f$ in
+ * 4 parts of `T`, which holds the relative error to about
+ * @f$ 6u^2 @f$ for @f$ |x| @f$ below @f$ 2^{p} @f$, where @f$ p @f$
+ * is the precision of `T`. Beyond that, the error grows with
+ * @f$ |x| @f$.
+ */
+template <typename T>
+inline double_word<T> sin(const double_word<T>& x)
+{
+    double_word<T> s;
+    double_word<T> c;
+    double_word_sincos_(x, s, c);
+    return s;
+}
+
+/**
+ * @brief Cosine.
+ *
+ * @note
+ * The argument reduction subtracts multiples of @f$ \pi/2 @f$ in
+ * 4 parts of `T`, which holds the relative error to about
+ * @f$ 6u^2 @f$ for @f$ |x| @f$ below @f$ 2^{p} @f$, where @f$ p @f$
+ * is the precision of `T`. Beyond that, the error grows with
+ * @f$ |x| @f$.
+ */
+template <typename T>
+inline double_word<T> cos(const double_word<T>& x)
+{
+    double_word<T> s;
+    double_word<T> c;
+    double_word_sincos_(x, s, c);
+    return c;
+}
+
+/**
+ * @brief Tangent.
+ */
+template <typename T>
+inline double_word<T> tan(const double_word<T>& x)
+{
+    double_word<T> s;
+    double_word<T> c;
+    double_word_sincos_(x, s, c);
+    return s / c;
+}
+
+/**
+ * @brief Arctangent of quotient, by one Newton step from `T`.
+ */
+template <typename T>
+inline double_word<T> atan2(const double_word<T>& y,
+                            const double_word<T>& x)
+{
+    T z = pre::atan2(y.hi(), x.hi());
+    if ((x.hi() == T(0) && y.hi() == T(0)) ||
+        !pre::isfinite(x.hi()) ||
+        !pre::isfinite(y.hi())) {
+        return z;
+    }
+    double_word<T> s;
+    double_word<T> c;
+    double_word_sincos_(double_word<T>(z), s, c);
+    return z + (y * c - x * s) / (x * c + y * s);
+}
+
+/**
+ * @brief Arctangent.
+ */
+template <typename T>
+inline double_word<T> atan(const double_word<T>& x)
+{
+    return pre::atan2(x, double_word<T>(T(1)));
+}
+
+/**
+ * @brief Arcsine.
+ */
+template <typename T>
+inline double_word<T> asin(const double_word<T>& x)
+{
+    return pre::atan2(x, pre::sqrt((T(1) - x) * (T(1) + x)));
+}
+
+/**
+ * @brief Arccosine.
+ */
+template <typename T>
+inline double_word<T> acos(const double_word<T>& x)
+{
+    return pre::atan2(pre::sqrt((T(1) - x) * (T(1) + x)), x);
+}
+
+/**
+ * @brief Hyperbolic sine.
+ */
+template <typename T>
+inline double_word<T> sinh(const double_word<T>& x)
+{
+    double_word<T> a = pre::fabs(x);
+    double_word<T> y;
+    if (a.hi() > T(1)) {
+        double_word<T> e = pre::exp(a);
+        y = (e - T(1) / e) / T(2);
+    }
+    else {
+        double_word<T> e = pre::expm1(a);
+        y = e * (e + T(2)) / (T(2) * (e + T(1)));
+    }
+    return pre::signbit(x.hi()) ? -y : y;
+}
+
+/**
+ * @brief Hyperbolic cosine.
+ */
+template <typename T>
+inline double_word<T> cosh(const double_word<T>& x)
+{
+    double_word<T> e = pre::exp(pre::fabs(x));
+    return (e + T(1) / e) / T(2);
+}
+
+/**
+ * @brief Hyperbolic tangent.
+ */
+template <typename T>
+inline double_word<T> tanh(const double_word<T>& x)
+{
+    // Beyond this, 1 - tanh(x) = 2 exp(-2x) is below double word
+    // precision.
+    constexpr T cutoff =
+        T(0.35) * (pre::numeric_limits<double_word<T>>::digits + 1);
+    double_word<T> a = pre::fabs(x);
+    double_word<T> y = T(1);
+    if (!(a.hi() > cutoff)) {
+        double_word<T> e = pre::expm1(T(2) * a);
+        y = e / (e + T(2));
+    }
+    return pre::signbit(x.hi()) ? -y : y;
+}
+
+/**
+ * @brief Hyperbolic arcsine.
+ *
+ * @note
+ * Beyond @f$ 1/\varepsilon @f$ of `T`, this is
+ * @f$ \log(2|x|) @f$, to avoid overflow in @f$ x^2 @f$, since the
+ * next term of the expansion is below double word precision.
+ */
+template <typename T>
+inline double_word<T> asinh(const double_word<T>& x)
+{
+    double_word<T> a = pre::fabs(x);
+    double_word<T> y;
+    if (a.hi() > 1 / pre::numeric_limits<T>::epsilon()) {
+        y = pre::log(a) + numeric_constants<double_word<T>>::M_ln2();
+    }
+    else {
+        double_word<T> a2 = a * a;
+        y = pre::log1p(a + a2 / (T(1) + pre::sqrt(T(1) + a2)));
+    }
+    return pre::signbit(x.hi()) ? -y : y;
+}
+
+/**
+ * @brief Hyperbolic arccosine.
+ *
+ * @note
+ * Beyond @f$ 1/\varepsilon @f$ of `T`, this is @f$ \log(2x) @f$,
+ * as for `asinh()`.
+ */
+template <typename T>
+inline double_word<T> acosh(const double_word<T>& x)
+{
+    if (x.hi() > 1 / pre::numeric_limits<T>::epsilon()) {
+        return pre::log(x) + numeric_constants<double_word<T>>::M_ln2();
+    }
+    double_word<T> d = x - T(1);
+    return pre::log1p(d + pre::sqrt(d * (d + T(2))));
+}
+
+/**
+ * @brief Hyperbolic arctangent.
+ */
+template <typename T>
+inline double_word<T> atanh(const double_word<T>& x)
+{
+    double_word<T> a = pre::fabs(x);
+    double_word<T> y = pre::log1p(T(2) * a / (T(1) - a)) / T(2);
+    return pre::signbit(x.hi()) ? -y : y;
+}
+
+/**@}*/
+
+/**@}*/
+
+} // namespace pre
+
+#endif // #ifndef PREFORM_DOUBLE_WORD_HPP
@@ -0,0 +1,402 @@
+/* Copyright (c) 2018-20 M. Grady Saunders
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer.
+ *
+ *   2. Redistributions in binary form must reproduce the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer in the documentation and/or other materials
+ *      provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*+-+*/
+#if !DOXYGEN
+#if !(__cplusplus >= 201703L)
+#error "preform/exact_predicates.hpp requires >=C++17"
+#endif // #if !(__cplusplus >= 201703L)
+#endif // #if !DOXYGEN
+#pragma once
+#ifndef PREFORM_EXACT_PREDICATES_HPP
+#define PREFORM_EXACT_PREDICATES_HPP
+
+// for std::is_floating_point
+#include <type_traits>
+
+// for pre::numeric_limits, pre::abs
+#include <preform/math.hpp>
+
+// for pre::multi
+#include <preform/multi.hpp>
+
+// for pre::double_word_two_sum_, pre::double_word_two_prod_, ...
+#include <preform/double_word.hpp>
+
+namespace pre {
+
+/**
+ * @defgroup exact_predicates Exact predicates
+ *
+ * `<preform/exact_predicates.hpp>`
+ *
+ * __C++ version__: >=C++17
+ *
+ * Adaptive exact geometric predicates, after Shewchuk's
+ * _Adaptive Precision Floating-Point Arithmetic and Fast Robust
+ * Geometric Predicates_. Each predicate first evaluates its
+ * determinant in plain floating point with a forward error bound,
+ * which decides all but near-degenerate inputs. Only otherwise does it
+ * evaluate the determinant exactly, as a floating point expansion
+ * (a sum of non-overlapping floats) built from error-free
+ * transformations. Results are exact, provided that no intermediate
+ * overflows or underflows.
+ */
+/**@{*/
+
+#if !DOXYGEN
+
+// Expansion of at most N components, in increasing magnitude.
+template <typename T, int N>
+struct exact_expansion_
+{
+    T v[N];
+    int n = 0;
+};
+
+// Exact difference, as expansion of 1 or 2 components.
+template <typename T>
+__attribute__((always_inline))
+inline exact_expansion_<T, 2> exact_expansion_diff_(T a, T b)
+{
+    exact_expansion_<T, 2> h;
+    T s, e;
+    double_word_two_sum_(a, -b, s, e);
+    if (e != 0) {
+        h.v[h.n++] = e;
+    }
+    h.v[h.n++] = s;
+    return h;
+}
+
+// Negate expansion.
+template <typename T, int N>
+inline void exact_expansion_negate_(exact_expansion_<T, N>& e)
+{
+    for (int k = 0; k < e.n; k++) {
+        e.v[k] = -e.v[k];
+    }
+}
+
+// Sum of expansions, with zero elimination. Shewchuk's
+// fast_expansion_sum_zeroelim(). Requires elen, flen >= 1, and
+// returns hlen >= 1.
+template <typename T>
+inline int exact_expansion_sum_(
+            int elen, const T* e,
+            int flen, const T* f, T* h)
+{
+    int eindex = 0;
+    int findex = 0;
+    int hindex = 0;
+    T enow = e[0];
+    T fnow = f[0];
+    T q;
+    T qnew;
+    T hh;
+    auto next_e = [&]() { if (++eindex < elen) enow = e[eindex]; };
+    auto next_f = [&]() { if (++findex < flen) fnow = f[findex]; };
+    if ((fnow > enow) == (fnow > -enow)) {
+        q = enow; next_e();
+    }
+    else {
+        q = fnow; next_f();
+    }
+    if (eindex < elen && findex < flen) {
+        if ((fnow > enow) == (fnow > -enow)) {
+            double_word_fast_two_sum_(enow, q, qnew, hh); next_e();
+        }
+        else {
+            double_word_fast_two_sum_(fnow, q, qnew, hh); next_f();
+        }
+        q = qnew;
+        if (hh != 0) {
+            h[hindex++] = hh;
+        }
+        while (eindex < elen && findex < flen) {
+            if ((fnow > enow) == (fnow > -enow)) {
+                double_word_two_sum_(q, enow, qnew, hh); next_e();
+            }
+            else {
+                double_word_two_sum_(q, fnow, qnew, hh); next_f();
+            }
+            q = qnew;
+            if (hh != 0) {
+                h[hindex++] = hh;
+            }
+        }
+    }
+    while (eindex < elen) {
+        double_word_two_sum_(q, enow, qnew, hh); next_e();
+        q = qnew;
+        if (hh != 0) {
+            h[hindex++] = hh;
+        }
+    }
+    while (findex < flen) {
+        double_word_two_sum_(q, fnow, qnew, hh); next_f();
+        q = qnew;
+        if (hh != 0) {
+            h[hindex++] = hh;
+        }
+    }
+    if (q != 0 || hindex == 0) {
+        h[hindex++] = q;
+    }
+    return hindex;
+}
+
+// Expansion times scalar, with zero elimination. Shewchuk's
+// scale_expansion_zeroelim(). Requires elen >= 1, and returns
+// hlen >= 1.
+template <typename T>
+inline int exact_expansion_scale_(int elen, const T* e, T b, T* h)
+{
+    int hindex = 0;
+    T q;
+    T hh;
+    double_word_two_prod_(e[0], b, q, hh);
+    if (hh != 0) {
+        h[hindex++] = hh;
+    }
+    for (int eindex = 1; eindex < elen; eindex++) {
+        T p1, p0;
+        T sum;
+        double_word_two_prod_(e[eindex], b, p1, p0);
+        double_word_two_sum_(q, p0, sum, hh);
+        if (hh != 0) {
+            h[hindex++] = hh;
+        }
+        double_word_fast_two_sum_(p1, sum, q, hh);
+        if (hh != 0) {
+            h[hindex++] = hh;
+        }
+    }
+    if (q != 0 || hindex == 0) {
+        h[hindex++] = q;
+    }
+    return hindex;
+}
+
+// Sum of expansions.
+template <typename T, int M, int N>
+inline exact_expansion_<T, M + N> operator+(
+            const exact_expansion_<T, M>& e,
+            const exact_expansion_<T, N>& f)
+{
+    exact_expansion_<T, M + N> h;
+    h.n = exact_expansion_sum_(e.n, e.v, f.n, f.v, h.v);
+    return h;
+}
+
+// Difference of expansions.
+template <typename T, int M, int N>
+inline exact_expansion_<T, M + N> operator-(
+            const exact_expansion_<T, M>& e,
+            exact_expansion_<T, N> f)
+{
+    exact_expansion_negate_(f);
+    return e + f;
+}
+
+// Product of expansions, as sum of each component of f times e.
+template <typename T, int M, int N>
+inline exact_expansion_<T, 2 * M * N> operator*(
+            const exact_expansion_<T, M>& e,
+            const exact_expansion_<T, N>& f)
+{
+    exact_expansion_<T, 2 * M * N> h[2];
+    T tmp[2 * M];
+    int cur = 0;
+    h[cur].n = exact_expansion_scale_(e.n, e.v, f.v[0], h[cur].v);
+    for (int k = 1; k < f.n; k++) {
+        int tmpn = exact_expansion_scale_(e.n, e.v, f.v[k], tmp);
+        h[cur ^ 1].n =
+            exact_expansion_sum_(
+                    h[cur].n, h[cur].v, tmpn, tmp, h[cur ^ 1].v);
+        cur ^= 1;
+    }
+    return h[cur];
+}
+
+// Sign of expansion, that of its largest component.
+template <typename T, int N>
+__attribute__((always_inline))
+inline int exact_expansion_sign_(const exact_expansion_<T, N>& e)
+{
+    T x = e.v[e.n - 1];
+    return x > 0 ? +1 : x < 0 ? -1 : 0;
+}
+
+// Exact orientation sign.
+template <typename T>
+__attribute__((noinline))
+inline int orient2d_exact_(
+            const multi<T, 2>& pa,
+            const multi<T, 2>& pb,
+            const multi<T, 2>& pc)
+{
+    auto acx = exact_expansion_diff_(pa[0], pc[0]);
+    auto acy = exact_expansion_diff_(pa[1], pc[1]);
+    auto bcx = exact_expansion_diff_(pb[0], pc[0]);
+    auto bcy = exact_expansion_diff_(pb[1], pc[1]);
+    return exact_expansion_sign_(acx * bcy - acy * bcx);
+}
+
+// Exact in-circle sign.
+template <typename T>
+__attribute__((noinline))
+inline int incircle_exact_(
+            const multi<T, 2>& pa,
+            const multi<T, 2>& pb,
+            const multi<T, 2>& pc,
+            const multi<T, 2>& pd)
+{
+    auto adx = exact_expansion_diff_(pa[0], pd[0]);
+    auto ady = exact_expansion_diff_(pa[1], pd[1]);
+    auto bdx = exact_expansion_diff_(pb[0], pd[0]);
+    auto bdy = exact_expansion_diff_(pb[1], pd[1]);
+    auto cdx = exact_expansion_diff_(pc[0], pd[0]);
+    auto cdy = exact_expansion_diff_(pc[1], pd[1]);
+    auto alift = adx * adx + ady * ady;
+    auto blift = bdx * bdx + bdy * bdy;
+    auto clift = cdx * cdx + cdy * cdy;
+    return exact_expansion_sign_(
+           alift * (bdx * cdy - cdx * bdy) +
+           blift * (cdx * ady - adx * cdy) +
+           clift * (adx * bdy - bdx * ady));
+}
+
+#endif // #if !DOXYGEN
+
+/**
+ * @brief Orientation sign.
+ *
+ * Exact sign of
+ * @f[
+ *      \det
+ *      \begin{bmatrix}
+ *          a_x - c_x & a_y - c_y
+ *       \\ b_x - c_x & b_y - c_y
+ *      \end{bmatrix},
+ * @f]
+ * the signed area of the parallelogram spanned by the triangle
+ * @f$ (\mathbf{a}, \mathbf{b}, \mathbf{c}) @f$.
+ *
+ * @returns
+ * Positive if counter-clockwise, negative if clockwise, and
+ * zero if exactly collinear.
+ */
+template <typename T>
+inline int orient2d_sign(
+            const multi<T, 2>& pa,
+            const multi<T, 2>& pb,
+            const multi<T, 2>& pc)
+{
+    static_assert(
+        std::is_floating_point<T>::value,
+        "T must be floating point");
+
+    // Filter, with Shewchuk's bound.
+    constexpr T u = pre::numeric_limits<T>::epsilon() / 2;
+    constexpr T errbound = (3 + 16 * u) * u;
+    T detleft = (pa[0] - pc[0]) * (pb[1] - pc[1]);
+    T detright = (pa[1] - pc[1]) * (pb[0] - pc[0]);
+    T det = detleft - detright;
+    T err = errbound * (pre::abs(detleft) + pre::abs(detright));
+    if (det > err) {
+        return +1;
+    }
+    if (det < -err) {
+        return -1;
+    }
+    return orient2d_exact_(pa, pb, pc);
+}
+
+/**
+ * @brief In-circle sign.
+ *
+ * Exact sign of
+ * @f[
+ *      \det
+ *      \begin{bmatrix}
+ *          a_x - d_x & a_y - d_y & \|\mathbf{a} - \mathbf{d}\|^2
+ *       \\ b_x - d_x & b_y - d_y & \|\mathbf{b} - \mathbf{d}\|^2
+ *       \\ c_x - d_x & c_y - d_y & \|\mathbf{c} - \mathbf{d}\|^2
+ *      \end{bmatrix}.
+ * @f]
+ *
+ * @returns
+ * For counter-clockwise @f$ (\mathbf{a}, \mathbf{b}, \mathbf{c}) @f$,
+ * positive if @f$ \mathbf{d} @f$ is inside the circumcircle, negative
+ * if outside, and zero if exactly co-circular. Reversed for clockwise.
+ */
+template <typename T>
+inline int incircle_sign(
+            const multi<T, 2>& pa,
+            const multi<T, 2>& pb,
+            const multi<T, 2>& pc,
+            const multi<T, 2>& pd)
+{
+    static_assert(
+        std::is_floating_point<T>::value,
+        "T must be floating point");
+
+    // Filter, with Shewchuk's bound.
+    constexpr T u = pre::numeric_limits<T>::epsilon() / 2;
+    constexpr T errbound = (10 + 96 * u) * u;
+    T adx = pa[0] - pd[0], ady = pa[1] - pd[1];
+    T bdx = pb[0] - pd[0], bdy = pb[1] - pd[1];
+    T cdx = pc[0] - pd[0], cdy = pc[1] - pd[1];
+    T bdxcdy = bdx * cdy, cdxbdy = cdx * bdy;
+    T cdxady = cdx * ady, adxcdy = adx * cdy;
+    T adxbdy = adx * bdy, bdxady = bdx * ady;
+    T alift = adx * adx + ady * ady;
+    T blift = bdx * bdx + bdy * bdy;
+    T clift = cdx * cdx + cdy * cdy;
+    T det =
+        alift * (bdxcdy - cdxbdy) +
+        blift * (cdxady - adxcdy) +
+        clift * (adxbdy - bdxady);
+    T err = errbound * (
+        (pre::abs(bdxcdy) + pre::abs(cdxbdy)) * alift +
+        (pre::abs(cdxady) + pre::abs(adxcdy)) * blift +
+        (pre::abs(adxbdy) + pre::abs(bdxady)) * clift);
+    if (det > err) {
+        return +1;
+    }
+    if (det < -err) {
+        return -1;
+    }
+    return incircle_exact_(pa, pb, pc, pd);
+}
+
+/**@}*/
+
+} // namespace pre
+
+#endif // #ifndef PREFORM_EXACT_PREDICATES_HPP
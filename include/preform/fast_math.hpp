@@ -0,0 +1,592 @@
+/* Copyright (c) 2018-20 M. Grady Saunders
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer.
+ *
+ *   2. Redistributions in binary form must reproduce the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer in the documentation and/or other materials
+ *      provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*+-+*/
+#if !DOXYGEN
+#if !(__cplusplus >= 201703L)
+#error "preform/fast_math.hpp requires >=C++17"
+#endif // #if !(__cplusplus >= 201703L)
+#endif // #if !DOXYGEN
+#pragma once
+#ifndef PREFORM_FAST_MATH_HPP
+#define PREFORM_FAST_MATH_HPP
+
+// for std::memcpy
+#include <cstring>
+
+// for std::uint32_t, std::uint64_t
+#include <cstdint>
+
+// for std::enable_if, std::is_floating_point
+#include <type_traits>
+
+// for pre::numeric_limits, pre::numeric_constants, pre::exp, ...
+#include <preform/math.hpp>
+
+namespace pre {
+
+/**
+ * @defgroup fast_math Fast math
+ *
+ * `<preform/fast_math.hpp>`
+ *
+ * __C++ version__: >=C++17
+ *
+ * Polynomial and rational approximations of common functions, for
+ * hot paths that tolerate about 1e-6 relative error. Each function
+ * is branch-free, selecting between cases with conditional
+ * expressions only, so loops over arrays of arguments vectorize
+ * without special compiler flags.
+ *
+ * Errors are measured against the `<cmath>` function in double
+ * precision, and quoted in float ulps over the whole domain. The
+ * approximations are the same in any precision, so they are no
+ * more accurate for double arguments.
+ *
+ * Call `fast_exp()` and friends directly, or take a policy template
+ * parameter, either `precise_math` or `fast_math`, and call
+ * `Tmath::exp()` and friends.
+ */
+/**@{*/
+
+#if !DOXYGEN
+
+namespace detail {
+
+template <typename T>
+struct fast_math_bits;
+
+template <>
+struct fast_math_bits<float>
+{
+    typedef std::uint32_t uint_type;
+    static constexpr int mantissa_bits = 23;
+    static constexpr int exponent_bias = 127;
+    static constexpr uint_type exponent_mask = 0xff;
+};
+
+template <>
+struct fast_math_bits<double>
+{
+    typedef std::uint64_t uint_type;
+    static constexpr int mantissa_bits = 52;
+    static constexpr int exponent_bias = 1023;
+    static constexpr uint_type exponent_mask = 0x7ff;
+};
+
+// Float to bits.
+template <typename T>
+__attribute__((always_inline))
+inline typename fast_math_bits<T>::uint_type fast_math_to_bits(T x)
+{
+    typename fast_math_bits<T>::uint_type u;
+    std::memcpy(&u, &x, sizeof(T));
+    return u;
+}
+
+// Bits to float.
+template <typename T>
+__attribute__((always_inline))
+inline T fast_math_from_bits(typename fast_math_bits<T>::uint_type u)
+{
+    T x;
+    std::memcpy(&x, &u, sizeof(T));
+    return x;
+}
+
+// Power of 2, for exponent in normal range.
+template <typename T>
+__attribute__((always_inline))
+inline T fast_math_pow2(int n)
+{
+    typedef fast_math_bits<T> bits;
+    typedef typename bits::uint_type uint_type;
+    return fast_math_from_bits<T>(
+           uint_type(n + bits::exponent_bias) << bits::mantissa_bits);
+}
+
+// Square root, for finite non-negative argument. Unlike sqrt(),
+// this doesn't set errno, so it vectorizes without -fno-math-errno.
+template <typename T>
+__attribute__((always_inline))
+inline T fast_math_sqrt(T x)
+{
+    typedef fast_math_bits<T> bits;
+    typedef typename bits::uint_type uint_type;
+
+    // Initial inverse square root guess, then 2 Newton steps.
+    constexpr uint_type magic =
+        std::is_same<T, float>::value ?
+        uint_type(0x5f3759dfUL) :
+        uint_type(0x5fe6eb50c7b537a9ULL);
+    T y = fast_math_from_bits<T>(magic - (fast_math_to_bits(x) >> 1));
+    T h = x * T(0.5);
+    y = y * (T(1.5) - h * y * y);
+    y = y * (T(1.5) - h * y * y);
+
+    // Square root, then 1 Newton step on the residual.
+    T r = x * y;
+    return r + (x - r * r) * (T(0.5) * y);
+}
+
+} // namespace detail
+
+#endif // #if !DOXYGEN
+
+/**
+ * @brief Fast exponential.
+ *
+ * Reduces to @f$ e^x = 2^n e^z @f$ with @f$ |z| \le \log(2)/2 @f$,
+ * then evaluates a degree 6 Taylor polynomial in @f$ z @f$.
+ *
+ * - Max error 3 ulp for results in the normal range.
+ * - Overflows to infinity and underflows to zero like `exp()`.
+ * - Propagates NaN.
+ */
+template <typename T>
+__attribute__((always_inline))
+inline std::enable_if_t<
+       std::is_floating_point<T>::value, T> fast_exp(T x)
+{
+    // Clamp, so the exponent is in range, replacing NaN.
+    constexpr bool is_float = std::is_same<T, float>::value;
+    constexpr T xmin = is_float ? T(-104) : T(-746);
+    constexpr T xmax = is_float ? T(+89) : T(+710);
+    T xc = x > xmin ? x : xmin;
+    xc = xc < xmax ? xc : xmax;
+
+    // Reduce, with Cody-Waite split of log(2).
+    T fn = pre::nearbyint(xc * pre::numeric_constants<T>::M_log2e());
+    int n = int(fn);
+    T z = xc - fn * T(0.693359375);
+    z = z - fn * T(-2.12194440e-4);
+
+    // Approximate exp(z).
+    T p = T(1) / 720;
+    p = p * z + T(1) / 120;
+    p = p * z + T(1) / 24;
+    p = p * z + T(1) / 6;
+    p = p * z + T(1) / 2;
+    p = p * z + T(1);
+    p = p * z + T(1);
+
+    // Scale in two steps, so that neither factor leaves the
+    // normal range.
+    int n1 = n / 2;
+    int n2 = n - n1;
+    p = p * detail::fast_math_pow2<T>(n1);
+    p = p * detail::fast_math_pow2<T>(n2);
+    return x == x ? p : x;
+}
+
+/**
+ * @brief Fast natural logarithm.
+ *
+ * Splits @f$ x = 2^n m @f$ with @f$ m \in [1/\sqrt{2}, \sqrt{2}) @f$,
+ * then evaluates @f$ \log(m) = 2 \operatorname{atanh}(s) @f$ for
+ * @f$ s = (m - 1)/(m + 1) @f$ by an odd degree 9 Taylor polynomial.
+ *
+ * - Max error 3 ulp, including subnormal arguments.
+ * - Returns @f$ -\infty @f$ for zero, @f$ +\infty @f$ for
+ *   @f$ +\infty @f$, and NaN for negative or NaN arguments.
+ */
+template <typename T>
+__attribute__((always_inline))
+inline std::enable_if_t<
+       std::is_floating_point<T>::value, T> fast_log(T x)
+{
+    typedef detail::fast_math_bits<T> bits;
+    typedef typename bits::uint_type uint_type;
+    typedef std::make_signed_t<uint_type> int_type;
+    constexpr uint_type mantissa_mask =
+             (uint_type(1) << bits::mantissa_bits) - 1;
+
+    // Split into biased exponent and significand, with implicit
+    // bit unless subnormal.
+    uint_type u = detail::fast_math_to_bits(x);
+    uint_type e = (u >> bits::mantissa_bits) & bits::exponent_mask;
+    uint_type k = u & mantissa_mask;
+    k = e == 0 ? k : k | (uint_type(1) << bits::mantissa_bits);
+    e = e == 0 ? 1 : e;
+
+    // Convert significand to floating point, which is exact and
+    // normalizes subnormals. Doing so unconditionally, with integer
+    // selects only, avoids conditional floating point arithmetic,
+    // which would block if-conversion under -ftrapping-math.
+    u = detail::fast_math_to_bits(T(int_type(k)));
+    int n = int(u >> bits::mantissa_bits) + int(e) -
+            2 * bits::exponent_bias - bits::mantissa_bits;
+
+    // Mantissa in [1, 2).
+    u = u & mantissa_mask;
+    u = u | (uint_type(bits::exponent_bias) << bits::mantissa_bits);
+
+    // Center mantissa on 1, halving by decrementing exponent bits.
+    bool is_large =
+        detail::fast_math_from_bits<T>(u) >
+        pre::numeric_constants<T>::M_sqrt2();
+    u = is_large ? u - (uint_type(1) << bits::mantissa_bits) : u;
+    n = is_large ? n + 1 : n;
+    T m = detail::fast_math_from_bits<T>(u);
+
+    // Approximate log(m).
+    T s = (m - 1) / (m + 1);
+    T s2 = s * s;
+    T p = T(2) / 9;
+    p = p * s2 + T(2) / 7;
+    p = p * s2 + T(2) / 5;
+    p = p * s2 + T(2) / 3;
+    p = p * s2 + T(2);
+    p = p * s + T(n) * pre::numeric_constants<T>::M_ln2();
+
+    // Special cases, added so that p is used unconditionally.
+    T q = x > 0 ? T(0) : x == 0 ?
+        -pre::numeric_limits<T>::infinity() :
+         pre::numeric_limits<T>::quiet_NaN();
+    q = x == pre::numeric_limits<T>::infinity() ? x : q;
+    return p + q;
+}
+
+/**
+ * @brief Fast power.
+ *
+ * Evaluates `fast_exp(y * fast_log(x))`, so relative error grows with
+ * @f$ |y \log(x)| @f$, by about 1.5 ulp per unit.
+ *
+ * - Defined for non-negative @f$ x @f$ only, returning NaN for
+ *   negative @f$ x @f$ regardless of @f$ y @f$.
+ * - Returns 1 if @f$ y = 0 @f$.
+ */
+template <typename T>
+__attribute__((always_inline))
+inline std::enable_if_t<
+       std::is_floating_point<T>::value, T> fast_pow(T x, T y)
+{
+    T p = pre::fast_exp(y * pre::fast_log(x));
+    return y == 0 ? T(1) : p;
+}
+
+/**
+ * @brief Fast error function.
+ *
+ * For @f$ |x| < 1/2 @f$, evaluates an odd degree 11 Taylor polynomial.
+ * Otherwise, evaluates the rational approximation 7.1.26 of
+ * Abramowitz and Stegun with `fast_exp()`.
+ *
+ * - Max error 6 ulp.
+ * - Propagates NaN.
+ */
+template <typename T>
+__attribute__((always_inline))
+inline std::enable_if_t<
+       std::is_floating_point<T>::value, T> fast_erf(T x)
+{
+    T a = pre::fabs(x);
+    T x2 = x * x;
+
+    // Small, Taylor polynomial.
+    T p0 = T(-1.0 / 1320);
+    p0 = p0 * x2 + T(+1.0 / 216);
+    p0 = p0 * x2 + T(-1.0 / 42);
+    p0 = p0 * x2 + T(+1.0 / 10);
+    p0 = p0 * x2 + T(-1.0 / 3);
+    p0 = p0 * x2 + T(1);
+    p0 = p0 * x * pre::numeric_constants<T>::M_2_sqrtpi();
+
+    // Large, Abramowitz and Stegun.
+    T t = 1 / (1 + T(0.3275911) * a);
+    T p1 = T(+1.061405429);
+    p1 = p1 * t + T(-1.453152027);
+    p1 = p1 * t + T(+1.421413741);
+    p1 = p1 * t + T(-0.284496736);
+    p1 = p1 * t + T(+0.254829592);
+    p1 = 1 - p1 * t * pre::fast_exp(-x2);
+    p1 = x < 0 ? -p1 : p1;
+    return a < T(0.5) ? p0 : p1;
+}
+
+/**
+ * @brief Fast error function inverse.
+ *
+ * Evaluates the single precision approximation of Giles, as in
+ * `erfinv()`, except that both branches are evaluated and
+ * selected, and the logarithm is `fast_log()`.
+ *
+ * - Max error 3 ulp on @f$ (-1, 1) @f$.
+ * - Returns @f$ \pm\infty @f$ for @f$ \pm 1 @f$, and NaN for
+ *   @f$ |y| > 1 @f$ or NaN.
+ */
+template <typename T>
+__attribute__((always_inline))
+inline std::enable_if_t<
+       std::is_floating_point<T>::value, T> fast_erfinv(T y)
+{
+    T w = -pre::fast_log((1 - y) * (1 + y));
+
+    // Central.
+    T w0 = w - T(2.5);
+    T p0 = T(+2.81022636e-08);
+    p0 = p0 * w0 + T(+3.43273939e-7);
+    p0 = p0 * w0 + T(-3.52338770e-6);
+    p0 = p0 * w0 + T(-4.39150654e-6);
+    p0 = p0 * w0 + T(+2.18580870e-4);
+    p0 = p0 * w0 + T(-1.25372503e-3);
+    p0 = p0 * w0 + T(-4.17768164e-3);
+    p0 = p0 * w0 + T(+2.46640727e-1);
+    p0 = p0 * w0 + T(+1.50140941);
+
+    // Tails.
+    T w1 = detail::fast_math_sqrt(w) - 3;
+    T p1 = T(-2.00214257e-4);
+    p1 = p1 * w1 + T(+1.00950558e-4);
+    p1 = p1 * w1 + T(+1.34934322e-3);
+    p1 = p1 * w1 + T(-3.67342844e-3);
+    p1 = p1 * w1 + T(+5.73950773e-3);
+    p1 = p1 * w1 + T(-7.62246130e-3);
+    p1 = p1 * w1 + T(+9.43887047e-3);
+    p1 = p1 * w1 + T(+1.00167406);
+    p1 = p1 * w1 + T(+2.83297682);
+
+    T p = (w < T(5) ? p0 : p1) * y;
+    return pre::fabs(y) == 1 ?
+           y * pre::numeric_limits<T>::infinity() : p;
+}
+
+/**
+ * @brief Fast arc tangent of quotient.
+ *
+ * Reduces to @f$ \operatorname{atan}(a) @f$ for @f$ a \in [0, 1] @f$,
+ * then evaluates the polynomial approximation 4.4.49 of Abramowitz
+ * and Stegun.
+ *
+ * - Max error 3 ulp, or @f$ 2 \times 10^{-8} @f$ absolute.
+ * - Returns NaN if both arguments are infinite, and zero if
+ *   both are zero, with quadrants following the signs as in
+ *   `atan2()`.
+ */
+template <typename T>
+__attribute__((always_inline))
+inline std::enable_if_t<
+       std::is_floating_point<T>::value, T> fast_atan2(T y, T x)
+{
+    T ay = pre::fabs(y);
+    T ax = pre::fabs(x);
+    T amax = ax > ay ? ax : ay;
+    T amin = ax > ay ? ay : ax;
+    T a = amin / (amax > 0 ? amax : T(1));
+    T a2 = a * a;
+    T p = T(+0.0028662257);
+    p = p * a2 + T(-0.0161657367);
+    p = p * a2 + T(+0.0429096138);
+    p = p * a2 + T(-0.0752896400);
+    p = p * a2 + T(+0.1065626393);
+    p = p * a2 + T(-0.1420889944);
+    p = p * a2 + T(+0.1999355085);
+    p = p * a2 + T(-0.3333314528);
+    p = p * a2 + T(1);
+    p = p * a;
+    p = ay > ax ? pre::numeric_constants<T>::M_pi_2() - p : p;
+    p = pre::signbit(x) ? pre::numeric_constants<T>::M_pi() - p : p;
+    return pre::copysign(p, y);
+}
+
+/**
+ * @brief Fast arc cosine.
+ *
+ * Evaluates @f$ \sqrt{1 - |x|} P(|x|) @f$, reflected for negative
+ * @f$ x @f$, where @f$ P @f$ is the polynomial approximation 4.4.46
+ * of Abramowitz and Stegun.
+ *
+ * - Max error 3 ulp, or @f$ 2 \times 10^{-8} @f$ absolute.
+ * - Returns NaN for @f$ |x| > 1 @f$ or NaN.
+ */
+template <typename T>
+__attribute__((always_inline))
+inline std::enable_if_t<
+       std::is_floating_point<T>::value, T> fast_acos(T x)
+{
+    T a = pre::fabs(x);
+    T p = T(-0.0012624911);
+    p = p * a + T(+0.0066700901);
+    p = p * a + T(-0.0170881256);
+    p = p * a + T(+0.0308918810);
+    p = p * a + T(-0.0501743046);
+    p = p * a + T(+0.0889789874);
+    p = p * a + T(-0.2145988016);
+    p = p * a + T(+1.5707963050);
+    p = p * detail::fast_math_sqrt(1 - a);
+    p = x < 0 ? pre::numeric_constants<T>::M_pi() - p : p;
+    return a > 1 ? pre::numeric_limits<T>::quiet_NaN() : p;
+}
+
+/**
+ * @brief Precise math policy.
+ *
+ * Forwards to the wrappers in `<preform/math.hpp>`.
+ */
+struct precise_math
+{
+    /**
+     * @brief Exponential.
+     */
+    template <typename T>
+    static T exp(T x)
+    {
+        return pre::exp(x);
+    }
+
+    /**
+     * @brief Natural logarithm.
+     */
+    template <typename T>
+    static T log(T x)
+    {
+        return pre::log(x);
+    }
+
+    /**
+     * @brief Power.
+     */
+    template <typename T>
+    static T pow(T x, T y)
+    {
+        return pre::pow(x, y);
+    }
+
+    /**
+     * @brief Error function.
+     */
+    template <typename T>
+    static T erf(T x)
+    {
+        return pre::erf(x);
+    }
+
+    /**
+     * @brief Error function inverse.
+     */
+    template <typename T>
+    static T erfinv(T y)
+    {
+        return pre::erfinv(y);
+    }
+
+    /**
+     * @brief Arc tangent of quotient.
+     */
+    template <typename T>
+    static T atan2(T y, T x)
+    {
+        return pre::atan2(y, x);
+    }
+
+    /**
+     * @brief Arc cosine.
+     */
+    template <typename T>
+    static T acos(T x)
+    {
+        return pre::acos(x);
+    }
+};
+
+/**
+ * @brief Fast math policy.
+ *
+ * Forwards to the approximations above.
+ */
+struct fast_math
+{
+    /**
+     * @brief Exponential.
+     */
+    template <typename T>
+    static T exp(T x)
+    {
+        return pre::fast_exp(x);
+    }
+
+    /**
+     * @brief Natural logarithm.
+     */
+    template <typename T>
+    static T log(T x)
+    {
+        return pre::fast_log(x);
+    }
+
+    /**
+     * @brief Power.
+     */
+    template <typename T>
+    static T pow(T x, T y)
+    {
+        return pre::fast_pow(x, y);
+    }
+
+    /**
+     * @brief Error function.
+     */
+    template <typename T>
+    static T erf(T x)
+    {
+        return pre::fast_erf(x);
+    }
+
+    /**
+     * @brief Error function inverse.
+     */
+    template <typename T>
+    static T erfinv(T y)
+    {
+        return pre::fast_erfinv(y);
+    }
+
+    /**
+     * @brief Arc tangent of quotient.
+     */
+    template <typename T>
+    static T atan2(T y, T x)
+    {
+        return pre::fast_atan2(y, x);
+    }
+
+    /**
+     * @brief Arc cosine.
+     */
+    template <typename T>
+    static T acos(T x)
+    {
+        return pre::fast_acos(x);
+    }
+};
+
+/**@}*/
+
+} // namespace pre
+
+#endif // #ifndef PREFORM_FAST_MATH_HPP
@@ -0,0 +1,535 @@
+/* Copyright (c) 2018-20 M. Grady Saunders
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer.
+ *
+ *   2. Redistributions in binary form must reproduce the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer in the documentation and/or other materials
+ *      provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*+-+*/
+#if !DOXYGEN
+#if !(__cplusplus >= 201703L)
+#error "preform/film2.hpp requires >=C++17"
+#endif // #if !(__cplusplus >= 201703L)
+#endif // #if !DOXYGEN
+#pragma once
+#ifndef PREFORM_FILM2_HPP
+#define PREFORM_FILM2_HPP
+
+// for std::min, std::max
+#include <algorithm>
+
+// for std::mutex, std::lock_guard
+#include <mutex>
+
+// for std::forward
+#include <utility>
+
+// for std::vector
+#include <vector>
+
+// for pre::fabs, pre::lerp
+#include <preform/math.hpp>
+
+// for pre::multi
+#include <preform/multi.hpp>
+
+// for pre::multi wrappers
+#include <preform/multi_misc_float.hpp>
+
+// for pre::image2
+#include <preform/image2.hpp>
+
+namespace pre {
+
+/**
+ * @defgroup film2 Film (2-dimensional)
+ *
+ * `<preform/film2.hpp>`
+ *
+ * __C++ version__: >=C++17
+ *
+ * Parallel sample reconstruction. Each thread splats samples with
+ * `image2::reconstruct()` into a private tile, padded by an apron of
+ * the filter radius, so that splatting needs no synchronization.
+ * Finished tiles merge into the film under a lock, which is cheap
+ * relative to splatting as it happens once per tile. The film keeps
+ * the filter weight sum in an extra channel, and `resolve()`
+ * normalizes by it.
+ *
+ * @note
+ * With `PREFORM_IMAGE2_USE_THREADS` falsy, `for_each_tile()` is only
+ * available serially.
+ */
+/**@{*/
+
+/**
+ * @brief Film (2-dimensional).
+ *
+ * @tparam Tfloat
+ * Float type.
+ *
+ * @tparam N
+ * Channels.
+ *
+ * @tparam Tfilt
+ * Filter type, with radii `r` and `operator()` taking an offset
+ * `multi<Tfloat, 2>` from the pixel center, such as `box_filter2`,
+ * `triangle_filter2`, or `mitchell_filter2`.
+ */
+template <
+    typename Tfloat,
+    std::size_t N,
+    typename Tfilt
+    >
+class film2
+{
+public:
+
+    // Sanity check.
+    static_assert(
+        std::is_floating_point<Tfloat>::value,
+        "Tfloat must be floating point");
+
+    /**
+     * @brief Float type.
+     */
+    typedef Tfloat float_type;
+
+    /**
+     * @brief Size type.
+     */
+    typedef std::size_t size_type;
+
+    /**
+     * @brief Value type.
+     */
+    typedef multi<float_type, N> value_type;
+
+    /**
+     * @brief Accumulation image type, with weight sum in last channel.
+     */
+    typedef image2<float_type, float_type, N + 1> image_type;
+
+    /**
+     * @brief Filter table cells, per radius per dimension.
+     */
+    static constexpr int table_size = 32;
+
+public:
+
+    /**
+     * @brief Tile.
+     *
+     * Private accumulation image over pixels `[from, to)` of the film,
+     * padded by the filter apron. A tile is not thread-safe, but
+     * distinct tiles need no synchronization.
+     */
+    class tile
+    {
+    public:
+
+        /**
+         * @brief Add sample.
+         *
+         * @param[in] val
+         * Value.
+         *
+         * @param[in] loc
+         * Location in film pixel coordinates. Samples outside the
+         * tile contribute only to pixels inside its apron.
+         */
+        void add(const value_type& val, multi<float_type, 2> loc)
+        {
+            multi<float_type, N + 1> v;
+            for (size_type k = 0; k < N; k++) {
+                v[k] = val[k];
+            }
+            v[N] = 1;
+            loc -= multi<float_type, 2>(origin_);
+            image_.reconstruct(v, loc, film_->filt_.r,
+                [&](const multi<float_type, 2>& off) {
+                    return film_->weight_(off);
+                });
+        }
+
+        /**
+         * @brief Pixel range begin.
+         */
+        const multi<size_type, 2>& from() const noexcept
+        {
+            return from_;
+        }
+
+        /**
+         * @brief Pixel range end.
+         */
+        const multi<size_type, 2>& to() const noexcept
+        {
+            return to_;
+        }
+
+    private:
+
+        /**
+         * @brief Film.
+         */
+        const film2* film_ = nullptr;
+
+        /**
+         * @brief Pixel range begin.
+         */
+        multi<size_type, 2> from_ = {};
+
+        /**
+         * @brief Pixel range end.
+         */
+        multi<size_type, 2> to_ = {};
+
+        /**
+         * @brief Film pixel of tile image pixel 0, including apron.
+         */
+        multi<int, 2> origin_ = {};
+
+        /**
+         * @brief Tile image.
+         */
+        image_type image_;
+
+        // Friend film.
+        friend class film2;
+    };
+
+public:
+
+    /**
+     * @name Constructors
+     */
+    /**@{*/
+
+    /**
+     * @brief Default constructor.
+     */
+    film2() = default;
+
+    /**
+     * @brief Constructor.
+     *
+     * @param[in] size
+     * Size in pixels.
+     *
+     * @param[in] filt
+     * Filter.
+     *
+     * @param[in] tabulate
+     * Tabulate filter? If so, splatting interpolates the filter
+     * bilinearly in a table with `table_size` cells per radius per
+     * dimension, over the positive quadrant, instead of calling it
+     * per pixel. This assumes the filter is even in each dimension.
+     */
+    film2(
+        multi<size_type, 2> size,
+        const Tfilt& filt = Tfilt(),
+        bool tabulate = false) : filt_(filt)
+    {
+        image_.resize(size);
+        apron_ = fastceil(filt_.r);
+        if (tabulate) {
+            table_.resize((table_size + 1) * (table_size + 1));
+            for (int i = 0; i <= table_size; i++)
+            for (int j = 0; j <= table_size; j++) {
+                multi<float_type, 2> off = {
+                    float_type(i) / table_size,
+                    float_type(j) / table_size
+                };
+                table_[i * (table_size + 1) + j] = filt_(off * filt_.r);
+            }
+        }
+    }
+
+    /**@}*/
+
+public:
+
+    /**
+     * @name Accessors
+     */
+    /**@{*/
+
+    /**
+     * @brief Size in pixels.
+     */
+    const multi<size_type, 2>& size() const noexcept
+    {
+        return image_.user_size();
+    }
+
+    /**
+     * @brief Accumulation image, with weight sum in last channel.
+     */
+    const image_type& image() const noexcept
+    {
+        return image_;
+    }
+
+    /**
+     * @brief Filter.
+     */
+    const Tfilt& filter() const noexcept
+    {
+        return filt_;
+    }
+
+    /**@}*/
+
+public:
+
+    /**
+     * @name Reconstruction
+     */
+    /**@{*/
+
+    /**
+     * @brief Make tile over pixels `[from, to)`.
+     */
+    tile make_tile(multi<size_type, 2> from, multi<size_type, 2> to) const
+    {
+        tile t;
+        t.film_ = this;
+        t.from_ = from;
+        t.to_ = to;
+        t.origin_ = multi<int, 2>(from) - apron_;
+        t.image_.resize(multi<size_type, 2>(to - from) +
+                        multi<size_type, 2>(2 * apron_));
+        return t;
+    }
+
+    /**
+     * @brief Merge tile, including apron. Thread-safe.
+     */
+    void merge(const tile& t)
+    {
+        // Overlap of tile image with film.
+        multi<int, 2> count = multi<int, 2>(t.image_.user_size());
+        multi<int, 2> imin = {};
+        multi<int, 2> imax = count;
+        for (int l = 0; l < 2; l++) {
+            imin[l] = std::max(imin[l], -t.origin_[l]);
+            imax[l] = std::min(imax[l], int(size()[l]) - t.origin_[l]);
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (int i = imin[0]; i < imax[0]; i++)
+        for (int j = imin[1]; j < imax[1]; j++) {
+            image_(i + t.origin_[0], j + t.origin_[1]) += t.image_(i, j);
+        }
+    }
+
+    /**
+     * @brief Add sample directly. Not thread-safe.
+     */
+    void add(const value_type& val, multi<float_type, 2> loc)
+    {
+        multi<float_type, N + 1> v;
+        for (size_type k = 0; k < N; k++) {
+            v[k] = val[k];
+        }
+        v[N] = 1;
+        image_.reconstruct(v, loc, filt_.r,
+            [&](const multi<float_type, 2>& off) {
+                return weight_(off);
+            });
+    }
+
+    /**
+     * @brief For each tile, serially.
+     *
+     * Partitions the film into tiles of `tile_count` pixels per
+     * dimension, calls `func(tile&)` for each, and merges the result.
+     */
+    template <typename Tfunc>
+    void for_each_tile(multi<size_type, 2> tile_count, Tfunc&& func)
+    {
+        for_each_tile_(nullptr, tile_count, std::forward<Tfunc>(func));
+    }
+
+#if PREFORM_IMAGE2_USE_THREADS || DOXYGEN
+
+    /**
+     * @brief For each tile, in parallel.
+     *
+     * Same as `for_each_tile()`, with tiles split across `pool`, so
+     * `func` must be safe to call concurrently on distinct tiles.
+     */
+    template <typename Tfunc>
+    void for_each_tile(
+            thread_pool& pool,
+            multi<size_type, 2> tile_count, Tfunc&& func)
+    {
+        for_each_tile_(&pool, tile_count, std::forward<Tfunc>(func));
+    }
+
+#endif // #if PREFORM_IMAGE2_USE_THREADS || DOXYGEN
+
+    /**
+     * @brief Resolve into image, normalizing by filter weight sum.
+     *
+     * Pixels with zero weight sum resolve to zero.
+     */
+    template <
+        typename T,
+        typename Talloc,
+        std::size_t Ntile
+        >
+    void resolve(image2<float_type, T, N, Talloc, Ntile>& out) const
+    {
+        out.resize(size());
+        for (size_type i = 0; i < size()[0]; i++)
+        for (size_type j = 0; j < size()[1]; j++) {
+            const multi<float_type, N + 1>& v = image_(i, j);
+            multi<float_type, N> res = {};
+            if (v[N] != 0) {
+                for (size_type k = 0; k < N; k++) {
+                    res[k] = v[k] / v[N];
+                }
+            }
+            out(i, j) = image_storage_traits<T>::
+                        template encode<float_type>(res);
+        }
+    }
+
+    /**
+     * @brief Clear accumulation, keeping size.
+     */
+    void clear()
+    {
+        multi<size_type, 2> count = size();
+        image_.clear();
+        image_.resize(count);
+    }
+
+    /**@}*/
+
+private:
+
+    /**
+     * @brief Filter.
+     */
+    Tfilt filt_ = Tfilt();
+
+    /**
+     * @brief Filter apron in pixels.
+     */
+    multi<int, 2> apron_ = {};
+
+    /**
+     * @brief Filter table over positive quadrant, if any, with
+     * `table_size + 1` nodes per dimension.
+     */
+    std::vector<float_type> table_;
+
+    /**
+     * @brief Accumulation image.
+     */
+    image_type image_;
+
+    /**
+     * @brief Merge mutex.
+     */
+    std::mutex mutex_;
+
+#if !DOXYGEN
+
+    /**
+     * @brief Filter weight at offset from pixel center.
+     */
+    float_type weight_(const multi<float_type, 2>& off) const
+    {
+        if (table_.empty()) {
+            return filt_(off);
+        }
+        multi<int, 2> ind;
+        multi<float_type, 2> frac;
+        for (int l = 0; l < 2; l++) {
+            float_type u = pre::fabs(off[l]) / filt_.r[l];
+            if (!(u < 1)) {
+                return 0;
+            }
+            u *= table_size;
+            ind[l] = std::min(int(u), table_size - 1);
+            frac[l] = u - ind[l];
+        }
+        const float_type* ptr =
+            &table_[ind[0] * (table_size + 1) + ind[1]];
+        return pre::lerp(frac[0],
+               pre::lerp(frac[1], ptr[0], ptr[1]),
+               pre::lerp(frac[1], ptr[table_size + 1],
+                                  ptr[table_size + 2]));
+    }
+
+    /**
+     * @brief For each tile.
+     */
+    template <typename Tfunc>
+    void for_each_tile_(
+            thread_pool* pool,
+            multi<size_type, 2> tile_count, Tfunc&& func)
+    {
+        multi<size_type, 2> count;
+        for (int l = 0; l < 2; l++) {
+            tile_count[l] = std::max<size_type>(tile_count[l], 1);
+            count[l] = (size()[l] + tile_count[l] - 1) / tile_count[l];
+        }
+        auto tile_func = [&](size_type index) {
+            multi<size_type, 2> from = {
+                (index / count[1]) * tile_count[0],
+                (index % count[1]) * tile_count[1]
+            };
+            multi<size_type, 2> to = {
+                std::min(from[0] + tile_count[0], size()[0]),
+                std::min(from[1] + tile_count[1], size()[1])
+            };
+            tile t = make_tile(from, to);
+            func(t);
+            merge(t);
+        };
+        #if PREFORM_IMAGE2_USE_THREADS
+        if (pool && count.prod() > 1) {
+            pool->parallel_for(
+                    size_type(0), count.prod(), size_type(1), tile_func);
+            return;
+        }
+        #else
+        (void) pool;
+        #endif // #if PREFORM_IMAGE2_USE_THREADS
+        for (size_type index = 0; index < count.prod(); index++) {
+            tile_func(index);
+        }
+    }
+
+#endif // #if !DOXYGEN
+};
+
+/**@}*/
+
+} // namespace pre
+
+#endif // #ifndef PREFORM_FILM2_HPP
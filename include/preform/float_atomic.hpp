@@ -35,15 +35,41 @@
 #ifndef PREFORM_FLOAT_ATOMIC_HPP
 #define PREFORM_FLOAT_ATOMIC_HPP
 
+// for std::size_t
+#include <cstddef>
+
+// for std::uintptr_t
+#include <cstdint>
+
 // for std::memcpy
 #include <cstring>
 
 // for std::atomic
 #include <atomic>
 
+// for std::unique_ptr
+#include <memory>
+
 // for std::is_floating_point, std::is_integral
 #include <type_traits>
 
+#if (__cplusplus >= 202002L)
+
+// for std::bit_cast
+#include <bit>
+
+#endif // #if (__cplusplus >= 202002L)
+
+#ifndef PREFORM_FLOAT_ATOMIC_NATIVE
+#if (__cplusplus >= 202002L) && \
+    defined(__cpp_lib_atomic_float) && (__cpp_lib_atomic_float >= 201711L) && \
+    defined(__cpp_lib_bit_cast) && (__cpp_lib_bit_cast >= 201806L)
+#define PREFORM_FLOAT_ATOMIC_NATIVE 1
+#else
+#define PREFORM_FLOAT_ATOMIC_NATIVE 0
+#endif
+#endif // #ifndef PREFORM_FLOAT_ATOMIC_NATIVE
+
 namespace pre {
 
 /**
@@ -57,6 +83,15 @@ namespace pre {
 
 /**
  * @brief Floating point atomic.
+ *
+ * If `PREFORM_FLOAT_ATOMIC_NATIVE` is nonzero, which is the default
+ * given C++20 floating point atomics, the value is stored as
+ * `std::atomic<Tfloat>`, so floating point addition and subtraction
+ * go to the standard library, and from there to hardware atomics on
+ * platforms which have them. Else, the value is stored as
+ * `std::atomic<Tfloat_bits>`, and floating point addition and
+ * subtraction are compare/exchange loops. Either way, the integral
+ * operations act on the bits, and compare/exchange compares bits.
  */
 template <
     typename Tfloat,
@@ -113,10 +148,42 @@ public:
      */
     /**@{*/
 
+#if PREFORM_FLOAT_ATOMIC_NATIVE
+
+    /**
+     * @brief Default constructor.
+     */
+    constexpr float_atomic() noexcept : rep_(Tfloat(0))
+    {
+    }
+
+    /**
+     * @brief Constructor.
+     *
+     * @param[in] bits
+     * Unsigned integral bits.
+     */
+    constexpr float_atomic(Tfloat_bits bits) noexcept :
+            rep_(std::bit_cast<Tfloat>(bits))
+    {
+    }
+
+    /**
+     * @brief Constructor.
+     *
+     * @param[in] val
+     * Floating point value.
+     */
+    constexpr float_atomic(Tfloat val) noexcept : rep_(val)
+    {
+    }
+
+#else
+
     /**
      * @brief Default constructor.
      */
-    constexpr float_atomic() noexcept : bits_(0)
+    constexpr float_atomic() noexcept : rep_(0)
     {
     }
 
@@ -126,7 +193,7 @@ public:
      * @param[in] bits
      * Unsigned integral bits.
      */
-    constexpr float_atomic(Tfloat_bits bits) noexcept : bits_(bits)
+    constexpr float_atomic(Tfloat_bits bits) noexcept : rep_(bits)
     {
     }
 
@@ -136,17 +203,19 @@ public:
      * @param[in] val
      * Floating point value.
      */
-    float_atomic(Tfloat val) noexcept : bits_(convert(val))
+    float_atomic(Tfloat val) noexcept : rep_(convert(val))
     {
     }
 
+#endif // #if PREFORM_FLOAT_ATOMIC_NATIVE
+
     /**
      * @brief Copy constructor.
      *
      * @note
      * Copying is _not_ atomic.
      */
-    float_atomic(const float_atomic& oth) noexcept : bits_(oth.load())
+    float_atomic(const float_atomic& oth) noexcept : rep_(oth.rep_.load())
     {
     }
 
@@ -167,7 +236,11 @@ public:
             std::memory_order order =
             std::memory_order_seq_cst) noexcept
     {
-        bits_.store(bits, order);
+#if PREFORM_FLOAT_ATOMIC_NATIVE
+        rep_.store(convert(bits), order);
+#else
+        rep_.store(bits, order);
+#endif // #if PREFORM_FLOAT_ATOMIC_NATIVE
     }
 
     /**
@@ -178,7 +251,11 @@ public:
             std::memory_order order =
             std::memory_order_seq_cst) volatile noexcept
     {
-        bits_.store(bits, order);
+#if PREFORM_FLOAT_ATOMIC_NATIVE
+        rep_.store(convert(bits), order);
+#else
+        rep_.store(bits, order);
+#endif // #if PREFORM_FLOAT_ATOMIC_NATIVE
     }
 
     /**
@@ -188,7 +265,11 @@ public:
             std::memory_order order =
             std::memory_order_seq_cst) const noexcept
     {
-        return bits_.load(order);
+#if PREFORM_FLOAT_ATOMIC_NATIVE
+        return convert(rep_.load(order));
+#else
+        return rep_.load(order);
+#endif // #if PREFORM_FLOAT_ATOMIC_NATIVE
     }
 
     /**
@@ -198,7 +279,11 @@ public:
             std::memory_order order =
             std::memory_order_seq_cst) const volatile noexcept
     {
-        return bits_.load(order);
+#if PREFORM_FLOAT_ATOMIC_NATIVE
+        return convert(rep_.load(order));
+#else
+        return rep_.load(order);
+#endif // #if PREFORM_FLOAT_ATOMIC_NATIVE
     }
 
     /**
@@ -209,7 +294,15 @@ public:
             std::memory_order order =
             std::memory_order_seq_cst) noexcept
     {
-        return bits_.fetch_add(bits, order);
+#if PREFORM_FLOAT_ATOMIC_NATIVE
+        return fetch_bits_(
+                rep_,
+                [=](Tfloat_bits prev) {
+                    return Tfloat_bits(prev + bits);
+                }, order);
+#else
+        return rep_.fetch_add(bits, order);
+#endif // #if PREFORM_FLOAT_ATOMIC_NATIVE
     }
 
     /**
@@ -220,7 +313,15 @@ public:
             std::memory_order order =
             std::memory_order_seq_cst) volatile noexcept
     {
-        return bits_.fetch_add(bits, order);
+#if PREFORM_FLOAT_ATOMIC_NATIVE
+        return fetch_bits_(
+                rep_,
+                [=](Tfloat_bits prev) {
+                    return Tfloat_bits(prev + bits);
+                }, order);
+#else
+        return rep_.fetch_add(bits, order);
+#endif // #if PREFORM_FLOAT_ATOMIC_NATIVE
     }
 
     /**
@@ -231,7 +332,15 @@ public:
             std::memory_order order =
             std::memory_order_seq_cst) noexcept
     {
-        return bits_.fetch_sub(bits, order);
+#if PREFORM_FLOAT_ATOMIC_NATIVE
+        return fetch_bits_(
+                rep_,
+                [=](Tfloat_bits prev) {
+                    return Tfloat_bits(prev - bits);
+                }, order);
+#else
+        return rep_.fetch_sub(bits, order);
+#endif // #if PREFORM_FLOAT_ATOMIC_NATIVE
     }
 
     /**
@@ -242,7 +351,15 @@ public:
             std::memory_order order =
             std::memory_order_seq_cst) volatile noexcept
     {
-        return bits_.fetch_sub(bits, order);
+#if PREFORM_FLOAT_ATOMIC_NATIVE
+        return fetch_bits_(
+                rep_,
+                [=](Tfloat_bits prev) {
+                    return Tfloat_bits(prev - bits);
+                }, order);
+#else
+        return rep_.fetch_sub(bits, order);
+#endif // #if PREFORM_FLOAT_ATOMIC_NATIVE
     }
 
     /**
@@ -253,7 +370,15 @@ public:
             std::memory_order order =
             std::memory_order_seq_cst) noexcept
     {
-        return bits_.fetch_or(bits, order);
+#if PREFORM_FLOAT_ATOMIC_NATIVE
+        return fetch_bits_(
+                rep_,
+                [=](Tfloat_bits prev) {
+                    return Tfloat_bits(prev | bits);
+                }, order);
+#else
+        return rep_.fetch_or(bits, order);
+#endif // #if PREFORM_FLOAT_ATOMIC_NATIVE
     }
 
     /**
@@ -264,7 +389,15 @@ public:
             std::memory_order order =
             std::memory_order_seq_cst) volatile noexcept
     {
-        return bits_.fetch_or(bits, order);
+#if PREFORM_FLOAT_ATOMIC_NATIVE
+        return fetch_bits_(
+                rep_,
+                [=](Tfloat_bits prev) {
+                    return Tfloat_bits(prev | bits);
+                }, order);
+#else
+        return rep_.fetch_or(bits, order);
+#endif // #if PREFORM_FLOAT_ATOMIC_NATIVE
     }
 
     /**
@@ -275,7 +408,15 @@ public:
             std::memory_order order =
             std::memory_order_seq_cst) noexcept
     {
-        return bits_.fetch_xor(bits, order);
+#if PREFORM_FLOAT_ATOMIC_NATIVE
+        return fetch_bits_(
+                rep_,
+                [=](Tfloat_bits prev) {
+                    return Tfloat_bits(prev ^ bits);
+                }, order);
+#else
+        return rep_.fetch_xor(bits, order);
+#endif // #if PREFORM_FLOAT_ATOMIC_NATIVE
     }
 
     /**
@@ -286,7 +427,15 @@ public:
             std::memory_order order =
             std::memory_order_seq_cst) volatile noexcept
     {
-        return bits_.fetch_xor(bits, order);
+#if PREFORM_FLOAT_ATOMIC_NATIVE
+        return fetch_bits_(
+                rep_,
+                [=](Tfloat_bits prev) {
+                    return Tfloat_bits(prev ^ bits);
+                }, order);
+#else
+        return rep_.fetch_xor(bits, order);
+#endif // #if PREFORM_FLOAT_ATOMIC_NATIVE
     }
 
     /**
@@ -297,7 +446,15 @@ public:
             std::memory_order order =
             std::memory_order_seq_cst) noexcept
     {
-        return bits_.fetch_and(bits, order);
+#if PREFORM_FLOAT_ATOMIC_NATIVE
+        return fetch_bits_(
+                rep_,
+                [=](Tfloat_bits prev) {
+                    return Tfloat_bits(prev & bits);
+                }, order);
+#else
+        return rep_.fetch_and(bits, order);
+#endif // #if PREFORM_FLOAT_ATOMIC_NATIVE
     }
 
     /**
@@ -308,7 +465,15 @@ public:
             std::memory_order order =
             std::memory_order_seq_cst) volatile noexcept
     {
-        return bits_.fetch_and(bits, order);
+#if PREFORM_FLOAT_ATOMIC_NATIVE
+        return fetch_bits_(
+                rep_,
+                [=](Tfloat_bits prev) {
+                    return Tfloat_bits(prev & bits);
+                }, order);
+#else
+        return rep_.fetch_and(bits, order);
+#endif // #if PREFORM_FLOAT_ATOMIC_NATIVE
     }
 
     /**
@@ -320,7 +485,15 @@ public:
             std::memory_order success,
             std::memory_order failure) noexcept
     {
-        return bits_.compare_exchange_weak(expect, desire, success, failure);
+#if PREFORM_FLOAT_ATOMIC_NATIVE
+        Tfloat prev = convert(expect);
+        bool res = rep_.compare_exchange_weak(
+                prev, convert(desire), success, failure);
+        expect = convert(prev);
+        return res;
+#else
+        return rep_.compare_exchange_weak(expect, desire, success, failure);
+#endif // #if PREFORM_FLOAT_ATOMIC_NATIVE
     }
 
     /**
@@ -332,7 +505,15 @@ public:
             std::memory_order success,
             std::memory_order failure) volatile noexcept
     {
-        return bits_.compare_exchange_weak(expect, desire, success, failure);
+#if PREFORM_FLOAT_ATOMIC_NATIVE
+        Tfloat prev = convert(expect);
+        bool res = rep_.compare_exchange_weak(
+                prev, convert(desire), success, failure);
+        expect = convert(prev);
+        return res;
+#else
+        return rep_.compare_exchange_weak(expect, desire, success, failure);
+#endif // #if PREFORM_FLOAT_ATOMIC_NATIVE
     }
 
     /**
@@ -344,7 +525,15 @@ public:
             std::memory_order success,
             std::memory_order failure) noexcept
     {
-        return bits_.compare_exchange_strong(expect, desire, success, failure);
+#if PREFORM_FLOAT_ATOMIC_NATIVE
+        Tfloat prev = convert(expect);
+        bool res = rep_.compare_exchange_strong(
+                prev, convert(desire), success, failure);
+        expect = convert(prev);
+        return res;
+#else
+        return rep_.compare_exchange_strong(expect, desire, success, failure);
+#endif // #if PREFORM_FLOAT_ATOMIC_NATIVE
     }
 
     /**
@@ -356,7 +545,15 @@ public:
             std::memory_order success,
             std::memory_order failure) volatile noexcept
     {
-        return bits_.compare_exchange_strong(expect, desire, success, failure);
+#if PREFORM_FLOAT_ATOMIC_NATIVE
+        Tfloat prev = convert(expect);
+        bool res = rep_.compare_exchange_strong(
+                prev, convert(desire), success, failure);
+        expect = convert(prev);
+        return res;
+#else
+        return rep_.compare_exchange_strong(expect, desire, success, failure);
+#endif // #if PREFORM_FLOAT_ATOMIC_NATIVE
     }
 
     /**
@@ -364,7 +561,7 @@ public:
      */
     bool is_lock_free() const noexcept
     {
-        return std::atomic_is_lock_free(&bits_);
+        return rep_.is_lock_free();
     }
 
     /**
@@ -372,7 +569,7 @@ public:
      */
     bool is_lock_free() const volatile noexcept
     {
-        return std::atomic_is_lock_free(&bits_);
+        return rep_.is_lock_free();
     }
 
     /**@}*/
@@ -392,7 +589,11 @@ public:
             std::memory_order order =
             std::memory_order_seq_cst) noexcept
     {
-        bits_.store(convert(val), order);
+#if PREFORM_FLOAT_ATOMIC_NATIVE
+        rep_.store(val, order);
+#else
+        rep_.store(convert(val), order);
+#endif // #if PREFORM_FLOAT_ATOMIC_NATIVE
     }
 
     /**
@@ -403,7 +604,11 @@ public:
             std::memory_order order =
             std::memory_order_seq_cst) volatile noexcept
     {
-        bits_.store(convert(val), order);
+#if PREFORM_FLOAT_ATOMIC_NATIVE
+        rep_.store(val, order);
+#else
+        rep_.store(convert(val), order);
+#endif // #if PREFORM_FLOAT_ATOMIC_NATIVE
     }
 
     /**
@@ -413,7 +618,11 @@ public:
             std::memory_order order =
             std::memory_order_seq_cst) const noexcept
     {
-        return convert(bits_.load(order));
+#if PREFORM_FLOAT_ATOMIC_NATIVE
+        return rep_.load(order);
+#else
+        return convert(rep_.load(order));
+#endif // #if PREFORM_FLOAT_ATOMIC_NATIVE
     }
 
     /**
@@ -423,77 +632,430 @@ public:
             std::memory_order order =
             std::memory_order_seq_cst) const volatile noexcept
     {
-        return convert(bits_.load(order));
+#if PREFORM_FLOAT_ATOMIC_NATIVE
+        return rep_.load(order);
+#else
+        return convert(rep_.load(order));
+#endif // #if PREFORM_FLOAT_ATOMIC_NATIVE
     }
 
     /**
      * @brief Fetch _then_ add floating point value.
      */
-    Tfloat fetch_addf(Tfloat val) noexcept
+    Tfloat fetch_addf(
+            Tfloat val,
+            std::memory_order order =
+            std::memory_order_seq_cst) noexcept
     {
-        Tfloat_bits prev = load(std::memory_order_acquire);
-        Tfloat_bits next;
-        do { next = convert(convert(prev) + val); }
-            while (!compare_exchange_weak(
-                    prev, next,
-                    std::memory_order_release,
-                    std::memory_order_relaxed));
-        return convert(prev);
+#if PREFORM_FLOAT_ATOMIC_NATIVE
+        return rep_.fetch_add(val, order);
+#else
+        return convert(fetch_bits_(
+                rep_,
+                [=](Tfloat_bits prev) {
+                    return convert(Tfloat(convert(prev) + val));
+                }, order));
+#endif // #if PREFORM_FLOAT_ATOMIC_NATIVE
     }
 
     /**
      * @brief Fetch _then_ add floating point value, volatile variant.
      */
-    Tfloat fetch_addf(Tfloat val) volatile noexcept
+    Tfloat fetch_addf(
+            Tfloat val,
+            std::memory_order order =
+            std::memory_order_seq_cst) volatile noexcept
     {
-        Tfloat_bits prev = load(std::memory_order_acquire);
-        Tfloat_bits next;
-        do { next = convert(convert(prev) + val); }
-            while (!compare_exchange_weak(
-                    prev, next,
-                    std::memory_order_release,
-                    std::memory_order_relaxed));
-        return convert(prev);
+#if PREFORM_FLOAT_ATOMIC_NATIVE
+        return rep_.fetch_add(val, order);
+#else
+        return convert(fetch_bits_(
+                rep_,
+                [=](Tfloat_bits prev) {
+                    return convert(Tfloat(convert(prev) + val));
+                }, order));
+#endif // #if PREFORM_FLOAT_ATOMIC_NATIVE
     }
 
     /**
      * @brief Fetch _then_ subtract floating point value.
      */
-    Tfloat fetch_subf(Tfloat val) noexcept
+    Tfloat fetch_subf(
+            Tfloat val,
+            std::memory_order order =
+            std::memory_order_seq_cst) noexcept
     {
-        Tfloat_bits prev = load(std::memory_order_acquire);
-        Tfloat_bits next;
-        do { next = convert(convert(prev) - val); }
-            while (!compare_exchange_weak(
-                    prev, next,
-                    std::memory_order_release,
-                    std::memory_order_relaxed));
-        return convert(prev);
+#if PREFORM_FLOAT_ATOMIC_NATIVE
+        return rep_.fetch_sub(val, order);
+#else
+        return convert(fetch_bits_(
+                rep_,
+                [=](Tfloat_bits prev) {
+                    return convert(Tfloat(convert(prev) - val));
+                }, order));
+#endif // #if PREFORM_FLOAT_ATOMIC_NATIVE
     }
 
     /**
      * @brief Fetch _then_ subtract floating point value, volatile variant.
      */
-    Tfloat fetch_subf(Tfloat val) volatile noexcept
+    Tfloat fetch_subf(
+            Tfloat val,
+            std::memory_order order =
+            std::memory_order_seq_cst) volatile noexcept
     {
-        Tfloat_bits prev = load(std::memory_order_acquire);
-        Tfloat_bits next;
-        do { next = convert(convert(prev) - val); }
-            while (!compare_exchange_weak(
-                    prev, next,
-                    std::memory_order_release,
-                    std::memory_order_relaxed));
-        return convert(prev);
+#if PREFORM_FLOAT_ATOMIC_NATIVE
+        return rep_.fetch_sub(val, order);
+#else
+        return convert(fetch_bits_(
+                rep_,
+                [=](Tfloat_bits prev) {
+                    return convert(Tfloat(convert(prev) - val));
+                }, order));
+#endif // #if PREFORM_FLOAT_ATOMIC_NATIVE
     }
 
     /**@}*/
 
 private:
 
+#if PREFORM_FLOAT_ATOMIC_NATIVE
+
+    /**
+     * @brief Atomic floating point type.
+     */
+    std::atomic<Tfloat> rep_;
+
+#else
+
     /**
      * @brief Atomic integral type.
      */
-    std::atomic<Tfloat_bits> bits_;
+    std::atomic<Tfloat_bits> rep_;
+
+#endif // #if PREFORM_FLOAT_ATOMIC_NATIVE
+
+#if !DOXYGEN
+
+    // Fetch _then_ apply operation to bits, by compare/exchange.
+    template <typename Trep, typename Func>
+    static Tfloat_bits fetch_bits_(
+            Trep& rep, Func&& func, std::memory_order order) noexcept
+    {
+#if PREFORM_FLOAT_ATOMIC_NATIVE
+        Tfloat prev = rep.load(std::memory_order_relaxed);
+        while (!rep.compare_exchange_weak(
+                    prev, convert(func(convert(prev))),
+                    order,
+                    std::memory_order_relaxed));
+        return convert(prev);
+#else
+        Tfloat_bits prev = rep.load(std::memory_order_relaxed);
+        while (!rep.compare_exchange_weak(
+                    prev, func(prev),
+                    order,
+                    std::memory_order_relaxed));
+        return prev;
+#endif // #if PREFORM_FLOAT_ATOMIC_NATIVE
+    }
+
+#endif // #if !DOXYGEN
+};
+
+/**
+ * @brief Fetch _then_ add floating point values, componentwise.
+ *
+ * For each value `vals[k]`, adds to `dst[k]` with
+ * `float_atomic::fetch_addf()`, skipping zeros, which is typical of
+ * sparse spectral or color contributions to film pixels.
+ *
+ * @param[in] dst
+ * Destination atomics.
+ *
+ * @param[in] vals
+ * Values, e.g., `multi<Tfloat, N>`, or any container with `begin()`
+ * and `end()`.
+ *
+ * @param[in] order
+ * Memory order. By default, relaxed, as accumulation typically
+ * needs no ordering before a later synchronization point, e.g.,
+ * joining threads.
+ */
+template <
+    typename Tfloat,
+    typename Tfloat_bits,
+    typename Tvalues
+    >
+inline void fetch_addf_each(
+            float_atomic<Tfloat, Tfloat_bits>* dst,
+            const Tvalues& vals,
+            std::memory_order order = std::memory_order_relaxed) noexcept
+{
+    for (const auto& val : vals) {
+        if (val != 0) {
+            dst->fetch_addf(Tfloat(val), order);
+        }
+        ++dst;
+    }
+}
+
+/**
+ * @brief Floating point atomic accumulation buffer.
+ *
+ * A buffer of floating point atomics, e.g., film pixels splatted
+ * by many threads in light tracing, replicated in shards. Each shard
+ * is a separate copy of the buffer, padded out to whole cache lines,
+ * so threads accumulating into different shards never contend for
+ * the same cache line, even on the same hot pixel. With as many
+ * shards as threads, this amounts to per-thread buffers, where the
+ * compare/exchange loop of `float_atomic::fetch_addf()` does not
+ * retry. With fewer shards, contention is divided among shards.
+ * Reading a value sums over shards.
+ *
+ * @note
+ * Accumulation is _not_ ordered with respect to other memory
+ * operations. Reading while threads are still accumulating
+ * is safe, but need not reflect all prior accumulations.
+ */
+template <
+    typename Tfloat,
+    typename Tfloat_bits
+    >
+class float_atomic_buffer
+{
+public:
+
+    /**
+     * @brief Float atomic type.
+     */
+    typedef float_atomic<Tfloat, Tfloat_bits> float_atomic_type;
+
+    /**
+     * @brief Cache line size in bytes.
+     */
+    static constexpr std::size_t cache_line_size = 64;
+
+public:
+
+    /**
+     * @brief Default constructor.
+     */
+    float_atomic_buffer() = default;
+
+    /**
+     * @brief Constructor.
+     *
+     * @param[in] size
+     * Size, i.e., number of values.
+     *
+     * @param[in] shards
+     * Number of shards, at least 1. Typically, the number of
+     * threads.
+     */
+    float_atomic_buffer(std::size_t size, std::size_t shards) :
+            size_(size),
+            shards_(shards < 1 ? 1 : shards)
+    {
+        // Pad each shard to whole cache lines.
+        constexpr std::size_t line =
+                (cache_line_size + sizeof(Tfloat) - 1) / sizeof(Tfloat);
+        stride_ = (size_ + line - 1) / line * line;
+
+        // Allocate, with slack to align to cache line.
+        mem_.reset(new float_atomic_type[stride_ * shards_ + line]);
+        std::uintptr_t addr = reinterpret_cast<std::uintptr_t>(mem_.get());
+        std::uintptr_t rem = addr % cache_line_size;
+        data_ = mem_.get() +
+                (rem == 0 ? 0 :
+                (cache_line_size - rem) / sizeof(float_atomic_type));
+    }
+
+public:
+
+    /**
+     * @brief Size, i.e., number of values.
+     */
+    std::size_t size() const noexcept
+    {
+        return size_;
+    }
+
+    /**
+     * @brief Number of shards.
+     */
+    std::size_t shards() const noexcept
+    {
+        return shards_;
+    }
+
+    /**
+     * @brief Shard of calling thread.
+     *
+     * Numbers threads consecutively in the order they first call
+     * this function, and wraps around to the number of shards.
+     */
+    std::size_t thread_shard() const noexcept
+    {
+        return thread_number_() % (shards_ < 1 ? 1 : shards_);
+    }
+
+    /**
+     * @brief Add value in shard.
+     *
+     * @param[in] shard
+     * Shard, wrapped around to the number of shards. Typically, the
+     * index of the calling thread.
+     *
+     * @param[in] index
+     * Index in `[0, size())`.
+     *
+     * @param[in] val
+     * Value.
+     */
+    void add(std::size_t shard, std::size_t index, Tfloat val) noexcept
+    {
+        data_[(shard % shards_) * stride_ + index].fetch_addf(
+                val, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Add value in shard of calling thread.
+     *
+     * @param[in] index
+     * Index in `[0, size())`.
+     *
+     * @param[in] val
+     * Value.
+     */
+    void add(std::size_t index, Tfloat val) noexcept
+    {
+        add(thread_shard(), index, val);
+    }
+
+    /**
+     * @brief Add consecutive values in shard, skipping zeros.
+     *
+     * @param[in] shard
+     * Shard, wrapped around to the number of shards.
+     *
+     * @param[in] index
+     * Index of first value.
+     *
+     * @param[in] vals
+     * Values, e.g., `multi<Tfloat, N>` for a color pixel.
+     */
+    template <typename Tvalues>
+    void add_each(
+            std::size_t shard,
+            std::size_t index,
+            const Tvalues& vals) noexcept
+    {
+        fetch_addf_each(data_ + (shard % shards_) * stride_ + index, vals);
+    }
+
+    /**
+     * @brief Add consecutive values in shard of calling thread,
+     * skipping zeros.
+     *
+     * @param[in] index
+     * Index of first value.
+     *
+     * @param[in] vals
+     * Values, e.g., `multi<Tfloat, N>` for a color pixel.
+     */
+    template <typename Tvalues>
+    void add_each(std::size_t index, const Tvalues& vals) noexcept
+    {
+        add_each(thread_shard(), index, vals);
+    }
+
+    /**
+     * @brief Load value, summed over shards.
+     *
+     * @param[in] index
+     * Index in `[0, size())`.
+     */
+    Tfloat loadf(std::size_t index) const noexcept
+    {
+        Tfloat res = 0;
+        for (std::size_t shard = 0; shard < shards_; shard++) {
+            res += data_[shard * stride_ + index].loadf(
+                        std::memory_order_relaxed);
+        }
+        return res;
+    }
+
+    /**
+     * @brief Merge shards into output.
+     *
+     * @param[out] res
+     * Output values, of size `size()`.
+     */
+    void merge(Tfloat* res) const noexcept
+    {
+        for (std::size_t index = 0; index < size_; index++) {
+            res[index] = 0;
+        }
+        for (std::size_t shard = 0; shard < shards_; shard++) {
+            const float_atomic_type* data = data_ + shard * stride_;
+            for (std::size_t index = 0; index < size_; index++) {
+                res[index] += data[index].loadf(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Clear, i.e., set all values to zero.
+     *
+     * @note
+     * Clearing is _not_ atomic with respect to accumulation.
+     */
+    void clear() noexcept
+    {
+        for (std::size_t pos = 0; pos < stride_ * shards_; pos++) {
+            data_[pos].storef(Tfloat(0), std::memory_order_relaxed);
+        }
+    }
+
+private:
+
+    /**
+     * @brief Size.
+     */
+    std::size_t size_ = 0;
+
+    /**
+     * @brief Number of shards.
+     */
+    std::size_t shards_ = 0;
+
+    /**
+     * @brief Stride between shards, in values.
+     */
+    std::size_t stride_ = 0;
+
+    /**
+     * @brief Memory.
+     */
+    std::unique_ptr<float_atomic_type[]> mem_;
+
+    /**
+     * @brief Data, aligned to cache line.
+     */
+    float_atomic_type* data_ = nullptr;
+
+#if !DOXYGEN
+
+    // Number of calling thread.
+    static std::size_t thread_number_() noexcept
+    {
+        static std::atomic<std::size_t> count(0);
+        static thread_local std::size_t number =
+            count.fetch_add(1, std::memory_order_relaxed);
+        return number;
+    }
+
+#endif // #if !DOXYGEN
 };
 
 /**@}*/
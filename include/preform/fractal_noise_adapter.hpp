@@ -0,0 +1,634 @@
+/* Copyright (c) 2018-20 M. Grady Saunders
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer.
+ *
+ *   2. Redistributions in binary form must reproduce the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer in the documentation and/or other materials
+ *      provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*+-+*/
+#if !DOXYGEN
+#if !(__cplusplus >= 201703L)
+#error "preform/fractal_noise_adapter.hpp requires >=C++17"
+#endif // #if !(__cplusplus >= 201703L)
+#endif // #if !DOXYGEN
+#pragma once
+#ifndef PREFORM_FRACTAL_NOISE_ADAPTER_HPP
+#define PREFORM_FRACTAL_NOISE_ADAPTER_HPP
+
+// for std::min, std::max
+#include <algorithm>
+
+// for std::size_t
+#include <cstddef>
+
+// for std::true_type, std::false_type, std::void_t, ...
+#include <type_traits>
+
+// for std::forward
+#include <utility>
+
+// for pre::multi
+#include <preform/multi.hpp>
+
+// for pre::multi wrappers
+#include <preform/multi_math.hpp>
+
+namespace pre {
+
+/**
+ * @defgroup fractal_noise_adapter Fractal noise adapter
+ *
+ * `<preform/fractal_noise_adapter.hpp>`
+ *
+ * __C++ version__: >=C++17
+ */
+/**@{*/
+
+/**
+ * @brief Fractal noise mode.
+ */
+enum class fractal_noise_mode {
+
+    /**
+     * @brief Fractional Brownian motion, sum of octaves.
+     */
+    fbm,
+
+    /**
+     * @brief Turbulence, sum of absolute octaves.
+     */
+    turbulence,
+
+    /**
+     * @brief Ridged, sum of squared complements of absolute octaves.
+     */
+    ridged
+};
+
+#if !DOXYGEN
+
+template <typename Tmember, typename Tfloat, std::size_t N>
+struct is_evaluate_many_ : std::false_type
+{
+};
+
+template <typename Tclass, typename Tfloat, std::size_t N>
+struct is_evaluate_many_<void (Tclass::*)(
+        multi<const Tfloat*, N>,
+        std::size_t, Tfloat*,
+        multi<Tfloat*, N>) const, Tfloat, N> : std::true_type
+{
+};
+
+// With extra trailing output, e.g., pre::worley_noise3.
+template <typename Tclass, typename Tfloat, std::size_t N>
+struct is_evaluate_many_<void (Tclass::*)(
+        multi<const Tfloat*, N>,
+        std::size_t, Tfloat*,
+        multi<Tfloat*, N>, Tfloat*) const, Tfloat, N> : std::true_type
+{
+};
+
+// Exact signature match, such that adapters which change dimension,
+// e.g., pre::periodic_noise_adapter2, do not match by inheritance.
+template <typename Tnoise, std::size_t N, typename = void>
+struct has_evaluate_many_ : std::false_type
+{
+};
+
+template <typename Tnoise, std::size_t N>
+struct has_evaluate_many_<Tnoise, N,
+        std::void_t<decltype(&Tnoise::evaluate_many)>> :
+            is_evaluate_many_<
+                decltype(&Tnoise::evaluate_many),
+                typename Tnoise::float_type, N>
+{
+};
+
+#endif // #if !DOXYGEN
+
+/**
+ * @brief Fractal noise adapter.
+ *
+ * Fractal noise adapter which sums octaves of an @f$ N @f$-dimensional
+ * noise function. Octave @f$ k @f$ has frequency @f$ \lambda^k @f$
+ * and amplitude @f$ g^k @f$, for lacunarity @f$ \lambda @f$ and gain
+ * @f$ g @f$, and the sum is normalized by the sum of amplitudes. Each
+ * octave is also offset, so that lattices do not align at the origin.
+ *
+ * Given a footprint, i.e., the width of a pixel in noise coordinates
+ * @f$ w @f$, octaves fade out linearly as @f$ \lambda^k w @f$ goes
+ * from 1/4 to 1/2, and octaves past the Nyquist limit are never
+ * evaluated.
+ *
+ * If the noise function has `evaluate_many()`, as
+ * `pre::simplex_noise3` and `pre::worley_noise3` do, octaves are
+ * evaluated together in one batch.
+ *
+ * @tparam Tnoise
+ * Noise type.
+ *
+ * @tparam N
+ * Dimension.
+ */
+template <typename Tnoise, std::size_t N>
+class fractal_noise_adapter : public Tnoise
+{
+public:
+
+    /**
+     * @brief Float type.
+     */
+    typedef typename Tnoise::float_type float_type;
+
+    /**
+     * @brief Maximum octaves.
+     */
+    static constexpr int max_octaves = 32;
+
+    /**
+     * @brief Default constructor.
+     */
+    fractal_noise_adapter() = default;
+
+    /**
+     * @brief Constructor.
+     *
+     * @param[in] mode
+     * Mode.
+     *
+     * @param[in] octaves
+     * Octaves, clamped to @f$ [1, 32] @f$.
+     *
+     * @param[in] lacunarity
+     * Lacunarity, frequency multiplier per octave.
+     *
+     * @param[in] gain
+     * Gain, amplitude multiplier per octave.
+     */
+    template <typename... Targs>
+    fractal_noise_adapter(
+            fractal_noise_mode mode,
+            int octaves,
+            float_type lacunarity,
+            float_type gain,
+            Targs&&... args) :
+                Tnoise(std::forward<Targs>(args)...),
+                mode_(mode),
+                octaves_(std::min(std::max(octaves, 1), max_octaves)),
+                lacunarity_(lacunarity),
+                gain_(gain)
+    {
+    }
+
+    /**
+     * @brief Evaluate.
+     *
+     * @param[in] t
+     * Coordinate.
+     *
+     * @param[out] ds_dt
+     * Noise partial derivatives. _Optional_.
+     *
+     * @param[in] footprint
+     * Footprint, or 0 to evaluate every octave.
+     */
+    float_type evaluate(
+                multi<float_type, N> t,
+                multi<float_type, N>* ds_dt = nullptr,
+                float_type footprint = 0) const
+    {
+        // Octave coordinates.
+        float_type u[N][max_octaves];
+        float_type du[N][max_octaves];
+        float_type w[max_octaves];
+        int count = 0;
+        for (int k = 0; k < octaves_; k++) {
+            w[k] = weight_(k, footprint);
+            if (!(w[k] > float_type(0))) {
+                break;
+            }
+            multi<float_type, N> uk = frequency_(k) * t + offset_(k);
+            for (std::size_t d = 0; d < N; d++) {
+                u[d][k] = uk[d];
+            }
+            count++;
+        }
+
+        // Delegate.
+        float_type s[max_octaves];
+        evaluate_octaves_(u, count, s, ds_dt ? du : nullptr);
+
+        // Combine.
+        float_type sum = 0;
+        if (ds_dt) {
+            *ds_dt = {};
+        }
+        for (int k = 0; k < count; k++) {
+            float_type ak = w[k] * amplitude_(k);
+            float_type dsk;
+            sum += ak * combine_(s[k], dsk);
+            if (ds_dt) {
+                for (std::size_t d = 0; d < N; d++) {
+                    (*ds_dt)[d] += ak * frequency_(k) * dsk * du[d][k];
+                }
+            }
+        }
+        if (ds_dt) {
+            *ds_dt /= amplitude_sum_();
+        }
+        return sum / amplitude_sum_();
+    }
+
+    /**
+     * @brief Evaluate many.
+     *
+     * Equivalent to `evaluate()` at each point, for coordinates in
+     * structure-of-arrays layout. Points go in groups of 64, one
+     * octave at a time, and an octave is skipped for the whole group
+     * if every footprint in the group is past its cutoff.
+     *
+     * @param[in] t
+     * Coordinate arrays, one per dimension.
+     *
+     * @param[in] n
+     * Count.
+     *
+     * @param[out] s
+     * Noise values.
+     *
+     * @param[out] ds_dt
+     * Noise partial derivative arrays, one per dimension. _Optional_.
+     *
+     * @param[in] footprint
+     * Footprints. _Optional_.
+     */
+    void evaluate_many(
+            multi<const float_type*, N> t,
+            std::size_t n,
+            float_type* s,
+            multi<float_type*, N> ds_dt = {},
+            const float_type* footprint = nullptr) const
+    {
+        // Points per group.
+        constexpr std::size_t lanes = 64;
+
+        bool want_ds_dt = false;
+        for (std::size_t d = 0; d < N; d++) {
+            want_ds_dt = want_ds_dt || ds_dt[d];
+        }
+        for (std::size_t k0 = 0; k0 < n; k0 += lanes) {
+            std::size_t m = std::min(lanes, n - k0);
+            float_type sum[lanes] = {};
+            float_type dsum[N][lanes] = {};
+            for (int k = 0; k < octaves_; k++) {
+
+                // Weights.
+                float_type w[lanes];
+                bool any = false;
+                for (std::size_t j = 0; j < m; j++) {
+                    w[j] = weight_(k, footprint ? footprint[k0 + j] : 0);
+                    any = any || w[j] > float_type(0);
+                }
+                if (!any) {
+                    break;
+                }
+
+                // Octave coordinates.
+                float_type fk = frequency_(k);
+                multi<float_type, N> ok = offset_(k);
+                float_type u[N][lanes];
+                float_type du[N][lanes];
+                for (std::size_t d = 0; d < N; d++)
+                for (std::size_t j = 0; j < m; j++) {
+                    u[d][j] = fk * t[d][k0 + j] + ok[d];
+                }
+
+                // Delegate.
+                float_type sk[lanes];
+                evaluate_octaves_(u, m, sk, want_ds_dt ? du : nullptr);
+
+                // Combine.
+                float_type ak = amplitude_(k);
+                for (std::size_t j = 0; j < m; j++) {
+                    float_type dsk;
+                    sum[j] += w[j] * ak * combine_(sk[j], dsk);
+                    if (want_ds_dt) {
+                        for (std::size_t d = 0; d < N; d++) {
+                            dsum[d][j] += w[j] * ak * fk * dsk * du[d][j];
+                        }
+                    }
+                }
+            }
+            float_type norm = amplitude_sum_();
+            for (std::size_t j = 0; j < m; j++) {
+                s[k0 + j] = sum[j] / norm;
+            }
+            for (std::size_t d = 0; d < N; d++) {
+                if (ds_dt[d]) {
+                    for (std::size_t j = 0; j < m; j++) {
+                        ds_dt[d][k0 + j] = dsum[d][j] / norm;
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Octaves visible at footprint.
+     *
+     * @param[in] footprint
+     * Footprint, or 0 for every octave.
+     */
+    int visible_octaves(float_type footprint) const
+    {
+        int k = 0;
+        while (k < octaves_ && weight_(k, footprint) > float_type(0)) {
+            k++;
+        }
+        return k;
+    }
+
+private:
+
+    /**
+     * @brief Mode.
+     */
+    fractal_noise_mode mode_ = fractal_noise_mode::fbm;
+
+    /**
+     * @brief Octaves.
+     */
+    int octaves_ = 6;
+
+    /**
+     * @brief Lacunarity @f$ \lambda @f$.
+     */
+    float_type lacunarity_ = 2;
+
+    /**
+     * @brief Gain @f$ g @f$.
+     */
+    float_type gain_ = float_type(0.5);
+
+    /**
+     * @brief Frequency of octave.
+     */
+    float_type frequency_(int k) const
+    {
+        return pre::pow(lacunarity_, float_type(k));
+    }
+
+    /**
+     * @brief Amplitude of octave.
+     */
+    float_type amplitude_(int k) const
+    {
+        return pre::pow(gain_, float_type(k));
+    }
+
+    /**
+     * @brief Sum of amplitudes.
+     */
+    float_type amplitude_sum_() const
+    {
+        float_type sum = 0;
+        for (int k = 0; k < octaves_; k++) {
+            sum += amplitude_(k);
+        }
+        return sum;
+    }
+
+    /**
+     * @brief Offset of octave.
+     */
+    multi<float_type, N> offset_(int k) const
+    {
+        multi<float_type, N> o;
+        for (std::size_t d = 0; d < N; d++) {
+            o[d] = float_type(k) * float_type(1.6180339887) * float_type(d + 1);
+        }
+        return o;
+    }
+
+    /**
+     * @brief Footprint weight of octave.
+     */
+    float_type weight_(int k, float_type footprint) const
+    {
+        float_type x = frequency_(k) * footprint;
+        return std::min(std::max(2 - 4 * x, float_type(0)), float_type(1));
+    }
+
+    /**
+     * @brief Combine octave value by mode.
+     *
+     * @param[in] sk
+     * Octave value.
+     *
+     * @param[out] dsk
+     * Derivative of combined value with respect to octave value.
+     */
+    float_type combine_(float_type sk, float_type& dsk) const
+    {
+        switch (mode_) {
+            case fractal_noise_mode::turbulence:
+                dsk = sk < 0 ? -1 : 1;
+                return pre::abs(sk);
+            case fractal_noise_mode::ridged: {
+                float_type rk = 1 - pre::abs(sk);
+                dsk = (sk < 0 ? 2 : -2) * rk;
+                return rk * rk;
+            }
+            default:
+                dsk = 1;
+                return sk;
+        }
+    }
+
+    /**
+     * @brief Evaluate octave coordinates, in batch if possible.
+     */
+    template <std::size_t M>
+    void evaluate_octaves_(
+            const float_type (&u)[N][M],
+            std::size_t count,
+            float_type* s,
+            float_type (*du)[M]) const
+    {
+        if constexpr (has_evaluate_many_<Tnoise, N>::value) {
+            multi<const float_type*, N> up;
+            multi<float_type*, N> dup = {};
+            for (std::size_t d = 0; d < N; d++) {
+                up[d] = &u[d][0];
+                if (du) {
+                    dup[d] = &du[d][0];
+                }
+            }
+            Tnoise::evaluate_many(up, count, s, dup);
+        }
+        else {
+            for (std::size_t k = 0; k < count; k++) {
+                multi<float_type, N> uk;
+                for (std::size_t d = 0; d < N; d++) {
+                    uk[d] = u[d][k];
+                }
+                multi<float_type, N> duk;
+                s[k] = Tnoise::evaluate(uk, du ? &duk : nullptr);
+                if (du) {
+                    for (std::size_t d = 0; d < N; d++) {
+                        du[d][k] = duk[d];
+                    }
+                }
+            }
+        }
+    }
+
+public:
+
+    /**
+     * @name Accessors
+     */
+    /**@{*/
+
+    /**
+     * @brief Get mode.
+     */
+    __attribute__((always_inline))
+    fractal_noise_mode mode() const
+    {
+        return mode_;
+    }
+
+    /**
+     * @brief Set mode, return previous mode.
+     */
+    __attribute__((always_inline))
+    fractal_noise_mode mode(fractal_noise_mode val)
+    {
+        fractal_noise_mode mode = mode_; mode_ = val; return mode;
+    }
+
+    /**
+     * @brief Get octaves.
+     */
+    __attribute__((always_inline))
+    int octaves() const
+    {
+        return octaves_;
+    }
+
+    /**
+     * @brief Set octaves, clamped to @f$ [1, 32] @f$, return previous
+     * octaves.
+     */
+    __attribute__((always_inline))
+    int octaves(int val)
+    {
+        int octaves = octaves_;
+        octaves_ = std::min(std::max(val, 1), max_octaves);
+        return octaves;
+    }
+
+    /**
+     * @brief Get lacunarity.
+     */
+    __attribute__((always_inline))
+    float_type lacunarity() const
+    {
+        return lacunarity_;
+    }
+
+    /**
+     * @brief Set lacunarity, return previous lacunarity.
+     */
+    __attribute__((always_inline))
+    float_type lacunarity(float_type val)
+    {
+        float_type lacunarity = lacunarity_; lacunarity_ = val;
+        return lacunarity;
+    }
+
+    /**
+     * @brief Get gain.
+     */
+    __attribute__((always_inline))
+    float_type gain() const
+    {
+        return gain_;
+    }
+
+    /**
+     * @brief Set gain, return previous gain.
+     */
+    __attribute__((always_inline))
+    float_type gain(float_type val)
+    {
+        float_type gain = gain_; gain_ = val; return gain;
+    }
+
+    /**@}*/
+};
+
+// Prototype
+#if !DOXYGEN
+    template <typename> class simplex_noise2;
+    template <typename> class simplex_noise3;
+    template <typename> class worley_noise3;
+#endif // #if !DOXYGEN
+
+/**
+ * @brief Template alias for convenience.
+ *
+ * @note
+ * Requires that client code includes `<preform/simplex_noise2.hpp>`.
+ */
+template <typename T>
+using fractal_simplex_noise2 =
+      fractal_noise_adapter<simplex_noise2<T>, 2>;
+
+/**
+ * @brief Template alias for convenience.
+ *
+ * @note
+ * Requires that client code includes `<preform/simplex_noise3.hpp>`.
+ */
+template <typename T>
+using fractal_simplex_noise3 =
+      fractal_noise_adapter<simplex_noise3<T>, 3>;
+
+/**
+ * @brief Template alias for convenience.
+ *
+ * @note
+ * Requires that client code includes `<preform/worley_noise3.hpp>`.
+ */
+template <typename T>
+using fractal_worley_noise3 =
+      fractal_noise_adapter<worley_noise3<T>, 3>;
+
+/**@}*/
+
+} // namespace pre
+
+#endif // #ifndef PREFORM_FRACTAL_NOISE_ADAPTER_HPP
@@ -38,6 +38,16 @@
 // for pre::signbit, pre::copysign, pre::sqrt, ...
 #include <preform/math.hpp>
 
+#if (__cplusplus >= 201703L)
+
+// for std::vector
+#include <vector>
+
+// for pre::simd
+#include <preform/simd.hpp>
+
+#endif // #if (__cplusplus >= 201703L)
+
 namespace pre {
 
 /**
@@ -447,6 +457,280 @@ inline std::enable_if_t<
 
 /**@}*/
 
+#if (__cplusplus >= 201703L)
+
+/**
+ * @name Fresnel (SIMD lanes)
+ *
+ * Overloads over `simd` lanes, e.g., one lane per wavelength in
+ * spectral shading, which blend lanes rather than branching. Complex
+ * refractive indices are passed as separate real and imaginary lanes,
+ * and the conducting form uses real arithmetic throughout.
+ *
+ * __C++ version__: >=C++17
+ */
+/**@{*/
+
+/**
+ * @brief Fresnel equations for dielectric interface, SIMD lanes.
+ *
+ * @returns
+ * Mask of lanes which refract, i.e., lanes without total internal
+ * reflection. Outputs are as in the scalar form, lane by lane.
+ */
+template <typename T, std::size_t W>
+inline simd_mask<T, W> fresnel_diel(
+                const simd<T, W>& eta,
+                const simd<T, W>& cos_thetai,
+                simd<T, W>& cos_thetat,
+                simd<T, W>& rs, simd<T, W>& rp,
+                simd<T, W>& ts, simd<T, W>& tp)
+{
+    simd<T, W> cos2_thetat = 1 - eta * eta * (1 - cos_thetai * cos_thetai);
+    simd_mask<T, W> refr = cos2_thetat > 0;
+    simd<T, W> cos_thetat_ =
+        pre::copysign(
+        pre::sqrt(pre::fmax(cos2_thetat, simd<T, W>(0))), cos_thetai);
+    simd<T, W> rs_ =
+        (eta * cos_thetai - cos_thetat_) /
+        (eta * cos_thetai + cos_thetat_);
+    simd<T, W> rp_ =
+        (cos_thetai - eta * cos_thetat_) /
+        (cos_thetai + eta * cos_thetat_);
+    cos_thetat = pre::select(refr, -cos_thetat_, simd<T, W>(0));
+    rs = pre::select(refr, rs_, simd<T, W>(1));
+    rp = pre::select(refr, rp_, simd<T, W>(1));
+    ts = pre::select(refr, 1 + rs_, simd<T, W>(0));
+    tp = pre::select(refr, eta * (1 + rp_), simd<T, W>(0));
+    return refr;
+}
+
+/**
+ * @brief Fresnel equations for dielectric interface, unpolarized form,
+ * SIMD lanes.
+ *
+ * @returns
+ * Mask of lanes which refract, i.e., lanes without total internal
+ * reflection.
+ */
+template <typename T, std::size_t W>
+inline simd_mask<T, W> fresnel_diel(
+                const simd<T, W>& eta,
+                const simd<T, W>& cos_thetai,
+                simd<T, W>& cos_thetat,
+                simd<T, W>& fr, simd<T, W>& ft)
+{
+    simd<T, W> rs, rp;
+    simd<T, W> ts, tp;
+    simd_mask<T, W> refr =
+    fresnel_diel(
+        eta,
+        cos_thetai,
+        cos_thetat,
+        rs, rp,
+        ts, tp);
+    fr = T(0.5) * (rs * rs + rp * rp);
+    ft = 1 - fr;
+    return refr;
+}
+
+/**
+ * @brief Fresnel equations for dielectric-to-conducting interface,
+ * unpolarized form, SIMD lanes.
+ *
+ * @param[in] eta_re
+ * Refractive index @f$ \eta = \eta_i / \eta_t @f$, real part.
+ *
+ * @param[in] eta_im
+ * Refractive index @f$ \eta = \eta_i / \eta_t @f$, imaginary part.
+ *
+ * @param[in] cos_thetai
+ * Cosine of incidence angle.
+ *
+ * @par Expression
+ * @parblock
+ * With @f$ n + ik = 1 / \eta @f$, @f$ c = |\cos{\theta_i}| @f$, and
+ * @f$ s^2 = 1 - c^2 @f$,
+ * - @f$ a^2 + b^2 = \sqrt{(n^2 - k^2 - s^2)^2 + 4n^2k^2} @f$
+ * - @f$ a^2 = (a^2 + b^2 + n^2 - k^2 - s^2) / 2 @f$
+ * - @f$ R_s = (a^2 + b^2 - 2ac + c^2) / (a^2 + b^2 + 2ac + c^2) @f$
+ * - @f$ R_p = R_s (c^2(a^2 + b^2) - 2acs^2 + s^4) /
+ *                 (c^2(a^2 + b^2) + 2acs^2 + s^4) @f$
+ * - @f$ F_r = (R_s + R_p) / 2 @f$
+ * @endparblock
+ *
+ * @note
+ * This agrees with the scalar form, which evaluates the same
+ * reflectance in complex arithmetic.
+ */
+template <typename T, std::size_t W>
+inline simd<T, W> fresnel_diel_cond(
+                const simd<T, W>& eta_re,
+                const simd<T, W>& eta_im,
+                const simd<T, W>& cos_thetai)
+{
+    // Invert.
+    simd<T, W> eta_norm = eta_re * eta_re + eta_im * eta_im;
+    simd<T, W> n = eta_re / eta_norm;
+    simd<T, W> k = -eta_im / eta_norm;
+
+    // Trig terms.
+    simd<T, W> cos_theta = pre::fabs(cos_thetai);
+    cos_theta = pre::fmin(cos_theta, simd<T, W>(1));
+    simd<T, W> cos2_theta = cos_theta * cos_theta;
+    simd<T, W> sin2_theta = 1 - cos2_theta;
+
+    // Terms.
+    simd<T, W> tmp = n * n - k * k - sin2_theta;
+    simd<T, W> a2b2 = pre::sqrt(tmp * tmp + 4 * n * n * k * k);
+    simd<T, W> a =
+        pre::sqrt(pre::fmax(T(0.5) * (a2b2 + tmp), simd<T, W>(0)));
+
+    // Reflectances.
+    simd<T, W> rs_numer = a2b2 - 2 * a * cos_theta + cos2_theta;
+    simd<T, W> rs_denom = a2b2 + 2 * a * cos_theta + cos2_theta;
+    simd<T, W> rs = rs_numer / rs_denom;
+    simd<T, W> rp_numer =
+        cos2_theta * a2b2 - 2 * a * cos_theta * sin2_theta +
+        sin2_theta * sin2_theta;
+    simd<T, W> rp_denom =
+        cos2_theta * a2b2 + 2 * a * cos_theta * sin2_theta +
+        sin2_theta * sin2_theta;
+    simd<T, W> rp = rs * rp_numer / rp_denom;
+    return T(0.5) * (rs + rp);
+}
+
+/**@}*/
+
+/**
+ * @brief Fresnel reflectance table, SIMD lanes.
+ *
+ * Tabulates unpolarized reflectance against absolute incidence cosine
+ * for a fixed refractive index per lane, e.g., a conductor sampled at
+ * the wavelengths of a spectral renderer. Each lookup then computes
+ * the cosine index once, shared by all lanes, and interpolates
+ * linearly. Nodes are uniform in @f$ \sqrt{|\cos{\theta_i}|} @f$,
+ * so that they concentrate towards grazing incidence, where
+ * reflectance changes fastest.
+ *
+ * @note
+ * Dielectric lanes, i.e., real @f$ \eta @f$, are not interpolated,
+ * as reflectance has a kink at the critical angle for @f$ \eta > 1 @f$,
+ * where interpolation error would reach 0.3, and steepens sharply
+ * towards grazing incidence as @f$ \eta \to 1 @f$. Lookups
+ * evaluate these lanes with the exact dielectric form instead, which
+ * is cheap relative to the conducting form. For conducting lanes with
+ * 64 nodes, error is below @f$ 10^{-3} @f$ for extinction
+ * coefficients of at least 0.5, which covers common metals, and grows
+ * towards @f$ 10^{-2} @f$ for weak absorbers with soft critical angles.
+ *
+ * @tparam T
+ * Float type.
+ *
+ * @tparam W
+ * Number of lanes.
+ */
+template <typename T, std::size_t W>
+class fresnel_table
+{
+public:
+
+    // Sanity check.
+    static_assert(
+        std::is_floating_point<T>::value,
+        "T must be floating point");
+
+    /**
+     * @brief Value type.
+     */
+    typedef simd<T, W> value_type;
+
+public:
+
+    /**
+     * @brief Default constructor.
+     */
+    fresnel_table() = default;
+
+    /**
+     * @brief Initialize.
+     *
+     * @param[in] eta
+     * Refractive index @f$ \eta = \eta_i / \eta_t @f$ per lane, real
+     * for dielectrics or complex for conductors.
+     *
+     * @param[in] size
+     * Number of nodes, at least 2.
+     */
+    void init(const std::complex<T>* eta, int size = 64)
+    {
+        simd<T, W> eta_re;
+        simd<T, W> eta_im;
+        for (std::size_t k = 0; k < W; k++) {
+            eta_re[k] = eta[k].real();
+            eta_im[k] = eta[k].imag();
+        }
+        eta_ = eta_re;
+        diel_ = eta_im == simd<T, W>(0);
+        size = std::max(size, 2);
+        values_.resize(std::size_t(size));
+        for (int i = 0; i < size; i++) {
+            T v = T(i) / T(size - 1);
+            values_[i] =
+                fresnel_diel_cond(
+                    eta_re, eta_im,
+                    simd<T, W>(v * v));
+        }
+    }
+
+    /**
+     * @brief Reflectance.
+     *
+     * @param[in] cos_thetai
+     * Cosine of incidence angle.
+     */
+    simd<T, W> fr(T cos_thetai) const
+    {
+        if (values_.empty()) {
+            return {};
+        }
+        T v = pre::sqrt(pre::fabs(cos_thetai));
+        T u = pre::fmin(v, T(1)) * T(values_.size() - 1);
+        std::size_t i = std::min(std::size_t(u), values_.size() - 2);
+        T t = u - T(i);
+        simd<T, W> res = (1 - t) * values_[i] + t * values_[i + 1];
+        if (diel_.any()) {
+            simd<T, W> cos_thetat;
+            simd<T, W> fr;
+            simd<T, W> ft;
+            fresnel_diel(
+                eta_, simd<T, W>(pre::fabs(cos_thetai)),
+                cos_thetat, fr, ft);
+            res = pre::select(diel_, fr, res);
+        }
+        return res;
+    }
+
+private:
+
+    /**
+     * @brief Refractive index, real part.
+     */
+    simd<T, W> eta_;
+
+    /**
+     * @brief Dielectric lanes, evaluated exactly.
+     */
+    simd_mask<T, W> diel_;
+
+    /**
+     * @brief Values.
+     */
+    std::vector<simd<T, W>> values_;
+};
+
+#endif // #if (__cplusplus >= 201703L)
+
 /**@}*/
 
 } // namespace pre
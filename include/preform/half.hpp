@@ -35,6 +35,9 @@
 #ifndef PREFORM_HALF_HPP
 #define PREFORM_HALF_HPP
 
+// for std::size_t
+#include <cstddef>
+
 // for std::uint16_t, std::uint32_t
 #include <cstdint>
 
@@ -44,6 +47,13 @@
 // for std::numeric_limits
 #include <limits>
 
+#if defined(__F16C__)
+
+// for _mm256_cvtps_ph, _mm256_cvtph_ps, ...
+#include <immintrin.h>
+
+#endif // #if defined(__F16C__)
+
 namespace pre {
 
 /**
@@ -343,6 +353,133 @@ inline half::operator float() const noexcept
 
 #endif // #if !DOXYGEN
 
+/**
+ * @name Bulk conversion
+ */
+/**@{*/
+
+/**
+ * @brief Convert floats to halfs.
+ *
+ * Same result as converting each value by `half(float)`, except
+ * that NaN payloads may differ with F16C. Uses F16C conversion
+ * instructions when compiled for them, and otherwise a branch-free
+ * formulation that compilers vectorize.
+ *
+ * @param[in] src
+ * Source.
+ *
+ * @param[out] dst
+ * Destination.
+ *
+ * @param[in] n
+ * Count.
+ */
+inline void float_to_half(const float* src, half* dst, std::size_t n) noexcept
+{
+    std::size_t k = 0;
+#if defined(__F16C__)
+    for (; n - k >= 8; k += 8) {
+        _mm_storeu_si128(
+            reinterpret_cast<__m128i*>(dst + k),
+            _mm256_cvtps_ph(
+                _mm256_loadu_ps(src + k),
+                _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+    }
+#endif // #if defined(__F16C__)
+    for (; k < n; k++) {
+        float f = src[k];
+        std::uint32_t u; std::memcpy(&u, &f, sizeof(f));
+        std::uint32_t sign = u & 0x80000000U;
+        u ^= sign;
+
+        // Subnormal or zero, rounded by float addition.
+        float g; std::memcpy(&g, &u, sizeof(g));
+        float magic_f;
+        std::uint32_t magic_u = 0x3F000000U;
+        std::memcpy(&magic_f, &magic_u, sizeof(magic_f));
+        g += magic_f;
+        std::uint32_t v; std::memcpy(&v, &g, sizeof(v));
+        std::uint32_t b_subnormal = v - magic_u;
+
+        // Normal, rounded to nearest even.
+        std::uint32_t b_normal =
+            (u + 0xC8000FFFU + ((u >> 13) & 1)) >> 13;
+
+        // Inf or NaN, keeping the payload as half(float) does.
+        std::uint32_t m = (u & 0x007FFFFFU) >> 13;
+        std::uint32_t is_nan = 0U - std::uint32_t(u > 0x7F800000U);
+        std::uint32_t b_special =
+            0x7C00U | (is_nan & (m | std::uint32_t(m == 0)));
+
+        // Select with masks, so that the loop has no control flow.
+        std::uint32_t is_special = 0U - std::uint32_t(u >= 0x47800000U);
+        std::uint32_t is_subnormal = 0U - std::uint32_t(u < 0x38800000U);
+        std::uint32_t b =
+            (b_special & is_special) |
+            (b_subnormal & ~is_special & is_subnormal) |
+            (b_normal & ~is_special & ~is_subnormal);
+        static_cast<std::uint16_t&>(dst[k]) =
+            std::uint16_t(b | (sign >> 16));
+    }
+}
+
+/**
+ * @brief Convert halfs to floats.
+ *
+ * Same result as converting each value by `float(half)`, except
+ * that signaling NaNs become quiet with F16C. Uses F16C conversion
+ * instructions when compiled for them, and otherwise a branch-free
+ * formulation that compilers vectorize.
+ *
+ * @param[in] src
+ * Source.
+ *
+ * @param[out] dst
+ * Destination.
+ *
+ * @param[in] n
+ * Count.
+ */
+inline void half_to_float(const half* src, float* dst, std::size_t n) noexcept
+{
+    std::size_t k = 0;
+#if defined(__F16C__)
+    for (; n - k >= 8; k += 8) {
+        _mm256_storeu_ps(
+            dst + k,
+            _mm256_cvtph_ps(
+                _mm_loadu_si128(
+                reinterpret_cast<const __m128i*>(src + k))));
+    }
+#endif // #if defined(__F16C__)
+    for (; k < n; k++) {
+        std::uint32_t b = static_cast<const std::uint16_t&>(src[k]);
+        std::uint32_t u = (b & 0x7FFFU) << 13;
+        std::uint32_t e = u & 0x0F800000U;
+        u += 0x38000000U;
+
+        // Subnormal or zero, renormalized by float subtraction.
+        std::uint32_t w = u + 0x00800000U;
+        float g; std::memcpy(&g, &w, sizeof(g));
+        float magic_f;
+        std::uint32_t magic_u = 0x38800000U;
+        std::memcpy(&magic_f, &magic_u, sizeof(magic_f));
+        g -= magic_f;
+        std::uint32_t u_subnormal; std::memcpy(&u_subnormal, &g, sizeof(g));
+
+        // Select with masks, so that the loop has no control flow.
+        std::uint32_t is_special = 0U - std::uint32_t(e == 0x0F800000U);
+        std::uint32_t is_subnormal = 0U - std::uint32_t(e == 0);
+        u = ((u + (0x38000000U & is_special)) & ~is_subnormal) |
+            (u_subnormal & is_subnormal);
+        u |= (b & 0x8000U) << 16;
+        std::memcpy(dst + k, &u, sizeof(u));
+    }
+}
+
+/**@}*/
+
 /**@}*/
 
 } // namespace pre
@@ -35,6 +35,18 @@
 #ifndef PREFORM_IMAGE2_HPP
 #define PREFORM_IMAGE2_HPP
 
+#if !DOXYGEN
+#ifndef PREFORM_IMAGE2_USE_THREADS
+#define PREFORM_IMAGE2_USE_THREADS 1
+#endif // PREFORM_IMAGE2_USE_THREADS
+#endif // #if !DOXYGEN
+
+// for std::min, std::max, std::fill
+#include <algorithm>
+
+// for std::vector
+#include <vector>
+
 // for pre::block_array2
 #include <preform/block_array2.hpp>
 
@@ -47,8 +59,30 @@
 // for pre::multi wrappers
 #include <preform/multi_misc_float.hpp>
 
+// for pre::filter_weight_table
+#include <preform/image_filters.hpp>
+
+// for pre::image_storage_traits
+#include <preform/image_storage.hpp>
+
+// for PREFORM_PROFILE_ZONE
+#include <preform/profile.hpp>
+
+#if PREFORM_IMAGE2_USE_THREADS
+
+// for pre::thread_pool
+#include <preform/thread_pool.hpp>
+
+#endif // #if PREFORM_IMAGE2_USE_THREADS
+
 namespace pre {
 
+#if !PREFORM_IMAGE2_USE_THREADS && !DOXYGEN
+
+class thread_pool;
+
+#endif // #if !PREFORM_IMAGE2_USE_THREADS && !DOXYGEN
+
 /**
  * @defgroup image2 Image (2-dimensional)
  *
@@ -60,16 +94,21 @@ namespace pre {
 
 /**
  * @brief Image (2-dimensional).
+ *
+ * @tparam Ntile
+ * Tile size of underlying block array, either 0 for no tiles
+ * or a power of 2, e.g., 32 for large textures.
  */
 template <
     typename Tfloat,
     typename T, std::size_t N,
-    typename Talloc = std::allocator<T>
+    typename Talloc = std::allocator<T>,
+    std::size_t Ntile = 0
     >
 class image2 : public block_array2<
                     multi<T, N>,
                     typename std::allocator_traits<Talloc>::
-                    template rebind_alloc<multi<T, N>>>
+                    template rebind_alloc<multi<T, N>>, Ntile>
 {
 public:
 
@@ -80,8 +119,8 @@ public:
 
     // Sanity check.
     static_assert(
-        std::is_arithmetic<T>::value,
-        "T must be arithmetic");
+        image_storage_traits<T>::value,
+        "T must be arithmetic, half, or srgb8");
 
     /**
      * @brief Float type.
@@ -100,7 +139,7 @@ public:
     typedef block_array2<
             multi<T, N>,
             typename std::allocator_traits<Talloc>::
-            template rebind_alloc<multi<T, N>>> base;
+            template rebind_alloc<multi<T, N>>, Ntile> base;
 
     using typename base::size_type;
 #endif // #if !DOXYGEN
@@ -330,6 +369,43 @@ public:
         return {};
     }
 
+    /**
+     * @brief Sample many locations.
+     *
+     * Same result as calling `sample()` on each location, but with
+     * the sampling method dispatched once for the whole batch,
+     * and with wrapped indices computed once per dimension rather
+     * than once per texel.
+     *
+     * @param[in] samp
+     * Sampling method, either 0, 1, or 3.
+     *
+     * @param[in] locs
+     * Locations.
+     *
+     * @param[in] count
+     * Location count.
+     *
+     * @param[out] out
+     * Samples.
+     */
+    void sample_many(
+            int samp,
+            const multi<float_type, 2>* locs, size_type count,
+            multi<float_type, N>* out) const
+    {
+        if (this->empty()) {
+            std::fill(out, out + count, multi<float_type, N>{});
+            return;
+        }
+        switch (samp) {
+            default:
+            case 0: sample_many_<1>(locs, count, out); break;
+            case 1: sample_many_<2>(locs, count, out); break;
+            case 3: sample_many_<4>(locs, count, out); break;
+        }
+    }
+
     /**
      * @brief Resample.
      *
@@ -341,6 +417,308 @@ public:
      */
     void resample(int samp, multi<size_type, 2> count)
     {
+        resample_(nullptr, samp, count);
+    }
+
+    /**
+     * @brief Mip downsample.
+     *
+     * As in mipmap construction, reduce image dimensions
+     * by a factor of 2, and average 2x2 pixel blocks.
+     *
+     * @note
+     * This is equivalent to calling `resample()` with
+     * appropriately reduced image dimensions. However, this
+     * implementation is much more efficient, as it averages
+     * directly and uses integer operations instead of floating
+     * point operations if possible.
+     *
+     * @throw std::runtime_error
+     * If any image dimension is not a multiple of 2.
+     */
+    void mip_downsample()
+    {
+        mip_downsample_(nullptr);
+    }
+
+    /**
+     * @brief Resample with separable filter.
+     *
+     * Resample in two 1-dimensional passes, first along the 1st
+     * dimension and then along the 0th, with weights tabulated once
+     * per pass. When downsampling, the filter is stretched by the
+     * scale factor, so that it prefilters properly. Boundaries
+     * follow the cycle mode.
+     *
+     * @param[in] count
+     * Count.
+     *
+     * @param[in] filt
+     * Filter, separable with radii `filt.r`, such as `box_filter2`,
+     * `triangle_filter2`, or `mitchell_filter2`.
+     */
+    template <typename Tfilt>
+    void resample_separable(multi<size_type, 2> count, const Tfilt& filt)
+    {
+        resample_separable_(nullptr, count, filt);
+    }
+
+#if PREFORM_IMAGE2_USE_THREADS || DOXYGEN
+
+    /**
+     * @brief Resample, in parallel.
+     *
+     * Same result as `resample()`, with bands of rows split
+     * across `pool`.
+     */
+    void resample(thread_pool& pool, int samp, multi<size_type, 2> count)
+    {
+        resample_(&pool, samp, count);
+    }
+
+    /**
+     * @brief Mip downsample, in parallel.
+     *
+     * Same result as `mip_downsample()`, with bands of rows split
+     * across `pool`.
+     *
+     * @throw std::runtime_error
+     * If any image dimension is not a multiple of 2.
+     */
+    void mip_downsample(thread_pool& pool)
+    {
+        mip_downsample_(&pool);
+    }
+
+    /**
+     * @brief Resample with separable filter, in parallel.
+     *
+     * Same result as `resample_separable()`, with bands of rows
+     * split across `pool` in each pass.
+     */
+    template <typename Tfilt>
+    void resample_separable(
+            thread_pool& pool,
+            multi<size_type, 2> count, const Tfilt& filt)
+    {
+        resample_separable_(&pool, count, filt);
+    }
+
+#endif // #if PREFORM_IMAGE2_USE_THREADS || DOXYGEN
+
+    /**@}*/
+
+public:
+
+    /**
+     * @name Reconstruction
+     */
+    /**@{*/
+
+    /**
+     * @brief Reconstruct.
+     *
+     * @param[in] val
+     * Value.
+     *
+     * @param[in] loc
+     * Location.
+     *
+     * @param[in] filtrad
+     * Filter radii, beyond which filter is zero.
+     *
+     * @param[in] filt
+     * Filter function.
+     */
+    template <typename Tfilt>
+    void reconstruct(
+            multi<float_type, N> val,
+            multi<float_type, 2> loc,
+            multi<float_type, 2> filtrad,
+            Tfilt&& filt)
+    {
+        // Shift.
+        loc -= float_type(0.5);
+
+        // Determine indices.
+        multi<int, 2> indmin = fastceil(loc - filtrad);
+        multi<int, 2> indmax = fastfloor(loc + filtrad);
+        for (int l = 0; l < 2; l++) {
+            if (!cycle_mode_[l]) {
+                indmin[l] = std::max(indmin[l], 0);
+                indmax[l] = std::min(indmax[l], int(this->user_size_[l]) - 1);
+            }
+        }
+
+        // Reconstruct.
+        for (int i = indmin[0]; i <= indmax[0]; i++)
+        for (int j = indmin[1]; j <= indmax[1]; j++) {
+            multi<int, 2> ind = {i, j};
+            float_type weight = std::forward<Tfilt>(filt)(ind - loc);
+            if (weight != float_type(0)) {
+
+                // Lookup entry.
+                auto& target =
+                    this->operator[](
+                    this->convert(cycle(ind)));
+
+                // Add.
+                target =
+                    encode_(weight * val +
+                    decode_(target));
+            }
+        }
+    }
+
+    /**@}*/
+
+private:
+
+    /**
+     * @brief Cycle mode.
+     *
+     *  Value | Behavior
+     * -------|----------
+     *  0     | Clamp
+     *  +1    | Repeat
+     *  -1    | Repeat with mirroring
+     */
+    multi<int, 2> cycle_mode_ = {};
+
+#if !DOXYGEN
+
+    /**
+     * @brief Cycle.
+     */
+    multi<int, 2> cycle(multi<int, 2> ind) const
+    {
+        for (int l = 0; l < 2; l++) {
+            ind[l] = cycle(ind[l], l);
+        }
+        return ind;
+    }
+
+    /**
+     * @brief Cycle in dimension.
+     */
+    int cycle(int ind, int l) const
+    {
+        switch (cycle_mode_[l]) {
+            default:
+            case 0:
+                return clamp(ind, int(this->user_size_[l]));
+            case +1:
+                return repeat(ind, int(this->user_size_[l]));
+            case -1:
+                return mirror(ind, int(this->user_size_[l]));
+        }
+    }
+
+    /**
+     * @brief Decode entry from storage.
+     */
+    static multi<float_type, N> decode_(const multi<T, N>& v)
+    {
+        return image_storage_traits<T>::template decode<float_type>(v);
+    }
+
+    /**
+     * @brief Encode entry to storage.
+     */
+    static multi<T, N> encode_(const multi<float_type, N>& v)
+    {
+        return image_storage_traits<T>::template encode<float_type>(v);
+    }
+
+    /**
+     * @brief Fetch.
+     */
+    multi<float_type, N> fetch(multi<int, 2> ind) const
+    {
+        return decode_(
+                        this->operator[](
+                        this->convert(cycle(ind))));
+    }
+
+    /**
+     * @brief Sample many locations, with taps per dimension.
+     */
+    template <int Ntaps>
+    void sample_many_(
+            const multi<float_type, 2>* locs, size_type count,
+            multi<float_type, N>* out) const
+    {
+        for (size_type n = 0; n < count; n++) {
+            multi<float_type, 2> loc = locs[n];
+            if constexpr (Ntaps == 1) {
+                out[n] = fetch(fastfloor(loc));
+                continue;
+            }
+            else {
+                // Shift.
+                loc -= float_type(0.5);
+
+                // Floor.
+                multi<int, 2> ind = fastfloor(loc);
+                loc -= ind;
+
+                // Wrap indices, only at boundaries.
+                int inds[2][Ntaps];
+                for (int l = 0; l < 2; l++) {
+                    int ind0 = ind[l] - (Ntaps / 2 - 1);
+                    if (ind0 >= 0 &&
+                        ind0 + Ntaps <= int(this->user_size_[l])) {
+                        for (int k = 0; k < Ntaps; k++) {
+                            inds[l][k] = ind0 + k;
+                        }
+                    }
+                    else {
+                        for (int k = 0; k < Ntaps; k++) {
+                            inds[l][k] = cycle(ind0 + k, l);
+                        }
+                    }
+                }
+
+                // Interpolate.
+                multi<float_type, N> val0[Ntaps];
+                for (int i = 0; i < Ntaps; i++) {
+                    multi<float_type, N> val1[Ntaps];
+                    for (int j = 0; j < Ntaps; j++) {
+                        val1[j] =
+                            decode_(
+                            this->operator[](
+                            this->convert(
+                            multi<int, 2>{inds[0][i], inds[1][j]})));
+                    }
+                    val0[i] = interpolate_<Ntaps>(loc[1], val1);
+                }
+                out[n] = interpolate_<Ntaps>(loc[0], val0);
+            }
+        }
+    }
+
+    /**
+     * @brief Interpolate taps, linear if 2 and Catmull-Rom if 4.
+     */
+    template <int Ntaps>
+    static multi<float_type, N> interpolate_(
+            float_type t, const multi<float_type, N>* val)
+    {
+        if constexpr (Ntaps == 2) {
+            return lerp(t, val[0], val[1]);
+        }
+        else {
+            return catmull(t, val[0], val[1], val[2], val[3]);
+        }
+    }
+
+    /**
+     * @brief Resample.
+     */
+    void resample_(thread_pool* pool, int samp, multi<size_type, 2> count)
+    {
+        PREFORM_PROFILE_ZONE("image2::resample");
+
         // Target size is equivalent?
         if ((count == this->user_size_).all()) {
             // Do nothing.
@@ -354,9 +732,9 @@ public:
         else if (!((count <= this->user_size_).all() ||
                    (count >= this->user_size_).all())) {
             // Resample 0th dimension.
-            resample(samp, {count[0], this->user_size_[1]});
+            resample_(pool, samp, {count[0], this->user_size_[1]});
             // Resample 1st dimension.
-            resample(samp, {count[0], count[1]});
+            resample_(pool, samp, {count[0], count[1]});
         }
         else {
 
@@ -373,7 +751,9 @@ public:
 
             // Requires downsampling?
             if ((this->user_size_ <= image.user_size_).all()) {
-                for (size_type i = 0; i < this->user_size_[0]; i++)
+                for_each_band_(pool, this->user_size_[0],
+                        [&](size_type from, size_type to) {
+                for (size_type i = from; i < to; i++)
                 for (size_type j = 0; j < this->user_size_[1]; j++) {
                     // Downsample.
                     multi<float_type, 2> locmin = {
@@ -385,12 +765,15 @@ public:
                         scale_fac[1] * float_type(j + 1)
                     };
                     this->operator()(i, j) =
-                        fstretch<entry_type>(
+                        encode_(
                                  image.average(locmin, locmax));
                 }
+                });
             }
             else {
-                for (size_type i = 0; i < this->user_size_[0]; i++)
+                for_each_band_(pool, this->user_size_[0],
+                        [&](size_type from, size_type to) {
+                for (size_type i = from; i < to; i++)
                 for (size_type j = 0; j < this->user_size_[1]; j++) {
                     // Upsample.
                     multi<float_type, 2> loc = {
@@ -398,30 +781,18 @@ public:
                         scale_fac[1] * (float_type(j) + float_type(0.5))
                     };
                     this->operator()(i, j) =
-                        fstretch<entry_type>(
+                        encode_(
                                  image.sample(samp, loc));
                 }
+                });
             }
         }
     }
 
     /**
      * @brief Mip downsample.
-     *
-     * As in mipmap construction, reduce image dimensions
-     * by a factor of 2, and average 2x2 pixel blocks.
-     *
-     * @note
-     * This is equivalent to calling `resample()` with
-     * appropriately reduced image dimensions. However, this
-     * implementation is much more efficient, as it averages
-     * directly and uses integer operations instead of floating
-     * point operations if possible.
-     *
-     * @throw std::runtime_error
-     * If any image dimension is not a multiple of 2.
      */
-    void mip_downsample()
+    void mip_downsample_(thread_pool* pool)
     {
         // Target size.
         multi<size_type, 2> count = this->user_size_ >> 1;
@@ -436,7 +807,9 @@ public:
         // Resize.
         this->resize(count);
 
-        for (size_type i = 0; i < this->user_size_[0]; i++)
+        for_each_band_(pool, this->user_size_[0],
+                [&](size_type from, size_type to) {
+        for (size_type i = from; i < to; i++)
         for (size_type j = 0; j < this->user_size_[1]; j++) {
             size_type i0 = 2 * i, i1 = 2 * i + 1;
             size_type j0 = 2 * j, j1 = 2 * j + 1;
@@ -481,122 +854,127 @@ public:
                 (*this)(i, j) = (v00 + v01 + v10 + v11) >> 2;
             }
             else {
-                // Error?
+                // Decode, average, and encode.
+                (*this)(i, j) =
+                    encode_(
+                        (decode_(image(i0, j0)) +
+                         decode_(image(i0, j1)) +
+                         decode_(image(i1, j0)) +
+                         decode_(image(i1, j1))) * float_type(0.25));
             }
         }
+        });
     }
 
-    /**@}*/
-
-public:
-
-    /**
-     * @name Reconstruction
-     */
-    /**@{*/
-
     /**
-     * @brief Reconstruct.
-     *
-     * @param[in] val
-     * Value.
+     * @brief For each band of rows in the 0th dimension.
      *
-     * @param[in] loc
-     * Location.
-     *
-     * @param[in] filtrad
-     * Filter radii, beyond which filter is zero.
-     *
-     * @param[in] filt
-     * Filter function.
+     * Bands are aligned to tiles, so that threads never write
+     * to the same block.
      */
-    template <typename Tfilt>
-    void reconstruct(
-            multi<float_type, N> val,
-            multi<float_type, 2> loc,
-            multi<float_type, 2> filtrad,
-            Tfilt&& filt)
+    template <typename Tfunc>
+    static void for_each_band_(
+                thread_pool* pool, size_type count, Tfunc&& func)
     {
-        // Shift.
-        loc -= float_type(0.5);
-
-        // Determine indices.
-        multi<int, 2> indmin = fastceil(loc - filtrad);
-        multi<int, 2> indmax = fastfloor(loc + filtrad);
-        for (int l = 0; l < 2; l++) {
-            if (!cycle_mode_[l]) {
-                indmin[l] = std::max(indmin[l], 0);
-                indmax[l] = std::min(indmax[l], int(this->user_size_[l]) - 1);
-            }
+        size_type band = base::tile_size;
+        size_type band_count = (count + band - 1) / band;
+        auto band_func = [&](size_type index) {
+            func(index * band, std::min(count, (index + 1) * band));
+        };
+        #if PREFORM_IMAGE2_USE_THREADS
+        if (pool && band_count > 1) {
+            pool->parallel_for(
+                    size_type(0), band_count,
+                    std::max<size_type>(
+                        1, band_count / (8 * (pool->size() + 1))),
+                    band_func);
+            return;
         }
-
-        // Reconstruct.
-        for (int i = indmin[0]; i <= indmax[0]; i++)
-        for (int j = indmin[1]; j <= indmax[1]; j++) {
-            multi<int, 2> ind = {i, j};
-            float_type weight = std::forward<Tfilt>(filt)(ind - loc);
-            if (weight != float_type(0)) {
-
-                // Lookup entry.
-                auto& target =
-                    this->operator[](
-                    this->convert(cycle(ind)));
-
-                // Add.
-                target =
-                    fstretch<entry_type>(weight * val +
-                    fstretch<float_type>(target));
-            }
+        #else
+        (void) pool;
+        #endif // #if PREFORM_IMAGE2_USE_THREADS
+        for (size_type index = 0; index < band_count; index++) {
+            band_func(index);
         }
     }
 
-    /**@}*/
-
-private:
-
     /**
-     * @brief Cycle mode.
-     *
-     *  Value | Behavior
-     * -------|----------
-     *  0     | Clamp
-     *  +1    | Repeat
-     *  -1    | Repeat with mirroring
+     * @brief Resample with separable filter.
      */
-    multi<int, 2> cycle_mode_ = {};
+    template <typename Tfilt>
+    void resample_separable_(
+            thread_pool* pool,
+            multi<size_type, 2> count, const Tfilt& filt)
+    {
+        if ((count == size_type(0)).any()) {
+            this->clear();
+            return;
+        }
+        if (this->empty()) {
+            this->resize(count);
+            return;
+        }
 
-#if !DOXYGEN
+        // Weight tables.
+        filter_weight_table<float_type> table0 =
+        filter_weight_table<float_type>::from_separable(
+                this->user_size_[0], count[0], filt, 0,
+                [&](int ind) { return cycle(ind, 0); });
+        filter_weight_table<float_type> table1 =
+        filter_weight_table<float_type>::from_separable(
+                this->user_size_[1], count[1], filt, 1,
+                [&](int ind) { return cycle(ind, 1); });
 
-    /**
-     * @brief Cycle.
-     */
-    multi<int, 2> cycle(multi<int, 2> ind) const
-    {
-        for (int l = 0; l < 2; l++) {
-            switch (cycle_mode_[l]) {
-                default:
-                case 0:
-                    ind[l] = clamp(ind[l], int(this->user_size_[l]));
-                    break;
-                case +1:
-                    ind[l] = repeat(ind[l], int(this->user_size_[l]));
-                    break;
-                case -1:
-                    ind[l] = mirror(ind[l], int(this->user_size_[l]));
-                    break;
+        // Temporary image.
+        image2 image(std::move(*this));
+        multi<size_type, 2> size = image.user_size_;
+
+        // Filter along 1st dimension into rows of intermediate,
+        // which are contiguous in the 1st dimension.
+        std::vector<multi<float_type, N>> inter(size[0] * count[1]);
+        for_each_band_(pool, size[0], [&](size_type from, size_type to) {
+            std::vector<multi<float_type, N>> row(size[1]);
+            for (size_type i = from; i < to; i++) {
+                for (size_type k = 0; k < size[1]; k++) {
+                    row[k] = decode_(image(i, k));
+                }
+                multi<float_type, N>* out = &inter[i * count[1]];
+                for (size_type j = 0; j < count[1]; j++) {
+                    const int* index = table1.index(j);
+                    const float_type* weight = table1.weight(j);
+                    multi<float_type, N> acc = {};
+                    for (size_type tap = 0; tap < table1.taps(); tap++) {
+                        acc += weight[tap] * row[index[tap]];
+                    }
+                    out[j] = acc;
+                }
             }
-        }
-        return ind;
-    }
+        });
 
-    /**
-     * @brief Fetch.
-     */
-    multi<float_type, N> fetch(multi<int, 2> ind) const
-    {
-        return fstretch<float_type>(
-                        this->operator[](
-                        this->convert(cycle(ind))));
+        // Filter along 0th dimension, accumulating whole rows of
+        // intermediate at once.
+        this->resize(count);
+        for_each_band_(pool, count[0], [&](size_type from, size_type to) {
+            std::vector<multi<float_type, N>> acc(count[1]);
+            for (size_type i = from; i < to; i++) {
+                const int* index = table0.index(i);
+                const float_type* weight = table0.weight(i);
+                std::fill(acc.begin(), acc.end(), multi<float_type, N>{});
+                for (size_type tap = 0; tap < table0.taps(); tap++) {
+                    if (weight[tap] == 0) {
+                        continue;
+                    }
+                    const multi<float_type, N>* in =
+                        &inter[size_type(index[tap]) * count[1]];
+                    for (size_type j = 0; j < count[1]; j++) {
+                        acc[j] += weight[tap] * in[j];
+                    }
+                }
+                for (size_type j = 0; j < count[1]; j++) {
+                    (*this)(i, j) = encode_(acc[j]);
+                }
+            }
+        });
     }
 
 #endif // #if !DOXYGEN
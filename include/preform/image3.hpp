@@ -35,6 +35,12 @@
 #ifndef PREFORM_IMAGE3_HPP
 #define PREFORM_IMAGE3_HPP
 
+// for std::fill
+#include <algorithm>
+
+// for std::vector
+#include <vector>
+
 // for pre::block_array3
 #include <preform/block_array3.hpp>
 
@@ -47,6 +53,15 @@
 // for pre::multi wrappers
 #include <preform/multi_misc_float.hpp>
 
+// for pre::filter_weight_table
+#include <preform/image_filters.hpp>
+
+// for pre::image_storage_traits
+#include <preform/image_storage.hpp>
+
+// for PREFORM_PROFILE_ZONE
+#include <preform/profile.hpp>
+
 namespace pre {
 
 /**
@@ -80,8 +95,8 @@ public:
 
     // Sanity check.
     static_assert(
-        std::is_arithmetic<T>::value,
-        "T must be arithmetic");
+        image_storage_traits<T>::value,
+        "T must be arithmetic, half, or srgb8");
 
     /**
      * @brief Float type.
@@ -352,6 +367,43 @@ public:
         return {};
     }
 
+    /**
+     * @brief Sample many locations.
+     *
+     * Same result as calling `sample()` on each location, but with
+     * the sampling method dispatched once for the whole batch,
+     * and with wrapped indices computed once per dimension rather
+     * than once per texel.
+     *
+     * @param[in] samp
+     * Sampling method, either 0, 1, or 3.
+     *
+     * @param[in] locs
+     * Locations.
+     *
+     * @param[in] count
+     * Location count.
+     *
+     * @param[out] out
+     * Samples.
+     */
+    void sample_many(
+            int samp,
+            const multi<float_type, 3>* locs, size_type count,
+            multi<float_type, N>* out) const
+    {
+        if (this->empty()) {
+            std::fill(out, out + count, multi<float_type, N>{});
+            return;
+        }
+        switch (samp) {
+            default:
+            case 0: sample_many_<1>(locs, count, out); break;
+            case 1: sample_many_<2>(locs, count, out); break;
+            case 3: sample_many_<4>(locs, count, out); break;
+        }
+    }
+
     /**
      * @brief Resample.
      *
@@ -363,6 +415,8 @@ public:
      */
     void resample(int samp, multi<size_type, 3> count)
     {
+        PREFORM_PROFILE_ZONE("image3::resample");
+
         // Target size is equivalent?
         if ((count == this->user_size_).all()) {
             // Do nothing.
@@ -424,7 +478,7 @@ public:
                         scale_fac[2] * float_type(k + 1)
                     };
                     this->operator()(i, j, k) =
-                        fstretch<entry_type>(
+                        encode_(
                                  image.average(locmin, locmax));
                 }
             }
@@ -439,13 +493,69 @@ public:
                         scale_fac[2] * (float_type(k) + float_type(0.5))
                     };
                     this->operator()(i, j, k) =
-                        fstretch<entry_type>(
+                        encode_(
                                  image.sample(samp, loc));
                 }
             }
         }
     }
 
+    /**
+     * @brief Resample with separable filter.
+     *
+     * Resample in three 1-dimensional passes, along the 2nd, 1st,
+     * and 0th dimensions in turn, with weights tabulated once per
+     * pass by `filter_weight_table`. Boundaries follow the cycle mode.
+     *
+     * @param[in] count
+     * Count.
+     *
+     * @param[in] filt
+     * Filter, separable with radii `filt.r`, such as `box_filter3`,
+     * `triangle_filter3`, or `mitchell_filter3`.
+     */
+    template <typename Tfilt>
+    void resample_separable(multi<size_type, 3> count, const Tfilt& filt)
+    {
+        if ((count == size_type(0)).any()) {
+            this->clear();
+            return;
+        }
+        if (this->empty()) {
+            this->resize(count);
+            return;
+        }
+
+        // Gather into dense array.
+        multi<size_type, 3> size = this->user_size_;
+        std::vector<multi<float_type, N>> vals(size.prod());
+        for (size_type i = 0; i < size[0]; i++)
+        for (size_type j = 0; j < size[1]; j++)
+        for (size_type k = 0; k < size[2]; k++) {
+            vals[(i * size[1] + j) * size[2] + k] =
+                decode_((*this)(i, j, k));
+        }
+
+        // Filter each dimension in turn.
+        for (int l = 2; l >= 0; l--) {
+            filter_weight_table<float_type> table =
+            filter_weight_table<float_type>::from_separable(
+                    size[l], count[l], filt, l,
+                    [&](int ind) { return cycle(ind, l); });
+            vals = filter_dimension(vals, size, l, table);
+            size[l] = count[l];
+        }
+
+        // Scatter from dense array.
+        this->resize(count);
+        for (size_type i = 0; i < size[0]; i++)
+        for (size_type j = 0; j < size[1]; j++)
+        for (size_type k = 0; k < size[2]; k++) {
+            (*this)(i, j, k) =
+                encode_(vals[(i * size[1] + j) * size[2] + k]);
+        }
+    }
+
     /**
      * @brief Mip downsample.
      *
@@ -533,7 +643,17 @@ public:
                 (*this)(i, j, k) = vsum >> 3;
             }
             else {
-                // Error?
+                // Decode, average, and encode.
+                multi<float_type, N> vsum = {};
+                for (size_type kk = 0; kk < 2; kk++)
+                for (size_type ii = 0; ii < 2; ii++)
+                for (size_type jj = 0; jj < 2; jj++) {
+                    vsum += decode_(image(
+                            2 * i + ii,
+                            2 * j + jj,
+                            2 * k + kk));
+                }
+                (*this)(i, j, k) = encode_(vsum * float_type(0.125));
             }
         }
     }
@@ -598,8 +718,8 @@ public:
 
                 // Add.
                 target =
-                    fstretch<entry_type>(weight * val +
-                    fstretch<float_type>(target));
+                    encode_(weight * val +
+                    decode_(target));
             }
         }
     }
@@ -627,32 +747,170 @@ private:
     multi<int, 3> cycle(multi<int, 3> ind) const
     {
         for (int l = 0; l < 3; l++) {
-            switch (cycle_mode_[l]) {
-                default:
-                case 0:
-                    ind[l] = clamp(ind[l], int(this->user_size_[l]));
-                    break;
-                case +1:
-                    ind[l] = repeat(ind[l], int(this->user_size_[l]));
-                    break;
-                case -1:
-                    ind[l] = mirror(ind[l], int(this->user_size_[l]));
-                    break;
-            }
+            ind[l] = cycle(ind[l], l);
         }
         return ind;
     }
 
+    /**
+     * @brief Cycle in dimension.
+     */
+    int cycle(int ind, int l) const
+    {
+        switch (cycle_mode_[l]) {
+            default:
+            case 0:
+                return clamp(ind, int(this->user_size_[l]));
+            case +1:
+                return repeat(ind, int(this->user_size_[l]));
+            case -1:
+                return mirror(ind, int(this->user_size_[l]));
+        }
+    }
+
+    /**
+     * @brief Filter dense array along one dimension.
+     *
+     * Accumulates whole runs of the dimensions after `l` at once,
+     * since these are contiguous.
+     */
+    static std::vector<multi<float_type, N>> filter_dimension(
+                const std::vector<multi<float_type, N>>& vals,
+                multi<size_type, 3> size, int l,
+                const filter_weight_table<float_type>& table)
+    {
+        size_type outer = 1;
+        size_type inner = 1;
+        for (int m = 0; m < l; m++) outer *= size[m];
+        for (int m = l + 1; m < 3; m++) inner *= size[m];
+        std::vector<multi<float_type, N>> res(
+                outer * table.size() * inner);
+        for (size_type o = 0; o < outer; o++)
+        for (size_type pos = 0; pos < table.size(); pos++) {
+            multi<float_type, N>* out =
+                &res[(o * table.size() + pos) * inner];
+            const int* index = table.index(pos);
+            const float_type* weight = table.weight(pos);
+            for (size_type tap = 0; tap < table.taps(); tap++) {
+                if (weight[tap] == 0) {
+                    continue;
+                }
+                const multi<float_type, N>* in =
+                    &vals[(o * size[l] + size_type(index[tap])) * inner];
+                for (size_type q = 0; q < inner; q++) {
+                    out[q] += weight[tap] * in[q];
+                }
+            }
+        }
+        return res;
+    }
+
+    /**
+     * @brief Decode entry from storage.
+     */
+    static multi<float_type, N> decode_(const multi<T, N>& v)
+    {
+        return image_storage_traits<T>::template decode<float_type>(v);
+    }
+
+    /**
+     * @brief Encode entry to storage.
+     */
+    static multi<T, N> encode_(const multi<float_type, N>& v)
+    {
+        return image_storage_traits<T>::template encode<float_type>(v);
+    }
+
     /**
      * @brief Fetch.
      */
     multi<float_type, N> fetch(multi<int, 3> ind) const
     {
-        return fstretch<float_type>(
+        return decode_(
                         this->operator[](
                         this->convert(cycle(ind))));
     }
 
+    /**
+     * @brief Sample many locations, with taps per dimension.
+     */
+    template <int Ntaps>
+    void sample_many_(
+            const multi<float_type, 3>* locs, size_type count,
+            multi<float_type, N>* out) const
+    {
+        for (size_type n = 0; n < count; n++) {
+            multi<float_type, 3> loc = locs[n];
+            if constexpr (Ntaps == 1) {
+                out[n] = fetch(fastfloor(loc));
+                continue;
+            }
+            else {
+                // Shift.
+                loc -= float_type(0.5);
+
+                // Floor.
+                multi<int, 3> ind = fastfloor(loc);
+                loc -= ind;
+
+                // Wrap indices, only at boundaries.
+                int inds[3][Ntaps];
+                for (int l = 0; l < 3; l++) {
+                    int ind0 = ind[l] - (Ntaps / 2 - 1);
+                    if (ind0 >= 0 &&
+                        ind0 + Ntaps <= int(this->user_size_[l])) {
+                        for (int k = 0; k < Ntaps; k++) {
+                            inds[l][k] = ind0 + k;
+                        }
+                    }
+                    else {
+                        for (int k = 0; k < Ntaps; k++) {
+                            inds[l][k] = cycle(ind0 + k, l);
+                        }
+                    }
+                }
+
+                // Interpolate.
+                multi<float_type, N> val2[Ntaps];
+                for (int k = 0; k < Ntaps; k++) {
+                    multi<float_type, N> val0[Ntaps];
+                    for (int i = 0; i < Ntaps; i++) {
+                        multi<float_type, N> val1[Ntaps];
+                        for (int j = 0; j < Ntaps; j++) {
+                            val1[j] =
+                                decode_(
+                                this->operator[](
+                                this->convert(
+                                multi<int, 3>{
+                                    inds[0][i],
+                                    inds[1][j],
+                                    inds[2][k]
+                                })));
+                        }
+                        val0[i] = interpolate_<Ntaps>(loc[1], val1);
+                    }
+                    val2[k] = interpolate_<Ntaps>(loc[0], val0);
+                }
+                out[n] = interpolate_<Ntaps>(loc[2], val2);
+            }
+        }
+    }
+
+    /**
+     * @brief Interpolate taps, linear if 2 and Catmull-Rom if 4.
+     */
+    template <int Ntaps>
+    static multi<float_type, N> interpolate_(
+            float_type t, const multi<float_type, N>* val)
+    {
+        if constexpr (Ntaps == 2) {
+            return lerp(t, val[0], val[1]);
+        }
+        else {
+            return catmull(t, val[0], val[1], val[2], val[3]);
+        }
+    }
+
 #endif // #if !DOXYGEN
 };
 
@@ -35,6 +35,12 @@
 #ifndef PREFORM_IMAGE_FILTERS_HPP
 #define PREFORM_IMAGE_FILTERS_HPP
 
+// for std::max
+#include <algorithm>
+
+// for std::vector
+#include <vector>
+
 // for pre::multi
 #include <preform/multi.hpp>
 
@@ -265,6 +271,201 @@ using mitchell_filter2 = mitchell_filter<T, 2>;
 template <typename T>
 using mitchell_filter3 = mitchell_filter<T, 3>;
 
+/**
+ * @brief Filter weight table.
+ *
+ * Normalized 1-dimensional filter weights for resampling one
+ * dimension, tabulated once per output index. Since all filters
+ * above are separable, resampling any dimension of an image of
+ * any rank is then a 1-dimensional convolution per pass, which
+ * evaluates the filter @f$ O(n k) @f$ rather than @f$ O(n^d k^d) @f$
+ * times.
+ *
+ * Output index @f$ j @f$ is centered at @f$ s (j + 1/2) @f$ in input
+ * coordinates, where @f$ s @f$ is the input count over the output
+ * count. When downsampling, the filter is stretched by @f$ s @f$, so
+ * that it prefilters properly.
+ *
+ * @tparam T
+ * Float type.
+ */
+template <typename T>
+class filter_weight_table
+{
+public:
+
+    // Sanity check.
+    static_assert(
+        std::is_floating_point<T>::value,
+        "T must be floating point");
+
+    /**
+     * @brief Size type.
+     */
+    typedef std::size_t size_type;
+
+public:
+
+    /**
+     * @brief Default constructor.
+     */
+    filter_weight_table() = default;
+
+    /**
+     * @brief Constructor.
+     *
+     * @param[in] in_count
+     * Input count.
+     *
+     * @param[in] out_count
+     * Output count.
+     *
+     * @param[in] radius
+     * Filter radius, beyond which filter is zero.
+     *
+     * @param[in] filt
+     * 1-dimensional filter, with signature equivalent to `T(T)`.
+     *
+     * @param[in] cycle
+     * Function mapping any input index into range, with signature
+     * equivalent to `int(int)`, e.g., to clamp or repeat.
+     */
+    template <typename Tfilt, typename Tcycle>
+    filter_weight_table(
+            size_type in_count,
+            size_type out_count,
+            T radius,
+            Tfilt&& filt,
+            Tcycle&& cycle)
+    {
+        // Scale factor, and stretch if downsampling.
+        T scale = T(in_count) / T(out_count);
+        T stretch = std::max(scale, T(1));
+        radius *= stretch;
+
+        taps_ = size_type(fastceil(2 * radius)) + 1;
+        index_.resize(out_count * taps_);
+        weight_.resize(out_count * taps_);
+        for (size_type pos = 0; pos < out_count; pos++) {
+            int* index = &index_[pos * taps_];
+            T* weight = &weight_[pos * taps_];
+
+            // Input pixel centers in support.
+            T center = scale * (T(pos) + T(0.5));
+            int first = fastceil(center - radius - T(0.5));
+            T sum = 0;
+            for (size_type tap = 0; tap < taps_; tap++) {
+                index[tap] = cycle(first + int(tap));
+                weight[tap] =
+                    filt((T(first + int(tap)) + T(0.5) - center) / stretch);
+                sum += weight[tap];
+            }
+
+            // Normalize, or fall back to nearest.
+            if (sum != 0) {
+                for (size_type tap = 0; tap < taps_; tap++) {
+                    weight[tap] /= sum;
+                }
+            }
+            else {
+                for (size_type tap = 0; tap < taps_; tap++) {
+                    weight[tap] = 0;
+                }
+                index[0] = cycle(fastfloor(center));
+                weight[0] = 1;
+            }
+        }
+    }
+
+    /**
+     * @brief Constructor, from dimension of separable filter.
+     *
+     * @param[in] in_count
+     * Input count.
+     *
+     * @param[in] out_count
+     * Output count.
+     *
+     * @param[in] filt
+     * Separable filter with radii `filt.r`, such as
+     * `mitchell_filter`.
+     *
+     * @param[in] l
+     * Dimension.
+     *
+     * @param[in] cycle
+     * Function mapping any input index into range, as above.
+     */
+    template <typename Tfilt, typename Tcycle>
+    static filter_weight_table from_separable(
+            size_type in_count,
+            size_type out_count,
+            const Tfilt& filt, int l,
+            Tcycle&& cycle)
+    {
+        typedef decltype(filt.r) radii_type;
+        return filter_weight_table(
+                in_count, out_count, T(filt.r[l]),
+                [&](T x) {
+                    radii_type xs = {};
+                    xs[l] = x;
+                    return T(filt(xs));
+                },
+                std::forward<Tcycle>(cycle));
+    }
+
+public:
+
+    /**
+     * @brief Taps per output index.
+     */
+    size_type taps() const noexcept
+    {
+        return taps_;
+    }
+
+    /**
+     * @brief Output count.
+     */
+    size_type size() const noexcept
+    {
+        return taps_ == 0 ? 0 : index_.size() / taps_;
+    }
+
+    /**
+     * @brief Input indexes for output index, in range after cycling.
+     */
+    const int* index(size_type pos) const noexcept
+    {
+        return &index_[pos * taps_];
+    }
+
+    /**
+     * @brief Normalized weights for output index.
+     */
+    const T* weight(size_type pos) const noexcept
+    {
+        return &weight_[pos * taps_];
+    }
+
+private:
+
+    /**
+     * @brief Taps per output index.
+     */
+    size_type taps_ = 0;
+
+    /**
+     * @brief Input indexes.
+     */
+    std::vector<int> index_;
+
+    /**
+     * @brief Weights.
+     */
+    std::vector<T> weight_;
+};
+
 /**@}*/
 
 } // namespace pre
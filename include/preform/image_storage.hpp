@@ -0,0 +1,240 @@
+/* Copyright (c) 2018-20 M. Grady Saunders
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer.
+ *
+ *   2. Redistributions in binary form must reproduce the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer in the documentation and/or other materials
+ *      provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*+-+*/
+#if !DOXYGEN
+#if !(__cplusplus >= 201703L)
+#error "preform/image_storage.hpp requires >=C++17"
+#endif // #if !(__cplusplus >= 201703L)
+#endif // #if !DOXYGEN
+#pragma once
+#ifndef PREFORM_IMAGE_STORAGE_HPP
+#define PREFORM_IMAGE_STORAGE_HPP
+
+// for std::array
+#include <array>
+
+// for std::uint8_t
+#include <cstdint>
+
+// for std::is_arithmetic
+#include <type_traits>
+
+// for pre::srgbdec, pre::srgbenc
+#include <preform/color.hpp>
+
+// for pre::half
+#include <preform/half.hpp>
+
+// for pre::multi
+#include <preform/multi.hpp>
+
+// for pre::multi wrappers
+#include <preform/multi_misc_float.hpp>
+
+namespace pre {
+
+/**
+ * @defgroup image_storage Image storage
+ *
+ * `<preform/image_storage.hpp>`
+ *
+ * __C++ version__: >=C++17
+ *
+ * Storage types for image entries, which images decode to float
+ * only when fetching, and encode from float only when storing.
+ * Besides arithmetic types, converted by `fstretch()`, these are
+ * `half`, for 2 bytes per channel, and `srgb8`, for 1 byte per
+ * channel with sRGB-encoded color.
+ */
+/**@{*/
+
+/**
+ * @brief 8-bit sRGB storage.
+ *
+ * With 3 or more channels, the first 3 channels are sRGB-encoded
+ * color, and the remaining channels, such as alpha, are linear
+ * unsigned normalized. With fewer channels, all channels are
+ * sRGB-encoded.
+ */
+struct srgb8
+{
+    /**
+     * @brief Encoded value.
+     */
+    std::uint8_t value = 0;
+
+    /**
+     * @brief Equal?
+     */
+    constexpr bool operator==(srgb8 other) const noexcept
+    {
+        return value == other.value;
+    }
+
+    /**
+     * @brief Not equal?
+     */
+    constexpr bool operator!=(srgb8 other) const noexcept
+    {
+        return value != other.value;
+    }
+};
+
+/**
+ * @brief Image storage traits.
+ *
+ * Arithmetic types, converted by `fstretch()`, so that integral
+ * types are normalized.
+ */
+template <typename T, typename = void>
+struct image_storage_traits
+{
+    /**
+     * @brief Is valid storage type?
+     */
+    static constexpr bool value = std::is_arithmetic<T>::value;
+
+    /**
+     * @brief Decode.
+     */
+    template <typename Tfloat, std::size_t N>
+    static multi<Tfloat, N> decode(const multi<T, N>& v)
+    {
+        return fstretch<Tfloat>(v);
+    }
+
+    /**
+     * @brief Encode.
+     */
+    template <typename Tfloat, std::size_t N>
+    static multi<T, N> encode(const multi<Tfloat, N>& v)
+    {
+        return fstretch<T>(v);
+    }
+};
+
+/**
+ * @brief Image storage traits, for half.
+ */
+template <>
+struct image_storage_traits<half>
+{
+    /**
+     * @brief Is valid storage type?
+     */
+    static constexpr bool value = true;
+
+    /**
+     * @brief Decode.
+     */
+    template <typename Tfloat, std::size_t N>
+    static multi<Tfloat, N> decode(const multi<half, N>& v)
+    {
+        multi<Tfloat, N> res;
+        for (std::size_t k = 0; k < N; k++) {
+            res[k] = Tfloat(float(v[k]));
+        }
+        return res;
+    }
+
+    /**
+     * @brief Encode.
+     */
+    template <typename Tfloat, std::size_t N>
+    static multi<half, N> encode(const multi<Tfloat, N>& v)
+    {
+        multi<half, N> res;
+        for (std::size_t k = 0; k < N; k++) {
+            res[k] = half(float(v[k]));
+        }
+        return res;
+    }
+};
+
+/**
+ * @brief Image storage traits, for 8-bit sRGB.
+ */
+template <>
+struct image_storage_traits<srgb8>
+{
+    /**
+     * @brief Is valid storage type?
+     */
+    static constexpr bool value = true;
+
+    /**
+     * @brief Decode.
+     */
+    template <typename Tfloat, std::size_t N>
+    static multi<Tfloat, N> decode(const multi<srgb8, N>& v)
+    {
+        const std::array<float, 256>& table = decode_table();
+        multi<Tfloat, N> res;
+        for (std::size_t k = 0; k < N; k++) {
+            res[k] = k < 3 || N < 3 ?
+                Tfloat(table[v[k].value]) :
+                fstretch<Tfloat>(v[k].value);
+        }
+        return res;
+    }
+
+    /**
+     * @brief Encode.
+     */
+    template <typename Tfloat, std::size_t N>
+    static multi<srgb8, N> encode(const multi<Tfloat, N>& v)
+    {
+        multi<srgb8, N> res;
+        for (std::size_t k = 0; k < N; k++) {
+            res[k].value = fstretch<std::uint8_t>(
+                    k < 3 || N < 3 ? srgbenc(v[k]) : v[k]);
+        }
+        return res;
+    }
+
+    /**
+     * @brief Decode table, from encoded value to linear value.
+     */
+    static const std::array<float, 256>& decode_table()
+    {
+        static const std::array<float, 256> table = []() {
+            std::array<float, 256> res;
+            for (int k = 0; k < 256; k++) {
+                res[k] = float(srgbdec(double(k) / 255.0));
+            }
+            return res;
+        }();
+        return table;
+    }
+};
+
+/**@}*/
+
+} // namespace pre
+
+#endif // #ifndef PREFORM_IMAGE_STORAGE_HPP
@@ -35,12 +35,42 @@
 #ifndef PREFORM_KDTREE_HPP
 #define PREFORM_KDTREE_HPP
 
-// for std::nth_element
+#if !DOXYGEN
+#ifndef PREFORM_KDTREE_USE_THREADS
+#define PREFORM_KDTREE_USE_THREADS 1
+#endif // PREFORM_KDTREE_USE_THREADS
+#ifndef PREFORM_KDTREE_COUNTERS
+#define PREFORM_KDTREE_COUNTERS 0
+#endif // #ifndef PREFORM_KDTREE_COUNTERS
+#endif // #if !DOXYGEN
+
+// for std::nth_element, std::sort, std::fill
 #include <algorithm>
 
-// for std::allocator
+// for std::array
+#include <array>
+
+// for std::uint32_t, std::uint64_t, std::uintptr_t
+#include <cstdint>
+
+// for std::memcmp, std::memcpy, std::memset
+#include <cstring>
+
+// for std::istream
+#include <istream>
+
+// for std::allocator, std::unique_ptr
 #include <memory>
 
+// for std::ostream
+#include <ostream>
+
+// for std::invalid_argument, std::runtime_error
+#include <stdexcept>
+
+// for std::is_invocable, std::is_void, std::invoke_result_t
+#include <type_traits>
+
 // for std::vector
 #include <vector>
 
@@ -53,11 +83,32 @@
 // for pre::aabb
 #include <preform/aabb.hpp>
 
+// for pre::byte_order, pre::byte_stream, pre::byte_swap
+#include <preform/byte_order.hpp>
+
 // for pre::iterator_range
 #include <preform/iterator_range.hpp>
 
+// for pre::morton_encode2, pre::morton_encode3
+#include <preform/misc_int.hpp>
+
+#if PREFORM_KDTREE_USE_THREADS
+
+// for pre::thread_pool, pre::task_group
+#include <preform/thread_pool.hpp>
+
+#endif // #if PREFORM_KDTREE_USE_THREADS
+
 namespace pre {
 
+#if !PREFORM_KDTREE_USE_THREADS && !DOXYGEN
+
+class thread_pool;
+
+class task_group;
+
+#endif // #if !PREFORM_KDTREE_USE_THREADS && !DOXYGEN
+
 /**
  * @defgroup kdtree Kd tree
  *
@@ -65,6 +116,155 @@ namespace pre {
  */
 /**@{*/
 
+/**
+ * @brief Tree statistics.
+ *
+ * Reported by `kdtree::stats()`. Every node holds exactly one
+ * value, so depths describe the balance of the tree.
+ */
+struct kdtree_stats
+{
+    /**
+     * @brief Node count.
+     */
+    std::size_t node_count = 0;
+
+    /**
+     * @brief Leaf count, that is, nodes without children.
+     */
+    std::size_t leaf_count = 0;
+
+    /**
+     * @brief Maximum node depth, where the root is at depth 0.
+     */
+    std::size_t max_depth = 0;
+
+    /**
+     * @brief Mean node depth.
+     */
+    double mean_depth = 0;
+
+    /**
+     * @brief Node count at each depth.
+     */
+    std::vector<std::size_t> depth_histogram;
+};
+
+/**
+ * @brief Per-thread traversal counters.
+ *
+ * Queries on `kdtree` and `linear_kdtree` accumulate into the
+ * counters of the calling thread only if `PREFORM_KDTREE_COUNTERS`
+ * is defined to 1. By default it is 0, and the counting compiles
+ * out entirely. Every node holds one value, so nodes visited is
+ * also the number of points tested.
+ */
+struct kdtree_counters
+{
+    /**
+     * @brief Nodes visited.
+     */
+    std::uint64_t nodes_visited = 0;
+
+    /**
+     * @brief Maximum recursion depth.
+     */
+    std::uint64_t max_stack_depth = 0;
+
+    /**
+     * @brief Current recursion depth, 0 between queries.
+     */
+    std::uint64_t stack_depth = 0;
+
+    /**
+     * @brief Clear, between queries.
+     */
+    void clear()
+    {
+        *this = kdtree_counters();
+    }
+
+    /**
+     * @brief Counters of calling thread.
+     */
+    static kdtree_counters& local()
+    {
+        thread_local kdtree_counters counters;
+        return counters;
+    }
+};
+
+#if !DOXYGEN
+
+/**
+ * @brief Count node visit, if counters enabled.
+ */
+__attribute__((always_inline))
+inline void kdtree_count_node_()
+{
+#if PREFORM_KDTREE_COUNTERS
+    kdtree_counters::local().nodes_visited++;
+#endif // #if PREFORM_KDTREE_COUNTERS
+}
+
+/**
+ * @brief Count recursion depth for scope, if counters enabled.
+ */
+struct kdtree_count_scope_
+{
+#if PREFORM_KDTREE_COUNTERS
+    kdtree_count_scope_()
+    {
+        kdtree_counters& counters = kdtree_counters::local();
+        if (counters.max_stack_depth < ++counters.stack_depth) {
+            counters.max_stack_depth = counters.stack_depth;
+        }
+    }
+
+    ~kdtree_count_scope_()
+    {
+        kdtree_counters::local().stack_depth--;
+    }
+#else
+    kdtree_count_scope_()
+    {
+    }
+#endif // #if PREFORM_KDTREE_COUNTERS
+};
+
+/**
+ * @brief Call nearby function, with or without distance-squared.
+ *
+ * @returns
+ * False to stop early, or true if the function returns `void`.
+ */
+template <typename Tfunc, typename Tnode, typename Tfloat>
+inline bool kdtree_nearby_call_(Tfunc& func, Tnode node, Tfloat dist2)
+{
+    if constexpr (std::is_invocable<Tfunc&, Tnode, Tfloat>::value) {
+        if constexpr (std::is_void<
+                std::invoke_result_t<Tfunc&, Tnode, Tfloat>>::value) {
+            func(node, dist2);
+            return true;
+        }
+        else {
+            return func(node, dist2);
+        }
+    }
+    else {
+        if constexpr (std::is_void<
+                std::invoke_result_t<Tfunc&, Tnode>>::value) {
+            func(node);
+            return true;
+        }
+        else {
+            return func(node);
+        }
+    }
+}
+
+#endif // #if !DOXYGEN
+
 /**
  * @brief Kd tree.
  *
@@ -205,6 +405,14 @@ public:
         clear();
     }
 
+public:
+
+    /**
+     * @brief Value count above which builds given a thread pool
+     * divide work into tasks.
+     */
+    static constexpr size_type parallel_cutoff = 16384;
+
 public:
 
     /**
@@ -234,31 +442,41 @@ public:
             Tinput_itr to,
             Tfunc&& func)
     {
-        // Clear.
-        clear();
-
-        // Count.
-        typename
-        std::iterator_traits<Tinput_itr>::difference_type
-            count = std::distance(from, to);
-        if (count < decltype(count)(1)) {
-            return;
-        }
+        init_(nullptr, from, to, std::forward<Tfunc>(func));
+    }
 
-        std::vector<value_type> values;
-        values.reserve(count);
-        while (from != to) {
-            values.emplace_back(std::forward<Tfunc>(func)(*from));
-            from++;
-        }
+#if PREFORM_KDTREE_USE_THREADS || DOXYGEN
 
-        root_ =
-        init_recursive({
-                &values[0],
-                &values[0] + values.size()
-            });
+    /**
+     * @brief Initialize in parallel.
+     *
+     * @param[in] pool
+     * Thread pool. Subtrees above `parallel_cutoff` values
+     * are built as tasks, and bounds and median selection at the
+     * upper levels are divided into chunks.
+     *
+     * @param[in] from
+     * Input from.
+     *
+     * @param[in] to
+     * Input to.
+     *
+     * @param[in] func
+     * Function constructing an instance of `value_type` for each
+     * input element, as in `init()`.
+     */
+    template <typename Tinput_itr, typename Tfunc>
+    void init(
+            thread_pool& pool,
+            Tinput_itr from,
+            Tinput_itr to,
+            Tfunc&& func)
+    {
+        init_(&pool, from, to, std::forward<Tfunc>(func));
     }
 
+#endif // #if PREFORM_KDTREE_USE_THREADS || DOXYGEN
+
     /**
      * @brief Clear.
      */
@@ -302,6 +520,54 @@ public:
 
     /**@}*/
 
+public:
+
+    /**
+     * @name Statistics
+     */
+    /**@{*/
+
+    /**
+     * @brief Statistics.
+     *
+     * Walks the whole tree, so this is for tuning rather than for
+     * use in inner loops.
+     */
+    kdtree_stats stats() const
+    {
+        kdtree_stats res;
+        if (!root_) {
+            return res;
+        }
+        double depth_sum = 0;
+        std::vector<std::pair<const node_type*, size_type>> todo;
+        todo.emplace_back(root_, 0);
+        while (!todo.empty()) {
+            auto [node, depth] = todo.back();
+            todo.pop_back();
+            res.node_count++;
+            res.max_depth = std::max(res.max_depth, depth);
+            depth_sum += double(depth);
+            if (res.depth_histogram.size() <= depth) {
+                res.depth_histogram.resize(depth + 1);
+            }
+            res.depth_histogram[depth]++;
+            if (!node->left && !node->right) {
+                res.leaf_count++;
+            }
+            if (node->right) {
+                todo.emplace_back(node->right, depth + 1);
+            }
+            if (node->left) {
+                todo.emplace_back(node->left, depth + 1);
+            }
+        }
+        res.mean_depth = depth_sum / double(res.node_count);
+        return res;
+    }
+
+    /**@}*/
+
 private:
 
     /**
@@ -358,45 +624,287 @@ private:
     }
 
     /**
-     * @brief Initialize recursively.
+     * @brief Initialize.
      */
-    node_type* init_recursive(iterator_range<value_type*> values)
+    template <typename Tinput_itr, typename Tfunc>
+    void init_(
+            thread_pool* pool,
+            Tinput_itr from,
+            Tinput_itr to,
+            Tfunc&& func)
     {
-        if (values.empty()) {
-            return nullptr;
+        // Clear.
+        clear();
+
+        // Count.
+        typename
+        std::iterator_traits<Tinput_itr>::difference_type
+            count = std::distance(from, to);
+        if (count < decltype(count)(1)) {
+            return;
+        }
+
+        std::vector<value_type> values;
+        values.reserve(count);
+        while (from != to) {
+            values.emplace_back(std::forward<Tfunc>(func)(*from));
+            from++;
         }
 
+        // Allocate nodes up front, such that the node for each
+        // split element is at the same offset as the element, and
+        // subtrees built as tasks never touch the allocator.
+        std::vector<node_type*> nodes;
+        nodes.reserve(values.size());
+        for (size_type pos = 0; pos < values.size(); pos++) {
+            nodes.push_back(allocate());
+        }
+
+        // Initialize.
+        task_group* group = nullptr;
+        std::vector<value_type> scratch;
+        #if PREFORM_KDTREE_USE_THREADS
+        std::unique_ptr<task_group> group_holder;
+        if (pool &&
+            values.size() > parallel_cutoff) {
+            group_holder.reset(new task_group(*pool));
+            group = group_holder.get();
+            scratch.resize(values.size());
+        }
+        #endif // #if PREFORM_KDTREE_USE_THREADS
+        root_ =
+        init_recursive(
+            {&values[0],
+             &values[0] + values.size()},
+            nodes.data(),
+            scratch.data(),
+            pool, group);
+        #if PREFORM_KDTREE_USE_THREADS
+        if (group) {
+            group->wait();
+        }
+        #endif // #if PREFORM_KDTREE_USE_THREADS
+    }
+
+    /**
+     * @brief Surround values.
+     */
+    static aabb<Tfloat, N> surround(
+            thread_pool* pool,
+            iterator_range<value_type*> values)
+    {
         aabb<Tfloat, N> box;
+
+        #if PREFORM_KDTREE_USE_THREADS
+        if (pool &&
+            size_type(values.size()) > parallel_cutoff) {
+            // Surround chunks in parallel.
+            size_type chunk_count = values.size() / (parallel_cutoff / 4);
+            std::vector<aabb<Tfloat, N>> chunks(chunk_count);
+            pool->parallel_for(
+                size_type(0), chunk_count, size_type(1),
+                [&](size_type chunk) {
+                    value_type* from =
+                        values.begin() +
+                        values.size() * chunk / chunk_count;
+                    value_type* to =
+                        values.begin() +
+                        values.size() * (chunk + 1) / chunk_count;
+                    for (; from < to; ++from) {
+                        chunks[chunk] |= from->first;
+                    }
+                });
+            for (const aabb<Tfloat, N>& chunk_box : chunks) {
+                box |= chunk_box;
+            }
+            return box;
+        }
+        #endif // #if PREFORM_KDTREE_USE_THREADS
+
+        (void) pool;
         for (const value_type& value : values) {
             box |= value.first;
         }
+        return box;
+    }
+
+    /**
+     * @brief Select split element.
+     *
+     * Above `parallel_cutoff` values, this runs quickselect with
+     * each three-way partition divided into chunks, counted and
+     * scattered through the scratch buffer in parallel, and falls
+     * back to `std::nth_element()` once the range is small enough.
+     */
+    static void select(
+            thread_pool* pool,
+            iterator_range<value_type*> values,
+            value_type* split,
+            size_type split_dim,
+            value_type* scratch)
+    {
+        value_type* from = values.begin();
+        value_type* to = values.end();
+
+        #if PREFORM_KDTREE_USE_THREADS
+        while (pool &&
+               size_type(to - from) > parallel_cutoff) {
+            size_type count = to - from;
+            value_type* scratch_from = scratch + (from - values.begin());
+
+            // Pivot from median of samples.
+            constexpr size_type sample_count = 63;
+            Tfloat samples[sample_count];
+            for (size_type sample = 0; sample < sample_count; sample++) {
+                samples[sample] =
+                    from[count * (2 * sample + 1) /
+                                 (2 * sample_count)].first[split_dim];
+            }
+            std::nth_element(
+                    &samples[0],
+                    &samples[0] + sample_count / 2,
+                    &samples[0] + sample_count);
+            Tfloat pivot = samples[sample_count / 2];
+
+            // Count less and equal in chunks.
+            size_type chunk_count = count / (parallel_cutoff / 4);
+            std::vector<std::array<size_type, 3>> chunks(chunk_count);
+            auto chunk_range = [=](size_type chunk) {
+                return std::make_pair(
+                        from + count * chunk / chunk_count,
+                        from + count * (chunk + 1) / chunk_count);
+            };
+            pool->parallel_for(
+                size_type(0), chunk_count, size_type(1),
+                [&](size_type chunk) {
+                    auto [chunk_from, chunk_to] = chunk_range(chunk);
+                    size_type count_less = 0;
+                    size_type count_equal = 0;
+                    for (; chunk_from < chunk_to; ++chunk_from) {
+                        Tfloat value = chunk_from->first[split_dim];
+                        count_less += value < pivot;
+                        count_equal += value == pivot;
+                    }
+                    chunks[chunk] = {
+                        count_less,
+                        count_equal,
+                        size_type(0)
+                    };
+                });
+
+            // Convert counts to scatter offsets.
+            size_type offset_less = 0;
+            size_type offset_equal = 0;
+            for (std::array<size_type, 3>& chunk : chunks) {
+                offset_equal += chunk[0];
+            }
+            size_type offset_greater = offset_equal;
+            for (std::array<size_type, 3>& chunk : chunks) {
+                offset_greater += chunk[1];
+            }
+            size_type count_less = offset_equal;
+            size_type count_equal = offset_greater - offset_equal;
+            for (size_type chunk = 0; chunk < chunk_count; chunk++) {
+                auto [chunk_from, chunk_to] = chunk_range(chunk);
+                size_type chunk_less = chunks[chunk][0];
+                size_type chunk_equal = chunks[chunk][1];
+                size_type chunk_greater =
+                    size_type(chunk_to - chunk_from) -
+                    chunk_less - chunk_equal;
+                chunks[chunk] = {
+                    offset_less,
+                    offset_equal,
+                    offset_greater
+                };
+                offset_less += chunk_less;
+                offset_equal += chunk_equal;
+                offset_greater += chunk_greater;
+            }
+
+            // Scatter to scratch.
+            pool->parallel_for(
+                size_type(0), chunk_count, size_type(1),
+                [&](size_type chunk) {
+                    auto [chunk_from, chunk_to] = chunk_range(chunk);
+                    std::array<size_type, 3> offset = chunks[chunk];
+                    for (; chunk_from < chunk_to; ++chunk_from) {
+                        Tfloat value = chunk_from->first[split_dim];
+                        int which = (value < pivot) ? 0 :
+                                    (value == pivot) ? 1 : 2;
+                        scratch_from[offset[which]++] =
+                            std::move(*chunk_from);
+                    }
+                });
+
+            // Move back.
+            pool->parallel_for(
+                size_type(0), chunk_count, size_type(1),
+                [&](size_type chunk) {
+                    auto [chunk_from, chunk_to] = chunk_range(chunk);
+                    std::move(
+                        scratch_from + (chunk_from - from),
+                        scratch_from + (chunk_to - from),
+                        chunk_from);
+                });
+
+            // Narrow to the range containing the split element.
+            if (split < from + count_less) {
+                to = from + count_less;
+            }
+            else if (split < from + count_less + count_equal) {
+                return;
+            }
+            else {
+                from = from + count_less + count_equal;
+            }
+        }
+        #endif // #if PREFORM_KDTREE_USE_THREADS
+
+        (void) pool;
+        (void) scratch;
+        std::nth_element(
+                from, split, to,
+                [=](const value_type& value0,
+                    const value_type& value1) -> bool {
+                    return value0.first[split_dim] <
+                           value1.first[split_dim];
+                });
+    }
+
+    /**
+     * @brief Initialize recursively.
+     */
+    node_type* init_recursive(
+            iterator_range<value_type*> values,
+            node_type** nodes,
+            value_type* scratch,
+            thread_pool* pool,
+            task_group* group)
+    {
+        if (values.empty()) {
+            return nullptr;
+        }
+
+        aabb<Tfloat, N> box = surround(pool, values);
 
         // Split dimension.
         size_type split_dim = box.diag().argmax();
 
         // Split element.
+        size_type split_offset = values.size() / 2;
         value_type* split =
                 values.begin() +
-                values.size() / 2;
+                split_offset;
 
         if (values.size() > 1) {
 
             // Partition.
-            std::nth_element(
-                    values.begin(), split,
-                    values.end(),
-                    [=](const value_type& value0,
-                        const value_type& value1) -> bool {
-                        return value0.first[split_dim] <
-                               value1.first[split_dim];
-                    });
+            select(pool, values, split, split_dim, scratch);
 
         }
 
-        // Allocate node.
-        node_type* node = allocate();
-
         // Initialize node.
+        node_type* node = nodes[split_offset];
         *node = {
             *split,
             nullptr,
@@ -404,13 +912,47 @@ private:
             std::uint32_t(split_dim)
         };
 
+        #if PREFORM_KDTREE_USE_THREADS
+        // Count sufficiently large?
+        if (group &&
+            size_type(values.size()) > parallel_cutoff) {
+
+            // Recurse as task to initialize left child.
+            value_type* from = values.begin();
+            group->run(
+            [this, node, from, split, nodes, scratch, pool, group]() {
+                node->left =
+                init_recursive(
+                    {from, split},
+                    nodes, scratch,
+                    pool, group);
+            });
+
+            // Recurse to initialize right child.
+            node->right =
+            init_recursive(
+                {split + 1, values.end()},
+                nodes + split_offset + 1,
+                scratch ? scratch + split_offset + 1 : nullptr,
+                pool, group);
+            return node;
+        }
+        #endif // #if PREFORM_KDTREE_USE_THREADS
+
         // Recurse to initialize left child.
         node->left =
-        init_recursive({values.begin(), split});
+        init_recursive(
+            {values.begin(), split},
+            nodes, scratch,
+            pool, group);
 
         // Recurse to initialize right child.
         node->right =
-        init_recursive({split + 1, values.end()});
+        init_recursive(
+            {split + 1, values.end()},
+            nodes + split_offset + 1,
+            scratch ? scratch + split_offset + 1 : nullptr,
+            pool, group);
 
         return node;
     }
@@ -422,13 +964,31 @@ public:
      *
      * @param[in] point
      * Reference point.
+     *
+     * @param[in] eps
+     * Approximation epsilon. Subtrees are culled unless they may
+     * contain a node closer than the current nearest node divided
+     * by `1 + eps`, so the result is within a factor of `1 + eps`
+     * of the true nearest distance. By default, 0, for the exact
+     * nearest neighbor.
+     *
+     * @param[in] max_visits
+     * Maximum number of nodes to visit. Traversal descends towards
+     * the reference point first, so the result after any number of
+     * visits is a reasonable guess, but is not guaranteed to be
+     * within `1 + eps`. By default, unlimited.
      */
-    node_dist2_pair_type nearest(const point_type& point) const
+    node_dist2_pair_type nearest(
+            const point_type& point,
+            float_type eps = 0,
+            size_type max_visits = size_type(-1)) const
     {
         nearest_recursive_info1 info;
         info.point = point;
         info.near.first = nullptr;
         info.near.second = pre::numeric_limits<float_type>::infinity();
+        info.scale2 = (1 + eps) * (1 + eps);
+        info.visits = max_visits;
         if (root_) {
             nearest_recursive(info, root_);
         }
@@ -453,6 +1013,16 @@ private:
          * @brief Nearest node/distance-squared pair.
          */
         node_dist2_pair_type near;
+
+        /**
+         * @brief Split plane distance-squared scale, `(1 + eps)^2`.
+         */
+        float_type scale2;
+
+        /**
+         * @brief Remaining visits.
+         */
+        size_type visits;
     };
 
     /**
@@ -468,6 +1038,14 @@ private:
     void nearest_recursive(
          nearest_recursive_info1& info, const node_type* node)
     {
+        // Out of visits?
+        if (info.visits == 0) {
+            return;
+        }
+        info.visits--;
+        kdtree_count_scope_ scope;
+        kdtree_count_node_();
+
         // Difference.
         point_type diff = node->value.first - info.point;
 
@@ -482,7 +1060,7 @@ private:
 
         // Signed distance to split plane.
         float_type min_dist = diff[node->split_dim];
-        float_type min_dist2 = min_dist * min_dist;
+        float_type min_dist2 = min_dist * min_dist * info.scale2;
 
         // If point is on left, process left child first.
         // If point is on right, process right child first.
@@ -526,6 +1104,18 @@ public:
      * @param[out] near_end
      * Nearest node/distance-squared pairs range end.
      *
+     * @param[in] eps
+     * Approximation epsilon. Subtrees are culled unless they may
+     * contain a node closer than the current furthest node divided
+     * by `1 + eps`, so the distance to the `i`th result is within
+     * a factor of `1 + eps` of the true `i`th nearest distance. By
+     * default, 0, for the exact nearest neighbors.
+     *
+     * @param[in] max_visits
+     * Maximum number of nodes to visit, as in the nearest neighbor
+     * overload. If less than `near_end - near`, fewer
+     * pairs may be returned. By default, unlimited.
+     *
      * @return
      * Returns the effective end of the nearest
      * node/distance-squared pair range,
@@ -544,7 +1134,9 @@ public:
     node_dist2_pair_type* nearest(
             const point_type& point,
             node_dist2_pair_type* near,
-            node_dist2_pair_type* near_end) const
+            node_dist2_pair_type* near_end,
+            float_type eps = 0,
+            size_type max_visits = size_type(-1)) const
     {
         if (near == nullptr || near_end == nullptr ||
             near >= near_end) {
@@ -556,6 +1148,8 @@ public:
         info.near = near;
         info.near_end = near_end;
         info.near_top = near;
+        info.scale2 = (1 + eps) * (1 + eps);
+        info.visits = max_visits;
         if (root_) {
             nearest_recursive(info, root_);
         }
@@ -600,11 +1194,21 @@ private:
          * @brief Nearest node/distance-squared pairs heap top.
          */
         node_dist2_pair_type* near_top;
-    };
 
-    /**
-     * @brief Nearest neighbors, recursive algorithm.
-     *
+        /**
+         * @brief Split plane distance-squared scale, `(1 + eps)^2`.
+         */
+        float_type scale2;
+
+        /**
+         * @brief Remaining visits.
+         */
+        size_type visits;
+    };
+
+    /**
+     * @brief Nearest neighbors, recursive algorithm.
+     *
      * @param[inout] info
      * Info.
      *
@@ -615,6 +1219,14 @@ private:
     void nearest_recursive(
          nearest_recursive_info2& info, const node_type* node)
     {
+        // Out of visits?
+        if (info.visits == 0) {
+            return;
+        }
+        info.visits--;
+        kdtree_count_scope_ scope;
+        kdtree_count_node_();
+
         // Compare operator.
         constexpr auto near_cmp =
         [](const node_dist2_pair_type& lhs,
@@ -630,7 +1242,7 @@ private:
 
         // Signed distance to split plane.
         float_type min_dist = diff[node->split_dim];
-        float_type min_dist2 = min_dist * min_dist;
+        float_type min_dist2 = min_dist * min_dist * info.scale2;
 
         // If point is on left, process left child first.
         // If point is on right, process right child first.
@@ -699,12 +1311,210 @@ private:
 
 #endif // #if !DOXYGEN
 
+public:
+
+    /**
+     * @brief Nearest neighbors, batched.
+     *
+     * Sorts reference points in Morton order, such that consecutive
+     * queries visit mostly the same nodes, then answers them in that
+     * order.
+     *
+     * @param[in] points
+     * Reference points.
+     *
+     * @param[in] count
+     * Reference point count.
+     *
+     * @param[in] k
+     * Nearest neighbor count per reference point.
+     *
+     * @param[out] near
+     * Nearest node/distance-squared pairs, as `count` consecutive
+     * ranges of `k` pairs, each sorted in ascending order by
+     * distance-squared as in `nearest()`. If there are fewer than `k`
+     * nodes, trailing pairs are nullptr and infinity.
+     */
+    void nearest(
+            const point_type* points,
+            size_type count,
+            size_type k,
+            node_dist2_pair_type* near) const
+    {
+        nearest_batch(nullptr, points, count, k, near);
+    }
+
+#if PREFORM_KDTREE_USE_THREADS || DOXYGEN
+
+    /**
+     * @brief Nearest neighbors, batched, in parallel.
+     *
+     * As above, except that blocks of consecutive queries in Morton
+     * order are spread over the thread pool.
+     *
+     * @param[in] pool
+     * Thread pool.
+     *
+     * @param[in] points
+     * Reference points.
+     *
+     * @param[in] count
+     * Reference point count.
+     *
+     * @param[in] k
+     * Nearest neighbor count per reference point.
+     *
+     * @param[out] near
+     * Nearest node/distance-squared pairs, as above.
+     */
+    void nearest(
+            thread_pool& pool,
+            const point_type* points,
+            size_type count,
+            size_type k,
+            node_dist2_pair_type* near) const
+    {
+        nearest_batch(&pool, points, count, k, near);
+    }
+
+#endif // #if PREFORM_KDTREE_USE_THREADS || DOXYGEN
+
+private:
+
+#if !DOXYGEN
+
+    /**
+     * @brief Morton code of point, normalized to the unit hypercube.
+     */
+    static std::uint64_t morton_code(const point_type& point)
+    {
+        // At most 63, so that shifting by it is defined for N == 1.
+        constexpr size_type bits = N == 1 ? 63 : (N < 64 ? 64 / N : 1);
+        std::uint64_t code = 0;
+        std::uint64_t quant[N];
+        for (size_type k = 0; k < N; k++) {
+            float_type x = point[k] * float_type(std::uint64_t(1) << bits);
+            x = x < 0 ? 0 : x;
+            quant[k] = std::uint64_t(x);
+            quant[k] = std::min(quant[k], (std::uint64_t(1) << bits) - 1);
+        }
+        if constexpr (N == 2) {
+            code = morton_encode2(quant[1], quant[0]);
+        }
+        else if constexpr (N == 3) {
+            code = morton_encode3(quant[2], quant[1], quant[0]);
+        }
+        else {
+            for (size_type b = bits; b-- > 0;) {
+                for (size_type k = 0; k < N; k++) {
+                    code = (code << 1) | ((quant[k] >> b) & 1);
+                }
+            }
+        }
+        return code;
+    }
+
+    /**
+     * @brief Nearest neighbors, batched, implementation.
+     */
+    void nearest_batch(
+            thread_pool* pool,
+            const point_type* points,
+            size_type count,
+            size_type k,
+            node_dist2_pair_type* near) const
+    {
+        if (count == 0 || k == 0) {
+            return;
+        }
+
+        // Sort in Morton order.
+        aabb<Tfloat, N> box;
+        for (size_type pos = 0; pos < count; pos++) {
+            box |= points[pos];
+        }
+        point_type box_scale;
+        for (size_type dim = 0; dim < N; dim++) {
+            float_type diag = box[1][dim] - box[0][dim];
+            box_scale[dim] = diag > 0 ? 1 / diag : 0;
+        }
+        std::vector<std::pair<std::uint64_t, size_type>> order(count);
+        for (size_type pos = 0; pos < count; pos++) {
+            order[pos] = {
+                morton_code((points[pos] - box[0]) * box_scale),
+                pos
+            };
+        }
+        std::sort(order.begin(), order.end());
+
+        // Answer queries in order.
+        auto run = [&](size_type from, size_type to) {
+            for (size_type pos = from; pos < to; pos++) {
+                size_type index = order[pos].second;
+                node_dist2_pair_type* near_from = near + index * k;
+                node_dist2_pair_type* near_to = near_from + k;
+                node_dist2_pair_type* near_top = near_from;
+                if (root_) {
+                    near_top = nearest(points[index], near_from, near_to);
+                }
+                std::fill(
+                    near_top, near_to,
+                    node_dist2_pair_type(
+                        nullptr,
+                        pre::numeric_limits<float_type>::infinity()));
+            }
+        };
+        #if PREFORM_KDTREE_USE_THREADS
+        constexpr size_type block_size = 256;
+        if (pool &&
+            count > block_size) {
+            size_type block_count = (count + block_size - 1) / block_size;
+            pool->parallel_for(
+                size_type(0), block_count, size_type(1),
+                [&](size_type block) {
+                    run(block * block_size,
+                        std::min(count, (block + 1) * block_size));
+                });
+            return;
+        }
+        #endif // #if PREFORM_KDTREE_USE_THREADS
+        (void) pool;
+        run(0, count);
+    }
+
+#endif // #if !DOXYGEN
+
 public:
 
     /**
      * @brief Visit nearby nodes.
      *
-     * TODO
+     * @param[in] point
+     * Reference point.
+     *
+     * @param[in] cutoff_dist
+     * Cutoff distance, non-negative.
+     *
+     * @param[in] func
+     * Function called with each node strictly within the cutoff
+     * distance, in no particular order, and optionally with its
+     * distance-squared to the reference point. If the function
+     * returns `bool`, returning false stops early.
+     *
+     * @note
+     * Function must have signature equivalent to one of
+     * ~~~~~~~~~~~~~~~~~~~~~~~~~{cpp}
+     * bool(const node_type*)
+     * bool(const node_type*, float_type)
+     * void(const node_type*)
+     * void(const node_type*, float_type)
+     * ~~~~~~~~~~~~~~~~~~~~~~~~~
+     *
+     * @returns
+     * False if stopped early.
+     *
+     * @throw std::invalid_argument
+     * If `cutoff_dist` is negative or NaN.
      */
     template <typename Tfunc>
     bool nearby(
@@ -712,16 +1522,15 @@ public:
             float_type cutoff_dist,
             Tfunc&& func) const
     {
-        bool result = true;
-        float_type cutoff_dist2 = cutoff_dist * cutoff_dist;
-        if (root_) {
-            result =
-            nearby_recursive(
-                    point, cutoff_dist2,
-                    std::forward<Tfunc>(func),
-                    root_);
+        if (!(cutoff_dist >= 0)) {
+            throw std::invalid_argument(__PRETTY_FUNCTION__);
+        }
+        if (!root_) {
+            return true;
         }
-        return result;
+        return nearby_recursive(
+                point, cutoff_dist * cutoff_dist,
+                func, root_);
     }
 
 private:
@@ -732,68 +1541,954 @@ private:
      * @brief Visit nearby nodes, recursive algorithm.
      */
     template <typename Tfunc>
-    bool nearby_recursive(
+    static bool nearby_recursive(
             const point_type& point,
             float_type cutoff_dist2,
-            Tfunc&& func,
-            const node_type* node) const
+            Tfunc& func,
+            const node_type* node)
     {
-        // Difference.
-        point_type diff = node->value.first - point;
-
-        // Squared distance to reference point.
-        float_type dist2 = dot(diff, diff);
-
-        // Process node if within cutoff distance.
-        if (cutoff_dist2 > dist2) {
-            if (!std::forward<Tfunc>(func)(node)) {
-                return false;
-            }
-        }
-
-        // Signed distance to split plane.
-        float_type min_dist = diff[node->split_dim];
-        float_type min_dist2 = min_dist * min_dist;
+        kdtree_count_scope_ scope;
+        do {
+            kdtree_count_node_();
 
-        // If point is on left, process left child first.
-        // If point is on right, process right child first.
-        const node_type* child0 = node->left;
-        const node_type* child1 = node->right;
-        if (min_dist < 0) {
-            min_dist = -min_dist;
-            std::swap(child0, child1);
-        }
+            // Difference.
+            point_type diff = node->value.first - point;
 
-        if (child0) {
-            // Recurse only if necessary.
-            if (!(min_dist < 0 &&
-                  min_dist2 > cutoff_dist2)) {
+            // Squared distance to reference point.
+            float_type dist2 = dot(diff, diff);
 
-                if (!nearby_recursive(
-                        point,
-                        cutoff_dist2,
-                        std::forward<Tfunc>(func),
-                        child0)) {
+            // Process node if within cutoff distance.
+            if (cutoff_dist2 > dist2) {
+                if (!kdtree_nearby_call_(func, node, dist2)) {
                     return false;
                 }
             }
-        }
-        if (child1) {
-            // Recurse only if necessary.
-            if (!(min_dist > 0 &&
-                  min_dist2 > cutoff_dist2)) {
 
-                // Recurse only if necessary.
+            // Signed distance to split plane.
+            float_type min_dist = diff[node->split_dim];
+            float_type min_dist2 = min_dist * min_dist;
+
+            // Child on the same side as the point.
+            const node_type* child0 = node->left;
+            const node_type* child1 = node->right;
+            if (pre::signbit(min_dist)) {
+                std::swap(child0, child1);
+            }
+
+            // Recurse into the other side only if it intersects, and
+            // continue iteratively on the same side.
+            if (child1 &&
+                !(min_dist2 > cutoff_dist2)) {
                 if (!nearby_recursive(
-                        point,
-                        cutoff_dist2,
-                        std::forward<Tfunc>(func),
-                        child1)) {
+                        point, cutoff_dist2,
+                        func, child1)) {
                     return false;
                 }
             }
+            node = child0;
+        } while (node);
+
+        return true;
+    }
+
+#endif // #if !DOXYGEN
+};
+
+/**
+ * @brief Linear kd tree.
+ *
+ * Stores values contiguously in left-balanced implicit order, such that
+ * the children of the value at index `i` are at indices `2 * i + 1` and
+ * `2 * i + 2`, with split dimensions packed alongside. There are no
+ * child pointers, so this is about half the size of `kdtree`, and
+ * traversal touches far fewer cache lines.
+ *
+ * @tparam Tfloat
+ * Float type.
+ *
+ * @tparam N
+ * Dimension.
+ *
+ * @tparam Tvalue
+ * Value type.
+ *
+ * @tparam Talloc
+ * Allocator type.
+ */
+template <
+    typename Tfloat, std::size_t N,
+    typename Tvalue,
+    typename Talloc = std::allocator<char>
+    >
+class linear_kdtree
+{
+public:
+
+    // Sanity check.
+    static_assert(
+        std::is_floating_point<Tfloat>::value,
+        "Tfloat must be floating point");
+
+    // Sanity check.
+    static_assert(
+        N < 256,
+        "N must be less than 256");
+
+    /**
+     * @name Container typedefs
+     */
+    /**@{*/
+
+    /**
+     * @brief Size type.
+     */
+    typedef std::size_t size_type;
+
+    /**
+     * @brief Float type.
+     */
+    typedef Tfloat float_type;
+
+    /**
+     * @brief Point type.
+     */
+    typedef multi<Tfloat, N> point_type;
+
+    /**
+     * @brief Value type.
+     */
+    typedef std::pair<multi<Tfloat, N>, Tvalue> value_type;
+
+    /**
+     * @brief Value allocator type.
+     */
+    typedef typename std::allocator_traits<Talloc>::
+            template rebind_alloc<value_type> value_allocator_type;
+
+    /**
+     * @brief Split dimension allocator type.
+     */
+    typedef typename std::allocator_traits<Talloc>::
+            template rebind_alloc<std::uint8_t> split_dim_allocator_type;
+
+    /**
+     * @brief Value/distance-squared pair type.
+     */
+    typedef std::pair<const value_type*, float_type> value_dist2_pair_type;
+
+    /**@}*/
+
+public:
+
+    /**
+     * @name Constructors
+     */
+    /**@{*/
+
+    /**
+     * @brief Constructor.
+     *
+     * @param[in] alloc
+     * Allocator.
+     */
+    linear_kdtree(const Talloc& alloc = Talloc()) :
+            values_(alloc),
+            split_dims_(alloc)
+    {
+    }
+
+    /**
+     * @brief Constructor from kd tree.
+     *
+     * @param[in] tree
+     * Kd tree, whose values are rebuilt in left-balanced order.
+     *
+     * @param[in] alloc
+     * Allocator.
+     */
+    template <typename Tother_alloc>
+    linear_kdtree(
+            const kdtree<Tfloat, N, Tvalue, Tother_alloc>& tree,
+            const Talloc& alloc = Talloc()) :
+                values_(alloc),
+                split_dims_(alloc)
+    {
+        std::vector<value_type> values;
+        values.reserve(tree.node_count());
+        collect_recursive(tree.root(), values);
+        init_values(values);
+    }
+
+    /**@}*/
+
+public:
+
+    /**
+     * @brief Initialize.
+     *
+     * @param[in] from
+     * Input from.
+     *
+     * @param[in] to
+     * Input to.
+     *
+     * @param[in] func
+     * Function constructing an instance of `value_type` for each
+     * input element, as in `kdtree::init()`.
+     */
+    template <typename Tinput_itr, typename Tfunc>
+    void init(
+            Tinput_itr from,
+            Tinput_itr to,
+            Tfunc&& func)
+    {
+        std::vector<value_type> values;
+        while (from != to) {
+            values.emplace_back(std::forward<Tfunc>(func)(*from));
+            from++;
         }
+        init_values(values);
+    }
 
+    /**
+     * @brief Clear.
+     */
+    void clear()
+    {
+        values_.clear();
+        split_dims_.clear();
+        mapped_values_ = nullptr;
+        mapped_split_dims_ = nullptr;
+        mapped_size_ = 0;
+    }
+
+public:
+
+    /**
+     * @name Container interface
+     */
+    /**@{*/
+
+    /**
+     * @brief Empty?
+     */
+    bool empty() const noexcept
+    {
+        return size() == 0;
+    }
+
+    /**
+     * @brief Size.
+     */
+    size_type size() const noexcept
+    {
+        return mapped_values_ ? mapped_size_ : values_.size();
+    }
+
+    /**
+     * @brief Begin iterator.
+     */
+    const value_type* begin() const noexcept
+    {
+        return mapped_values_ ? mapped_values_ : values_.data();
+    }
+
+    /**
+     * @brief End iterator.
+     */
+    const value_type* end() const noexcept
+    {
+        return begin() + size();
+    }
+
+    /**
+     * @brief Index accessor.
+     */
+    const value_type& operator[](size_type pos) const noexcept
+    {
+        return begin()[pos];
+    }
+
+    /**
+     * @brief Split dimension accessor.
+     */
+    size_type split_dim(size_type pos) const noexcept
+    {
+        return split_dims_begin_()[pos];
+    }
+
+    /**@}*/
+
+public:
+
+    /**
+     * @brief Nearest neighbor.
+     *
+     * @param[in] point
+     * Reference point.
+     */
+    value_dist2_pair_type nearest(const point_type& point) const
+    {
+        value_dist2_pair_type near = {
+            nullptr,
+            pre::numeric_limits<float_type>::infinity()
+        };
+        if (!empty()) {
+            nearest_recursive(point, near, 0);
+        }
+        return near;
+    }
+
+    /**
+     * @brief Nearest neighbors.
+     *
+     * @param[in] point
+     * Reference point.
+     *
+     * @param[out] near
+     * Nearest value/distance-squared pairs range.
+     *
+     * @param[out] near_end
+     * Nearest value/distance-squared pairs range end.
+     *
+     * @return
+     * Returns the effective end of the nearest
+     * value/distance-squared pair range, as in `kdtree::nearest()`.
+     *
+     * @throw std::invalid_argument
+     * Unless
+     * `near` is non-null, `near_end` is non-null, and
+     * `near` is strictly less than `near_end`.
+     */
+    value_dist2_pair_type* nearest(
+            const point_type& point,
+            value_dist2_pair_type* near,
+            value_dist2_pair_type* near_end) const
+    {
+        if (near == nullptr || near_end == nullptr ||
+            near >= near_end) {
+            throw std::invalid_argument(__PRETTY_FUNCTION__);
+        }
+
+        value_dist2_pair_type* near_top = near;
+        if (!empty()) {
+            nearest_recursive(point, near, near_end, near_top, 0);
+        }
+        if (near_top > near) {
+            std::sort_heap(near, near_top, near_cmp);
+        }
+        return near_top;
+    }
+
+    /**
+     * @brief Visit nearby values.
+     *
+     * @param[in] point
+     * Reference point.
+     *
+     * @param[in] cutoff_dist
+     * Cutoff distance, non-negative.
+     *
+     * @param[in] func
+     * Function called with a pointer to each value strictly within
+     * the cutoff distance, and optionally with its distance-squared,
+     * as in `kdtree::nearby()`.
+     *
+     * @returns
+     * False if stopped early.
+     *
+     * @throw std::invalid_argument
+     * If `cutoff_dist` is negative or NaN.
+     */
+    template <typename Tfunc>
+    bool nearby(
+            const point_type& point,
+            float_type cutoff_dist,
+            Tfunc&& func) const
+    {
+        if (!(cutoff_dist >= 0)) {
+            throw std::invalid_argument(__PRETTY_FUNCTION__);
+        }
+        if (empty()) {
+            return true;
+        }
+        return nearby_recursive(
+                point, cutoff_dist * cutoff_dist,
+                func, 0);
+    }
+
+public:
+
+    /**
+     * @name Serialization
+     *
+     * Flat binary layout, with all fields in the recorded byte order:
+     *
+     * Bytes | Field
+     * ------|-------
+     * 8     | Magic `"PREFORMK"`
+     * 4     | Version, currently 1
+     * 4     | Byte order, 0 for little or 1 for big endian
+     * 4     | Dimensions
+     * 4     | Float size, in bytes
+     * 4     | Value size, in bytes
+     * 4     | Point/value pair size, in bytes
+     * 8     | Count
+     * 24    | Padding, 0
+     *
+     * Point/value pairs follow at byte offset 64 in their in-memory
+     * layout, with padding zeroed, and then split dimensions as one
+     * byte each. The tree is implicit, so pairs written in host byte
+     * order can be read in place, e.g., from a `mapped_file`, without
+     * any fixup.
+     *
+     * Requires that `Tvalue` is trivially copyable. Writing or reading
+     * in the other byte order further requires that `Tvalue` is
+     * arithmetic.
+     */
+    /**@{*/
+
+    /**
+     * @brief Header size, in bytes.
+     */
+    static constexpr size_type header_size = 64;
+
+    /**
+     * @brief Write.
+     *
+     * @param[in] os
+     * Output stream, in binary mode.
+     *
+     * @param[in] order
+     * Byte order. By default, host byte order.
+     *
+     * @throw std::invalid_argument
+     * If `order` is not host byte order and `Tvalue` is not
+     * arithmetic.
+     *
+     * @throw std::runtime_error
+     * If writing fails.
+     */
+    void write(std::ostream& os, byte_order order = host_byte_order()) const
+    {
+        static_assert(
+            std::is_trivially_copyable<Tvalue>::value,
+            "Tvalue must be trivially copyable");
+        bool rev = order != host_byte_order();
+        if (rev && !std::is_arithmetic<Tvalue>::value) {
+            throw std::invalid_argument(__PRETTY_FUNCTION__);
+        }
+
+        // Header.
+        char padding[24] = {};
+        os.write("PREFORMK", 8);
+        byte_stream(os, order)
+            << std::uint32_t(1)
+            << std::uint32_t(order)
+            << std::uint32_t(N)
+            << std::uint32_t(sizeof(float_type))
+            << std::uint32_t(sizeof(Tvalue))
+            << std::uint32_t(sizeof(value_type))
+            << std::uint64_t(size());
+        os.write(padding, sizeof(padding));
+
+        // Values, in buffered chunks.
+        constexpr size_type chunk = 256;
+        value_type buffer[chunk];
+        for (size_type k = 0; k < size(); k += chunk) {
+            size_type n = std::min(chunk, size() - k);
+            std::memset(static_cast<void*>(&buffer[0]), 0, sizeof(buffer));
+            for (size_type l = 0; l < n; l++) {
+                buffer[l].first = begin()[k + l].first;
+                buffer[l].second = begin()[k + l].second;
+                if (rev) {
+                    byte_swap_value_(buffer[l]);
+                }
+            }
+            os.write(
+                static_cast<const char*>(
+                static_cast<const void*>(&buffer[0])),
+                n * sizeof(value_type));
+        }
+
+        // Split dimensions.
+        os.write(
+            static_cast<const char*>(
+            static_cast<const void*>(split_dims_begin_())),
+            size());
+        if (!os) {
+            throw std::runtime_error(__PRETTY_FUNCTION__);
+        }
+    }
+
+    /**
+     * @brief Read, into owned storage.
+     *
+     * @param[in] is
+     * Input stream, in binary mode.
+     *
+     * @throw std::runtime_error
+     * If reading fails or the header does not match.
+     */
+    void read(std::istream& is)
+    {
+        static_assert(
+            std::is_trivially_copyable<Tvalue>::value,
+            "Tvalue must be trivially copyable");
+        char header[header_size];
+        if (!is.read(header, header_size)) {
+            throw std::runtime_error(__PRETTY_FUNCTION__);
+        }
+        bool rev = false;
+        size_type count = read_header_(header, rev);
+        std::vector<value_type, value_allocator_type> values(
+                count, values_.get_allocator());
+        std::vector<std::uint8_t, split_dim_allocator_type> split_dims(
+                count, split_dims_.get_allocator());
+        if (count > 0 &&
+            (!is.read(
+                static_cast<char*>(static_cast<void*>(values.data())),
+                count * sizeof(value_type)) ||
+             !is.read(
+                static_cast<char*>(static_cast<void*>(split_dims.data())),
+                count))) {
+            throw std::runtime_error(__PRETTY_FUNCTION__);
+        }
+        if (rev) {
+            for (value_type& value : values) {
+                byte_swap_value_(value);
+            }
+        }
+        clear();
+        values_.swap(values);
+        split_dims_.swap(split_dims);
+    }
+
+    /**
+     * @brief Map, in place.
+     *
+     * If the data is in host byte order and suitably aligned, as
+     * in a `mapped_file`, refers to the values in place, so the
+     * data must outlive the tree or the next call to `init()`,
+     * `clear()`, `map()`, or `read()`. Otherwise, copies the values
+     * into owned storage, swapping byte order if necessary.
+     *
+     * @param[in] data
+     * Data, as written by `write()`.
+     *
+     * @param[in] data_size
+     * Data size, in bytes.
+     *
+     * @throw std::runtime_error
+     * If the data is too small or the header does not match.
+     *
+     * @note
+     * Split dimensions are not otherwise validated, so the data
+     * must come from a trusted source.
+     */
+    void map(const char* data, size_type data_size)
+    {
+        static_assert(
+            std::is_trivially_copyable<Tvalue>::value,
+            "Tvalue must be trivially copyable");
+        if (data == nullptr || data_size < header_size) {
+            throw std::runtime_error(__PRETTY_FUNCTION__);
+        }
+        bool rev = false;
+        size_type count = read_header_(data, rev);
+        if ((data_size - header_size) / (sizeof(value_type) + 1) < count) {
+            throw std::runtime_error(__PRETTY_FUNCTION__);
+        }
+        const char* first = data + header_size;
+        const char* split_dims_first = first + count * sizeof(value_type);
+        clear();
+        if (count == 0) {
+            return;
+        }
+        if (!rev &&
+            reinterpret_cast<std::uintptr_t>(first) %
+                    alignof(value_type) == 0) {
+            mapped_values_ = reinterpret_cast<const value_type*>(first);
+            mapped_split_dims_ =
+                reinterpret_cast<const std::uint8_t*>(split_dims_first);
+            mapped_size_ = count;
+        }
+        else {
+            values_.resize(count);
+            split_dims_.resize(count);
+            std::memcpy(
+                static_cast<void*>(values_.data()), first,
+                count * sizeof(value_type));
+            std::memcpy(split_dims_.data(), split_dims_first, count);
+            if (rev) {
+                for (value_type& value : values_) {
+                    byte_swap_value_(value);
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Refers to mapped values in place?
+     */
+    bool mapped() const noexcept
+    {
+        return mapped_values_ != nullptr;
+    }
+
+    /**@}*/
+
+private:
+
+    /**
+     * @brief Values, in left-balanced implicit order.
+     */
+    std::vector<value_type, value_allocator_type> values_;
+
+    /**
+     * @brief Split dimensions.
+     */
+    std::vector<std::uint8_t, split_dim_allocator_type> split_dims_;
+
+    /**
+     * @brief Mapped values, or nullptr if values are owned.
+     */
+    const value_type* mapped_values_ = nullptr;
+
+    /**
+     * @brief Mapped split dimensions.
+     */
+    const std::uint8_t* mapped_split_dims_ = nullptr;
+
+    /**
+     * @brief Mapped count.
+     */
+    size_type mapped_size_ = 0;
+
+    /**
+     * @brief Split dimensions begin, mapped or owned.
+     */
+    const std::uint8_t* split_dims_begin_() const noexcept
+    {
+        return mapped_values_ ? mapped_split_dims_ : split_dims_.data();
+    }
+
+    /**
+     * @brief Read header, return count.
+     *
+     * @param[in] header
+     * Header, of `header_size` bytes.
+     *
+     * @param[out] rev
+     * Written in the other byte order?
+     *
+     * @throw std::runtime_error
+     * If the header does not match, or if written in the other
+     * byte order and `Tvalue` is not arithmetic.
+     */
+    static size_type read_header_(const char* header, bool& rev)
+    {
+        if (std::memcmp(header, "PREFORMK", 8) != 0) {
+            throw std::runtime_error(__PRETTY_FUNCTION__);
+        }
+        std::uint32_t fields[6];
+        std::uint64_t count = 0;
+        std::memcpy(fields, header + 8, sizeof(fields));
+        std::memcpy(&count, header + 32, sizeof(count));
+
+        // Written in the other byte order?
+        std::uint32_t order = std::uint32_t(host_byte_order());
+        rev = fields[1] != order;
+        if (rev) {
+            byte_swap(&fields[0], 6);
+            byte_swap(&count, 1);
+            order = 1 - order;
+        }
+        if (fields[0] != 1 ||
+            fields[1] != order ||
+            fields[2] != N ||
+            fields[3] != sizeof(float_type) ||
+            fields[4] != sizeof(Tvalue) ||
+            fields[5] != sizeof(value_type) ||
+            (rev && !std::is_arithmetic<Tvalue>::value)) {
+            throw std::runtime_error(__PRETTY_FUNCTION__);
+        }
+        return size_type(count);
+    }
+
+    /**
+     * @brief Byte swap point/value pair fields.
+     */
+    static void byte_swap_value_(value_type& value) noexcept
+    {
+        byte_swap(&value.first[0], N);
+        if constexpr (std::is_arithmetic<Tvalue>::value) {
+            byte_swap(&value.second, 1);
+        }
+    }
+
+private:
+
+#if !DOXYGEN
+
+    /**
+     * @brief Compare by distance-squared.
+     */
+    static bool near_cmp(
+            const value_dist2_pair_type& lhs,
+            const value_dist2_pair_type& rhs)
+    {
+        return lhs.second < rhs.second;
+    }
+
+    /**
+     * @brief Collect kd tree values recursively.
+     */
+    template <typename Tnode>
+    static void collect_recursive(
+            const Tnode* node,
+            std::vector<value_type>& values)
+    {
+        if (node) {
+            values.push_back(node->value);
+            collect_recursive(node->left, values);
+            collect_recursive(node->right, values);
+        }
+    }
+
+    /**
+     * @brief Left subtree size of left-balanced tree.
+     */
+    static size_type left_size(size_type count)
+    {
+        // Largest power of 2 such that full levels fit in count.
+        size_type full = 1;
+        while (2 * full - 1 <= count) {
+            full *= 2;
+        }
+        size_type last = count - (full - 1);
+        return (full / 2 - 1) + std::min(last, full / 2);
+    }
+
+    /**
+     * @brief Initialize from values.
+     */
+    void init_values(std::vector<value_type>& values)
+    {
+        clear();
+        if (values.empty()) {
+            return;
+        }
+        values_.resize(values.size());
+        split_dims_.resize(values.size());
+        init_recursive(0, {&values[0], &values[0] + values.size()});
+    }
+
+    /**
+     * @brief Initialize recursively.
+     */
+    void init_recursive(
+            size_type index,
+            iterator_range<value_type*> values)
+    {
+        if (values.empty()) {
+            return;
+        }
+
+        aabb<Tfloat, N> box;
+        for (const value_type& value : values) {
+            box |= value.first;
+        }
+
+        // Split dimension.
+        size_type split_dim = box.diag().argmax();
+
+        // Split element, such that left subtree is left balanced.
+        value_type* split =
+                values.begin() +
+                left_size(values.size());
+
+        if (values.size() > 1) {
+
+            // Partition.
+            std::nth_element(
+                    values.begin(), split,
+                    values.end(),
+                    [=](const value_type& value0,
+                        const value_type& value1) -> bool {
+                        return value0.first[split_dim] <
+                               value1.first[split_dim];
+                    });
+
+        }
+
+        values_[index] = *split;
+        split_dims_[index] = std::uint8_t(split_dim);
+
+        // Recurse.
+        init_recursive(2 * index + 1, {values.begin(), split});
+        init_recursive(2 * index + 2, {split + 1, values.end()});
+    }
+
+    /**
+     * @brief Nearest neighbor, recursive algorithm.
+     */
+    void nearest_recursive(
+            const point_type& point,
+            value_dist2_pair_type& near,
+            size_type index) const
+    {
+        kdtree_count_scope_ scope;
+        kdtree_count_node_();
+
+        // Difference.
+        const value_type& value = begin()[index];
+        point_type diff = value.first - point;
+
+        // Squared distance to reference point.
+        float_type dist2 = dot(diff, diff);
+
+        // Possibly update nearest value.
+        if (near.second > dist2) {
+            near.second = dist2;
+            near.first = &value;
+        }
+
+        // Signed distance to split plane.
+        float_type min_dist = diff[split_dims_begin_()[index]];
+        float_type min_dist2 = min_dist * min_dist;
+
+        // If point is on left, process left child first.
+        // If point is on right, process right child first.
+        size_type child0 = 2 * index + 1;
+        size_type child1 = 2 * index + 2;
+        if (pre::signbit(min_dist)) {
+            std::swap(child0, child1);
+        }
+
+        if (child0 < size()) {
+            nearest_recursive(point, near, child0);
+        }
+
+        if (child1 < size()) {
+            // Recurse only if necessary.
+            if (!(min_dist2 > near.second)) {
+                nearest_recursive(point, near, child1);
+            }
+        }
+    }
+
+    /**
+     * @brief Nearest neighbors, recursive algorithm.
+     */
+    void nearest_recursive(
+            const point_type& point,
+            value_dist2_pair_type* near,
+            value_dist2_pair_type* near_end,
+            value_dist2_pair_type*& near_top,
+            size_type index) const
+    {
+        kdtree_count_scope_ scope;
+        kdtree_count_node_();
+
+        // Difference.
+        const value_type& value = begin()[index];
+        point_type diff = value.first - point;
+
+        // Squared distance to reference point.
+        float_type dist2 = dot(diff, diff);
+
+        if (near_top != near_end) {
+
+            // Push.
+            *near_top++ = value_dist2_pair_type(&value, dist2);
+            std::push_heap(near, near_top, near_cmp);
+        }
+        else if (near->second > dist2) {
+
+            // Replace furthest value.
+            std::pop_heap(near, near_top, near_cmp);
+            *(near_top - 1) = value_dist2_pair_type(&value, dist2);
+            std::push_heap(near, near_top, near_cmp);
+        }
+
+        // Signed distance to split plane.
+        float_type min_dist = diff[split_dims_begin_()[index]];
+        float_type min_dist2 = min_dist * min_dist;
+
+        // If point is on left, process left child first.
+        // If point is on right, process right child first.
+        size_type child0 = 2 * index + 1;
+        size_type child1 = 2 * index + 2;
+        if (pre::signbit(min_dist)) {
+            std::swap(child0, child1);
+        }
+
+        if (child0 < size()) {
+            nearest_recursive(point, near, near_end, near_top, child0);
+        }
+
+        if (child1 < size()) {
+            // Recurse only if the pairs heap is not full, or the
+            // split plane is not further than the furthest value.
+            if (near_top != near_end ||
+                !(min_dist2 > near->second)) {
+                nearest_recursive(point, near, near_end, near_top, child1);
+            }
+        }
+    }
+
+    /**
+     * @brief Visit nearby values, recursive algorithm.
+     */
+    template <typename Tfunc>
+    bool nearby_recursive(
+            const point_type& point,
+            float_type cutoff_dist2,
+            Tfunc& func,
+            size_type index) const
+    {
+        kdtree_count_scope_ scope;
+        kdtree_count_node_();
+
+        // Difference.
+        const value_type& value = begin()[index];
+        point_type diff = value.first - point;
+
+        // Process value if within cutoff distance.
+        float_type dist2 = dot(diff, diff);
+        if (cutoff_dist2 > dist2) {
+            if (!kdtree_nearby_call_(func, &value, dist2)) {
+                return false;
+            }
+        }
+
+        // Signed distance to split plane.
+        float_type min_dist = diff[split_dims_begin_()[index]];
+        float_type min_dist2 = min_dist * min_dist;
+
+        // If point is on left, process left child first.
+        // If point is on right, process right child first.
+        size_type child0 = 2 * index + 1;
+        size_type child1 = 2 * index + 2;
+        if (pre::signbit(min_dist)) {
+            std::swap(child0, child1);
+        }
+
+        if (child0 < size()) {
+            if (!nearby_recursive(point, cutoff_dist2, func, child0)) {
+                return false;
+            }
+        }
+
+        if (child1 < size()) {
+            // Recurse only if necessary.
+            if (!(min_dist2 > cutoff_dist2)) {
+                if (!nearby_recursive(point, cutoff_dist2, func, child1)) {
+                    return false;
+                }
+            }
+        }
         return true;
     }
 
@@ -0,0 +1,1021 @@
+/* Copyright (c) 2018-20 M. Grady Saunders
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer.
+ *
+ *   2. Redistributions in binary form must reproduce the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer in the documentation and/or other materials
+ *      provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*+-+*/
+#if !DOXYGEN
+#if !(__cplusplus >= 201703L)
+#error "preform/low_discrepancy.hpp requires >=C++17"
+#endif // #if !(__cplusplus >= 201703L)
+#endif // #if !DOXYGEN
+#pragma once
+#ifndef PREFORM_LOW_DISCREPANCY_HPP
+#define PREFORM_LOW_DISCREPANCY_HPP
+
+// for std::shuffle
+#include <algorithm>
+
+// for std::uint32_t, std::uint64_t
+#include <cstdint>
+
+// for std::invalid_argument
+#include <stdexcept>
+
+// for std::vector
+#include <vector>
+
+// for pre::exp, pre::nextafter, ...
+#include <preform/math.hpp>
+
+// for pre::bit_reverse, pre::first1
+#include <preform/misc_int.hpp>
+
+// for pre::pcg32
+#include <preform/random.hpp>
+
+namespace pre {
+
+/**
+ * @defgroup low_discrepancy Low-discrepancy sequences
+ *
+ * `<preform/low_discrepancy.hpp>`
+ *
+ * __C++ version__: >=C++17
+ *
+ * Sequences here are exposed as generators. Each call to
+ * `operator()` returns the next dimension of the current sample,
+ * as a 64-bit result, so one call makes exactly one canonical sample
+ * of `float` or `double` in `pre::generate_canonical()`. Thus a
+ * sequence may be passed to any distribution in place of a
+ * pseudo-random engine, with `next()` advancing to the next sample.
+ */
+/**@{*/
+
+#if !DOXYGEN
+
+// Hash, after the SplitMix64 finalizer.
+constexpr std::uint64_t low_discrepancy_hash_(std::uint64_t x)
+{
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ULL;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBULL;
+    x ^= x >> 31;
+    return x;
+}
+
+// Hash of sample index and dimension, for padding.
+constexpr std::uint64_t low_discrepancy_pad_(
+                std::uint64_t seed,
+                std::uint64_t index,
+                std::uint64_t dim)
+{
+    return low_discrepancy_hash_(
+           low_discrepancy_hash_(
+           low_discrepancy_hash_(seed) ^ index) ^ dim);
+}
+
+// Canonical float from 32 bits.
+template <typename T>
+constexpr T low_discrepancy_canonical_(std::uint32_t x)
+{
+    T u = T(x) * T(2.3283064365386962890625e-10L);
+    return u < T(1) ? u : pre::nextafter(T(1), T(0));
+}
+
+#endif // #if !DOXYGEN
+
+/**
+ * @brief Owen-scrambled Sobol sequence.
+ *
+ * Sobol sequence with the direction numbers of [Joe and Kuo 2008][1]
+ * for the first 16 dimensions, scrambled with the hash-based nested
+ * uniform scramble of [Burley 2020][2]. Points are enumerated in Gray
+ * code order, so advancing one sample is one XOR per dimension.
+ * Dimensions beyond `max_dimensions` are padded with pseudo-random
+ * values.
+ *
+ * [1]: https://doi.org/10.1137/070709359
+ * [2]: https://jcgt.org/published/0009/04/01/
+ */
+class sobol_sequence
+{
+public:
+
+    /**
+     * @brief Result type.
+     */
+    typedef std::uint64_t result_type;
+
+    /**
+     * @brief Maximum dimensions.
+     */
+    static constexpr std::size_t max_dimensions = 16;
+
+public:
+
+    /**
+     * @brief Constructor.
+     *
+     * @param[in] seed
+     * Seed, for scrambling.
+     *
+     * @param[in] scramble
+     * Scramble? If false, the sequence is the plain Sobol sequence.
+     */
+    explicit sobol_sequence(std::uint64_t seed = 0, bool scramble = true) :
+            seed_(seed)
+    {
+        init_directions_();
+        for (std::size_t dim = 0; dim < max_dimensions; dim++) {
+            scramble_seeds_[dim] = 0;
+            if (scramble) {
+                scramble_seeds_[dim] = std::uint32_t(
+                    low_discrepancy_pad_(seed, ~0ULL, dim));
+            }
+        }
+        scrambled_ = scramble;
+        seek(0);
+    }
+
+public:
+
+    /**
+     * @brief Sample bits, at index and dimension.
+     */
+    std::uint32_t sample_bits(std::uint32_t index, std::size_t dim) const
+    {
+        if (dim >= max_dimensions) {
+            return std::uint32_t(low_discrepancy_pad_(seed_, index, dim));
+        }
+        return scramble_(unscrambled_(index, dim), dim);
+    }
+
+    /**
+     * @brief Sample, at index and dimension.
+     */
+    template <typename T>
+    std::enable_if_t<std::is_floating_point<T>::value, T> sample(
+                std::uint32_t index, std::size_t dim) const
+    {
+        return low_discrepancy_canonical_<T>(sample_bits(index, dim));
+    }
+
+    /**
+     * @brief Generate samples.
+     *
+     * @param[in] first
+     * First index.
+     *
+     * @param[in] count
+     * Count.
+     *
+     * @param[in] dims
+     * Dimensions per sample.
+     *
+     * @param[out] out
+     * Samples, such that `out[k * dims + dim]` is dimension `dim`
+     * of sample `first + k`.
+     */
+    template <typename T>
+    std::enable_if_t<std::is_floating_point<T>::value, void> generate(
+                std::uint32_t first,
+                std::size_t count,
+                std::size_t dims,
+                T* out) const
+    {
+        std::uint32_t state[max_dimensions];
+        std::size_t nstate = std::min(dims, max_dimensions);
+        for (std::size_t dim = 0; dim < nstate; dim++) {
+            state[dim] = unscrambled_(first, dim);
+        }
+        for (std::size_t k = 0; k < count; k++) {
+            std::uint32_t index = first + std::uint32_t(k);
+            for (std::size_t dim = 0; dim < nstate; dim++) {
+                *out++ = low_discrepancy_canonical_<T>(
+                         scramble_(state[dim], dim));
+            }
+            for (std::size_t dim = nstate; dim < dims; dim++) {
+                *out++ = sample<T>(index, dim);
+            }
+            std::size_t bit = pre::first1(index + 1);
+            for (std::size_t dim = 0; dim < nstate; dim++) {
+                state[dim] ^= directions_[dim][bit];
+            }
+        }
+    }
+
+public:
+
+    /**
+     * @brief Seek to sample index, at dimension 0.
+     */
+    void seek(std::uint32_t index)
+    {
+        index_ = index;
+        dim_ = 0;
+        for (std::size_t dim = 0; dim < max_dimensions; dim++) {
+            state_[dim] = unscrambled_(index, dim);
+        }
+    }
+
+    /**
+     * @brief Advance to next sample index, at dimension 0.
+     */
+    void next()
+    {
+        std::size_t bit = pre::first1(index_ + 1);
+        for (std::size_t dim = 0; dim < max_dimensions; dim++) {
+            state_[dim] ^= directions_[dim][bit];
+        }
+        index_++;
+        dim_ = 0;
+    }
+
+    /**
+     * @brief Sample index.
+     */
+    std::uint32_t index() const
+    {
+        return index_;
+    }
+
+    /**
+     * @brief Next dimension.
+     */
+    std::size_t dimension() const
+    {
+        return dim_;
+    }
+
+    /**
+     * @brief Set next dimension, e.g., to skip dimensions.
+     */
+    void dimension(std::size_t dim)
+    {
+        dim_ = dim;
+    }
+
+    /**
+     * @brief Result minimum.
+     */
+    static constexpr result_type min() noexcept
+    {
+        return 0;
+    }
+
+    /**
+     * @brief Result maximum.
+     */
+    static constexpr result_type max() noexcept
+    {
+        return ~0ULL;
+    }
+
+    /**
+     * @brief Generate result, the next dimension of the sample.
+     */
+    result_type operator()()
+    {
+        std::uint32_t x =
+                dim_ < max_dimensions ?
+                scramble_(state_[dim_], dim_) :
+                std::uint32_t(low_discrepancy_pad_(seed_, index_, dim_));
+        dim_++;
+        return result_type(x) << 32;
+    }
+
+private:
+
+    /**
+     * @brief Seed.
+     */
+    std::uint64_t seed_ = 0;
+
+    /**
+     * @brief Scramble?
+     */
+    bool scrambled_ = true;
+
+    /**
+     * @brief Direction numbers.
+     */
+    std::uint32_t directions_[max_dimensions][32] = {};
+
+    /**
+     * @brief Scramble seeds.
+     */
+    std::uint32_t scramble_seeds_[max_dimensions] = {};
+
+    /**
+     * @brief Sample index.
+     */
+    std::uint32_t index_ = 0;
+
+    /**
+     * @brief Next dimension.
+     */
+    std::size_t dim_ = 0;
+
+    /**
+     * @brief Unscrambled sample bits, for each dimension.
+     */
+    std::uint32_t state_[max_dimensions] = {};
+
+    /**
+     * @brief Initialize direction numbers.
+     */
+    void init_directions_()
+    {
+        // Degree, coefficients, and initial direction numbers of
+        // dimensions 2 through 16, from new-joe-kuo-6.21201.
+        static const std::uint32_t params[max_dimensions - 1][8] = {
+            {1, 0,  1},
+            {2, 1,  1, 3},
+            {3, 1,  1, 3, 1},
+            {3, 2,  1, 1, 1},
+            {4, 1,  1, 1, 3, 3},
+            {4, 4,  1, 3, 5, 13},
+            {5, 2,  1, 1, 5, 5, 17},
+            {5, 4,  1, 1, 5, 5, 5},
+            {5, 7,  1, 1, 7, 11, 19},
+            {5, 11, 1, 1, 5, 1, 1},
+            {5, 13, 1, 1, 1, 3, 11},
+            {5, 14, 1, 3, 5, 5, 31},
+            {6, 1,  1, 3, 3, 9, 7, 49},
+            {6, 13, 1, 1, 1, 15, 21, 21},
+            {6, 16, 1, 3, 1, 13, 27, 49}
+        };
+
+        // Van der Corput.
+        for (std::uint32_t i = 0; i < 32; i++) {
+            directions_[0][i] = 1UL << (31 - i);
+        }
+        for (std::size_t dim = 1; dim < max_dimensions; dim++) {
+            std::uint32_t* v = &directions_[dim][0];
+            std::uint32_t s = params[dim - 1][0];
+            std::uint32_t a = params[dim - 1][1];
+            const std::uint32_t* m = &params[dim - 1][2];
+            for (std::uint32_t i = 0; i < 32; i++) {
+                if (i < s) {
+                    v[i] = m[i] << (31 - i);
+                }
+                else {
+                    v[i] = v[i - s] ^ (v[i - s] >> s);
+                    for (std::uint32_t k = 1; k < s; k++) {
+                        if ((a >> (s - 1 - k)) & 1) {
+                            v[i] ^= v[i - k];
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Unscrambled sample bits.
+     */
+    std::uint32_t unscrambled_(std::uint32_t index, std::size_t dim) const
+    {
+        std::uint32_t gray = index ^ (index >> 1);
+        std::uint32_t x = 0;
+        for (std::size_t bit = 0; gray != 0; gray >>= 1, bit++) {
+            if (gray & 1) {
+                x ^= directions_[dim][bit];
+            }
+        }
+        return x;
+    }
+
+    /**
+     * @brief Nested uniform scramble.
+     *
+     * Reverses bits, applies the Laine-Karras-style permutation, in
+     * which each bit depends only on lower bits, then reverses bits
+     * back.
+     */
+    std::uint32_t scramble_(std::uint32_t x, std::size_t dim) const
+    {
+        if (!scrambled_) {
+            return x;
+        }
+        x = pre::bit_reverse(x);
+        x += scramble_seeds_[dim];
+        x ^= x * 0x6C50B47CUL;
+        x ^= x * 0xB82F1E52UL;
+        x ^= x * 0xC7AFE638UL;
+        x ^= x * 0x8D22F6E6UL;
+        return pre::bit_reverse(x);
+    }
+};
+
+/**
+ * @brief Scrambled Halton sequence.
+ *
+ * Halton sequence in the first 16 prime bases, with digits scrambled
+ * by random permutations, precomputed per dimension and per digit.
+ * Permuted trailing zero digits are accounted for with precomputed
+ * tails, so points are as if all digits were scrambled. Dimensions
+ * beyond `max_dimensions` are padded with pseudo-random values.
+ */
+class halton_sequence
+{
+public:
+
+    /**
+     * @brief Result type.
+     */
+    typedef std::uint64_t result_type;
+
+    /**
+     * @brief Maximum dimensions.
+     */
+    static constexpr std::size_t max_dimensions = 16;
+
+public:
+
+    /**
+     * @brief Constructor.
+     *
+     * @param[in] seed
+     * Seed, for scrambling.
+     *
+     * @param[in] scramble
+     * Scramble? If false, the sequence is the plain Halton sequence.
+     */
+    explicit halton_sequence(std::uint64_t seed = 0, bool scramble = true) :
+            seed_(seed)
+    {
+        pre::pcg32 gen(seed, 0x48414C544F4EULL);
+        for (std::size_t dim = 0; dim < max_dimensions; dim++) {
+            std::uint32_t base = bases_[dim];
+
+            // Digits to resolve double precision.
+            std::size_t digits = 0;
+            for (double scale = 1; scale > 0x1p-53; scale /= base) {
+                digits++;
+            }
+            digits_[dim] = digits;
+            offsets_[dim] = perms_.size();
+
+            // Permutations.
+            for (std::size_t j = 0; j < digits; j++) {
+                std::size_t first = perms_.size();
+                for (std::uint32_t k = 0; k < base; k++) {
+                    perms_.push_back(std::uint16_t(k));
+                }
+                if (scramble) {
+                    std::shuffle(
+                        perms_.begin() + first,
+                        perms_.end(), gen);
+                }
+            }
+
+            // Tails of permuted zero digits.
+            tails_[dim].resize(digits + 1);
+            tails_[dim][digits] = 0;
+            double scale = 1;
+            for (std::size_t j = 0; j < digits; j++) {
+                scale /= base;
+            }
+            for (std::size_t j = digits; j-- > 0;) {
+                tails_[dim][j] = tails_[dim][j + 1] +
+                    perms_[offsets_[dim] + j * base] * scale;
+                scale *= base;
+            }
+        }
+        seek(0);
+    }
+
+public:
+
+    /**
+     * @brief Sample, at index and dimension.
+     */
+    template <typename T>
+    std::enable_if_t<std::is_floating_point<T>::value, T> sample(
+                std::uint64_t index, std::size_t dim) const
+    {
+        T u = T(sample_(index, dim));
+        return u < T(1) ? u : pre::nextafter(T(1), T(0));
+    }
+
+    /**
+     * @brief Generate samples.
+     *
+     * @param[in] first
+     * First index.
+     *
+     * @param[in] count
+     * Count.
+     *
+     * @param[in] dims
+     * Dimensions per sample.
+     *
+     * @param[out] out
+     * Samples, such that `out[k * dims + dim]` is dimension `dim`
+     * of sample `first + k`.
+     */
+    template <typename T>
+    std::enable_if_t<std::is_floating_point<T>::value, void> generate(
+                std::uint64_t first,
+                std::size_t count,
+                std::size_t dims,
+                T* out) const
+    {
+        for (std::size_t k = 0; k < count; k++) {
+            for (std::size_t dim = 0; dim < dims; dim++) {
+                *out++ = sample<T>(first + k, dim);
+            }
+        }
+    }
+
+public:
+
+    /**
+     * @brief Seek to sample index, at dimension 0.
+     */
+    void seek(std::uint64_t index)
+    {
+        index_ = index;
+        dim_ = 0;
+    }
+
+    /**
+     * @brief Advance to next sample index, at dimension 0.
+     */
+    void next()
+    {
+        index_++;
+        dim_ = 0;
+    }
+
+    /**
+     * @brief Sample index.
+     */
+    std::uint64_t index() const
+    {
+        return index_;
+    }
+
+    /**
+     * @brief Next dimension.
+     */
+    std::size_t dimension() const
+    {
+        return dim_;
+    }
+
+    /**
+     * @brief Set next dimension, e.g., to skip dimensions.
+     */
+    void dimension(std::size_t dim)
+    {
+        dim_ = dim;
+    }
+
+    /**
+     * @brief Result minimum.
+     */
+    static constexpr result_type min() noexcept
+    {
+        return 0;
+    }
+
+    /**
+     * @brief Result maximum.
+     */
+    static constexpr result_type max() noexcept
+    {
+        return ~0ULL;
+    }
+
+    /**
+     * @brief Generate result, the next dimension of the sample.
+     */
+    result_type operator()()
+    {
+        double u = sample_(index_, dim_++);
+        return u < 1 ? result_type(u * 0x1p64) : ~0ULL;
+    }
+
+private:
+
+    /**
+     * @brief Prime bases.
+     */
+    static constexpr std::uint32_t bases_[max_dimensions] = {
+        2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47, 53
+    };
+
+    /**
+     * @brief Seed.
+     */
+    std::uint64_t seed_ = 0;
+
+    /**
+     * @brief Digits, for each dimension.
+     */
+    std::size_t digits_[max_dimensions] = {};
+
+    /**
+     * @brief Permutation offsets, for each dimension.
+     */
+    std::size_t offsets_[max_dimensions] = {};
+
+    /**
+     * @brief Permutations, base entries per digit.
+     */
+    std::vector<std::uint16_t> perms_;
+
+    /**
+     * @brief Tails, for each dimension, such that `tails_[dim][j]` is
+     * the contribution of permuted zero digits from digit `j` on.
+     */
+    std::vector<double> tails_[max_dimensions];
+
+    /**
+     * @brief Sample index.
+     */
+    std::uint64_t index_ = 0;
+
+    /**
+     * @brief Next dimension.
+     */
+    std::size_t dim_ = 0;
+
+    /**
+     * @brief Sample, at index and dimension.
+     */
+    double sample_(std::uint64_t index, std::size_t dim) const
+    {
+        if (dim >= max_dimensions) {
+            return double(low_discrepancy_pad_(seed_, index, dim) >> 11) *
+                   0x1p-53;
+        }
+        std::uint32_t base = bases_[dim];
+        double inv_base = 1.0 / base;
+        double scale = inv_base;
+        double u = 0;
+        const std::uint16_t* perm = &perms_[offsets_[dim]];
+        std::size_t j = 0;
+        for (; index != 0 && j < digits_[dim]; j++) {
+            std::uint64_t next = index / base;
+            u += perm[index - next * base] * scale;
+            index = next;
+            scale *= inv_base;
+            perm += base;
+        }
+        return u + tails_[dim][j];
+    }
+};
+
+/**
+ * @brief Blue-noise dither tile.
+ *
+ * Toroidal tile of ranks with blue-noise spectrum, generated by the
+ * void-and-cluster method of [Ulichney 1993][1]. Generation costs
+ * @f$ O(n^2) @f$ in the pixel count @f$ n @f$, so tiles should be
+ * generated once and shared.
+ *
+ * [1]: https://doi.org/10.1117/12.152707
+ */
+class blue_noise_tile
+{
+public:
+
+    /**
+     * @brief Constructor.
+     *
+     * @param[in] log2_size
+     * Binary logarithm of side length.
+     *
+     * @param[in] seed
+     * Seed, for initial binary pattern.
+     *
+     * @param[in] sigma
+     * Standard deviation of energy filter, in pixels.
+     *
+     * @throw std::invalid_argument
+     * Unless `log2_size` is in @f$ [1, 8] @f$ and `sigma > 0`.
+     */
+    explicit blue_noise_tile(
+            std::size_t log2_size = 6,
+            std::uint64_t seed = 0,
+            double sigma = 1.5)
+    {
+        if (!(log2_size >= 1 && log2_size <= 8) || !(sigma > 0)) {
+            throw std::invalid_argument(__PRETTY_FUNCTION__);
+        }
+        size_ = 1 << log2_size;
+        init_(seed, sigma);
+    }
+
+public:
+
+    /**
+     * @brief Side length.
+     */
+    int size() const
+    {
+        return size_;
+    }
+
+    /**
+     * @brief Pixel count.
+     */
+    int count() const
+    {
+        return size_ * size_;
+    }
+
+    /**
+     * @brief Rank at pixel, wrapping toroidally.
+     */
+    std::uint32_t rank(int x, int y) const
+    {
+        x &= size_ - 1;
+        y &= size_ - 1;
+        return ranks_[y * size_ + x];
+    }
+
+    /**
+     * @brief Dither threshold at pixel, in @f$ (0, 1) @f$.
+     */
+    template <typename T>
+    std::enable_if_t<std::is_floating_point<T>::value, T> value(
+                int x, int y) const
+    {
+        return (T(rank(x, y)) + T(0.5)) / T(count());
+    }
+
+    /**
+     * @brief Ranks, row-major.
+     */
+    const std::uint32_t* ranks() const
+    {
+        return ranks_.data();
+    }
+
+private:
+
+    /**
+     * @brief Side length.
+     */
+    int size_ = 0;
+
+    /**
+     * @brief Ranks.
+     */
+    std::vector<std::uint32_t> ranks_;
+
+    /**
+     * @brief Void and cluster.
+     */
+    void init_(std::uint64_t seed, double sigma)
+    {
+        int n = size_ * size_;
+        int mask = size_ - 1;
+
+        // Toroidal Gaussian energy filter.
+        std::vector<double> filter(n);
+        for (int y = 0; y < size_; y++)
+        for (int x = 0; x < size_; x++) {
+            int dx = std::min(x, size_ - x);
+            int dy = std::min(y, size_ - y);
+            filter[y * size_ + x] =
+                pre::exp(-(dx * dx + dy * dy) / (2 * sigma * sigma));
+        }
+        std::vector<double> energy(n);
+        std::vector<char> ones(n);
+        auto toggle = [&](int p, double sign) {
+            ones[p] = sign > 0;
+            int px = p & mask;
+            int py = p >> pre::first1(size_);
+            for (int y = 0; y < size_; y++) {
+                double* row = &energy[((py + y) & mask) * size_];
+                const double* frow = &filter[y * size_];
+                for (int x = 0; x < size_; x++) {
+                    row[(px + x) & mask] += sign * frow[x];
+                }
+            }
+        };
+        auto tightest_cluster = [&]() {
+            int best = -1;
+            for (int p = 0; p < n; p++) {
+                if (ones[p] && (best < 0 || energy[p] > energy[best])) {
+                    best = p;
+                }
+            }
+            return best;
+        };
+        auto largest_void = [&]() {
+            int best = -1;
+            for (int p = 0; p < n; p++) {
+                if (!ones[p] && (best < 0 || energy[p] < energy[best])) {
+                    best = p;
+                }
+            }
+            return best;
+        };
+
+        // Initial binary pattern, random.
+        int nones = std::max(1, n / 10);
+        std::vector<int> order(n);
+        for (int p = 0; p < n; p++) {
+            order[p] = p;
+        }
+        pre::pcg32 gen(seed);
+        std::shuffle(order.begin(), order.end(), gen);
+        for (int k = 0; k < nones; k++) {
+            toggle(order[k], +1);
+        }
+
+        // Relax, by moving tightest cluster to largest void.
+        for (int iter = 0; iter < n; iter++) {
+            int c = tightest_cluster();
+            toggle(c, -1);
+            int v = largest_void();
+            toggle(v, +1);
+            if (v == c) {
+                break;
+            }
+        }
+        std::vector<double> proto_energy = energy;
+        std::vector<char> proto_ones = ones;
+
+        // Rank prototype by removing tightest clusters.
+        ranks_.resize(n);
+        for (int k = nones; k > 0; k--) {
+            int c = tightest_cluster();
+            toggle(c, -1);
+            ranks_[c] = k - 1;
+        }
+
+        // Rank the rest by filling largest voids. Past half-full,
+        // the largest void among zeros is also the tightest cluster
+        // of zeros, since the filter sum is constant.
+        energy = proto_energy;
+        ones = proto_ones;
+        for (int k = nones; k < n; k++) {
+            int v = largest_void();
+            toggle(v, +1);
+            ranks_[v] = k;
+        }
+    }
+};
+
+/**
+ * @brief Blue-noise dither generator.
+ *
+ * Generator of dither values for one pixel, where each dimension
+ * reads the tile under a pseudo-random toroidal offset, so that each
+ * dimension has blue-noise spectrum across pixels while dimensions
+ * are decorrelated. Values are jittered uniformly within rank bins.
+ */
+class blue_noise_generator
+{
+public:
+
+    /**
+     * @brief Result type.
+     */
+    typedef std::uint64_t result_type;
+
+public:
+
+    /**
+     * @brief Constructor.
+     *
+     * @param[in] tile
+     * Tile, must outlive generator.
+     *
+     * @param[in] x
+     * Pixel X.
+     *
+     * @param[in] y
+     * Pixel Y.
+     *
+     * @param[in] frame
+     * Frame, or sample index, to decorrelate offsets.
+     */
+    blue_noise_generator(
+            const blue_noise_tile& tile,
+            int x, int y,
+            std::uint64_t frame = 0) :
+                tile_(&tile),
+                x_(x),
+                y_(y),
+                frame_(frame)
+    {
+    }
+
+public:
+
+    /**
+     * @brief Next dimension.
+     */
+    std::size_t dimension() const
+    {
+        return dim_;
+    }
+
+    /**
+     * @brief Set next dimension, e.g., to skip dimensions.
+     */
+    void dimension(std::size_t dim)
+    {
+        dim_ = dim;
+    }
+
+    /**
+     * @brief Result minimum.
+     */
+    static constexpr result_type min() noexcept
+    {
+        return 0;
+    }
+
+    /**
+     * @brief Result maximum.
+     */
+    static constexpr result_type max() noexcept
+    {
+        return ~0ULL;
+    }
+
+    /**
+     * @brief Generate result, the next dimension.
+     */
+    result_type operator()()
+    {
+        std::uint64_t h = low_discrepancy_pad_(frame_, dim_++, 0);
+        int offx = int(h & 0xFFFF);
+        int offy = int((h >> 16) & 0xFFFF);
+        std::uint64_t rank = tile_->rank(x_ + offx, y_ + offy);
+        std::uint64_t count = std::uint64_t(tile_->count());
+
+        // Jitter within rank bin, in 64-bit fixed point.
+        std::uint64_t bin = ~0ULL / count;
+        std::uint64_t jitter =
+            low_discrepancy_hash_(h ^ std::uint64_t(x_) ^
+                                 (std::uint64_t(y_) << 32)) % bin;
+        return rank * bin + jitter;
+    }
+
+private:
+
+    /**
+     * @brief Tile.
+     */
+    const blue_noise_tile* tile_ = nullptr;
+
+    /**
+     * @brief Pixel X.
+     */
+    int x_ = 0;
+
+    /**
+     * @brief Pixel Y.
+     */
+    int y_ = 0;
+
+    /**
+     * @brief Frame.
+     */
+    std::uint64_t frame_ = 0;
+
+    /**
+     * @brief Next dimension.
+     */
+    std::size_t dim_ = 0;
+};
+
+/**@}*/
+
+} // namespace pre
+
+#endif // #ifndef PREFORM_LOW_DISCREPANCY_HPP
@@ -0,0 +1,951 @@
+/* Copyright (c) 2018-20 M. Grady Saunders
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer.
+ *
+ *   2. Redistributions in binary form must reproduce the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer in the documentation and/or other materials
+ *      provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*+-+*/
+#if !DOXYGEN
+#if !(__cplusplus >= 201703L)
+#error "preform/mapped_image.hpp requires >=C++17"
+#endif // #if !(__cplusplus >= 201703L)
+#endif // #if !DOXYGEN
+#pragma once
+#ifndef PREFORM_MAPPED_IMAGE_HPP
+#define PREFORM_MAPPED_IMAGE_HPP
+
+// for std::copy, std::swap
+#include <algorithm>
+
+// for std::uint32_t, std::uint64_t
+#include <cstdint>
+
+// for std::memcmp, std::memcpy
+#include <cstring>
+
+// for std::ifstream, std::ofstream
+#include <fstream>
+
+// for std::runtime_error
+#include <stdexcept>
+
+// for std::string
+#include <string>
+
+// for std::is_arithmetic, std::is_floating_point, std::is_signed
+#include <type_traits>
+
+// for std::vector
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+
+// for open
+#include <fcntl.h>
+
+// for mmap, munmap, madvise
+#include <sys/mman.h>
+
+// for fstat
+#include <sys/stat.h>
+
+// for close
+#include <unistd.h>
+
+#endif // #if defined(__unix__) || defined(__APPLE__)
+
+// for pre::byte_order, pre::host_byte_order
+#include <preform/byte_order.hpp>
+
+// for pre::clamp, pre::repeat, pre::mirror
+#include <preform/misc_int.hpp>
+
+// for pre::multi
+#include <preform/multi.hpp>
+
+// for pre::multi wrappers
+#include <preform/multi_math.hpp>
+
+// for pre::multi wrappers
+#include <preform/multi_misc_float.hpp>
+
+namespace pre {
+
+/**
+ * @defgroup mapped_image Mapped image
+ *
+ * `<preform/mapped_image.hpp>`
+ *
+ * __C++ version__: >=C++17
+ *
+ * Tiled binary container for 2- and 3-dimensional images with mip
+ * levels, laid out so that it can be read in place through a
+ * read-only memory mapping. Pages, and thus tiles, are read from
+ * disk only when first touched.
+ *
+ * Layout, with all fields in the recorded byte order:
+ *
+ * Bytes   | Field
+ * --------|-------
+ * 8       | Magic `"PREFORMI"`
+ * 4       | Version, currently 1
+ * 4       | Byte order, 0 for little or 1 for big endian
+ * 4       | Dimensions, 2 or 3
+ * 4       | Channels
+ * 4       | Element kind, see `mapped_element_kind`
+ * 4       | Element size, in bytes
+ * 4       | Tile size, in entries along each dimension
+ * 4       | Level count
+ * 32 each | Level records, 3 sizes and byte offset, as 64-bit integers
+ *
+ * Each level starts at a page-aligned offset, and holds its tiles
+ * in row-major order, each tile holding its entries in row-major
+ * order. Edge tiles are padded to the full tile size, so that
+ * addressing needs no per-tile table.
+ */
+/**@{*/
+
+/**
+ * @brief Mapped element kind.
+ */
+enum class mapped_element_kind : std::uint32_t {
+
+    /**
+     * @brief Unsigned integer.
+     */
+    unsigned_integer = 0,
+
+    /**
+     * @brief Signed integer.
+     */
+    signed_integer = 1,
+
+    /**
+     * @brief Floating point.
+     */
+    floating_point = 2
+};
+
+/**
+ * @brief Mapped element kind of type.
+ */
+template <typename T>
+constexpr mapped_element_kind mapped_element_kind_of() noexcept
+{
+    static_assert(
+        std::is_arithmetic<T>::value,
+        "T must be arithmetic");
+    return std::is_floating_point<T>::value ?
+           mapped_element_kind::floating_point :
+           std::is_signed<T>::value ?
+           mapped_element_kind::signed_integer :
+           mapped_element_kind::unsigned_integer;
+}
+
+/**
+ * @brief Mapped file.
+ *
+ * Read-only memory mapping of a whole file, or, on platforms
+ * without `mmap`, a copy of the whole file in memory.
+ */
+class mapped_file
+{
+public:
+
+    /**
+     * @brief Default constructor.
+     */
+    mapped_file() = default;
+
+    /**
+     * @brief Constructor.
+     *
+     * @param[in] path
+     * Path.
+     *
+     * @throw std::runtime_error
+     * If the file cannot be opened or mapped.
+     */
+    explicit mapped_file(const std::string& path)
+    {
+#if defined(__unix__) || defined(__APPLE__)
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error(__PRETTY_FUNCTION__);
+        }
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            throw std::runtime_error(__PRETTY_FUNCTION__);
+        }
+        size_ = std::size_t(st.st_size);
+        if (size_ > 0) {
+            void* ptr = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+            if (ptr == MAP_FAILED) {
+                ::close(fd);
+                throw std::runtime_error(__PRETTY_FUNCTION__);
+            }
+            data_ = static_cast<const char*>(ptr);
+        }
+        ::close(fd);
+#else
+        std::ifstream ifs(path, std::ios::binary | std::ios::ate);
+        if (!ifs) {
+            throw std::runtime_error(__PRETTY_FUNCTION__);
+        }
+        copy_.resize(std::size_t(ifs.tellg()));
+        ifs.seekg(0);
+        ifs.read(copy_.data(), copy_.size());
+        data_ = copy_.data();
+        size_ = copy_.size();
+#endif // #if defined(__unix__) || defined(__APPLE__)
+    }
+
+    /**
+     * @brief Non-copyable.
+     */
+    mapped_file(const mapped_file&) = delete;
+
+    /**
+     * @brief Move constructor.
+     */
+    mapped_file(mapped_file&& other) noexcept
+    {
+        swap(other);
+    }
+
+    /**
+     * @brief Destructor.
+     */
+    ~mapped_file()
+    {
+#if defined(__unix__) || defined(__APPLE__)
+        if (data_) {
+            ::munmap(const_cast<char*>(data_), size_);
+        }
+#endif // #if defined(__unix__) || defined(__APPLE__)
+    }
+
+    /**
+     * @brief Non-copyable.
+     */
+    mapped_file& operator=(const mapped_file&) = delete;
+
+    /**
+     * @brief Move assignment.
+     */
+    mapped_file& operator=(mapped_file&& other) noexcept
+    {
+        mapped_file tmp(std::move(other));
+        swap(tmp);
+        return *this;
+    }
+
+    /**
+     * @brief Swap.
+     */
+    void swap(mapped_file& other) noexcept
+    {
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+#if !(defined(__unix__) || defined(__APPLE__))
+        std::swap(copy_, other.copy_);
+#endif // #if !(defined(__unix__) || defined(__APPLE__))
+    }
+
+    /**
+     * @brief Data.
+     */
+    const char* data() const noexcept
+    {
+        return data_;
+    }
+
+    /**
+     * @brief Size, in bytes.
+     */
+    std::size_t size() const noexcept
+    {
+        return size_;
+    }
+
+private:
+
+    /**
+     * @brief Data.
+     */
+    const char* data_ = nullptr;
+
+    /**
+     * @brief Size.
+     */
+    std::size_t size_ = 0;
+
+#if !(defined(__unix__) || defined(__APPLE__))
+
+    /**
+     * @brief Copy, without mmap.
+     */
+    std::vector<char> copy_;
+
+#endif // #if !(defined(__unix__) || defined(__APPLE__))
+};
+
+/**
+ * @brief Mapped image.
+ *
+ * Read-only view of a mapped image container, with one image per
+ * mip level. Entries are read in place, so opening is immediate
+ * regardless of image size.
+ *
+ * @tparam Tfloat
+ * Float type, for sampling.
+ *
+ * @tparam T
+ * Entry type, which must match the file.
+ *
+ * @tparam N
+ * Channels, which must match the file.
+ *
+ * @tparam Ndims
+ * Dimensions, either 2 or 3.
+ */
+template <
+    typename Tfloat,
+    typename T, std::size_t N,
+    std::size_t Ndims
+    >
+class mapped_image
+{
+public:
+
+    // Sanity check.
+    static_assert(
+        Ndims == 2 || Ndims == 3,
+        "Ndims must be 2 or 3");
+
+    /**
+     * @brief Float type.
+     */
+    typedef Tfloat float_type;
+
+    /**
+     * @brief Entry type.
+     */
+    typedef T entry_type;
+
+    /**
+     * @brief Value type.
+     */
+    typedef multi<T, N> value_type;
+
+    /**
+     * @brief Size type.
+     */
+    typedef std::size_t size_type;
+
+    /**
+     * @brief Index type.
+     */
+    typedef multi<size_type, Ndims> index_type;
+
+public:
+
+    /**
+     * @brief Default constructor.
+     */
+    mapped_image() = default;
+
+    /**
+     * @brief Constructor, from file.
+     *
+     * @param[in] path
+     * Path.
+     *
+     * @throw std::runtime_error
+     * If the file cannot be mapped, is malformed, or does not
+     * match `T`, `N`, and `Ndims`.
+     *
+     * @note
+     * Files written in the other byte order open correctly, but
+     * not in place: entries are copied and byte swapped in bulk.
+     */
+    explicit mapped_image(const std::string& path) : file_(path)
+    {
+        const char* data = file_.data();
+        std::size_t size = file_.size();
+        if (size < header_size ||
+            std::memcmp(data, "PREFORMI", 8) != 0) {
+            throw std::runtime_error(__PRETTY_FUNCTION__);
+        }
+        std::uint32_t fields[8];
+        std::memcpy(fields, data + 8, sizeof(fields));
+
+        // Written in the other byte order?
+        std::uint32_t order = std::uint32_t(host_byte_order());
+        bool rev = fields[1] != order;
+        if (rev) {
+            byte_swap(&fields[0], 8);
+            order = 1 - order;
+        }
+        if (fields[0] != 1 ||
+            fields[1] != order ||
+            fields[2] != Ndims ||
+            fields[3] != N ||
+            fields[4] != std::uint32_t(mapped_element_kind_of<T>()) ||
+            fields[5] != sizeof(T) ||
+            fields[6] == 0 ||
+            size < header_size + fields[7] * level_record_size) {
+            throw std::runtime_error(__PRETTY_FUNCTION__);
+        }
+        tile_size_ = fields[6];
+        levels_.resize(fields[7]);
+        for (level_type& level : levels_) {
+            std::uint64_t record[4];
+            std::memcpy(
+                record,
+                data + header_size +
+                       (&level - levels_.data()) * level_record_size,
+                sizeof(record));
+            if (rev) {
+                byte_swap(&record[0], 4);
+            }
+            for (size_type l = 0; l < Ndims; l++) {
+                level.size[l] = size_type(record[l]);
+                level.tiles[l] =
+                    (level.size[l] + tile_size_ - 1) / tile_size_;
+            }
+            if ((level.size == size_type(0)).any() ||
+                record[3] % alignof(value_type) != 0 ||
+                record[3] + level.tiles.prod() * tile_volume() *
+                            sizeof(value_type) > size) {
+                throw std::runtime_error(__PRETTY_FUNCTION__);
+            }
+            level.data =
+                reinterpret_cast<const value_type*>(data + record[3]);
+        }
+
+        // Copy and swap, if in the other byte order.
+        if (rev) {
+            size_type count = 0;
+            for (const level_type& level : levels_) {
+                count += level.tiles.prod() * tile_volume();
+            }
+            swapped_.resize(count);
+            value_type* dst = swapped_.data();
+            for (level_type& level : levels_) {
+                size_type level_count = level.tiles.prod() * tile_volume();
+                std::memcpy(dst, level.data, level_count * sizeof(value_type));
+                byte_swap(&(*dst)[0], level_count * N);
+                level.data = dst;
+                dst += level_count;
+            }
+        }
+    }
+
+public:
+
+    /**
+     * @brief Write container.
+     *
+     * @param[in] path
+     * Path.
+     *
+     * @param[in] images
+     * Images, one for each mip level, starting from the finest,
+     * such as `image2` or `image3`.
+     *
+     * @param[in] tile_size
+     * Tile size, in entries along each dimension.
+     *
+     * @param[in] order
+     * Byte order.
+     *
+     * @throw std::runtime_error
+     * If writing fails.
+     */
+    template <typename Timage>
+    static void write(
+            const std::string& path,
+            const std::vector<Timage>& images,
+            size_type tile_size = Ndims == 2 ? 64 : 16,
+            byte_order order = host_byte_order())
+    {
+        bool rev = order != host_byte_order();
+        std::ofstream ofs(path, std::ios::binary | std::ios::trunc);
+        if (!ofs || images.empty() || tile_size == 0) {
+            throw std::runtime_error(__PRETTY_FUNCTION__);
+        }
+        size_type volume = 1;
+        for (size_type l = 0; l < Ndims; l++) {
+            volume *= tile_size;
+        }
+
+        // Header.
+        std::uint32_t fields[8] = {
+            1,
+            std::uint32_t(order),
+            std::uint32_t(Ndims),
+            std::uint32_t(N),
+            std::uint32_t(mapped_element_kind_of<T>()),
+            std::uint32_t(sizeof(T)),
+            std::uint32_t(tile_size),
+            std::uint32_t(images.size())
+        };
+        if (rev) {
+            byte_swap(&fields[0], 8);
+        }
+        ofs.write("PREFORMI", 8);
+        ofs.write(reinterpret_cast<const char*>(fields), sizeof(fields));
+
+        // Level records.
+        std::uint64_t offset =
+            header_size + images.size() * level_record_size;
+        std::vector<std::uint64_t> offsets;
+        for (const Timage& image : images) {
+            offset = (offset + page_size - 1) / page_size * page_size;
+            offsets.push_back(offset);
+            std::uint64_t record[4] = {1, 1, 1, offset};
+            index_type tiles;
+            for (size_type l = 0; l < Ndims; l++) {
+                record[l] = image.user_size()[l];
+                tiles[l] = (image.user_size()[l] + tile_size - 1) / tile_size;
+            }
+            if (rev) {
+                byte_swap(&record[0], 4);
+            }
+            ofs.write(reinterpret_cast<const char*>(record), sizeof(record));
+            offset += tiles.prod() * volume * sizeof(value_type);
+        }
+
+        // Levels.
+        std::vector<value_type> tile(volume);
+        for (size_type level = 0; level < images.size(); level++) {
+            const Timage& image = images[level];
+            pad_to_(ofs, offsets[level]);
+            index_type size = image.user_size();
+            index_type tiles = (size + tile_size - 1) / tile_size;
+            for (size_type t = 0; t < tiles.prod(); t++) {
+                index_type origin = unravel_(t, tiles) * tile_size;
+                for (size_type n = 0; n < volume; n++) {
+                    index_type ind =
+                        origin + unravel_(n, index_type(tile_size));
+                    ind = pre::min(ind, size - 1);
+                    if constexpr (Ndims == 2) {
+                        tile[n] = image(ind[0], ind[1]);
+                    }
+                    else {
+                        tile[n] = image(ind[0], ind[1], ind[2]);
+                    }
+                }
+                if (rev) {
+                    byte_swap(&tile[0][0], volume * N);
+                }
+                ofs.write(
+                    reinterpret_cast<const char*>(tile.data()),
+                    volume * sizeof(value_type));
+            }
+        }
+        if (!ofs) {
+            throw std::runtime_error(__PRETTY_FUNCTION__);
+        }
+    }
+
+public:
+
+    /**
+     * @name Accessors
+     */
+    /**@{*/
+
+    /**
+     * @brief Level count.
+     */
+    int levels() const noexcept
+    {
+        return int(levels_.size());
+    }
+
+    /**
+     * @brief Level size.
+     */
+    index_type level_size(int level) const
+    {
+        return levels_[level].size;
+    }
+
+    /**
+     * @brief Tile size.
+     */
+    size_type tile_size() const noexcept
+    {
+        return tile_size_;
+    }
+
+    /**
+     * @brief Tile volume, in entries.
+     */
+    size_type tile_volume() const noexcept
+    {
+        size_type volume = 1;
+        for (size_type l = 0; l < Ndims; l++) {
+            volume *= tile_size_;
+        }
+        return volume;
+    }
+
+    /**
+     * @brief Get cycle mode.
+     */
+    multi<int, Ndims> cycle_mode() const
+    {
+        return cycle_mode_;
+    }
+
+    /**
+     * @brief Set cycle mode.
+     */
+    multi<int, Ndims> cycle_mode(multi<int, Ndims> mode)
+    {
+        multi<int, Ndims> prev = cycle_mode_;
+        cycle_mode_ = mode;
+        return prev;
+    }
+
+    /**
+     * @brief Set cycle mode.
+     */
+    multi<int, Ndims> cycle_mode(int mode)
+    {
+        return cycle_mode(multi<int, Ndims>(mode));
+    }
+
+    /**
+     * @brief Entry.
+     *
+     * @param[in] level
+     * Level.
+     *
+     * @param[in] ind
+     * Index, in range.
+     */
+    const value_type& operator()(int level, index_type ind) const
+    {
+        const level_type& lev = levels_[level];
+        index_type tile = ind / tile_size_;
+        ind %= tile_size_;
+        return lev.data[
+               ravel_(tile, lev.tiles) * tile_volume() +
+               ravel_(ind, index_type(tile_size_))];
+    }
+
+    /**@}*/
+
+public:
+
+    /**
+     * @name Sampling
+     */
+    /**@{*/
+
+    /**
+     * @brief Sample.
+     *
+     * @param[in] samp
+     * Sampling method, either 0, 1, or 3.
+     *
+     * @param[in] level
+     * Level.
+     *
+     * @param[in] loc
+     * Location.
+     */
+    multi<float_type, N> sample(
+            int samp, int level,
+            multi<float_type, Ndims> loc) const
+    {
+        switch (samp) {
+            default:
+            case 0: return fetch(level, fastfloor(loc));
+            case 1: return sample_<2>(level, loc);
+            case 3: return sample_<4>(level, loc);
+        }
+    }
+
+    /**@}*/
+
+public:
+
+    /**
+     * @name Loading
+     */
+    /**@{*/
+
+    /**
+     * @brief Load level into image.
+     *
+     * @param[in] level
+     * Level.
+     *
+     * @param[out] image
+     * Image, such as `image2` or `image3`, resized.
+     */
+    template <typename Timage>
+    void load(int level, Timage& image) const
+    {
+        image.resize(level_size(level));
+        load_region(level, index_type(), image);
+    }
+
+    /**
+     * @brief Load region of level into image.
+     *
+     * Copy entries of the level at the given origin into the
+     * image, at the image's current size. With `Ndims` of 2, this
+     * fits `texture_cache` as a tile loader.
+     *
+     * @param[in] level
+     * Level.
+     *
+     * @param[in] origin
+     * Origin.
+     *
+     * @param[out] image
+     * Image.
+     */
+    template <typename Timage>
+    void load_region(int level, index_type origin, Timage& image) const
+    {
+        index_type size = image.user_size();
+        for (size_type n = 0; n < size.prod(); n++) {
+            index_type ind = unravel_(n, size);
+            if constexpr (Ndims == 2) {
+                image(ind[0], ind[1]) =
+                    operator()(level, origin + ind);
+            }
+            else {
+                image(ind[0], ind[1], ind[2]) =
+                    operator()(level, origin + ind);
+            }
+        }
+    }
+
+    /**@}*/
+
+private:
+
+    /**
+     * @brief Level.
+     */
+    struct level_type
+    {
+        /**
+         * @brief Size.
+         */
+        index_type size = {};
+
+        /**
+         * @brief Tile count along each dimension.
+         */
+        index_type tiles = {};
+
+        /**
+         * @brief Data.
+         */
+        const value_type* data = nullptr;
+    };
+
+    /**
+     * @brief Header size, in bytes.
+     */
+    static constexpr size_type header_size = 40;
+
+    /**
+     * @brief Level record size, in bytes.
+     */
+    static constexpr size_type level_record_size = 32;
+
+    /**
+     * @brief Page size, for level alignment.
+     */
+    static constexpr size_type page_size = 4096;
+
+    /**
+     * @brief File.
+     */
+    mapped_file file_;
+
+    /**
+     * @brief Swapped copy, if in the other byte order.
+     */
+    std::vector<value_type> swapped_;
+
+    /**
+     * @brief Tile size.
+     */
+    size_type tile_size_ = 0;
+
+    /**
+     * @brief Levels.
+     */
+    std::vector<level_type> levels_;
+
+    /**
+     * @brief Cycle mode.
+     *
+     *  Value | Behavior
+     * -------|----------
+     *  0     | Clamp
+     *  +1    | Repeat
+     *  -1    | Repeat with mirroring
+     */
+    multi<int, Ndims> cycle_mode_ = {};
+
+#if !DOXYGEN
+
+    /**
+     * @brief Row-major linear index.
+     */
+    static size_type ravel_(index_type ind, index_type size) noexcept
+    {
+        size_type n = 0;
+        for (size_type l = 0; l < Ndims; l++) {
+            n = n * size[l] + ind[l];
+        }
+        return n;
+    }
+
+    /**
+     * @brief Row-major index from linear index.
+     */
+    static index_type unravel_(size_type n, index_type size) noexcept
+    {
+        index_type ind;
+        for (size_type l = Ndims; l-- > 0;) {
+            ind[l] = n % size[l];
+            n /= size[l];
+        }
+        return ind;
+    }
+
+    /**
+     * @brief Pad stream with zeros to offset.
+     */
+    static void pad_to_(std::ofstream& ofs, std::uint64_t offset)
+    {
+        static const char zeros[64] = {};
+        std::uint64_t pos = std::uint64_t(ofs.tellp());
+        while (pos < offset) {
+            std::uint64_t count = std::min<std::uint64_t>(offset - pos, 64);
+            ofs.write(zeros, count);
+            pos += count;
+        }
+    }
+
+    /**
+     * @brief Fetch.
+     */
+    multi<float_type, N> fetch(int level, multi<int, Ndims> ind) const
+    {
+        const level_type& lev = levels_[level];
+        for (size_type l = 0; l < Ndims; l++) {
+            switch (cycle_mode_[l]) {
+                default:
+                case 0:  ind[l] = clamp(ind[l], int(lev.size[l])); break;
+                case +1: ind[l] = repeat(ind[l], int(lev.size[l])); break;
+                case -1: ind[l] = mirror(ind[l], int(lev.size[l])); break;
+            }
+        }
+        return fstretch<float_type>(operator()(level, index_type(ind)));
+    }
+
+    /**
+     * @brief Sample, with taps per dimension, linear if 2 and
+     * Catmull-Rom if 4.
+     */
+    template <int Ntaps>
+    multi<float_type, N> sample_(
+            int level, multi<float_type, Ndims> loc) const
+    {
+        // Shift.
+        loc -= float_type(0.5);
+
+        // Floor.
+        multi<int, Ndims> ind = fastfloor(loc);
+        loc -= ind;
+        ind -= Ntaps / 2 - 1;
+
+        // Weights.
+        float_type weights[Ndims][Ntaps];
+        for (size_type l = 0; l < Ndims; l++) {
+            if constexpr (Ntaps == 2) {
+                weights[l][0] = 1 - loc[l];
+                weights[l][1] = loc[l];
+            }
+            else {
+                for (int k = 0; k < 4; k++) {
+                    weights[l][k] =
+                        catmull(
+                            loc[l],
+                            float_type(k == 0), float_type(k == 1),
+                            float_type(k == 2), float_type(k == 3));
+                }
+            }
+        }
+
+        // Accumulate.
+        multi<float_type, N> res = {};
+        multi<int, Ndims> taps(Ntaps);
+        for (int n = 0; n < taps.prod(); n++) {
+            multi<int, Ndims> off;
+            float_type weight = 1;
+            for (int l = int(Ndims) - 1, m = n; l >= 0; l--, m /= Ntaps) {
+                off[l] = m % Ntaps;
+                weight *= weights[l][off[l]];
+            }
+            res += weight * fetch(level, ind + off);
+        }
+        return res;
+    }
+
+#endif // #if !DOXYGEN
+};
+
+/**
+ * @brief Mapped image (2-dimensional).
+ */
+template <typename Tfloat, typename T, std::size_t N>
+using mapped_image2 = mapped_image<Tfloat, T, N, 2>;
+
+/**
+ * @brief Mapped image (3-dimensional).
+ */
+template <typename Tfloat, typename T, std::size_t N>
+using mapped_image3 = mapped_image<Tfloat, T, N, 3>;
+
+/**@}*/
+
+} // namespace pre
+
+#endif // #ifndef PREFORM_MAPPED_IMAGE_HPP
@@ -35,6 +35,15 @@
 #ifndef PREFORM_MEDIUM_HPP
 #define PREFORM_MEDIUM_HPP
 
+// for std::fill, std::min, std::max, std::swap
+#include <algorithm>
+
+// for std::invalid_argument
+#include <stdexcept>
+
+// for std::vector
+#include <vector>
+
 // for pre::multi
 #include <preform/multi.hpp>
 
@@ -136,6 +145,74 @@ public:
                multi<float_type, 3>::hg_phase_pdf_sample(g_, u)));
     }
 
+    /**
+     * @brief Phase function, batched.
+     *
+     * @param[in] wo
+     * Outgoing directions.
+     *
+     * @param[in] wi
+     * Incident directions.
+     *
+     * @param[in] count
+     * Count.
+     *
+     * @param[out] res
+     * Output phase function values.
+     */
+    void ps_many(
+            const multi<float_type, 3>* wo,
+            const multi<float_type, 3>* wi,
+            std::size_t count,
+            float_type* res) const
+    {
+        if (pre::fabs(g_) < float_type(0.00001)) {
+            std::fill(res, res + count,
+                      multi<float_type, 3>::uniform_sphere_pdf());
+            return;
+        }
+
+        // Hoist constants.
+        float_type g = g_;
+        g = pre::fmin(g, float_type(+0.99999));
+        g = pre::fmax(g, float_type(-0.99999));
+        float_type a = float_type(0.25) *
+                       pre::numeric_constants<float_type>::M_1_pi() *
+                       (1 - g * g);
+        float_type b0 = 1 + g * g;
+        float_type b1 = 2 * g;
+        for (std::size_t j = 0; j < count; j++) {
+            float_type b = b0 + b1 * dot(wo[j], wi[j]);
+            res[j] = a / pre::sqrt(b * b * b);
+        }
+    }
+
+    /**
+     * @brief Phase function sample direction, batched.
+     *
+     * @param[in] u
+     * Samples in @f$ [0, 1)^2 @f$.
+     *
+     * @param[in] wo
+     * Outgoing directions.
+     *
+     * @param[in] count
+     * Count.
+     *
+     * @param[out] wi
+     * Output incident directions.
+     */
+    void ps_sample_many(
+            const multi<float_type, 2>* u,
+            const multi<float_type, 3>* wo,
+            std::size_t count,
+            multi<float_type, 3>* wi) const
+    {
+        for (std::size_t j = 0; j < count; j++) {
+            wi[j] = ps_sample(u[j], wo[j]);
+        }
+    }
+
 private:
 
     /**
@@ -273,6 +350,80 @@ public:
                multi<float_type, 3>::hg_phase_pdf_sample(g_[k], u)));
     }
 
+    /**
+     * @brief Phase function, batched.
+     *
+     * @param[in] wo
+     * Outgoing directions.
+     *
+     * @param[in] wi
+     * Incident directions.
+     *
+     * @param[in] count
+     * Count.
+     *
+     * @param[out] res
+     * Output phase function values.
+     */
+    void ps_many(
+            const multi<float_type, 3>* wo,
+            const multi<float_type, 3>* wi,
+            std::size_t count,
+            float_type* res) const
+    {
+        std::fill(res, res + count, float_type(0));
+        for (std::size_t k = 0; k < Nlobes; k++) {
+            if (pre::fabs(g_[k]) < float_type(0.00001)) {
+                float_type a = w_[k] *
+                               multi<float_type, 3>::uniform_sphere_pdf();
+                for (std::size_t j = 0; j < count; j++) {
+                    res[j] += a;
+                }
+                continue;
+            }
+
+            // Hoist constants.
+            float_type g = g_[k];
+            g = pre::fmin(g, float_type(+0.99999));
+            g = pre::fmax(g, float_type(-0.99999));
+            float_type a = float_type(0.25) * w_[k] *
+                           pre::numeric_constants<float_type>::M_1_pi() *
+                           (1 - g * g);
+            float_type b0 = 1 + g * g;
+            float_type b1 = 2 * g;
+            for (std::size_t j = 0; j < count; j++) {
+                float_type b = b0 + b1 * dot(wo[j], wi[j]);
+                res[j] += a / pre::sqrt(b * b * b);
+            }
+        }
+    }
+
+    /**
+     * @brief Phase function sample direction, batched.
+     *
+     * @param[in] u
+     * Samples in @f$ [0, 1)^2 @f$.
+     *
+     * @param[in] wo
+     * Outgoing directions.
+     *
+     * @param[in] count
+     * Count.
+     *
+     * @param[out] wi
+     * Output incident directions.
+     */
+    void ps_sample_many(
+            const multi<float_type, 2>* u,
+            const multi<float_type, 3>* wo,
+            std::size_t count,
+            multi<float_type, 3>* wi) const
+    {
+        for (std::size_t j = 0; j < count; j++) {
+            wi[j] = ps_sample(u[j], wo[j]);
+        }
+    }
+
 private:
 
     /**
@@ -394,6 +545,65 @@ public:
         return dot(multi<float_type, 3, 3>::build_onb(-wo), wi);
     }
 
+    /**
+     * @brief Phase function, batched.
+     *
+     * @param[in] wo
+     * Outgoing directions.
+     *
+     * @param[in] wi
+     * Incident directions.
+     *
+     * @param[in] count
+     * Count.
+     *
+     * @param[out] res
+     * Output phase function values.
+     */
+    void ps_many(
+            const multi<float_type, 3>* wo,
+            const multi<float_type, 3>* wi,
+            std::size_t count,
+            float_type* res) const
+    {
+        // Hoist constants.
+        float_type gam = rho_ / (2 - rho_);
+        float_type fac = pre::numeric_constants<float_type>::M_1_pi() *
+                         float_type(0.1875) / (1 + 2 * gam);
+        float_type a = fac * (1 - gam);
+        float_type b = fac * (1 + 3 * gam);
+        for (std::size_t j = 0; j < count; j++) {
+            float_type cos_theta = dot(wo[j], wi[j]);
+            res[j] = a * cos_theta * cos_theta + b;
+        }
+    }
+
+    /**
+     * @brief Phase function sample direction, batched.
+     *
+     * @param[in] u
+     * Samples in @f$ [0, 1)^2 @f$.
+     *
+     * @param[in] wo
+     * Outgoing directions.
+     *
+     * @param[in] count
+     * Count.
+     *
+     * @param[out] wi
+     * Output incident directions.
+     */
+    void ps_sample_many(
+            const multi<float_type, 2>* u,
+            const multi<float_type, 3>* wo,
+            std::size_t count,
+            multi<float_type, 3>* wi) const
+    {
+        for (std::size_t j = 0; j < count; j++) {
+            wi[j] = ps_sample(u[j], wo[j]);
+        }
+    }
+
 private:
 
     /**
@@ -463,6 +673,40 @@ public:
         sdet1_2_ = pre::sqrt(s.prod());
     }
 
+    /**
+     * @brief Constructor, from distribution matrix.
+     *
+     * This prepares the inverse and determinant root once, so that
+     * a volume storing the symmetric distribution matrix per voxel
+     * may construct a microvolume per voxel lookup, and then reuse
+     * it for every phase function evaluation or sample there.
+     *
+     * @param[in] s
+     * Distribution matrix, symmetric positive definite.
+     */
+    explicit microvolume_sggx(const multi<float_type, 3, 3>& s) : s_(s)
+    {
+        // Adjugate.
+        multi<float_type, 3, 3> adj;
+        adj[0][0] = s[1][1] * s[2][2] - s[1][2] * s[2][1];
+        adj[0][1] = s[0][2] * s[2][1] - s[0][1] * s[2][2];
+        adj[0][2] = s[0][1] * s[1][2] - s[0][2] * s[1][1];
+        adj[1][0] = s[1][2] * s[2][0] - s[1][0] * s[2][2];
+        adj[1][1] = s[0][0] * s[2][2] - s[0][2] * s[2][0];
+        adj[1][2] = s[0][2] * s[1][0] - s[0][0] * s[1][2];
+        adj[2][0] = s[1][0] * s[2][1] - s[1][1] * s[2][0];
+        adj[2][1] = s[0][1] * s[2][0] - s[0][0] * s[2][1];
+        adj[2][2] = s[0][0] * s[1][1] - s[0][1] * s[1][0];
+
+        // Determinant, inverse, and determinant root.
+        float_type det =
+            s[0][0] * adj[0][0] +
+            s[0][1] * adj[1][0] +
+            s[0][2] * adj[2][0];
+        sinv_ = adj / det;
+        sdet1_2_ = pre::sqrt(det);
+    }
+
     /**
      * @brief Projected area.
      *
@@ -550,24 +794,27 @@ public:
         multi<float_type, 3, 3> q =
         multi<float_type, 3, 3>::build_onb(wo);
 
-        // Project distribution matrix into basis.
-        multi<float_type, 3, 3> s = dot(transpose(q), dot(s_, q));
+        // Project distribution matrix into basis, computing only the
+        // entries used below.
+        multi<float_type, 3, 3> qt = transpose(q);
+        multi<float_type, 3> s_q1 = dot(s_, qt[1]);
+        multi<float_type, 3> s_q2 = dot(s_, qt[2]);
+        float_type s10 = dot(qt[0], s_q1);
+        float_type s11 = dot(qt[1], s_q1);
+        float_type s20 = dot(qt[0], s_q2);
+        float_type s21 = dot(qt[1], s_q2);
+        float_type s22 = dot(qt[2], s_q2);
 
         // Compute component vectors.
-        float_type tmp0 = pre::sqrt(s[2][2]);
-        float_type tmp1 = pre::sqrt(s[1][1] * s[2][2] - s[1][2] * s[2][1]);
+        float_type tmp0 = pre::sqrt(s22);
+        float_type tmp1 = pre::sqrt(s11 * s22 - s21 * s21);
         multi<float_type, 3> mx = {sdet1_2_ / tmp1, 0, 0};
         multi<float_type, 3> my = {
-            -(s[2][0] * s[2][1] -
-              s[1][0] * s[2][2]) / tmp1,
+            -(s20 * s21 - s10 * s22) / tmp1,
             tmp1,
             0
         };
-        multi<float_type, 3> mz = {
-            s[2][0],
-            s[2][1],
-            s[2][2]
-        };
+        multi<float_type, 3> mz = {s20, s21, s22};
         my *= 1 / tmp0;
         mz *= 1 / tmp0;
 
@@ -694,6 +941,58 @@ public:
         multi<float_type, 3> wi = normalize_fast(-wo + 2 * dot(wo, wm) * wm);
         return wi;
     }
+
+    /**
+     * @brief Phase function, batched.
+     *
+     * @param[in] wo
+     * Outgoing directions.
+     *
+     * @param[in] wi
+     * Incident directions.
+     *
+     * @param[in] count
+     * Count.
+     *
+     * @param[out] res
+     * Output phase function values.
+     */
+    void ps_many(
+            const multi<float_type, 3>* wo,
+            const multi<float_type, 3>* wi,
+            std::size_t count,
+            float_type* res) const
+    {
+        for (std::size_t j = 0; j < count; j++) {
+            res[j] = ps(wo[j], wi[j]);
+        }
+    }
+
+    /**
+     * @brief Phase function sample direction, batched.
+     *
+     * @param[in] u
+     * Samples in @f$ [0, 1)^2 @f$.
+     *
+     * @param[in] wo
+     * Outgoing directions.
+     *
+     * @param[in] count
+     * Count.
+     *
+     * @param[out] wi
+     * Output incident directions.
+     */
+    void ps_sample_many(
+            const multi<float_type, 2>* u,
+            const multi<float_type, 3>* wo,
+            std::size_t count,
+            multi<float_type, 3>* wi) const
+    {
+        for (std::size_t j = 0; j < count; j++) {
+            wi[j] = ps_sample(u[j], wo[j]);
+        }
+    }
 };
 
 /**
@@ -806,6 +1105,70 @@ public:
         return normalize_fast(
                dot(multi<float_type, 3, 3>::build_onb(wm), wi));
     }
+
+    /**
+     * @brief Phase function, batched.
+     *
+     * @param[in] u
+     * Samples in @f$ [0, 1)^2 @f$.
+     *
+     * @param[in] wo
+     * Outgoing directions.
+     *
+     * @param[in] wi
+     * Incident directions.
+     *
+     * @param[in] count
+     * Count.
+     *
+     * @param[out] res
+     * Output phase function values.
+     */
+    void ps_many(
+            const multi<float_type, 2>* u,
+            const multi<float_type, 3>* wo,
+            const multi<float_type, 3>* wi,
+            std::size_t count,
+            float_type* res) const
+    {
+        for (std::size_t j = 0; j < count; j++) {
+            res[j] = ps(u[j], wo[j], wi[j]);
+        }
+    }
+
+    /**
+     * @brief Phase function sample direction, batched.
+     *
+     * @param[in] u0
+     * Samples in @f$ [0, 1)^2 @f$.
+     *
+     * @param[in] u1
+     * Samples in @f$ [0, 1)^2 @f$.
+     *
+     * @param[in] wo
+     * Outgoing directions.
+     *
+     * @param[in] count
+     * Count.
+     *
+     * @param[out] wi
+     * Output incident directions.
+     *
+     * @param[out] pdf
+     * _Optional_. Output PDFs.
+     */
+    void ps_sample_many(
+            const multi<float_type, 2>* u0,
+            const multi<float_type, 2>* u1,
+            const multi<float_type, 3>* wo,
+            std::size_t count,
+            multi<float_type, 3>* wi,
+            float_type* pdf = nullptr) const
+    {
+        for (std::size_t j = 0; j < count; j++) {
+            wi[j] = ps_sample(u0[j], u1[j], wo[j], pdf ? pdf + j : nullptr);
+        }
+    }
 };
 
 #if 0
@@ -985,7 +1348,7 @@ public:
      */
     float_type mua() const
     {
-        return mus_;
+        return mua_;
     }
 
     /**
@@ -1091,6 +1454,485 @@ private:
     float_type mu_ = 0;
 };
 
+/**
+ * @brief Heterogeneous medium.
+ *
+ * Medium with extinction proportional to a density volume, e.g.,
+ * an `image3` or `sparse_image3` whose first channel is density,
+ * and with constant single-scattering albedo. Locations, directions,
+ * and distances are in the index space of the volume, such that
+ * the medium occupies @f$ [0, n_x] \times [0, n_y] \times [0, n_z] @f$,
+ * and is empty outside.
+ *
+ * A majorant grid holds, for each cell of @f$ s^3 @f$ voxels, an
+ * upper bound on the density any sample in the cell may return,
+ * accounting for the footprint and overshoot of the sampling method.
+ * A max mip of the majorant grid then lets tracking skip empty space
+ * in the largest empty cell around the current location, rather than
+ * one cell at a time.
+ *
+ * Collisions are sampled with delta tracking, and transmittance
+ * is estimated with ratio tracking. Both restart against the local
+ * majorant in each cell, and are unbiased.
+ *
+ * @tparam Tfloat
+ * Float type.
+ *
+ * @tparam Tvolume
+ * Density volume type, with `user_size()` and `sample(samp, loc)`.
+ *
+ * ### References
+ *
+ * 1. J. Novak, A. Selle, and W. Jarosz, &ldquo;Residual ratio tracking
+ * for estimating attenuation in participating media,&rdquo; _ACM
+ * Transactions on Graphics (Proceedings of SIGGRAPH Asia)_, vol. 33,
+ * no. 6, Nov. 2014.
+ */
+template <typename Tfloat, typename Tvolume>
+class heterogeneous_medium
+{
+public:
+
+    // Sanity check.
+    static_assert(
+        std::is_floating_point<Tfloat>::value,
+        "Tfloat must be floating point");
+
+    /**
+     * @brief Float type.
+     */
+    typedef Tfloat float_type;
+
+    /**
+     * @brief Volume type.
+     */
+    typedef Tvolume volume_type;
+
+public:
+
+    /**
+     * @brief Default constructor.
+     */
+    heterogeneous_medium() = default;
+
+    /**
+     * @brief Constructor.
+     *
+     * @param[in] volume
+     * Density volume, which must outlive the medium, and must not
+     * change without re-initializing the medium.
+     *
+     * @param[in] mua
+     * Absorption coefficient at unit density.
+     *
+     * @param[in] mus
+     * Scattering coefficient at unit density.
+     *
+     * @param[in] samp
+     * Sampling method, either 0, 1, or 3.
+     *
+     * @param[in] cell_size
+     * Majorant grid cell size, in voxels.
+     *
+     * @throw std::invalid_argument
+     * If cell size is not positive.
+     */
+    heterogeneous_medium(
+            const volume_type& volume,
+            float_type mua,
+            float_type mus,
+            int samp = 1,
+            int cell_size = 8) :
+                volume_(&volume),
+                mua_(mua),
+                mus_(mus),
+                mu_(mua + mus),
+                samp_(samp == 1 || samp == 3 ? samp : 0),
+                cell_size_(cell_size)
+    {
+        if (!(cell_size > 0)) {
+            throw std::invalid_argument(__PRETTY_FUNCTION__);
+        }
+        init_();
+    }
+
+public:
+
+    /**
+     * @name Accessors
+     */
+    /**@{*/
+
+    /**
+     * @brief Absorption coefficient @f$ \mu_a @f$ at unit density.
+     */
+    float_type mua() const
+    {
+        return mua_;
+    }
+
+    /**
+     * @brief Scattering coefficient @f$ \mu_s @f$ at unit density.
+     */
+    float_type mus() const
+    {
+        return mus_;
+    }
+
+    /**
+     * @brief Extinction coefficient @f$ \mu = \mu_a + \mu_s @f$ at
+     * unit density.
+     */
+    float_type mu() const
+    {
+        return mu_;
+    }
+
+    /**
+     * @brief Density at location.
+     *
+     * @param[in] loc
+     * Location.
+     */
+    float_type density(const multi<float_type, 3>& loc) const
+    {
+        for (int k = 0; k < 3; k++) {
+            if (!(loc[k] >= 0 && loc[k] <= float_type(size_[k]))) {
+                return 0;
+            }
+        }
+        return pre::fmax(
+               float_type(volume_->sample(samp_, loc)[0]),
+               float_type(0));
+    }
+
+    /**
+     * @brief Majorant density at location.
+     *
+     * @param[in] loc
+     * Location.
+     */
+    float_type majorant(const multi<float_type, 3>& loc) const
+    {
+        multi<int, 3> cell;
+        for (int k = 0; k < 3; k++) {
+            if (!(loc[k] >= 0 && loc[k] <= float_type(size_[k]))) {
+                return 0;
+            }
+            cell[k] = std::min(
+                      int(loc[k] / cell_size_), mip_size_[0][k] - 1);
+        }
+        return mip_[0][mip_index_(0, cell)];
+    }
+
+    /**@}*/
+
+public:
+
+    /**
+     * @brief Transmittance estimate, by ratio tracking.
+     *
+     * @param[inout] gen
+     * Generator.
+     *
+     * @param[in] loc
+     * Ray origin.
+     *
+     * @param[in] dir
+     * Ray direction, normalized.
+     *
+     * @param[in] d
+     * Distance.
+     */
+    template <typename Tgen>
+    float_type tau(
+            Tgen& gen,
+            const multi<float_type, 3>& loc,
+            const multi<float_type, 3>& dir,
+            float_type d) const
+    {
+        if (!(d >= 0)) {
+            return 0;
+        }
+        float_type tr = 1;
+        track_(gen, loc, dir, d,
+        [&](float_type, float_type ratio) {
+            tr *= 1 - ratio;
+            return !(tr > 0);
+        });
+        return tr;
+    }
+
+    /**
+     * @brief Transmittance probability density function sampling
+     * routine, by delta tracking.
+     *
+     * @param[inout] gen
+     * Generator.
+     *
+     * @param[in] loc
+     * Ray origin.
+     *
+     * @param[in] dir
+     * Ray direction, normalized.
+     *
+     * @param[in] dmax
+     * _Optional_. Distance maximum.
+     *
+     * @returns
+     * Distance to collision, with density proportional to
+     * @f$ \mu(d) \tau(d) @f$, or infinity if the ray escapes before
+     * `dmax`. From a collision, the probability of scattering rather
+     * than absorption is @f$ \mu_s / \mu @f$.
+     */
+    template <typename Tgen>
+    float_type tau_pdf_sample(
+            Tgen& gen,
+            const multi<float_type, 3>& loc,
+            const multi<float_type, 3>& dir,
+            float_type dmax =
+                pre::numeric_limits<float_type>::infinity()) const
+    {
+        float_type res = pre::numeric_limits<float_type>::infinity();
+        track_(gen, loc, dir, dmax,
+        [&](float_type t, float_type ratio) {
+            if (pre::generate_canonical<float_type>(gen) < ratio) {
+                res = t;
+                return true;
+            }
+            return false;
+        });
+        return res;
+    }
+
+private:
+
+    /**
+     * @brief Volume.
+     */
+    const volume_type* volume_ = nullptr;
+
+    /**
+     * @brief Absorption coefficient @f$ \mu_a \ge 0 @f$.
+     */
+    float_type mua_ = 0;
+
+    /**
+     * @brief Scattering coefficient @f$ \mu_s \ge 0 @f$.
+     */
+    float_type mus_ = 0;
+
+    /**
+     * @brief Extinction coefficient @f$ \mu = \mu_a + \mu_s @f$.
+     */
+    float_type mu_ = 0;
+
+    /**
+     * @brief Sampling method.
+     */
+    int samp_ = 0;
+
+    /**
+     * @brief Majorant grid cell size, in voxels.
+     */
+    int cell_size_ = 8;
+
+    /**
+     * @brief Volume size.
+     */
+    multi<int, 3> size_ = {};
+
+    /**
+     * @brief Max mip sizes, with level 0 the majorant grid.
+     */
+    std::vector<multi<int, 3>> mip_size_;
+
+    /**
+     * @brief Max mip levels.
+     */
+    std::vector<std::vector<float_type>> mip_;
+
+#if !DOXYGEN
+
+    /**
+     * @brief Max mip index.
+     */
+    std::size_t mip_index_(int level, const multi<int, 3>& cell) const
+    {
+        const multi<int, 3>& size = mip_size_[level];
+        return (std::size_t(cell[0]) * size[1] + cell[1]) * size[2] + cell[2];
+    }
+
+    /**
+     * @brief Initialize majorant grid and max mip.
+     */
+    void init_()
+    {
+        auto user_size = volume_->user_size();
+        for (int k = 0; k < 3; k++) {
+            size_[k] = int(user_size[k]);
+        }
+        mip_size_.clear();
+        mip_.clear();
+        if (!(size_ > 0).all()) {
+            return;
+        }
+
+        // Footprint radius and overshoot of sampling method.
+        int r = samp_ == 0 ? 0 : samp_ == 1 ? 1 : 2;
+        float_type overshoot =
+            samp_ == 3 ? float_type(1.125 * 1.125 * 1.125) : 1;
+
+        // Majorant grid.
+        multi<int, 3> size0 = (size_ + cell_size_ - 1) / cell_size_;
+        mip_size_.push_back(size0);
+        mip_.emplace_back(std::size_t(size0.prod()));
+        for (int i0 = 0; i0 < size0[0]; i0++)
+        for (int i1 = 0; i1 < size0[1]; i1++)
+        for (int i2 = 0; i2 < size0[2]; i2++) {
+            multi<int, 3> cell = {i0, i1, i2};
+            multi<int, 3> lo = cell * cell_size_ - r;
+            multi<int, 3> hi = (cell + 1) * cell_size_ + r;
+            float_type m = 0;
+            for (int j0 = lo[0]; j0 < hi[0]; j0++)
+            for (int j1 = lo[1]; j1 < hi[1]; j1++)
+            for (int j2 = lo[2]; j2 < hi[2]; j2++) {
+                multi<float_type, 3> loc = {
+                    j0 + float_type(0.5),
+                    j1 + float_type(0.5),
+                    j2 + float_type(0.5)
+                };
+                m = pre::fmax(m,
+                    pre::fabs(float_type(volume_->sample(0, loc)[0])));
+            }
+            mip_[0][mip_index_(0, cell)] = m * overshoot;
+        }
+
+        // Max mip.
+        while ((mip_size_.back() > 1).any()) {
+            int level = int(mip_size_.size());
+            multi<int, 3> prev_size = mip_size_.back();
+            multi<int, 3> next_size = (prev_size + 1) / 2;
+            mip_size_.push_back(next_size);
+            mip_.emplace_back(std::size_t(next_size.prod()));
+            for (int i0 = 0; i0 < prev_size[0]; i0++)
+            for (int i1 = 0; i1 < prev_size[1]; i1++)
+            for (int i2 = 0; i2 < prev_size[2]; i2++) {
+                multi<int, 3> cell = {i0, i1, i2};
+                float_type& m = mip_[level][mip_index_(level, cell / 2)];
+                m = pre::fmax(m, mip_[level - 1][mip_index_(level - 1, cell)]);
+            }
+        }
+    }
+
+    /**
+     * @brief Track along ray, calling `func(t, ratio)` at each
+     * tentative collision, where ratio is density over majorant,
+     * until `func` returns true or the ray exits.
+     */
+    template <typename Tgen, typename Tfunc>
+    void track_(
+            Tgen& gen,
+            const multi<float_type, 3>& loc,
+            const multi<float_type, 3>& dir,
+            float_type tmax,
+            Tfunc&& func) const
+    {
+        if (mip_.empty() || !(mu_ > 0)) {
+            return;
+        }
+
+        // Clip to volume.
+        float_type tmin = 0;
+        for (int k = 0; k < 3; k++) {
+            if (dir[k] == 0) {
+                if (!(loc[k] >= 0 && loc[k] <= float_type(size_[k]))) {
+                    return;
+                }
+            }
+            else {
+                float_type t0 = (0 - loc[k]) / dir[k];
+                float_type t1 = (float_type(size_[k]) - loc[k]) / dir[k];
+                if (t0 > t1) {
+                    std::swap(t0, t1);
+                }
+                tmin = pre::fmax(tmin, t0);
+                tmax = pre::fmin(tmax, t1);
+            }
+        }
+
+        float_type t = tmin;
+        while (t < tmax) {
+
+            // Locate level 0 cell, breaking ties in ray direction.
+            multi<float_type, 3> pos = loc + t * dir;
+            multi<int, 3> cell;
+            for (int k = 0; k < 3; k++) {
+                float_type u = pos[k] / cell_size_;
+                int i = int(pre::floor(u));
+                if (dir[k] < 0 && float_type(i) == u) {
+                    i--;
+                }
+                cell[k] = std::max(0, std::min(i, mip_size_[0][k] - 1));
+            }
+
+            // Climb to the largest empty cell, if any.
+            int level = 0;
+            float_type m = mip_[0][mip_index_(0, cell)];
+            if (m == 0) {
+                while (level + 1 < int(mip_.size()) &&
+                       mip_[level + 1][
+                       mip_index_(level + 1, cell >> (level + 1))] == 0) {
+                    level++;
+                }
+            }
+
+            // Exit cell.
+            float_type width = float_type(cell_size_ << level);
+            multi<int, 3> cell_level = cell >> level;
+            float_type t_exit = tmax;
+            for (int k = 0; k < 3; k++) {
+                if (dir[k] > 0) {
+                    t_exit = pre::fmin(t_exit,
+                        ((cell_level[k] + 1) * width - loc[k]) / dir[k]);
+                }
+                else if (dir[k] < 0) {
+                    t_exit = pre::fmin(t_exit,
+                        (cell_level[k] * width - loc[k]) / dir[k]);
+                }
+            }
+            if (!(t_exit > t)) {
+                // Round-off, step forward.
+                t_exit =
+                pre::fmin(tmax, std::nextafter(t, tmax));
+            }
+
+            // Empty?
+            if (m == 0) {
+                t = t_exit;
+                continue;
+            }
+
+            // Track against local majorant.
+            float_type mbar = m * mu_;
+            while (true) {
+                t -= pre::log1p(
+                    -pre::generate_canonical<float_type>(gen)) / mbar;
+                if (!(t < t_exit)) {
+                    t = t_exit;
+                    break;
+                }
+                float_type ratio = density(loc + t * dir) / m;
+                if (std::forward<Tfunc>(func)(t, ratio)) {
+                    return;
+                }
+            }
+        }
+    }
+
+#endif // #if !DOXYGEN
+};
+
 /**@}*/
 
 } // namespace pre
@@ -35,12 +35,27 @@
 #ifndef PREFORM_MEMORY_ARENA_HPP
 #define PREFORM_MEMORY_ARENA_HPP
 
+// for std::max, std::min, std::swap
+#include <algorithm>
+
+// for std::atomic
+#include <atomic>
+
+// for std::uint64_t
+#include <cstdint>
+
 // for std::allocator
 #include <memory>
 
+// for std::this_thread
+#include <thread>
+
 // for std::vector
 #include <vector>
 
+// for pre::allocator_stats
+#include <preform/allocator_stats.hpp>
+
 namespace pre {
 
 /**
@@ -61,6 +76,27 @@ namespace pre {
 template <typename Tbyte_alloc = std::allocator<char>>
 class memory_arena
 {
+public:
+
+    /**
+     * @brief Marker type.
+     *
+     * A marker records the allocation position at some point in time,
+     * so that `rewind()` can later release everything allocated since.
+     */
+    struct marker_type
+    {
+        /**
+         * @brief Number of full blocks.
+         */
+        std::size_t full_count = 0;
+
+        /**
+         * @brief Offset in current block.
+         */
+        std::size_t offset = 0;
+    };
+
 public:
 
     /**
@@ -83,6 +119,9 @@ public:
         block_.size = block_size_;
         block_.begin = byte_alloc_.allocate(block_.size);
         block_.offset = 0;
+        #if PREFORM_ALLOCATOR_STATS
+        stats_.reserve(block_.size);
+        #endif // #if PREFORM_ALLOCATOR_STATS
 
         // Reserve blocks.
         free_blocks_.reserve(4);
@@ -120,24 +159,40 @@ public:
      */
     void* allocate(std::size_t size)
     {
+        #if PREFORM_ALLOCATOR_STATS
+        std::size_t requested = size;
+        #endif // #if PREFORM_ALLOCATOR_STATS
+
         // Round up to 16 byte interval.
         size +=  15u;
         size &= ~15u;
         if (size == 0) {
             return nullptr;
         }
+        #if PREFORM_ALLOCATOR_STATS
+        stats_.request(requested, size);
+        #endif // #if PREFORM_ALLOCATOR_STATS
 
         if (block_.size < block_.offset + size) {
             full_blocks_.emplace_back(block_);
-            if (free_blocks_.size() == 0 ||
-                free_blocks_.back().size < size) {
+
+            // Find free block large enough.
+            std::size_t pos = free_blocks_.size();
+            while (pos > 0 && free_blocks_[pos - 1].size < size) {
+                pos--;
+            }
+            if (pos == 0) {
                 // Allocate block.
                 block_.size = std::max(block_size_, size);
                 block_.begin = byte_alloc_.allocate(block_.size);
                 block_.offset = 0;
+                #if PREFORM_ALLOCATOR_STATS
+                stats_.reserve(block_.size);
+                #endif // #if PREFORM_ALLOCATOR_STATS
             }
             else {
                 // Use free block.
+                std::swap(free_blocks_[pos - 1], free_blocks_.back());
                 block_ =
                 free_blocks_.back();
                 free_blocks_.pop_back();
@@ -151,11 +206,63 @@ public:
         return static_cast<void*>(pos);
     }
 
+    /**
+     * @brief Marker at current allocation position.
+     */
+    marker_type marker() const
+    {
+        marker_type m;
+        m.full_count = full_blocks_.size();
+        m.offset = block_.offset;
+        return m;
+    }
+
+    /**
+     * @brief Rewind to marker.
+     *
+     * Releases everything allocated since the marker, recycling any
+     * blocks filled in the meantime. Markers must be rewound in LIFO
+     * order, and `clear()` or `reset()` invalidates all markers.
+     */
+    void rewind(const marker_type& m)
+    {
+        #if PREFORM_ALLOCATOR_STATS
+        std::size_t released = block_.offset - m.offset;
+        for (std::size_t pos = m.full_count;
+                         pos < full_blocks_.size(); pos++) {
+            released += full_blocks_[pos].offset;
+        }
+        stats_.release(released);
+        #endif // #if PREFORM_ALLOCATOR_STATS
+
+        if (full_blocks_.size() > m.full_count) {
+            // Convert current block and full blocks past marker
+            // to free blocks.
+            free_blocks_.push_back(block_);
+            free_blocks_.back().offset = 0;
+            for (std::size_t pos = m.full_count + 1;
+                             pos < full_blocks_.size(); pos++) {
+                free_blocks_.push_back(full_blocks_[pos]);
+                free_blocks_.back().offset = 0;
+            }
+
+            // Restore block current at marker.
+            block_ = full_blocks_[m.full_count];
+            full_blocks_.resize(m.full_count);
+        }
+        block_.offset = m.offset;
+    }
+
     /**
      * @brief Clear memory arena.
      */
     void clear()
     {
+        #if PREFORM_ALLOCATOR_STATS
+        stats_.release_all();
+        stats_.reset();
+        #endif // #if PREFORM_ALLOCATOR_STATS
+
         // Clear current block.
         block_.offset = 0;
 
@@ -175,12 +282,20 @@ public:
      */
     void reset()
     {
+        #if PREFORM_ALLOCATOR_STATS
+        stats_.release_all();
+        stats_.reset();
+        #endif // #if PREFORM_ALLOCATOR_STATS
+
         // Clear current block.
         block_.offset = 0;
 
         // Deallocate free blocks.
         for (block& free_block : free_blocks_) {
             byte_alloc_.deallocate(free_block.begin, free_block.size);
+            #if PREFORM_ALLOCATOR_STATS
+            stats_.unreserve(free_block.size);
+            #endif // #if PREFORM_ALLOCATOR_STATS
         }
         free_blocks_.clear();
         free_blocks_.shrink_to_fit();
@@ -188,11 +303,29 @@ public:
         // Deallocate full blocks.
         for (block& full_block : full_blocks_) {
             byte_alloc_.deallocate(full_block.begin, full_block.size);
+            #if PREFORM_ALLOCATOR_STATS
+            stats_.unreserve(full_block.size);
+            #endif // #if PREFORM_ALLOCATOR_STATS
         }
         full_blocks_.clear();
         full_blocks_.shrink_to_fit();
     }
 
+#if PREFORM_ALLOCATOR_STATS || DOXYGEN
+
+    /**
+     * @brief Statistics.
+     *
+     * @note
+     * Only if `PREFORM_ALLOCATOR_STATS`.
+     */
+    allocator_stats stats() const
+    {
+        return stats_.snapshot();
+    }
+
+#endif // #if PREFORM_ALLOCATOR_STATS || DOXYGEN
+
 private:
 
     /**
@@ -240,6 +373,447 @@ private:
      * @brief Byte allocator.
      */
     Tbyte_alloc byte_alloc_;
+
+#if PREFORM_ALLOCATOR_STATS || DOXYGEN
+
+    /**
+     * @brief Statistics recorder.
+     */
+    allocator_stats_recorder stats_;
+
+#endif // #if PREFORM_ALLOCATOR_STATS || DOXYGEN
+};
+
+/**
+ * @brief Scoped memory arena.
+ *
+ * Guard that marks a memory arena on construction and rewinds it on
+ * destruction, releasing scratch allocations in LIFO order, e.g.,
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~{cpp}
+ * for (int bounce = 0; bounce < max_bounces; bounce++) {
+ *     pre::scoped_arena<> scratch(arena);
+ *     float* weights = new (scratch) float[count];
+ *     // ...
+ * }
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ *
+ * @tparam Tbyte_alloc
+ * Underlying byte allocator type.
+ */
+template <typename Tbyte_alloc = std::allocator<char>>
+class scoped_arena
+{
+public:
+
+    /**
+     * @brief Constructor.
+     */
+    explicit scoped_arena(memory_arena<Tbyte_alloc>& arena) :
+                arena_(arena),
+                marker_(arena.marker())
+    {
+    }
+
+    /**
+     * @brief Non-copyable.
+     */
+    scoped_arena(const scoped_arena&) = delete;
+
+    /**
+     * @brief Destructor.
+     */
+    ~scoped_arena()
+    {
+        arena_.rewind(marker_);
+    }
+
+public:
+
+    /**
+     * @brief Allocate bytes.
+     */
+    void* allocate(std::size_t size)
+    {
+        return arena_.allocate(size);
+    }
+
+    /**
+     * @brief Underlying memory arena.
+     */
+    memory_arena<Tbyte_alloc>& arena()
+    {
+        return arena_;
+    }
+
+private:
+
+    /**
+     * @brief Memory arena.
+     */
+    memory_arena<Tbyte_alloc>& arena_;
+
+    /**
+     * @brief Marker at construction.
+     */
+    typename memory_arena<Tbyte_alloc>::marker_type marker_;
+};
+
+/**
+ * @brief Concurrent memory arena.
+ *
+ * Each thread bump-allocates from its own block, so `allocate()` is
+ * safe to call from any number of threads at once without locking.
+ * Threads claim blocks recycled by `clear()` with a single atomic
+ * increment, and link newly allocated blocks into a lock-free list.
+ * Thus, after the first frame, a frame of allocation typically
+ * never touches the underlying byte allocator at all.
+ *
+ * @note
+ * Unlike `allocate()`, `clear()` and `reset()` require that no other
+ * thread is using the arena, as at the end of a frame.
+ *
+ * @note
+ * The underlying byte allocator must be thread-safe, since threads
+ * may call it concurrently when no recycled block is available.
+ *
+ * @tparam Tbyte_alloc
+ * Underlying byte allocator type.
+ */
+template <typename Tbyte_alloc = std::allocator<char>>
+class concurrent_memory_arena
+{
+public:
+
+    /**
+     * @brief Constructor.
+     */
+    concurrent_memory_arena(
+            std::size_t block_size = 0,
+            const Tbyte_alloc& byte_alloc = Tbyte_alloc()) :
+                block_size_(block_size),
+                byte_alloc_(byte_alloc),
+                id_(next_id()++)
+    {
+        // Round up to 256 byte interval.
+        block_size_ +=  255u;
+        block_size_ &= ~255u;
+        if (block_size_ == 0) {
+            block_size_ = 65536;
+        }
+    }
+
+    /**
+     * @brief Non-copyable.
+     */
+    concurrent_memory_arena(const concurrent_memory_arena&) = delete;
+
+    /**
+     * @brief Destructor.
+     */
+    ~concurrent_memory_arena()
+    {
+        reset();
+
+        // Deallocate thread slots.
+        slot* itr = slots_.load(std::memory_order_acquire);
+        while (itr) {
+            slot* next = itr->next;
+            itr->~slot();
+            byte_alloc_.deallocate(
+                    reinterpret_cast<char*>(itr),
+                    sizeof(slot));
+            itr = next;
+        }
+    }
+
+public:
+
+    /**
+     * @brief Allocate bytes.
+     *
+     * @note
+     * This is thread-safe.
+     */
+    void* allocate(std::size_t size)
+    {
+        // Round up to 16 byte interval.
+        size +=  15u;
+        size &= ~15u;
+        if (size == 0) {
+            return nullptr;
+        }
+
+        // Bump allocate from this thread's block.
+        slot& this_slot = find_slot();
+        if (std::size_t(this_slot.end - this_slot.pos) < size) {
+            if (size > block_size_ - sizeof(block)) {
+                // Allocate dedicated block, but keep current block.
+                return claim_block(size)->data();
+            }
+
+            // Claim new block.
+            block* new_block = claim_block(block_size_ - sizeof(block));
+            this_slot.pos = new_block->data();
+            this_slot.end = new_block->data() + new_block->capacity;
+        }
+        char* pos = this_slot.pos;
+        this_slot.pos += size;
+        return static_cast<void*>(pos);
+    }
+
+    /**
+     * @brief Clear memory arena, recycling every thread's blocks.
+     *
+     * @note
+     * This is _not_ thread-safe.
+     */
+    void clear()
+    {
+        // Forget thread blocks.
+        for (slot* itr = slots_.load(std::memory_order_acquire);
+                   itr; itr = itr->next) {
+            itr->pos = nullptr;
+            itr->end = nullptr;
+        }
+
+        // Recycle unclaimed blocks, then blocks in use. Dedicated
+        // blocks larger than the block size are deallocated, so that
+        // every recycled block is interchangeable.
+        std::vector<block*> blocks;
+        size_type free_index = free_index_.load(std::memory_order_relaxed);
+        for (size_type index = std::min(free_index, free_blocks_.size());
+                       index < free_blocks_.size(); index++) {
+            blocks.push_back(free_blocks_[index]);
+        }
+        block* itr = used_blocks_.exchange(nullptr, std::memory_order_acq_rel);
+        while (itr) {
+            block* next = itr->next;
+            if (itr->capacity == block_size_ - sizeof(block)) {
+                blocks.push_back(itr);
+            }
+            else {
+                deallocate_block(itr);
+            }
+            itr = next;
+        }
+        free_blocks_.swap(blocks);
+        free_index_.store(0, std::memory_order_release);
+    }
+
+    /**
+     * @brief Clear memory arena and free blocks.
+     *
+     * @note
+     * This is _not_ thread-safe.
+     */
+    void reset()
+    {
+        clear();
+        for (block* free_block : free_blocks_) {
+            deallocate_block(free_block);
+        }
+        free_blocks_.clear();
+        free_blocks_.shrink_to_fit();
+    }
+
+private:
+
+    /**
+     * @brief Size type.
+     */
+    typedef std::size_t size_type;
+
+    /**
+     * @brief Memory block header, followed by bytes.
+     */
+    struct alignas(16) block
+    {
+        /**
+         * @brief Next block in used list.
+         */
+        block* next;
+
+        /**
+         * @brief Capacity in bytes, not including header.
+         */
+        std::size_t capacity;
+
+        /**
+         * @brief Bytes.
+         */
+        char* data()
+        {
+            return reinterpret_cast<char*>(this) + sizeof(block);
+        }
+    };
+
+    /**
+     * @brief Thread slot.
+     */
+    struct slot
+    {
+        /**
+         * @brief Owner thread.
+         */
+        std::thread::id owner;
+
+        /**
+         * @brief Current block position.
+         */
+        char* pos = nullptr;
+
+        /**
+         * @brief Current block end.
+         */
+        char* end = nullptr;
+
+        /**
+         * @brief Next slot.
+         */
+        slot* next = nullptr;
+    };
+
+    /**
+     * @brief Thread-local slot cache entry.
+     */
+    struct slot_cache
+    {
+        /**
+         * @brief Arena identifier.
+         */
+        std::uint64_t id = 0;
+
+        /**
+         * @brief Slot.
+         */
+        slot* this_slot = nullptr;
+    };
+
+    /**
+     * @brief Next arena identifier.
+     *
+     * Identifiers are never reused, so a thread-local cache entry
+     * can never refer to a destroyed arena's slot.
+     */
+    static std::atomic<std::uint64_t>& next_id()
+    {
+        static std::atomic<std::uint64_t> id(1);
+        return id;
+    }
+
+    /**
+     * @brief Find or create this thread's slot.
+     */
+    slot& find_slot()
+    {
+        // Most recently used arena?
+        static thread_local slot_cache cache;
+        if (cache.id == id_) {
+            return *cache.this_slot;
+        }
+
+        // Search.
+        std::thread::id owner = std::this_thread::get_id();
+        slot* head = slots_.load(std::memory_order_acquire);
+        for (slot* itr = head; itr; itr = itr->next) {
+            if (itr->owner == owner) {
+                cache.id = id_;
+                cache.this_slot = itr;
+                return *itr;
+            }
+        }
+
+        // Create, and push onto slot list. This slot is the only one
+        // this thread can add, so the search need not be repeated.
+        slot* new_slot =
+            new (byte_alloc_.allocate(sizeof(slot))) slot();
+        new_slot->owner = owner;
+        new_slot->next = head;
+        while (!slots_.compare_exchange_weak(
+                    new_slot->next, new_slot,
+                    std::memory_order_release,
+                    std::memory_order_acquire)) {
+        }
+        cache.id = id_;
+        cache.this_slot = new_slot;
+        return *new_slot;
+    }
+
+    /**
+     * @brief Claim recycled block, or allocate new block.
+     */
+    block* claim_block(std::size_t capacity)
+    {
+        block* new_block = nullptr;
+        if (capacity == block_size_ - sizeof(block)) {
+            size_type index =
+                free_index_.fetch_add(1, std::memory_order_acq_rel);
+            if (index < free_blocks_.size()) {
+                new_block = free_blocks_[index];
+            }
+        }
+        if (!new_block) {
+            new_block = reinterpret_cast<block*>(
+                    byte_alloc_.allocate(sizeof(block) + capacity));
+            new_block->capacity = capacity;
+        }
+
+        // Push onto used list.
+        new_block->next = used_blocks_.load(std::memory_order_relaxed);
+        while (!used_blocks_.compare_exchange_weak(
+                    new_block->next, new_block,
+                    std::memory_order_release,
+                    std::memory_order_relaxed)) {
+        }
+        return new_block;
+    }
+
+    /**
+     * @brief Deallocate block.
+     */
+    void deallocate_block(block* old_block)
+    {
+        byte_alloc_.deallocate(
+                reinterpret_cast<char*>(old_block),
+                sizeof(block) + old_block->capacity);
+    }
+
+private:
+
+    /**
+     * @brief Block size, including header.
+     */
+    std::size_t block_size_;
+
+    /**
+     * @brief Byte allocator.
+     */
+    Tbyte_alloc byte_alloc_;
+
+    /**
+     * @brief Arena identifier.
+     */
+    std::uint64_t id_;
+
+    /**
+     * @brief Thread slots.
+     */
+    std::atomic<slot*> slots_ = {nullptr};
+
+    /**
+     * @brief Used blocks.
+     */
+    std::atomic<block*> used_blocks_ = {nullptr};
+
+    /**
+     * @brief Free blocks, recycled by last clear.
+     */
+    std::vector<block*> free_blocks_;
+
+    /**
+     * @brief Index of next free block to claim.
+     */
+    std::atomic<size_type> free_index_ = {0};
 };
 
 /**@}*/
@@ -266,6 +840,42 @@ inline void* operator new[](
     return arena.allocate(size);
 }
 
+// operator new
+template <typename Tbyte_alloc>
+inline void* operator new(
+                std::size_t size,
+                pre::concurrent_memory_arena<Tbyte_alloc>& arena)
+{
+    return arena.allocate(size);
+}
+
+// operator new[]
+template <typename Tbyte_alloc>
+inline void* operator new[](
+                std::size_t size,
+                pre::concurrent_memory_arena<Tbyte_alloc>& arena)
+{
+    return arena.allocate(size);
+}
+
+// operator new
+template <typename Tbyte_alloc>
+inline void* operator new(
+                std::size_t size,
+                pre::scoped_arena<Tbyte_alloc>& arena)
+{
+    return arena.allocate(size);
+}
+
+// operator new[]
+template <typename Tbyte_alloc>
+inline void* operator new[](
+                std::size_t size,
+                pre::scoped_arena<Tbyte_alloc>& arena)
+{
+    return arena.allocate(size);
+}
+
 #endif // #if !DOXYGEN
 
 #endif // #ifndef PREFORM_MEMORY_ARENA_HPP
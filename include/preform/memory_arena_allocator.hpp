@@ -35,7 +35,7 @@
 #ifndef PREFORM_MEMORY_ARENA_ALLOCATOR_HPP
 #define PREFORM_MEMORY_ARENA_ALLOCATOR_HPP
 
-// for pre::memory_arena
+// for pre::memory_arena, pre::concurrent_memory_arena
 #include <preform/memory_arena.hpp>
 
 namespace pre {
@@ -57,8 +57,17 @@ namespace pre {
  *
  * @tparam Tbyte_alloc
  * Underlying byte allocator type.
+ *
+ * @tparam Tarena
+ * Underlying memory arena type, either `memory_arena` or
+ * `concurrent_memory_arena`. With the latter, copies of the allocator
+ * may allocate from any number of threads at once.
  */
-template <typename T, typename Tbyte_alloc = std::allocator<char>>
+template <
+    typename T,
+    typename Tbyte_alloc = std::allocator<char>,
+    typename Tarena = memory_arena<Tbyte_alloc>
+    >
 class memory_arena_allocator
 {
 public:
@@ -99,7 +108,18 @@ public:
     memory_arena_allocator(
             std::size_t block_size = 0,
             const Tbyte_alloc& byte_alloc = Tbyte_alloc()) :
-            arena_(new memory_arena<Tbyte_alloc>(block_size, byte_alloc))
+            arena_(new Tarena(block_size, byte_alloc))
+    {
+    }
+
+    /**
+     * @brief Constructor.
+     *
+     * @param[in] arena
+     * Underlying memory arena, to share with other allocators.
+     */
+    explicit memory_arena_allocator(std::shared_ptr<Tarena> arena) :
+            arena_(std::move(arena))
     {
     }
 
@@ -108,7 +128,7 @@ public:
      */
     template <typename U>
     memory_arena_allocator(
-            const memory_arena_allocator<U, Tbyte_alloc>& other) :
+            const memory_arena_allocator<U, Tbyte_alloc, Tarena>& other) :
             arena_(other.arena_)
     {
     }
@@ -118,7 +138,7 @@ public:
      */
     template <typename U>
     memory_arena_allocator(
-            memory_arena_allocator<U, Tbyte_alloc>&& other) :
+            memory_arena_allocator<U, Tbyte_alloc, Tarena>&& other) :
             arena_(std::move(other.arena_))
     {
     }
@@ -128,7 +148,7 @@ public:
      */
     template <typename U>
     memory_arena_allocator& operator=(
-                    const memory_arena_allocator<U, Tbyte_alloc>& other)
+                    const memory_arena_allocator<U, Tbyte_alloc, Tarena>& other)
     {
         if (this != &other) {
             this->arena_ = other.arena_;
@@ -141,7 +161,7 @@ public:
      */
     template <typename U>
     memory_arena_allocator& operator=(
-                    memory_arena_allocator<U, Tbyte_alloc>&& other)
+                    memory_arena_allocator<U, Tbyte_alloc, Tarena>&& other)
     {
         this->arena_ = std::move(other.arena_);
         return *this;
@@ -196,7 +216,8 @@ public:
      * @brief Equal?
      */
     template <typename U>
-    bool operator==(const memory_arena_allocator<U, Tbyte_alloc>& other) const
+    bool operator==(
+            const memory_arena_allocator<U, Tbyte_alloc, Tarena>& other) const
     {
         return arena_.get() == other.arena_.get();
     }
@@ -205,7 +226,8 @@ public:
      * @brief Not equal?
      */
     template <typename U>
-    bool operator!=(const memory_arena_allocator<U, Tbyte_alloc>& other) const
+    bool operator!=(
+            const memory_arena_allocator<U, Tbyte_alloc, Tarena>& other) const
     {
         return arena_.get() != other.arena_.get();
     }
@@ -215,13 +237,21 @@ private:
     /**
      * @brief Memory arena.
      */
-    std::shared_ptr<memory_arena<Tbyte_alloc>> arena_;
+    std::shared_ptr<Tarena> arena_;
 
     // Declare friend.
-    template <typename, typename>
+    template <typename, typename, typename>
     friend class memory_arena_allocator;
 };
 
+/**
+ * @brief Concurrent memory arena allocator.
+ */
+template <typename T, typename Tbyte_alloc = std::allocator<char>>
+using concurrent_memory_arena_allocator =
+      memory_arena_allocator<T, Tbyte_alloc,
+                             concurrent_memory_arena<Tbyte_alloc>>;
+
 /**@}*/
 
 } // namespace pre
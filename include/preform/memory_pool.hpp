@@ -35,15 +35,33 @@
 #ifndef PREFORM_MEMORY_POOL_HPP
 #define PREFORM_MEMORY_POOL_HPP
 
+// for std::min
+#include <algorithm>
+
+// for std::atomic
+#include <atomic>
+
 // for std::size_t
 #include <cstddef>
 
+// for std::uint32_t, std::uint64_t
+#include <cstdint>
+
 // for std::memcpy
 #include <cstring>
 
 // for std::allocator
 #include <memory>
 
+// for std::logic_error, std::length_error
+#include <stdexcept>
+
+// for std::this_thread
+#include <thread>
+
+// for pre::allocator_stats
+#include <preform/allocator_stats.hpp>
+
 namespace pre {
 
 /**
@@ -91,6 +109,16 @@ private:
          */
         byte_type* first_free;
 
+        /**
+         * @brief Pointer to most recently deallocated free element,
+         * or `nullptr`.
+         *
+         * Insertion into the sorted free element list starts here
+         * when possible, so deallocating in ascending address order
+         * does not rescan the list.
+         */
+        byte_type* last_free;
+
     };
 
     /**
@@ -147,10 +175,14 @@ public:
      */
     void* allocate()
     {
-        pool_type* pool = head_;
-        while (pool && 
-               pool->first_free == nullptr) {
-            pool = pool->next;
+        pool_type* pool = hint_;
+        if (!(pool &&
+              pool->first_free)) {
+            pool = head_;
+            while (pool &&
+                   pool->first_free == nullptr) {
+                pool = pool->next;
+            }
         }
 
         // Pool with free element not found?
@@ -165,7 +197,16 @@ public:
         std::memcpy(
                 &pool->first_free, 
                  pool->first_free, sizeof(void*));
+        if (pool->last_free == elem) {
+            pool->last_free = nullptr;
+        }
 
+        // Remember pool.
+        hint_ = pool;
+
+        #if PREFORM_ALLOCATOR_STATS
+        stats_.request(elem_size_, elem_size_);
+        #endif // #if PREFORM_ALLOCATOR_STATS
         return static_cast<void*>(elem);
     }
 
@@ -275,10 +316,15 @@ public:
         }
 
         byte_type* elem = static_cast<byte_type*>(ptr);
+        std::ptrdiff_t pool_size = elem_size_ * elems_per_pool_;
         pool_type* pool = head_;
+        if (hint_ &&
+            elem - hint_->begin >= 0 &&
+            elem - hint_->begin < pool_size) {
+            pool = hint_; // Check remembered pool first.
+        }
         while (pool) {
             // Element in range of pool?
-            std::ptrdiff_t pool_size = elem_size_ * elems_per_pool_;
             std::ptrdiff_t elem_diff = elem - pool->begin;
             if (elem_diff >= 0 && elem_diff < pool_size) {
 
@@ -315,8 +361,13 @@ public:
         }
         else {
 
-            // Find insertion.
+            // Find insertion, starting from most recently
+            // deallocated element if possible.
             byte_type* free_elem = pool->first_free;
+            if (pool->last_free &&
+                pool->last_free < elem) {
+                free_elem = pool->last_free;
+            }
             byte_type* free_elem_next = nullptr;
             while (1) {
                 std::memcpy(&free_elem_next, free_elem, sizeof(void*));
@@ -331,6 +382,13 @@ public:
             std::memcpy(free_elem, &elem, sizeof(void*));
             std::memcpy(elem, &free_elem_next, sizeof(void*));
         }
+
+        // Remember element and pool.
+        pool->last_free = elem;
+        hint_ = pool;
+        #if PREFORM_ALLOCATOR_STATS
+        stats_.release(elem_size_);
+        #endif // #if PREFORM_ALLOCATOR_STATS
     }
 
     /**
@@ -365,6 +423,11 @@ public:
      */
     void clear()
     {
+        #if PREFORM_ALLOCATOR_STATS
+        stats_.release_all();
+        stats_.reset();
+        #endif // #if PREFORM_ALLOCATOR_STATS
+
         // Loop through all pools.
         for (pool_type* pool = head_; pool; pool = pool->next) {
 
@@ -378,19 +441,43 @@ public:
      */
     void reset()
     {
+        #if PREFORM_ALLOCATOR_STATS
+        stats_.release_all();
+        stats_.reset();
+        #endif // #if PREFORM_ALLOCATOR_STATS
+
         for (pool_type* pool = head_; pool;) {
 
             // Deallocate.
             pool_type* next = pool->next;
             byte_alloc_.deallocate(pool->begin, elem_size_ * elems_per_pool_);
             pool_alloc_.deallocate(pool, 1);
+            #if PREFORM_ALLOCATOR_STATS
+            stats_.unreserve(elem_size_ * elems_per_pool_);
+            #endif // #if PREFORM_ALLOCATOR_STATS
             pool = next; // Increment.
         }
 
         // Nullify.
         head_ = nullptr;
+        hint_ = nullptr;
     }
 
+#if PREFORM_ALLOCATOR_STATS || DOXYGEN
+
+    /**
+     * @brief Statistics.
+     *
+     * @note
+     * Only if `PREFORM_ALLOCATOR_STATS`.
+     */
+    allocator_stats stats() const
+    {
+        return stats_.snapshot();
+    }
+
+#endif // #if PREFORM_ALLOCATOR_STATS || DOXYGEN
+
 private:
 
     /**
@@ -408,6 +495,11 @@ private:
      */
     pool_type* head_ = nullptr;
 
+    /**
+     * @brief Most recently used pool, or `nullptr`.
+     */
+    pool_type* hint_ = nullptr;
+
     /**
      * @brief Byte allocator.
      */
@@ -418,6 +510,15 @@ private:
      */
     pool_allocator pool_alloc_;
 
+#if PREFORM_ALLOCATOR_STATS || DOXYGEN
+
+    /**
+     * @brief Statistics recorder.
+     */
+    allocator_stats_recorder stats_;
+
+#endif // #if PREFORM_ALLOCATOR_STATS || DOXYGEN
+
 #if !DOXYGEN 
 private:
 
@@ -432,6 +533,9 @@ private:
         // Allocate pool memory.
         pool->begin = 
         byte_alloc_.allocate(elem_size_ * elems_per_pool_);
+        #if PREFORM_ALLOCATOR_STATS
+        stats_.reserve(elem_size_ * elems_per_pool_);
+        #endif // #if PREFORM_ALLOCATOR_STATS
 
         // Clear.
         clear_pool_(pool);
@@ -456,6 +560,7 @@ private:
     {
         // Link all elements sequentially.
         pool->first_free = pool->begin;
+        pool->last_free = nullptr;
         for (std::size_t index = 0;
                          index + 1 < elems_per_pool_; index++) {
 
@@ -472,6 +577,521 @@ private:
 #endif // #if !DOXYGEN
 };
 
+/**
+ * @brief Concurrent memory pool.
+ *
+ * Thread-safe counterpart to `memory_pool`. Each thread allocates
+ * from and deallocates to its own cache of free elements, without
+ * synchronization. A thread exchanges whole batches of free elements
+ * with a lock-free global free list only when its cache runs empty
+ * or overflows. The global free list tags its head with a counter
+ * to protect against ABA, and names elements by 32-bit index so
+ * that index and tag fit in one lock-free 64-bit atomic.
+ *
+ * Unlike `memory_pool`, pools double in size, so that an element
+ * index maps to its pool in constant time. The first pool has
+ * `elems_per_pool` elements.
+ *
+ * @note
+ * Unlike `allocate()` and `deallocate()`, `clear()` and `reset()`
+ * require that no other thread is using the pool.
+ *
+ * @note
+ * Free elements cached by a thread that exits are not reused
+ * until `clear()`.
+ *
+ * @tparam Talloc
+ * Internal allocator type, which must be thread-safe.
+ */
+template <typename Talloc = std::allocator<char>>
+class concurrent_memory_pool
+{
+private:
+
+    /**
+     * @brief Byte type.
+     */
+    typedef char byte_type;
+
+    /**
+     * @brief Byte allocator type.
+     */
+    typedef typename std::allocator_traits<Talloc>::
+            template rebind_alloc<byte_type> byte_allocator;
+
+    /**
+     * @brief Thread slot, holding thread's cache of free elements.
+     */
+    struct slot_type {
+
+        /**
+         * @brief Owner thread.
+         */
+        std::thread::id owner;
+
+        /**
+         * @brief Pointer to first free element, or `nullptr`.
+         */
+        byte_type* first_free = nullptr;
+
+        /**
+         * @brief Free element count.
+         */
+        std::size_t free_count = 0;
+
+        /**
+         * @brief Pointer to next slot.
+         */
+        slot_type* next = nullptr;
+    };
+
+    /**
+     * @brief Slot allocator type.
+     */
+    typedef typename std::allocator_traits<Talloc>::
+            template rebind_alloc<slot_type> slot_allocator;
+
+    /**
+     * @brief Maximum pool count.
+     */
+    static constexpr std::size_t max_pools = 32;
+
+public:
+
+    /**
+     * @brief Constructor.
+     *
+     * @param[in] elem_size
+     * Element size in bytes, at least two pointers.
+     *
+     * @param[in] elems_per_pool
+     * Elements in first pool.
+     *
+     * @param[in] elems_per_batch
+     * Elements per batch exchanged with the global free list.
+     */
+    concurrent_memory_pool(
+            std::size_t elem_size,
+            std::size_t elems_per_pool,
+            std::size_t elems_per_batch = 64,
+            const Talloc& alloc = Talloc()) :
+                elem_size_(elem_size),
+                elems_per_pool_(elems_per_pool),
+                elems_per_batch_(elems_per_batch),
+                byte_alloc_(alloc),
+                slot_alloc_(alloc),
+                id_(next_id_()++)
+    {
+        // Room for element link and batch link, aligned for both.
+        if (elem_size_ < 2 * sizeof(void*)) {
+            elem_size_ = 2 * sizeof(void*);
+        }
+        elem_size_ = (elem_size_ + sizeof(void*) - 1) /
+                     sizeof(void*) * sizeof(void*);
+        if (elems_per_pool_ < 1) {
+            elems_per_pool_ = 1;
+        }
+        if (elems_per_batch_ < 1) {
+            elems_per_batch_ = 1;
+        }
+
+        // Indexes must fit in 32 bits.
+        if (std::uint64_t(elems_per_pool_) > 0xFFFFFFFEu) {
+            throw std::length_error(__PRETTY_FUNCTION__);
+        }
+        for (std::size_t pool_index = 0;
+                         pool_index < max_pools; pool_index++) {
+            std::uint64_t pool_end = pool_begin_(pool_index + 1);
+            if (pool_end > 0xFFFFFFFEu) {
+                break;
+            }
+            elem_capacity_ = pool_end;
+        }
+        if (elem_capacity_ == 0) {
+            elem_capacity_ = elems_per_pool_;
+        }
+        for (std::atomic<byte_type*>& pool : pools_) {
+            pool.store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Non-copyable.
+     */
+    concurrent_memory_pool(const concurrent_memory_pool&) = delete;
+
+    /**
+     * @brief Destructor.
+     */
+    ~concurrent_memory_pool()
+    {
+        reset();
+
+        // Deallocate thread slots.
+        slot_type* slot = slots_.load(std::memory_order_acquire);
+        while (slot) {
+            slot_type* next = slot->next;
+            slot->~slot_type();
+            slot_alloc_.deallocate(slot, 1);
+            slot = next;
+        }
+    }
+
+public:
+
+    /**
+     * @brief Allocate element.
+     *
+     * @note
+     * This is thread-safe.
+     *
+     * @throw std::length_error
+     * If all 32-bit element indexes are in use.
+     */
+    void* allocate()
+    {
+        slot_type& slot = find_slot_();
+        if (slot.first_free == nullptr) {
+            refill_(slot);
+        }
+
+        // First free element.
+        byte_type* elem = slot.first_free;
+
+        // Increment.
+        std::memcpy(&slot.first_free, elem, sizeof(void*));
+        slot.free_count--;
+        return static_cast<void*>(elem);
+    }
+
+    /**
+     * @brief Deallocate element.
+     *
+     * @param[in] ptr
+     * Pointer.
+     *
+     * @note
+     * This is thread-safe. The element may be deallocated by a
+     * thread other than the one that allocated it.
+     *
+     * @note
+     * If `ptr == nullptr`, implementation is a no-op. Otherwise `ptr`
+     * must be a pointer returned by `allocate()`, as validating it
+     * would defeat the purpose.
+     */
+    void deallocate(void* ptr)
+    {
+        if (ptr == nullptr) {
+            return;
+        }
+
+        // Prepend.
+        slot_type& slot = find_slot_();
+        byte_type* elem = static_cast<byte_type*>(ptr);
+        std::memcpy(elem, &slot.first_free, sizeof(void*));
+        slot.first_free = elem;
+        slot.free_count++;
+
+        // Overflow?
+        if (slot.free_count >= 2 * elems_per_batch_) {
+            flush_(slot);
+        }
+    }
+
+    /**
+     * @brief Clear, so that every element is free.
+     *
+     * @note
+     * This is _not_ thread-safe.
+     */
+    void clear()
+    {
+        for (slot_type* slot = slots_.load(std::memory_order_acquire);
+                        slot; slot = slot->next) {
+            slot->first_free = nullptr;
+            slot->free_count = 0;
+        }
+
+        // Keep tag, so that no stale head compares equal.
+        std::uint64_t head = head_.load(std::memory_order_relaxed);
+        head_.store(head & ~std::uint64_t(0xFFFFFFFFu),
+                    std::memory_order_relaxed);
+        next_fresh_.store(0, std::memory_order_release);
+    }
+
+    /**
+     * @brief Reset.
+     *
+     * @note
+     * This is _not_ thread-safe.
+     */
+    void reset()
+    {
+        clear();
+        for (std::size_t pool_index = 0;
+                         pool_index < max_pools; pool_index++) {
+            byte_type* pool = pools_[pool_index].exchange(nullptr);
+            if (pool) {
+                byte_alloc_.deallocate(pool,
+                    elem_size_ * elems_per_pool_ << pool_index);
+            }
+        }
+    }
+
+private:
+
+    /**
+     * @brief Element size in bytes.
+     */
+    std::size_t elem_size_ = 0;
+
+    /**
+     * @brief Elements in first pool.
+     */
+    std::size_t elems_per_pool_ = 0;
+
+    /**
+     * @brief Elements per batch.
+     */
+    std::size_t elems_per_batch_ = 0;
+
+    /**
+     * @brief Element capacity, less than @f$ 2^{32} - 1 @f$.
+     */
+    std::uint64_t elem_capacity_ = 0;
+
+    /**
+     * @brief Pools, where pool @f$ k @f$ holds
+     * @f$ 2^k @f$ times as many elements as the first.
+     */
+    std::atomic<byte_type*> pools_[max_pools];
+
+    /**
+     * @brief Global free list head.
+     *
+     * The low 32 bits are the index of the first batch plus 1, or 0
+     * if empty, and the high 32 bits are the ABA tag.
+     */
+    std::atomic<std::uint64_t> head_ = {0};
+
+    /**
+     * @brief Index of next never-allocated element.
+     */
+    std::atomic<std::uint64_t> next_fresh_ = {0};
+
+    /**
+     * @brief Thread slots.
+     */
+    std::atomic<slot_type*> slots_ = {nullptr};
+
+    /**
+     * @brief Byte allocator.
+     */
+    byte_allocator byte_alloc_;
+
+    /**
+     * @brief Slot allocator.
+     */
+    slot_allocator slot_alloc_;
+
+    /**
+     * @brief Pool identifier.
+     */
+    std::uint64_t id_ = 0;
+
+#if !DOXYGEN
+private:
+
+    // Next pool identifier, never reused.
+    static std::atomic<std::uint64_t>& next_id_()
+    {
+        static std::atomic<std::uint64_t> id(1);
+        return id;
+    }
+
+    // Index of first element in pool.
+    std::uint64_t pool_begin_(std::size_t pool_index) const
+    {
+        return std::uint64_t(elems_per_pool_) *
+                ((std::uint64_t(1) << pool_index) - 1);
+    }
+
+    // Pool index of element index.
+    std::size_t pool_index_(std::uint64_t index) const
+    {
+        std::uint64_t quot = index / elems_per_pool_ + 1;
+        std::size_t pool_index = 0;
+        while (quot >>= 1) {
+            pool_index++;
+        }
+        return pool_index;
+    }
+
+    // Element pointer from index.
+    byte_type* elem_(std::uint64_t index) const
+    {
+        std::size_t pool_index = pool_index_(index);
+        return pools_[pool_index].load(std::memory_order_acquire) +
+               (index - pool_begin_(pool_index)) * elem_size_;
+    }
+
+    // Element index from pointer.
+    std::uint64_t index_(byte_type* elem) const
+    {
+        for (std::size_t pool_index = 0;
+                         pool_index < max_pools; pool_index++) {
+            byte_type* pool =
+                pools_[pool_index].load(std::memory_order_acquire);
+            std::size_t pool_size =
+                elem_size_ * elems_per_pool_ << pool_index;
+            if (pool &&
+                elem >= pool &&
+                elem <  pool + pool_size) {
+                return pool_begin_(pool_index) +
+                       std::size_t(elem - pool) / elem_size_;
+            }
+        }
+
+        // User passed a garbage pointer.
+        throw std::logic_error(__PRETTY_FUNCTION__);
+    }
+
+    // Find or create this thread's slot.
+    slot_type& find_slot_()
+    {
+        // Recently used pool? The cache is direct-mapped by
+        // identifier, so that several pools created together, as
+        // for size classes, do not evict each other.
+        static thread_local std::uint64_t cache_ids[32] = {};
+        static thread_local slot_type* cache_slots[32] = {};
+        std::uint64_t& cache_id = cache_ids[id_ & 31];
+        slot_type*& cache_slot = cache_slots[id_ & 31];
+        if (cache_id == id_) {
+            return *cache_slot;
+        }
+
+        // Search.
+        std::thread::id owner = std::this_thread::get_id();
+        slot_type* head = slots_.load(std::memory_order_acquire);
+        for (slot_type* slot = head; slot; slot = slot->next) {
+            if (slot->owner == owner) {
+                cache_id = id_;
+                cache_slot = slot;
+                return *slot;
+            }
+        }
+
+        // Create, and push onto slot list.
+        slot_type* slot = new (slot_alloc_.allocate(1)) slot_type();
+        slot->owner = owner;
+        slot->next = head;
+        while (!slots_.compare_exchange_weak(
+                    slot->next, slot,
+                    std::memory_order_release,
+                    std::memory_order_acquire)) {
+        }
+        cache_id = id_;
+        cache_slot = slot;
+        return *slot;
+    }
+
+    // Refill empty slot from global free list, or from fresh elements.
+    void refill_(slot_type& slot)
+    {
+        // Pop batch.
+        std::uint64_t head = head_.load(std::memory_order_acquire);
+        while (head & 0xFFFFFFFFu) {
+            byte_type* elem = elem_((head & 0xFFFFFFFFu) - 1);
+
+            // Read batch link. If the batch was popped concurrently,
+            // this may read garbage, but then the tag differs and the
+            // exchange fails.
+            std::uint32_t next;
+            std::memcpy(&next, elem + sizeof(void*), sizeof(next));
+            std::uint64_t tag = (head >> 32) + 1;
+            if (head_.compare_exchange_weak(
+                        head, (tag << 32) | next,
+                        std::memory_order_acquire,
+                        std::memory_order_acquire)) {
+                slot.first_free = elem;
+                slot.free_count = elems_per_batch_;
+                return;
+            }
+        }
+
+        // Claim fresh elements.
+        std::uint64_t index =
+            next_fresh_.fetch_add(elems_per_batch_,
+                                  std::memory_order_relaxed);
+        if (index >= elem_capacity_) {
+            throw std::length_error(__PRETTY_FUNCTION__);
+        }
+        std::uint64_t index_end =
+            std::min<std::uint64_t>(index + elems_per_batch_,
+                                    elem_capacity_);
+
+        // Allocate pools as necessary.
+        for (std::size_t pool_index = pool_index_(index);
+                         pool_index <= pool_index_(index_end - 1);
+                         pool_index++) {
+            if (pools_[pool_index].load(std::memory_order_acquire)) {
+                continue;
+            }
+            std::size_t pool_size =
+                elem_size_ * elems_per_pool_ << pool_index;
+            byte_type* pool = byte_alloc_.allocate(pool_size);
+            byte_type* expected = nullptr;
+            if (!pools_[pool_index].compare_exchange_strong(
+                        expected, pool,
+                        std::memory_order_acq_rel)) {
+                byte_alloc_.deallocate(pool, pool_size);
+            }
+        }
+
+        // Link elements sequentially.
+        byte_type* elem1 = nullptr;
+        for (std::uint64_t curr = index_end; curr-- > index;) {
+            byte_type* elem0 = elem_(curr);
+            std::memcpy(elem0, &elem1, sizeof(void*));
+            elem1 = elem0;
+        }
+        slot.first_free = elem1;
+        slot.free_count = std::size_t(index_end - index);
+    }
+
+    // Flush batch from overflowing slot to global free list.
+    void flush_(slot_type& slot)
+    {
+        // Cut batch.
+        byte_type* first = slot.first_free;
+        byte_type* last = first;
+        for (std::size_t count = 1; count < elems_per_batch_; count++) {
+            std::memcpy(&last, last, sizeof(void*));
+        }
+        std::memcpy(&slot.first_free, last, sizeof(void*));
+        slot.free_count -= elems_per_batch_;
+        byte_type* null = nullptr;
+        std::memcpy(last, &null, sizeof(void*));
+
+        // Push batch.
+        std::uint64_t index = index_(first);
+        std::uint64_t head = head_.load(std::memory_order_relaxed);
+        while (true) {
+            std::uint32_t next = std::uint32_t(head & 0xFFFFFFFFu);
+            std::memcpy(first + sizeof(void*), &next, sizeof(next));
+            std::uint64_t tag = (head >> 32) + 1;
+            if (head_.compare_exchange_weak(
+                        head, (tag << 32) | (index + 1),
+                        std::memory_order_release,
+                        std::memory_order_relaxed)) {
+                break;
+            }
+        }
+    }
+
+#endif // #if !DOXYGEN
+};
+
 /**@}*/
 
 } // namespace pre
@@ -0,0 +1,569 @@
+/* Copyright (c) 2018-20 M. Grady Saunders
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer.
+ *
+ *   2. Redistributions in binary form must reproduce the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer in the documentation and/or other materials
+ *      provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*+-+*/
+#if !DOXYGEN
+#if !(__cplusplus >= 201703L)
+#error "preform/microsurface_table.hpp requires >=C++17"
+#endif // #if !(__cplusplus >= 201703L)
+#endif // #if !DOXYGEN
+#pragma once
+#ifndef PREFORM_MICROSURFACE_TABLE_HPP
+#define PREFORM_MICROSURFACE_TABLE_HPP
+
+// for std::int32_t, std::uint32_t
+#include <cstdint>
+
+// for std::memcmp
+#include <cstring>
+
+// for std::istream, std::ostream
+#include <iostream>
+
+// for std::invalid_argument, std::runtime_error
+#include <stdexcept>
+
+// for std::vector
+#include <vector>
+
+// for pre::multi
+#include <preform/multi.hpp>
+
+// for pre::multi wrappers
+#include <preform/multi_math.hpp>
+
+// for pre::microsurface_dielectric_bsdf, ...
+#include <preform/microsurface.hpp>
+
+namespace pre {
+
+/**
+ * @defgroup microsurface_table Microsurface table
+ *
+ * `<preform/microsurface_table.hpp>`
+ *
+ * __C++ version__: >=C++17
+ */
+/**@{*/
+
+/**
+ * @brief Tabulated microsurface BSDF.
+ *
+ * Random-walk evaluation of the multiple-scattering BSDF is exact
+ * but noisy, and costs a full walk per query. This class bakes the
+ * walk offline into a table over outgoing cosine, incident cosine,
+ * relative azimuth, roughness, and a material parameter, such that
+ * it may be evaluated in constant time with multilinear interpolation.
+ *
+ * By default, only scattering orders @f$ k \ge 2 @f$ are tabulated.
+ * The single-scattering term has sharp features that a table of
+ * reasonable size blurs, but it is analytic and cheap, so the full
+ * BSDF is best evaluated as `surf.fs1(wo, wi) + table.fs(wo, wi, ...)`.
+ *
+ * The table assumes isotropic roughness, so that it depends on
+ * the incident direction only through the relative azimuth. It stores
+ * @f$ f_s |\omega_{i_z}| @f$, which is smooth where @f$ f_s @f$ is
+ * not, at cell-centered cosine nodes, which avoid the horizon.
+ *
+ * @tparam Tfloat
+ * Float type.
+ */
+template <typename Tfloat>
+class microsurface_table
+{
+public:
+
+    // Sanity check.
+    static_assert(
+        std::is_floating_point<Tfloat>::value,
+        "Tfloat must be floating point");
+
+    /**
+     * @brief Float type.
+     */
+    typedef Tfloat float_type;
+
+    /**
+     * @brief Size type.
+     */
+    typedef std::size_t size_type;
+
+    /**
+     * @brief Sizes type, ordered as roughness, material parameter,
+     * outgoing cosine, incident cosine, and relative azimuth.
+     */
+    typedef multi<int, 5> sizes_type;
+
+public:
+
+    /**
+     * @brief Default constructor.
+     */
+    microsurface_table() = default;
+
+public:
+
+    /**
+     * @brief Initialize.
+     *
+     * @param[inout] gen
+     * Generator.
+     *
+     * @param[in] func
+     * Function mapping roughness and material parameter to a
+     * microsurface, e.g., a dielectric BSDF with isotropic roughness
+     * and refractive index, or a conductive BRDF with isotropic
+     * roughness and some parameterization of its complex refractive
+     * index.
+     *
+     * @param[in] sizes
+     * Sizes, each in @f$ [1, 4096] @f$, with at least 2 azimuth nodes
+     * and at most @f$ 2^{28} @f$ nodes in total. Cosine sizes should
+     * be even, so that no node lies on the horizon.
+     *
+     * @param[in] alpha_range
+     * Roughness range.
+     *
+     * @param[in] eta_range
+     * Material parameter range.
+     *
+     * @param[in] num_samples
+     * Number of random walks per node.
+     *
+     * @param[in] kmin
+     * Scattering order minimum.
+     *
+     * @throw std::invalid_argument
+     * If sizes or number of samples invalid.
+     */
+    template <typename Tgen, typename Tfunc>
+    void init(
+            Tgen& gen,
+            Tfunc&& func,
+            const sizes_type& sizes,
+            const multi<float_type, 2>& alpha_range,
+            const multi<float_type, 2>& eta_range,
+            int num_samples = 64,
+            unsigned kmin = 2)
+    {
+        if (!(valid_(sizes) && num_samples >= 1)) {
+            throw std::invalid_argument(__PRETTY_FUNCTION__);
+        }
+        sizes_ = sizes;
+        alpha_range_ = alpha_range;
+        eta_range_ = eta_range;
+        kmin_ = kmin;
+        values_.clear();
+        values_.reserve(count_(sizes));
+        for (int ia = 0; ia < sizes_[0]; ia++)
+        for (int ie = 0; ie < sizes_[1]; ie++) {
+            auto surf =
+                func(
+                    node_(alpha_range_, sizes_[0], ia),
+                    node_(eta_range_, sizes_[1], ie));
+            for (int io = 0; io < sizes_[2]; io++)
+            for (int ii = 0; ii < sizes_[3]; ii++)
+            for (int ip = 0; ip < sizes_[4]; ip++) {
+                float_type cos_thetao = cos_node_(sizes_[2], io);
+                float_type cos_thetai = cos_node_(sizes_[3], ii);
+                float_type sin_thetao = pre::sqrt(1 - cos_thetao * cos_thetao);
+                float_type sin_thetai = pre::sqrt(1 - cos_thetai * cos_thetai);
+                float_type phi =
+                    ip * numeric_constants<float_type>::M_pi() /
+                    (sizes_[4] - 1);
+                multi<float_type, 3> wo = {
+                    sin_thetao, 0, cos_thetao
+                };
+                multi<float_type, 3> wi = {
+                    sin_thetai * pre::cos(phi),
+                    sin_thetai * pre::sin(phi),
+                    cos_thetai
+                };
+                double sum = 0;
+                for (int k = 0; k < num_samples; k++) {
+                    float_type fs = surf.fs(gen, wo, wi, kmin_, 0);
+                    if (pre::isfinite(fs)) {
+                        sum += double(fs);
+                    }
+                }
+                values_.push_back(
+                    float(sum / num_samples * pre::abs(cos_thetai)));
+            }
+        }
+    }
+
+    /**
+     * @brief Clear.
+     */
+    void clear()
+    {
+        sizes_ = {};
+        values_.clear();
+    }
+
+public:
+
+    /**
+     * @brief Tabulated BSDF.
+     *
+     * @param[in] wo
+     * Outgoing direction, normalized.
+     *
+     * @param[in] wi
+     * Incident direction, normalized.
+     *
+     * @param[in] alpha
+     * Roughness, clamped to table range.
+     *
+     * @param[in] eta
+     * Material parameter, clamped to table range.
+     *
+     * @note
+     * Returns zero if the table is empty.
+     */
+    float_type fs(
+            const multi<float_type, 3>& wo,
+            const multi<float_type, 3>& wi,
+            float_type alpha,
+            float_type eta) const
+    {
+        if (values_.empty()) {
+            return 0;
+        }
+
+        // Relative azimuth.
+        float_type phi =
+            pre::abs(pre::atan2(
+                wo[0] * wi[1] - wo[1] * wi[0],
+                wo[0] * wi[0] + wo[1] * wi[1]));
+
+        // Fractional indices.
+        multi<float_type, 5> u = {
+            coord_(alpha_range_, sizes_[0], alpha),
+            coord_(eta_range_, sizes_[1], eta),
+            cos_coord_(sizes_[2], wo[2]),
+            cos_coord_(sizes_[3], wi[2]),
+            phi / numeric_constants<float_type>::M_pi() * (sizes_[4] - 1)
+        };
+        multi<int, 5> i0;
+        multi<int, 5> i1;
+        multi<float_type, 5> t;
+        for (int j = 0; j < 5; j++) {
+            float_type umin = 0;
+            float_type umax = sizes_[j] - 1;
+            if ((j == 2 || j == 3) && sizes_[j] % 2 == 0) {
+                // Don't interpolate across the horizon.
+                if ((j == 2 ? wo[2] : wi[2]) < 0) {
+                    umax = sizes_[j] / 2 - 1;
+                }
+                else {
+                    umin = sizes_[j] / 2;
+                }
+            }
+            u[j] = pre::fmax(u[j], umin);
+            u[j] = pre::fmin(u[j], umax);
+            i0[j] = int(u[j]);
+            i1[j] = std::min(i0[j] + 1, sizes_[j] - 1);
+            t[j] = u[j] - i0[j];
+        }
+
+        // Interpolate.
+        float_type value = 0;
+        for (int corner = 0; corner < 32; corner++) {
+            float_type weight = 1;
+            size_type index = 0;
+            for (int j = 0; j < 5; j++) {
+                bool hi = (corner >> j) & 1;
+                weight *= hi ? t[j] : 1 - t[j];
+                index = index * size_type(sizes_[j]) + (hi ? i1[j] : i0[j]);
+            }
+            if (weight > 0) {
+                value += weight * float_type(values_[index]);
+            }
+        }
+        return value / pre::fmax(pre::abs(wi[2]), float_type(1) / sizes_[3]);
+    }
+
+public:
+
+    /**
+     * @name Accessors
+     */
+    /**@{*/
+
+    /**
+     * @brief Sizes.
+     */
+    const sizes_type& sizes() const
+    {
+        return sizes_;
+    }
+
+    /**
+     * @brief Roughness range.
+     */
+    const multi<float_type, 2>& alpha_range() const
+    {
+        return alpha_range_;
+    }
+
+    /**
+     * @brief Material parameter range.
+     */
+    const multi<float_type, 2>& eta_range() const
+    {
+        return eta_range_;
+    }
+
+    /**
+     * @brief Scattering order minimum.
+     */
+    unsigned kmin() const
+    {
+        return kmin_;
+    }
+
+    /**@}*/
+
+public:
+
+    /**
+     * @name Serialization
+     *
+     * @note
+     * The format is binary, in native byte order, with values stored
+     * as single precision regardless of `Tfloat`.
+     */
+    /**@{*/
+
+    /**
+     * @brief Save.
+     *
+     * @throw std::runtime_error
+     * If write fails.
+     */
+    void save(std::ostream& os) const
+    {
+        std::int32_t head[7] = {
+            version_,
+            std::int32_t(kmin_),
+            sizes_[0], sizes_[1], sizes_[2], sizes_[3], sizes_[4]
+        };
+        double ranges[4] = {
+            double(alpha_range_[0]), double(alpha_range_[1]),
+            double(eta_range_[0]), double(eta_range_[1])
+        };
+        os.write(magic_, sizeof(magic_));
+        os.write(reinterpret_cast<const char*>(&head[0]), sizeof(head));
+        os.write(reinterpret_cast<const char*>(&ranges[0]), sizeof(ranges));
+        os.write(
+            reinterpret_cast<const char*>(values_.data()),
+            values_.size() * sizeof(float));
+        if (!os) {
+            throw std::runtime_error(__PRETTY_FUNCTION__);
+        }
+    }
+
+    /**
+     * @brief Load.
+     *
+     * @throw std::runtime_error
+     * If read fails, or if data is not a table of this version, or
+     * if sizes are out of bounds.
+     */
+    void load(std::istream& is)
+    {
+        char magic[sizeof(magic_)];
+        std::int32_t head[7];
+        double ranges[4];
+        is.read(&magic[0], sizeof(magic));
+        is.read(reinterpret_cast<char*>(&head[0]), sizeof(head));
+        is.read(reinterpret_cast<char*>(&ranges[0]), sizeof(ranges));
+        if (!is ||
+            std::memcmp(&magic[0], &magic_[0], sizeof(magic)) != 0 ||
+            head[0] != version_) {
+            throw std::runtime_error(__PRETTY_FUNCTION__);
+        }
+        sizes_type sizes = {head[2], head[3], head[4], head[5], head[6]};
+        if (!(valid_(sizes) || empty_(sizes))) {
+            throw std::runtime_error(__PRETTY_FUNCTION__);
+        }
+        std::vector<float> values(count_(sizes));
+        is.read(
+            reinterpret_cast<char*>(values.data()),
+            values.size() * sizeof(float));
+        if (!is) {
+            throw std::runtime_error(__PRETTY_FUNCTION__);
+        }
+        kmin_ = unsigned(head[1]);
+        sizes_ = sizes;
+        alpha_range_ = {float_type(ranges[0]), float_type(ranges[1])};
+        eta_range_ = {float_type(ranges[2]), float_type(ranges[3])};
+        values_ = std::move(values);
+    }
+
+    /**@}*/
+
+private:
+
+    /**
+     * @brief Magic number.
+     */
+    static constexpr char magic_[8] = {
+        'P', 'R', 'E', 'M', 'S', 'T', 'B', 'L'
+    };
+
+    /**
+     * @brief Format version.
+     */
+    static constexpr std::int32_t version_ = 1;
+
+    /**
+     * @brief Sizes.
+     */
+    sizes_type sizes_ = {};
+
+    /**
+     * @brief Roughness range.
+     */
+    multi<float_type, 2> alpha_range_ = {};
+
+    /**
+     * @brief Material parameter range.
+     */
+    multi<float_type, 2> eta_range_ = {};
+
+    /**
+     * @brief Scattering order minimum.
+     */
+    unsigned kmin_ = 2;
+
+    /**
+     * @brief Values, as BSDF times absolute incident cosine.
+     */
+    std::vector<float> values_;
+
+private:
+
+    /**
+     * @brief Size maximum, per dimension.
+     */
+    static constexpr int max_size_ = 4096;
+
+    /**
+     * @brief Node count maximum.
+     */
+    static constexpr size_type max_count_ = size_type(1) << 28;
+
+    /**
+     * @brief Sizes valid?
+     *
+     * The bounds keep the node count from overflowing, and keep
+     * corrupt files from requesting enormous allocations.
+     */
+    static bool valid_(const sizes_type& sizes)
+    {
+        size_type count = 1;
+        for (int j = 0; j < 5; j++) {
+            if (!(sizes[j] >= 1 && sizes[j] <= max_size_)) {
+                return false;
+            }
+            count *= size_type(sizes[j]); // Can't overflow.
+            if (count > max_count_) {
+                return false;
+            }
+        }
+        return sizes[4] >= 2;
+    }
+
+    /**
+     * @brief Node count, for valid or empty sizes.
+     */
+    static size_type count_(const sizes_type& sizes)
+    {
+        size_type count = 1;
+        for (int j = 0; j < 5; j++) {
+            count *= size_type(sizes[j]);
+        }
+        return count;
+    }
+
+    /**
+     * @brief Sizes empty, as saved by an empty table?
+     */
+    static bool empty_(const sizes_type& sizes)
+    {
+        for (int j = 0; j < 5; j++) {
+            if (sizes[j] != 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Range node, inclusive of endpoints.
+     */
+    static float_type node_(
+            const multi<float_type, 2>& range, int n, int i)
+    {
+        return n == 1 ? range[0] :
+               range[0] + (range[1] - range[0]) * i / (n - 1);
+    }
+
+    /**
+     * @brief Range fractional index.
+     */
+    static float_type coord_(
+            const multi<float_type, 2>& range, int n, float_type x)
+    {
+        return n == 1 || !(range[1] != range[0]) ? 0 :
+               (x - range[0]) / (range[1] - range[0]) * (n - 1);
+    }
+
+    /**
+     * @brief Cosine node, cell-centered on @f$ [-1, 1] @f$.
+     */
+    static float_type cos_node_(int n, int i)
+    {
+        return (2 * i + 1) / float_type(n) - 1;
+    }
+
+    /**
+     * @brief Cosine fractional index.
+     */
+    static float_type cos_coord_(int n, float_type x)
+    {
+        return (x + 1) * float_type(0.5) * n - float_type(0.5);
+    }
+};
+
+/**@}*/
+
+} // namespace pre
+
+#endif // #ifndef PREFORM_MICROSURFACE_TABLE_HPP
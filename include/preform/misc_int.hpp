@@ -35,9 +35,25 @@
 #ifndef PREFORM_MISC_INT_HPP
 #define PREFORM_MISC_INT_HPP
 
+// for std::size_t
+#include <cstddef>
+
+// for std::uint8_t, std::uint16_t, ...
+#include <cstdint>
+
+// for std::invalid_argument
+#include <stdexcept>
+
 // for std::enable_if_t, std::is_integral
 #include <type_traits>
 
+#if __BMI2__
+
+// for _pdep_u32, _pext_u32, ...
+#include <immintrin.h>
+
+#endif // #if __BMI2__
+
 namespace pre {
 
 /**
@@ -416,7 +432,8 @@ struct bit_interleave_zero_impl<std::uint64_t>
             0xccccccccccccccccULL,
             0xf0f0f0f0f0f0f0f0ULL,
             0xff00ff00ff00ff00ULL,
-            0xffff0000ffff0000ULL
+            0xffff0000ffff0000ULL,
+            0xffffffff00000000ULL
         };
         for (int k = 5; k >= 0; k--) {
             val = (val ^ (val << (1 << k))) & ~mask[k];
@@ -448,6 +465,344 @@ constexpr std::enable_if_t<
     return val0 | (val1 << 1);
 }
 
+#if !DOXYGEN
+template <typename>
+struct morton_impl;
+
+// Morton implementation for 32-bit unsigned integer.
+template <>
+struct morton_impl<std::uint32_t>
+{
+    // Spread low 16 bits to even bits.
+    static constexpr std::uint32_t spread2(std::uint32_t val)
+    {
+        val &= 0x0000ffffUL;
+        val = (val | (val << 8)) & 0x00ff00ffUL;
+        val = (val | (val << 4)) & 0x0f0f0f0fUL;
+        val = (val | (val << 2)) & 0x33333333UL;
+        val = (val | (val << 1)) & 0x55555555UL;
+        return val;
+    }
+
+    // Compact even bits to low 16 bits.
+    static constexpr std::uint32_t compact2(std::uint32_t val)
+    {
+        val &= 0x55555555UL;
+        val = (val | (val >> 1)) & 0x33333333UL;
+        val = (val | (val >> 2)) & 0x0f0f0f0fUL;
+        val = (val | (val >> 4)) & 0x00ff00ffUL;
+        val = (val | (val >> 8)) & 0x0000ffffUL;
+        return val;
+    }
+
+    // Spread low 10 bits to every third bit.
+    static constexpr std::uint32_t spread3(std::uint32_t val)
+    {
+        val &= 0x000003ffUL;
+        val = (val | (val << 16)) & 0x030000ffUL;
+        val = (val | (val << 8)) & 0x0300f00fUL;
+        val = (val | (val << 4)) & 0x030c30c3UL;
+        val = (val | (val << 2)) & 0x09249249UL;
+        return val;
+    }
+
+    // Compact every third bit to low 10 bits.
+    static constexpr std::uint32_t compact3(std::uint32_t val)
+    {
+        val &= 0x09249249UL;
+        val = (val | (val >> 2)) & 0x030c30c3UL;
+        val = (val | (val >> 4)) & 0x0300f00fUL;
+        val = (val | (val >> 8)) & 0x030000ffUL;
+        val = (val | (val >> 16)) & 0x000003ffUL;
+        return val;
+    }
+
+    // Encode 2 dimensions.
+    static std::uint32_t encode2(std::uint32_t x, std::uint32_t y)
+    {
+#if __BMI2__
+        return _pdep_u32(x, 0x55555555UL) |
+               _pdep_u32(y, 0x55555555UL << 1);
+#else
+        return spread2(x) | (spread2(y) << 1);
+#endif // #if __BMI2__
+    }
+
+    // Decode 2 dimensions.
+    static void decode2(std::uint32_t code, std::uint32_t& x, std::uint32_t& y)
+    {
+#if __BMI2__
+        x = _pext_u32(code, 0x55555555UL);
+        y = _pext_u32(code, 0x55555555UL << 1);
+#else
+        x = compact2(code);
+        y = compact2(code >> 1);
+#endif // #if __BMI2__
+    }
+
+    // Encode 3 dimensions.
+    static std::uint32_t encode3(
+            std::uint32_t x, std::uint32_t y, std::uint32_t z)
+    {
+#if __BMI2__
+        return _pdep_u32(x, 0x09249249UL) |
+               _pdep_u32(y, 0x09249249UL << 1) |
+               _pdep_u32(z, 0x09249249UL << 2);
+#else
+        return spread3(x) | (spread3(y) << 1) | (spread3(z) << 2);
+#endif // #if __BMI2__
+    }
+
+    // Decode 3 dimensions.
+    static void decode3(
+            std::uint32_t code,
+            std::uint32_t& x, std::uint32_t& y, std::uint32_t& z)
+    {
+#if __BMI2__
+        x = _pext_u32(code, 0x09249249UL);
+        y = _pext_u32(code, 0x09249249UL << 1);
+        z = _pext_u32(code, 0x09249249UL << 2);
+#else
+        x = compact3(code);
+        y = compact3(code >> 1);
+        z = compact3(code >> 2);
+#endif // #if __BMI2__
+    }
+};
+
+// Morton implementation for 64-bit unsigned integer.
+template <>
+struct morton_impl<std::uint64_t>
+{
+    // Spread low 32 bits to even bits.
+    static constexpr std::uint64_t spread2(std::uint64_t val)
+    {
+        val &= 0x00000000ffffffffULL;
+        val = (val | (val << 16)) & 0x0000ffff0000ffffULL;
+        val = (val | (val << 8)) & 0x00ff00ff00ff00ffULL;
+        val = (val | (val << 4)) & 0x0f0f0f0f0f0f0f0fULL;
+        val = (val | (val << 2)) & 0x3333333333333333ULL;
+        val = (val | (val << 1)) & 0x5555555555555555ULL;
+        return val;
+    }
+
+    // Compact even bits to low 32 bits.
+    static constexpr std::uint64_t compact2(std::uint64_t val)
+    {
+        val &= 0x5555555555555555ULL;
+        val = (val | (val >> 1)) & 0x3333333333333333ULL;
+        val = (val | (val >> 2)) & 0x0f0f0f0f0f0f0f0fULL;
+        val = (val | (val >> 4)) & 0x00ff00ff00ff00ffULL;
+        val = (val | (val >> 8)) & 0x0000ffff0000ffffULL;
+        val = (val | (val >> 16)) & 0x00000000ffffffffULL;
+        return val;
+    }
+
+    // Spread low 21 bits to every third bit.
+    static constexpr std::uint64_t spread3(std::uint64_t val)
+    {
+        val &= 0x00000000001fffffULL;
+        val = (val | (val << 32)) & 0x001f00000000ffffULL;
+        val = (val | (val << 16)) & 0x001f0000ff0000ffULL;
+        val = (val | (val << 8)) & 0x100f00f00f00f00fULL;
+        val = (val | (val << 4)) & 0x10c30c30c30c30c3ULL;
+        val = (val | (val << 2)) & 0x1249249249249249ULL;
+        return val;
+    }
+
+    // Compact every third bit to low 21 bits.
+    static constexpr std::uint64_t compact3(std::uint64_t val)
+    {
+        val &= 0x1249249249249249ULL;
+        val = (val | (val >> 2)) & 0x10c30c30c30c30c3ULL;
+        val = (val | (val >> 4)) & 0x100f00f00f00f00fULL;
+        val = (val | (val >> 8)) & 0x001f0000ff0000ffULL;
+        val = (val | (val >> 16)) & 0x001f00000000ffffULL;
+        val = (val | (val >> 32)) & 0x00000000001fffffULL;
+        return val;
+    }
+
+    // Encode 2 dimensions.
+    static std::uint64_t encode2(std::uint64_t x, std::uint64_t y)
+    {
+#if __BMI2__ && __x86_64__
+        return _pdep_u64(x, 0x5555555555555555ULL) |
+               _pdep_u64(y, 0x5555555555555555ULL << 1);
+#else
+        return spread2(x) | (spread2(y) << 1);
+#endif // #if __BMI2__ && __x86_64__
+    }
+
+    // Decode 2 dimensions.
+    static void decode2(std::uint64_t code, std::uint64_t& x, std::uint64_t& y)
+    {
+#if __BMI2__ && __x86_64__
+        x = _pext_u64(code, 0x5555555555555555ULL);
+        y = _pext_u64(code, 0x5555555555555555ULL << 1);
+#else
+        x = compact2(code);
+        y = compact2(code >> 1);
+#endif // #if __BMI2__ && __x86_64__
+    }
+
+    // Encode 3 dimensions.
+    static std::uint64_t encode3(
+            std::uint64_t x, std::uint64_t y, std::uint64_t z)
+    {
+#if __BMI2__ && __x86_64__
+        return _pdep_u64(x, 0x1249249249249249ULL) |
+               _pdep_u64(y, 0x1249249249249249ULL << 1) |
+               _pdep_u64(z, 0x1249249249249249ULL << 2);
+#else
+        return spread3(x) | (spread3(y) << 1) | (spread3(z) << 2);
+#endif // #if __BMI2__ && __x86_64__
+    }
+
+    // Decode 3 dimensions.
+    static void decode3(
+            std::uint64_t code,
+            std::uint64_t& x, std::uint64_t& y, std::uint64_t& z)
+    {
+#if __BMI2__ && __x86_64__
+        x = _pext_u64(code, 0x1249249249249249ULL);
+        y = _pext_u64(code, 0x1249249249249249ULL << 1);
+        z = _pext_u64(code, 0x1249249249249249ULL << 2);
+#else
+        x = compact3(code);
+        y = compact3(code >> 1);
+        z = compact3(code >> 2);
+#endif // #if __BMI2__ && __x86_64__
+    }
+};
+
+// Enable if 32-bit or 64-bit unsigned integer.
+template <typename T, typename U = T>
+using enable_if_morton_t =
+    std::enable_if_t<
+        std::is_same<T, std::uint32_t>::value ||
+        std::is_same<T, std::uint64_t>::value, U>;
+#endif // #if !DOXYGEN
+
+/**
+ * @name Morton codes
+ *
+ * Encode and decode Morton codes in 32-bit or 64-bit unsigned
+ * integers, for 2 dimensions with 16 or 32 bits per coordinate, and
+ * for 3 dimensions with 10 or 21 bits per coordinate. Bit @f$ k @f$
+ * of coordinate @f$ i @f$ in @f$ n @f$ dimensions is bit @f$ nk + i @f$
+ * of the code, and higher bits of coordinates are ignored.
+ *
+ * With BMI2, i.e., `-mbmi2` or `-march=haswell` and later, single
+ * codes use `pdep`/`pext`. Else, and for arrays, where the loop
+ * vectorizes instead, codes use shifts and masks.
+ *
+ * @note
+ * On AMD processors before Zen 3, `pdep` and `pext` are microcoded
+ * and slow, so prefer the array forms there.
+ */
+/**@{*/
+
+/**
+ * @brief Morton encode, 2 dimensions.
+ */
+template <typename T>
+inline enable_if_morton_t<T> morton_encode2(T x, T y)
+{
+    return morton_impl<T>::encode2(x, y);
+}
+
+/**
+ * @brief Morton decode, 2 dimensions.
+ */
+template <typename T>
+inline enable_if_morton_t<T, void> morton_decode2(T code, T& x, T& y)
+{
+    morton_impl<T>::decode2(code, x, y);
+}
+
+/**
+ * @brief Morton encode, 3 dimensions.
+ */
+template <typename T>
+inline enable_if_morton_t<T> morton_encode3(T x, T y, T z)
+{
+    return morton_impl<T>::encode3(x, y, z);
+}
+
+/**
+ * @brief Morton decode, 3 dimensions.
+ */
+template <typename T>
+inline enable_if_morton_t<T, void> morton_decode3(
+                T code, T& x, T& y, T& z)
+{
+    morton_impl<T>::decode3(code, x, y, z);
+}
+
+/**
+ * @brief Morton encode array, 2 dimensions.
+ */
+template <typename T>
+inline enable_if_morton_t<T, void> morton_encode2(
+                const T* x,
+                const T* y, T* code, std::size_t n)
+{
+    typedef morton_impl<T> impl;
+    for (std::size_t k = 0; k < n; k++) {
+        code[k] = impl::spread2(x[k]) | (impl::spread2(y[k]) << 1);
+    }
+}
+
+/**
+ * @brief Morton decode array, 2 dimensions.
+ */
+template <typename T>
+inline enable_if_morton_t<T, void> morton_decode2(
+                const T* code,
+                T* x, T* y, std::size_t n)
+{
+    typedef morton_impl<T> impl;
+    for (std::size_t k = 0; k < n; k++) {
+        x[k] = impl::compact2(code[k]);
+        y[k] = impl::compact2(code[k] >> 1);
+    }
+}
+
+/**
+ * @brief Morton encode array, 3 dimensions.
+ */
+template <typename T>
+inline enable_if_morton_t<T, void> morton_encode3(
+                const T* x,
+                const T* y,
+                const T* z, T* code, std::size_t n)
+{
+    typedef morton_impl<T> impl;
+    for (std::size_t k = 0; k < n; k++) {
+        code[k] = impl::spread3(x[k]) |
+                 (impl::spread3(y[k]) << 1) |
+                 (impl::spread3(z[k]) << 2);
+    }
+}
+
+/**
+ * @brief Morton decode array, 3 dimensions.
+ */
+template <typename T>
+inline enable_if_morton_t<T, void> morton_decode3(
+                const T* code,
+                T* x, T* y, T* z, std::size_t n)
+{
+    typedef morton_impl<T> impl;
+    for (std::size_t k = 0; k < n; k++) {
+        x[k] = impl::compact3(code[k]);
+        y[k] = impl::compact3(code[k] >> 1);
+        z[k] = impl::compact3(code[k] >> 2);
+    }
+}
+
+/**@}*/
+
 /**
  * @brief Clamp integer in range.
  *
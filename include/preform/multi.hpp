@@ -114,6 +114,11 @@ struct is_multi<multi<T, N...>> : std::true_type
 {
 };
 
+template <typename T>
+struct is_multi_expr : std::false_type
+{
+};
+
 #endif // #if !DOXYGEN
 
 template <typename T, typename = void>
@@ -231,6 +236,9 @@ private:
         if (align > std::alignment_of<std::max_align_t>::value) {
             align = std::alignment_of<std::max_align_t>::value;
         }
+        if (align < std::alignment_of<value_type>::value) {
+            align = std::alignment_of<value_type>::value; // e.g., simd
+        }
         return align;
     }
 
@@ -280,6 +288,20 @@ public:
         fill(ptr);
     }
 
+    /**
+     * @brief Assign lazy expression, fused into one loop.
+     *
+     * @see `<preform/multi_expr.hpp>`
+     */
+    template <typename E>
+    __attribute__((always_inline))
+    constexpr std::enable_if_t<is_multi_expr<E>::value, multi&>
+                operator=(const E& expr)
+    {
+        expr.assign_to(*this);
+        return *this;
+    }
+
 public:
 
 
@@ -0,0 +1,536 @@
+/* Copyright (c) 2018-20 M. Grady Saunders
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer.
+ *
+ *   2. Redistributions in binary form must reproduce the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer in the documentation and/or other materials
+ *      provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#if !DOXYGEN
+#if !(__cplusplus >= 201703L)
+#error "preform/multi_batch.hpp requires >=C++17"
+#endif // #if !(__cplusplus >= 201703L)
+#endif // #if !DOXYGEN
+#pragma once
+#ifndef PREFORM_MULTI_BATCH_HPP
+#define PREFORM_MULTI_BATCH_HPP
+
+// for std::size_t
+#include <cstddef>
+
+// for std::min
+#include <algorithm>
+
+// for std::decay_t, std::invoke_result_t
+#include <type_traits>
+
+// for pre::simd, pre::select, pre::any
+#include <preform/simd.hpp>
+
+// for pre::multi
+#include <preform/multi.hpp>
+
+// for pre::dot, pre::inverse, ...
+#include <preform/multi_math.hpp>
+
+namespace pre {
+
+/**
+ * @defgroup multi_batch Multi-dimensional array (batched linear algebra)
+ *
+ * `<preform/multi_batch.hpp>`
+ *
+ * __C++ version__: >=C++17
+ *
+ * Small dense factorizations and solves, written once for both
+ * scalar and `simd` entries. With `simd` entries, a single
+ * `multi<simd<T, W>, M, N>` holds `W` matrices interleaved by entry,
+ * so that every arithmetic operation processes one entry of all
+ * `W` matrices at once, and data-dependent decisions blend lanes
+ * with `select()` instead of branching. Use `batch_pack()`,
+ * `batch_unpack()`, or `batch_transform()` to convert between
+ * arrays of matrices and batches.
+ *
+ * The existing `inverse()`, `dot()`, and other `multi_math` routines
+ * already work on batches.
+ */
+/**@{*/
+
+/**
+ * @brief Batch of `W` arrays, interleaved by entry.
+ */
+template <typename T, std::size_t W, std::size_t... N>
+using multi_batch = multi<simd<T, W>, N...>;
+
+#if !DOXYGEN
+
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline void batch_pack_lane_(simd<T, W>& res, const T& val, std::size_t k)
+{
+    res[k] = val;
+}
+
+template <typename T, std::size_t W, std::size_t M, std::size_t... N>
+__attribute__((always_inline))
+inline void batch_pack_lane_(
+                multi<simd<T, W>, M, N...>& res,
+                const multi<T, M, N...>& arr, std::size_t k)
+{
+    for (std::size_t i = 0; i < M; i++) {
+        batch_pack_lane_(res[i], arr[i], k);
+    }
+}
+
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline void batch_unpack_lane_(const simd<T, W>& res, T& val, std::size_t k)
+{
+    val = res[k];
+}
+
+template <typename T, std::size_t W, std::size_t M, std::size_t... N>
+__attribute__((always_inline))
+inline void batch_unpack_lane_(
+                const multi<simd<T, W>, M, N...>& res,
+                multi<T, M, N...>& arr, std::size_t k)
+{
+    for (std::size_t i = 0; i < M; i++) {
+        batch_unpack_lane_(res[i], arr[i], k);
+    }
+}
+
+#endif // #if !DOXYGEN
+
+/**
+ * @name Packing
+ */
+/**@{*/
+
+/**
+ * @brief Pack arrays into batch.
+ *
+ * @param[in] arr
+ * Arrays.
+ *
+ * @param[in] count
+ * Count, at most `W`. The last array fills the remaining lanes,
+ * so that padding lanes are as well-conditioned as the real ones.
+ */
+template <std::size_t W, typename T, std::size_t... N>
+inline multi<simd<T, W>, N...> batch_pack(
+                const multi<T, N...>* arr, std::size_t count = W)
+{
+    multi<simd<T, W>, N...> res;
+    for (std::size_t k = 0; k < W; k++) {
+        batch_pack_lane_(res, arr[std::min(k, count - 1)], k);
+    }
+    return res;
+}
+
+/**
+ * @brief Unpack batch into arrays.
+ *
+ * @param[in] res
+ * Batch.
+ *
+ * @param[out] arr
+ * Arrays.
+ *
+ * @param[in] count
+ * Count, at most `W`.
+ */
+template <typename T, std::size_t W, std::size_t... N>
+inline void batch_unpack(
+                const multi<simd<T, W>, N...>& res,
+                multi<T, N...>* arr, std::size_t count = W)
+{
+    for (std::size_t k = 0; k < std::min(count, W); k++) {
+        batch_unpack_lane_(res, arr[k], k);
+    }
+}
+
+/**
+ * @brief Unpack batch into values.
+ */
+template <typename T, std::size_t W>
+inline void batch_unpack(
+                const simd<T, W>& res,
+                T* arr, std::size_t count = W)
+{
+    for (std::size_t k = 0; k < std::min(count, W); k++) {
+        arr[k] = res[k];
+    }
+}
+
+/**
+ * @brief Transform arrays in batches of `W`.
+ *
+ * Packs each run of `W` consecutive arrays, invokes `func` on the
+ * batch, and unpacks the result, which may be a `multi` of `simd`
+ * entries or a single `simd`, e.g., for a determinant. The final
+ * run may be partial.
+ *
+ * @param[in] from
+ * Input range from.
+ *
+ * @param[in] to
+ * Input range to.
+ *
+ * @param[out] out
+ * Output.
+ *
+ * @param[in] func
+ * Function.
+ */
+template <
+    std::size_t W,
+    typename T, std::size_t... N,
+    typename Tout,
+    typename Func
+    >
+inline void batch_transform(
+                const multi<T, N...>* from,
+                const multi<T, N...>* to,
+                Tout* out, Func&& func)
+{
+    for (; from < to; from += W, out += W) {
+        std::size_t count = std::min(std::size_t(to - from), W);
+        batch_unpack(func(batch_pack<W>(from, count)), out, count);
+    }
+}
+
+/**@}*/
+
+/**
+ * @name Factorizations
+ */
+/**@{*/
+
+/**
+ * @brief Cholesky decomposition, in place.
+ *
+ * @param[inout] a
+ * Symmetric positive definite matrix @f$ \mathbf{A} \to \mathbf{L} @f$,
+ * with @f$ \mathbf{A} = \mathbf{L}\mathbf{L}^\top @f$. Reads the lower
+ * triangle only, and zeros the upper triangle.
+ *
+ * @returns
+ * Whether each matrix is positive definite. Lanes which are not
+ * substitute a unit pivot rather than produce NaNs, so that they
+ * do not disturb anything downstream.
+ */
+template <typename T, std::size_t N>
+inline decltype(T() > T()) chol(multi<T, N, N>& a)
+{
+    decltype(T() > T()) res(true);
+    for (std::size_t k = 0; k < N; k++) {
+        T akk = a[k][k];
+        for (std::size_t l = 0; l < k; l++) {
+            akk -= a[k][l] * a[k][l];
+        }
+        auto pos = akk > T(0);
+        res = res && pos;
+        akk = pre::sqrt(pre::select(pos, akk, T(1)));
+        T invakk = T(1) / akk;
+        a[k][k] = akk;
+        for (std::size_t i = k + 1; i < N; i++) {
+            T aik = a[i][k];
+            for (std::size_t l = 0; l < k; l++) {
+                aik -= a[i][l] * a[k][l];
+            }
+            a[i][k] = aik * invakk;
+            a[k][i] = T(0);
+        }
+    }
+    return res;
+}
+
+/**
+ * @brief Solve with Cholesky decomposition.
+ *
+ * @param[in] l
+ * Matrix @f$ \mathbf{L} @f$, as computed by `chol()`.
+ *
+ * @param[in] b
+ * Vector @f$ \mathbf{b} @f$.
+ *
+ * @returns
+ * Vector @f$ \mathbf{x} @f$ such that
+ * @f$ \mathbf{L}\mathbf{L}^\top \mathbf{x} = \mathbf{b} @f$.
+ */
+template <typename T, std::size_t N>
+inline multi<T, N> chol_solve(
+                const multi<T, N, N>& l,
+                const multi<T, N>& b)
+{
+    // Forward substitution.
+    multi<T, N> x = b;
+    for (std::size_t i = 0; i < N; i++) {
+        for (std::size_t j = 0; j < i; j++) {
+            x[i] -= l[i][j] * x[j];
+        }
+        x[i] /= l[i][i];
+    }
+
+    // Back substitution.
+    for (std::size_t i = N; i-- > 0;) {
+        for (std::size_t j = i + 1; j < N; j++) {
+            x[i] -= l[j][i] * x[j];
+        }
+        x[i] /= l[i][i];
+    }
+    return x;
+}
+
+/**
+ * @brief QR-decomposition by Householder reflections.
+ *
+ * @param[in] a
+ * Matrix @f$ \mathbf{A} @f$.
+ *
+ * @param[out] q
+ * Orthogonal matrix @f$ \mathbf{Q} @f$.
+ *
+ * @param[out] r
+ * Upper triangular matrix @f$ \mathbf{R} @f$, with
+ * @f$ \mathbf{A} = \mathbf{Q}\mathbf{R} @f$.
+ *
+ * @note
+ * Reflectors of zero columns are replaced by the identity
+ * per lane, rather than by branching.
+ */
+template <typename T, std::size_t M, std::size_t N>
+inline void qr(
+                const multi<T, M, N>& a,
+                multi<T, M, M>& q,
+                multi<T, M, N>& r)
+{
+    q = {};
+    for (std::size_t i = 0; i < M; i++) {
+        q[i][i] = T(1);
+    }
+    r = a;
+    for (std::size_t k = 0; k < std::min(M - 1, N); k++) {
+
+        // Reflector.
+        T norm2 = T(0);
+        for (std::size_t i = k; i < M; i++) {
+            norm2 += r[i][k] * r[i][k];
+        }
+        T alpha = -pre::copysign(pre::sqrt(norm2), r[k][k]);
+        multi<T, M> v = {};
+        v[k] = r[k][k] - alpha;
+        for (std::size_t i = k + 1; i < M; i++) {
+            v[i] = r[i][k];
+        }
+        T vv = dot(v, v);
+        T beta = pre::select(vv > T(0), T(2) / vv, T(0));
+
+        // Reflect columns.
+        r[k][k] = pre::select(vv > T(0), alpha, r[k][k]);
+        for (std::size_t i = k + 1; i < M; i++) {
+            r[i][k] = T(0);
+        }
+        for (std::size_t j = k + 1; j < N; j++) {
+            T fac = T(0);
+            for (std::size_t i = k; i < M; i++) {
+                fac += v[i] * r[i][j];
+            }
+            fac *= beta;
+            for (std::size_t i = k; i < M; i++) {
+                r[i][j] -= fac * v[i];
+            }
+        }
+
+        // Accumulate.
+        for (std::size_t i = 0; i < M; i++) {
+            T fac = T(0);
+            for (std::size_t j = k; j < M; j++) {
+                fac += q[i][j] * v[j];
+            }
+            fac *= beta;
+            for (std::size_t j = k; j < M; j++) {
+                q[i][j] -= fac * v[j];
+            }
+        }
+    }
+}
+
+/**
+ * @brief Solve with QR-decomposition, in the least-squares sense.
+ *
+ * @param[in] q
+ * Matrix @f$ \mathbf{Q} @f$, as computed by `qr()`.
+ *
+ * @param[in] r
+ * Matrix @f$ \mathbf{R} @f$, as computed by `qr()`.
+ *
+ * @param[in] b
+ * Vector @f$ \mathbf{b} @f$.
+ *
+ * @returns
+ * Vector @f$ \mathbf{x} @f$ minimizing
+ * @f$ \lVert \mathbf{Q}\mathbf{R}\mathbf{x} - \mathbf{b} \rVert @f$,
+ * assuming @f$ M \ge N @f$ and full rank.
+ */
+template <typename T, std::size_t M, std::size_t N>
+inline multi<T, N> qr_solve(
+                const multi<T, M, M>& q,
+                const multi<T, M, N>& r,
+                const multi<T, M>& b)
+{
+    static_assert(M >= N, "qr_solve() requires M >= N");
+
+    // Project.
+    multi<T, N> x;
+    for (std::size_t j = 0; j < N; j++) {
+        x[j] = T(0);
+        for (std::size_t i = 0; i < M; i++) {
+            x[j] += q[i][j] * b[i];
+        }
+    }
+
+    // Back substitution.
+    for (std::size_t i = N; i-- > 0;) {
+        for (std::size_t j = i + 1; j < N; j++) {
+            x[i] -= r[i][j] * x[j];
+        }
+        x[i] /= r[i][i];
+    }
+    return x;
+}
+
+/**
+ * @brief Symmetric eigendecomposition by cyclic Jacobi rotations.
+ *
+ * @param[in] a
+ * Symmetric matrix @f$ \mathbf{A} @f$.
+ *
+ * @param[out] v
+ * Orthogonal matrix @f$ \mathbf{V} @f$ of eigenvectors, as columns.
+ *
+ * @param[in] max_sweeps
+ * Maximum number of sweeps. Jacobi converges quadratically, so
+ * @f$ 3 \times 3 @f$ matrices typically need 3 to 5.
+ *
+ * @returns
+ * Eigenvalues @f$ \boldsymbol{\lambda} @f$, in ascending order, with
+ * @f$ \mathbf{A} = \mathbf{V}
+ *     \operatorname{diag}(\boldsymbol{\lambda}) \mathbf{V}^\top @f$.
+ *
+ * @note
+ * Every sweep rotates all lanes, where rotations of converged
+ * lanes reduce to the identity. Sweeps stop once the off-diagonal
+ * entries of every lane are negligible.
+ */
+template <typename T, std::size_t N>
+inline multi<T, N> eigh(
+                multi<T, N, N> a,
+                multi<T, N, N>& v,
+                int max_sweeps = 8)
+{
+    typedef simd_value_type_t<T> float_type;
+    v = {};
+    for (std::size_t i = 0; i < N; i++) {
+        v[i][i] = T(1);
+    }
+    for (int sweep = 0; sweep < max_sweeps; sweep++) {
+
+        // Converged?
+        T off = T(0);
+        T diag = T(0);
+        for (std::size_t p = 0; p < N; p++) {
+            diag += a[p][p] * a[p][p];
+            for (std::size_t q = p + 1; q < N; q++) {
+                off += a[p][q] * a[p][q];
+            }
+        }
+        if (pre::none(off > diag *
+                pre::numeric_limits<float_type>::epsilon() *
+                pre::numeric_limits<float_type>::epsilon())) {
+            break;
+        }
+
+        for (std::size_t p = 0; p < N; p++)
+        for (std::size_t q = p + 1; q < N; q++) {
+
+            // Rotation zeroing a[p][q].
+            T apq = a[p][q];
+            auto rot = apq != T(0);
+            T theta = (a[q][q] - a[p][p]) /
+                      (T(2) * pre::select(rot, apq, T(1)));
+            T t = pre::copysign(T(1), theta) /
+                  (pre::abs(theta) + pre::sqrt(theta * theta + T(1)));
+            t = pre::select(rot, t, T(0));
+            T c = T(1) / pre::sqrt(t * t + T(1));
+            T s = t * c;
+
+            // Update.
+            for (std::size_t k = 0; k < N; k++) {
+                T akp = a[k][p];
+                T akq = a[k][q];
+                a[k][p] = c * akp - s * akq;
+                a[k][q] = s * akp + c * akq;
+            }
+            for (std::size_t k = 0; k < N; k++) {
+                T apk = a[p][k];
+                T aqk = a[q][k];
+                a[p][k] = c * apk - s * aqk;
+                a[q][k] = s * apk + c * aqk;
+            }
+            for (std::size_t k = 0; k < N; k++) {
+                T vkp = v[k][p];
+                T vkq = v[k][q];
+                v[k][p] = c * vkp - s * vkq;
+                v[k][q] = s * vkp + c * vkq;
+            }
+        }
+    }
+
+    // Sort ascending, by compare-exchange.
+    multi<T, N> lambda;
+    for (std::size_t p = 0; p < N; p++) {
+        lambda[p] = a[p][p];
+    }
+    for (std::size_t pass = 0; pass + 1 < N; pass++)
+    for (std::size_t p = 0; p + 1 < N - pass; p++) {
+        auto swap = lambda[p + 1] < lambda[p];
+        T lp = lambda[p];
+        lambda[p] = pre::select(swap, lambda[p + 1], lp);
+        lambda[p + 1] = pre::select(swap, lp, lambda[p + 1]);
+        for (std::size_t k = 0; k < N; k++) {
+            T vkp = v[k][p];
+            v[k][p] = pre::select(swap, v[k][p + 1], vkp);
+            v[k][p + 1] = pre::select(swap, vkp, v[k][p + 1]);
+        }
+    }
+    return lambda;
+}
+
+/**@}*/
+
+/**@}*/
+
+} // namespace pre
+
+#endif // #ifndef PREFORM_MULTI_BATCH_HPP
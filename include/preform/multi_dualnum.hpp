@@ -0,0 +1,739 @@
+/* Copyright (c) 2018-20 M. Grady Saunders
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer.
+ *
+ *   2. Redistributions in binary form must reproduce the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer in the documentation and/or other materials
+ *      provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*+-+*/
+#if !DOXYGEN
+#if !(__cplusplus >= 201703L)
+#error "preform/multi_dualnum.hpp requires >=C++17"
+#endif // #if !(__cplusplus >= 201703L)
+#endif // #if !DOXYGEN
+#pragma once
+#ifndef PREFORM_MULTI_DUALNUM_HPP
+#define PREFORM_MULTI_DUALNUM_HPP
+
+// for std::size_t
+#include <cstddef>
+
+// for std::basic_istream
+#include <istream>
+
+// for std::basic_ostream
+#include <ostream>
+
+#include <preform/math.hpp>
+
+// for pre::multi
+#include <preform/multi.hpp>
+
+// for pre::is_dualnum_param
+#include <preform/dualnum.hpp>
+
+namespace pre {
+
+/**
+ * @defgroup multi_dualnum Multi-dual number
+ *
+ * `<preform/multi_dualnum.hpp>`
+ *
+ * __C++ version__: >=C++17
+ *
+ * A multi-dual number @f$ a + \sum_k \varepsilon_k b_k @f$ satisfies
+ * @f$ \varepsilon_j \varepsilon_k = 0 @f$ for all @f$ j, k @f$, so
+ * that it carries the full gradient of @f$ a @f$ with respect to `N`
+ * parameters through one evaluation, as opposed to one directional
+ * derivative for `dualnum`. The dual part is a `multi<T, N>`, so
+ * each operation is a short loop over the tangent that the compiler
+ * may vectorize.
+ */
+/**@{*/
+
+#if !DOXYGEN
+
+template <typename T, std::size_t N>
+class multi_dualnum;
+
+template <typename T>
+struct is_multi_dualnum : std::false_type
+{
+};
+
+template <typename T, std::size_t N>
+struct is_multi_dualnum<multi_dualnum<T, N>> : std::true_type
+{
+};
+
+#endif // #if !DOXYGEN
+
+/**
+ * @brief Multi-dual number.
+ *
+ * @tparam T
+ * Value type.
+ *
+ * @tparam N
+ * Number of partial derivatives.
+ */
+template <typename T, std::size_t N>
+class multi_dualnum
+{
+public:
+
+    // Sanity check.
+    static_assert(
+        is_dualnum_param<T>::value,
+        "T must be arithmetic or complex");
+
+    // Sanity check.
+    static_assert(N > 0, "N must be positive");
+
+    /**
+     * @brief Value type.
+     */
+    typedef T value_type;
+
+    /**
+     * @brief Dual type.
+     */
+    typedef multi<T, N> dual_type;
+
+public:
+
+    /**
+     * @name Constructors
+     */
+    /**@{*/
+
+    /**
+     * @brief Default constructor.
+     */
+    constexpr multi_dualnum() = default;
+
+    /**
+     * @brief Constructor.
+     */
+    constexpr multi_dualnum(T a, const dual_type& b = dual_type()) :
+            a_(a),
+            b_(b)
+    {
+    }
+
+    /**
+     * @brief Independent variable.
+     *
+     * @f[
+     *      a + \varepsilon_k
+     * @f]
+     *
+     * @param[in] a
+     * Value.
+     *
+     * @param[in] k
+     * Parameter index, must be less than `N`.
+     */
+    static constexpr multi_dualnum variable(T a, std::size_t k)
+    {
+        multi_dualnum x(a);
+        x.b_[k] = T(1);
+        return x;
+    }
+
+    /**@}*/
+
+public:
+
+    /**
+     * @name Accessors
+     */
+    /**@{*/
+
+    /**
+     * @brief Get real part.
+     */
+    constexpr const T& real() const
+    {
+        return a_;
+    }
+
+    /**
+     * @brief Get dual part.
+     */
+    constexpr const dual_type& dual() const
+    {
+        return b_;
+    }
+
+    /**
+     * @brief Get dual part, i.e., partial derivative, at index.
+     */
+    constexpr const T& dual(std::size_t k) const
+    {
+        return b_[k];
+    }
+
+    /**
+     * @brief Set real part, return previous real part.
+     */
+    constexpr T real(T val)
+    {
+        T a = a_; a_ = val; return a;
+    }
+
+    /**
+     * @brief Set dual part, return previous dual part.
+     */
+    constexpr dual_type dual(const dual_type& val)
+    {
+        dual_type b = b_; b_ = val; return b;
+    }
+
+    /**@}*/
+
+private:
+
+    /**
+     * @brief Real part.
+     */
+    T a_ = T();
+
+    /**
+     * @brief Dual part.
+     */
+    dual_type b_ = dual_type();
+
+public:
+
+    /**
+     * @name Stream operators
+     */
+    /**@{*/
+
+    /**
+     * @brief Parse from `std::basic_istream`.
+     *
+     * Format is `(a,[b0,b1,...])`. Sets `std::ios_base::failbit`
+     * on error.
+     */
+    template <typename C, typename Ctraits>
+    friend
+    inline std::basic_istream<C, Ctraits>& operator>>(
+           std::basic_istream<C, Ctraits>& is, multi_dualnum& x)
+    {
+        C ch;
+        if (!(is >> ch) ||
+            !Ctraits::eq(ch,
+             Ctraits::to_char_type('('))) {
+            is.setstate(std::ios_base::failbit);
+            return is;
+        }
+        is >> x.a_;
+        if (!(is >> ch) ||
+            !Ctraits::eq(ch,
+             Ctraits::to_char_type(','))) {
+            is.setstate(std::ios_base::failbit);
+            return is;
+        }
+        is >> x.b_;
+        if (!(is >> ch) ||
+            !Ctraits::eq(ch,
+             Ctraits::to_char_type(')'))) {
+            is.setstate(std::ios_base::failbit);
+            return is;
+        }
+        return is;
+    }
+
+    /**
+     * @brief Write into `std::basic_ostream`.
+     *
+     * Format is `(a,[b0,b1,...])`.
+     */
+    template <typename C, typename Ctraits>
+    friend
+    inline std::basic_ostream<C, Ctraits>& operator<<(
+           std::basic_ostream<C, Ctraits>& os, const multi_dualnum& x)
+    {
+        os << '(';
+        os << x.a_ << ',';
+        os << x.b_ << ')';
+        return os;
+    }
+
+    /**@}*/
+};
+
+/**
+ * @name Unary operators (multi_dualnum)
+ */
+/**@{*/
+
+/**
+ * @brief Distribute `operator+`.
+ */
+template <typename T, std::size_t N>
+__attribute__((always_inline))
+constexpr multi_dualnum<T, N> operator+(const multi_dualnum<T, N>& x)
+{
+    return {+x.real(), +x.dual()};
+}
+
+/**
+ * @brief Distribute `operator-`.
+ */
+template <typename T, std::size_t N>
+__attribute__((always_inline))
+constexpr multi_dualnum<T, N> operator-(const multi_dualnum<T, N>& x)
+{
+    return {-x.real(), -x.dual()};
+}
+
+/**@}*/
+
+/**
+ * @name Binary operators (multi_dualnum/multi_dualnum)
+ */
+/**@{*/
+
+/**
+ * @brief Distribute `operator+`.
+ */
+template <typename T, typename U, std::size_t N>
+__attribute__((always_inline))
+constexpr multi_dualnum<decltype(T() + U()), N> operator+(
+                    const multi_dualnum<T, N>& x0,
+                    const multi_dualnum<U, N>& x1)
+{
+    return {x0.real() + x1.real(), x0.dual() + x1.dual()};
+}
+
+/**
+ * @brief Distribute `operator-`.
+ */
+template <typename T, typename U, std::size_t N>
+__attribute__((always_inline))
+constexpr multi_dualnum<decltype(T() - U()), N> operator-(
+                    const multi_dualnum<T, N>& x0,
+                    const multi_dualnum<U, N>& x1)
+{
+    return {x0.real() - x1.real(), x0.dual() - x1.dual()};
+}
+
+/**
+ * @brief Distribute `operator*`.
+ *
+ * @f[
+ *      (a_0 + \varepsilon_k b_{0,k})
+ *      (a_1 + \varepsilon_k b_{1,k}) =
+ *       a_0 a_1 + \varepsilon_k
+ *      (a_0 b_{1,k} + b_{0,k} a_1)
+ * @f]
+ */
+template <typename T, typename U, std::size_t N>
+__attribute__((always_inline))
+constexpr multi_dualnum<decltype(T() * U()), N> operator*(
+                    const multi_dualnum<T, N>& x0,
+                    const multi_dualnum<U, N>& x1)
+{
+    return {
+        x0.real() * x1.real(),
+        x0.real() * x1.dual() + x0.dual() * x1.real()
+    };
+}
+
+/**
+ * @brief Distribute `operator*`, inverting right hand side.
+ *
+ * @f[
+ *      (a_0 + \varepsilon_k b_{0,k})
+ *      (a_1 + \varepsilon_k b_{1,k})^{-1} =
+ *       a_0 a_1^{-1} + \varepsilon_k
+ *      (b_{0,k} - a_0 a_1^{-1} b_{1,k}) a_1^{-1}
+ * @f]
+ */
+template <typename T, typename U, std::size_t N>
+__attribute__((always_inline))
+constexpr multi_dualnum<decltype(T() / U()), N> operator/(
+                    const multi_dualnum<T, N>& x0,
+                    const multi_dualnum<U, N>& x1)
+{
+    typedef decltype(T() / U()) value_type;
+    value_type inv = value_type(1) / x1.real();
+    value_type a = x0.real() * inv;
+    return {a, (x0.dual() - a * x1.dual()) * inv};
+}
+
+/**@}*/
+
+/**
+ * @name Binary operators (multi_dualnum/num)
+ */
+/**@{*/
+
+/**
+ * @brief Distribute `operator+`.
+ */
+template <typename T, typename U, std::size_t N>
+__attribute__((always_inline))
+constexpr std::enable_if_t<
+                        is_dualnum_param<U>::value,
+                        multi_dualnum<decltype(T() + U()), N>> operator+(
+                            const multi_dualnum<T, N>& x0, const U& x1)
+{
+    return {x0.real() + x1, x0.dual()};
+}
+
+/**
+ * @brief Distribute `operator-`.
+ */
+template <typename T, typename U, std::size_t N>
+__attribute__((always_inline))
+constexpr std::enable_if_t<
+                        is_dualnum_param<U>::value,
+                        multi_dualnum<decltype(T() - U()), N>> operator-(
+                            const multi_dualnum<T, N>& x0, const U& x1)
+{
+    return {x0.real() - x1, x0.dual()};
+}
+
+/**
+ * @brief Distribute `operator*`.
+ */
+template <typename T, typename U, std::size_t N>
+__attribute__((always_inline))
+constexpr std::enable_if_t<
+                        is_dualnum_param<U>::value,
+                        multi_dualnum<decltype(T() * U()), N>> operator*(
+                            const multi_dualnum<T, N>& x0, const U& x1)
+{
+    return {x0.real() * x1, x0.dual() * x1};
+}
+
+/**
+ * @brief Distribute `operator*`, inverting right hand side.
+ */
+template <typename T, typename U, std::size_t N>
+__attribute__((always_inline))
+constexpr std::enable_if_t<
+                        is_dualnum_param<U>::value,
+                        multi_dualnum<decltype(T() / U()), N>> operator/(
+                            const multi_dualnum<T, N>& x0, const U& x1)
+{
+    typedef decltype(T() / U()) value_type;
+    value_type inv = value_type(1) / x1;
+    return {x0.real() * inv, x0.dual() * inv};
+}
+
+/**@}*/
+
+/**
+ * @name Binary operators (num/multi_dualnum)
+ */
+/**@{*/
+
+/**
+ * @brief Distribute `operator+`.
+ */
+template <typename T, typename U, std::size_t N>
+__attribute__((always_inline))
+constexpr std::enable_if_t<
+                        is_dualnum_param<T>::value,
+                        multi_dualnum<decltype(T() + U()), N>> operator+(
+                            const T& x0, const multi_dualnum<U, N>& x1)
+{
+    return {x0 + x1.real(), x1.dual()};
+}
+
+/**
+ * @brief Distribute `operator-`.
+ */
+template <typename T, typename U, std::size_t N>
+__attribute__((always_inline))
+constexpr std::enable_if_t<
+                        is_dualnum_param<T>::value,
+                        multi_dualnum<decltype(T() - U()), N>> operator-(
+                            const T& x0, const multi_dualnum<U, N>& x1)
+{
+    return {x0 - x1.real(), -x1.dual()};
+}
+
+/**
+ * @brief Distribute `operator*`.
+ */
+template <typename T, typename U, std::size_t N>
+__attribute__((always_inline))
+constexpr std::enable_if_t<
+                        is_dualnum_param<T>::value,
+                        multi_dualnum<decltype(T() * U()), N>> operator*(
+                            const T& x0, const multi_dualnum<U, N>& x1)
+{
+    return {x0 * x1.real(), x0 * x1.dual()};
+}
+
+/**
+ * @brief Distribute `operator*`, inverting right hand side.
+ *
+ * @f[
+ *      a_0 (a_1 + \varepsilon_k b_{1,k})^{-1} =
+ *      a_0 a_1^{-1} - \varepsilon_k a_0 a_1^{-2} b_{1,k}
+ * @f]
+ */
+template <typename T, typename U, std::size_t N>
+__attribute__((always_inline))
+constexpr std::enable_if_t<
+                        is_dualnum_param<T>::value,
+                        multi_dualnum<decltype(T() / U()), N>> operator/(
+                            const T& x0, const multi_dualnum<U, N>& x1)
+{
+    typedef decltype(T() / U()) value_type;
+    value_type inv = value_type(1) / x1.real();
+    value_type a = x0 * inv;
+    return {a, x1.dual() * (-a * inv)};
+}
+
+/**@}*/
+
+/**
+ * @name Binary operators (multi_dualnum/any)
+ */
+/**@{*/
+
+/**
+ * @brief Distribute `operator+=`.
+ */
+template <typename T, std::size_t N, typename U>
+__attribute__((always_inline))
+constexpr multi_dualnum<T, N>& operator+=(
+                    multi_dualnum<T, N>& x, const U& any)
+{
+    return x = x + any;
+}
+
+/**
+ * @brief Distribute `operator-=`.
+ */
+template <typename T, std::size_t N, typename U>
+__attribute__((always_inline))
+constexpr multi_dualnum<T, N>& operator-=(
+                    multi_dualnum<T, N>& x, const U& any)
+{
+    return x = x - any;
+}
+
+/**
+ * @brief Distribute `operator*=`.
+ */
+template <typename T, std::size_t N, typename U>
+__attribute__((always_inline))
+constexpr multi_dualnum<T, N>& operator*=(
+                    multi_dualnum<T, N>& x, const U& any)
+{
+    return x = x * any;
+}
+
+/**
+ * @brief Distribute `operator/=`.
+ */
+template <typename T, std::size_t N, typename U>
+__attribute__((always_inline))
+constexpr multi_dualnum<T, N>& operator/=(
+                    multi_dualnum<T, N>& x, const U& any)
+{
+    return x = x / any;
+}
+
+/**@}*/
+
+/**
+ * @name Comparison operators (multi_dualnum)
+ */
+/**@{*/
+
+/**
+ * @brief Compare `operator==`.
+ */
+template <typename T, typename U, std::size_t N>
+__attribute__((always_inline))
+constexpr bool operator==(
+                    const multi_dualnum<T, N>& x0,
+                    const multi_dualnum<U, N>& x1)
+{
+    return x0.real() == x1.real() && (x0.dual() == x1.dual()).all();
+}
+
+/**
+ * @brief Compare `operator!=`.
+ */
+template <typename T, typename U, std::size_t N>
+__attribute__((always_inline))
+constexpr bool operator!=(
+                    const multi_dualnum<T, N>& x0,
+                    const multi_dualnum<U, N>& x1)
+{
+    return !(x0 == x1);
+}
+
+/**@}*/
+
+/**
+ * @name Accessors (multi_dualnum)
+ */
+/**@{*/
+
+/**
+ * @brief Real part.
+ */
+template <typename T, std::size_t N>
+__attribute__((always_inline))
+constexpr T real(const multi_dualnum<T, N>& x) { return x.real(); }
+
+/**
+ * @brief Dual part.
+ */
+template <typename T, std::size_t N>
+__attribute__((always_inline))
+constexpr multi<T, N> dual(const multi_dualnum<T, N>& x)
+{
+    return x.dual();
+}
+
+/**
+ * @brief Dual conjugate.
+ *
+ * @f[
+ *      (a + \varepsilon_k b_k)^\circ =
+ *       a - \varepsilon_k b_k
+ * @f]
+ */
+template <typename T, std::size_t N>
+__attribute__((always_inline))
+constexpr multi_dualnum<T, N> dual_conj(const multi_dualnum<T, N>& x)
+{
+    return {+x.real(), -x.dual()};
+}
+
+/**
+ * @brief Norm square.
+ *
+ * @f[
+ *      |(a + \varepsilon_k b_k)
+ *       (a + \varepsilon_k b_k)^\circ| = |a^2|
+ * @f]
+ */
+template <typename T, std::size_t N>
+__attribute__((always_inline))
+constexpr decltype(pre::abs(T() * T())) norm(const multi_dualnum<T, N>& x)
+{
+    return pre::abs(x.real() * x.real());
+}
+
+/**
+ * @brief Absolute value.
+ *
+ * @f[
+ *      |a + \varepsilon_k b_k| = |a|
+ * @f]
+ */
+template <typename T, std::size_t N>
+__attribute__((always_inline))
+inline decltype(pre::abs(T())) abs(const multi_dualnum<T, N>& x)
+{
+    return pre::abs(x.real());
+}
+
+/**@}*/
+
+/**
+ * @name Float checks (multi_dualnum)
+ */
+/**@{*/
+
+/**
+ * @brief Any Inf?
+ */
+template <typename T, std::size_t N>
+__attribute__((always_inline))
+inline bool isinf(const multi_dualnum<T, N>& x)
+{
+    bool res = pre::isinf(x.real());
+    for (const T& b : x.dual()) {
+        res = res || pre::isinf(b);
+    }
+    return res;
+}
+
+/**
+ * @brief Any NaN?
+ */
+template <typename T, std::size_t N>
+__attribute__((always_inline))
+inline bool isnan(const multi_dualnum<T, N>& x)
+{
+    bool res = pre::isnan(x.real());
+    for (const T& b : x.dual()) {
+        res = res || pre::isnan(b);
+    }
+    return res;
+}
+
+/**
+ * @brief All finite?
+ */
+template <typename T, std::size_t N>
+__attribute__((always_inline))
+inline bool isfinite(const multi_dualnum<T, N>& x)
+{
+    bool res = pre::isfinite(x.real());
+    for (const T& b : x.dual()) {
+        res = res && pre::isfinite(b);
+    }
+    return res;
+}
+
+/**
+ * @brief All normal?
+ */
+template <typename T, std::size_t N>
+__attribute__((always_inline))
+inline bool isnormal(const multi_dualnum<T, N>& x)
+{
+    bool res = pre::isnormal(x.real());
+    for (const T& b : x.dual()) {
+        res = res && pre::isnormal(b);
+    }
+    return res;
+}
+
+/**@}*/
+
+/**@}*/
+
+} // namespace pre
+
+#if !DOXYGEN
+#include "multi_dualnum.inl"
+#endif // #if !DOXYGEN
+
+#endif // #ifndef PREFORM_MULTI_DUALNUM_HPP
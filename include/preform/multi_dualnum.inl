@@ -0,0 +1,502 @@
+/* Copyright (c) 2018-20 M. Grady Saunders
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *   1. Redistributions of source code must retain the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer.
+ * 
+ *   2. Redistributions in binary form must reproduce the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer in the documentation and/or other materials
+ *      provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*+-+*/
+// A ruby script generates this file, DO NOT EDIT
+
+namespace pre {
+
+/**
+ * @addtogroup multi_dualnum
+ */
+/**@{*/
+
+/**
+ * @name Math (multi_dualnum)
+ *
+ * @f[
+ *      f(a + \varepsilon_k b_k) =
+ *      f(a) + \varepsilon_k f'(a) b_k
+ * @f]
+ */
+/**@{*/
+
+/**
+ * @brief Multi-dual number implementation of `pre::exp()`.
+ */
+template <typename T, std::size_t N>
+__attribute__((always_inline))
+inline multi_dualnum<T, N> exp(const multi_dualnum<T, N>& x)
+{
+    T d = pre::exp(x.real());
+    return {
+        pre::exp(x.real()),
+        x.dual() * d
+    };
+}
+
+/**
+ * @brief Multi-dual number implementation of `pre::log()`.
+ */
+template <typename T, std::size_t N>
+__attribute__((always_inline))
+inline multi_dualnum<T, N> log(const multi_dualnum<T, N>& x)
+{
+    T d = T(1) / x.real();
+    return {
+        pre::log(x.real()),
+        x.dual() * d
+    };
+}
+
+/**
+ * @brief Multi-dual number implementation of `pre::exp2()`.
+ */
+template <typename T, std::size_t N>
+__attribute__((always_inline))
+inline multi_dualnum<T, N> exp2(const multi_dualnum<T, N>& x)
+{
+    T d = pre::numeric_constants<T>::M_ln2() * pre::exp2(x.real());
+    return {
+        pre::exp2(x.real()),
+        x.dual() * d
+    };
+}
+
+/**
+ * @brief Multi-dual number implementation of `pre::log2()`.
+ */
+template <typename T, std::size_t N>
+__attribute__((always_inline))
+inline multi_dualnum<T, N> log2(const multi_dualnum<T, N>& x)
+{
+    T d = T(1) / (pre::numeric_constants<T>::M_ln2() * x.real());
+    return {
+        pre::log2(x.real()),
+        x.dual() * d
+    };
+}
+
+/**
+ * @brief Multi-dual number implementation of `pre::log10()`.
+ */
+template <typename T, std::size_t N>
+__attribute__((always_inline))
+inline multi_dualnum<T, N> log10(const multi_dualnum<T, N>& x)
+{
+    T d = T(1) / (pre::numeric_constants<T>::M_ln10() * x.real());
+    return {
+        pre::log10(x.real()),
+        x.dual() * d
+    };
+}
+
+/**
+ * @brief Multi-dual number implementation of `pre::expm1()`.
+ */
+template <typename T, std::size_t N>
+__attribute__((always_inline))
+inline multi_dualnum<T, N> expm1(const multi_dualnum<T, N>& x)
+{
+    T d = pre::exp(x.real());
+    return {
+        pre::expm1(x.real()),
+        x.dual() * d
+    };
+}
+
+/**
+ * @brief Multi-dual number implementation of `pre::log1p()`.
+ */
+template <typename T, std::size_t N>
+__attribute__((always_inline))
+inline multi_dualnum<T, N> log1p(const multi_dualnum<T, N>& x)
+{
+    T d = T(1) / (T(1) + x.real());
+    return {
+        pre::log1p(x.real()),
+        x.dual() * d
+    };
+}
+
+/**
+ * @brief Multi-dual number implementation of `pre::sqrt()`.
+ */
+template <typename T, std::size_t N>
+__attribute__((always_inline))
+inline multi_dualnum<T, N> sqrt(const multi_dualnum<T, N>& x)
+{
+    T d = T(1) / (T(2) * pre::sqrt(x.real()));
+    return {
+        pre::sqrt(x.real()),
+        x.dual() * d
+    };
+}
+
+/**
+ * @brief Multi-dual number implementation of `pre::cbrt()`.
+ */
+template <typename T, std::size_t N>
+__attribute__((always_inline))
+inline multi_dualnum<T, N> cbrt(const multi_dualnum<T, N>& x)
+{
+    T d = T(1) / (T(3) * pre::nthpow(pre::cbrt(x.real()), 2));
+    return {
+        pre::cbrt(x.real()),
+        x.dual() * d
+    };
+}
+
+/**
+ * @brief Multi-dual number implementation of `pre::erf()`.
+ */
+template <typename T, std::size_t N>
+__attribute__((always_inline))
+inline multi_dualnum<T, N> erf(const multi_dualnum<T, N>& x)
+{
+    T d = pre::numeric_constants<T>::M_2_sqrtpi() * pre::exp(-pre::nthpow(x.real(), 2));
+    return {
+        pre::erf(x.real()),
+        x.dual() * d
+    };
+}
+
+/**
+ * @brief Multi-dual number implementation of `pre::erfc()`.
+ */
+template <typename T, std::size_t N>
+__attribute__((always_inline))
+inline multi_dualnum<T, N> erfc(const multi_dualnum<T, N>& x)
+{
+    T d = -pre::numeric_constants<T>::M_2_sqrtpi() * pre::exp(-pre::nthpow(x.real(), 2));
+    return {
+        pre::erfc(x.real()),
+        x.dual() * d
+    };
+}
+
+/**
+ * @brief Multi-dual number implementation of `pre::sin()`.
+ */
+template <typename T, std::size_t N>
+__attribute__((always_inline))
+inline multi_dualnum<T, N> sin(const multi_dualnum<T, N>& x)
+{
+    T d = pre::cos(x.real());
+    return {
+        pre::sin(x.real()),
+        x.dual() * d
+    };
+}
+
+/**
+ * @brief Multi-dual number implementation of `pre::cos()`.
+ */
+template <typename T, std::size_t N>
+__attribute__((always_inline))
+inline multi_dualnum<T, N> cos(const multi_dualnum<T, N>& x)
+{
+    T d = -pre::sin(x.real());
+    return {
+        pre::cos(x.real()),
+        x.dual() * d
+    };
+}
+
+/**
+ * @brief Multi-dual number implementation of `pre::tan()`.
+ */
+template <typename T, std::size_t N>
+__attribute__((always_inline))
+inline multi_dualnum<T, N> tan(const multi_dualnum<T, N>& x)
+{
+    T d = T(1) / pre::nthpow(pre::cos(x.real()), 2);
+    return {
+        pre::tan(x.real()),
+        x.dual() * d
+    };
+}
+
+/**
+ * @brief Multi-dual number implementation of `pre::asin()`.
+ */
+template <typename T, std::size_t N>
+__attribute__((always_inline))
+inline multi_dualnum<T, N> asin(const multi_dualnum<T, N>& x)
+{
+    T d = T(1) / pre::sqrt(T(1) - pre::nthpow(x.real(), 2));
+    return {
+        pre::asin(x.real()),
+        x.dual() * d
+    };
+}
+
+/**
+ * @brief Multi-dual number implementation of `pre::acos()`.
+ */
+template <typename T, std::size_t N>
+__attribute__((always_inline))
+inline multi_dualnum<T, N> acos(const multi_dualnum<T, N>& x)
+{
+    T d = T(1) / -pre::sqrt(T(1) - pre::nthpow(x.real(), 2));
+    return {
+        pre::acos(x.real()),
+        x.dual() * d
+    };
+}
+
+/**
+ * @brief Multi-dual number implementation of `pre::atan()`.
+ */
+template <typename T, std::size_t N>
+__attribute__((always_inline))
+inline multi_dualnum<T, N> atan(const multi_dualnum<T, N>& x)
+{
+    T d = T(1) / (T(1) + pre::nthpow(x.real(), 2));
+    return {
+        pre::atan(x.real()),
+        x.dual() * d
+    };
+}
+
+/**
+ * @brief Multi-dual number implementation of `pre::sinh()`.
+ */
+template <typename T, std::size_t N>
+__attribute__((always_inline))
+inline multi_dualnum<T, N> sinh(const multi_dualnum<T, N>& x)
+{
+    T d = pre::cosh(x.real());
+    return {
+        pre::sinh(x.real()),
+        x.dual() * d
+    };
+}
+
+/**
+ * @brief Multi-dual number implementation of `pre::cosh()`.
+ */
+template <typename T, std::size_t N>
+__attribute__((always_inline))
+inline multi_dualnum<T, N> cosh(const multi_dualnum<T, N>& x)
+{
+    T d = pre::sinh(x.real());
+    return {
+        pre::cosh(x.real()),
+        x.dual() * d
+    };
+}
+
+/**
+ * @brief Multi-dual number implementation of `pre::tanh()`.
+ */
+template <typename T, std::size_t N>
+__attribute__((always_inline))
+inline multi_dualnum<T, N> tanh(const multi_dualnum<T, N>& x)
+{
+    T d = T(1) / pre::nthpow(pre::cosh(x.real()), 2);
+    return {
+        pre::tanh(x.real()),
+        x.dual() * d
+    };
+}
+
+/**
+ * @brief Multi-dual number implementation of `pre::asinh()`.
+ */
+template <typename T, std::size_t N>
+__attribute__((always_inline))
+inline multi_dualnum<T, N> asinh(const multi_dualnum<T, N>& x)
+{
+    T d = T(1) / pre::sqrt(pre::nthpow(x.real(), 2) + T(1));
+    return {
+        pre::asinh(x.real()),
+        x.dual() * d
+    };
+}
+
+/**
+ * @brief Multi-dual number implementation of `pre::acosh()`.
+ */
+template <typename T, std::size_t N>
+__attribute__((always_inline))
+inline multi_dualnum<T, N> acosh(const multi_dualnum<T, N>& x)
+{
+    T d = T(1) / pre::sqrt(pre::nthpow(x.real(), 2) - T(1));
+    return {
+        pre::acosh(x.real()),
+        x.dual() * d
+    };
+}
+
+/**
+ * @brief Multi-dual number implementation of `pre::atanh()`.
+ */
+template <typename T, std::size_t N>
+__attribute__((always_inline))
+inline multi_dualnum<T, N> atanh(const multi_dualnum<T, N>& x)
+{
+    T d = T(1) / (T(1) - pre::nthpow(x.real(), 2));
+    return {
+        pre::atanh(x.real()),
+        x.dual() * d
+    };
+}
+
+/**@}*/
+
+/**
+ * @name Reciprocal trigonometric functions (multi_dualnum)
+ */
+/**@{*/
+
+/**
+ * @brief Reciprocal of `pre::sin()`.
+ */
+template <typename T, std::size_t N>
+__attribute__((always_inline))
+inline multi_dualnum<T, N> csc(const multi_dualnum<T, N>& x)
+{
+    return T(1) / pre::sin(x);
+}
+
+/**
+ * @brief Reciprocal of `pre::cos()`.
+ */
+template <typename T, std::size_t N>
+__attribute__((always_inline))
+inline multi_dualnum<T, N> sec(const multi_dualnum<T, N>& x)
+{
+    return T(1) / pre::cos(x);
+}
+
+/**
+ * @brief Reciprocal of `pre::tan()`.
+ */
+template <typename T, std::size_t N>
+__attribute__((always_inline))
+inline multi_dualnum<T, N> cot(const multi_dualnum<T, N>& x)
+{
+    return T(1) / pre::tan(x);
+}
+
+/**
+ * @brief Reciprocal of `pre::sinh()`.
+ */
+template <typename T, std::size_t N>
+__attribute__((always_inline))
+inline multi_dualnum<T, N> csch(const multi_dualnum<T, N>& x)
+{
+    return T(1) / pre::sinh(x);
+}
+
+/**
+ * @brief Reciprocal of `pre::cosh()`.
+ */
+template <typename T, std::size_t N>
+__attribute__((always_inline))
+inline multi_dualnum<T, N> sech(const multi_dualnum<T, N>& x)
+{
+    return T(1) / pre::cosh(x);
+}
+
+/**
+ * @brief Reciprocal of `pre::tanh()`.
+ */
+template <typename T, std::size_t N>
+__attribute__((always_inline))
+inline multi_dualnum<T, N> coth(const multi_dualnum<T, N>& x)
+{
+    return T(1) / pre::tanh(x);
+}
+
+/**
+ * @brief Inverse of `pre::csc()`.
+ */
+template <typename T, std::size_t N>
+__attribute__((always_inline))
+inline multi_dualnum<T, N> acsc(const multi_dualnum<T, N>& x)
+{
+    return pre::asin(T(1) / x);
+}
+
+/**
+ * @brief Inverse of `pre::sec()`.
+ */
+template <typename T, std::size_t N>
+__attribute__((always_inline))
+inline multi_dualnum<T, N> asec(const multi_dualnum<T, N>& x)
+{
+    return pre::acos(T(1) / x);
+}
+
+/**
+ * @brief Inverse of `pre::cot()`.
+ */
+template <typename T, std::size_t N>
+__attribute__((always_inline))
+inline multi_dualnum<T, N> acot(const multi_dualnum<T, N>& x)
+{
+    return pre::atan(T(1) / x);
+}
+
+/**
+ * @brief Inverse of `pre::csch()`.
+ */
+template <typename T, std::size_t N>
+__attribute__((always_inline))
+inline multi_dualnum<T, N> acsch(const multi_dualnum<T, N>& x)
+{
+    return pre::asinh(T(1) / x);
+}
+
+/**
+ * @brief Inverse of `pre::sech()`.
+ */
+template <typename T, std::size_t N>
+__attribute__((always_inline))
+inline multi_dualnum<T, N> asech(const multi_dualnum<T, N>& x)
+{
+    return pre::acosh(T(1) / x);
+}
+
+/**
+ * @brief Inverse of `pre::coth()`.
+ */
+template <typename T, std::size_t N>
+__attribute__((always_inline))
+inline multi_dualnum<T, N> acoth(const multi_dualnum<T, N>& x)
+{
+    return pre::atanh(T(1) / x);
+}
+
+/**@}*/
+
+/**@}*/
+
+} // namespace pre
+
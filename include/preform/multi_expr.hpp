@@ -0,0 +1,441 @@
+/* Copyright (c) 2018-20 M. Grady Saunders
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer.
+ *
+ *   2. Redistributions in binary form must reproduce the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer in the documentation and/or other materials
+ *      provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#if !DOXYGEN
+#if !(__cplusplus >= 201703L)
+#error "preform/multi_expr.hpp requires >=C++17"
+#endif // #if !(__cplusplus >= 201703L)
+#endif // #if !DOXYGEN
+#pragma once
+#ifndef PREFORM_MULTI_EXPR_HPP
+#define PREFORM_MULTI_EXPR_HPP
+
+// for std::size_t
+#include <cstddef>
+
+// for std::tuple, std::get
+#include <tuple>
+
+// for std::decay_t, std::enable_if_t, std::is_same, ...
+#include <type_traits>
+
+// for std::declval, std::index_sequence, ...
+#include <utility>
+
+// for pre::multi
+#include <preform/multi.hpp>
+
+namespace pre {
+
+/**
+ * @defgroup multi_expr Multi-dimensional array (expressions)
+ *
+ * `<preform/multi_expr.hpp>`
+ *
+ * __C++ version__: >=C++17
+ *
+ * Opt-in lazy arithmetic for `multi`. Wrapping any operand in
+ * `lazy()` makes the operators build an expression instead of
+ * an array, so that
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * res = pre::lazy(a) * b + pre::lazy(c) * d - e;
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * evaluates one loop over `res`, without the four temporary arrays
+ * of the eager operators. Expressions also convert implicitly
+ * to `multi`, or explicitly with `eval()`, and fuse into the
+ * compound assignment operators.
+ *
+ * @note
+ * Expressions hold `multi` operands by reference, so evaluate
+ * them before the operands go out of scope. Temporary `multi`
+ * operands, e.g., the eager result in `lazy(a) * (b + c)`, do not
+ * compile, so write `lazy(a) * (lazy(b) + c)` instead. Every operator
+ * is entry-wise, hence assigning an expression to one of its own
+ * operands is safe.
+ */
+/**@{*/
+
+template <typename F, typename... E>
+class multi_expr;
+
+#if !DOXYGEN
+
+template <typename F, typename... E>
+struct is_multi_expr<multi_expr<F, E...>> : std::true_type
+{
+};
+
+template <typename U, typename S>
+struct multi_expr_rebind_;
+
+template <typename U, std::size_t... N>
+struct multi_expr_rebind_<U, std::index_sequence<N...>>
+{
+    using type = multi<U, N...>;
+};
+
+template <typename... E>
+struct multi_expr_shape_
+{
+    using type = void;
+};
+
+template <typename E, typename... Es>
+struct multi_expr_shape_<E, Es...>
+{
+    using type =
+        std::conditional_t<std::is_void<typename E::shape_type>::value,
+            typename multi_expr_shape_<Es...>::type,
+            typename E::shape_type>;
+};
+
+// Entry-by-index into multi, by nested subscripts.
+template <typename T, typename I, typename... Is>
+__attribute__((always_inline))
+constexpr decltype(auto) multi_expr_index_(T& arr, I i, Is... is)
+{
+    if constexpr (sizeof...(Is) == 0) {
+        return arr[i];
+    }
+    else {
+        return multi_expr_index_(arr[i], is...);
+    }
+}
+
+// Leaf referencing multi.
+template <typename T, std::size_t... N>
+struct multi_expr_ref_
+{
+    using entry_type = T;
+
+    using shape_type = std::index_sequence<N...>;
+
+    template <typename... I>
+    __attribute__((always_inline))
+    constexpr const T& at(I... i) const
+    {
+        return multi_expr_index_(*ptr, i...);
+    }
+
+    const multi<T, N...>* ptr;
+};
+
+// Leaf holding entry, broadcast to every index.
+template <typename T>
+struct multi_expr_val_
+{
+    using entry_type = T;
+
+    using shape_type = void;
+
+    template <typename... I>
+    __attribute__((always_inline))
+    constexpr const T& at(I...) const
+    {
+        return val;
+    }
+
+    T val;
+};
+
+struct multi_expr_identity_
+{
+    template <typename T>
+    __attribute__((always_inline))
+    constexpr T operator()(const T& x) const
+    {
+        return x;
+    }
+};
+
+// Wrap operand as expression node.
+template <typename F, typename... E>
+__attribute__((always_inline))
+constexpr const multi_expr<F, E...>& multi_expr_wrap_(
+                const multi_expr<F, E...>& expr)
+{
+    return expr;
+}
+
+template <typename T, std::size_t... N>
+__attribute__((always_inline))
+constexpr multi_expr_ref_<T, N...> multi_expr_wrap_(
+                const multi<T, N...>& arr)
+{
+    return {&arr};
+}
+
+template <typename T>
+__attribute__((always_inline))
+constexpr std::enable_if_t<
+                !is_multi<T>::value &&
+                !is_multi_expr<T>::value,
+                multi_expr_val_<T>> multi_expr_wrap_(const T& val)
+{
+    return {val};
+}
+
+template <typename T>
+using multi_expr_wrap_t_ =
+        std::decay_t<decltype(multi_expr_wrap_(std::declval<const T&>()))>;
+
+#endif // #if !DOXYGEN
+
+/**
+ * @brief Lazy expression.
+ *
+ * Applies the functor `F` entry-wise to the operands `E...`, each
+ * of which is either another expression, a reference to a `multi`,
+ * or a broadcast entry. Nothing is computed until the expression
+ * is assigned or evaluated.
+ *
+ * @tparam F
+ * Functor.
+ *
+ * @tparam E
+ * Operand types.
+ */
+template <typename F, typename... E>
+class multi_expr
+{
+public:
+
+    /**
+     * @brief Entry type.
+     */
+    typedef std::decay_t<decltype(std::declval<const F&>()(
+            std::declval<typename E::entry_type>()...))> entry_type;
+
+    /**
+     * @brief Shape type, `std::index_sequence<N...>`.
+     */
+    typedef typename multi_expr_shape_<E...>::type shape_type;
+
+    /**
+     * @brief Multi type.
+     */
+    typedef typename
+            multi_expr_rebind_<entry_type, shape_type>::type multi_type;
+
+    static_assert(!std::is_void<shape_type>::value,
+        "multi_expr needs at least one multi operand");
+
+    static_assert(
+        ((std::is_void<typename E::shape_type>::value ||
+          std::is_same<typename E::shape_type, shape_type>::value) && ...),
+        "multi_expr operands must have same shape");
+
+public:
+
+    /**
+     * @brief Constructor.
+     */
+    __attribute__((always_inline))
+    constexpr multi_expr(const F& func, const E&... args) :
+            func_(func),
+            args_(args...)
+    {
+    }
+
+    /**
+     * @brief Entry at index.
+     *
+     * @param[in] i
+     * Index, one per dimension.
+     */
+    template <typename... I>
+    __attribute__((always_inline))
+    constexpr entry_type at(I... i) const
+    {
+        return at_(std::index_sequence_for<E...>(), i...);
+    }
+
+    /**
+     * @brief Evaluate.
+     */
+    __attribute__((always_inline))
+    constexpr multi_type eval() const
+    {
+        multi_type res;
+        assign_to(res);
+        return res;
+    }
+
+    /**
+     * @brief Evaluate, implicit cast.
+     */
+    __attribute__((always_inline))
+    constexpr operator multi_type() const
+    {
+        return eval();
+    }
+
+    /**
+     * @brief Assign, fused into one loop over `arr`.
+     */
+    template <typename Arr>
+    __attribute__((always_inline))
+    constexpr void assign_to(Arr& arr) const
+    {
+        apply_to(arr, [](auto& x, const entry_type& y) { x = y; });
+    }
+
+    /**
+     * @brief Apply `func(arr[i...], at(i...))` at every index.
+     *
+     * The compound assignment operators are implemented in terms
+     * of this.
+     */
+    template <typename Arr, typename G>
+    __attribute__((always_inline))
+    constexpr void apply_to(Arr& arr, G&& func) const
+    {
+        static_assert(
+            std::is_same<Arr, typename multi_expr_rebind_<
+                typename Arr::entry_type, shape_type>::type>::value,
+            "multi_expr assigned to multi of different shape");
+        apply_to_(arr, func);
+    }
+
+private:
+
+    /**
+     * @brief Functor.
+     */
+    F func_;
+
+    /**
+     * @brief Operands.
+     */
+    std::tuple<E...> args_;
+
+    /**
+     * @brief Entry at index, implementation.
+     */
+    template <std::size_t... J, typename... I>
+    __attribute__((always_inline))
+    constexpr entry_type at_(std::index_sequence<J...>, I... i) const
+    {
+        return func_(std::get<J>(args_).at(i...)...);
+    }
+
+    /**
+     * @brief Apply, implementation.
+     */
+    template <typename Arr, typename G, typename... I>
+    __attribute__((always_inline))
+    constexpr void apply_to_(Arr& arr, G& func, I... i) const
+    {
+        for (std::size_t k = 0; k < arr.size(); k++) {
+            if constexpr (is_multi<std::decay_t<decltype(arr[k])>>::value) {
+                apply_to_(arr[k], func, i..., k);
+            }
+            else {
+                func(arr[k], at(i..., k));
+            }
+        }
+    }
+};
+
+/**
+ * @brief Wrap `multi` as lazy expression.
+ */
+template <typename T, std::size_t... N>
+__attribute__((always_inline))
+constexpr multi_expr<multi_expr_identity_, multi_expr_ref_<T, N...>> lazy(
+                const multi<T, N...>& arr)
+{
+    return {multi_expr_identity_(), {&arr}};
+}
+
+/**
+ * @brief Wrap temporary `multi`, deleted, as the expression would
+ * reference it after destruction.
+ */
+template <typename T, std::size_t... N>
+void lazy(multi<T, N...>&& arr) = delete;
+
+/**
+ * @brief Wrap lazy expression, no-op so that `lazy()` is idempotent.
+ */
+template <typename F, typename... E>
+__attribute__((always_inline))
+constexpr const multi_expr<F, E...>& lazy(const multi_expr<F, E...>& expr)
+{
+    return expr;
+}
+
+/**
+ * @brief Evaluate lazy expression.
+ */
+template <typename F, typename... E>
+__attribute__((always_inline))
+constexpr typename multi_expr<F, E...>::multi_type eval(
+                const multi_expr<F, E...>& expr)
+{
+    return expr.eval();
+}
+
+/**
+ * @brief Lazy entry-wise function application.
+ *
+ * For functions without an operator, e.g.,
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * res = pre::lazy_apply([](double x, double y) {
+ *     return pre::fma(x, y, 1.0);
+ * }, a, pre::lazy(b) * 2);
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ *
+ * @param[in] func
+ * Function.
+ *
+ * @param[in] args
+ * Arguments, each of which is a `multi`, an expression, or an
+ * entry to broadcast. Temporary `multi` arguments are rejected, as
+ * the expression would reference them after destruction.
+ */
+template <typename F, typename... Args>
+__attribute__((always_inline))
+constexpr multi_expr<std::decay_t<F>, multi_expr_wrap_t_<Args>...>
+                lazy_apply(F&& func, Args&&... args)
+{
+    static_assert(
+        ((!is_multi<std::decay_t<Args>>::value ||
+          std::is_lvalue_reference<Args>::value) && ...),
+        "lazy_apply would reference temporary multi");
+    return {std::forward<F>(func), multi_expr_wrap_(args)...};
+}
+
+/**@}*/
+
+} // namespace pre
+
+#if !DOXYGEN
+#include "multi_expr.inl"
+#endif // #if !DOXYGEN
+
+#endif // #ifndef PREFORM_MULTI_EXPR_HPP
@@ -0,0 +1,2104 @@
+/* Copyright (c) 2018-20 M. Grady Saunders
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *   1. Redistributions of source code must retain the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer.
+ * 
+ *   2. Redistributions in binary form must reproduce the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer in the documentation and/or other materials
+ *      provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*+-+*/
+// A ruby script generates this file, DO NOT EDIT
+
+namespace pre {
+
+#if !DOXYGEN
+
+struct multi_expr_unary_plus_
+{
+    template <typename T>
+    __attribute__((always_inline))
+    constexpr auto operator()(const T& x) const
+    {
+        return +x;
+    }
+};
+
+struct multi_expr_negate_
+{
+    template <typename T>
+    __attribute__((always_inline))
+    constexpr auto operator()(const T& x) const
+    {
+        return -x;
+    }
+};
+
+struct multi_expr_bit_not_
+{
+    template <typename T>
+    __attribute__((always_inline))
+    constexpr auto operator()(const T& x) const
+    {
+        return ~x;
+    }
+};
+
+struct multi_expr_logical_not_
+{
+    template <typename T>
+    __attribute__((always_inline))
+    constexpr auto operator()(const T& x) const
+    {
+        return !x;
+    }
+};
+
+struct multi_expr_plus_
+{
+    template <typename T, typename U>
+    __attribute__((always_inline))
+    constexpr auto operator()(const T& x, const U& y) const
+    {
+        return x + y;
+    }
+};
+
+struct multi_expr_minus_
+{
+    template <typename T, typename U>
+    __attribute__((always_inline))
+    constexpr auto operator()(const T& x, const U& y) const
+    {
+        return x - y;
+    }
+};
+
+struct multi_expr_multiplies_
+{
+    template <typename T, typename U>
+    __attribute__((always_inline))
+    constexpr auto operator()(const T& x, const U& y) const
+    {
+        return x * y;
+    }
+};
+
+struct multi_expr_divides_
+{
+    template <typename T, typename U>
+    __attribute__((always_inline))
+    constexpr auto operator()(const T& x, const U& y) const
+    {
+        return x / y;
+    }
+};
+
+struct multi_expr_modulus_
+{
+    template <typename T, typename U>
+    __attribute__((always_inline))
+    constexpr auto operator()(const T& x, const U& y) const
+    {
+        return x % y;
+    }
+};
+
+struct multi_expr_bit_and_
+{
+    template <typename T, typename U>
+    __attribute__((always_inline))
+    constexpr auto operator()(const T& x, const U& y) const
+    {
+        return x & y;
+    }
+};
+
+struct multi_expr_bit_or_
+{
+    template <typename T, typename U>
+    __attribute__((always_inline))
+    constexpr auto operator()(const T& x, const U& y) const
+    {
+        return x | y;
+    }
+};
+
+struct multi_expr_bit_xor_
+{
+    template <typename T, typename U>
+    __attribute__((always_inline))
+    constexpr auto operator()(const T& x, const U& y) const
+    {
+        return x ^ y;
+    }
+};
+
+struct multi_expr_shift_right_
+{
+    template <typename T, typename U>
+    __attribute__((always_inline))
+    constexpr auto operator()(const T& x, const U& y) const
+    {
+        return x >> y;
+    }
+};
+
+struct multi_expr_shift_left_
+{
+    template <typename T, typename U>
+    __attribute__((always_inline))
+    constexpr auto operator()(const T& x, const U& y) const
+    {
+        return x << y;
+    }
+};
+
+struct multi_expr_equal_to_
+{
+    template <typename T, typename U>
+    __attribute__((always_inline))
+    constexpr auto operator()(const T& x, const U& y) const
+    {
+        return x == y;
+    }
+};
+
+struct multi_expr_not_equal_to_
+{
+    template <typename T, typename U>
+    __attribute__((always_inline))
+    constexpr auto operator()(const T& x, const U& y) const
+    {
+        return x != y;
+    }
+};
+
+struct multi_expr_less_
+{
+    template <typename T, typename U>
+    __attribute__((always_inline))
+    constexpr auto operator()(const T& x, const U& y) const
+    {
+        return x < y;
+    }
+};
+
+struct multi_expr_greater_
+{
+    template <typename T, typename U>
+    __attribute__((always_inline))
+    constexpr auto operator()(const T& x, const U& y) const
+    {
+        return x > y;
+    }
+};
+
+struct multi_expr_less_equal_
+{
+    template <typename T, typename U>
+    __attribute__((always_inline))
+    constexpr auto operator()(const T& x, const U& y) const
+    {
+        return x <= y;
+    }
+};
+
+struct multi_expr_greater_equal_
+{
+    template <typename T, typename U>
+    __attribute__((always_inline))
+    constexpr auto operator()(const T& x, const U& y) const
+    {
+        return x >= y;
+    }
+};
+
+struct multi_expr_logical_and_
+{
+    template <typename T, typename U>
+    __attribute__((always_inline))
+    constexpr auto operator()(const T& x, const U& y) const
+    {
+        return x && y;
+    }
+};
+
+struct multi_expr_logical_or_
+{
+    template <typename T, typename U>
+    __attribute__((always_inline))
+    constexpr auto operator()(const T& x, const U& y) const
+    {
+        return x || y;
+    }
+};
+
+#endif // #if !DOXYGEN
+
+/**
+ * @addtogroup multi_expr
+ */
+/**@{*/
+
+/**
+ * @name Unary operators (multi_expr)
+ */
+/**@{*/
+
+/**
+ * @brief Lazy `operator+`.
+ */
+template <typename F, typename... E>
+__attribute__((always_inline))
+constexpr multi_expr<multi_expr_unary_plus_, multi_expr<F, E...>>
+                operator+(const multi_expr<F, E...>& expr)
+{
+    return {multi_expr_unary_plus_(), expr};
+}
+
+/**
+ * @brief Lazy `operator-`.
+ */
+template <typename F, typename... E>
+__attribute__((always_inline))
+constexpr multi_expr<multi_expr_negate_, multi_expr<F, E...>>
+                operator-(const multi_expr<F, E...>& expr)
+{
+    return {multi_expr_negate_(), expr};
+}
+
+/**
+ * @brief Lazy `operator~`.
+ */
+template <typename F, typename... E>
+__attribute__((always_inline))
+constexpr multi_expr<multi_expr_bit_not_, multi_expr<F, E...>>
+                operator~(const multi_expr<F, E...>& expr)
+{
+    return {multi_expr_bit_not_(), expr};
+}
+
+/**
+ * @brief Lazy `operator!`.
+ */
+template <typename F, typename... E>
+__attribute__((always_inline))
+constexpr multi_expr<multi_expr_logical_not_, multi_expr<F, E...>>
+                operator!(const multi_expr<F, E...>& expr)
+{
+    return {multi_expr_logical_not_(), expr};
+}
+
+/**@}*/
+
+/**
+ * @name Binary operators (multi_expr)
+ */
+/**@{*/
+
+/**
+ * @brief Lazy `operator+` (multi_expr/multi_expr).
+ */
+template <
+    typename F0, typename... E0,
+    typename F1, typename... E1
+    >
+__attribute__((always_inline))
+constexpr multi_expr<multi_expr_plus_,
+                multi_expr<F0, E0...>,
+                multi_expr<F1, E1...>> operator+(
+                    const multi_expr<F0, E0...>& expr0,
+                    const multi_expr<F1, E1...>& expr1)
+{
+    return {multi_expr_plus_(), expr0, expr1};
+}
+
+/**
+ * @brief Lazy `operator+` (multi_expr/multi).
+ */
+template <typename F, typename... E, typename U, std::size_t... N>
+__attribute__((always_inline))
+constexpr multi_expr<multi_expr_plus_,
+                multi_expr<F, E...>,
+                multi_expr_ref_<U, N...>> operator+(
+                    const multi_expr<F, E...>& expr,
+                    const multi<U, N...>& arr)
+{
+    return {multi_expr_plus_(), expr, {&arr}};
+}
+
+/**
+ * @brief Lazy `operator+` (multi/multi_expr).
+ */
+template <typename T, std::size_t... N, typename F, typename... E>
+__attribute__((always_inline))
+constexpr multi_expr<multi_expr_plus_,
+                multi_expr_ref_<T, N...>,
+                multi_expr<F, E...>> operator+(
+                    const multi<T, N...>& arr,
+                    const multi_expr<F, E...>& expr)
+{
+    return {multi_expr_plus_(), {&arr}, expr};
+}
+
+#if !DOXYGEN
+
+template <typename F, typename... E, typename U, std::size_t... N>
+void operator+(
+                const multi_expr<F, E...>& expr,
+                multi<U, N...>&& arr) = delete;
+
+template <typename T, std::size_t... N, typename F, typename... E>
+void operator+(
+                multi<T, N...>&& arr,
+                const multi_expr<F, E...>& expr) = delete;
+
+#endif // #if !DOXYGEN
+
+/**
+ * @brief Lazy `operator+` (multi_expr/entry).
+ */
+template <typename F, typename... E, typename U>
+__attribute__((always_inline))
+constexpr std::enable_if_t<
+                !is_multi<U>::value &&
+                !is_multi_expr<U>::value,
+                multi_expr<multi_expr_plus_,
+                    multi_expr<F, E...>,
+                    multi_expr_val_<U>>> operator+(
+                        const multi_expr<F, E...>& expr, const U& val)
+{
+    return {multi_expr_plus_(), expr, {val}};
+}
+
+/**
+ * @brief Lazy `operator+` (entry/multi_expr).
+ */
+template <typename T, typename F, typename... E>
+__attribute__((always_inline))
+constexpr std::enable_if_t<
+                !is_multi<T>::value &&
+                !is_multi_expr<T>::value,
+                multi_expr<multi_expr_plus_,
+                    multi_expr_val_<T>,
+                    multi_expr<F, E...>>> operator+(
+                        const T& val, const multi_expr<F, E...>& expr)
+{
+    return {multi_expr_plus_(), {val}, expr};
+}
+
+/**
+ * @brief Lazy `operator-` (multi_expr/multi_expr).
+ */
+template <
+    typename F0, typename... E0,
+    typename F1, typename... E1
+    >
+__attribute__((always_inline))
+constexpr multi_expr<multi_expr_minus_,
+                multi_expr<F0, E0...>,
+                multi_expr<F1, E1...>> operator-(
+                    const multi_expr<F0, E0...>& expr0,
+                    const multi_expr<F1, E1...>& expr1)
+{
+    return {multi_expr_minus_(), expr0, expr1};
+}
+
+/**
+ * @brief Lazy `operator-` (multi_expr/multi).
+ */
+template <typename F, typename... E, typename U, std::size_t... N>
+__attribute__((always_inline))
+constexpr multi_expr<multi_expr_minus_,
+                multi_expr<F, E...>,
+                multi_expr_ref_<U, N...>> operator-(
+                    const multi_expr<F, E...>& expr,
+                    const multi<U, N...>& arr)
+{
+    return {multi_expr_minus_(), expr, {&arr}};
+}
+
+/**
+ * @brief Lazy `operator-` (multi/multi_expr).
+ */
+template <typename T, std::size_t... N, typename F, typename... E>
+__attribute__((always_inline))
+constexpr multi_expr<multi_expr_minus_,
+                multi_expr_ref_<T, N...>,
+                multi_expr<F, E...>> operator-(
+                    const multi<T, N...>& arr,
+                    const multi_expr<F, E...>& expr)
+{
+    return {multi_expr_minus_(), {&arr}, expr};
+}
+
+#if !DOXYGEN
+
+template <typename F, typename... E, typename U, std::size_t... N>
+void operator-(
+                const multi_expr<F, E...>& expr,
+                multi<U, N...>&& arr) = delete;
+
+template <typename T, std::size_t... N, typename F, typename... E>
+void operator-(
+                multi<T, N...>&& arr,
+                const multi_expr<F, E...>& expr) = delete;
+
+#endif // #if !DOXYGEN
+
+/**
+ * @brief Lazy `operator-` (multi_expr/entry).
+ */
+template <typename F, typename... E, typename U>
+__attribute__((always_inline))
+constexpr std::enable_if_t<
+                !is_multi<U>::value &&
+                !is_multi_expr<U>::value,
+                multi_expr<multi_expr_minus_,
+                    multi_expr<F, E...>,
+                    multi_expr_val_<U>>> operator-(
+                        const multi_expr<F, E...>& expr, const U& val)
+{
+    return {multi_expr_minus_(), expr, {val}};
+}
+
+/**
+ * @brief Lazy `operator-` (entry/multi_expr).
+ */
+template <typename T, typename F, typename... E>
+__attribute__((always_inline))
+constexpr std::enable_if_t<
+                !is_multi<T>::value &&
+                !is_multi_expr<T>::value,
+                multi_expr<multi_expr_minus_,
+                    multi_expr_val_<T>,
+                    multi_expr<F, E...>>> operator-(
+                        const T& val, const multi_expr<F, E...>& expr)
+{
+    return {multi_expr_minus_(), {val}, expr};
+}
+
+/**
+ * @brief Lazy `operator*` (multi_expr/multi_expr).
+ */
+template <
+    typename F0, typename... E0,
+    typename F1, typename... E1
+    >
+__attribute__((always_inline))
+constexpr multi_expr<multi_expr_multiplies_,
+                multi_expr<F0, E0...>,
+                multi_expr<F1, E1...>> operator*(
+                    const multi_expr<F0, E0...>& expr0,
+                    const multi_expr<F1, E1...>& expr1)
+{
+    return {multi_expr_multiplies_(), expr0, expr1};
+}
+
+/**
+ * @brief Lazy `operator*` (multi_expr/multi).
+ */
+template <typename F, typename... E, typename U, std::size_t... N>
+__attribute__((always_inline))
+constexpr multi_expr<multi_expr_multiplies_,
+                multi_expr<F, E...>,
+                multi_expr_ref_<U, N...>> operator*(
+                    const multi_expr<F, E...>& expr,
+                    const multi<U, N...>& arr)
+{
+    return {multi_expr_multiplies_(), expr, {&arr}};
+}
+
+/**
+ * @brief Lazy `operator*` (multi/multi_expr).
+ */
+template <typename T, std::size_t... N, typename F, typename... E>
+__attribute__((always_inline))
+constexpr multi_expr<multi_expr_multiplies_,
+                multi_expr_ref_<T, N...>,
+                multi_expr<F, E...>> operator*(
+                    const multi<T, N...>& arr,
+                    const multi_expr<F, E...>& expr)
+{
+    return {multi_expr_multiplies_(), {&arr}, expr};
+}
+
+#if !DOXYGEN
+
+template <typename F, typename... E, typename U, std::size_t... N>
+void operator*(
+                const multi_expr<F, E...>& expr,
+                multi<U, N...>&& arr) = delete;
+
+template <typename T, std::size_t... N, typename F, typename... E>
+void operator*(
+                multi<T, N...>&& arr,
+                const multi_expr<F, E...>& expr) = delete;
+
+#endif // #if !DOXYGEN
+
+/**
+ * @brief Lazy `operator*` (multi_expr/entry).
+ */
+template <typename F, typename... E, typename U>
+__attribute__((always_inline))
+constexpr std::enable_if_t<
+                !is_multi<U>::value &&
+                !is_multi_expr<U>::value,
+                multi_expr<multi_expr_multiplies_,
+                    multi_expr<F, E...>,
+                    multi_expr_val_<U>>> operator*(
+                        const multi_expr<F, E...>& expr, const U& val)
+{
+    return {multi_expr_multiplies_(), expr, {val}};
+}
+
+/**
+ * @brief Lazy `operator*` (entry/multi_expr).
+ */
+template <typename T, typename F, typename... E>
+__attribute__((always_inline))
+constexpr std::enable_if_t<
+                !is_multi<T>::value &&
+                !is_multi_expr<T>::value,
+                multi_expr<multi_expr_multiplies_,
+                    multi_expr_val_<T>,
+                    multi_expr<F, E...>>> operator*(
+                        const T& val, const multi_expr<F, E...>& expr)
+{
+    return {multi_expr_multiplies_(), {val}, expr};
+}
+
+/**
+ * @brief Lazy `operator/` (multi_expr/multi_expr).
+ */
+template <
+    typename F0, typename... E0,
+    typename F1, typename... E1
+    >
+__attribute__((always_inline))
+constexpr multi_expr<multi_expr_divides_,
+                multi_expr<F0, E0...>,
+                multi_expr<F1, E1...>> operator/(
+                    const multi_expr<F0, E0...>& expr0,
+                    const multi_expr<F1, E1...>& expr1)
+{
+    return {multi_expr_divides_(), expr0, expr1};
+}
+
+/**
+ * @brief Lazy `operator/` (multi_expr/multi).
+ */
+template <typename F, typename... E, typename U, std::size_t... N>
+__attribute__((always_inline))
+constexpr multi_expr<multi_expr_divides_,
+                multi_expr<F, E...>,
+                multi_expr_ref_<U, N...>> operator/(
+                    const multi_expr<F, E...>& expr,
+                    const multi<U, N...>& arr)
+{
+    return {multi_expr_divides_(), expr, {&arr}};
+}
+
+/**
+ * @brief Lazy `operator/` (multi/multi_expr).
+ */
+template <typename T, std::size_t... N, typename F, typename... E>
+__attribute__((always_inline))
+constexpr multi_expr<multi_expr_divides_,
+                multi_expr_ref_<T, N...>,
+                multi_expr<F, E...>> operator/(
+                    const multi<T, N...>& arr,
+                    const multi_expr<F, E...>& expr)
+{
+    return {multi_expr_divides_(), {&arr}, expr};
+}
+
+#if !DOXYGEN
+
+template <typename F, typename... E, typename U, std::size_t... N>
+void operator/(
+                const multi_expr<F, E...>& expr,
+                multi<U, N...>&& arr) = delete;
+
+template <typename T, std::size_t... N, typename F, typename... E>
+void operator/(
+                multi<T, N...>&& arr,
+                const multi_expr<F, E...>& expr) = delete;
+
+#endif // #if !DOXYGEN
+
+/**
+ * @brief Lazy `operator/` (multi_expr/entry).
+ */
+template <typename F, typename... E, typename U>
+__attribute__((always_inline))
+constexpr std::enable_if_t<
+                !is_multi<U>::value &&
+                !is_multi_expr<U>::value,
+                multi_expr<multi_expr_divides_,
+                    multi_expr<F, E...>,
+                    multi_expr_val_<U>>> operator/(
+                        const multi_expr<F, E...>& expr, const U& val)
+{
+    return {multi_expr_divides_(), expr, {val}};
+}
+
+/**
+ * @brief Lazy `operator/` (entry/multi_expr).
+ */
+template <typename T, typename F, typename... E>
+__attribute__((always_inline))
+constexpr std::enable_if_t<
+                !is_multi<T>::value &&
+                !is_multi_expr<T>::value,
+                multi_expr<multi_expr_divides_,
+                    multi_expr_val_<T>,
+                    multi_expr<F, E...>>> operator/(
+                        const T& val, const multi_expr<F, E...>& expr)
+{
+    return {multi_expr_divides_(), {val}, expr};
+}
+
+/**
+ * @brief Lazy `operator%` (multi_expr/multi_expr).
+ */
+template <
+    typename F0, typename... E0,
+    typename F1, typename... E1
+    >
+__attribute__((always_inline))
+constexpr multi_expr<multi_expr_modulus_,
+                multi_expr<F0, E0...>,
+                multi_expr<F1, E1...>> operator%(
+                    const multi_expr<F0, E0...>& expr0,
+                    const multi_expr<F1, E1...>& expr1)
+{
+    return {multi_expr_modulus_(), expr0, expr1};
+}
+
+/**
+ * @brief Lazy `operator%` (multi_expr/multi).
+ */
+template <typename F, typename... E, typename U, std::size_t... N>
+__attribute__((always_inline))
+constexpr multi_expr<multi_expr_modulus_,
+                multi_expr<F, E...>,
+                multi_expr_ref_<U, N...>> operator%(
+                    const multi_expr<F, E...>& expr,
+                    const multi<U, N...>& arr)
+{
+    return {multi_expr_modulus_(), expr, {&arr}};
+}
+
+/**
+ * @brief Lazy `operator%` (multi/multi_expr).
+ */
+template <typename T, std::size_t... N, typename F, typename... E>
+__attribute__((always_inline))
+constexpr multi_expr<multi_expr_modulus_,
+                multi_expr_ref_<T, N...>,
+                multi_expr<F, E...>> operator%(
+                    const multi<T, N...>& arr,
+                    const multi_expr<F, E...>& expr)
+{
+    return {multi_expr_modulus_(), {&arr}, expr};
+}
+
+#if !DOXYGEN
+
+template <typename F, typename... E, typename U, std::size_t... N>
+void operator%(
+                const multi_expr<F, E...>& expr,
+                multi<U, N...>&& arr) = delete;
+
+template <typename T, std::size_t... N, typename F, typename... E>
+void operator%(
+                multi<T, N...>&& arr,
+                const multi_expr<F, E...>& expr) = delete;
+
+#endif // #if !DOXYGEN
+
+/**
+ * @brief Lazy `operator%` (multi_expr/entry).
+ */
+template <typename F, typename... E, typename U>
+__attribute__((always_inline))
+constexpr std::enable_if_t<
+                !is_multi<U>::value &&
+                !is_multi_expr<U>::value,
+                multi_expr<multi_expr_modulus_,
+                    multi_expr<F, E...>,
+                    multi_expr_val_<U>>> operator%(
+                        const multi_expr<F, E...>& expr, const U& val)
+{
+    return {multi_expr_modulus_(), expr, {val}};
+}
+
+/**
+ * @brief Lazy `operator%` (entry/multi_expr).
+ */
+template <typename T, typename F, typename... E>
+__attribute__((always_inline))
+constexpr std::enable_if_t<
+                !is_multi<T>::value &&
+                !is_multi_expr<T>::value,
+                multi_expr<multi_expr_modulus_,
+                    multi_expr_val_<T>,
+                    multi_expr<F, E...>>> operator%(
+                        const T& val, const multi_expr<F, E...>& expr)
+{
+    return {multi_expr_modulus_(), {val}, expr};
+}
+
+/**
+ * @brief Lazy `operator&` (multi_expr/multi_expr).
+ */
+template <
+    typename F0, typename... E0,
+    typename F1, typename... E1
+    >
+__attribute__((always_inline))
+constexpr multi_expr<multi_expr_bit_and_,
+                multi_expr<F0, E0...>,
+                multi_expr<F1, E1...>> operator&(
+                    const multi_expr<F0, E0...>& expr0,
+                    const multi_expr<F1, E1...>& expr1)
+{
+    return {multi_expr_bit_and_(), expr0, expr1};
+}
+
+/**
+ * @brief Lazy `operator&` (multi_expr/multi).
+ */
+template <typename F, typename... E, typename U, std::size_t... N>
+__attribute__((always_inline))
+constexpr multi_expr<multi_expr_bit_and_,
+                multi_expr<F, E...>,
+                multi_expr_ref_<U, N...>> operator&(
+                    const multi_expr<F, E...>& expr,
+                    const multi<U, N...>& arr)
+{
+    return {multi_expr_bit_and_(), expr, {&arr}};
+}
+
+/**
+ * @brief Lazy `operator&` (multi/multi_expr).
+ */
+template <typename T, std::size_t... N, typename F, typename... E>
+__attribute__((always_inline))
+constexpr multi_expr<multi_expr_bit_and_,
+                multi_expr_ref_<T, N...>,
+                multi_expr<F, E...>> operator&(
+                    const multi<T, N...>& arr,
+                    const multi_expr<F, E...>& expr)
+{
+    return {multi_expr_bit_and_(), {&arr}, expr};
+}
+
+#if !DOXYGEN
+
+template <typename F, typename... E, typename U, std::size_t... N>
+void operator&(
+                const multi_expr<F, E...>& expr,
+                multi<U, N...>&& arr) = delete;
+
+template <typename T, std::size_t... N, typename F, typename... E>
+void operator&(
+                multi<T, N...>&& arr,
+                const multi_expr<F, E...>& expr) = delete;
+
+#endif // #if !DOXYGEN
+
+/**
+ * @brief Lazy `operator&` (multi_expr/entry).
+ */
+template <typename F, typename... E, typename U>
+__attribute__((always_inline))
+constexpr std::enable_if_t<
+                !is_multi<U>::value &&
+                !is_multi_expr<U>::value,
+                multi_expr<multi_expr_bit_and_,
+                    multi_expr<F, E...>,
+                    multi_expr_val_<U>>> operator&(
+                        const multi_expr<F, E...>& expr, const U& val)
+{
+    return {multi_expr_bit_and_(), expr, {val}};
+}
+
+/**
+ * @brief Lazy `operator&` (entry/multi_expr).
+ */
+template <typename T, typename F, typename... E>
+__attribute__((always_inline))
+constexpr std::enable_if_t<
+                !is_multi<T>::value &&
+                !is_multi_expr<T>::value,
+                multi_expr<multi_expr_bit_and_,
+                    multi_expr_val_<T>,
+                    multi_expr<F, E...>>> operator&(
+                        const T& val, const multi_expr<F, E...>& expr)
+{
+    return {multi_expr_bit_and_(), {val}, expr};
+}
+
+/**
+ * @brief Lazy `operator|` (multi_expr/multi_expr).
+ */
+template <
+    typename F0, typename... E0,
+    typename F1, typename... E1
+    >
+__attribute__((always_inline))
+constexpr multi_expr<multi_expr_bit_or_,
+                multi_expr<F0, E0...>,
+                multi_expr<F1, E1...>> operator|(
+                    const multi_expr<F0, E0...>& expr0,
+                    const multi_expr<F1, E1...>& expr1)
+{
+    return {multi_expr_bit_or_(), expr0, expr1};
+}
+
+/**
+ * @brief Lazy `operator|` (multi_expr/multi).
+ */
+template <typename F, typename... E, typename U, std::size_t... N>
+__attribute__((always_inline))
+constexpr multi_expr<multi_expr_bit_or_,
+                multi_expr<F, E...>,
+                multi_expr_ref_<U, N...>> operator|(
+                    const multi_expr<F, E...>& expr,
+                    const multi<U, N...>& arr)
+{
+    return {multi_expr_bit_or_(), expr, {&arr}};
+}
+
+/**
+ * @brief Lazy `operator|` (multi/multi_expr).
+ */
+template <typename T, std::size_t... N, typename F, typename... E>
+__attribute__((always_inline))
+constexpr multi_expr<multi_expr_bit_or_,
+                multi_expr_ref_<T, N...>,
+                multi_expr<F, E...>> operator|(
+                    const multi<T, N...>& arr,
+                    const multi_expr<F, E...>& expr)
+{
+    return {multi_expr_bit_or_(), {&arr}, expr};
+}
+
+#if !DOXYGEN
+
+template <typename F, typename... E, typename U, std::size_t... N>
+void operator|(
+                const multi_expr<F, E...>& expr,
+                multi<U, N...>&& arr) = delete;
+
+template <typename T, std::size_t... N, typename F, typename... E>
+void operator|(
+                multi<T, N...>&& arr,
+                const multi_expr<F, E...>& expr) = delete;
+
+#endif // #if !DOXYGEN
+
+/**
+ * @brief Lazy `operator|` (multi_expr/entry).
+ */
+template <typename F, typename... E, typename U>
+__attribute__((always_inline))
+constexpr std::enable_if_t<
+                !is_multi<U>::value &&
+                !is_multi_expr<U>::value,
+                multi_expr<multi_expr_bit_or_,
+                    multi_expr<F, E...>,
+                    multi_expr_val_<U>>> operator|(
+                        const multi_expr<F, E...>& expr, const U& val)
+{
+    return {multi_expr_bit_or_(), expr, {val}};
+}
+
+/**
+ * @brief Lazy `operator|` (entry/multi_expr).
+ */
+template <typename T, typename F, typename... E>
+__attribute__((always_inline))
+constexpr std::enable_if_t<
+                !is_multi<T>::value &&
+                !is_multi_expr<T>::value,
+                multi_expr<multi_expr_bit_or_,
+                    multi_expr_val_<T>,
+                    multi_expr<F, E...>>> operator|(
+                        const T& val, const multi_expr<F, E...>& expr)
+{
+    return {multi_expr_bit_or_(), {val}, expr};
+}
+
+/**
+ * @brief Lazy `operator^` (multi_expr/multi_expr).
+ */
+template <
+    typename F0, typename... E0,
+    typename F1, typename... E1
+    >
+__attribute__((always_inline))
+constexpr multi_expr<multi_expr_bit_xor_,
+                multi_expr<F0, E0...>,
+                multi_expr<F1, E1...>> operator^(
+                    const multi_expr<F0, E0...>& expr0,
+                    const multi_expr<F1, E1...>& expr1)
+{
+    return {multi_expr_bit_xor_(), expr0, expr1};
+}
+
+/**
+ * @brief Lazy `operator^` (multi_expr/multi).
+ */
+template <typename F, typename... E, typename U, std::size_t... N>
+__attribute__((always_inline))
+constexpr multi_expr<multi_expr_bit_xor_,
+                multi_expr<F, E...>,
+                multi_expr_ref_<U, N...>> operator^(
+                    const multi_expr<F, E...>& expr,
+                    const multi<U, N...>& arr)
+{
+    return {multi_expr_bit_xor_(), expr, {&arr}};
+}
+
+/**
+ * @brief Lazy `operator^` (multi/multi_expr).
+ */
+template <typename T, std::size_t... N, typename F, typename... E>
+__attribute__((always_inline))
+constexpr multi_expr<multi_expr_bit_xor_,
+                multi_expr_ref_<T, N...>,
+                multi_expr<F, E...>> operator^(
+                    const multi<T, N...>& arr,
+                    const multi_expr<F, E...>& expr)
+{
+    return {multi_expr_bit_xor_(), {&arr}, expr};
+}
+
+#if !DOXYGEN
+
+template <typename F, typename... E, typename U, std::size_t... N>
+void operator^(
+                const multi_expr<F, E...>& expr,
+                multi<U, N...>&& arr) = delete;
+
+template <typename T, std::size_t... N, typename F, typename... E>
+void operator^(
+                multi<T, N...>&& arr,
+                const multi_expr<F, E...>& expr) = delete;
+
+#endif // #if !DOXYGEN
+
+/**
+ * @brief Lazy `operator^` (multi_expr/entry).
+ */
+template <typename F, typename... E, typename U>
+__attribute__((always_inline))
+constexpr std::enable_if_t<
+                !is_multi<U>::value &&
+                !is_multi_expr<U>::value,
+                multi_expr<multi_expr_bit_xor_,
+                    multi_expr<F, E...>,
+                    multi_expr_val_<U>>> operator^(
+                        const multi_expr<F, E...>& expr, const U& val)
+{
+    return {multi_expr_bit_xor_(), expr, {val}};
+}
+
+/**
+ * @brief Lazy `operator^` (entry/multi_expr).
+ */
+template <typename T, typename F, typename... E>
+__attribute__((always_inline))
+constexpr std::enable_if_t<
+                !is_multi<T>::value &&
+                !is_multi_expr<T>::value,
+                multi_expr<multi_expr_bit_xor_,
+                    multi_expr_val_<T>,
+                    multi_expr<F, E...>>> operator^(
+                        const T& val, const multi_expr<F, E...>& expr)
+{
+    return {multi_expr_bit_xor_(), {val}, expr};
+}
+
+/**
+ * @brief Lazy `operator>>` (multi_expr/multi_expr).
+ */
+template <
+    typename F0, typename... E0,
+    typename F1, typename... E1
+    >
+__attribute__((always_inline))
+constexpr multi_expr<multi_expr_shift_right_,
+                multi_expr<F0, E0...>,
+                multi_expr<F1, E1...>> operator>>(
+                    const multi_expr<F0, E0...>& expr0,
+                    const multi_expr<F1, E1...>& expr1)
+{
+    return {multi_expr_shift_right_(), expr0, expr1};
+}
+
+/**
+ * @brief Lazy `operator>>` (multi_expr/multi).
+ */
+template <typename F, typename... E, typename U, std::size_t... N>
+__attribute__((always_inline))
+constexpr multi_expr<multi_expr_shift_right_,
+                multi_expr<F, E...>,
+                multi_expr_ref_<U, N...>> operator>>(
+                    const multi_expr<F, E...>& expr,
+                    const multi<U, N...>& arr)
+{
+    return {multi_expr_shift_right_(), expr, {&arr}};
+}
+
+/**
+ * @brief Lazy `operator>>` (multi/multi_expr).
+ */
+template <typename T, std::size_t... N, typename F, typename... E>
+__attribute__((always_inline))
+constexpr multi_expr<multi_expr_shift_right_,
+                multi_expr_ref_<T, N...>,
+                multi_expr<F, E...>> operator>>(
+                    const multi<T, N...>& arr,
+                    const multi_expr<F, E...>& expr)
+{
+    return {multi_expr_shift_right_(), {&arr}, expr};
+}
+
+#if !DOXYGEN
+
+template <typename F, typename... E, typename U, std::size_t... N>
+void operator>>(
+                const multi_expr<F, E...>& expr,
+                multi<U, N...>&& arr) = delete;
+
+template <typename T, std::size_t... N, typename F, typename... E>
+void operator>>(
+                multi<T, N...>&& arr,
+                const multi_expr<F, E...>& expr) = delete;
+
+#endif // #if !DOXYGEN
+
+/**
+ * @brief Lazy `operator>>` (multi_expr/entry).
+ */
+template <typename F, typename... E, typename U>
+__attribute__((always_inline))
+constexpr std::enable_if_t<
+                !is_multi<U>::value &&
+                !is_multi_expr<U>::value,
+                multi_expr<multi_expr_shift_right_,
+                    multi_expr<F, E...>,
+                    multi_expr_val_<U>>> operator>>(
+                        const multi_expr<F, E...>& expr, const U& val)
+{
+    return {multi_expr_shift_right_(), expr, {val}};
+}
+
+/**
+ * @brief Lazy `operator>>` (entry/multi_expr).
+ */
+template <typename T, typename F, typename... E>
+__attribute__((always_inline))
+constexpr std::enable_if_t<
+                !is_multi<T>::value &&
+                !is_multi_expr<T>::value,
+                multi_expr<multi_expr_shift_right_,
+                    multi_expr_val_<T>,
+                    multi_expr<F, E...>>> operator>>(
+                        const T& val, const multi_expr<F, E...>& expr)
+{
+    return {multi_expr_shift_right_(), {val}, expr};
+}
+
+/**
+ * @brief Lazy `operator<<` (multi_expr/multi_expr).
+ */
+template <
+    typename F0, typename... E0,
+    typename F1, typename... E1
+    >
+__attribute__((always_inline))
+constexpr multi_expr<multi_expr_shift_left_,
+                multi_expr<F0, E0...>,
+                multi_expr<F1, E1...>> operator<<(
+                    const multi_expr<F0, E0...>& expr0,
+                    const multi_expr<F1, E1...>& expr1)
+{
+    return {multi_expr_shift_left_(), expr0, expr1};
+}
+
+/**
+ * @brief Lazy `operator<<` (multi_expr/multi).
+ */
+template <typename F, typename... E, typename U, std::size_t... N>
+__attribute__((always_inline))
+constexpr multi_expr<multi_expr_shift_left_,
+                multi_expr<F, E...>,
+                multi_expr_ref_<U, N...>> operator<<(
+                    const multi_expr<F, E...>& expr,
+                    const multi<U, N...>& arr)
+{
+    return {multi_expr_shift_left_(), expr, {&arr}};
+}
+
+/**
+ * @brief Lazy `operator<<` (multi/multi_expr).
+ */
+template <typename T, std::size_t... N, typename F, typename... E>
+__attribute__((always_inline))
+constexpr multi_expr<multi_expr_shift_left_,
+                multi_expr_ref_<T, N...>,
+                multi_expr<F, E...>> operator<<(
+                    const multi<T, N...>& arr,
+                    const multi_expr<F, E...>& expr)
+{
+    return {multi_expr_shift_left_(), {&arr}, expr};
+}
+
+#if !DOXYGEN
+
+template <typename F, typename... E, typename U, std::size_t... N>
+void operator<<(
+                const multi_expr<F, E...>& expr,
+                multi<U, N...>&& arr) = delete;
+
+template <typename T, std::size_t... N, typename F, typename... E>
+void operator<<(
+                multi<T, N...>&& arr,
+                const multi_expr<F, E...>& expr) = delete;
+
+#endif // #if !DOXYGEN
+
+/**
+ * @brief Lazy `operator<<` (multi_expr/entry).
+ */
+template <typename F, typename... E, typename U>
+__attribute__((always_inline))
+constexpr std::enable_if_t<
+                !is_multi<U>::value &&
+                !is_multi_expr<U>::value,
+                multi_expr<multi_expr_shift_left_,
+                    multi_expr<F, E...>,
+                    multi_expr_val_<U>>> operator<<(
+                        const multi_expr<F, E...>& expr, const U& val)
+{
+    return {multi_expr_shift_left_(), expr, {val}};
+}
+
+/**
+ * @brief Lazy `operator<<` (entry/multi_expr).
+ */
+template <typename T, typename F, typename... E>
+__attribute__((always_inline))
+constexpr std::enable_if_t<
+                !is_multi<T>::value &&
+                !is_multi_expr<T>::value,
+                multi_expr<multi_expr_shift_left_,
+                    multi_expr_val_<T>,
+                    multi_expr<F, E...>>> operator<<(
+                        const T& val, const multi_expr<F, E...>& expr)
+{
+    return {multi_expr_shift_left_(), {val}, expr};
+}
+
+/**@}*/
+
+/**
+ * @name Comparison operators (multi_expr)
+ */
+/**@{*/
+
+/**
+ * @brief Lazy `operator==` (multi_expr/multi_expr).
+ */
+template <
+    typename F0, typename... E0,
+    typename F1, typename... E1
+    >
+__attribute__((always_inline))
+constexpr multi_expr<multi_expr_equal_to_,
+                multi_expr<F0, E0...>,
+                multi_expr<F1, E1...>> operator==(
+                    const multi_expr<F0, E0...>& expr0,
+                    const multi_expr<F1, E1...>& expr1)
+{
+    return {multi_expr_equal_to_(), expr0, expr1};
+}
+
+/**
+ * @brief Lazy `operator==` (multi_expr/multi).
+ */
+template <typename F, typename... E, typename U, std::size_t... N>
+__attribute__((always_inline))
+constexpr multi_expr<multi_expr_equal_to_,
+                multi_expr<F, E...>,
+                multi_expr_ref_<U, N...>> operator==(
+                    const multi_expr<F, E...>& expr,
+                    const multi<U, N...>& arr)
+{
+    return {multi_expr_equal_to_(), expr, {&arr}};
+}
+
+/**
+ * @brief Lazy `operator==` (multi/multi_expr).
+ */
+template <typename T, std::size_t... N, typename F, typename... E>
+__attribute__((always_inline))
+constexpr multi_expr<multi_expr_equal_to_,
+                multi_expr_ref_<T, N...>,
+                multi_expr<F, E...>> operator==(
+                    const multi<T, N...>& arr,
+                    const multi_expr<F, E...>& expr)
+{
+    return {multi_expr_equal_to_(), {&arr}, expr};
+}
+
+#if !DOXYGEN
+
+template <typename F, typename... E, typename U, std::size_t... N>
+void operator==(
+                const multi_expr<F, E...>& expr,
+                multi<U, N...>&& arr) = delete;
+
+template <typename T, std::size_t... N, typename F, typename... E>
+void operator==(
+                multi<T, N...>&& arr,
+                const multi_expr<F, E...>& expr) = delete;
+
+#endif // #if !DOXYGEN
+
+/**
+ * @brief Lazy `operator==` (multi_expr/entry).
+ */
+template <typename F, typename... E, typename U>
+__attribute__((always_inline))
+constexpr std::enable_if_t<
+                !is_multi<U>::value &&
+                !is_multi_expr<U>::value,
+                multi_expr<multi_expr_equal_to_,
+                    multi_expr<F, E...>,
+                    multi_expr_val_<U>>> operator==(
+                        const multi_expr<F, E...>& expr, const U& val)
+{
+    return {multi_expr_equal_to_(), expr, {val}};
+}
+
+/**
+ * @brief Lazy `operator==` (entry/multi_expr).
+ */
+template <typename T, typename F, typename... E>
+__attribute__((always_inline))
+constexpr std::enable_if_t<
+                !is_multi<T>::value &&
+                !is_multi_expr<T>::value,
+                multi_expr<multi_expr_equal_to_,
+                    multi_expr_val_<T>,
+                    multi_expr<F, E...>>> operator==(
+                        const T& val, const multi_expr<F, E...>& expr)
+{
+    return {multi_expr_equal_to_(), {val}, expr};
+}
+
+/**
+ * @brief Lazy `operator!=` (multi_expr/multi_expr).
+ */
+template <
+    typename F0, typename... E0,
+    typename F1, typename... E1
+    >
+__attribute__((always_inline))
+constexpr multi_expr<multi_expr_not_equal_to_,
+                multi_expr<F0, E0...>,
+                multi_expr<F1, E1...>> operator!=(
+                    const multi_expr<F0, E0...>& expr0,
+                    const multi_expr<F1, E1...>& expr1)
+{
+    return {multi_expr_not_equal_to_(), expr0, expr1};
+}
+
+/**
+ * @brief Lazy `operator!=` (multi_expr/multi).
+ */
+template <typename F, typename... E, typename U, std::size_t... N>
+__attribute__((always_inline))
+constexpr multi_expr<multi_expr_not_equal_to_,
+                multi_expr<F, E...>,
+                multi_expr_ref_<U, N...>> operator!=(
+                    const multi_expr<F, E...>& expr,
+                    const multi<U, N...>& arr)
+{
+    return {multi_expr_not_equal_to_(), expr, {&arr}};
+}
+
+/**
+ * @brief Lazy `operator!=` (multi/multi_expr).
+ */
+template <typename T, std::size_t... N, typename F, typename... E>
+__attribute__((always_inline))
+constexpr multi_expr<multi_expr_not_equal_to_,
+                multi_expr_ref_<T, N...>,
+                multi_expr<F, E...>> operator!=(
+                    const multi<T, N...>& arr,
+                    const multi_expr<F, E...>& expr)
+{
+    return {multi_expr_not_equal_to_(), {&arr}, expr};
+}
+
+#if !DOXYGEN
+
+template <typename F, typename... E, typename U, std::size_t... N>
+void operator!=(
+                const multi_expr<F, E...>& expr,
+                multi<U, N...>&& arr) = delete;
+
+template <typename T, std::size_t... N, typename F, typename... E>
+void operator!=(
+                multi<T, N...>&& arr,
+                const multi_expr<F, E...>& expr) = delete;
+
+#endif // #if !DOXYGEN
+
+/**
+ * @brief Lazy `operator!=` (multi_expr/entry).
+ */
+template <typename F, typename... E, typename U>
+__attribute__((always_inline))
+constexpr std::enable_if_t<
+                !is_multi<U>::value &&
+                !is_multi_expr<U>::value,
+                multi_expr<multi_expr_not_equal_to_,
+                    multi_expr<F, E...>,
+                    multi_expr_val_<U>>> operator!=(
+                        const multi_expr<F, E...>& expr, const U& val)
+{
+    return {multi_expr_not_equal_to_(), expr, {val}};
+}
+
+/**
+ * @brief Lazy `operator!=` (entry/multi_expr).
+ */
+template <typename T, typename F, typename... E>
+__attribute__((always_inline))
+constexpr std::enable_if_t<
+                !is_multi<T>::value &&
+                !is_multi_expr<T>::value,
+                multi_expr<multi_expr_not_equal_to_,
+                    multi_expr_val_<T>,
+                    multi_expr<F, E...>>> operator!=(
+                        const T& val, const multi_expr<F, E...>& expr)
+{
+    return {multi_expr_not_equal_to_(), {val}, expr};
+}
+
+/**
+ * @brief Lazy `operator<` (multi_expr/multi_expr).
+ */
+template <
+    typename F0, typename... E0,
+    typename F1, typename... E1
+    >
+__attribute__((always_inline))
+constexpr multi_expr<multi_expr_less_,
+                multi_expr<F0, E0...>,
+                multi_expr<F1, E1...>> operator<(
+                    const multi_expr<F0, E0...>& expr0,
+                    const multi_expr<F1, E1...>& expr1)
+{
+    return {multi_expr_less_(), expr0, expr1};
+}
+
+/**
+ * @brief Lazy `operator<` (multi_expr/multi).
+ */
+template <typename F, typename... E, typename U, std::size_t... N>
+__attribute__((always_inline))
+constexpr multi_expr<multi_expr_less_,
+                multi_expr<F, E...>,
+                multi_expr_ref_<U, N...>> operator<(
+                    const multi_expr<F, E...>& expr,
+                    const multi<U, N...>& arr)
+{
+    return {multi_expr_less_(), expr, {&arr}};
+}
+
+/**
+ * @brief Lazy `operator<` (multi/multi_expr).
+ */
+template <typename T, std::size_t... N, typename F, typename... E>
+__attribute__((always_inline))
+constexpr multi_expr<multi_expr_less_,
+                multi_expr_ref_<T, N...>,
+                multi_expr<F, E...>> operator<(
+                    const multi<T, N...>& arr,
+                    const multi_expr<F, E...>& expr)
+{
+    return {multi_expr_less_(), {&arr}, expr};
+}
+
+#if !DOXYGEN
+
+template <typename F, typename... E, typename U, std::size_t... N>
+void operator<(
+                const multi_expr<F, E...>& expr,
+                multi<U, N...>&& arr) = delete;
+
+template <typename T, std::size_t... N, typename F, typename... E>
+void operator<(
+                multi<T, N...>&& arr,
+                const multi_expr<F, E...>& expr) = delete;
+
+#endif // #if !DOXYGEN
+
+/**
+ * @brief Lazy `operator<` (multi_expr/entry).
+ */
+template <typename F, typename... E, typename U>
+__attribute__((always_inline))
+constexpr std::enable_if_t<
+                !is_multi<U>::value &&
+                !is_multi_expr<U>::value,
+                multi_expr<multi_expr_less_,
+                    multi_expr<F, E...>,
+                    multi_expr_val_<U>>> operator<(
+                        const multi_expr<F, E...>& expr, const U& val)
+{
+    return {multi_expr_less_(), expr, {val}};
+}
+
+/**
+ * @brief Lazy `operator<` (entry/multi_expr).
+ */
+template <typename T, typename F, typename... E>
+__attribute__((always_inline))
+constexpr std::enable_if_t<
+                !is_multi<T>::value &&
+                !is_multi_expr<T>::value,
+                multi_expr<multi_expr_less_,
+                    multi_expr_val_<T>,
+                    multi_expr<F, E...>>> operator<(
+                        const T& val, const multi_expr<F, E...>& expr)
+{
+    return {multi_expr_less_(), {val}, expr};
+}
+
+/**
+ * @brief Lazy `operator>` (multi_expr/multi_expr).
+ */
+template <
+    typename F0, typename... E0,
+    typename F1, typename... E1
+    >
+__attribute__((always_inline))
+constexpr multi_expr<multi_expr_greater_,
+                multi_expr<F0, E0...>,
+                multi_expr<F1, E1...>> operator>(
+                    const multi_expr<F0, E0...>& expr0,
+                    const multi_expr<F1, E1...>& expr1)
+{
+    return {multi_expr_greater_(), expr0, expr1};
+}
+
+/**
+ * @brief Lazy `operator>` (multi_expr/multi).
+ */
+template <typename F, typename... E, typename U, std::size_t... N>
+__attribute__((always_inline))
+constexpr multi_expr<multi_expr_greater_,
+                multi_expr<F, E...>,
+                multi_expr_ref_<U, N...>> operator>(
+                    const multi_expr<F, E...>& expr,
+                    const multi<U, N...>& arr)
+{
+    return {multi_expr_greater_(), expr, {&arr}};
+}
+
+/**
+ * @brief Lazy `operator>` (multi/multi_expr).
+ */
+template <typename T, std::size_t... N, typename F, typename... E>
+__attribute__((always_inline))
+constexpr multi_expr<multi_expr_greater_,
+                multi_expr_ref_<T, N...>,
+                multi_expr<F, E...>> operator>(
+                    const multi<T, N...>& arr,
+                    const multi_expr<F, E...>& expr)
+{
+    return {multi_expr_greater_(), {&arr}, expr};
+}
+
+#if !DOXYGEN
+
+template <typename F, typename... E, typename U, std::size_t... N>
+void operator>(
+                const multi_expr<F, E...>& expr,
+                multi<U, N...>&& arr) = delete;
+
+template <typename T, std::size_t... N, typename F, typename... E>
+void operator>(
+                multi<T, N...>&& arr,
+                const multi_expr<F, E...>& expr) = delete;
+
+#endif // #if !DOXYGEN
+
+/**
+ * @brief Lazy `operator>` (multi_expr/entry).
+ */
+template <typename F, typename... E, typename U>
+__attribute__((always_inline))
+constexpr std::enable_if_t<
+                !is_multi<U>::value &&
+                !is_multi_expr<U>::value,
+                multi_expr<multi_expr_greater_,
+                    multi_expr<F, E...>,
+                    multi_expr_val_<U>>> operator>(
+                        const multi_expr<F, E...>& expr, const U& val)
+{
+    return {multi_expr_greater_(), expr, {val}};
+}
+
+/**
+ * @brief Lazy `operator>` (entry/multi_expr).
+ */
+template <typename T, typename F, typename... E>
+__attribute__((always_inline))
+constexpr std::enable_if_t<
+                !is_multi<T>::value &&
+                !is_multi_expr<T>::value,
+                multi_expr<multi_expr_greater_,
+                    multi_expr_val_<T>,
+                    multi_expr<F, E...>>> operator>(
+                        const T& val, const multi_expr<F, E...>& expr)
+{
+    return {multi_expr_greater_(), {val}, expr};
+}
+
+/**
+ * @brief Lazy `operator<=` (multi_expr/multi_expr).
+ */
+template <
+    typename F0, typename... E0,
+    typename F1, typename... E1
+    >
+__attribute__((always_inline))
+constexpr multi_expr<multi_expr_less_equal_,
+                multi_expr<F0, E0...>,
+                multi_expr<F1, E1...>> operator<=(
+                    const multi_expr<F0, E0...>& expr0,
+                    const multi_expr<F1, E1...>& expr1)
+{
+    return {multi_expr_less_equal_(), expr0, expr1};
+}
+
+/**
+ * @brief Lazy `operator<=` (multi_expr/multi).
+ */
+template <typename F, typename... E, typename U, std::size_t... N>
+__attribute__((always_inline))
+constexpr multi_expr<multi_expr_less_equal_,
+                multi_expr<F, E...>,
+                multi_expr_ref_<U, N...>> operator<=(
+                    const multi_expr<F, E...>& expr,
+                    const multi<U, N...>& arr)
+{
+    return {multi_expr_less_equal_(), expr, {&arr}};
+}
+
+/**
+ * @brief Lazy `operator<=` (multi/multi_expr).
+ */
+template <typename T, std::size_t... N, typename F, typename... E>
+__attribute__((always_inline))
+constexpr multi_expr<multi_expr_less_equal_,
+                multi_expr_ref_<T, N...>,
+                multi_expr<F, E...>> operator<=(
+                    const multi<T, N...>& arr,
+                    const multi_expr<F, E...>& expr)
+{
+    return {multi_expr_less_equal_(), {&arr}, expr};
+}
+
+#if !DOXYGEN
+
+template <typename F, typename... E, typename U, std::size_t... N>
+void operator<=(
+                const multi_expr<F, E...>& expr,
+                multi<U, N...>&& arr) = delete;
+
+template <typename T, std::size_t... N, typename F, typename... E>
+void operator<=(
+                multi<T, N...>&& arr,
+                const multi_expr<F, E...>& expr) = delete;
+
+#endif // #if !DOXYGEN
+
+/**
+ * @brief Lazy `operator<=` (multi_expr/entry).
+ */
+template <typename F, typename... E, typename U>
+__attribute__((always_inline))
+constexpr std::enable_if_t<
+                !is_multi<U>::value &&
+                !is_multi_expr<U>::value,
+                multi_expr<multi_expr_less_equal_,
+                    multi_expr<F, E...>,
+                    multi_expr_val_<U>>> operator<=(
+                        const multi_expr<F, E...>& expr, const U& val)
+{
+    return {multi_expr_less_equal_(), expr, {val}};
+}
+
+/**
+ * @brief Lazy `operator<=` (entry/multi_expr).
+ */
+template <typename T, typename F, typename... E>
+__attribute__((always_inline))
+constexpr std::enable_if_t<
+                !is_multi<T>::value &&
+                !is_multi_expr<T>::value,
+                multi_expr<multi_expr_less_equal_,
+                    multi_expr_val_<T>,
+                    multi_expr<F, E...>>> operator<=(
+                        const T& val, const multi_expr<F, E...>& expr)
+{
+    return {multi_expr_less_equal_(), {val}, expr};
+}
+
+/**
+ * @brief Lazy `operator>=` (multi_expr/multi_expr).
+ */
+template <
+    typename F0, typename... E0,
+    typename F1, typename... E1
+    >
+__attribute__((always_inline))
+constexpr multi_expr<multi_expr_greater_equal_,
+                multi_expr<F0, E0...>,
+                multi_expr<F1, E1...>> operator>=(
+                    const multi_expr<F0, E0...>& expr0,
+                    const multi_expr<F1, E1...>& expr1)
+{
+    return {multi_expr_greater_equal_(), expr0, expr1};
+}
+
+/**
+ * @brief Lazy `operator>=` (multi_expr/multi).
+ */
+template <typename F, typename... E, typename U, std::size_t... N>
+__attribute__((always_inline))
+constexpr multi_expr<multi_expr_greater_equal_,
+                multi_expr<F, E...>,
+                multi_expr_ref_<U, N...>> operator>=(
+                    const multi_expr<F, E...>& expr,
+                    const multi<U, N...>& arr)
+{
+    return {multi_expr_greater_equal_(), expr, {&arr}};
+}
+
+/**
+ * @brief Lazy `operator>=` (multi/multi_expr).
+ */
+template <typename T, std::size_t... N, typename F, typename... E>
+__attribute__((always_inline))
+constexpr multi_expr<multi_expr_greater_equal_,
+                multi_expr_ref_<T, N...>,
+                multi_expr<F, E...>> operator>=(
+                    const multi<T, N...>& arr,
+                    const multi_expr<F, E...>& expr)
+{
+    return {multi_expr_greater_equal_(), {&arr}, expr};
+}
+
+#if !DOXYGEN
+
+template <typename F, typename... E, typename U, std::size_t... N>
+void operator>=(
+                const multi_expr<F, E...>& expr,
+                multi<U, N...>&& arr) = delete;
+
+template <typename T, std::size_t... N, typename F, typename... E>
+void operator>=(
+                multi<T, N...>&& arr,
+                const multi_expr<F, E...>& expr) = delete;
+
+#endif // #if !DOXYGEN
+
+/**
+ * @brief Lazy `operator>=` (multi_expr/entry).
+ */
+template <typename F, typename... E, typename U>
+__attribute__((always_inline))
+constexpr std::enable_if_t<
+                !is_multi<U>::value &&
+                !is_multi_expr<U>::value,
+                multi_expr<multi_expr_greater_equal_,
+                    multi_expr<F, E...>,
+                    multi_expr_val_<U>>> operator>=(
+                        const multi_expr<F, E...>& expr, const U& val)
+{
+    return {multi_expr_greater_equal_(), expr, {val}};
+}
+
+/**
+ * @brief Lazy `operator>=` (entry/multi_expr).
+ */
+template <typename T, typename F, typename... E>
+__attribute__((always_inline))
+constexpr std::enable_if_t<
+                !is_multi<T>::value &&
+                !is_multi_expr<T>::value,
+                multi_expr<multi_expr_greater_equal_,
+                    multi_expr_val_<T>,
+                    multi_expr<F, E...>>> operator>=(
+                        const T& val, const multi_expr<F, E...>& expr)
+{
+    return {multi_expr_greater_equal_(), {val}, expr};
+}
+
+/**
+ * @brief Lazy `operator&&` (multi_expr/multi_expr).
+ */
+template <
+    typename F0, typename... E0,
+    typename F1, typename... E1
+    >
+__attribute__((always_inline))
+constexpr multi_expr<multi_expr_logical_and_,
+                multi_expr<F0, E0...>,
+                multi_expr<F1, E1...>> operator&&(
+                    const multi_expr<F0, E0...>& expr0,
+                    const multi_expr<F1, E1...>& expr1)
+{
+    return {multi_expr_logical_and_(), expr0, expr1};
+}
+
+/**
+ * @brief Lazy `operator&&` (multi_expr/multi).
+ */
+template <typename F, typename... E, typename U, std::size_t... N>
+__attribute__((always_inline))
+constexpr multi_expr<multi_expr_logical_and_,
+                multi_expr<F, E...>,
+                multi_expr_ref_<U, N...>> operator&&(
+                    const multi_expr<F, E...>& expr,
+                    const multi<U, N...>& arr)
+{
+    return {multi_expr_logical_and_(), expr, {&arr}};
+}
+
+/**
+ * @brief Lazy `operator&&` (multi/multi_expr).
+ */
+template <typename T, std::size_t... N, typename F, typename... E>
+__attribute__((always_inline))
+constexpr multi_expr<multi_expr_logical_and_,
+                multi_expr_ref_<T, N...>,
+                multi_expr<F, E...>> operator&&(
+                    const multi<T, N...>& arr,
+                    const multi_expr<F, E...>& expr)
+{
+    return {multi_expr_logical_and_(), {&arr}, expr};
+}
+
+#if !DOXYGEN
+
+template <typename F, typename... E, typename U, std::size_t... N>
+void operator&&(
+                const multi_expr<F, E...>& expr,
+                multi<U, N...>&& arr) = delete;
+
+template <typename T, std::size_t... N, typename F, typename... E>
+void operator&&(
+                multi<T, N...>&& arr,
+                const multi_expr<F, E...>& expr) = delete;
+
+#endif // #if !DOXYGEN
+
+/**
+ * @brief Lazy `operator&&` (multi_expr/entry).
+ */
+template <typename F, typename... E, typename U>
+__attribute__((always_inline))
+constexpr std::enable_if_t<
+                !is_multi<U>::value &&
+                !is_multi_expr<U>::value,
+                multi_expr<multi_expr_logical_and_,
+                    multi_expr<F, E...>,
+                    multi_expr_val_<U>>> operator&&(
+                        const multi_expr<F, E...>& expr, const U& val)
+{
+    return {multi_expr_logical_and_(), expr, {val}};
+}
+
+/**
+ * @brief Lazy `operator&&` (entry/multi_expr).
+ */
+template <typename T, typename F, typename... E>
+__attribute__((always_inline))
+constexpr std::enable_if_t<
+                !is_multi<T>::value &&
+                !is_multi_expr<T>::value,
+                multi_expr<multi_expr_logical_and_,
+                    multi_expr_val_<T>,
+                    multi_expr<F, E...>>> operator&&(
+                        const T& val, const multi_expr<F, E...>& expr)
+{
+    return {multi_expr_logical_and_(), {val}, expr};
+}
+
+/**
+ * @brief Lazy `operator||` (multi_expr/multi_expr).
+ */
+template <
+    typename F0, typename... E0,
+    typename F1, typename... E1
+    >
+__attribute__((always_inline))
+constexpr multi_expr<multi_expr_logical_or_,
+                multi_expr<F0, E0...>,
+                multi_expr<F1, E1...>> operator||(
+                    const multi_expr<F0, E0...>& expr0,
+                    const multi_expr<F1, E1...>& expr1)
+{
+    return {multi_expr_logical_or_(), expr0, expr1};
+}
+
+/**
+ * @brief Lazy `operator||` (multi_expr/multi).
+ */
+template <typename F, typename... E, typename U, std::size_t... N>
+__attribute__((always_inline))
+constexpr multi_expr<multi_expr_logical_or_,
+                multi_expr<F, E...>,
+                multi_expr_ref_<U, N...>> operator||(
+                    const multi_expr<F, E...>& expr,
+                    const multi<U, N...>& arr)
+{
+    return {multi_expr_logical_or_(), expr, {&arr}};
+}
+
+/**
+ * @brief Lazy `operator||` (multi/multi_expr).
+ */
+template <typename T, std::size_t... N, typename F, typename... E>
+__attribute__((always_inline))
+constexpr multi_expr<multi_expr_logical_or_,
+                multi_expr_ref_<T, N...>,
+                multi_expr<F, E...>> operator||(
+                    const multi<T, N...>& arr,
+                    const multi_expr<F, E...>& expr)
+{
+    return {multi_expr_logical_or_(), {&arr}, expr};
+}
+
+#if !DOXYGEN
+
+template <typename F, typename... E, typename U, std::size_t... N>
+void operator||(
+                const multi_expr<F, E...>& expr,
+                multi<U, N...>&& arr) = delete;
+
+template <typename T, std::size_t... N, typename F, typename... E>
+void operator||(
+                multi<T, N...>&& arr,
+                const multi_expr<F, E...>& expr) = delete;
+
+#endif // #if !DOXYGEN
+
+/**
+ * @brief Lazy `operator||` (multi_expr/entry).
+ */
+template <typename F, typename... E, typename U>
+__attribute__((always_inline))
+constexpr std::enable_if_t<
+                !is_multi<U>::value &&
+                !is_multi_expr<U>::value,
+                multi_expr<multi_expr_logical_or_,
+                    multi_expr<F, E...>,
+                    multi_expr_val_<U>>> operator||(
+                        const multi_expr<F, E...>& expr, const U& val)
+{
+    return {multi_expr_logical_or_(), expr, {val}};
+}
+
+/**
+ * @brief Lazy `operator||` (entry/multi_expr).
+ */
+template <typename T, typename F, typename... E>
+__attribute__((always_inline))
+constexpr std::enable_if_t<
+                !is_multi<T>::value &&
+                !is_multi_expr<T>::value,
+                multi_expr<multi_expr_logical_or_,
+                    multi_expr_val_<T>,
+                    multi_expr<F, E...>>> operator||(
+                        const T& val, const multi_expr<F, E...>& expr)
+{
+    return {multi_expr_logical_or_(), {val}, expr};
+}
+
+/**@}*/
+
+/**
+ * @name Compound assignment operators (multi/multi_expr)
+ */
+/**@{*/
+
+/**
+ * @brief Lazy `operator+=`, fused into one loop over `arr`.
+ */
+template <typename T, std::size_t... N, typename F, typename... E>
+__attribute__((always_inline))
+constexpr multi<T, N...>& operator+=(
+                    multi<T, N...>& arr,
+                    const multi_expr<F, E...>& expr)
+{
+    expr.apply_to(arr, [](auto& x, const auto& y) { x += y; });
+    return arr;
+}
+
+/**
+ * @brief Lazy `operator-=`, fused into one loop over `arr`.
+ */
+template <typename T, std::size_t... N, typename F, typename... E>
+__attribute__((always_inline))
+constexpr multi<T, N...>& operator-=(
+                    multi<T, N...>& arr,
+                    const multi_expr<F, E...>& expr)
+{
+    expr.apply_to(arr, [](auto& x, const auto& y) { x -= y; });
+    return arr;
+}
+
+/**
+ * @brief Lazy `operator*=`, fused into one loop over `arr`.
+ */
+template <typename T, std::size_t... N, typename F, typename... E>
+__attribute__((always_inline))
+constexpr multi<T, N...>& operator*=(
+                    multi<T, N...>& arr,
+                    const multi_expr<F, E...>& expr)
+{
+    expr.apply_to(arr, [](auto& x, const auto& y) { x *= y; });
+    return arr;
+}
+
+/**
+ * @brief Lazy `operator/=`, fused into one loop over `arr`.
+ */
+template <typename T, std::size_t... N, typename F, typename... E>
+__attribute__((always_inline))
+constexpr multi<T, N...>& operator/=(
+                    multi<T, N...>& arr,
+                    const multi_expr<F, E...>& expr)
+{
+    expr.apply_to(arr, [](auto& x, const auto& y) { x /= y; });
+    return arr;
+}
+
+/**
+ * @brief Lazy `operator%=`, fused into one loop over `arr`.
+ */
+template <typename T, std::size_t... N, typename F, typename... E>
+__attribute__((always_inline))
+constexpr multi<T, N...>& operator%=(
+                    multi<T, N...>& arr,
+                    const multi_expr<F, E...>& expr)
+{
+    expr.apply_to(arr, [](auto& x, const auto& y) { x %= y; });
+    return arr;
+}
+
+/**
+ * @brief Lazy `operator&=`, fused into one loop over `arr`.
+ */
+template <typename T, std::size_t... N, typename F, typename... E>
+__attribute__((always_inline))
+constexpr multi<T, N...>& operator&=(
+                    multi<T, N...>& arr,
+                    const multi_expr<F, E...>& expr)
+{
+    expr.apply_to(arr, [](auto& x, const auto& y) { x &= y; });
+    return arr;
+}
+
+/**
+ * @brief Lazy `operator|=`, fused into one loop over `arr`.
+ */
+template <typename T, std::size_t... N, typename F, typename... E>
+__attribute__((always_inline))
+constexpr multi<T, N...>& operator|=(
+                    multi<T, N...>& arr,
+                    const multi_expr<F, E...>& expr)
+{
+    expr.apply_to(arr, [](auto& x, const auto& y) { x |= y; });
+    return arr;
+}
+
+/**
+ * @brief Lazy `operator^=`, fused into one loop over `arr`.
+ */
+template <typename T, std::size_t... N, typename F, typename... E>
+__attribute__((always_inline))
+constexpr multi<T, N...>& operator^=(
+                    multi<T, N...>& arr,
+                    const multi_expr<F, E...>& expr)
+{
+    expr.apply_to(arr, [](auto& x, const auto& y) { x ^= y; });
+    return arr;
+}
+
+/**
+ * @brief Lazy `operator>>=`, fused into one loop over `arr`.
+ */
+template <typename T, std::size_t... N, typename F, typename... E>
+__attribute__((always_inline))
+constexpr multi<T, N...>& operator>>=(
+                    multi<T, N...>& arr,
+                    const multi_expr<F, E...>& expr)
+{
+    expr.apply_to(arr, [](auto& x, const auto& y) { x >>= y; });
+    return arr;
+}
+
+/**
+ * @brief Lazy `operator<<=`, fused into one loop over `arr`.
+ */
+template <typename T, std::size_t... N, typename F, typename... E>
+__attribute__((always_inline))
+constexpr multi<T, N...>& operator<<=(
+                    multi<T, N...>& arr,
+                    const multi_expr<F, E...>& expr)
+{
+    expr.apply_to(arr, [](auto& x, const auto& y) { x <<= y; });
+    return arr;
+}
+
+/**@}*/
+
+/**@}*/
+
+} // namespace pre
@@ -0,0 +1,256 @@
+OP1 = {
+    '+' => 'unary_plus',
+    '-' => 'negate',
+    '~' => 'bit_not',
+    '!' => 'logical_not'
+}
+OP2 = {
+    '+' => 'plus',
+    '-' => 'minus',
+    '*' => 'multiplies',
+    '/' => 'divides',
+    '%' => 'modulus',
+    '&' => 'bit_and',
+    '|' => 'bit_or',
+    '^' => 'bit_xor',
+    '>>' => 'shift_right',
+    '<<' => 'shift_left'
+}
+OPC = {
+    '==' => 'equal_to',
+    '!=' => 'not_equal_to',
+    '<' => 'less',
+    '>' => 'greater',
+    '<=' => 'less_equal',
+    '>=' => 'greater_equal',
+    '&&' => 'logical_and',
+    '||' => 'logical_or'
+}
+
+puts <<STR
+namespace pre {
+
+#if !DOXYGEN
+
+STR
+
+for op1, name in OP1
+    puts <<STR
+struct multi_expr_#{name}_
+{
+    template <typename T>
+    __attribute__((always_inline))
+    constexpr auto operator()(const T& x) const
+    {
+        return #{op1}x;
+    }
+};
+
+STR
+end
+
+for op2, name in OP2.merge(OPC)
+    puts <<STR
+struct multi_expr_#{name}_
+{
+    template <typename T, typename U>
+    __attribute__((always_inline))
+    constexpr auto operator()(const T& x, const U& y) const
+    {
+        return x #{op2} y;
+    }
+};
+
+STR
+end
+
+puts <<STR
+#endif // #if !DOXYGEN
+
+/**
+ * @addtogroup multi_expr
+ */
+/**@{*/
+
+STR
+
+#------------------------------------------------------------------------------
+
+puts <<STR
+/**
+ * @name Unary operators (multi_expr)
+ */
+/**@{*/
+
+STR
+
+for op1, name in OP1
+    puts <<STR
+/**
+ * @brief Lazy `operator#{op1}`.
+ */
+template <typename F, typename... E>
+__attribute__((always_inline))
+constexpr multi_expr<multi_expr_#{name}_, multi_expr<F, E...>>
+                operator#{op1}(const multi_expr<F, E...>& expr)
+{
+    return {multi_expr_#{name}_(), expr};
+}
+
+STR
+end
+
+puts <<STR
+/**@}*/
+
+STR
+
+#------------------------------------------------------------------------------
+
+for kind, ops in [['Binary', OP2], ['Comparison', OPC]]
+    puts <<STR
+/**
+ * @name #{kind} operators (multi_expr)
+ */
+/**@{*/
+
+STR
+
+    for op2, name in ops
+        functor = "multi_expr_#{name}_"
+        puts <<STR
+/**
+ * @brief Lazy `operator#{op2}` (multi_expr/multi_expr).
+ */
+template <
+    typename F0, typename... E0,
+    typename F1, typename... E1
+    >
+__attribute__((always_inline))
+constexpr multi_expr<#{functor},
+                multi_expr<F0, E0...>,
+                multi_expr<F1, E1...>> operator#{op2}(
+                    const multi_expr<F0, E0...>& expr0,
+                    const multi_expr<F1, E1...>& expr1)
+{
+    return {#{functor}(), expr0, expr1};
+}
+
+/**
+ * @brief Lazy `operator#{op2}` (multi_expr/multi).
+ */
+template <typename F, typename... E, typename U, std::size_t... N>
+__attribute__((always_inline))
+constexpr multi_expr<#{functor},
+                multi_expr<F, E...>,
+                multi_expr_ref_<U, N...>> operator#{op2}(
+                    const multi_expr<F, E...>& expr,
+                    const multi<U, N...>& arr)
+{
+    return {#{functor}(), expr, {&arr}};
+}
+
+/**
+ * @brief Lazy `operator#{op2}` (multi/multi_expr).
+ */
+template <typename T, std::size_t... N, typename F, typename... E>
+__attribute__((always_inline))
+constexpr multi_expr<#{functor},
+                multi_expr_ref_<T, N...>,
+                multi_expr<F, E...>> operator#{op2}(
+                    const multi<T, N...>& arr,
+                    const multi_expr<F, E...>& expr)
+{
+    return {#{functor}(), {&arr}, expr};
+}
+
+#if !DOXYGEN
+
+template <typename F, typename... E, typename U, std::size_t... N>
+void operator#{op2}(
+                const multi_expr<F, E...>& expr,
+                multi<U, N...>&& arr) = delete;
+
+template <typename T, std::size_t... N, typename F, typename... E>
+void operator#{op2}(
+                multi<T, N...>&& arr,
+                const multi_expr<F, E...>& expr) = delete;
+
+#endif // #if !DOXYGEN
+
+/**
+ * @brief Lazy `operator#{op2}` (multi_expr/entry).
+ */
+template <typename F, typename... E, typename U>
+__attribute__((always_inline))
+constexpr std::enable_if_t<
+                !is_multi<U>::value &&
+                !is_multi_expr<U>::value,
+                multi_expr<#{functor},
+                    multi_expr<F, E...>,
+                    multi_expr_val_<U>>> operator#{op2}(
+                        const multi_expr<F, E...>& expr, const U& val)
+{
+    return {#{functor}(), expr, {val}};
+}
+
+/**
+ * @brief Lazy `operator#{op2}` (entry/multi_expr).
+ */
+template <typename T, typename F, typename... E>
+__attribute__((always_inline))
+constexpr std::enable_if_t<
+                !is_multi<T>::value &&
+                !is_multi_expr<T>::value,
+                multi_expr<#{functor},
+                    multi_expr_val_<T>,
+                    multi_expr<F, E...>>> operator#{op2}(
+                        const T& val, const multi_expr<F, E...>& expr)
+{
+    return {#{functor}(), {val}, expr};
+}
+
+STR
+    end
+
+    puts <<STR
+/**@}*/
+
+STR
+end
+
+#------------------------------------------------------------------------------
+
+puts <<STR
+/**
+ * @name Compound assignment operators (multi/multi_expr)
+ */
+/**@{*/
+
+STR
+
+for op2, name in OP2
+    puts <<STR
+/**
+ * @brief Lazy `operator#{op2}=`, fused into one loop over `arr`.
+ */
+template <typename T, std::size_t... N, typename F, typename... E>
+__attribute__((always_inline))
+constexpr multi<T, N...>& operator#{op2}=(
+                    multi<T, N...>& arr,
+                    const multi_expr<F, E...>& expr)
+{
+    expr.apply_to(arr, [](auto& x, const auto& y) { x #{op2}= y; });
+    return arr;
+}
+
+STR
+end
+
+puts <<STR
+/**@}*/
+
+/**@}*/
+
+} // namespace pre
+STR
@@ -35,12 +35,22 @@
 #ifndef PREFORM_MULTI_MATH_HPP
 #define PREFORM_MULTI_MATH_HPP
 
+#if defined(__SSE2__)
+
+// for _mm_min_ps, _mm256_min_pd, ...
+#include <immintrin.h>
+
+#endif // #if defined(__SSE2__)
+
 // for pre::fabs, pre::fmin, ...
 #include <preform/math.hpp>
 
 // for pre::multi
 #include <preform/multi.hpp>
 
+// for pre::simd, pre::select, ...
+#include <preform/simd.hpp>
+
 namespace pre {
 
 /**
@@ -328,6 +338,99 @@ inline decltype(pre::sqrt(pre::abs(T()))) length_fast(const multi<T, N>& arr)
     }
 }
 
+#if !DOXYGEN
+
+#if defined(__SSE2__)
+
+// Length, safe variant, of 4 float lanes.
+__attribute__((always_inline))
+inline float multi_length_safe_sse_(__m128 x)
+{
+    // Absolute values.
+    x = _mm_andnot_ps(_mm_set1_ps(-0.0f), x);
+
+    // Determine extremal values, ignoring zeros.
+    __m128 zero = _mm_cmpeq_ps(x, _mm_setzero_ps());
+    __m128 big = _mm_set1_ps(pre::numeric_limits<float>::max());
+    __m128 xnz = _mm_or_ps(_mm_and_ps(zero, big), _mm_andnot_ps(zero, x));
+    __m128 xmin = _mm_min_ps(xnz, _mm_shuffle_ps(xnz, xnz, 0xb1));
+    __m128 xmax = _mm_max_ps(x, _mm_shuffle_ps(x, x, 0xb1));
+    xmin = _mm_min_ps(xmin, _mm_shuffle_ps(xmin, xmin, 0x4e));
+    xmax = _mm_max_ps(xmax, _mm_shuffle_ps(xmax, xmax, 0x4e));
+    float tmpmin = _mm_cvtss_f32(xmin);
+    float tmpmax = _mm_cvtss_f32(xmax);
+
+    // Impending overflow or underflow?
+    bool scale =
+        tmpmax * tmpmax >= pre::numeric_limits<float>::max() / 4 ||
+        tmpmin <= pre::numeric_limits<float>::min_squarable();
+    if (scale) {
+        // Factor out maximum.
+        if (tmpmax >= pre::numeric_limits<float>::min_invertible()) {
+            x = _mm_mul_ps(x, _mm_set1_ps(1 / tmpmax));
+        }
+        else {
+            x = _mm_div_ps(x, xmax); // Inverse overflows.
+        }
+    }
+
+    // Length.
+    __m128 x2 = _mm_mul_ps(x, x);
+    x2 = _mm_add_ps(x2, _mm_shuffle_ps(x2, x2, 0xb1));
+    x2 = _mm_add_ps(x2, _mm_shuffle_ps(x2, x2, 0x4e));
+    float len = _mm_cvtss_f32(_mm_sqrt_ss(x2));
+    return scale ? len * tmpmax : len;
+}
+
+#endif // #if defined(__SSE2__)
+
+#if defined(__AVX__)
+
+// Length, safe variant, of 4 double lanes.
+__attribute__((always_inline))
+inline double multi_length_safe_avx_(__m256d x)
+{
+    // Absolute values.
+    x = _mm256_andnot_pd(_mm256_set1_pd(-0.0), x);
+
+    // Determine extremal values, ignoring zeros.
+    __m256d zero = _mm256_cmp_pd(x, _mm256_setzero_pd(), _CMP_EQ_OQ);
+    __m256d xnz = _mm256_blendv_pd(
+                  x, _mm256_set1_pd(pre::numeric_limits<double>::max()),
+                  zero);
+    __m256d xmin = _mm256_min_pd(xnz, _mm256_permute_pd(xnz, 0x5));
+    __m256d xmax = _mm256_max_pd(x, _mm256_permute_pd(x, 0x5));
+    xmin = _mm256_min_pd(xmin, _mm256_permute2f128_pd(xmin, xmin, 0x1));
+    xmax = _mm256_max_pd(xmax, _mm256_permute2f128_pd(xmax, xmax, 0x1));
+    double tmpmin = _mm256_cvtsd_f64(xmin);
+    double tmpmax = _mm256_cvtsd_f64(xmax);
+
+    // Impending overflow or underflow?
+    bool scale =
+        tmpmax * tmpmax >= pre::numeric_limits<double>::max() / 4 ||
+        tmpmin <= pre::numeric_limits<double>::min_squarable();
+    if (scale) {
+        // Factor out maximum.
+        if (tmpmax >= pre::numeric_limits<double>::min_invertible()) {
+            x = _mm256_mul_pd(x, _mm256_set1_pd(1 / tmpmax));
+        }
+        else {
+            x = _mm256_div_pd(x, xmax); // Inverse overflows.
+        }
+    }
+
+    // Length.
+    __m256d x2 = _mm256_mul_pd(x, x);
+    x2 = _mm256_add_pd(x2, _mm256_permute_pd(x2, 0x5));
+    x2 = _mm256_add_pd(x2, _mm256_permute2f128_pd(x2, x2, 0x1));
+    double len = pre::sqrt(_mm256_cvtsd_f64(x2));
+    return scale ? len * tmpmax : len;
+}
+
+#endif // #if defined(__AVX__)
+
+#endif // #if !DOXYGEN
+
 /**
  * @brief @f$ L^2 @f$ length, safe variant.
  *
@@ -341,6 +444,11 @@ inline decltype(pre::sqrt(pre::abs(T()))) length_fast(const multi<T, N>& arr)
  * - calculates the moduli as a preprocessing step,
  * - if impending overflow or underflow, factors the maximum modulus out
  * from under the radical.
+ *
+ * For 4 entries of `float` under SSE2, or of `double` under AVX, the
+ * implementation holds the entries in one register and sums the
+ * squares pairwise, so the result may differ from the generic
+ * implementation in the last bit.
  */
 template <typename T, std::size_t N>
 inline decltype(pre::sqrt(pre::abs(T()))) length_safe(const multi<T, N>& arr)
@@ -355,6 +463,16 @@ inline decltype(pre::sqrt(pre::abs(T()))) length_safe(const multi<T, N>& arr)
                     pre::abs(arr[0]),
                     pre::abs(arr[1]));
     }
+#if defined(__SSE2__)
+    else if constexpr (std::is_same<T, float>::value && N == 4) {
+        return multi_length_safe_sse_(_mm_loadu_ps(&arr[0]));
+    }
+#endif // #if defined(__SSE2__)
+#if defined(__AVX__)
+    else if constexpr (std::is_same<T, double>::value && N == 4) {
+        return multi_length_safe_avx_(_mm256_loadu_pd(&arr[0]));
+    }
+#endif // #if defined(__AVX__)
     else {
 
         // Deduce floating point type.
@@ -364,14 +482,16 @@ inline decltype(pre::sqrt(pre::abs(T()))) length_safe(const multi<T, N>& arr)
         multi<float_type, N> tmp =
         multi<float_type, N>(pre::abs(arr));
 
-        // Determine extremal values.
+        // Determine extremal values, ignoring zeros. The selects are
+        // equivalent to fmin and fmax here, as they also ignore NaN,
+        // but compile to branch-free min and max instructions instead
+        // of library calls.
         float_type tmpmin = pre::numeric_limits<float_type>::max();
         float_type tmpmax = 0;
         for (float_type tmpval : tmp) {
-            if (tmpval != 0) {
-                tmpmin = pre::fmin(tmpmin, tmpval);
-                tmpmax = pre::fmax(tmpmax, tmpval);
-            }
+            float_type tmpnz = tmpval != 0 ? tmpval : tmpmin;
+            tmpmin = tmpnz < tmpmin ? tmpnz : tmpmin;
+            tmpmax = tmpval > tmpmax ? tmpval : tmpmax;
         }
 
         // Impending overflow or underflow?
@@ -407,6 +527,8 @@ inline decltype(pre::sqrt(pre::abs(T()))) length_safe(const multi<T, N>& arr)
  * By default, calls `length_safe()`.
  * Define `PREFORM_DEFAULT_LENGTH_FAST` before including to call
  * `length_fast()`.
+ * Always calls `length_fast()` for `simd` entries, as the safe variant
+ * branches on magnitude.
  */
 template <typename T, std::size_t N>
 inline decltype(pre::sqrt(pre::abs(T()))) length(const multi<T, N>& arr)
@@ -414,7 +536,12 @@ inline decltype(pre::sqrt(pre::abs(T()))) length(const multi<T, N>& arr)
 #if PREFORM_DEFAULT_LENGTH_FAST
     return length_fast(arr);
 #else
-    return length_safe(arr);
+    if constexpr (is_simd<T>::value) {
+        return length_fast(arr);
+    }
+    else {
+        return length_safe(arr);
+    }
 #endif // #if PREFORM_DEFAULT_LENGTH_FAST
 }
 
@@ -494,6 +621,8 @@ inline multi<decltype(T()/pre::sqrt(pre::abs(T()))), N>
  * By default, calls `normalize_safe()`.
  * Define `PREFORM_DEFAULT_NORMALIZE_FAST` before including to call
  * `normalize_fast()`.
+ * Always calls `normalize_fast()` for `simd` entries, as the safe variant
+ * branches on magnitude.
  */
 template <typename T, std::size_t N>
 inline multi<decltype(T()/pre::sqrt(pre::abs(T()))), N>
@@ -502,7 +631,12 @@ inline multi<decltype(T()/pre::sqrt(pre::abs(T()))), N>
 #if PREFORM_DEFAULT_NORMALIZE_FAST
     return normalize_fast(arr);
 #else
-    return normalize_safe(arr);
+    if constexpr (is_simd<T>::value) {
+        return normalize_fast(arr);
+    }
+    else {
+        return normalize_safe(arr);
+    }
 #endif // #if PREFORM_DEFAULT_NORMALIZE_FAST
 }
 
@@ -1036,12 +1170,16 @@ struct multi_initializers<
 
 /**
  * @brief Initializers for 3x3-dimensional floating point arrays.
+ *
+ * @note
+ * Also available for `simd` floating point entries, for which
+ * `build_onb()` blends lanes instead of branching.
  */
 template <typename T>
 struct multi_initializers<
             multi<T, 3, 3>,
             std::enable_if_t<
-            std::is_floating_point<T>::value, void>>
+            std::is_floating_point<simd_value_type_t<T>>::value, void>>
 {
     /**
      * @brief Identity.
@@ -1073,11 +1211,30 @@ struct multi_initializers<
      * As the notation suggests, the implementation assumes the input
      * vector `hatz` is unit-length.
      */
+    __attribute__((always_inline))
     static multi<T, 3, 3> build_onb(multi<T, 3> hatz)
     {
         multi<T, 3> hatx = {};
         multi<T, 3> haty = {};
-        if (hatz[2] < T(-0.9999999)) {
+        if constexpr (is_simd<T>::value) {
+            // Blend, as lanes may disagree.
+            auto flip = hatz[2] < T(-0.9999999);
+            T alpha0 = -1 / (hatz[2] + 1);
+            T alpha1 = alpha0 * hatz[0] * hatz[1];
+            T alpha2 = alpha0 * hatz[0] * hatz[0] + 1;
+            T alpha3 = alpha0 * hatz[1] * hatz[1] + 1;
+            hatx = {
+                pre::select(flip, T(0), alpha2),
+                pre::select(flip, T(-1), alpha1),
+                pre::select(flip, T(0), -hatz[0])
+            };
+            haty = {
+                pre::select(flip, T(-1), alpha1),
+                pre::select(flip, T(0), alpha3),
+                pre::select(flip, T(0), -hatz[1])
+            };
+        }
+        else if (hatz[2] < T(-0.9999999)) {
             hatx[1] = -1;
             haty[0] = -1;
         }
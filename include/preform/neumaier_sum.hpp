@@ -35,6 +35,10 @@
 #ifndef PREFORM_NEUMAIER_SUM_HPP
 #define PREFORM_NEUMAIER_SUM_HPP
 
+// for std::size_t
+#include <cstddef>
+
+// for pre::fabs
 #include <preform/math.hpp>
 
 namespace pre {
@@ -61,6 +65,11 @@ public:
         std::is_floating_point<T>::value,
         "T must be floating point");
 
+    /**
+     * @brief Number of lanes in bulk addition.
+     */
+    static constexpr std::size_t lanes = 8;
+
     /**
      * @brief Default constructor
      */
@@ -86,12 +95,76 @@ public:
      *
      * @note
      * - @f$ s' \gets s \oplus x @f$
-     * - @f$ t' \gets t \oplus ((\max(s, x) \ominus s') \oplus \min(s, x)) @f$
+     * - @f$ t' \gets t \oplus ((a \ominus s') \oplus b) @f$
+     *
+     * where @f$ a @f$ and @f$ b @f$ are the larger and smaller
+     * of @f$ s @f$ and @f$ x @f$ in magnitude.
      */
     neumaier_sum& operator+=(T x)
     {
         volatile T s = s_ + x;
-        volatile T t = t_ + ((pre::fmax(s_, x) - s) + pre::fmin(s_, x));
+        volatile T t = t_ + low_order_(s_, x, s);
+        s_ = s;
+        t_ = t;
+        return *this;
+    }
+
+    /**
+     * @brief Add terms.
+     *
+     * Keeps independent compensated sums in lanes, each taking every
+     * `lanes`-th term, so the loop vectorizes, and then combines lanes.
+     * The result agrees with adding terms one at a time to within
+     * the compensated error, but not bitwise.
+     *
+     * @param[in] x
+     * Terms.
+     *
+     * @param[in] n
+     * Number of terms.
+     *
+     * @note
+     * Unlike `operator+=()`, this relies on the compiler not
+     * reassociating floating point arithmetic, i.e., no `-ffast-math`.
+     */
+    neumaier_sum& add(const T* x, std::size_t n)
+    {
+        std::size_t k = n / lanes;
+        if (k > 0) {
+            T s[lanes] = {};
+            T t[lanes] = {};
+            for (std::size_t j = 0; j < k; j++) {
+                const T* xj = x + j * lanes;
+                for (std::size_t l = 0; l < lanes; l++) {
+                    T sl = s[l] + xj[l];
+                    t[l] += low_order_(s[l], xj[l], sl);
+                    s[l] = sl;
+                }
+            }
+            for (std::size_t l = 0; l < lanes; l++) {
+                merge(neumaier_sum(s[l], t[l]));
+            }
+        }
+        for (std::size_t j = k * lanes; j < n; j++) {
+            *this += x[j];
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Merge, e.g., per-thread partial sums.
+     *
+     * @note
+     * - @f$ s' \gets s_A \oplus s_B @f$
+     * - @f$ t' \gets t_A \oplus t_B \oplus ((a \ominus s') \oplus b) @f$
+     *
+     * where @f$ a @f$ and @f$ b @f$ are the larger and smaller
+     * of @f$ s_A @f$ and @f$ s_B @f$ in magnitude.
+     */
+    neumaier_sum& merge(const neumaier_sum& oth)
+    {
+        volatile T s = s_ + oth.s_;
+        volatile T t = (t_ + oth.t_) + low_order_(s_, oth.s_, s);
         s_ = s;
         t_ = t;
         return *this;
@@ -136,6 +209,17 @@ private:
      * @brief Low-order term @f$ t @f$.
      */
     T t_ = 0;
+
+#if !DOXYGEN
+
+    // Rounding error of s = a + b.
+    static T low_order_(T a, T b, T s)
+    {
+        bool c = pre::fabs(a) >= pre::fabs(b);
+        return ((c ? a : b) - s) + (c ? b : a);
+    }
+
+#endif // #if !DOXYGEN
 };
 
 /**@}*/
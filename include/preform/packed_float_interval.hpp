@@ -0,0 +1,938 @@
+/* Copyright (c) 2018-20 M. Grady Saunders
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer.
+ *
+ *   2. Redistributions in binary form must reproduce the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer in the documentation and/or other materials
+ *      provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*+-+*/
+#if !DOXYGEN
+#if !(__cplusplus >= 201703L)
+#error "preform/packed_float_interval.hpp requires >=C++17"
+#endif // #if !(__cplusplus >= 201703L)
+#endif // #if !DOXYGEN
+#pragma once
+#ifndef PREFORM_PACKED_FLOAT_INTERVAL_HPP
+#define PREFORM_PACKED_FLOAT_INTERVAL_HPP
+
+// for std::size_t
+#include <cstddef>
+
+// for std::basic_istream
+#include <istream>
+
+// for std::basic_ostream
+#include <ostream>
+
+// for pre::numeric_limits
+#include <preform/math.hpp>
+
+// for pre::simd
+#include <preform/simd.hpp>
+
+// for pre::multi
+#include <preform/multi.hpp>
+
+// for pre::dot, pre::cross
+#include <preform/multi_math.hpp>
+
+// for pre::aabb
+#include <preform/aabb.hpp>
+
+// for pre::float_interval
+#include <preform/float_interval.hpp>
+
+namespace pre {
+
+/**
+ * @defgroup packed_float_interval Packed float interval
+ *
+ * `<preform/packed_float_interval.hpp>`
+ *
+ * __C++ version__: >=C++17
+ *
+ * A float interval @f$ [x_0, x_1] @f$ stored as the pair
+ * @f$ (-x_0, x_1) @f$ in one `simd<T, 2>`, such that both bounds
+ * round in the same direction, namely up. Each operation is then a
+ * few packed instructions, followed by one packed outward rounding
+ * step which does not depend on the floating point environment.
+ *
+ * Unlike `float_interval`, this tracks only the bounds, not a
+ * separate value.
+ *
+ * @note
+ * Outward rounding adds @f$ \epsilon |x| @f$ plus the least normal
+ * float to each lane, which is at least one ulp, so the bounds may
+ * be up to about two ulps looser per operation than those of
+ * `float_interval` with `PREFORM_USE_FENV`.
+ */
+/**@{*/
+
+#if !DOXYGEN
+
+// Round lanes up, by at least one ulp. The absolute term is the
+// least normal rather than the least denormal, as denormal operands
+// are very slow on most hardware.
+template <typename T>
+__attribute__((always_inline))
+inline simd<T, 2> packed_float_interval_round_up_(const simd<T, 2>& v)
+{
+    // Clamp magnitude so negative infinity does not become NaN.
+    simd<T, 2> a = pre::min(pre::abs(v), simd<T, 2>(
+                                pre::numeric_limits<T>::max()));
+    return v + (a * pre::numeric_limits<T>::epsilon() +
+                    pre::numeric_limits<T>::min());
+}
+
+// Swap lanes.
+template <typename T>
+__attribute__((always_inline))
+inline simd<T, 2> packed_float_interval_swap_(const simd<T, 2>& v)
+{
+    simd<T, 2> res;
+    res[0] = v[1];
+    res[1] = v[0];
+    return res;
+}
+
+#endif // #if !DOXYGEN
+
+/**
+ * @brief Packed float interval.
+ *
+ * @tparam T
+ * Float type.
+ */
+template <typename T>
+class packed_float_interval
+{
+public:
+
+    // Sanity check.
+    static_assert(
+        std::is_floating_point<T>::value,
+        "T must be floating point");
+
+    /**
+     * @brief Packed type.
+     */
+    typedef simd<T, 2> packed_type;
+
+public:
+
+    /**
+     * @name Constructors
+     */
+    /**@{*/
+
+    /**
+     * @brief Default constructor.
+     */
+    constexpr packed_float_interval() = default;
+
+    /**
+     * @brief Constructor.
+     *
+     * @param[in] x
+     * Value.
+     */
+    packed_float_interval(T x)
+    {
+        v_[0] = -x;
+        v_[1] = +x;
+    }
+
+    /**
+     * @brief Constructor.
+     *
+     * @param[in] x0
+     * Value lower bound.
+     *
+     * @param[in] x1
+     * Value upper bound.
+     */
+    packed_float_interval(T x0, T x1)
+    {
+        v_[0] = -x0;
+        v_[1] = +x1;
+    }
+
+    /**
+     * @brief Constructor from packed representation.
+     *
+     * @param[in] v
+     * Negated lower bound and upper bound.
+     */
+    explicit packed_float_interval(const packed_type& v) : v_(v)
+    {
+    }
+
+    /**
+     * @brief Constructor from `float_interval`.
+     */
+    explicit packed_float_interval(const float_interval<T>& b) :
+            packed_float_interval(b.lower_bound(), b.upper_bound())
+    {
+    }
+
+    /**@}*/
+
+public:
+
+    /**
+     * @name Accessors
+     */
+    /**@{*/
+
+    /**
+     * @brief Packed representation, negated lower bound and upper bound.
+     */
+    __attribute__((always_inline))
+    const packed_type& packed() const
+    {
+        return v_;
+    }
+
+    /**
+     * @brief Lower bound.
+     */
+    __attribute__((always_inline))
+    T lower_bound() const
+    {
+        return -v_[0];
+    }
+
+    /**
+     * @brief Upper bound.
+     */
+    __attribute__((always_inline))
+    T upper_bound() const
+    {
+        return v_[1];
+    }
+
+    /**
+     * @brief Absolute value lower bound.
+     */
+    __attribute__((always_inline))
+    T abs_lower_bound() const
+    {
+        return v_[0] <= 0 ? -v_[0] :
+               v_[1] <= 0 ? -v_[1] : 0;
+    }
+
+    /**
+     * @brief Absolute value upper bound.
+     */
+    __attribute__((always_inline))
+    T abs_upper_bound() const
+    {
+        return pre::max(v_[0], v_[1]);
+    }
+
+    /**
+     * @brief Midpoint.
+     */
+    __attribute__((always_inline))
+    T midpoint() const
+    {
+        return T(0.5) * v_[1] - T(0.5) * v_[0];
+    }
+
+    /**
+     * @brief Width, rounded up.
+     */
+    __attribute__((always_inline))
+    T width() const
+    {
+        return v_[0] + v_[1] == 0 ? T(0) :
+                packed_float_interval_round_up_(
+                    packed_type(v_[0] + v_[1]))[0];
+    }
+
+    /**
+     * @brief Convert to `float_interval`, with midpoint as value.
+     */
+    explicit operator float_interval<T>() const
+    {
+        return {midpoint(), lower_bound(), upper_bound()};
+    }
+
+    /**@}*/
+
+public:
+
+    /**
+     * @name Queries
+     */
+    /**@{*/
+
+    /**
+     * @brief Overlaps other interval?
+     *
+     * @tparam inclusive0
+     * Inclusive lower bound?
+     *
+     * @tparam inclusive1
+     * Inclusive upper bound?
+     */
+    template <
+        bool inclusive0 = true,
+        bool inclusive1 = false
+        >
+    __attribute__((always_inline))
+    bool overlaps(const packed_float_interval& oth) const
+    {
+        if constexpr (inclusive0 && inclusive1) {
+            return lower_bound() <= oth.upper_bound() &&
+                   upper_bound() >= oth.lower_bound();
+        }
+        else if constexpr (inclusive0 && !inclusive1) {
+            return lower_bound() <= oth.upper_bound() &&
+                   upper_bound() > oth.lower_bound();
+        }
+        else if constexpr (!inclusive0 && inclusive1) {
+            return lower_bound() < oth.upper_bound() &&
+                   upper_bound() >= oth.lower_bound();
+        }
+        else {
+            return lower_bound() < oth.upper_bound() &&
+                   upper_bound() > oth.lower_bound();
+        }
+    }
+
+    /**
+     * @brief Contains other interval?
+     *
+     * @tparam inclusive0
+     * Inclusive lower bound?
+     *
+     * @tparam inclusive1
+     * Inclusive upper bound?
+     */
+    template <
+        bool inclusive0 = true,
+        bool inclusive1 = false
+        >
+    __attribute__((always_inline))
+    bool contains(const packed_float_interval& oth) const
+    {
+        if constexpr (inclusive0 && inclusive1) {
+            return lower_bound() <= oth.lower_bound() &&
+                   upper_bound() >= oth.upper_bound();
+        }
+        else if constexpr (inclusive0 && !inclusive1) {
+            return lower_bound() <= oth.lower_bound() &&
+                   upper_bound() > oth.upper_bound();
+        }
+        else if constexpr (!inclusive0 && inclusive1) {
+            return lower_bound() < oth.lower_bound() &&
+                   upper_bound() >= oth.upper_bound();
+        }
+        else {
+            return lower_bound() < oth.lower_bound() &&
+                   upper_bound() > oth.upper_bound();
+        }
+    }
+
+    /**@}*/
+
+private:
+
+    /**
+     * @brief Negated lower bound and upper bound.
+     */
+    packed_type v_ = packed_type();
+
+public:
+
+    /**
+     * @name Stream operators
+     */
+    /**@{*/
+
+    /**
+     * @brief Parse from `std::basic_istream`.
+     *
+     * Format is `[x0,x1]`. Sets `std::ios_base::failbit` on error.
+     */
+    template <typename C, typename Ctraits>
+    friend
+    inline std::basic_istream<C, Ctraits>& operator>>(
+           std::basic_istream<C, Ctraits>& is, packed_float_interval& b)
+    {
+        C ch;
+        if (!(is >> ch) ||
+            !Ctraits::eq(ch,
+             Ctraits::to_char_type('['))) {
+            is.setstate(std::ios_base::failbit);
+            return is;
+        }
+        T x0;
+        is >> x0;
+        if (!(is >> ch) ||
+            !Ctraits::eq(ch,
+             Ctraits::to_char_type(','))) {
+            is.setstate(std::ios_base::failbit);
+            return is;
+        }
+        T x1;
+        is >> x1;
+        if (!(is >> ch) ||
+            !Ctraits::eq(ch,
+             Ctraits::to_char_type(']'))) {
+            is.setstate(std::ios_base::failbit);
+            return is;
+        }
+        b = packed_float_interval(x0, x1);
+        return is;
+    }
+
+    /**
+     * @brief Write into `std::basic_ostream`.
+     *
+     * Format is `[x0,x1]`.
+     */
+    template <typename C, typename Ctraits>
+    friend
+    inline std::basic_ostream<C, Ctraits>& operator<<(
+           std::basic_ostream<C, Ctraits>& os,
+           const packed_float_interval& b)
+    {
+        os << '[' << b.lower_bound() << ',' << b.upper_bound() << ']';
+        return os;
+    }
+
+    /**@}*/
+};
+
+/**
+ * @name Unary operators (packed_float_interval)
+ */
+/**@{*/
+
+/**
+ * @brief Bound `operator+`.
+ */
+template <typename T>
+__attribute__((always_inline))
+inline packed_float_interval<T> operator+(
+                const packed_float_interval<T>& b)
+{
+    return b;
+}
+
+/**
+ * @brief Bound `operator-`, exact.
+ *
+ * @f[
+ *      -(-b_0, b_1) = (-(-b_1), -b_0)
+ * @f]
+ */
+template <typename T>
+__attribute__((always_inline))
+inline packed_float_interval<T> operator-(
+                const packed_float_interval<T>& b)
+{
+    return packed_float_interval<T>(
+           packed_float_interval_swap_(b.packed()));
+}
+
+/**@}*/
+
+/**
+ * @name Binary operators (packed_float_interval/packed_float_interval)
+ */
+/**@{*/
+
+/**
+ * @brief Bound `operator+`.
+ *
+ * @f[
+ *      (-b_{00}, b_{01}) + (-b_{10}, b_{11}) =
+ *      (-(b_{00} + b_{10}), b_{01} + b_{11})
+ * @f]
+ */
+template <typename T>
+__attribute__((always_inline))
+inline packed_float_interval<T> operator+(
+                const packed_float_interval<T>& b0,
+                const packed_float_interval<T>& b1)
+{
+    return packed_float_interval<T>(
+           packed_float_interval_round_up_(b0.packed() + b1.packed()));
+}
+
+/**
+ * @brief Bound `operator-`.
+ */
+template <typename T>
+__attribute__((always_inline))
+inline packed_float_interval<T> operator-(
+                const packed_float_interval<T>& b0,
+                const packed_float_interval<T>& b1)
+{
+    return packed_float_interval<T>(
+           packed_float_interval_round_up_(b0.packed() +
+           packed_float_interval_swap_(b1.packed())));
+}
+
+/**
+ * @brief Bound `operator*`.
+ *
+ * Forms the four bound products in both lanes, negated in the
+ * lower lane, and takes the lane maximum, so there are no sign
+ * branches.
+ *
+ * @note
+ * Zero times infinity yields NaN, as in `float_interval`.
+ */
+template <typename T>
+__attribute__((always_inline))
+inline packed_float_interval<T> operator*(
+                const packed_float_interval<T>& b0,
+                const packed_float_interval<T>& b1)
+{
+    simd<T, 2> x = b0.packed();
+    simd<T, 2> y = packed_float_interval_swap_(x);
+    simd<T, 2> sign;
+    sign[0] = T(-1);
+    sign[1] = T(+1);
+    simd<T, 2> u = b1.packed() * sign;  // ( b10,  b11)
+    simd<T, 2> w = -u;                  // (-b10, -b11)
+    simd<T, 2> t = pre::max(
+                   pre::max(x * u, x * packed_float_interval_swap_(u)),
+                   pre::max(y * w, y * packed_float_interval_swap_(w)));
+    return packed_float_interval<T>(packed_float_interval_round_up_(t));
+}
+
+/**
+ * @brief Bound `operator/`.
+ *
+ * @note
+ * If the denominator contains zero, the result is the whole
+ * real line.
+ */
+template <typename T>
+__attribute__((always_inline))
+inline packed_float_interval<T> operator/(
+                const packed_float_interval<T>& b0,
+                const packed_float_interval<T>& b1)
+{
+    // Denominator contains zero?
+    if (b1.packed()[0] >= T(0) &&
+        b1.packed()[1] >= T(0)) {
+        return packed_float_interval<T>(
+               simd<T, 2>(pre::numeric_limits<T>::infinity()));
+    }
+
+    // Reciprocal, (-1/b11, 1/b10).
+    simd<T, 2> r = packed_float_interval_round_up_(
+                   simd<T, 2>(T(-1)) /
+                   packed_float_interval_swap_(b1.packed()));
+    return b0 * packed_float_interval<T>(r);
+}
+
+/**@}*/
+
+/**
+ * @name Binary operators (packed_float_interval/float)
+ */
+/**@{*/
+
+/**
+ * @brief Wrap `operator+`.
+ */
+template <typename T>
+__attribute__((always_inline))
+inline packed_float_interval<T> operator+(
+                const packed_float_interval<T>& b0, T b1)
+{
+    return b0 + packed_float_interval<T>(b1);
+}
+
+/**
+ * @brief Wrap `operator-`.
+ */
+template <typename T>
+__attribute__((always_inline))
+inline packed_float_interval<T> operator-(
+                const packed_float_interval<T>& b0, T b1)
+{
+    return b0 - packed_float_interval<T>(b1);
+}
+
+/**
+ * @brief Bound `operator*`.
+ *
+ * Multiplying by a single float only needs the products in each
+ * lane, or in swapped lanes if the float is negative.
+ */
+template <typename T>
+__attribute__((always_inline))
+inline packed_float_interval<T> operator*(
+                const packed_float_interval<T>& b0, T b1)
+{
+    simd<T, 2> x = b0.packed();
+    if (b1 < T(0)) {
+        x = packed_float_interval_swap_(x);
+        b1 = -b1;
+    }
+    return packed_float_interval<T>(
+           packed_float_interval_round_up_(x * b1));
+}
+
+/**
+ * @brief Wrap `operator/`.
+ */
+template <typename T>
+__attribute__((always_inline))
+inline packed_float_interval<T> operator/(
+                const packed_float_interval<T>& b0, T b1)
+{
+    return b0 / packed_float_interval<T>(b1);
+}
+
+/**@}*/
+
+/**
+ * @name Binary operators (float/packed_float_interval)
+ */
+/**@{*/
+
+/**
+ * @brief Wrap `operator+`.
+ */
+template <typename T>
+__attribute__((always_inline))
+inline packed_float_interval<T> operator+(
+                T b0, const packed_float_interval<T>& b1)
+{
+    return packed_float_interval<T>(b0) + b1;
+}
+
+/**
+ * @brief Wrap `operator-`.
+ */
+template <typename T>
+__attribute__((always_inline))
+inline packed_float_interval<T> operator-(
+                T b0, const packed_float_interval<T>& b1)
+{
+    return packed_float_interval<T>(b0) - b1;
+}
+
+/**
+ * @brief Wrap `operator*`.
+ */
+template <typename T>
+__attribute__((always_inline))
+inline packed_float_interval<T> operator*(
+                T b0, const packed_float_interval<T>& b1)
+{
+    return b1 * b0;
+}
+
+/**
+ * @brief Wrap `operator/`.
+ */
+template <typename T>
+__attribute__((always_inline))
+inline packed_float_interval<T> operator/(
+                T b0, const packed_float_interval<T>& b1)
+{
+    return packed_float_interval<T>(b0) / b1;
+}
+
+/**@}*/
+
+/**
+ * @name Binary operators (packed_float_interval/any)
+ */
+/**@{*/
+
+/**
+ * @brief Wrap `operator+=`.
+ */
+template <typename T, typename U>
+__attribute__((always_inline))
+inline packed_float_interval<T>& operator+=(
+                packed_float_interval<T>& b, const U& any)
+{
+    return b = b + any;
+}
+
+/**
+ * @brief Wrap `operator-=`.
+ */
+template <typename T, typename U>
+__attribute__((always_inline))
+inline packed_float_interval<T>& operator-=(
+                packed_float_interval<T>& b, const U& any)
+{
+    return b = b - any;
+}
+
+/**
+ * @brief Wrap `operator*=`.
+ */
+template <typename T, typename U>
+__attribute__((always_inline))
+inline packed_float_interval<T>& operator*=(
+                packed_float_interval<T>& b, const U& any)
+{
+    return b = b * any;
+}
+
+/**
+ * @brief Wrap `operator/=`.
+ */
+template <typename T, typename U>
+__attribute__((always_inline))
+inline packed_float_interval<T>& operator/=(
+                packed_float_interval<T>& b, const U& any)
+{
+    return b = b / any;
+}
+
+/**@}*/
+
+/**
+ * @name Math (packed_float_interval)
+ */
+/**@{*/
+
+/**
+ * @brief Bound `pre::fabs()`, exact.
+ */
+template <typename T>
+inline packed_float_interval<T> fabs(const packed_float_interval<T>& b)
+{
+    simd<T, 2> v = b.packed();
+    if (v[0] <= T(0)) { // Entire interval non-negative?
+        return b;
+    }
+    if (v[1] <= T(0)) { // Entire interval non-positive?
+        return -b;
+    }
+    return packed_float_interval<T>(T(0), pre::max(v[0], v[1]));
+}
+
+/**
+ * @brief Bound `pre::sqrt()`.
+ *
+ * @note
+ * Negative lower bounds clamp to zero.
+ */
+template <typename T>
+inline packed_float_interval<T> sqrt(const packed_float_interval<T>& b)
+{
+    simd<T, 2> sign;
+    sign[0] = T(-1);
+    sign[1] = T(+1);
+    simd<T, 2> x = pre::max(b.packed() * sign, simd<T, 2>(T(0)));
+    return packed_float_interval<T>(
+           packed_float_interval_round_up_(pre::sqrt(x) * sign));
+}
+
+/**@}*/
+
+/**
+ * @name Ray kernels (packed_float_interval)
+ */
+/**@{*/
+
+/**
+ * @brief Conservative ray/box test.
+ *
+ * Bounds the slab parameters as intervals and narrows `[tmin, tmax]`
+ * by their hull. The hull of the near and far slab intervals is one
+ * lane maximum in packed form, and narrowing across slabs is one lane
+ * minimum, so the loop is branch-free except for directions which are
+ * exactly zero.
+ *
+ * @param[in] box
+ * Box.
+ *
+ * @param[in] ray_org
+ * Ray origin.
+ *
+ * @param[in] ray_dir
+ * Ray direction.
+ *
+ * @param[inout] ray_tmin
+ * Ray parameter minimum. On hit, set to lower bound of entry.
+ *
+ * @param[inout] ray_tmax
+ * Ray parameter maximum. On hit, set to upper bound of exit.
+ *
+ * @returns
+ * False only if the ray certainly misses the box.
+ */
+template <typename T, std::size_t N>
+inline bool interval_ray_aabb(
+                const aabb<T, N>& box,
+                const multi<T, N>& ray_org,
+                const multi<T, N>& ray_dir,
+                T& ray_tmin,
+                T& ray_tmax)
+{
+    simd<T, 2> acc;
+    acc[0] = -ray_tmin;
+    acc[1] = +ray_tmax;
+    for (std::size_t k = 0; k < N; k++) {
+        if (ray_dir[k] == T(0)) {
+            // Parallel to slab.
+            if (ray_org[k] < box[0][k] ||
+                ray_org[k] > box[1][k]) {
+                return false;
+            }
+            continue;
+        }
+        packed_float_interval<T> inv =
+                T(1) / packed_float_interval<T>(ray_dir[k]);
+        packed_float_interval<T> t0 =
+                (packed_float_interval<T>(box[0][k]) - ray_org[k]) * inv;
+        packed_float_interval<T> t1 =
+                (packed_float_interval<T>(box[1][k]) - ray_org[k]) * inv;
+        acc = pre::min(acc, pre::max(t0.packed(), t1.packed()));
+    }
+    if (-acc[0] <= acc[1]) {
+        ray_tmin = -acc[0];
+        ray_tmax = +acc[1];
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Conservative ray/triangle test.
+ *
+ * Evaluates the Moller-Trumbore test in interval arithmetic. The
+ * barycentric coordinates and ray parameter are then intervals,
+ * and the test only reports a miss if they certainly fall outside
+ * the triangle or the ray parameter range.
+ *
+ * @param[in] p0
+ * Triangle vertex.
+ *
+ * @param[in] p1
+ * Triangle vertex.
+ *
+ * @param[in] p2
+ * Triangle vertex.
+ *
+ * @param[in] ray_org
+ * Ray origin.
+ *
+ * @param[in] ray_dir
+ * Ray direction.
+ *
+ * @param[in] ray_tmin
+ * Ray parameter minimum.
+ *
+ * @param[in] ray_tmax
+ * Ray parameter maximum.
+ *
+ * @param[out] t
+ * Ray parameter bounds. _Optional_.
+ *
+ * @param[out] b
+ * Barycentric coordinate bounds for `p1` and `p2`. _Optional_.
+ *
+ * @returns
+ * False only if the ray certainly misses the triangle. If the
+ * determinant bounds contain zero, as for rays nearly parallel to
+ * the triangle, the result is true with unbounded `t` and `b`, so
+ * the caller may refine with an exact test.
+ */
+template <typename T>
+inline bool interval_ray_triangle(
+                const multi<T, 3>& p0,
+                const multi<T, 3>& p1,
+                const multi<T, 3>& p2,
+                const multi<T, 3>& ray_org,
+                const multi<T, 3>& ray_dir,
+                T ray_tmin,
+                T ray_tmax,
+                packed_float_interval<T>* t = nullptr,
+                multi<packed_float_interval<T>, 2>* b = nullptr)
+{
+    typedef packed_float_interval<T> interval_type;
+    multi<interval_type, 3> org;
+    multi<interval_type, 3> dir;
+    multi<interval_type, 3> e1;
+    multi<interval_type, 3> e2;
+    for (std::size_t k = 0; k < 3; k++) {
+        org[k] = interval_type(ray_org[k]) - p0[k];
+        dir[k] = interval_type(ray_dir[k]);
+        e1[k] = interval_type(p1[k]) - p0[k];
+        e2[k] = interval_type(p2[k]) - p0[k];
+    }
+    multi<interval_type, 3> pvec = pre::cross(dir, e2);
+    interval_type det = pre::dot(e1, pvec);
+    if (det.template contains<true, true>(interval_type(T(0)))) {
+        interval_type inf(
+                -pre::numeric_limits<T>::infinity(),
+                +pre::numeric_limits<T>::infinity());
+        if (t) {
+            *t = inf;
+        }
+        if (b) {
+            *b = {inf, inf};
+        }
+        return true;
+    }
+    interval_type inv = T(1) / det;
+    interval_type b1 = pre::dot(org, pvec) * inv;
+    if (b1.upper_bound() < T(0) ||
+        b1.lower_bound() > T(1)) {
+        return false;
+    }
+    multi<interval_type, 3> qvec = pre::cross(org, e1);
+    interval_type b2 = pre::dot(dir, qvec) * inv;
+    if (b2.upper_bound() < T(0) ||
+        (b1 + b2).lower_bound() > T(1)) {
+        return false;
+    }
+    interval_type tt = pre::dot(e2, qvec) * inv;
+    if (tt.upper_bound() < ray_tmin ||
+        tt.lower_bound() > ray_tmax) {
+        return false;
+    }
+    if (t) {
+        *t = tt;
+    }
+    if (b) {
+        *b = {b1, b2};
+    }
+    return true;
+}
+
+/**@}*/
+
+/**@}*/
+
+} // namespace pre
+
+#endif // #ifndef PREFORM_PACKED_FLOAT_INTERVAL_HPP
@@ -0,0 +1,774 @@
+/* Copyright (c) 2018-20 M. Grady Saunders
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer.
+ *
+ *   2. Redistributions in binary form must reproduce the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer in the documentation and/or other materials
+ *      provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#if !DOXYGEN
+#if !(__cplusplus >= 201703L)
+#error "preform/patch_tessellator.hpp requires >=C++17"
+#endif // #if !(__cplusplus >= 201703L)
+#endif // #if !DOXYGEN
+#pragma once
+#ifndef PREFORM_PATCH_TESSELLATOR_HPP
+#define PREFORM_PATCH_TESSELLATOR_HPP
+
+// for std::max, std::min
+#include <algorithm>
+
+// for std::vector
+#include <vector>
+
+// for pre::sqrt, pre::ceil, ...
+#include <preform/math.hpp>
+
+// for pre::multi
+#include <preform/multi.hpp>
+
+// for pre::length
+#include <preform/multi_math.hpp>
+
+// for pre::make_iterator_range
+#include <preform/iterator_range.hpp>
+
+namespace pre {
+
+/**
+ * @defgroup patch_tessellator Patch tessellator
+ *
+ * `<preform/patch_tessellator.hpp>`
+ *
+ * __C++ version__: >=C++17
+ */
+/**@{*/
+
+/**
+ * @brief Adaptive patch tessellator.
+ *
+ * Tessellates a `bspline_patch` or `nurbs_patch` into indexed
+ * triangles, in the manner of hardware tessellation. The patch
+ * domain is partitioned into cells along its knot spans. Each cell
+ * edge is assigned a level, such that dividing it into that many
+ * segments keeps the chordal error below tolerance, and each cell
+ * interior is assigned levels in each dimension similarly. Edge levels
+ * are raised to the interior levels of adjacent cells, since stitched
+ * triangles reach into the interior. The cell interior is then a
+ * regular grid, stitched to the subdivided cell edges in the outer
+ * ring. Because neighboring cells share edge levels and edge vertices,
+ * and every vertex is evaluated exactly once, the mesh is watertight.
+ *
+ * The error of a segment is measured by a user function of the
+ * surface point and the corresponding point on the chord, such that
+ * an object-space distance gives curvature-driven tessellation, and
+ * a distance between projected points gives screen-space-driven
+ * tessellation. Chordal error falls off quadratically with the number
+ * of segments, so levels are estimated from the error of a single
+ * segment as @f$ L = \lceil \sqrt{E / \epsilon} \rceil @f$. Since
+ * this estimate is poor for strongly curved or rational patches,
+ * levels are then refined, in up to 4 passes, by the error at the
+ * midpoints of every edge segment, and of every grid segment and
+ * grid diagonal of the cell interiors.
+ *
+ * The tolerance is thus a heuristic rather than a bound: it holds
+ * at the checked midpoints, and in practice over the mesh, but not
+ * between them in general, and not wherever levels are clamped
+ * to the maximum level.
+ *
+ * Triangles wind counterclockwise in the parameter domain. Points,
+ * parameters, and triangles are held in vectors using `Talloc`, e.g.,
+ * `memory_arena_allocator`, and may be handed directly to
+ * `aabbtree::init()`, with a function bounding the points of each
+ * triangle.
+ *
+ * @tparam Tfloat
+ * Float type.
+ *
+ * @tparam N
+ * Control point dimension.
+ *
+ * @tparam Talloc
+ * Allocator type.
+ */
+template <
+    typename Tfloat, std::size_t N,
+    typename Talloc = std::allocator<char>
+    >
+class patch_tessellator
+{
+public:
+
+    // Sanity check.
+    static_assert(
+        std::is_floating_point<Tfloat>::value,
+        "Tfloat must be floating point");
+
+    /**
+     * @brief Float type.
+     */
+    typedef Tfloat float_type;
+
+    /**
+     * @brief Size type.
+     */
+    typedef std::size_t size_type;
+
+    /**
+     * @brief Index type.
+     */
+    typedef int index_type;
+
+    /**
+     * @brief Parameter type.
+     */
+    typedef multi<Tfloat, 2> param_type;
+
+    /**
+     * @brief Point type.
+     */
+    typedef std::conditional_t<N == 1, Tfloat, multi<Tfloat, N>> point_type;
+
+    /**
+     * @brief Triangle type, as indices of points.
+     */
+    typedef multi<index_type, 3> triangle_type;
+
+public:
+
+    /**
+     * @brief Default constructor.
+     */
+    patch_tessellator() = default;
+
+    /**
+     * @brief Constructor.
+     *
+     * @param[in] alloc
+     * Allocator.
+     */
+    patch_tessellator(const Talloc& alloc) :
+            params_(alloc),
+            points_(alloc),
+            triangles_(alloc)
+    {
+    }
+
+public:
+
+    /**
+     * @brief Initialize.
+     *
+     * @param[in] patch
+     * Patch, either `bspline_patch` or `nurbs_patch`.
+     *
+     * @param[in] tol
+     * Error tolerance @f$ \epsilon @f$.
+     *
+     * @param[in] func
+     * Error function.
+     *
+     * @param[in] max_level
+     * Maximum level, that is, maximum number of segments per edge
+     * of each cell. Takes precedence over the tolerance.
+     *
+     * @note
+     * Function must have signature equivalent to
+     * ~~~~~~~~~~~~~~~~~~~~~~~~{cpp}
+     * float_type(const point_type& surface, const point_type& chord)
+     * ~~~~~~~~~~~~~~~~~~~~~~~~
+     *
+     * @throw std::invalid_argument
+     * Unless `tol > 0` and `max_level >= 2`.
+     */
+    template <typename Tpatch, typename Tfunc>
+    void init(
+            const Tpatch& patch,
+            float_type tol,
+            Tfunc&& func,
+            int max_level = 64)
+    {
+        // Validate.
+        if (!(tol > 0) ||
+            !(max_level >= 2)) {
+            throw std::invalid_argument(__PRETTY_FUNCTION__);
+        }
+
+        // Clear.
+        clear();
+
+        // Cell boundaries.
+        std::vector<float_type> s0 = spans_(patch.basis0());
+        std::vector<float_type> s1 = spans_(patch.basis1());
+        int c0 = int(s0.size()) - 1;
+        int c1 = int(s1.size()) - 1;
+        auto node = [&](int a, int b) {
+            return index_type(a * (c1 + 1) + b);
+        };
+
+        // Error samples, at fractions k / 8 along lines.
+        constexpr int line_size = 9;
+        std::vector<param_type> samples;
+        auto add_line = [&](param_type t0, param_type t1) {
+            for (int k = 0; k < line_size; k++) {
+                samples.push_back(
+                    t0 + (t1 - t0) * (float_type(k) / (line_size - 1)));
+            }
+        };
+        for (int a = 0; a < c0; a++)
+        for (int b = 0; b <= c1; b++) {
+            add_line({s0[a], s1[b]}, {s0[a + 1], s1[b]});
+        }
+        for (int a = 0; a <= c0; a++)
+        for (int b = 0; b < c1; b++) {
+            add_line({s0[a], s1[b]}, {s0[a], s1[b + 1]});
+        }
+        for (int a = 0; a < c0; a++)
+        for (int b = 0; b < c1; b++) {
+            float_type m0 = (s0[a] + s0[a + 1]) / 2;
+            float_type m1 = (s1[b] + s1[b + 1]) / 2;
+            add_line({s0[a], m1}, {s0[a + 1], m1});
+            add_line({m0, s1[b]}, {m0, s1[b + 1]});
+        }
+        std::vector<point_type> values(samples.size());
+        patch.evaluate_many(samples.data(), samples.size(), values.data());
+
+        // Level of line.
+        const point_type* line = values.data();
+        auto next_level = [&]() {
+            float_type err = 0;
+            for (int k = 1; k + 1 < line_size; k++) {
+                err = pre::fmax(err, float_type(func(
+                        line[k],
+                        line[0] + (line[line_size - 1] - line[0]) *
+                        (float_type(k) / (line_size - 1)))));
+            }
+            line += line_size;
+            float_type lev = pre::ceil(pre::sqrt(err / tol));
+            return int(pre::fmin(lev, float_type(max_level)));
+        };
+        auto clamp_level = [&](int lev) {
+            return std::max(1, std::min(lev, max_level));
+        };
+        std::vector<int> lev0(c0 * (c1 + 1));
+        std::vector<int> lev1((c0 + 1) * c1);
+        for (int& lev : lev0) {
+            lev = clamp_level(next_level());
+        }
+        for (int& lev : lev1) {
+            lev = clamp_level(next_level());
+        }
+        std::vector<multi<int, 2>> levc(c0 * c1);
+        for (int a = 0; a < c0; a++)
+        for (int b = 0; b < c1; b++) {
+            const point_type* mid = line;
+            int l0 = next_level();
+            int l1 = next_level();
+
+            // Twist, from center against corners.
+            const point_type* e0 = &values[line_size * (a * (c1 + 1) + b)];
+            const point_type* e1 = e0 + line_size;
+            float_type err = func(
+                    mid[line_size / 2],
+                    (e0[0] + e0[line_size - 1] +
+                     e1[0] + e1[line_size - 1]) / 4);
+            int lt = int(pre::fmin(
+                    pre::ceil(pre::sqrt(err / tol)),
+                    float_type(max_level)));
+            levc[a * c1 + b] = {
+                clamp_level(std::max(l0, lt)),
+                clamp_level(std::max(l1, lt))
+            };
+        }
+
+        // Raise edge levels to adjacent interior levels, as stitched
+        // triangles reach into the interior. Then raise interior levels
+        // to edge levels.
+        auto match_levels = [&]() {
+            for (int a = 0; a < c0; a++)
+            for (int b = 0; b < c1; b++) {
+                multi<int, 2> lev = levc[a * c1 + b];
+                int& lb = lev0[a * (c1 + 1) + b];
+                int& lt = lev0[a * (c1 + 1) + b + 1];
+                int& ll = lev1[a * c1 + b];
+                int& lr = lev1[(a + 1) * c1 + b];
+                lb = std::max(lb, lev[0]);
+                lt = std::max(lt, lev[0]);
+                ll = std::max(ll, lev[1]);
+                lr = std::max(lr, lev[1]);
+            }
+            for (int a = 0; a < c0; a++)
+            for (int b = 0; b < c1; b++) {
+                multi<int, 2>& lev = levc[a * c1 + b];
+                lev[0] = std::max({lev[0],
+                        lev0[a * (c1 + 1) + b],
+                        lev0[a * (c1 + 1) + b + 1]});
+                lev[1] = std::max({lev[1],
+                        lev1[a * c1 + b],
+                        lev1[(a + 1) * c1 + b]});
+            }
+        };
+        match_levels();
+
+        // Refine, by the error at the midpoints of the segments and
+        // grid cells of each cell at its levels, since the estimate
+        // from a single segment is poor for strongly curved or
+        // rational patches.
+        constexpr int max_passes = 4;
+        for (int pass = 0; pass < max_passes; pass++) {
+
+            // Sample at half steps, as edges then cells.
+            samples.clear();
+            for (int a = 0; a < c0; a++)
+            for (int b = 0; b <= c1; b++) {
+                int lev = 2 * lev0[a * (c1 + 1) + b];
+                for (int k = 0; k <= lev; k++) {
+                    samples.push_back({
+                        s0[a] + (s0[a + 1] - s0[a]) * k / lev, s1[b]});
+                }
+            }
+            for (int a = 0; a <= c0; a++)
+            for (int b = 0; b < c1; b++) {
+                int lev = 2 * lev1[a * c1 + b];
+                for (int k = 0; k <= lev; k++) {
+                    samples.push_back({
+                        s0[a], s1[b] + (s1[b + 1] - s1[b]) * k / lev});
+                }
+            }
+            for (int a = 0; a < c0; a++)
+            for (int b = 0; b < c1; b++) {
+                multi<int, 2> lev = 2 * grid_levels_(levc[a * c1 + b]);
+                for (int i = 0; i <= lev[0]; i++)
+                for (int j = 0; j <= lev[1]; j++) {
+                    samples.push_back({
+                        s0[a] + (s0[a + 1] - s0[a]) * i / lev[0],
+                        s1[b] + (s1[b + 1] - s1[b]) * j / lev[1]});
+                }
+            }
+            values.resize(samples.size());
+            patch.evaluate_many(
+                    samples.data(), samples.size(), values.data());
+
+            // Raise level by error, assuming quadratic falloff.
+            bool raised = false;
+            auto raise_level = [&](int& lev, float_type err) {
+                if (err > tol && lev < max_level) {
+                    lev = clamp_level(int(pre::fmin(
+                            pre::ceil(lev * pre::sqrt(err / tol)),
+                            float_type(max_level))));
+                    raised = true;
+                }
+            };
+            auto mid_error = [&](
+                    const point_type& p,
+                    const point_type& q0,
+                    const point_type& q1) {
+                return float_type(func(p, (q0 + q1) / 2));
+            };
+            line = values.data();
+            auto edge_error = [&](int lev) {
+                float_type err = 0;
+                for (int k = 1; k < 2 * lev; k += 2) {
+                    err = pre::fmax(err,
+                            mid_error(line[k], line[k - 1], line[k + 1]));
+                }
+                line += 2 * lev + 1;
+                return err;
+            };
+            for (int& lev : lev0) {
+                raise_level(lev, edge_error(lev));
+            }
+            for (int& lev : lev1) {
+                raise_level(lev, edge_error(lev));
+            }
+            for (multi<int, 2>& lev : levc) {
+                multi<int, 2> grid_lev = 2 * grid_levels_(lev);
+                auto at = [&](int i, int j) -> const point_type& {
+                    return line[i * (grid_lev[1] + 1) + j];
+                };
+                float_type err0 = 0;
+                float_type err1 = 0;
+                for (int i = 0; i <= grid_lev[0]; i++)
+                for (int j = 0; j <= grid_lev[1]; j++) {
+                    if (i % 2 == 1 && j % 2 == 0) {
+                        err0 = pre::fmax(err0, mid_error(
+                                at(i, j), at(i - 1, j), at(i + 1, j)));
+                    }
+                    if (i % 2 == 0 && j % 2 == 1) {
+                        err1 = pre::fmax(err1, mid_error(
+                                at(i, j), at(i, j - 1), at(i, j + 1)));
+                    }
+                    if (i % 2 == 1 && j % 2 == 1) {
+                        // Diagonals, as the grid uses one and the outer
+                        // ring may use either.
+                        float_type err = pre::fmax(
+                            mid_error(at(i, j),
+                                      at(i - 1, j - 1), at(i + 1, j + 1)),
+                            mid_error(at(i, j),
+                                      at(i - 1, j + 1), at(i + 1, j - 1)));
+                        err0 = pre::fmax(err0, err);
+                        err1 = pre::fmax(err1, err);
+                    }
+                }
+                line += (grid_lev[0] + 1) * (grid_lev[1] + 1);
+                raise_level(lev[0], err0);
+                raise_level(lev[1], err1);
+            }
+            if (!raised) {
+                break;
+            }
+            match_levels();
+        }
+
+        // Vertices at nodes.
+        for (int a = 0; a <= c0; a++)
+        for (int b = 0; b <= c1; b++) {
+            params_.push_back({s0[a], s1[b]});
+        }
+
+        // Vertices on edges.
+        std::vector<index_type> base0(lev0.size());
+        std::vector<index_type> base1(lev1.size());
+        for (int a = 0; a < c0; a++)
+        for (int b = 0; b <= c1; b++) {
+            int lev = lev0[a * (c1 + 1) + b];
+            base0[a * (c1 + 1) + b] = index_type(params_.size()) - 1;
+            for (int k = 1; k < lev; k++) {
+                params_.push_back({
+                    s0[a] + (s0[a + 1] - s0[a]) * k / lev, s1[b]});
+            }
+        }
+        for (int a = 0; a <= c0; a++)
+        for (int b = 0; b < c1; b++) {
+            int lev = lev1[a * c1 + b];
+            base1[a * c1 + b] = index_type(params_.size()) - 1;
+            for (int k = 1; k < lev; k++) {
+                params_.push_back({
+                    s0[a], s1[b] + (s1[b + 1] - s1[b]) * k / lev});
+            }
+        }
+
+        // Vertices on edge, including end nodes, as k in [0, lev].
+        auto edge0 = [&](int a, int b, int k) {
+            int lev = lev0[a * (c1 + 1) + b];
+            return k == 0 ? node(a, b) :
+                   k == lev ? node(a + 1, b) :
+                   base0[a * (c1 + 1) + b] + k;
+        };
+        auto edge1 = [&](int a, int b, int k) {
+            int lev = lev1[a * c1 + b];
+            return k == 0 ? node(a, b) :
+                   k == lev ? node(a, b + 1) :
+                   base1[a * c1 + b] + k;
+        };
+
+        // Cells.
+        std::vector<index_type> outer;
+        std::vector<index_type> inner;
+        for (int a = 0; a < c0; a++)
+        for (int b = 0; b < c1; b++) {
+            multi<int, 2> lev = levc[a * c1 + b];
+            int lb = lev0[a * (c1 + 1) + b];
+            int lt = lev0[a * (c1 + 1) + b + 1];
+            int ll = lev1[a * c1 + b];
+            int lr = lev1[(a + 1) * c1 + b];
+
+            // Flat?
+            if ((lev == 1).all() &&
+                lb == 1 && lt == 1 && ll == 1 && lr == 1) {
+                triangles_.push_back({
+                    node(a, b), node(a + 1, b), node(a + 1, b + 1)});
+                triangles_.push_back({
+                    node(a, b), node(a + 1, b + 1), node(a, b + 1)});
+                continue;
+            }
+            lev = grid_levels_(lev);
+
+            // Interior grid vertices.
+            index_type base = index_type(params_.size());
+            for (int i = 1; i < lev[0]; i++)
+            for (int j = 1; j < lev[1]; j++) {
+                params_.push_back({
+                    s0[a] + (s0[a + 1] - s0[a]) * i / lev[0],
+                    s1[b] + (s1[b + 1] - s1[b]) * j / lev[1]});
+            }
+            auto grid = [&](int i, int j) {
+                return base + (i - 1) * (lev[1] - 1) + (j - 1);
+            };
+
+            // Interior grid triangles.
+            for (int i = 1; i + 1 < lev[0]; i++)
+            for (int j = 1; j + 1 < lev[1]; j++) {
+                triangles_.push_back({
+                    grid(i, j), grid(i + 1, j), grid(i + 1, j + 1)});
+                triangles_.push_back({
+                    grid(i, j), grid(i + 1, j + 1), grid(i, j + 1)});
+            }
+
+            // Outer ring, counterclockwise, side by side.
+            outer.clear();
+            inner.clear();
+            for (int k = 0; k <= lb; k++) {
+                outer.push_back(edge0(a, b, k));
+            }
+            for (int i = 1; i < lev[0]; i++) {
+                inner.push_back(grid(i, 1));
+            }
+            stitch_(outer, inner, lev[0]);
+            outer.clear();
+            inner.clear();
+            for (int k = 0; k <= lr; k++) {
+                outer.push_back(edge1(a + 1, b, k));
+            }
+            for (int j = 1; j < lev[1]; j++) {
+                inner.push_back(grid(lev[0] - 1, j));
+            }
+            stitch_(outer, inner, lev[1]);
+            outer.clear();
+            inner.clear();
+            for (int k = lt; k >= 0; k--) {
+                outer.push_back(edge0(a, b + 1, k));
+            }
+            for (int i = lev[0] - 1; i >= 1; i--) {
+                inner.push_back(grid(i, lev[1] - 1));
+            }
+            stitch_(outer, inner, lev[0]);
+            outer.clear();
+            inner.clear();
+            for (int k = ll; k >= 0; k--) {
+                outer.push_back(edge1(a, b, k));
+            }
+            for (int j = lev[1] - 1; j >= 1; j--) {
+                inner.push_back(grid(1, j));
+            }
+            stitch_(outer, inner, lev[1]);
+        }
+
+        // Evaluate.
+        points_.resize(params_.size());
+        patch.evaluate_many(params_.data(), params_.size(), points_.data());
+    }
+
+    /**
+     * @brief Initialize, with object-space error.
+     *
+     * @param[in] patch
+     * Patch, either `bspline_patch` or `nurbs_patch`.
+     *
+     * @param[in] tol
+     * Error tolerance @f$ \epsilon @f$, as distance.
+     *
+     * @param[in] max_level
+     * Maximum level.
+     */
+    template <typename Tpatch>
+    void init(
+            const Tpatch& patch,
+            float_type tol,
+            int max_level = 64)
+    {
+        init(patch, tol,
+            [](const point_type& p, const point_type& q) {
+                if constexpr (N == 1) {
+                    return pre::abs(p - q);
+                }
+                else {
+                    return pre::length(p - q);
+                }
+            }, max_level);
+    }
+
+    /**
+     * @brief Clear.
+     */
+    void clear()
+    {
+        params_.clear();
+        points_.clear();
+        triangles_.clear();
+    }
+
+public:
+
+    /**
+     * @name Accessors
+     */
+    /**@{*/
+
+    /**
+     * @brief Iterator range of parameters.
+     */
+    auto params() const
+    {
+        return make_iterator_range(params_);
+    }
+
+    /**
+     * @brief Iterator range of points.
+     */
+    auto points() const
+    {
+        return make_iterator_range(points_);
+    }
+
+    /**
+     * @brief Iterator range of triangles.
+     */
+    auto triangles() const
+    {
+        return make_iterator_range(triangles_);
+    }
+
+    /**@}*/
+
+private:
+
+    /**
+     * @brief Distinct knots within domain.
+     */
+    template <typename Tbasis>
+    static std::vector<float_type> spans_(const Tbasis& basis)
+    {
+        const float_type* u = basis.knots_data();
+        std::vector<float_type> res;
+        res.push_back(basis.domain_min());
+        for (auto k = basis.degree() + 1;
+                  k < basis.num_control_points(); k++) {
+            if (u[k] > res.back()) {
+                res.push_back(u[k]);
+            }
+        }
+        if (basis.domain_max() > res.back()) {
+            res.push_back(basis.domain_max());
+        }
+        return res;
+    }
+
+    /**
+     * @brief Interior grid levels, at least 2 unless flat.
+     */
+    static multi<int, 2> grid_levels_(multi<int, 2> lev)
+    {
+        if ((lev == 1).all()) {
+            return lev;
+        }
+        return {
+            std::max(lev[0], 2),
+            std::max(lev[1], 2)
+        };
+    }
+
+    /**
+     * @brief Stitch one side of outer ring to inner ring.
+     *
+     * Zips the outer side, with vertices at fractions @f$ k / p @f$
+     * for @f$ k \in [0, p] @f$, to the inner side, with vertices at
+     * fractions @f$ (k + 1) / L @f$ for @f$ k \in [0, L - 2] @f$, in
+     * order of fraction, so that triangles do not overlap.
+     */
+    void stitch_(
+            const std::vector<index_type>& outer,
+            const std::vector<index_type>& inner,
+            int lev)
+    {
+        int p = int(outer.size()) - 1;
+        int q = int(inner.size()) - 1;
+        int ka = 0;
+        int kb = 0;
+        while (ka < p || kb < q) {
+            // Compare fractions (ka + 1) / p and (kb + 2) / lev.
+            if (kb == q ||
+                (ka < p && (ka + 1) * lev < (kb + 2) * p)) {
+                triangles_.push_back({
+                    outer[ka], outer[ka + 1], inner[kb]});
+                ka++;
+            }
+            else {
+                triangles_.push_back({
+                    outer[ka], inner[kb + 1], inner[kb]});
+                kb++;
+            }
+        }
+    }
+
+private:
+
+    /**
+     * @brief Parameters.
+     *
+     * @note
+     * This uses the user-specified allocator type `Talloc` rebound to
+     * `param_type`. For brevity, this is not shown in the documentation
+     * type signature.
+     */
+    std::vector<
+        param_type,
+#if !DOXYGEN
+        typename std::allocator_traits<Talloc>::
+        template rebind_alloc<param_type>
+#else
+        ...
+#endif // #if !DOXYGEN
+        > params_;
+
+    /**
+     * @brief Points.
+     *
+     * @note
+     * This uses the user-specified allocator type `Talloc` rebound to
+     * `point_type`. For brevity, this is not shown in the documentation
+     * type signature.
+     */
+    std::vector<
+        point_type,
+#if !DOXYGEN
+        typename std::allocator_traits<Talloc>::
+        template rebind_alloc<point_type>
+#else
+        ...
+#endif // #if !DOXYGEN
+        > points_;
+
+    /**
+     * @brief Triangles.
+     *
+     * @note
+     * This uses the user-specified allocator type `Talloc` rebound to
+     * `triangle_type`. For brevity, this is not shown in the documentation
+     * type signature.
+     */
+    std::vector<
+        triangle_type,
+#if !DOXYGEN
+        typename std::allocator_traits<Talloc>::
+        template rebind_alloc<triangle_type>
+#else
+        ...
+#endif // #if !DOXYGEN
+        > triangles_;
+};
+
+/**@}*/
+
+} // namespace pre
+
+#endif // #ifndef PREFORM_PATCH_TESSELLATOR_HPP
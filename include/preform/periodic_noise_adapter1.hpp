@@ -35,6 +35,9 @@
 #ifndef PREFORM_PERIODIC_NOISE_ADAPTER1_HPP
 #define PREFORM_PERIODIC_NOISE_ADAPTER1_HPP
 
+// for std::min
+#include <algorithm>
+
 // for std::forward
 #include <utility>
 
@@ -137,8 +140,167 @@ public:
         return s;
     }
 
+    /**
+     * @brief Evaluate many.
+     *
+     * Equivalent to `evaluate()` at each point. Points go in groups
+     * of 64, each mapped onto the circle and delegated to the noise
+     * function's `evaluate_many()` at once.
+     *
+     * @param[in] t
+     * Coordinates.
+     *
+     * @param[in] n
+     * Count.
+     *
+     * @param[out] s
+     * Noise values.
+     *
+     * @param[out] ds_dt
+     * Noise derivatives. _Optional_.
+     *
+     * @note
+     * Requires that the noise function has `evaluate_many()`, e.g.,
+     * `pre::simplex_noise2` or `pre::worley_noise2`.
+     */
+    void evaluate_many(
+            const float_type* t,
+            std::size_t n,
+            float_type* s,
+            float_type* ds_dt = nullptr) const
+    {
+        // Points per group.
+        constexpr std::size_t lanes = 64;
+
+        float_type pi = pre::numeric_constants<float_type>::M_pi();
+        float_type omega = 2 * pi / t0_;
+        for (std::size_t k0 = 0; k0 < n; k0 += lanes) {
+            std::size_t m = std::min(lanes, n - k0);
+            float_type cos_omegat[lanes];
+            float_type sin_omegat[lanes];
+            for (std::size_t j = 0; j < m; j++) {
+                cos_omegat[j] = pre::cos(omega * t[k0 + j]);
+                sin_omegat[j] = pre::sin(omega * t[k0 + j]);
+            }
+            evaluate_circle_(cos_omegat, sin_omegat, omega, m,
+                             s + k0, ds_dt ? ds_dt + k0 : nullptr);
+        }
+    }
+
+    /**
+     * @brief Evaluate on grid.
+     *
+     * Fills `s` such that entry @f$ k @f$ is the noise at
+     * @f$ t_0 + k \Delta t @f$. Trigonometric functions of the angle
+     * increments within a group of 64 entries are tabulated once, so
+     * each group needs only one direct evaluation, with entries
+     * following by the angle sum identities. Groups then delegate
+     * to the noise function's `evaluate_many()` at once.
+     *
+     * @param[in] t0
+     * Coordinate of entry 0.
+     *
+     * @param[in] dt
+     * Coordinate increment per entry.
+     *
+     * @param[in] n
+     * Count.
+     *
+     * @param[out] s
+     * Noise values.
+     *
+     * @param[out] ds_dt
+     * Noise derivatives. _Optional_.
+     *
+     * @note
+     * Requires that the noise function has `evaluate_many()`, e.g.,
+     * `pre::simplex_noise2` or `pre::worley_noise2`.
+     */
+    void evaluate_grid(
+            float_type t0,
+            float_type dt,
+            std::size_t n,
+            float_type* s,
+            float_type* ds_dt = nullptr) const
+    {
+        // Points per group.
+        constexpr std::size_t lanes = 64;
+
+        // Table.
+        float_type pi = pre::numeric_constants<float_type>::M_pi();
+        float_type omega = 2 * pi / t0_;
+        float_type cos_omegadt[lanes];
+        float_type sin_omegadt[lanes];
+        for (std::size_t j = 0; j < std::min(lanes, n); j++) {
+            cos_omegadt[j] = pre::cos(omega * dt * float_type(j));
+            sin_omegadt[j] = pre::sin(omega * dt * float_type(j));
+        }
+        for (std::size_t k0 = 0; k0 < n; k0 += lanes) {
+            std::size_t m = std::min(lanes, n - k0);
+            float_type theta = omega * (t0 + dt * float_type(k0));
+            float_type cos_theta = pre::cos(theta);
+            float_type sin_theta = pre::sin(theta);
+            float_type cos_omegat[lanes];
+            float_type sin_omegat[lanes];
+            for (std::size_t j = 0; j < m; j++) {
+                cos_omegat[j] =
+                    cos_theta * cos_omegadt[j] -
+                    sin_theta * sin_omegadt[j];
+                sin_omegat[j] =
+                    sin_theta * cos_omegadt[j] +
+                    cos_theta * sin_omegadt[j];
+            }
+            evaluate_circle_(cos_omegat, sin_omegat, omega, m,
+                             s + k0, ds_dt ? ds_dt + k0 : nullptr);
+        }
+    }
+
 private:
 
+#if !DOXYGEN
+
+    /**
+     * @brief Evaluate at points on circle, given by angle cosines
+     * and sines.
+     */
+    void evaluate_circle_(
+            const float_type* cos_omegat,
+            const float_type* sin_omegat,
+            float_type omega,
+            std::size_t m,
+            float_type* s,
+            float_type* ds_dt) const
+    {
+        // Points per group.
+        constexpr std::size_t lanes = 64;
+
+        // Circle.
+        float_type u[2][lanes];
+        for (std::size_t j = 0; j < m; j++) {
+            u[0][j] = c0_[0] + r0_ * cos_omegat[j];
+            u[1][j] = c0_[1] + r0_ * sin_omegat[j];
+        }
+
+        // Delegate.
+        float_type ds_du[2][lanes];
+        Tnoise2::evaluate_many(
+            {u[0], u[1]}, m, s,
+            ds_dt ?
+            multi<float_type*, 2>{ds_du[0], ds_du[1]} :
+            multi<float_type*, 2>{});
+        if (ds_dt) {
+
+            // Chain rule.
+            for (std::size_t j = 0; j < m; j++) {
+                ds_dt[j] =
+                    ds_du[0][j] * (r0_ * omega) * -sin_omegat[j] +
+                    ds_du[1][j] * (r0_ * omega) * +cos_omegat[j];
+            }
+        }
+    }
+
+#endif // #if !DOXYGEN
+
     /**
      * @brief Center @f$ \mathbf{c}_0 @f$.
      */
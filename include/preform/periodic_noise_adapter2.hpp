@@ -35,9 +35,15 @@
 #ifndef PREFORM_PERIODIC_NOISE_ADAPTER2_HPP
 #define PREFORM_PERIODIC_NOISE_ADAPTER2_HPP
 
+// for std::min
+#include <algorithm>
+
 // for std::forward
 #include <utility>
 
+// for std::vector
+#include <vector>
+
 // for pre::multi
 #include <preform/multi.hpp>
 
@@ -145,6 +151,159 @@ public:
         return s;
     }
 
+    /**
+     * @brief Evaluate many.
+     *
+     * Equivalent to `evaluate()` at each point, for coordinates in
+     * structure-of-arrays layout. Points go in groups of 64, each
+     * mapped onto the torus and delegated to the noise function's
+     * `evaluate_many()` at once.
+     *
+     * @param[in] t
+     * Coordinate arrays, one per dimension.
+     *
+     * @param[in] n
+     * Count.
+     *
+     * @param[out] s
+     * Noise values.
+     *
+     * @param[out] ds_dt
+     * Noise partial derivative arrays, one per dimension. _Optional_.
+     *
+     * @note
+     * Requires that the noise function has `evaluate_many()`, e.g.,
+     * `pre::simplex_noise3` or `pre::worley_noise3`.
+     */
+    void evaluate_many(
+            multi<const float_type*, 2> t,
+            std::size_t n,
+            float_type* s,
+            multi<float_type*, 2> ds_dt = {}) const
+    {
+        // Points per group.
+        constexpr std::size_t lanes = 64;
+
+        float_type pi = pre::numeric_constants<float_type>::M_pi();
+        multi<float_type, 2> omega = 2 * pi / t0_;
+        bool want_ds_dt = ds_dt[0] || ds_dt[1];
+        for (std::size_t k0 = 0; k0 < n; k0 += lanes) {
+            std::size_t m = std::min(lanes, n - k0);
+
+            // Torus.
+            float_type cos_omegat[2][lanes];
+            float_type sin_omegat[2][lanes];
+            float_type u[3][lanes];
+            for (std::size_t j = 0; j < m; j++) {
+                for (int d = 0; d < 2; d++) {
+                    cos_omegat[d][j] = pre::cos(omega[d] * t[d][k0 + j]);
+                    sin_omegat[d][j] = pre::sin(omega[d] * t[d][k0 + j]);
+                }
+                float_type rho = r0_[0] + r0_[1] * cos_omegat[1][j];
+                u[0][j] = c0_[0] + rho * cos_omegat[0][j];
+                u[1][j] = c0_[1] + rho * sin_omegat[0][j];
+                u[2][j] = c0_[2] + r0_[1] * sin_omegat[1][j];
+            }
+
+            // Delegate.
+            float_type ds_du[3][lanes];
+            Tnoise3::evaluate_many(
+                {u[0], u[1], u[2]}, m, s + k0,
+                want_ds_dt ?
+                multi<float_type*, 3>{ds_du[0], ds_du[1], ds_du[2]} :
+                multi<float_type*, 3>{});
+            if (want_ds_dt) {
+                for (std::size_t j = 0; j < m; j++) {
+
+                    // Torus partial derivatives and chain rule.
+                    float_type tmp0 =
+                        omega[0] * (r0_[0] + r0_[1] * cos_omegat[1][j]);
+                    float_type tmp1 = omega[1] * r0_[1];
+                    multi<float_type, 2> ds_dtj = {
+                        tmp0 * (ds_du[1][j] * cos_omegat[0][j] -
+                                ds_du[0][j] * sin_omegat[0][j]),
+                        tmp1 * (ds_du[2][j] * cos_omegat[1][j] -
+                               (ds_du[0][j] * cos_omegat[0][j] +
+                                ds_du[1][j] * sin_omegat[0][j]) *
+                                sin_omegat[1][j])
+                    };
+                    for (int d = 0; d < 2; d++) {
+                        if (ds_dt[d]) {
+                            ds_dt[d][k0 + j] = ds_dtj[d];
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Evaluate on grid.
+     *
+     * Fills `image` such that entry @f$ (k_0, k_1) @f$ is the noise
+     * at @f$ t_0 + \Delta t \odot (k_0, k_1) @f$, in every channel.
+     * Trigonometric functions depend only on row or column, so they
+     * are tabulated once per axis, and each row maps onto the torus
+     * with multiply-adds only, then delegates to the noise function's
+     * `evaluate_many()` at once.
+     *
+     * @param[out] image
+     * Image, e.g., `pre::image2`, whose value type must be
+     * constructible from float type.
+     *
+     * @param[in] t0
+     * Coordinate of entry @f$ (0, 0) @f$.
+     *
+     * @param[in] dt
+     * Coordinate increment per entry.
+     *
+     * @note
+     * Requires that the noise function has `evaluate_many()`, e.g.,
+     * `pre::simplex_noise3` or `pre::worley_noise3`.
+     */
+    template <typename Timage>
+    void evaluate_grid(
+            Timage& image,
+            multi<float_type, 2> t0,
+            multi<float_type, 2> dt) const
+    {
+        typedef typename Timage::value_type value_type;
+        std::size_t size0 = image.user_size()[0];
+        std::size_t size1 = image.user_size()[1];
+        float_type pi = pre::numeric_constants<float_type>::M_pi();
+        multi<float_type, 2> omega = 2 * pi / t0_;
+
+        // Tables. Ring radius and height depend only on column.
+        std::vector<float_type> buf(2 * size0 + 5 * size1);
+        float_type* cos0 = buf.data();
+        float_type* sin0 = cos0 + size0;
+        float_type* rho1 = sin0 + size0;
+        float_type* buf0 = rho1 + size1;
+        float_type* buf1 = buf0 + size1;
+        float_type* buf2 = buf1 + size1;
+        float_type* bufs = buf2 + size1;
+        for (std::size_t k0 = 0; k0 < size0; k0++) {
+            float_type theta = omega[0] * (t0[0] + dt[0] * float_type(k0));
+            cos0[k0] = pre::cos(theta);
+            sin0[k0] = pre::sin(theta);
+        }
+        for (std::size_t k1 = 0; k1 < size1; k1++) {
+            float_type theta = omega[1] * (t0[1] + dt[1] * float_type(k1));
+            rho1[k1] = r0_[0] + r0_[1] * pre::cos(theta);
+            buf2[k1] = c0_[2] + r0_[1] * pre::sin(theta);
+        }
+        for (std::size_t k0 = 0; k0 < size0; k0++) {
+            for (std::size_t k1 = 0; k1 < size1; k1++) {
+                buf0[k1] = c0_[0] + rho1[k1] * cos0[k0];
+                buf1[k1] = c0_[1] + rho1[k1] * sin0[k0];
+            }
+            Tnoise3::evaluate_many({buf0, buf1, buf2}, size1, bufs);
+            for (std::size_t k1 = 0; k1 < size1; k1++) {
+                image(k0, k1) = value_type(bufs[k1]);
+            }
+        }
+    }
+
 private:
 
     /**
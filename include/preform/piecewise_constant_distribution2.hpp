@@ -0,0 +1,762 @@
+/* Copyright (c) 2018-20 M. Grady Saunders
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer.
+ *
+ *   2. Redistributions in binary form must reproduce the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer in the documentation and/or other materials
+ *      provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*+-+*/
+#if !DOXYGEN
+#if !(__cplusplus >= 201703L)
+#error "preform/piecewise_constant_distribution2.hpp requires >=C++17"
+#endif // #if !(__cplusplus >= 201703L)
+#endif // #if !DOXYGEN
+#pragma once
+#ifndef PREFORM_PIECEWISE_CONSTANT_DISTRIBUTION2_HPP
+#define PREFORM_PIECEWISE_CONSTANT_DISTRIBUTION2_HPP
+
+// for std::min, std::upper_bound
+#include <algorithm>
+
+// for std::size_t
+#include <cstddef>
+
+// for std::invalid_argument, std::runtime_error
+#include <stdexcept>
+
+// for std::enable_if_t, std::is_invocable
+#include <type_traits>
+
+// for std::forward
+#include <utility>
+
+// for std::vector
+#include <vector>
+
+// for pre::first1, pre::roundpow2
+#include <preform/misc_int.hpp>
+
+// for pre::multi
+#include <preform/multi.hpp>
+
+// for pre::neumaier_sum
+#include <preform/neumaier_sum.hpp>
+
+// for pre::generate_canonical
+#include <preform/random.hpp>
+
+namespace pre {
+
+/**
+ * @defgroup piecewise_constant_distribution2 Piecewise constant distribution (2-dimensional)
+ *
+ * `<preform/piecewise_constant_distribution2.hpp>`
+ *
+ * __C++ version__: >=C++17
+ */
+/**@{*/
+
+/**
+ * @brief Piecewise constant distribution (2-dimensional).
+ *
+ * Distribution on the unit square with constant density in each cell
+ * of a @f$ n_0 \times n_1 @f$ grid, e.g., for importance sampling
+ * image luminance, where location @f$ \mathbf{x} @f$ corresponds to
+ * `image2` location @f$ \mathbf{x} \odot \mathbf{n} @f$. Offers three
+ * sampling methods, which all have density `pdf()`:
+ * - `cdfinv()`, by marginal and conditional inverse transform,
+ * - `alias_sample()`, by alias table over cells, in @f$ O(1) @f$, and
+ * - `warp()`, by descending a pyramid of cell masses, padded to
+ * powers of 2, in @f$ O(\log n) @f$ with no data-dependent trip
+ * counts.
+ *
+ * Like `cdfinv()`, `warp()` is continuous almost everywhere, and so
+ * preserves the stratification of its input. The densities, the
+ * marginal and conditional CDFs, and the pyramid share one contiguous
+ * buffer.
+ *
+ * @tparam T
+ * Float type.
+ */
+template <typename T = double>
+class piecewise_constant_distribution2
+{
+public:
+
+    // Sanity check.
+    static_assert(
+        std::is_floating_point<T>::value,
+        "T must be floating point");
+
+    /**
+     * @brief Value type.
+     */
+    typedef multi<T, 2> value_type;
+
+    /**
+     * @brief Float type.
+     */
+    typedef T float_type;
+
+    /**
+     * @brief Sample mode, for `operator()`.
+     */
+    enum class sample_mode {
+
+        /**
+         * @brief By `cdfinv()`.
+         */
+        cdfinv,
+
+        /**
+         * @brief By `alias_sample()`.
+         */
+        alias,
+
+        /**
+         * @brief By `warp()`.
+         */
+        warp
+    };
+
+    /**
+     * @brief Default constructor.
+     */
+    piecewise_constant_distribution2() = default;
+
+    /**
+     * @brief Constructor.
+     *
+     * @param[in] size
+     * Grid size.
+     *
+     * @param[in] func
+     * Function with signature equivalent to `float_type(int, int)`,
+     * returning the weight of each cell, e.g., the luminance of each
+     * image entry.
+     *
+     * @param[in] mode
+     * Sample mode.
+     *
+     * @throw std::invalid_argument
+     * Unless
+     * - `(size > 0).all()`,
+     * - weights are non-negative, and
+     * - weights have non-zero sum.
+     */
+    template <
+        typename Tfunc,
+        typename = std::enable_if_t<std::is_invocable<Tfunc, int, int>::value>
+        >
+    piecewise_constant_distribution2(
+            multi<int, 2> size,
+            Tfunc&& func,
+            sample_mode mode = sample_mode::cdfinv) : mode_(mode)
+    {
+        init_(size, std::forward<Tfunc>(func));
+    }
+
+    /**
+     * @brief Constructor.
+     *
+     * @param[in] size
+     * Grid size.
+     *
+     * @param[in] weights
+     * Weights, in row-major order such that cell @f$ (k_0, k_1) @f$
+     * is at @f$ k_0 n_1 + k_1 @f$.
+     *
+     * @param[in] mode
+     * Sample mode.
+     */
+    piecewise_constant_distribution2(
+            multi<int, 2> size,
+            const float_type* weights,
+            sample_mode mode = sample_mode::cdfinv) : mode_(mode)
+    {
+        init_(size, [=](int k0, int k1) {
+            return weights[std::size_t(k0) * size[1] + k1];
+        });
+    }
+
+    /**
+     * @brief Grid size.
+     */
+    multi<int, 2> size() const noexcept
+    {
+        return size_;
+    }
+
+    /**
+     * @brief Get sample mode.
+     */
+    sample_mode mode() const noexcept
+    {
+        return mode_;
+    }
+
+    /**
+     * @brief Set sample mode, return previous sample mode.
+     */
+    sample_mode mode(sample_mode val) noexcept
+    {
+        sample_mode mode = mode_; mode_ = val; return mode;
+    }
+
+    /**
+     * @brief Probability density function.
+     *
+     * @throw std::runtime_error
+     * If empty.
+     */
+    float_type pdf(value_type x) const
+    {
+        // Invalid?
+        if (buffer_.empty()) {
+            throw std::runtime_error(__PRETTY_FUNCTION__);
+        }
+
+        if (!(x[0] >= float_type(0) && x[0] < float_type(1) &&
+              x[1] >= float_type(0) && x[1] < float_type(1))) {
+            return 0;
+        }
+        int k0 = std::min(int(x[0] * size_[0]), size_[0] - 1);
+        int k1 = std::min(int(x[1] * size_[1]), size_[1] - 1);
+        return buffer_[std::size_t(k0) * size_[1] + k1];
+    }
+
+    /**
+     * @brief Sample by marginal and conditional inverse transform.
+     *
+     * @param[in] u
+     * Sample in @f$ [0, 1)^2 @f$.
+     *
+     * @throw std::runtime_error
+     * If empty.
+     */
+    value_type cdfinv(value_type u) const
+    {
+        // Invalid?
+        if (buffer_.empty()) {
+            throw std::runtime_error(__PRETTY_FUNCTION__);
+        }
+
+        // Marginal.
+        const float_type* cdf0 = &buffer_[marginal_offset_];
+        int k0 = lookup_(cdf0, size_[0], u[0]);
+        float_type t0 =
+            (u[0] - cdf0[k0]) / (cdf0[k0 + 1] - cdf0[k0]);
+
+        // Conditional.
+        const float_type* cdf1 =
+            &buffer_[conditional_offset_ +
+                     std::size_t(k0) * (size_[1] + 1)];
+        int k1 = lookup_(cdf1, size_[1], u[1]);
+        float_type t1 =
+            (u[1] - cdf1[k1]) / (cdf1[k1 + 1] - cdf1[k1]);
+
+        return {
+            (k0 + t0) / size_[0],
+            (k1 + t1) / size_[1]
+        };
+    }
+
+    /**
+     * @brief Sample by alias table.
+     *
+     * @param[in] u
+     * Sample in @f$ [0, 1)^3 @f$. The first component selects a
+     * cell, the second the alias coin and position in the first
+     * dimension, and the third position in the second dimension.
+     *
+     * @throw std::runtime_error
+     * If empty.
+     */
+    value_type alias_sample(multi<float_type, 3> u) const
+    {
+        // Invalid?
+        if (buffer_.empty()) {
+            throw std::runtime_error(__PRETTY_FUNCTION__);
+        }
+
+        int n = int(alias_.size());
+        int k = std::min(int(u[0] * n), n - 1);
+        const alias_entry& entry = alias_[k];
+        float_type t0 = 0;
+        if (u[1] < entry.prob) {
+            t0 = u[1] / entry.prob;
+        }
+        else {
+            k = entry.alias;
+            t0 = (u[1] - entry.prob) / (1 - entry.prob);
+        }
+        int k0 = k / size_[1];
+        int k1 = k % size_[1];
+        return {
+            (k0 + t0) / size_[0],
+            (k1 + u[2]) / size_[1]
+        };
+    }
+
+    /**
+     * @brief Sample by hierarchical warp.
+     *
+     * @param[in] u
+     * Sample in @f$ [0, 1)^2 @f$.
+     *
+     * @throw std::runtime_error
+     * If empty.
+     */
+    value_type warp(value_type u) const
+    {
+        value_type x;
+        warp_many(&u, 1, &x);
+        return x;
+    }
+
+    /**
+     * @brief Sample many by marginal and conditional inverse transform.
+     *
+     * @param[in] u
+     * Samples in @f$ [0, 1)^2 @f$.
+     *
+     * @param[in] n
+     * Count.
+     *
+     * @param[out] x
+     * Locations.
+     *
+     * @param[out] f
+     * Densities. _Optional_.
+     */
+    void cdfinv_many(
+            const value_type* u,
+            std::size_t n,
+            value_type* x,
+            float_type* f = nullptr) const
+    {
+        for (std::size_t k = 0; k < n; k++) {
+            x[k] = cdfinv(u[k]);
+            if (f) {
+                f[k] = pdf(x[k]);
+            }
+        }
+    }
+
+    /**
+     * @brief Sample many by alias table.
+     *
+     * @param[in] u
+     * Samples in @f$ [0, 1)^3 @f$.
+     *
+     * @param[in] n
+     * Count.
+     *
+     * @param[out] x
+     * Locations.
+     *
+     * @param[out] f
+     * Densities. _Optional_.
+     */
+    void alias_sample_many(
+            const multi<float_type, 3>* u,
+            std::size_t n,
+            value_type* x,
+            float_type* f = nullptr) const
+    {
+        for (std::size_t k = 0; k < n; k++) {
+            x[k] = alias_sample(u[k]);
+            if (f) {
+                f[k] = pdf(x[k]);
+            }
+        }
+    }
+
+    /**
+     * @brief Sample many by hierarchical warp.
+     *
+     * Samples go in groups of 16, descending the pyramid one level
+     * at a time for the whole group, since every sample takes the
+     * same number of steps.
+     *
+     * @param[in] u
+     * Samples in @f$ [0, 1)^2 @f$.
+     *
+     * @param[in] n
+     * Count.
+     *
+     * @param[out] x
+     * Locations.
+     *
+     * @param[out] f
+     * Densities. _Optional_.
+     *
+     * @throw std::runtime_error
+     * If empty.
+     */
+    void warp_many(
+            const value_type* u,
+            std::size_t n,
+            value_type* x,
+            float_type* f = nullptr) const
+    {
+        // Invalid?
+        if (buffer_.empty()) {
+            throw std::runtime_error(__PRETTY_FUNCTION__);
+        }
+
+        // Samples per group.
+        constexpr std::size_t lanes = 16;
+
+        int nlevels = int(level_offsets_.size());
+        for (std::size_t k0 = 0; k0 < n; k0 += lanes) {
+            std::size_t m = std::min(lanes, n - k0);
+            float_type u0[lanes] = {};
+            float_type u1[lanes] = {};
+            int i[lanes] = {};
+            int j[lanes] = {};
+            for (std::size_t l = 0; l < m; l++) {
+                u0[l] = u[k0 + l][0];
+                u1[l] = u[k0 + l][1];
+            }
+
+            // Descend.
+            for (int lev = nlevels - 1; lev > 0; lev--) {
+                multi<int, 2> dim = level_size_(lev);
+                multi<int, 2> sub = level_size_(lev - 1);
+                const float_type* w = &buffer_[level_offsets_[lev - 1]];
+                bool split0 = sub[0] > dim[0];
+                bool split1 = sub[1] > dim[1];
+                for (std::size_t l = 0; l < m; l++) {
+                    int jl = split1 ? 2 * j[l] : j[l];
+                    int il = split0 ? 2 * i[l] : i[l];
+                    const float_type* w0 = w + std::size_t(il) * sub[1] + jl;
+                    if (split0) {
+                        const float_type* w1 = w0 + sub[1];
+                        float_type a = w0[0] + (split1 ? w0[1] : 0);
+                        float_type b = w1[0] + (split1 ? w1[1] : 0);
+                        if (choose_(a, b, u0[l])) {
+                            il++;
+                            w0 = w1;
+                        }
+                    }
+                    if (split1) {
+                        if (choose_(w0[0], w0[1], u1[l])) {
+                            jl++;
+                        }
+                    }
+                    i[l] = il;
+                    j[l] = jl;
+                }
+            }
+            for (std::size_t l = 0; l < m; l++) {
+                x[k0 + l] = {
+                    (i[l] + u0[l]) / size_[0],
+                    (j[l] + u1[l]) / size_[1]
+                };
+                if (f) {
+                    f[k0 + l] =
+                        buffer_[std::size_t(i[l]) * size_[1] + j[l]];
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Generate number.
+     */
+    template <typename G>
+    value_type operator()(G&& gen) const
+    {
+        switch (mode_) {
+            case sample_mode::alias:
+                return alias_sample(
+                    multi<float_type, 3>{
+                        pre::generate_canonical<float_type>(gen),
+                        pre::generate_canonical<float_type>(gen),
+                        pre::generate_canonical<float_type>(gen)
+                    });
+            case sample_mode::warp:
+                return warp(
+                    value_type{
+                        pre::generate_canonical<float_type>(gen),
+                        pre::generate_canonical<float_type>(gen)
+                    });
+            default:
+                return cdfinv(
+                    value_type{
+                        pre::generate_canonical<float_type>(gen),
+                        pre::generate_canonical<float_type>(gen)
+                    });
+        }
+    }
+
+private:
+
+    /**
+     * @brief Alias table entry.
+     */
+    struct alias_entry
+    {
+        /**
+         * @brief Probability of keeping this entry.
+         */
+        float_type prob = 1;
+
+        /**
+         * @brief Alias.
+         */
+        int alias = 0;
+    };
+
+    /**
+     * @brief Sample mode.
+     */
+    sample_mode mode_ = sample_mode::cdfinv;
+
+    /**
+     * @brief Grid size.
+     */
+    multi<int, 2> size_ = {};
+
+    /**
+     * @brief Pyramid level 0 size, rounded up to powers of 2.
+     */
+    multi<int, 2> size_pow2_ = {};
+
+    /**
+     * @brief Buffer.
+     *
+     * In order,
+     * - densities, @f$ n_0 n_1 @f$,
+     * - marginal CDF, @f$ n_0 + 1 @f$,
+     * - conditional CDFs, @f$ n_0 (n_1 + 1) @f$, and
+     * - pyramid levels of cell masses, from full resolution to 1 cell.
+     */
+    std::vector<float_type> buffer_;
+
+    /**
+     * @brief Marginal CDF offset.
+     */
+    std::size_t marginal_offset_ = 0;
+
+    /**
+     * @brief Conditional CDFs offset.
+     */
+    std::size_t conditional_offset_ = 0;
+
+    /**
+     * @brief Pyramid level offsets.
+     */
+    std::vector<std::size_t> level_offsets_;
+
+    /**
+     * @brief Alias table over cells.
+     */
+    std::vector<alias_entry> alias_;
+
+    /**
+     * @brief Pyramid level size.
+     */
+    multi<int, 2> level_size_(int lev) const
+    {
+        return {
+            std::max(size_pow2_[0] >> lev, 1),
+            std::max(size_pow2_[1] >> lev, 1)
+        };
+    }
+
+    /**
+     * @brief Lookup interval in CDF of @f$ n + 1 @f$ entries.
+     */
+    static int lookup_(const float_type* cdf, int n, float_type u)
+    {
+        int k = int(std::upper_bound(cdf, cdf + n + 1, u) - cdf) - 1;
+        return std::min(std::max(k, 0), n - 1);
+    }
+
+    /**
+     * @brief Choose between masses, and rescale sample.
+     *
+     * @return
+     * False to choose `a`, true to choose `b`.
+     */
+    static bool choose_(float_type a, float_type b, float_type& u)
+    {
+        float_type p = a / (a + b);
+        bool choice = !(u < p);
+        u = choice ? (u - p) / (1 - p) : u / p;
+        u = std::min(u, pre::nextafter(float_type(1), float_type(0)));
+        return choice;
+    }
+
+    /**
+     * @brief Initialize.
+     */
+    template <typename Tfunc>
+    void init_(multi<int, 2> size, Tfunc&& func)
+    {
+        // Invalid?
+        if (!(size[0] > 0 && size[1] > 0)) {
+            throw std::invalid_argument(__PRETTY_FUNCTION__);
+        }
+        size_ = size;
+        size_pow2_ = {roundpow2(size[0]), roundpow2(size[1])};
+        std::size_t n = std::size_t(size[0]) * size[1];
+
+        // Layout.
+        marginal_offset_ = n;
+        conditional_offset_ = marginal_offset_ + size[0] + 1;
+        std::size_t offset = conditional_offset_ +
+                             std::size_t(size[0]) * (size[1] + 1);
+        int nlevels = 1 + first1(std::max(size_pow2_[0], size_pow2_[1]));
+        level_offsets_.resize(nlevels);
+        for (int lev = 0; lev < nlevels; lev++) {
+            level_offsets_[lev] = offset;
+            offset += std::size_t(level_size_(lev).prod());
+        }
+        buffer_.assign(offset, 0);
+
+        // Weights.
+        neumaier_sum<float_type> total = 0;
+        for (int k0 = 0; k0 < size[0]; k0++)
+        for (int k1 = 0; k1 < size[1]; k1++) {
+            float_type w = func(k0, k1);
+            if (!(w >= 0)) {
+                throw std::invalid_argument(__PRETTY_FUNCTION__);
+            }
+            buffer_[std::size_t(k0) * size[1] + k1] = w;
+            total += w;
+        }
+        if (!(float_type(total) > 0)) {
+            throw std::invalid_argument(__PRETTY_FUNCTION__);
+        }
+
+        // Conditional and marginal CDFs.
+        float_type* cdf0 = &buffer_[marginal_offset_];
+        neumaier_sum<float_type> sum0 = 0;
+        for (int k0 = 0; k0 < size[0]; k0++) {
+            const float_type* w = &buffer_[std::size_t(k0) * size[1]];
+            float_type* cdf1 =
+                &buffer_[conditional_offset_ +
+                         std::size_t(k0) * (size[1] + 1)];
+            neumaier_sum<float_type> sum1 = 0;
+            for (int k1 = 0; k1 < size[1]; k1++) {
+                sum1 += w[k1];
+                cdf1[k1 + 1] = float_type(sum1);
+            }
+            float_type fac1 = cdf1[size[1]];
+            for (int k1 = 1; k1 <= size[1]; k1++) {
+                cdf1[k1] = fac1 > 0 ? cdf1[k1] / fac1 : 0;
+            }
+            cdf1[size[1]] = 1;
+            sum0 += fac1;
+            cdf0[k0 + 1] = float_type(sum0) / float_type(total);
+        }
+        cdf0[size[0]] = 1;
+
+        // Pyramid of masses, padded with zeros.
+        float_type* base = &buffer_[level_offsets_[0]];
+        for (int k0 = 0; k0 < size[0]; k0++)
+        for (int k1 = 0; k1 < size[1]; k1++) {
+            base[std::size_t(k0) * size_pow2_[1] + k1] =
+                buffer_[std::size_t(k0) * size[1] + k1] /
+                float_type(total);
+        }
+        for (int lev = 1; lev < nlevels; lev++) {
+            multi<int, 2> dim = level_size_(lev);
+            multi<int, 2> sub = level_size_(lev - 1);
+            const float_type* w = &buffer_[level_offsets_[lev - 1]];
+            float_type* v = &buffer_[level_offsets_[lev]];
+            int r0 = sub[0] / dim[0];
+            int r1 = sub[1] / dim[1];
+            for (int k0 = 0; k0 < dim[0]; k0++)
+            for (int k1 = 0; k1 < dim[1]; k1++) {
+                float_type sum = 0;
+                for (int l0 = 0; l0 < r0; l0++)
+                for (int l1 = 0; l1 < r1; l1++) {
+                    sum += w[std::size_t(k0 * r0 + l0) * sub[1] +
+                                        (k1 * r1 + l1)];
+                }
+                v[std::size_t(k0) * dim[1] + k1] = sum;
+            }
+        }
+
+        // Alias table.
+        build_alias_(float_type(total));
+
+        // Densities.
+        float_type fac = float_type(n) / float_type(total);
+        for (std::size_t k = 0; k < n; k++) {
+            buffer_[k] *= fac;
+        }
+    }
+
+    /**
+     * @brief Build alias table, by Vose's method.
+     */
+    void build_alias_(float_type total)
+    {
+        int n = size_[0] * size_[1];
+        alias_.assign(n, alias_entry());
+        std::vector<float_type> q(n);
+        std::vector<int> small;
+        std::vector<int> large;
+        small.reserve(n);
+        large.reserve(n);
+        for (int k = 0; k < n; k++) {
+            q[k] = buffer_[k] / total * n;
+            if (q[k] < 1) {
+                small.push_back(k);
+            }
+            else {
+                large.push_back(k);
+            }
+        }
+        while (!small.empty() && !large.empty()) {
+            int ks = small.back(); small.pop_back();
+            int kl = large.back();
+            alias_[ks].prob = q[ks];
+            alias_[ks].alias = kl;
+            q[kl] = (q[kl] + q[ks]) - 1;
+            if (q[kl] < 1) {
+                large.pop_back();
+                small.push_back(kl);
+            }
+        }
+        for (int k : large) {
+            alias_[k].prob = 1;
+            alias_[k].alias = k;
+        }
+        for (int k : small) {
+            alias_[k].prob = 1;
+            alias_[k].alias = k;
+        }
+    }
+};
+
+/**@}*/
+
+} // namespace pre
+
+#endif // #ifndef PREFORM_PIECEWISE_CONSTANT_DISTRIBUTION2_HPP
@@ -0,0 +1,689 @@
+/* Copyright (c) 2018-20 M. Grady Saunders
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer.
+ *
+ *   2. Redistributions in binary form must reproduce the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer in the documentation and/or other materials
+ *      provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*+-+*/
+#if !DOXYGEN
+#if !(__cplusplus >= 201703L)
+#error "preform/profile.hpp requires >=C++17"
+#endif // #if !(__cplusplus >= 201703L)
+#endif // #if !DOXYGEN
+#pragma once
+#ifndef PREFORM_PROFILE_HPP
+#define PREFORM_PROFILE_HPP
+
+#if !DOXYGEN
+#ifndef PREFORM_PROFILE
+#define PREFORM_PROFILE 0
+#endif // #ifndef PREFORM_PROFILE
+#endif // #if !DOXYGEN
+
+// for std::sort
+#include <algorithm>
+
+// for std::atomic
+#include <atomic>
+
+// for std::chrono
+#include <chrono>
+
+// for std::uint32_t, std::uint64_t
+#include <cstdint>
+
+// for std::setw, std::left, std::right, ...
+#include <iomanip>
+
+// for std::map
+#include <map>
+
+// for std::unique_ptr
+#include <memory>
+
+// for std::mutex, std::lock_guard
+#include <mutex>
+
+// for std::basic_ostream
+#include <ostream>
+
+// for std::string
+#include <string>
+
+// for std::tuple
+#include <tuple>
+
+// for std::vector
+#include <vector>
+
+#if __x86_64__ || __i386__
+// for __rdtsc
+#include <x86intrin.h>
+#endif // #if __x86_64__ || __i386__
+
+// for pre::steady_timer
+#include <preform/timer.hpp>
+
+namespace pre {
+
+/**
+ * @defgroup profile Profile
+ *
+ * `<preform/profile.hpp>`
+ *
+ * __C++ version__: >=C++17
+ *
+ * Hierarchical profiling zones. `PREFORM_PROFILE_ZONE(name)` opens a
+ * zone with a static name until the end of the enclosing scope. Each
+ * thread appends events to its own buffer without locking, and
+ * `profiler` aggregates them into per-zone statistics or exports them
+ * in the Chrome trace event format (for `chrome://tracing` or
+ * Perfetto).
+ *
+ * Zones record only if `PREFORM_PROFILE` is defined to 1 before
+ * including this or any header using it. Otherwise, the macro expands
+ * to nothing and no code is generated. Zones in the library mark
+ * `aabbtree` construction, `image2`/`image3` resampling, and
+ * microsurface random walks.
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~{cpp}
+ * void render()
+ * {
+ *     PREFORM_PROFILE_ZONE("render");
+ *     ...
+ * }
+ * ...
+ * pre::profiler::instance().write_report(std::cout);
+ * std::ofstream ofs("trace.json");
+ * pre::profiler::instance().write_chrome_trace(ofs);
+ * ~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+/**@{*/
+
+/**
+ * @brief Profile zone, with static storage.
+ */
+struct profile_zone
+{
+    /**
+     * @brief Name.
+     */
+    const char* name;
+
+    /**
+     * @brief File.
+     */
+    const char* file;
+
+    /**
+     * @brief Line.
+     */
+    int line;
+};
+
+/**
+ * @brief Profile event.
+ */
+struct profile_event
+{
+    /**
+     * @brief Zone.
+     */
+    const profile_zone* zone;
+
+    /**
+     * @brief Begin tick.
+     */
+    std::uint64_t begin;
+
+    /**
+     * @brief End tick.
+     */
+    std::uint64_t end;
+
+    /**
+     * @brief Depth, for zones open in the same thread.
+     */
+    std::uint32_t depth;
+};
+
+/**
+ * @brief Profile zone statistics.
+ */
+struct profile_zone_stats
+{
+    /**
+     * @brief Zone.
+     */
+    const profile_zone* zone = nullptr;
+
+    /**
+     * @brief Count.
+     */
+    std::size_t count = 0;
+
+    /**
+     * @brief Total seconds.
+     */
+    double total = 0;
+
+    /**
+     * @brief Total seconds, excluding nested zones.
+     */
+    double self = 0;
+
+    /**
+     * @brief Minimum seconds.
+     */
+    double min = 0;
+
+    /**
+     * @brief Maximum seconds.
+     */
+    double max = 0;
+};
+
+/**
+ * @brief Profiler.
+ *
+ * Process-wide registry of per-thread event buffers. Each buffer is
+ * a list of fixed-size chunks, written only by its thread, which
+ * publishes events with release stores, so that recording never locks
+ * and reading sees only complete events.
+ *
+ * @note
+ * Ticks are the time stamp counter on x86, and `steady_clock`
+ * nanoseconds otherwise. Tick length is calibrated against
+ * `steady_timer`.
+ */
+class profiler
+{
+public:
+
+    /**
+     * @brief Events per buffer chunk.
+     */
+    static constexpr std::size_t chunk_size = 4096;
+
+    /**
+     * @brief Thread buffer.
+     */
+    class thread_buffer
+    {
+    public:
+
+        /**
+         * @brief Constructor.
+         */
+        thread_buffer(std::uint32_t tid) :
+                tid_(tid),
+                head_(new chunk_type()),
+                tail_(head_.get())
+        {
+        }
+
+        /**
+         * @brief Push event, from owning thread.
+         */
+        void push(const profile_event& event)
+        {
+            std::size_t count = tail_->count.load(std::memory_order_relaxed);
+            if (count == chunk_size) {
+                chunk_type* next = new chunk_type();
+                tail_->next.reset(next);
+                tail_->next_ptr.store(next, std::memory_order_release);
+                tail_ = next;
+                count = 0;
+            }
+            tail_->events[count] = event;
+            tail_->count.store(count + 1, std::memory_order_release);
+        }
+
+        /**
+         * @brief Thread index.
+         */
+        std::uint32_t tid() const noexcept
+        {
+            return tid_;
+        }
+
+        /**
+         * @brief Open zone depth.
+         */
+        std::uint32_t depth = 0;
+
+    private:
+
+        /**
+         * @brief Chunk.
+         */
+        struct chunk_type
+        {
+            profile_event events[chunk_size];
+
+            std::atomic<std::size_t> count = {0};
+
+            std::atomic<chunk_type*> next_ptr = {nullptr};
+
+            std::unique_ptr<chunk_type> next;
+        };
+
+        /**
+         * @brief Thread index.
+         */
+        std::uint32_t tid_;
+
+        /**
+         * @brief Head chunk.
+         */
+        std::unique_ptr<chunk_type> head_;
+
+        /**
+         * @brief Tail chunk, written by owning thread.
+         */
+        chunk_type* tail_;
+
+        // Friend profiler.
+        friend class profiler;
+    };
+
+public:
+
+    /**
+     * @brief Instance.
+     */
+    static profiler& instance()
+    {
+        static profiler inst;
+        return inst;
+    }
+
+    /**
+     * @brief Current tick.
+     */
+    __attribute__((always_inline))
+    static std::uint64_t now() noexcept
+    {
+#if __x86_64__ || __i386__
+        return __rdtsc();
+#else
+        return std::uint64_t(
+               std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+                    .count());
+#endif // #if __x86_64__ || __i386__
+    }
+
+    /**
+     * @brief Buffer of calling thread.
+     */
+    static thread_buffer& local()
+    {
+        thread_local thread_buffer* buffer = instance().register_();
+        return *buffer;
+    }
+
+    /**
+     * @brief Seconds per tick.
+     */
+    double seconds_per_tick() const
+    {
+        // Wait for at least 10ms since construction.
+        std::int64_t ns;
+        while ((ns = timer_.read<std::nano>()) < 10000000) {
+        }
+        return double(ns) * 1e-9 / double(now() - tick0_);
+    }
+
+    /**
+     * @brief Events of all threads, with thread indices.
+     *
+     * @note
+     * Sees events complete at the time of the call.
+     */
+    std::vector<std::pair<std::uint32_t, profile_event>> events() const
+    {
+        std::vector<std::pair<std::uint32_t, profile_event>> res;
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& buffer : buffers_) {
+            const thread_buffer::chunk_type* chunk = buffer->head_.get();
+            while (chunk) {
+                std::size_t count =
+                    chunk->count.load(std::memory_order_acquire);
+                for (std::size_t k = 0; k < count; k++) {
+                    res.emplace_back(buffer->tid_, chunk->events[k]);
+                }
+                chunk = chunk->next_ptr.load(std::memory_order_acquire);
+            }
+        }
+        return res;
+    }
+
+    /**
+     * @brief Per-zone statistics, in decreasing order of total time.
+     *
+     * Zones with the same name, file, and line, e.g., in different
+     * instantiations of the same template, aggregate together.
+     */
+    std::vector<profile_zone_stats> report() const
+    {
+        double spt = seconds_per_tick();
+        auto evs = events();
+
+        // Sort by thread, then begin, then depth, such that parents
+        // precede children.
+        std::sort(evs.begin(), evs.end(),
+            [](const auto& lhs, const auto& rhs) {
+                return
+                    std::tie(lhs.first, lhs.second.begin, lhs.second.depth) <
+                    std::tie(rhs.first, rhs.second.begin, rhs.second.depth);
+            });
+
+        // Child time of each event.
+        std::vector<std::uint64_t> child(evs.size(), 0);
+        std::vector<std::size_t> stack;
+        for (std::size_t k = 0; k < evs.size(); k++) {
+            while (!stack.empty() &&
+                    (evs[stack.back()].first != evs[k].first ||
+                     evs[stack.back()].second.end <= evs[k].second.begin)) {
+                stack.pop_back();
+            }
+            if (!stack.empty()) {
+                child[stack.back()] +=
+                    evs[k].second.end - evs[k].second.begin;
+            }
+            stack.push_back(k);
+        }
+
+        // Aggregate.
+        std::map<
+            std::tuple<std::string, std::string, int>,
+            profile_zone_stats> stats;
+        for (std::size_t k = 0; k < evs.size(); k++) {
+            const profile_event& event = evs[k].second;
+            double dur = double(event.end - event.begin) * spt;
+            double self = double(event.end - event.begin - child[k]) * spt;
+            profile_zone_stats& s = stats[{
+                event.zone->name,
+                event.zone->file,
+                event.zone->line}];
+            if (s.count == 0) {
+                s.zone = event.zone;
+                s.min = dur;
+                s.max = dur;
+            }
+            s.count++;
+            s.total += dur;
+            s.self += self;
+            s.min = std::min(s.min, dur);
+            s.max = std::max(s.max, dur);
+        }
+        std::vector<profile_zone_stats> res;
+        for (const auto& kv : stats) {
+            res.push_back(kv.second);
+        }
+        std::sort(res.begin(), res.end(),
+            [](const auto& lhs, const auto& rhs) {
+                return lhs.total > rhs.total;
+            });
+        return res;
+    }
+
+    /**
+     * @brief Write per-zone statistics as table.
+     */
+    template <typename Tchar, typename Ttraits>
+    void write_report(std::basic_ostream<Tchar, Ttraits>& os) const
+    {
+        auto stats = report();
+        auto flags = os.flags();
+        os << std::left << std::setw(32) << "zone" << std::right
+           << std::setw(10) << "count"
+           << std::setw(12) << "total ms"
+           << std::setw(12) << "self ms"
+           << std::setw(12) << "mean us"
+           << std::setw(12) << "min us"
+           << std::setw(12) << "max us" << '\n';
+        os << std::fixed << std::setprecision(3);
+        for (const profile_zone_stats& s : stats) {
+            os << std::left << std::setw(32) << s.zone->name << std::right
+               << std::setw(10) << s.count
+               << std::setw(12) << s.total * 1e3
+               << std::setw(12) << s.self * 1e3
+               << std::setw(12) << s.total * 1e6 / double(s.count)
+               << std::setw(12) << s.min * 1e6
+               << std::setw(12) << s.max * 1e6 << '\n';
+        }
+        os.flags(flags);
+    }
+
+    /**
+     * @brief Write events in Chrome trace event format (JSON).
+     */
+    template <typename Tchar, typename Ttraits>
+    void write_chrome_trace(std::basic_ostream<Tchar, Ttraits>& os) const
+    {
+        double spt = seconds_per_tick();
+        auto evs = events();
+        auto flags = os.flags();
+        os << "{\"traceEvents\":[";
+        os << std::fixed << std::setprecision(3);
+        bool first = true;
+        for (const auto& [tid, event] : evs) {
+            os << (first ? "\n" : ",\n");
+            first = false;
+            os << "{\"name\":\"";
+            write_json_string_(os, event.zone->name);
+            os << "\",\"cat\":\"preform\",\"ph\":\"X\",\"ts\":"
+               << double(event.begin - tick0_) * spt * 1e6
+               << ",\"dur\":"
+               << double(event.end - event.begin) * spt * 1e6
+               << ",\"pid\":0,\"tid\":" << tid
+               << ",\"args\":{\"file\":\"";
+            write_json_string_(os, event.zone->file);
+            os << "\",\"line\":" << event.zone->line << "}}";
+        }
+        os << "\n],\"displayTimeUnit\":\"ns\"}\n";
+        os.flags(flags);
+    }
+
+    /**
+     * @brief Clear events.
+     *
+     * @note
+     * Not thread-safe with respect to recording. Call only while no
+     * zones are open.
+     */
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& buffer : buffers_) {
+            buffer->head_->next.reset();
+            buffer->head_->next_ptr.store(nullptr);
+            buffer->head_->count.store(0);
+            buffer->tail_ = buffer->head_.get();
+        }
+    }
+
+private:
+
+    /**
+     * @brief Constructor.
+     */
+    profiler() : tick0_(now())
+    {
+    }
+
+    /**
+     * @brief Timer since construction.
+     */
+    steady_timer timer_;
+
+    /**
+     * @brief Tick at construction.
+     */
+    std::uint64_t tick0_;
+
+    /**
+     * @brief Mutex for buffer registration.
+     */
+    mutable std::mutex mutex_;
+
+    /**
+     * @brief Buffers, outliving their threads.
+     */
+    std::vector<std::unique_ptr<thread_buffer>> buffers_;
+
+#if !DOXYGEN
+
+    /**
+     * @brief Register buffer of calling thread.
+     */
+    thread_buffer* register_()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        buffers_.emplace_back(
+                new thread_buffer(std::uint32_t(buffers_.size())));
+        return buffers_.back().get();
+    }
+
+    /**
+     * @brief Write JSON string contents, escaped.
+     */
+    template <typename Tchar, typename Ttraits>
+    static void write_json_string_(
+                std::basic_ostream<Tchar, Ttraits>& os,
+                const char* str)
+    {
+        for (; *str; str++) {
+            char c = *str;
+            if (c == '"' || c == '\\') {
+                os << '\\' << c;
+            }
+            else if ((unsigned char)c < 0x20) {
+                os << ' ';
+            }
+            else {
+                os << c;
+            }
+        }
+    }
+
+#endif // #if !DOXYGEN
+};
+
+/**
+ * @brief Profile scope.
+ *
+ * Records an event for `zone` from construction to destruction.
+ * Prefer `PREFORM_PROFILE_ZONE`, which compiles out when profiling is
+ * disabled.
+ */
+class profile_scope
+{
+public:
+
+    /**
+     * @brief Constructor.
+     */
+    __attribute__((always_inline))
+    explicit profile_scope(const profile_zone& zone) :
+            buffer_(profiler::local()),
+            zone_(&zone),
+            depth_(buffer_.depth++),
+            begin_(profiler::now())
+    {
+    }
+
+    /**
+     * @brief Non-copyable.
+     */
+    profile_scope(const profile_scope&) = delete;
+
+    /**
+     * @brief Destructor.
+     */
+    __attribute__((always_inline))
+    ~profile_scope()
+    {
+        std::uint64_t end = profiler::now();
+        buffer_.push({zone_, begin_, end, depth_});
+        buffer_.depth--;
+    }
+
+private:
+
+    /**
+     * @brief Buffer.
+     */
+    profiler::thread_buffer& buffer_;
+
+    /**
+     * @brief Zone.
+     */
+    const profile_zone* zone_;
+
+    /**
+     * @brief Depth.
+     */
+    std::uint32_t depth_;
+
+    /**
+     * @brief Begin tick.
+     */
+    std::uint64_t begin_;
+};
+
+#if !DOXYGEN
+
+#define PREFORM_PROFILE_CAT2_(a, b) a##b
+#define PREFORM_PROFILE_CAT_(a, b) PREFORM_PROFILE_CAT2_(a, b)
+
+#endif // #if !DOXYGEN
+
+#if PREFORM_PROFILE || DOXYGEN
+
+/**
+ * @brief Open profile zone with static name until end of scope.
+ */
+#define PREFORM_PROFILE_ZONE(name) \
+    static constexpr ::pre::profile_zone \
+    PREFORM_PROFILE_CAT_(preform_profile_zone_, __LINE__) = { \
+        name, __FILE__, __LINE__ \
+    }; \
+    ::pre::profile_scope \
+    PREFORM_PROFILE_CAT_(preform_profile_scope_, __LINE__)( \
+    PREFORM_PROFILE_CAT_(preform_profile_zone_, __LINE__))
+
+#else
+
+#define PREFORM_PROFILE_ZONE(name) ((void) 0)
+
+#endif // #if PREFORM_PROFILE || DOXYGEN
+
+/**@}*/
+
+} // namespace pre
+
+#endif // #ifndef PREFORM_PROFILE_HPP
@@ -0,0 +1,352 @@
+/* Copyright (c) 2018-20 M. Grady Saunders
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer.
+ *
+ *   2. Redistributions in binary form must reproduce the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer in the documentation and/or other materials
+ *      provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*+-+*/
+#if !DOXYGEN
+#if !(__cplusplus >= 201703L)
+#error "preform/progress_reporter.hpp requires >=C++17"
+#endif // #if !(__cplusplus >= 201703L)
+#endif // #if !DOXYGEN
+#pragma once
+#ifndef PREFORM_PROGRESS_REPORTER_HPP
+#define PREFORM_PROGRESS_REPORTER_HPP
+
+// for std::atomic
+#include <atomic>
+
+// for std::chrono
+#include <chrono>
+
+// for std::condition_variable
+#include <condition_variable>
+
+// for std::uint64_t
+#include <cstdint>
+
+// for std::snprintf
+#include <cstdio>
+
+// for std::strlen
+#include <cstring>
+
+// for std::cout
+#include <iostream>
+
+// for std::mutex, std::unique_lock
+#include <mutex>
+
+// for std::ostream
+#include <ostream>
+
+// for std::thread
+#include <thread>
+
+// for pre::terminal_dims, pre::terminal_progress_bar
+#include <preform/bash_format.hpp>
+
+namespace pre {
+
+/**
+ * @defgroup progress_reporter Progress reporter
+ *
+ * `<preform/progress_reporter.hpp>`
+ *
+ * __C++ version__: >=C++17
+ */
+/**@{*/
+
+/**
+ * @brief Progress reporter.
+ *
+ * Workers report completed items with `add()`, a single relaxed
+ * atomic increment, and never touch the stream. A background
+ * thread redraws one line at a fixed interval, with a
+ * `terminal_progress_bar` sized to `terminal_dims::get()`, the
+ * throughput, and the estimated time remaining. So reporting
+ * costs the same whether tasks take microseconds or minutes.
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~{cpp}
+ * pre::progress_reporter progress(count);
+ * pool.parallel_for(0, count, 1, [&](int k) {
+ *     bake(k);
+ *     progress.add();
+ * });
+ * progress.done();
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+class progress_reporter
+{
+public:
+
+    /**
+     * @brief Default constructor, inactive.
+     */
+    progress_reporter() = default;
+
+    /**
+     * @brief Constructor, starting the redraw thread.
+     *
+     * @param[in] total
+     * Total item count.
+     *
+     * @param[in] os
+     * Output stream, which nothing else should write to until
+     * `done()`.
+     *
+     * @param[in] interval
+     * Redraw interval in seconds. By default, 0.1.
+     */
+    explicit progress_reporter(
+            std::uint64_t total,
+            std::ostream& os = std::cout,
+            double interval = 0.1) :
+                total_(total),
+                os_(&os),
+                interval_(interval > 0 ? interval : 0.1),
+                start_(clock_type::now())
+    {
+        thread_ = std::thread([this]() { run_(); });
+    }
+
+    /**
+     * @brief Non-copyable.
+     */
+    progress_reporter(const progress_reporter&) = delete;
+
+    /**
+     * @brief Destructor, as if by `done()`.
+     */
+    ~progress_reporter()
+    {
+        done();
+    }
+
+public:
+
+    /**
+     * @brief Add completed items.
+     *
+     * Safe to call concurrently from any thread.
+     */
+    void add(std::uint64_t count = 1) noexcept
+    {
+        count_.fetch_add(count, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Completed item count.
+     */
+    std::uint64_t count() const noexcept
+    {
+        return count_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Total item count.
+     */
+    std::uint64_t total() const noexcept
+    {
+        return total_;
+    }
+
+    /**
+     * @brief Done.
+     *
+     * Stops the redraw thread, then draws the final line and a
+     * newline. Does nothing if inactive or already done.
+     */
+    void done()
+    {
+        if (!thread_.joinable()) {
+            return;
+        }
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cond_.notify_one();
+        thread_.join();
+        draw_();
+        *os_ << '\n';
+        os_->flush();
+    }
+
+private:
+
+    /**
+     * @brief Clock type.
+     */
+    typedef std::chrono::steady_clock clock_type;
+
+    /**
+     * @brief Completed item count, on a cache line of its own.
+     */
+    alignas(64) std::atomic<std::uint64_t> count_ = {0};
+
+    /**
+     * @brief Total item count.
+     */
+    alignas(64) std::uint64_t total_ = 0;
+
+    /**
+     * @brief Output stream.
+     */
+    std::ostream* os_ = nullptr;
+
+    /**
+     * @brief Redraw interval in seconds.
+     */
+    double interval_ = 0.1;
+
+    /**
+     * @brief Start time.
+     */
+    clock_type::time_point start_;
+
+    /**
+     * @brief Redraw thread.
+     */
+    std::thread thread_;
+
+    /**
+     * @brief Mutual exclusion lock, for stop.
+     */
+    std::mutex mutex_;
+
+    /**
+     * @brief Condition variable, for stop.
+     */
+    std::condition_variable cond_;
+
+    /**
+     * @brief Stop?
+     */
+    bool stop_ = false;
+
+private:
+
+    /**
+     * @brief Redraw until stopped.
+     */
+    void run_()
+    {
+        std::chrono::duration<double> interval(interval_);
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!cond_.wait_for(lock, interval, [this]() { return stop_; })) {
+            draw_();
+        }
+    }
+
+    /**
+     * @brief Draw line.
+     */
+    void draw_() const
+    {
+        std::uint64_t count = this->count();
+        double elapsed =
+            std::chrono::duration<double>(clock_type::now() - start_).count();
+        double rate = elapsed > 0 ? double(count) / elapsed : 0;
+
+        // Throughput and time remaining, or elapsed if complete.
+        char suffix[64];
+        char rate_str[16];
+        char time_str[16];
+        format_rate_(rate_str, sizeof(rate_str), rate);
+        if (count >= total_) {
+            format_time_(time_str, sizeof(time_str), elapsed);
+            std::snprintf(
+                suffix, sizeof(suffix),
+                " %s/s in %s", rate_str, time_str);
+        }
+        else if (rate > 0) {
+            format_time_(
+                time_str, sizeof(time_str),
+                double(total_ - count) / rate);
+            std::snprintf(
+                suffix, sizeof(suffix),
+                " %s/s ETA %s", rate_str, time_str);
+        }
+        else {
+            std::snprintf(
+                suffix, sizeof(suffix),
+                " %s/s ETA --:--:--", rate_str);
+        }
+
+        // Fit bar to terminal, less suffix, leaving the last column
+        // empty so the line does not wrap.
+        int cols = terminal_dims::get().cols;
+        if (!(cols > 0)) {
+            cols = 80;
+        }
+        int width = cols - 1 - int(std::strlen(suffix));
+        *os_ << '\r';
+        if (width >= 16) {
+            double amount = total_ > 0 ? double(count) / double(total_) : 1;
+            *os_ << terminal_progress_bar(amount, width);
+        }
+        *os_ << suffix;
+        os_->flush();
+    }
+
+    /**
+     * @brief Format rate with SI prefix.
+     */
+    static void format_rate_(char* str, std::size_t size, double rate)
+    {
+        const char* prefixes = " kMGTP";
+        int prefix = 0;
+        while (rate >= 1000 && prefix < 5) {
+            rate /= 1000;
+            prefix++;
+        }
+        if (prefix == 0) {
+            std::snprintf(str, size, "%.1f", rate);
+        }
+        else {
+            std::snprintf(str, size, "%.1f%c", rate, prefixes[prefix]);
+        }
+    }
+
+    /**
+     * @brief Format time as hours, minutes, and seconds, clamped
+     * to under 100 hours.
+     */
+    static void format_time_(char* str, std::size_t size, double time)
+    {
+        std::uint64_t secs =
+            time < 359999 ? std::uint64_t(time + 0.5) : 359999;
+        std::snprintf(
+            str, size, "%02d:%02d:%02d",
+            int(secs / 3600), int(secs / 60 % 60), int(secs % 60));
+    }
+};
+
+/**@}*/
+
+} // namespace pre
+
+#endif // #ifndef PREFORM_PROGRESS_REPORTER_HPP
@@ -73,7 +73,7 @@ struct is_quat<quat<T>> : std::true_type
 template <typename T>
 struct is_quat_param :
             std::integral_constant<bool,
-            std::is_arithmetic<T>::value ||
+            std::is_arithmetic<simd_value_type_t<T>>::value ||
         /*  is_complex<T>::value ||  */
             is_dualnum<T>::value>
 {
@@ -94,7 +94,7 @@ public:
 
     // Sanity check.
     static_assert(
-        std::is_floating_point<T>::value,
+        std::is_floating_point<simd_value_type_t<T>>::value,
         "T must be floating point");
 
     /**
@@ -1601,7 +1601,8 @@ constexpr decltype(T() * U()) dot(const quat<T>& q0, const quat<U>& q1)
 template <typename T>
 __attribute__((always_inline))
 inline std::enable_if_t<
-       std::is_floating_point<T>::value, T> length_fast(const quat<T>& q)
+       std::is_floating_point<simd_value_type_t<T>>::value,
+                         T> length_fast(const quat<T>& q)
 {
     return length_fast(static_cast<multi<T, 4>>(q));
 }
@@ -1619,7 +1620,8 @@ inline std::enable_if_t<
 template <typename T>
 __attribute__((always_inline))
 inline std::enable_if_t<
-       std::is_floating_point<T>::value, T> length_safe(const quat<T>& q)
+       std::is_floating_point<simd_value_type_t<T>>::value,
+                         T> length_safe(const quat<T>& q)
 {
     return length_safe(static_cast<multi<T, 4>>(q));
 }
@@ -1637,7 +1639,8 @@ inline std::enable_if_t<
 template <typename T>
 __attribute__((always_inline))
 inline std::enable_if_t<
-       std::is_floating_point<T>::value, T> length(const quat<T>& q)
+       std::is_floating_point<simd_value_type_t<T>>::value,
+                         T> length(const quat<T>& q)
 {
     return length(static_cast<multi<T, 4>>(q));
 }
@@ -1655,7 +1658,7 @@ inline std::enable_if_t<
 template <typename T>
 __attribute__((always_inline))
 inline std::enable_if_t<
-       std::is_floating_point<T>::value,
+       std::is_floating_point<simd_value_type_t<T>>::value,
                          quat<T>> normalize_fast(const quat<T>& q)
 {
     return quat<T>(normalize_fast(static_cast<multi<T, 4>>(q)));
@@ -1674,7 +1677,7 @@ inline std::enable_if_t<
 template <typename T>
 __attribute__((always_inline))
 inline std::enable_if_t<
-       std::is_floating_point<T>::value,
+       std::is_floating_point<simd_value_type_t<T>>::value,
                          quat<T>> normalize_safe(const quat<T>& q)
 {
     return quat<T>(normalize_safe(static_cast<multi<T, 4>>(q)));
@@ -1693,7 +1696,7 @@ inline std::enable_if_t<
 template <typename T>
 __attribute__((always_inline))
 inline std::enable_if_t<
-       std::is_floating_point<T>::value,
+       std::is_floating_point<simd_value_type_t<T>>::value,
                          quat<T>> normalize(const quat<T>& q)
 {
     return quat<T>(normalize(static_cast<multi<T, 4>>(q)));
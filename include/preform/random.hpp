@@ -47,9 +47,19 @@
 // for std::invalid_argument
 #include <stdexcept>
 
+// for std::integral_constant
+#include <type_traits>
+
 // for std::vector
 #include <vector>
 
+#if defined(__AVX2__)
+
+// for _mm256_mul_epu32, ...
+#include <immintrin.h>
+
+#endif // #if defined(__AVX2__)
+
 // for pre::numeric_limits, pre::log2, ...
 #include <preform/math.hpp>
 
@@ -99,6 +109,30 @@ inline std::enable_if_t<
     return s;
 }
 
+#if !DOXYGEN
+
+// Generate numbers by inverse transform, in blocks.
+template <typename Tdist, typename G>
+inline void sample_n_(
+            const Tdist& dist, G&& gen,
+            typename Tdist::value_type* x, std::size_t n)
+{
+    typedef typename Tdist::float_type float_type;
+    constexpr std::size_t block = 256;
+    float_type u[block];
+    while (n > 0) {
+        std::size_t m = std::min(n, block);
+        for (std::size_t k = 0; k < m; k++) {
+            u[k] = pre::generate_canonical<float_type>(gen);
+        }
+        dist.cdfinv_n(&u[0], x, m);
+        x += m;
+        n -= m;
+    }
+}
+
+#endif // #if !DOXYGEN
+
 /**
  * @brief Uniform int distribution.
  *
@@ -297,6 +331,37 @@ public:
             pre::generate_canonical<float_type>(std::forward<G>(gen)));
     }
 
+    /**
+     * @brief Cumulative distribution function inverse, for arrays.
+     *
+     * @param[in] u
+     * Canonical samples.
+     *
+     * @param[out] x
+     * Numbers.
+     *
+     * @param[in] n
+     * Count.
+     */
+    void cdfinv_n(const float_type* u, value_type* x, std::size_t n) const
+    {
+        for (std::size_t k = 0; k < n; k++) {
+            x[k] = cdfinv(u[k]);
+        }
+    }
+
+    /**
+     * @brief Generate numbers.
+     *
+     * Equivalent to @f$ n @f$ calls to `operator()`, but generates
+     * canonical samples in blocks for `cdfinv_n()`.
+     */
+    template <typename G>
+    void sample_n(G&& gen, value_type* x, std::size_t n) const
+    {
+        pre::sample_n_(*this, std::forward<G>(gen), x, n);
+    }
+
 private:
 
     /**
@@ -503,6 +568,37 @@ public:
             pre::generate_canonical<float_type>(std::forward<G>(gen)));
     }
 
+    /**
+     * @brief Cumulative distribution function inverse, for arrays.
+     *
+     * @param[in] u
+     * Canonical samples.
+     *
+     * @param[out] x
+     * Numbers.
+     *
+     * @param[in] n
+     * Count.
+     */
+    void cdfinv_n(const float_type* u, value_type* x, std::size_t n) const
+    {
+        for (std::size_t k = 0; k < n; k++) {
+            x[k] = cdfinv(u[k]);
+        }
+    }
+
+    /**
+     * @brief Generate numbers.
+     *
+     * Equivalent to @f$ n @f$ calls to `operator()`, but generates
+     * canonical samples in blocks for `cdfinv_n()`.
+     */
+    template <typename G>
+    void sample_n(G&& gen, value_type* x, std::size_t n) const
+    {
+        pre::sample_n_(*this, std::forward<G>(gen), x, n);
+    }
+
 private:
 
     /**
@@ -567,6 +663,9 @@ public:
         if (!(lambda > float_type(0))) {
             throw std::invalid_argument(__PRETTY_FUNCTION__);
         }
+        if (!(lambda_ < ptrs_min_lambda_)) {
+            init_ptrs_();
+        }
     }
 
     /**
@@ -759,12 +858,62 @@ public:
 
     /**
      * @brief Generate number.
+     *
+     * For @f$ \lambda < 10 @f$, inverts the CDF of one canonical
+     * sample. Otherwise, uses the transformed rejection method PTRS
+     * of [Hormann 1993][1], with @f$ O(1) @f$ expected time.
+     *
+     * [1]: https://doi.org/10.1016/0167-6687(93)90997-4
      */
     template <typename G>
     value_type operator()(G&& gen) const
     {
-        return cdfinv(
-            pre::generate_canonical<float_type>(std::forward<G>(gen)));
+        if (lambda_ < ptrs_min_lambda_) {
+            return cdfinv(
+                pre::generate_canonical<float_type>(std::forward<G>(gen)));
+        }
+        else {
+            return ptrs_sample_(gen);
+        }
+    }
+
+    /**
+     * @brief Cumulative distribution function inverse, for arrays.
+     *
+     * @param[in] u
+     * Canonical samples.
+     *
+     * @param[out] x
+     * Numbers.
+     *
+     * @param[in] n
+     * Count.
+     */
+    void cdfinv_n(const float_type* u, value_type* x, std::size_t n) const
+    {
+        for (std::size_t k = 0; k < n; k++) {
+            x[k] = cdfinv(u[k]);
+        }
+    }
+
+    /**
+     * @brief Generate numbers.
+     *
+     * Equivalent to @f$ n @f$ calls to `operator()`. For small
+     * @f$ \lambda @f$, generates canonical samples in blocks for
+     * `cdfinv_n()`.
+     */
+    template <typename G>
+    void sample_n(G&& gen, value_type* x, std::size_t n) const
+    {
+        if (lambda_ < ptrs_min_lambda_) {
+            pre::sample_n_(*this, std::forward<G>(gen), x, n);
+        }
+        else {
+            for (std::size_t k = 0; k < n; k++) {
+                x[k] = ptrs_sample_(gen);
+            }
+        }
     }
 
 private:
@@ -773,6 +922,73 @@ private:
      * @brief Rate @f$ \lambda @f$.
      */
     float_type lambda_ = 1;
+
+    /**
+     * @brief Minimum rate for PTRS.
+     */
+    static constexpr float_type ptrs_min_lambda_ = 10;
+
+    /**
+     * @brief PTRS constants.
+     */
+    struct ptrs_constants
+    {
+        float_type a = 0;
+        float_type b = 0;
+        float_type vr = 0;
+        float_type log_inv_alpha = 0;
+        float_type log_lambda = 0;
+    } ptrs_;
+
+    /**
+     * @brief Initialize PTRS constants.
+     */
+    void init_ptrs_()
+    {
+        float_type b = float_type(0.931) +
+                       float_type(2.53) * pre::sqrt(lambda_);
+        ptrs_.a = float_type(-0.059) + float_type(0.02483) * b;
+        ptrs_.b = b;
+        ptrs_.vr = float_type(0.9277) - float_type(3.6224) / (b - 2);
+        ptrs_.log_inv_alpha = pre::log(
+                float_type(1.1239) +
+                float_type(1.1328) / (b - float_type(3.4)));
+        ptrs_.log_lambda = pre::log(lambda_);
+    }
+
+    /**
+     * @brief Generate number with PTRS.
+     */
+    template <typename G>
+    value_type ptrs_sample_(G&& gen) const
+    {
+        for (;;) {
+            float_type u =
+                pre::generate_canonical<float_type>(gen) - float_type(0.5);
+            float_type v = pre::generate_canonical<float_type>(gen);
+            float_type us = float_type(0.5) - pre::abs(u);
+            float_type k = pre::floor(
+                    (2 * ptrs_.a / us + ptrs_.b) * u +
+                    lambda_ + float_type(0.43));
+
+            // Accept quickly?
+            if (us >= float_type(0.07) && v <= ptrs_.vr) {
+                return value_type(k);
+            }
+
+            // Reject quickly?
+            if (k < 0 || (us < float_type(0.013) && v > us)) {
+                continue;
+            }
+
+            // Accept?
+            if (pre::log(v) + ptrs_.log_inv_alpha -
+                pre::log(ptrs_.a / (us * us) + ptrs_.b) <=
+                -lambda_ + k * ptrs_.log_lambda - pre::lgamma(k + 1)) {
+                return value_type(k);
+            }
+        }
+    }
 };
 
 /**
@@ -969,6 +1185,37 @@ public:
             pre::generate_canonical<float_type>(std::forward<G>(gen)));
     }
 
+    /**
+     * @brief Cumulative distribution function inverse, for arrays.
+     *
+     * @param[in] u
+     * Canonical samples.
+     *
+     * @param[out] x
+     * Numbers.
+     *
+     * @param[in] n
+     * Count.
+     */
+    void cdfinv_n(const float_type* u, value_type* x, std::size_t n) const
+    {
+        for (std::size_t k = 0; k < n; k++) {
+            x[k] = cdfinv(u[k]);
+        }
+    }
+
+    /**
+     * @brief Generate numbers.
+     *
+     * Equivalent to @f$ n @f$ calls to `operator()`, but generates
+     * canonical samples in blocks for `cdfinv_n()`.
+     */
+    template <typename G>
+    void sample_n(G&& gen, value_type* x, std::size_t n) const
+    {
+        pre::sample_n_(*this, std::forward<G>(gen), x, n);
+    }
+
 private:
 
     /**
@@ -1188,6 +1435,42 @@ public:
             pre::generate_canonical<float_type>(std::forward<G>(gen)));
     }
 
+    /**
+     * @brief Cumulative distribution function inverse, for arrays.
+     *
+     * Branch-free, so vectorizes.
+     *
+     * @param[in] u
+     * Canonical samples.
+     *
+     * @param[out] x
+     * Numbers.
+     *
+     * @param[in] n
+     * Count.
+     */
+    void cdfinv_n(const float_type* u, value_type* x, std::size_t n) const
+    {
+        for (std::size_t k = 0; k < n; k++) {
+            float_type uk = u[k];
+            float_type xk = uk < q_ ? float_type(0) : float_type(1);
+            x[k] = uk >= float_type(0) && uk < float_type(1) ? xk :
+                   pre::numeric_limits<float_type>::quiet_NaN();
+        }
+    }
+
+    /**
+     * @brief Generate numbers.
+     *
+     * Equivalent to @f$ n @f$ calls to `operator()`, but generates
+     * canonical samples in blocks for `cdfinv_n()`.
+     */
+    template <typename G>
+    void sample_n(G&& gen, value_type* x, std::size_t n) const
+    {
+        pre::sample_n_(*this, std::forward<G>(gen), x, n);
+    }
+
 private:
 
     /**
@@ -1247,6 +1530,9 @@ public:
               p <= 1)) {
             throw std::invalid_argument(__PRETTY_FUNCTION__);
         }
+        if (!(n_ * pre::min(p_, q_) < btrs_min_mean_)) {
+            init_btrs_();
+        }
     }
 
     /**
@@ -1428,12 +1714,62 @@ public:
 
     /**
      * @brief Generate number.
+     *
+     * For @f$ n \min(p, q) < 10 @f$, inverts the CDF of one canonical
+     * sample. Otherwise, uses the transformed rejection method BTRS
+     * of [Hormann 1993][1], with @f$ O(1) @f$ expected time.
+     *
+     * [1]: https://doi.org/10.1080/00949659308811496
      */
     template <typename G>
     value_type operator()(G&& gen) const
     {
-        return cdfinv(
-            pre::generate_canonical<float_type>(std::forward<G>(gen)));
+        if (!btrs_.enabled) {
+            return cdfinv(
+                pre::generate_canonical<float_type>(std::forward<G>(gen)));
+        }
+        else {
+            return btrs_sample_(gen);
+        }
+    }
+
+    /**
+     * @brief Cumulative distribution function inverse, for arrays.
+     *
+     * @param[in] u
+     * Canonical samples.
+     *
+     * @param[out] x
+     * Numbers.
+     *
+     * @param[in] n
+     * Count.
+     */
+    void cdfinv_n(const float_type* u, value_type* x, std::size_t n) const
+    {
+        for (std::size_t k = 0; k < n; k++) {
+            x[k] = cdfinv(u[k]);
+        }
+    }
+
+    /**
+     * @brief Generate numbers.
+     *
+     * Equivalent to @f$ n @f$ calls to `operator()`. For small
+     * @f$ n \min(p, q) @f$, generates canonical samples in blocks
+     * for `cdfinv_n()`.
+     */
+    template <typename G>
+    void sample_n(G&& gen, value_type* x, std::size_t n) const
+    {
+        if (!btrs_.enabled) {
+            pre::sample_n_(*this, std::forward<G>(gen), x, n);
+        }
+        else {
+            for (std::size_t k = 0; k < n; k++) {
+                x[k] = btrs_sample_(gen);
+            }
+        }
     }
 
 private:
@@ -1452,8 +1788,171 @@ private:
      * @brief Probability of failure @f$ q = 1 - p @f$.
      */
     float_type q_ = float_type(0.5);
+
+    /**
+     * @brief Minimum mean @f$ n \min(p, q) @f$ for BTRS.
+     */
+    static constexpr float_type btrs_min_mean_ = 10;
+
+    /**
+     * @brief BTRS constants, for @f$ \min(p, q) @f$.
+     */
+    struct btrs_constants
+    {
+        bool enabled = false;
+        bool flip = false;
+        float_type a = 0;
+        float_type b = 0;
+        float_type c = 0;
+        float_type vr = 0;
+        float_type log_alpha = 0;
+        float_type log_pq = 0;
+        float_type m = 0;
+        float_type h = 0;
+    } btrs_;
+
+    /**
+     * @brief Initialize BTRS constants.
+     */
+    void init_btrs_()
+    {
+        float_type p = pre::min(p_, q_);
+        float_type q = 1 - p;
+        float_type spq = pre::sqrt(n_ * p * q);
+        float_type b = float_type(1.15) + float_type(2.53) * spq;
+        btrs_.enabled = true;
+        btrs_.flip = p_ > q_;
+        btrs_.a = float_type(-0.0873) + float_type(0.0248) * b +
+                  float_type(0.01) * p;
+        btrs_.b = b;
+        btrs_.c = n_ * p + float_type(0.5);
+        btrs_.vr = float_type(0.92) - float_type(4.2) / b;
+        btrs_.log_alpha = pre::log(
+                (float_type(2.83) + float_type(5.1) / b) * spq);
+        btrs_.log_pq = pre::log(p / q);
+        btrs_.m = pre::floor((n_ + 1) * p);
+        btrs_.h = pre::lgamma(btrs_.m + 1) +
+                  pre::lgamma(n_ - btrs_.m + 1);
+    }
+
+    /**
+     * @brief Generate number with BTRS.
+     */
+    template <typename G>
+    value_type btrs_sample_(G&& gen) const
+    {
+        for (;;) {
+            float_type u =
+                pre::generate_canonical<float_type>(gen) - float_type(0.5);
+            float_type v = pre::generate_canonical<float_type>(gen);
+            float_type us = float_type(0.5) - pre::abs(u);
+            float_type k = pre::floor(
+                    (2 * btrs_.a / us + btrs_.b) * u + btrs_.c);
+
+            // Reject quickly?
+            if (k < 0 || k > n_) {
+                continue;
+            }
+
+            // Accept quickly?
+            if (!(us >= float_type(0.07) && v <= btrs_.vr)) {
+
+                // Reject?
+                if (pre::log(v) + btrs_.log_alpha -
+                    pre::log(btrs_.a / (us * us) + btrs_.b) >
+                    btrs_.h -
+                    pre::lgamma(k + 1) -
+                    pre::lgamma(n_ - k + 1) +
+                    (k - btrs_.m) * btrs_.log_pq) {
+                    continue;
+                }
+            }
+            return btrs_.flip ? n_ - value_type(k) : value_type(k);
+        }
+    }
+};
+
+#if !DOXYGEN
+
+// Ziggurat for standard normal, after Marsaglia and Tsang 2000.
+struct normal_ziggurat_
+{
+    // Layers.
+    static constexpr int layers = 128;
+
+    // Rightmost layer edge.
+    static constexpr double r = 3.442619855899;
+
+    // Layer area, for unnormalized density.
+    static constexpr double v = 9.91256303526217e-3;
+
+    // Layer widths, with base layer width v / f(r).
+    double x[layers + 1];
+
+    // Density at layer widths.
+    double f[layers + 1];
+
+    normal_ziggurat_()
+    {
+        x[1] = r;
+        f[1] = pre::exp(-r * r / 2);
+        x[0] = v / f[1];
+        f[0] = 0;
+        for (int i = 1; i < layers - 1; i++) {
+            x[i + 1] = pre::sqrt(-2 * pre::log(f[i] + v / x[i]));
+            f[i + 1] = pre::exp(-x[i + 1] * x[i + 1] / 2);
+        }
+        x[layers] = 0;
+        f[layers] = 1;
+    }
+
+    static const normal_ziggurat_& get()
+    {
+        static const normal_ziggurat_ table;
+        return table;
+    }
+
+    template <typename G>
+    double operator()(G&& gen) const
+    {
+        for (;;) {
+            // Layer, sign, and position from one canonical sample.
+            double t = pre::generate_canonical<double>(gen) * (2 * layers);
+            int j = int(t);
+            int i = j & (layers - 1);
+            double sign = 1 - 2 * ((j / layers) & 1);
+            double xi = (t - j) * x[i];
+
+            // Inside next layer?
+            if (xi < x[i + 1]) {
+                return sign * xi;
+            }
+
+            // Tail?
+            if (i == 0) {
+                double a, b;
+                do {
+                    a = -pre::log1p(
+                        -pre::generate_canonical<double>(gen)) / r;
+                    b = -pre::log1p(
+                        -pre::generate_canonical<double>(gen));
+                }
+                while (b + b < a * a);
+                return sign * (r + a);
+            }
+
+            // Wedge.
+            double y = f[i] +
+                pre::generate_canonical<double>(gen) * (f[i + 1] - f[i]);
+            if (y < pre::exp(-xi * xi / 2)) {
+                return sign * xi;
+            }
+        }
+    }
 };
 
+#endif // #if !DOXYGEN
+
 /**
  * @brief Normal distribution.
  *
@@ -1651,6 +2150,68 @@ public:
             pre::generate_canonical<float_type>(std::forward<G>(gen)));
     }
 
+    /**
+     * @brief Cumulative distribution function inverse, for arrays.
+     *
+     * @param[in] u
+     * Canonical samples.
+     *
+     * @param[out] x
+     * Numbers.
+     *
+     * @param[in] n
+     * Count.
+     */
+    void cdfinv_n(const float_type* u, value_type* x, std::size_t n) const
+    {
+        for (std::size_t k = 0; k < n; k++) {
+            x[k] = cdfinv(u[k]);
+        }
+    }
+
+    /**
+     * @brief Generate numbers.
+     *
+     * Equivalent to @f$ n @f$ calls to `operator()`, but generates
+     * canonical samples in blocks for `cdfinv_n()`.
+     */
+    template <typename G>
+    void sample_n(G&& gen, value_type* x, std::size_t n) const
+    {
+        pre::sample_n_(*this, std::forward<G>(gen), x, n);
+    }
+
+    /**
+     * @brief Generate number, with ziggurat method.
+     *
+     * Uses the ziggurat method of [Marsaglia and Tsang 2000][1]
+     * with 128 layers, which accepts about 99% of the time with one
+     * canonical `double` sample and no transcendental functions.
+     * This is faster than `operator()`, but is not a function of
+     * one canonical sample, so is unsuitable for stratified or
+     * low-discrepancy samples.
+     *
+     * [1]: https://doi.org/10.18637/jss.v005.i08
+     */
+    template <typename G>
+    value_type ziggurat(G&& gen) const
+    {
+        return mu_ + sigma_ *
+            float_type(normal_ziggurat_::get()(std::forward<G>(gen)));
+    }
+
+    /**
+     * @brief Generate numbers, with ziggurat method.
+     */
+    template <typename G>
+    void ziggurat_n(G&& gen, value_type* x, std::size_t n) const
+    {
+        const normal_ziggurat_& table = normal_ziggurat_::get();
+        for (std::size_t k = 0; k < n; k++) {
+            x[k] = mu_ + sigma_ * float_type(table(gen));
+        }
+    }
+
 protected:
 
     /**
@@ -1827,10 +2388,63 @@ public:
             pre::generate_canonical<float_type>(std::forward<G>(gen)));
     }
 
-private:
-
-    // Make member variable visible.
-    using normal_distribution<T>::mu_;
+    /**
+     * @brief Cumulative distribution function inverse, for arrays.
+     *
+     * @param[in] u
+     * Canonical samples.
+     *
+     * @param[out] x
+     * Numbers.
+     *
+     * @param[in] n
+     * Count.
+     */
+    void cdfinv_n(const float_type* u, value_type* x, std::size_t n) const
+    {
+        for (std::size_t k = 0; k < n; k++) {
+            x[k] = cdfinv(u[k]);
+        }
+    }
+
+    /**
+     * @brief Generate numbers.
+     *
+     * Equivalent to @f$ n @f$ calls to `operator()`, but generates
+     * canonical samples in blocks for `cdfinv_n()`.
+     */
+    template <typename G>
+    void sample_n(G&& gen, value_type* x, std::size_t n) const
+    {
+        pre::sample_n_(*this, std::forward<G>(gen), x, n);
+    }
+
+    /**
+     * @brief Generate number, with ziggurat method.
+     */
+    template <typename G>
+    value_type ziggurat(G&& gen) const
+    {
+        return pre::exp(
+            normal_distribution<T>::ziggurat(std::forward<G>(gen)));
+    }
+
+    /**
+     * @brief Generate numbers, with ziggurat method.
+     */
+    template <typename G>
+    void ziggurat_n(G&& gen, value_type* x, std::size_t n) const
+    {
+        normal_distribution<T>::ziggurat_n(std::forward<G>(gen), x, n);
+        for (std::size_t k = 0; k < n; k++) {
+            x[k] = pre::exp(x[k]);
+        }
+    }
+
+private:
+
+    // Make member variable visible.
+    using normal_distribution<T>::mu_;
 
     // Make member variable visible.
     using normal_distribution<T>::sigma_;
@@ -2019,6 +2633,37 @@ public:
             pre::generate_canonical<float_type>(std::forward<G>(gen)));
     }
 
+    /**
+     * @brief Cumulative distribution function inverse, for arrays.
+     *
+     * @param[in] u
+     * Canonical samples.
+     *
+     * @param[out] x
+     * Numbers.
+     *
+     * @param[in] n
+     * Count.
+     */
+    void cdfinv_n(const float_type* u, value_type* x, std::size_t n) const
+    {
+        for (std::size_t k = 0; k < n; k++) {
+            x[k] = cdfinv(u[k]);
+        }
+    }
+
+    /**
+     * @brief Generate numbers.
+     *
+     * Equivalent to @f$ n @f$ calls to `operator()`, but generates
+     * canonical samples in blocks for `cdfinv_n()`.
+     */
+    template <typename G>
+    void sample_n(G&& gen, value_type* x, std::size_t n) const
+    {
+        pre::sample_n_(*this, std::forward<G>(gen), x, n);
+    }
+
 private:
 
     /**
@@ -2215,6 +2860,37 @@ public:
             pre::generate_canonical<float_type>(std::forward<G>(gen)));
     }
 
+    /**
+     * @brief Cumulative distribution function inverse, for arrays.
+     *
+     * @param[in] u
+     * Canonical samples.
+     *
+     * @param[out] x
+     * Numbers.
+     *
+     * @param[in] n
+     * Count.
+     */
+    void cdfinv_n(const float_type* u, value_type* x, std::size_t n) const
+    {
+        for (std::size_t k = 0; k < n; k++) {
+            x[k] = cdfinv(u[k]);
+        }
+    }
+
+    /**
+     * @brief Generate numbers.
+     *
+     * Equivalent to @f$ n @f$ calls to `operator()`, but generates
+     * canonical samples in blocks for `cdfinv_n()`.
+     */
+    template <typename G>
+    void sample_n(G&& gen, value_type* x, std::size_t n) const
+    {
+        pre::sample_n_(*this, std::forward<G>(gen), x, n);
+    }
+
 private:
 
     /**
@@ -2455,6 +3131,37 @@ public:
             pre::generate_canonical<float_type>(std::forward<G>(gen)));
     }
 
+    /**
+     * @brief Cumulative distribution function inverse, for arrays.
+     *
+     * @param[in] u
+     * Canonical samples.
+     *
+     * @param[out] x
+     * Numbers.
+     *
+     * @param[in] n
+     * Count.
+     */
+    void cdfinv_n(const float_type* u, value_type* x, std::size_t n) const
+    {
+        for (std::size_t k = 0; k < n; k++) {
+            x[k] = cdfinv(u[k]);
+        }
+    }
+
+    /**
+     * @brief Generate numbers.
+     *
+     * Equivalent to @f$ n @f$ calls to `operator()`, but generates
+     * canonical samples in blocks for `cdfinv_n()`.
+     */
+    template <typename G>
+    void sample_n(G&& gen, value_type* x, std::size_t n) const
+    {
+        pre::sample_n_(*this, std::forward<G>(gen), x, n);
+    }
+
 private:
 
     /**
@@ -2653,6 +3360,37 @@ public:
             pre::generate_canonical<float_type>(std::forward<G>(gen)));
     }
 
+    /**
+     * @brief Cumulative distribution function inverse, for arrays.
+     *
+     * @param[in] u
+     * Canonical samples.
+     *
+     * @param[out] x
+     * Numbers.
+     *
+     * @param[in] n
+     * Count.
+     */
+    void cdfinv_n(const float_type* u, value_type* x, std::size_t n) const
+    {
+        for (std::size_t k = 0; k < n; k++) {
+            x[k] = cdfinv(u[k]);
+        }
+    }
+
+    /**
+     * @brief Generate numbers.
+     *
+     * Equivalent to @f$ n @f$ calls to `operator()`, but generates
+     * canonical samples in blocks for `cdfinv_n()`.
+     */
+    template <typename G>
+    void sample_n(G&& gen, value_type* x, std::size_t n) const
+    {
+        pre::sample_n_(*this, std::forward<G>(gen), x, n);
+    }
+
 private:
 
     /**
@@ -2992,14 +3730,210 @@ public:
 
     /**
      * @brief Generate number.
+     *
+     * If the alias table is initialized, uses `alias_cdfinv()` on two
+     * canonical samples. Otherwise, uses `cdfinv()` on one.
      */
     template <typename G>
     value_type operator()(G&& gen) const
     {
+        if (!alias_.empty()) {
+            float_type u0 = pre::generate_canonical<float_type>(gen);
+            float_type u1 = pre::generate_canonical<float_type>(gen);
+            return alias_cdfinv(u0, u1);
+        }
         return cdfinv(
             pre::generate_canonical<float_type>(std::forward<G>(gen)));
     }
 
+    /**
+     * @brief Cumulative distribution function inverse, for arrays.
+     *
+     * @param[in] u
+     * Canonical samples.
+     *
+     * @param[out] x
+     * Numbers.
+     *
+     * @param[in] n
+     * Count.
+     */
+    void cdfinv_n(const float_type* u, value_type* x, std::size_t n) const
+    {
+        for (std::size_t k = 0; k < n; k++) {
+            x[k] = cdfinv(u[k]);
+        }
+    }
+
+    /**
+     * @brief Generate numbers.
+     *
+     * Equivalent to @f$ n @f$ calls to `operator()`.
+     */
+    template <typename G>
+    void sample_n(G&& gen, value_type* x, std::size_t n) const
+    {
+        if (!alias_.empty()) {
+            for (std::size_t k = 0; k < n; k++) {
+                x[k] = operator()(gen);
+            }
+        }
+        else {
+            pre::sample_n_(*this, std::forward<G>(gen), x, n);
+        }
+    }
+
+    /**
+     * @name Alias table
+     */
+    /**@{*/
+
+    /**
+     * @brief Bins per alias table block.
+     */
+    static constexpr int alias_block_size = 4096;
+
+    /**
+     * @brief Initialize alias table.
+     *
+     * Builds a two-level Walker/Vose alias table in linear time, with
+     * one table for each block of `alias_block_size` bins and one
+     * table over blocks. Afterwards, sampling is @f$ O(1) @f$ in
+     * the number of bins, with two lookups that do not depend on
+     * each other's comparisons.
+     */
+    void init_alias()
+    {
+        int nblocks = init_alias_begin_();
+        for (int b = 0; b < nblocks; b++) {
+            init_alias_block_(b);
+        }
+        init_alias_end_();
+    }
+
+    /**
+     * @brief Initialize alias table in parallel.
+     *
+     * @param[in] pool
+     * Pool with `parallel_for()`, e.g., `pre::thread_pool`. Blocks
+     * are built as independent tasks.
+     */
+    template <typename Tpool>
+    void init_alias(Tpool& pool)
+    {
+        int nblocks = init_alias_begin_();
+        pool.parallel_for(0, nblocks, 1, [this](int b) {
+            init_alias_block_(b);
+        });
+        init_alias_end_();
+    }
+
+    /**
+     * @brief Has alias table?
+     */
+    bool has_alias() const noexcept
+    {
+        return !alias_.empty();
+    }
+
+    /**
+     * @brief Number of bins.
+     */
+    int bins() const noexcept
+    {
+        return points_.empty() ? 0 : int(points_.size()) - 1;
+    }
+
+    /**
+     * @brief Probability density function of bin.
+     *
+     * Equivalent to `pdf()` at any point in bin @f$ k @f$, without
+     * lookup.
+     */
+    float_type bin_pdf(int k) const
+    {
+        return points_[k].pdf;
+    }
+
+    /**
+     * @brief Alias table sample.
+     *
+     * Maps @f$ u_0 @f$ to a bin and @f$ u_1 @f$ to the alias coin and
+     * the position within the bin, such that the result has density
+     * `pdf()`. This does not preserve order, unlike `cdfinv()`.
+     *
+     * @param[in] u0
+     * Sample in @f$ [0, 1) @f$, for bin.
+     *
+     * @param[in] u1
+     * Sample in @f$ [0, 1) @f$, for coin and position.
+     *
+     * @param[out] k
+     * Bin. _Optional_.
+     *
+     * @throw std::runtime_error
+     * Unless `has_alias()`.
+     *
+     * @note
+     * Since @f$ u_0 @f$ is split between two levels of tables,
+     * bin resolution is limited by the precision of `float_type`
+     * rather than the table size.
+     */
+    float_type alias_cdfinv(
+                float_type u0,
+                float_type u1,
+                int* k = nullptr) const
+    {
+        // Invalid?
+        if (alias_.empty()) {
+            throw std::runtime_error(__PRETTY_FUNCTION__);
+        }
+
+        if (!(u0 >= float_type(0) && u0 < float_type(1) &&
+              u1 >= float_type(0) && u1 < float_type(1))) {
+            return pre::numeric_limits<float_type>::quiet_NaN();
+        }
+
+        // Block.
+        int nblocks = alias_blocks_.size();
+        float_type v = u0 * nblocks;
+        int i = std::min(int(v), nblocks - 1);
+        v -= i;
+        int b = i;
+        const alias_entry& top = alias_blocks_[i];
+        if (v < top.prob) {
+            v = v / top.prob;
+        }
+        else {
+            b = top.alias;
+            v = (v - top.prob) / (1 - top.prob);
+        }
+
+        // Bin.
+        int first = b * alias_block_size;
+        int m = std::min(alias_block_size, bins() - first);
+        int j = first + std::min(int(v * m), m - 1);
+        const alias_entry& entry = alias_[j];
+        float_type t = 0;
+        if (u1 < entry.prob) {
+            t = u1 / entry.prob;
+        }
+        else {
+            j = entry.alias;
+            t = (u1 - entry.prob) / (1 - entry.prob);
+        }
+        if (k) {
+            *k = j;
+        }
+
+        // Evaluate.
+        float_type x0 = points_[j].x;
+        float_type x1 = points_[j + 1].x;
+        return (1 - t) * x0 + t * x1;
+    }
+
+    /**@}*/
+
 private:
 
     /**
@@ -3027,6 +3961,163 @@ private:
      * @brief Points.
      */
     std::vector<point_type> points_;
+
+    /**
+     * @brief Alias table entry.
+     */
+    struct alias_entry
+    {
+        /**
+         * @brief Probability of keeping this entry.
+         */
+        float_type prob = 1;
+
+        /**
+         * @brief Alias.
+         */
+        int alias = 0;
+    };
+
+    /**
+     * @brief Alias table over bins, by block.
+     */
+    std::vector<alias_entry> alias_;
+
+    /**
+     * @brief Alias table over blocks.
+     */
+    std::vector<alias_entry> alias_blocks_;
+
+    /**
+     * @brief Block masses, while initializing.
+     */
+    std::vector<float_type> alias_block_mass_;
+
+    /**
+     * @brief Initialize alias table, begin.
+     *
+     * @return
+     * Number of blocks.
+     *
+     * @throw std::runtime_error
+     * Unless `points_.size() > 1`.
+     */
+    int init_alias_begin_()
+    {
+        // Invalid?
+        if (!(points_.size() > 1)) {
+            throw std::runtime_error(__PRETTY_FUNCTION__);
+        }
+        int nblocks = (bins() + alias_block_size - 1) / alias_block_size;
+        alias_.resize(bins());
+        alias_blocks_.resize(nblocks);
+        alias_block_mass_.resize(nblocks);
+        return nblocks;
+    }
+
+    /**
+     * @brief Initialize alias table, block.
+     */
+    void init_alias_block_(int b)
+    {
+        int first = b * alias_block_size;
+        int m = std::min(alias_block_size, bins() - first);
+        std::vector<float_type> mass(m);
+        neumaier_sum<float_type> total = 0;
+        for (int k = 0; k < m; k++) {
+            const point_type& point0 = points_[first + k];
+            const point_type& point1 = points_[first + k + 1];
+            mass[k] = (point1.x - point0.x) * point0.pdf;
+            total += mass[k];
+        }
+        alias_block_mass_[b] = float_type(total);
+        build_alias_(mass.data(), m, &alias_[first], first);
+    }
+
+    /**
+     * @brief Initialize alias table, end.
+     */
+    void init_alias_end_()
+    {
+        build_alias_(
+                alias_block_mass_.data(),
+                alias_block_mass_.size(),
+                alias_blocks_.data(), 0);
+        alias_block_mass_.clear();
+        alias_block_mass_.shrink_to_fit();
+    }
+
+    /**
+     * @brief Build alias table, by Vose's method.
+     *
+     * @param[in] mass
+     * Masses.
+     *
+     * @param[in] m
+     * Count.
+     *
+     * @param[out] table
+     * Table.
+     *
+     * @param[in] offset
+     * Offset added to aliases.
+     */
+    static void build_alias_(
+            const float_type* mass, int m,
+            alias_entry* table, int offset)
+    {
+        neumaier_sum<float_type> total = 0;
+        for (int k = 0; k < m; k++) {
+            total += mass[k];
+        }
+        if (!(float_type(total) > 0)) {
+            for (int k = 0; k < m; k++) {
+                table[k].prob = 1;
+                table[k].alias = offset + k;
+            }
+            return;
+        }
+
+        // Scale to mean 1, and partition into small and large.
+        std::vector<float_type> q(m);
+        std::vector<int> small;
+        std::vector<int> large;
+        small.reserve(m);
+        large.reserve(m);
+        float_type fac = m / float_type(total);
+        for (int k = 0; k < m; k++) {
+            q[k] = mass[k] * fac;
+            if (q[k] < 1) {
+                small.push_back(k);
+            }
+            else {
+                large.push_back(k);
+            }
+        }
+
+        // Pair each small entry with a large entry.
+        while (!small.empty() && !large.empty()) {
+            int ks = small.back(); small.pop_back();
+            int kl = large.back();
+            table[ks].prob = q[ks];
+            table[ks].alias = offset + kl;
+            q[kl] = (q[kl] + q[ks]) - 1;
+            if (q[kl] < 1) {
+                large.pop_back();
+                small.push_back(kl);
+            }
+        }
+
+        // Remainders, which are 1 up to round-off.
+        for (int k : large) {
+            table[k].prob = 1;
+            table[k].alias = offset + k;
+        }
+        for (int k : small) {
+            table[k].prob = 1;
+            table[k].alias = offset + k;
+        }
+    }
 };
 
 /**
@@ -3331,17 +4422,48 @@ public:
             pre::generate_canonical<float_type>(std::forward<G>(gen)));
     }
 
-private:
-
     /**
-     * @brief Point type.
+     * @brief Cumulative distribution function inverse, for arrays.
+     *
+     * @param[in] u
+     * Canonical samples.
+     *
+     * @param[out] x
+     * Numbers.
+     *
+     * @param[in] n
+     * Count.
      */
-    struct point_type
+    void cdfinv_n(const float_type* u, value_type* x, std::size_t n) const
     {
-        /**
-         * @brief Abscissa @f$ x_k @f$.
-         */
-        float_type x = 0;
+        for (std::size_t k = 0; k < n; k++) {
+            x[k] = cdfinv(u[k]);
+        }
+    }
+
+    /**
+     * @brief Generate numbers.
+     *
+     * Equivalent to @f$ n @f$ calls to `operator()`, but generates
+     * canonical samples in blocks for `cdfinv_n()`.
+     */
+    template <typename G>
+    void sample_n(G&& gen, value_type* x, std::size_t n) const
+    {
+        pre::sample_n_(*this, std::forward<G>(gen), x, n);
+    }
+
+private:
+
+    /**
+     * @brief Point type.
+     */
+    struct point_type
+    {
+        /**
+         * @brief Abscissa @f$ x_k @f$.
+         */
+        float_type x = 0;
 
         /**
          * @brief Ordinate @f$ f_k @f$.
@@ -3694,6 +4816,832 @@ typedef pcg_xsh_rr_engine<
 
 /**@}*/
 
+/**
+ * @brief PCG XSH-RR engine lanes.
+ *
+ * Lanes of independent PCG XSH-RR engines, advanced in lockstep. Each
+ * lane produces exactly the sequence of the scalar engine with the
+ * same state and increment, so lanes may stand in for per-pixel or
+ * per-path engines. For `pcg32` with a multiple of 4 lanes, compiling
+ * for AVX2 advances 4 lanes per instruction.
+ *
+ * @tparam Tengine
+ * Engine type, a `pcg_xsh_rr_engine`.
+ *
+ * @tparam N
+ * Lanes.
+ */
+template <typename Tengine, std::size_t N>
+class pcg_xsh_rr_lanes
+{
+public:
+
+    /**
+     * @brief Engine type.
+     */
+    typedef Tengine engine_type;
+
+    /**
+     * @brief Result type.
+     */
+    typedef typename Tengine::result_type result_type;
+
+    /**
+     * @brief State type.
+     */
+    typedef typename Tengine::state_type state_type;
+
+    /**
+     * @brief Lanes.
+     */
+    static constexpr std::size_t lanes = N;
+
+public:
+
+    /**
+     * @brief Default constructor.
+     *
+     * Lane @f$ k @f$ is equivalent to `Tengine(0, k)`.
+     */
+    pcg_xsh_rr_lanes() : pcg_xsh_rr_lanes(state_type(0))
+    {
+    }
+
+    /**
+     * @brief Constructor.
+     *
+     * Lane @f$ k @f$ is equivalent to `Tengine(seed, seq + k)`.
+     */
+    pcg_xsh_rr_lanes(state_type seed, state_type seq = 0)
+    {
+        for (std::size_t k = 0; k < N; k++) {
+            lane(k, Tengine(seed, seq + state_type(k)));
+        }
+    }
+
+    /**
+     * @brief Constructor.
+     *
+     * @param[in] engines
+     * Engines, one per lane.
+     */
+    explicit pcg_xsh_rr_lanes(const Tengine* engines)
+    {
+        for (std::size_t k = 0; k < N; k++) {
+            lane(k, engines[k]);
+        }
+    }
+
+public:
+
+    /**
+     * @brief Get lane as engine.
+     */
+    Tengine lane(std::size_t k) const
+    {
+        Tengine engine;
+        engine.state_ = state_[k];
+        engine.inc_ = inc_[k];
+        return engine;
+    }
+
+    /**
+     * @brief Set lane from engine.
+     */
+    void lane(std::size_t k, const Tengine& engine)
+    {
+        state_[k] = engine.state_;
+        inc_[k] = engine.inc_;
+    }
+
+    /**
+     * @brief Set stream of lane.
+     */
+    void set_stream(std::size_t k, state_type seq)
+    {
+        inc_[k] = (seq << 1) | 1;
+    }
+
+    /**
+     * @brief Result minimum.
+     */
+    static constexpr result_type min() noexcept
+    {
+        return Tengine::min();
+    }
+
+    /**
+     * @brief Result maximum.
+     */
+    static constexpr result_type max() noexcept
+    {
+        return Tengine::max();
+    }
+
+    /**
+     * @brief Generate one result per lane.
+     *
+     * @param[out] out
+     * Results, @f$ N @f$.
+     */
+    void operator()(result_type* out)
+    {
+        generate(out, 1);
+    }
+
+    /**
+     * @brief Generate results.
+     *
+     * @param[out] out
+     * Results, @f$ N @f$ per round, such that `out[r * N + k]` is
+     * the result of lane @f$ k @f$ in round @f$ r @f$.
+     *
+     * @param[in] rounds
+     * Rounds.
+     */
+    void generate(result_type* out, std::size_t rounds)
+    {
+        for (std::size_t r = 0; r < rounds; r++) {
+            advance_(out + r * N, use_avx2_());
+        }
+    }
+
+    /**
+     * @brief Generate canonical random samples.
+     *
+     * Equivalent to `pre::generate_canonical<Tfloat>(lane(k))` for
+     * each lane, in each round, so consumes as many results per
+     * sample as the scalar version.
+     *
+     * @param[out] out
+     * Samples, @f$ N @f$ per round, laid out as in `generate()`.
+     *
+     * @param[in] rounds
+     * Rounds.
+     */
+    template <typename Tfloat>
+    void generate_canonical(Tfloat* out, std::size_t rounds)
+    {
+        // Results per sample.
+        constexpr std::size_t m = canonical_results_<Tfloat>();
+
+        // Rounds per batch.
+        constexpr std::size_t batch = 64;
+
+        result_type buf[batch * m * N];
+        for (std::size_t r0 = 0; r0 < rounds; r0 += batch) {
+            std::size_t nr = std::min(batch, rounds - r0);
+            generate(&buf[0], nr * m);
+            for (std::size_t r = 0; r < nr; r++)
+            for (std::size_t k = 0; k < N; k++) {
+                replay_ gen = {&buf[r * m * N + k]};
+                out[(r0 + r) * N + k] =
+                    pre::generate_canonical<Tfloat>(gen);
+            }
+        }
+    }
+
+    /**
+     * @brief Discard.
+     */
+    void discard(state_type n)
+    {
+        for (std::size_t k = 0; k < N; k++) {
+            state_[k] = pre::lcg_seek<state_type>(
+                        state_[k], Tengine::multiplier, inc_[k], n);
+        }
+    }
+
+    /**
+     * @brief Compare `operator==`.
+     */
+    bool operator==(const pcg_xsh_rr_lanes& other) const
+    {
+        return std::equal(&state_[0], &state_[0] + N, &other.state_[0]) &&
+               std::equal(&inc_[0], &inc_[0] + N, &other.inc_[0]);
+    }
+
+    /**
+     * @brief Compare `operator!=`.
+     */
+    bool operator!=(const pcg_xsh_rr_lanes& other) const
+    {
+        return !operator==(other);
+    }
+
+private:
+
+    /**
+     * @brief States.
+     */
+    alignas(64) state_type state_[N] = {};
+
+    /**
+     * @brief Increments.
+     */
+    alignas(64) state_type inc_[N] = {};
+
+    /**
+     * @brief Replay generator, interleaved by lane.
+     */
+    struct replay_
+    {
+        /**
+         * @brief Next result.
+         */
+        const result_type* ptr;
+
+        static constexpr result_type min() noexcept
+        {
+            return Tengine::min();
+        }
+
+        static constexpr result_type max() noexcept
+        {
+            return Tengine::max();
+        }
+
+        result_type operator()()
+        {
+            result_type res = *ptr;
+            ptr += N;
+            return res;
+        }
+    };
+
+    /**
+     * @brief Results per canonical sample, as in
+     * `pre::generate_canonical()`.
+     */
+    template <typename Tfloat>
+    static constexpr std::size_t canonical_results_()
+    {
+        std::size_t log2r = sizeof(result_type) * 8;
+        std::size_t b = pre::numeric_limits<Tfloat>::digits;
+        std::size_t m = (log2r + b - 1) / log2r;
+        return m < 1 ? 1 : m;
+    }
+
+    /**
+     * @brief Use AVX2, for 64-bit states and 32-bit results?
+     */
+    static constexpr auto use_avx2_()
+    {
+#if defined(__AVX2__)
+        return std::integral_constant<bool,
+                sizeof(state_type) == 8 &&
+                sizeof(result_type) == 4 && N % 4 == 0>();
+#else
+        return std::false_type();
+#endif // #if defined(__AVX2__)
+    }
+
+    /**
+     * @brief Advance, portable.
+     */
+    void advance_(result_type* out, std::false_type)
+    {
+        for (std::size_t k = 0; k < N; k++) {
+            state_type state = state_[k];
+            state_[k] = state * Tengine::multiplier + inc_[k];
+            out[k] = Tengine::output(state);
+        }
+    }
+
+#if defined(__AVX2__)
+
+    /**
+     * @brief Advance, AVX2.
+     */
+    void advance_(result_type* out, std::true_type)
+    {
+        // Multiplier, split into 32-bit halves.
+        const __m256i mul_lo =
+            _mm256_set1_epi64x(
+            std::int64_t(Tengine::multiplier & 0xFFFFFFFFULL));
+        const __m256i mul_hi =
+            _mm256_set1_epi64x(
+            std::int64_t(Tengine::multiplier >> 32));
+        const __m256i mask32 = _mm256_set1_epi64x(0xFFFFFFFFLL);
+        const __m256i thirty_two = _mm256_set1_epi64x(32);
+        const __m256i even = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+        for (std::size_t k = 0; k < N; k += 4) {
+            __m256i state = _mm256_load_si256(
+                    reinterpret_cast<const __m256i*>(&state_[k]));
+            __m256i inc = _mm256_load_si256(
+                    reinterpret_cast<const __m256i*>(&inc_[k]));
+
+            // Advance, with 64-bit low multiply from 32-bit halves.
+            __m256i state_hi = _mm256_srli_epi64(state, 32);
+            __m256i lo = _mm256_mul_epu32(state, mul_lo);
+            __m256i cross = _mm256_add_epi64(
+                    _mm256_mul_epu32(state, mul_hi),
+                    _mm256_mul_epu32(state_hi, mul_lo));
+            __m256i next = _mm256_add_epi64(
+                    _mm256_add_epi64(lo, _mm256_slli_epi64(cross, 32)),
+                    inc);
+            _mm256_store_si256(
+                    reinterpret_cast<__m256i*>(&state_[k]), next);
+
+            // Output, XOR shift.
+            __m256i pivot = _mm256_srli_epi64(state, 59);
+            __m256i x = _mm256_xor_si256(state, _mm256_srli_epi64(state, 18));
+            x = _mm256_and_si256(_mm256_srli_epi64(x, 27), mask32);
+
+            // Output, random rotate.
+            x = _mm256_and_si256(
+                _mm256_or_si256(
+                    _mm256_srlv_epi64(x, pivot),
+                    _mm256_sllv_epi64(x,
+                        _mm256_sub_epi64(thirty_two, pivot))), mask32);
+
+            // Pack.
+            x = _mm256_permutevar8x32_epi32(x, even);
+            _mm_storeu_si128(
+                reinterpret_cast<__m128i*>(out + k),
+                _mm256_castsi256_si128(x));
+        }
+    }
+
+#endif // #if defined(__AVX2__)
+};
+
+/**
+ * @name PCG lanes
+ */
+/**@{*/
+
+/**
+ * @brief 4 lanes of 32-bit PCG XSH-RR generators.
+ */
+typedef pcg_xsh_rr_lanes<pcg32, 4> pcg32x4;
+
+/**
+ * @brief 8 lanes of 32-bit PCG XSH-RR generators.
+ */
+typedef pcg_xsh_rr_lanes<pcg32, 8> pcg32x8;
+
+/**
+ * @brief 16 lanes of 32-bit PCG XSH-RR generators.
+ */
+typedef pcg_xsh_rr_lanes<pcg32, 16> pcg32x16;
+
+/**@}*/
+
+/**
+ * @brief Philox 4x32 engine.
+ *
+ * Counter-based generator of [Salmon et al. 2011][1]. Results are
+ * a keyed bijection of a 128-bit counter, 4 results per counter, so
+ * any result may be computed directly from (key, counter) without
+ * threading state through call chains. For example, key by seed,
+ * set the high counter to the pixel and sample indices, and let the
+ * low counter run over dimensions.
+ *
+ * [1]: https://doi.org/10.1145/2063384.2063405
+ *
+ * @tparam Nrounds
+ * Rounds, 10 by convention.
+ */
+template <std::size_t Nrounds = 10>
+class philox4x32_engine
+{
+public:
+
+    /**
+     * @brief Result type.
+     */
+    typedef std::uint32_t result_type;
+
+    /**
+     * @brief Results per counter.
+     */
+    static constexpr std::size_t block_size = 4;
+
+public:
+
+    /**
+     * @brief Constructor.
+     *
+     * @param[in] key
+     * Key.
+     *
+     * @param[in] counter_hi
+     * Counter, high 64 bits.
+     *
+     * @param[in] counter_lo
+     * Counter, low 64 bits.
+     */
+    explicit philox4x32_engine(
+            std::uint64_t key = 0,
+            std::uint64_t counter_hi = 0,
+            std::uint64_t counter_lo = 0) :
+                key_(key),
+                counter_hi_(counter_hi),
+                counter_lo_(counter_lo)
+    {
+    }
+
+public:
+
+    /**
+     * @brief Key.
+     */
+    std::uint64_t key() const
+    {
+        return key_;
+    }
+
+    /**
+     * @brief Counter, high 64 bits.
+     */
+    std::uint64_t counter_hi() const
+    {
+        return counter_hi_;
+    }
+
+    /**
+     * @brief Counter, low 64 bits, of next block.
+     */
+    std::uint64_t counter_lo() const
+    {
+        return counter_lo_;
+    }
+
+    /**
+     * @brief Seek to counter, and discard buffered results.
+     */
+    void seek(std::uint64_t counter_hi, std::uint64_t counter_lo)
+    {
+        counter_hi_ = counter_hi;
+        counter_lo_ = counter_lo;
+        index_ = block_size;
+    }
+
+    /**
+     * @brief Result minimum.
+     */
+    static constexpr result_type min() noexcept
+    {
+        return 0;
+    }
+
+    /**
+     * @brief Result maximum.
+     */
+    static constexpr result_type max() noexcept
+    {
+        return 0xFFFFFFFFUL;
+    }
+
+    /**
+     * @brief Generate result.
+     */
+    result_type operator()()
+    {
+        if (index_ == block_size) {
+            block(key_, counter_hi_, counter_lo_, &buffer_[0]);
+            increment_();
+            index_ = 0;
+        }
+        return buffer_[index_++];
+    }
+
+    /**
+     * @brief Generate results.
+     *
+     * Equivalent to calling `operator()` @f$ n @f$ times, but
+     * computes whole blocks in batches.
+     *
+     * @param[out] out
+     * Results.
+     *
+     * @param[in] n
+     * Count.
+     */
+    void generate(result_type* out, std::size_t n)
+    {
+        // Drain buffer.
+        while (n > 0 && index_ < block_size) {
+            *out++ = buffer_[index_++];
+            n--;
+        }
+
+        // Batches.
+        constexpr std::size_t batch = 32;
+        while (n >= batch * block_size) {
+            blocks_<batch>(counter_lo_, out);
+            counter_lo_ += batch;
+            counter_hi_ += counter_lo_ < batch;
+            out += batch * block_size;
+            n -= batch * block_size;
+        }
+
+        // Tail.
+        while (n > 0) {
+            *out++ = operator()();
+            n--;
+        }
+    }
+
+    /**
+     * @brief Discard.
+     */
+    void discard(unsigned long long n)
+    {
+        std::size_t buffered = block_size - index_;
+        if (n <= buffered) {
+            index_ += n;
+            return;
+        }
+        n -= buffered;
+        index_ = block_size;
+        std::uint64_t blocks = n / block_size;
+        counter_lo_ += blocks;
+        counter_hi_ += counter_lo_ < blocks;
+        n %= block_size;
+        if (n > 0) {
+            operator()();
+            index_ = n;
+        }
+    }
+
+    /**
+     * @brief Compare `operator==`.
+     */
+    bool operator==(const philox4x32_engine& other) const
+    {
+        if (!(key_ == other.key_ &&
+              counter_hi_ == other.counter_hi_ &&
+              counter_lo_ == other.counter_lo_ &&
+              index_ == other.index_)) {
+            return false;
+        }
+        return std::equal(
+                &buffer_[0] + index_,
+                &buffer_[0] + block_size,
+                &other.buffer_[0] + index_);
+    }
+
+    /**
+     * @brief Compare `operator!=`.
+     */
+    bool operator!=(const philox4x32_engine& other) const
+    {
+        return !operator==(other);
+    }
+
+public:
+
+    /**
+     * @brief Compute block.
+     *
+     * @param[in] key
+     * Key.
+     *
+     * @param[in] counter_hi
+     * Counter, high 64 bits.
+     *
+     * @param[in] counter_lo
+     * Counter, low 64 bits.
+     *
+     * @param[out] out
+     * Results, 4.
+     */
+    static void block(
+            std::uint64_t key,
+            std::uint64_t counter_hi,
+            std::uint64_t counter_lo,
+            result_type* out)
+    {
+        std::uint32_t c0 = std::uint32_t(counter_lo);
+        std::uint32_t c1 = std::uint32_t(counter_lo >> 32);
+        std::uint32_t c2 = std::uint32_t(counter_hi);
+        std::uint32_t c3 = std::uint32_t(counter_hi >> 32);
+        std::uint32_t k0 = std::uint32_t(key);
+        std::uint32_t k1 = std::uint32_t(key >> 32);
+        for (std::size_t r = 0; r < Nrounds; r++) {
+            round_(c0, c1, c2, c3, k0, k1);
+            k0 += weyl0_;
+            k1 += weyl1_;
+        }
+        out[0] = c0;
+        out[1] = c1;
+        out[2] = c2;
+        out[3] = c3;
+    }
+
+private:
+
+    /**
+     * @brief Key.
+     */
+    std::uint64_t key_ = 0;
+
+    /**
+     * @brief Counter, high 64 bits.
+     */
+    std::uint64_t counter_hi_ = 0;
+
+    /**
+     * @brief Counter, low 64 bits, of next block.
+     */
+    std::uint64_t counter_lo_ = 0;
+
+    /**
+     * @brief Buffered block.
+     */
+    result_type buffer_[block_size] = {};
+
+    /**
+     * @brief Buffer index.
+     */
+    std::size_t index_ = block_size;
+
+    /**
+     * @brief Multiplier 0.
+     */
+    static constexpr std::uint64_t mul0_ = 0xD2511F53ULL;
+
+    /**
+     * @brief Multiplier 1.
+     */
+    static constexpr std::uint64_t mul1_ = 0xCD9E8D57ULL;
+
+    /**
+     * @brief Weyl key increment 0.
+     */
+    static constexpr std::uint32_t weyl0_ = 0x9E3779B9UL;
+
+    /**
+     * @brief Weyl key increment 1.
+     */
+    static constexpr std::uint32_t weyl1_ = 0xBB67AE85UL;
+
+    /**
+     * @brief Increment counter.
+     */
+    void increment_()
+    {
+        counter_lo_++;
+        counter_hi_ += counter_lo_ == 0;
+    }
+
+    /**
+     * @brief Round.
+     */
+    __attribute__((always_inline))
+    static void round_(
+            std::uint32_t& c0,
+            std::uint32_t& c1,
+            std::uint32_t& c2,
+            std::uint32_t& c3,
+            std::uint32_t k0,
+            std::uint32_t k1)
+    {
+        std::uint64_t p0 = mul0_ * c0;
+        std::uint64_t p1 = mul1_ * c2;
+        std::uint32_t d0 = std::uint32_t(p1 >> 32) ^ c1 ^ k0;
+        std::uint32_t d2 = std::uint32_t(p0 >> 32) ^ c3 ^ k1;
+        c1 = std::uint32_t(p1);
+        c3 = std::uint32_t(p0);
+        c0 = d0;
+        c2 = d2;
+    }
+
+    /**
+     * @brief Compute consecutive blocks.
+     */
+    template <std::size_t Nbatch>
+    void blocks_(std::uint64_t counter_lo, result_type* out) const
+    {
+#if defined(__AVX2__)
+        blocks_<Nbatch>(counter_lo, out,
+                std::integral_constant<bool, Nbatch % 8 == 0>());
+#else
+        blocks_<Nbatch>(counter_lo, out, std::false_type());
+#endif // #if defined(__AVX2__)
+    }
+
+    /**
+     * @brief Compute consecutive blocks, portable.
+     */
+    template <std::size_t Nbatch>
+    void blocks_(
+            std::uint64_t counter_lo,
+            result_type* out,
+            std::false_type) const
+    {
+        for (std::size_t j = 0; j < Nbatch; j++) {
+            std::uint64_t lo = counter_lo + j;
+            block(key_, counter_hi_ + (lo < counter_lo), lo, out + 4 * j);
+        }
+    }
+
+#if defined(__AVX2__)
+
+    /**
+     * @brief Compute consecutive blocks, AVX2.
+     *
+     * Computes 8 blocks at a time in structure-of-arrays form, then
+     * transposes to interleaved results.
+     */
+    template <std::size_t Nbatch>
+    void blocks_(
+            std::uint64_t counter_lo,
+            result_type* out,
+            std::true_type) const
+    {
+        const __m256i mul0 = _mm256_set1_epi64x(std::int64_t(mul0_));
+        const __m256i mul1 = _mm256_set1_epi64x(std::int64_t(mul1_));
+        for (std::size_t j0 = 0; j0 < Nbatch; j0 += 8) {
+            alignas(32) std::uint32_t w[4][8];
+            for (std::size_t j = 0; j < 8; j++) {
+                std::uint64_t lo = counter_lo + j0 + j;
+                std::uint64_t hi = counter_hi_ + (lo < counter_lo);
+                w[0][j] = std::uint32_t(lo);
+                w[1][j] = std::uint32_t(lo >> 32);
+                w[2][j] = std::uint32_t(hi);
+                w[3][j] = std::uint32_t(hi >> 32);
+            }
+            __m256i c0 = _mm256_load_si256(
+                    reinterpret_cast<const __m256i*>(&w[0][0]));
+            __m256i c1 = _mm256_load_si256(
+                    reinterpret_cast<const __m256i*>(&w[1][0]));
+            __m256i c2 = _mm256_load_si256(
+                    reinterpret_cast<const __m256i*>(&w[2][0]));
+            __m256i c3 = _mm256_load_si256(
+                    reinterpret_cast<const __m256i*>(&w[3][0]));
+            std::uint32_t k0 = std::uint32_t(key_);
+            std::uint32_t k1 = std::uint32_t(key_ >> 32);
+            for (std::size_t r = 0; r < Nrounds; r++) {
+                // Products, with even and odd lanes separately.
+                __m256i p0e = _mm256_mul_epu32(c0, mul0);
+                __m256i p0o = _mm256_mul_epu32(
+                        _mm256_srli_epi64(c0, 32), mul0);
+                __m256i p1e = _mm256_mul_epu32(c2, mul1);
+                __m256i p1o = _mm256_mul_epu32(
+                        _mm256_srli_epi64(c2, 32), mul1);
+                __m256i p0lo = _mm256_blend_epi32(
+                        p0e, _mm256_slli_epi64(p0o, 32), 0xAA);
+                __m256i p0hi = _mm256_blend_epi32(
+                        _mm256_srli_epi64(p0e, 32), p0o, 0xAA);
+                __m256i p1lo = _mm256_blend_epi32(
+                        p1e, _mm256_slli_epi64(p1o, 32), 0xAA);
+                __m256i p1hi = _mm256_blend_epi32(
+                        _mm256_srli_epi64(p1e, 32), p1o, 0xAA);
+
+                // Mix.
+                __m256i d0 = _mm256_xor_si256(
+                        _mm256_xor_si256(p1hi, c1),
+                        _mm256_set1_epi32(std::int32_t(k0)));
+                __m256i d2 = _mm256_xor_si256(
+                        _mm256_xor_si256(p0hi, c3),
+                        _mm256_set1_epi32(std::int32_t(k1)));
+                c0 = d0;
+                c1 = p1lo;
+                c2 = d2;
+                c3 = p0lo;
+                k0 += weyl0_;
+                k1 += weyl1_;
+            }
+
+            // Transpose.
+            __m256i t0 = _mm256_unpacklo_epi32(c0, c1);
+            __m256i t1 = _mm256_unpackhi_epi32(c0, c1);
+            __m256i t2 = _mm256_unpacklo_epi32(c2, c3);
+            __m256i t3 = _mm256_unpackhi_epi32(c2, c3);
+            __m256i b04 = _mm256_unpacklo_epi64(t0, t2);
+            __m256i b15 = _mm256_unpackhi_epi64(t0, t2);
+            __m256i b26 = _mm256_unpacklo_epi64(t1, t3);
+            __m256i b37 = _mm256_unpackhi_epi64(t1, t3);
+            __m256i* ptr = reinterpret_cast<__m256i*>(out + 4 * j0);
+            _mm256_storeu_si256(ptr + 0,
+                    _mm256_permute2x128_si256(b04, b15, 0x20));
+            _mm256_storeu_si256(ptr + 1,
+                    _mm256_permute2x128_si256(b26, b37, 0x20));
+            _mm256_storeu_si256(ptr + 2,
+                    _mm256_permute2x128_si256(b04, b15, 0x31));
+            _mm256_storeu_si256(ptr + 3,
+                    _mm256_permute2x128_si256(b26, b37, 0x31));
+        }
+    }
+
+#endif // #if defined(__AVX2__)
+};
+
+/**
+ * @name Philox
+ */
+/**@{*/
+
+/**
+ * @brief Philox 4x32-10 generator.
+ */
+typedef philox4x32_engine<10> philox4x32;
+
+/**@}*/
+
 /**@}*/
 
 } // namespace pre
@@ -35,6 +35,10 @@
 #ifndef PREFORM_RUNNING_STAT_HPP
 #define PREFORM_RUNNING_STAT_HPP
 
+// for std::size_t
+#include <cstddef>
+
+// for pre::sqrt, pre::nthpow
 #include <preform/math.hpp>
 
 namespace pre {
@@ -65,6 +69,11 @@ public:
         std::is_floating_point<T>::value,
         "T must be floating point");
 
+    /**
+     * @brief Number of lanes in bulk addition.
+     */
+    static constexpr std::size_t lanes = 8;
+
 public:
 
     /**
@@ -254,12 +263,18 @@ public:
      * - @f$ M_3' \gets M_{3,A} + M_{3,B} + q d (r_A - r_B) +
      *         3 d (r_A M_{2,B} - r_B M_{2,A}) @f$
      * - @f$ M_4' \gets M_{4,A} + M_{4,B} + q d^2 (r_A^2 - r_A r_B + r_B^2) +
-     *         6 d^2 (r_A^2 M_{2,B} - r_B^2 M_{2,A}) +
+     *         6 d^2 (r_A^2 M_{2,B} + r_B^2 M_{2,A}) +
      *         4 d (r_A M_{3,B} - r_B M_{3,A}) @f$
      */
     running_stat operator+(const running_stat& b) const
     {
         const running_stat& a = *this;
+        if (a.n_ == 0) {
+            return b;
+        }
+        if (b.n_ == 0) {
+            return a;
+        }
 
         // Temporary terms.
         T d = b.m_[0] - a.m_[0];
@@ -282,7 +297,7 @@ public:
             a.m_[3] + b.m_[3] +
             d * (d * (q * (ra * ra - ra * rb + rb * rb) +
             6 * (ra * ra * b.m_[1] + rb * rb * a.m_[1])) +
-            4 * (ra * b.m_[2] + rb * a.m_[2]))
+            4 * (ra * b.m_[2] - rb * a.m_[2]))
         };
     }
 
@@ -294,6 +309,68 @@ public:
         return *this + -b;
     }
 
+    /**
+     * @brief Merge, e.g., per-thread partial statistics.
+     *
+     * Equivalent to `*this += b`, as a named operation for use
+     * in reductions.
+     */
+    running_stat& merge(const running_stat& b)
+    {
+        return *this = *this + b;
+    }
+
+    /**
+     * @brief Add terms.
+     *
+     * Keeps independent statistics in lanes, each taking every
+     * `lanes`-th term, so the loop vectorizes. As lanes share their
+     * count, the division is shared too. The lanes are then merged,
+     * along with any remaining terms.
+     *
+     * @param[in] x
+     * Terms.
+     *
+     * @param[in] n
+     * Number of terms.
+     */
+    running_stat& add(const T* x, std::size_t n)
+    {
+        running_stat res;
+        std::size_t k = n / lanes;
+        if (k > 0) {
+            T m0[lanes] = {};
+            T m1[lanes] = {};
+            T m2[lanes] = {};
+            T m3[lanes] = {};
+            for (std::size_t j = 0; j < k; j++) {
+                const T* xj = x + j * lanes;
+                T n0 = T(j);
+                T n1 = T(j + 1);
+                T c2 = n0 - 1;
+                T c3 = n0 * (n0 - 1) + 1;
+                T inv = 1 / n1;
+                for (std::size_t l = 0; l < lanes; l++) {
+                    T d = xj[l] - m0[l];
+                    T s = d * inv;
+                    T t = d * n0 * s;
+                    m0[l] += s;
+                    m3[l] += s * (s * (t * c3 + 6 * m1[l]) - 4 * m2[l]);
+                    m2[l] += s * (t * c2 - 3 * m1[l]);
+                    m1[l] += t;
+                }
+            }
+            for (std::size_t l = 0; l < lanes; l++) {
+                res += running_stat(
+                        (long long)k, m0[l], m1[l], m2[l], m3[l]);
+            }
+        }
+        for (std::size_t j = k * lanes; j < n; j++) {
+            res += x[j];
+        }
+        return merge(res);
+    }
+
     /**
      * @brief Generic `operator+=`.
      */
@@ -0,0 +1,1230 @@
+/* Copyright (c) 2018-20 M. Grady Saunders
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer.
+ *
+ *   2. Redistributions in binary form must reproduce the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer in the documentation and/or other materials
+ *      provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*+-+*/
+#if !DOXYGEN
+#if !(__cplusplus >= 201703L)
+#error "preform/simd.hpp requires >=C++17"
+#endif // #if !(__cplusplus >= 201703L)
+#endif // #if !DOXYGEN
+#pragma once
+#ifndef PREFORM_SIMD_HPP
+#define PREFORM_SIMD_HPP
+
+// for std::size_t
+#include <cstddef>
+
+// for std::int8_t, std::int16_t, std::int32_t, std::int64_t, ...
+#include <cstdint>
+
+// for std::memcpy
+#include <cstring>
+
+// for std::basic_ostream
+#include <ostream>
+
+// for std::common_type, std::enable_if, std::is_arithmetic, ...
+#include <type_traits>
+
+// for std::declval
+#include <utility>
+
+#if defined(__SSE2__)
+
+// for _mm_sqrt_ps, _mm256_sqrt_ps, ...
+#include <immintrin.h>
+
+#endif // #if defined(__SSE2__)
+
+// for pre::sqrt, pre::numeric_limits, ...
+#include <preform/math.hpp>
+
+namespace pre {
+
+/**
+ * @defgroup simd SIMD value
+ *
+ * `<preform/simd.hpp>`
+ *
+ * __C++ version__: >=C++17
+ *
+ * A fixed-width packet of lanes with entrywise arithmetic, intended
+ * as the entry type of `multi`, `quat`, and `aabb` to form
+ * structure-of-arrays packets, e.g., `multi<simd<float, 8>, 3>` for
+ * 8 directions at once. Lanes are stored in an aligned array and
+ * operated on in fixed-length loops which the compiler vectorizes, so
+ * generic algorithms run on packets without modification as long as
+ * they do not branch on values. Use `select()` to blend lanes in
+ * place of branching.
+ *
+ * @note
+ * The `multi` math wrappers resolve `pre::` overloads where they are
+ * defined, so `<preform/multi_math.hpp>` includes this header
+ * ahead of its wrappers.
+ */
+/**@{*/
+
+#if !DOXYGEN
+
+template <typename T, std::size_t W>
+class simd;
+
+template <typename T, std::size_t W>
+class simd_mask;
+
+template <typename T>
+struct is_simd : std::false_type
+{
+};
+
+template <typename T, std::size_t W>
+struct is_simd<simd<T, W>> : std::true_type
+{
+};
+
+template <typename T>
+struct is_simd_mask : std::false_type
+{
+};
+
+template <typename T, std::size_t W>
+struct is_simd_mask<simd_mask<T, W>> : std::true_type
+{
+};
+
+// Signed integer of given size, for mask lanes.
+template <std::size_t Nbytes>
+struct simd_mask_lane_;
+
+template <>
+struct simd_mask_lane_<1>
+{
+    typedef std::int8_t type;
+};
+
+template <>
+struct simd_mask_lane_<2>
+{
+    typedef std::int16_t type;
+};
+
+template <>
+struct simd_mask_lane_<4>
+{
+    typedef std::int32_t type;
+};
+
+template <>
+struct simd_mask_lane_<8>
+{
+    typedef std::int64_t type;
+};
+
+#endif // #if !DOXYGEN
+
+/**
+ * @brief Entry type of SIMD value, or type itself if not SIMD.
+ *
+ * Lets traits such as `std::is_floating_point` see through
+ * `simd<T, W>` to `T`.
+ */
+template <typename T>
+struct simd_value_type
+{
+    typedef T type;
+};
+
+/**
+ * @brief Entry type of SIMD value, specialization.
+ */
+template <typename T, std::size_t W>
+struct simd_value_type<simd<T, W>>
+{
+    typedef T type;
+};
+
+/**
+ * @brief Entry type of SIMD value, or type itself if not SIMD.
+ */
+template <typename T>
+using simd_value_type_t = typename simd_value_type<T>::type;
+
+/**
+ * @brief SIMD mask.
+ *
+ * @tparam T
+ * Value type of corresponding `simd`, which determines the lane
+ * size, so that masks blend directly with values.
+ *
+ * @tparam W
+ * Width, i.e., number of lanes.
+ */
+template <typename T, std::size_t W>
+class simd_mask
+{
+public:
+
+    // Sanity check.
+    static_assert(W > 0 && (W & (W - 1)) == 0,
+        "W must be a power of 2");
+
+    /**
+     * @brief Lane type.
+     *
+     * Signed integer the same size as `T`, either 0 for false
+     * or -1 for true, as SIMD comparisons produce.
+     */
+    typedef typename simd_mask_lane_<sizeof(T)>::type lane_type;
+
+    /**
+     * @brief Size type.
+     */
+    typedef std::size_t size_type;
+
+public:
+
+    /**
+     * @brief Default constructor, all false.
+     */
+    constexpr simd_mask() = default;
+
+    /**
+     * @brief Constructor, broadcast.
+     */
+    constexpr simd_mask(bool b)
+    {
+        for (size_type k = 0; k < W; k++) {
+            m_[k] = -lane_type(b);
+        }
+    }
+
+    /**
+     * @brief Constructor, from bool array.
+     */
+    constexpr explicit simd_mask(const bool* ptr) __attribute__((nonnull))
+    {
+        for (size_type k = 0; k < W; k++) {
+            m_[k] = -lane_type(ptr[k]);
+        }
+    }
+
+    /**
+     * @brief Width.
+     */
+    static constexpr size_type size() noexcept
+    {
+        return W;
+    }
+
+    /**
+     * @brief Lane accessor.
+     */
+    constexpr bool operator[](size_type k) const noexcept
+    {
+        return m_[k] != 0;
+    }
+
+    /**
+     * @brief Set lane.
+     */
+    constexpr void set(size_type k, bool b) noexcept
+    {
+        m_[k] = -lane_type(b);
+    }
+
+    /**
+     * @brief Raw lane, either 0 or -1.
+     */
+    constexpr lane_type lane(size_type k) const noexcept
+    {
+        return m_[k];
+    }
+
+    /**
+     * @brief Any lanes true?
+     */
+    constexpr bool any() const noexcept
+    {
+        lane_type acc = 0;
+        for (size_type k = 0; k < W; k++) {
+            acc |= m_[k];
+        }
+        return acc != 0;
+    }
+
+    /**
+     * @brief All lanes true?
+     */
+    constexpr bool all() const noexcept
+    {
+        lane_type acc = -1;
+        for (size_type k = 0; k < W; k++) {
+            acc &= m_[k];
+        }
+        return acc != 0;
+    }
+
+    /**
+     * @brief No lanes true?
+     */
+    constexpr bool none() const noexcept
+    {
+        return !any();
+    }
+
+    /**
+     * @brief Number of lanes true.
+     */
+    constexpr size_type count() const noexcept
+    {
+        size_type n = 0;
+        for (size_type k = 0; k < W; k++) {
+            n += size_type(m_[k] & 1);
+        }
+        return n;
+    }
+
+    /**
+     * @brief Lanes as bits, lane @f$ k @f$ in bit @f$ k @f$.
+     */
+    template <bool B = (W <= 64)>
+    constexpr std::enable_if_t<B, std::uint64_t> bits() const noexcept
+    {
+        std::uint64_t res = 0;
+        for (size_type k = 0; k < W; k++) {
+            res |= std::uint64_t(m_[k] & 1) << k;
+        }
+        return res;
+    }
+
+public:
+
+    /**
+     * @name Logical operators
+     */
+    /**@{*/
+
+    /**
+     * @brief Lanewise logical not.
+     */
+    __attribute__((always_inline))
+    friend constexpr simd_mask operator!(const simd_mask& m)
+    {
+        simd_mask res;
+        for (size_type k = 0; k < W; k++) {
+            res.m_[k] = ~m.m_[k];
+        }
+        return res;
+    }
+
+    /**
+     * @brief Lanewise logical and.
+     */
+    __attribute__((always_inline))
+    friend constexpr simd_mask operator&&(
+                        const simd_mask& m0, const simd_mask& m1)
+    {
+        return m0 & m1;
+    }
+
+    /**
+     * @brief Lanewise logical or.
+     */
+    __attribute__((always_inline))
+    friend constexpr simd_mask operator||(
+                        const simd_mask& m0, const simd_mask& m1)
+    {
+        return m0 | m1;
+    }
+
+    /**
+     * @brief Lanewise and.
+     */
+    __attribute__((always_inline))
+    friend constexpr simd_mask operator&(
+                        const simd_mask& m0, const simd_mask& m1)
+    {
+        simd_mask res;
+        for (size_type k = 0; k < W; k++) {
+            res.m_[k] = m0.m_[k] & m1.m_[k];
+        }
+        return res;
+    }
+
+    /**
+     * @brief Lanewise or.
+     */
+    __attribute__((always_inline))
+    friend constexpr simd_mask operator|(
+                        const simd_mask& m0, const simd_mask& m1)
+    {
+        simd_mask res;
+        for (size_type k = 0; k < W; k++) {
+            res.m_[k] = m0.m_[k] | m1.m_[k];
+        }
+        return res;
+    }
+
+    /**
+     * @brief Lanewise exclusive or.
+     */
+    __attribute__((always_inline))
+    friend constexpr simd_mask operator^(
+                        const simd_mask& m0, const simd_mask& m1)
+    {
+        simd_mask res;
+        for (size_type k = 0; k < W; k++) {
+            res.m_[k] = m0.m_[k] ^ m1.m_[k];
+        }
+        return res;
+    }
+
+    /**
+     * @brief Lanewise equal.
+     */
+    __attribute__((always_inline))
+    friend constexpr simd_mask operator==(
+                        const simd_mask& m0, const simd_mask& m1)
+    {
+        return !(m0 ^ m1);
+    }
+
+    /**
+     * @brief Lanewise not equal.
+     */
+    __attribute__((always_inline))
+    friend constexpr simd_mask operator!=(
+                        const simd_mask& m0, const simd_mask& m1)
+    {
+        return m0 ^ m1;
+    }
+
+    /**
+     * @brief Lanewise and, assignment.
+     */
+    constexpr simd_mask& operator&=(const simd_mask& oth)
+    {
+        return *this = *this & oth;
+    }
+
+    /**
+     * @brief Lanewise or, assignment.
+     */
+    constexpr simd_mask& operator|=(const simd_mask& oth)
+    {
+        return *this = *this | oth;
+    }
+
+    /**
+     * @brief Lanewise exclusive or, assignment.
+     */
+    constexpr simd_mask& operator^=(const simd_mask& oth)
+    {
+        return *this = *this ^ oth;
+    }
+
+    /**@}*/
+
+public:
+
+    /**
+     * @brief Write into `std::basic_ostream`.
+     *
+     * Format is `<m0,m1,...>`.
+     */
+    template <typename C, typename Ctraits>
+    friend
+    inline std::basic_ostream<C, Ctraits>& operator<<(
+           std::basic_ostream<C, Ctraits>& os, const simd_mask& m)
+    {
+        os << '<';
+        for (size_type k = 0; k < W; k++) {
+            if (k > 0) {
+                os << ',';
+            }
+            os << m[k];
+        }
+        os << '>';
+        return os;
+    }
+
+private:
+
+    /**
+     * @brief Lanes.
+     */
+    alignas(sizeof(lane_type) * W) lane_type m_[W] = {};
+};
+
+/**
+ * @brief SIMD value.
+ *
+ * @tparam T
+ * Value type, arithmetic.
+ *
+ * @tparam W
+ * Width, i.e., number of lanes, a power of 2. For best results,
+ * `sizeof(T) * W` should be a multiple of the native vector size,
+ * e.g., `simd<float, 8>` for AVX.
+ */
+template <typename T, std::size_t W>
+class simd
+{
+public:
+
+    // Sanity check.
+    static_assert(
+        std::is_arithmetic<T>::value,
+        "T must be arithmetic");
+
+    // Sanity check.
+    static_assert(W > 0 && (W & (W - 1)) == 0,
+        "W must be a power of 2");
+
+    /**
+     * @brief Value type.
+     */
+    typedef T value_type;
+
+    /**
+     * @brief Mask type.
+     */
+    typedef simd_mask<T, W> mask_type;
+
+    /**
+     * @brief Size type.
+     */
+    typedef std::size_t size_type;
+
+public:
+
+    /**
+     * @name Constructors
+     */
+    /**@{*/
+
+    /**
+     * @brief Default constructor, all zero.
+     */
+    constexpr simd() = default;
+
+    /**
+     * @brief Constructor, broadcast.
+     */
+    __attribute__((always_inline))
+    constexpr simd(const T& val)
+    {
+        for (size_type k = 0; k < W; k++) {
+            v_[k] = val;
+        }
+    }
+
+    /**
+     * @brief Constructor, load from unaligned array.
+     *
+     * @note
+     * A template so that literal zero, as in `T(0)`, is not mistaken
+     * for a null pointer.
+     */
+    template <
+        typename U,
+        typename = std::enable_if_t<std::is_same<U, T>::value>
+        >
+    __attribute__((always_inline, nonnull))
+    constexpr explicit simd(const U* ptr)
+    {
+        load(ptr);
+    }
+
+    /**
+     * @brief Constructor, convert lanes.
+     */
+    template <typename U>
+    __attribute__((always_inline))
+    constexpr simd(const simd<U, W>& oth)
+    {
+        for (size_type k = 0; k < W; k++) {
+            v_[k] = T(oth[k]);
+        }
+    }
+
+    /**
+     * @brief Generate lanes @f$ v_k = f(k) @f$.
+     */
+    template <typename F>
+    __attribute__((always_inline))
+    static constexpr simd generate(F&& func)
+    {
+        simd res;
+        for (size_type k = 0; k < W; k++) {
+            res.v_[k] = T(std::forward<F>(func)(k));
+        }
+        return res;
+    }
+
+    /**
+     * @brief Lane indexes @f$ v_k = k @f$.
+     */
+    static constexpr simd iota()
+    {
+        simd res;
+        for (size_type k = 0; k < W; k++) {
+            res.v_[k] = T(k);
+        }
+        return res;
+    }
+
+    /**@}*/
+
+public:
+
+    /**
+     * @name Container interface
+     */
+    /**@{*/
+
+    /**
+     * @brief Width.
+     */
+    static constexpr size_type size() noexcept
+    {
+        return W;
+    }
+
+    /**
+     * @brief Lane accessor.
+     */
+    __attribute__((always_inline))
+    constexpr T& operator[](size_type k) noexcept
+    {
+        return v_[k];
+    }
+
+    /**
+     * @brief Lane accessor, const variant.
+     */
+    __attribute__((always_inline))
+    constexpr const T& operator[](size_type k) const noexcept
+    {
+        return v_[k];
+    }
+
+    /**
+     * @brief Data.
+     */
+    constexpr T* data() noexcept
+    {
+        return &v_[0];
+    }
+
+    /**
+     * @brief Data, const variant.
+     */
+    constexpr const T* data() const noexcept
+    {
+        return &v_[0];
+    }
+
+    /**
+     * @brief Begin iterator.
+     */
+    constexpr T* begin() noexcept
+    {
+        return &v_[0];
+    }
+
+    /**
+     * @brief Begin iterator, const variant.
+     */
+    constexpr const T* begin() const noexcept
+    {
+        return &v_[0];
+    }
+
+    /**
+     * @brief End iterator.
+     */
+    constexpr T* end() noexcept
+    {
+        return &v_[0] + W;
+    }
+
+    /**
+     * @brief End iterator, const variant.
+     */
+    constexpr const T* end() const noexcept
+    {
+        return &v_[0] + W;
+    }
+
+    /**@}*/
+
+public:
+
+    /**
+     * @name Memory
+     */
+    /**@{*/
+
+    /**
+     * @brief Load from unaligned array.
+     */
+    __attribute__((always_inline))
+    constexpr simd& load(const T* ptr) __attribute__((nonnull))
+    {
+        for (size_type k = 0; k < W; k++) {
+            v_[k] = ptr[k];
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Load lanes where mask is true, leaving others unchanged.
+     *
+     * @note
+     * Lanes where the mask is false are not read, so `ptr` may point
+     * to a partial packet at the end of an array.
+     */
+    __attribute__((always_inline))
+    constexpr simd& load(const T* ptr, const mask_type& m)
+                                        __attribute__((nonnull))
+    {
+        for (size_type k = 0; k < W; k++) {
+            if (m[k]) {
+                v_[k] = ptr[k];
+            }
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Store into unaligned array.
+     */
+    __attribute__((always_inline))
+    constexpr void store(T* ptr) const __attribute__((nonnull))
+    {
+        for (size_type k = 0; k < W; k++) {
+            ptr[k] = v_[k];
+        }
+    }
+
+    /**
+     * @brief Store lanes where mask is true.
+     */
+    __attribute__((always_inline))
+    constexpr void store(T* ptr, const mask_type& m) const
+                                        __attribute__((nonnull))
+    {
+        for (size_type k = 0; k < W; k++) {
+            if (m[k]) {
+                ptr[k] = v_[k];
+            }
+        }
+    }
+
+    /**
+     * @brief Gather @f$ v_k = p_{[i_k]} @f$.
+     */
+    template <typename I>
+    __attribute__((always_inline, nonnull))
+    static constexpr simd gather(const T* ptr, const simd<I, W>& idx)
+    {
+        static_assert(std::is_integral<I>::value, "I must be integral");
+        simd res;
+        for (size_type k = 0; k < W; k++) {
+            res.v_[k] = ptr[idx[k]];
+        }
+        return res;
+    }
+
+    /**
+     * @brief Scatter @f$ p_{[i_k]} = v_k @f$.
+     *
+     * @note
+     * If indexes repeat, the highest lane wins.
+     */
+    template <typename I>
+    __attribute__((always_inline, nonnull))
+    constexpr void scatter(T* ptr, const simd<I, W>& idx) const
+    {
+        static_assert(std::is_integral<I>::value, "I must be integral");
+        for (size_type k = 0; k < W; k++) {
+            ptr[idx[k]] = v_[k];
+        }
+    }
+
+    /**@}*/
+
+public:
+
+    /**
+     * @name Reductions
+     */
+    /**@{*/
+
+    /**
+     * @brief Sum of lanes.
+     */
+    constexpr T sum() const
+    {
+        return reduce_([](T x, T y) { return x + y; });
+    }
+
+    /**
+     * @brief Product of lanes.
+     */
+    constexpr T prod() const
+    {
+        return reduce_([](T x, T y) { return x * y; });
+    }
+
+    /**
+     * @brief Minimum of lanes.
+     */
+    constexpr T min() const
+    {
+        return reduce_([](T x, T y) { return y < x ? y : x; });
+    }
+
+    /**
+     * @brief Maximum of lanes.
+     */
+    constexpr T max() const
+    {
+        return reduce_([](T x, T y) { return x < y ? y : x; });
+    }
+
+    /**@}*/
+
+public:
+
+    /**
+     * @name Increment operators
+     */
+    /**@{*/
+
+    /**
+     * @brief Lanewise pre-increment.
+     */
+    constexpr simd& operator++()
+    {
+        for (T& val : v_) { ++val; } return *this;
+    }
+
+    /**
+     * @brief Lanewise pre-decrement.
+     */
+    constexpr simd& operator--()
+    {
+        for (T& val : v_) { --val; } return *this;
+    }
+
+    /**
+     * @brief Lanewise post-increment.
+     */
+    constexpr simd operator++(int)
+    {
+        simd tmp = *this; operator++(); return tmp;
+    }
+
+    /**
+     * @brief Lanewise post-decrement.
+     */
+    constexpr simd operator--(int)
+    {
+        simd tmp = *this; operator--(); return tmp;
+    }
+
+    /**@}*/
+
+public:
+
+    /**
+     * @brief Write into `std::basic_ostream`.
+     *
+     * Format is `<v0,v1,...>`.
+     */
+    template <typename C, typename Ctraits>
+    friend
+    inline std::basic_ostream<C, Ctraits>& operator<<(
+           std::basic_ostream<C, Ctraits>& os, const simd& x)
+    {
+        os << '<';
+        for (size_type k = 0; k < W; k++) {
+            if (k > 0) {
+                os << ',';
+            }
+            os << x[k];
+        }
+        os << '>';
+        return os;
+    }
+
+private:
+
+    /**
+     * @brief Lanes.
+     */
+    alignas(sizeof(T) * W) T v_[W] = {};
+
+    /**
+     * @brief Pairwise reduction, halving the width at each step.
+     */
+    template <typename F>
+    __attribute__((always_inline))
+    constexpr T reduce_(F&& func) const
+    {
+        T tmp[W] = {};
+        for (size_type k = 0; k < W; k++) {
+            tmp[k] = v_[k];
+        }
+        for (size_type n = W / 2; n > 0; n /= 2) {
+            for (size_type k = 0; k < n; k++) {
+                tmp[k] = std::forward<F>(func)(tmp[k], tmp[k + n]);
+            }
+        }
+        return tmp[0];
+    }
+};
+
+/**@}*/
+
+} // namespace pre
+
+#if !DOXYGEN
+#include "simd.inl"
+#endif // #if !DOXYGEN
+
+namespace pre {
+
+/**
+ * @addtogroup simd
+ */
+/**@{*/
+
+/**
+ * @name Blending
+ */
+/**@{*/
+
+/**
+ * @brief Select lanes, @f$ m_k\,?\,x_k : y_k @f$.
+ *
+ * This is the branch-free replacement for `if` in code which
+ * should run on both scalars and packets.
+ *
+ * @note
+ * Blends bits rather than evaluating `m_k ? x_k : y_k`, as the
+ * conditional expression tempts the compiler into branching per
+ * lane once the expression no longer fits in registers.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline simd<T, W> select(
+                const simd_mask<T, W>& m,
+                const simd<T, W>& x,
+                const simd<T, W>& y)
+{
+    typedef typename simd_mask<T, W>::lane_type lane_type;
+    simd<T, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        lane_type xk;
+        lane_type yk;
+        std::memcpy(&xk, &x[k], sizeof(T));
+        std::memcpy(&yk, &y[k], sizeof(T));
+        lane_type resk = (xk & m.lane(k)) | (yk & ~m.lane(k));
+        std::memcpy(&res[k], &resk, sizeof(T));
+    }
+    return res;
+}
+
+/**
+ * @brief Select, scalar variant, @f$ m\,?\,x : y @f$.
+ */
+template <typename T>
+__attribute__((always_inline))
+constexpr std::enable_if_t<!is_simd<T>::value, T> select(
+                bool m, const T& x, const T& y)
+{
+    return m ? x : y;
+}
+
+/**
+ * @brief Any lanes true?
+ */
+template <typename T, std::size_t W>
+constexpr bool any(const simd_mask<T, W>& m)
+{
+    return m.any();
+}
+
+/**
+ * @brief All lanes true?
+ */
+template <typename T, std::size_t W>
+constexpr bool all(const simd_mask<T, W>& m)
+{
+    return m.all();
+}
+
+/**
+ * @brief No lanes true?
+ */
+template <typename T, std::size_t W>
+constexpr bool none(const simd_mask<T, W>& m)
+{
+    return m.none();
+}
+
+/**
+ * @brief Any true, scalar variant.
+ */
+constexpr bool any(bool m)
+{
+    return m;
+}
+
+/**
+ * @brief All true, scalar variant.
+ */
+constexpr bool all(bool m)
+{
+    return m;
+}
+
+/**
+ * @brief None true, scalar variant.
+ */
+constexpr bool none(bool m)
+{
+    return !m;
+}
+
+/**@}*/
+
+/**
+ * @name Math functions (simd)
+ *
+ * Hand-written where the generic lane loop would not vectorize,
+ * e.g., because of `errno` or a library call.
+ */
+/**@{*/
+
+#if !DOXYGEN
+
+// Square root of n floats or doubles at aligned pointers.
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline void simd_sqrt_(const T* x, T* res)
+{
+    std::size_t k = 0;
+    if constexpr (std::is_same<T, float>::value) {
+#if defined(__AVX512F__)
+        for (; k + 16 <= W; k += 16) {
+            _mm512_store_ps(res + k, _mm512_sqrt_ps(_mm512_load_ps(x + k)));
+        }
+#endif // #if defined(__AVX512F__)
+#if defined(__AVX__)
+        for (; k + 8 <= W; k += 8) {
+            _mm256_store_ps(res + k, _mm256_sqrt_ps(_mm256_load_ps(x + k)));
+        }
+#endif // #if defined(__AVX__)
+#if defined(__SSE2__)
+        for (; k + 4 <= W; k += 4) {
+            _mm_store_ps(res + k, _mm_sqrt_ps(_mm_load_ps(x + k)));
+        }
+#endif // #if defined(__SSE2__)
+    }
+    else if constexpr (std::is_same<T, double>::value) {
+#if defined(__AVX512F__)
+        for (; k + 8 <= W; k += 8) {
+            _mm512_store_pd(res + k, _mm512_sqrt_pd(_mm512_load_pd(x + k)));
+        }
+#endif // #if defined(__AVX512F__)
+#if defined(__AVX__)
+        for (; k + 4 <= W; k += 4) {
+            _mm256_store_pd(res + k, _mm256_sqrt_pd(_mm256_load_pd(x + k)));
+        }
+#endif // #if defined(__AVX__)
+#if defined(__SSE2__)
+        for (; k + 2 <= W; k += 2) {
+            _mm_store_pd(res + k, _mm_sqrt_pd(_mm_load_pd(x + k)));
+        }
+#endif // #if defined(__SSE2__)
+    }
+    for (; k < W; k++) {
+        res[k] = pre::sqrt(x[k]);
+    }
+}
+
+#endif // #if !DOXYGEN
+
+/**
+ * @brief Square root.
+ *
+ * @note
+ * The lane loop over `std::sqrt()` does not vectorize unless
+ * compiling with `-fno-math-errno`, so this uses intrinsics
+ * where available.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline simd<decltype(pre::sqrt(T())), W> sqrt(const simd<T, W>& x)
+{
+    if constexpr (std::is_floating_point<T>::value) {
+        simd<T, W> res;
+        simd_sqrt_<T, W>(x.data(), res.data());
+        return res;
+    }
+    else {
+        simd<decltype(pre::sqrt(T())), W> res;
+        for (std::size_t k = 0; k < W; k++) {
+            res[k] = pre::sqrt(x[k]);
+        }
+        return res;
+    }
+}
+
+/**
+ * @brief Minimum, @f$ y_k < x_k\,?\,y_k : x_k @f$.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+constexpr simd<T, W> min(const simd<T, W>& x, const simd<T, W>& y)
+{
+    simd<T, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = y[k] < x[k] ? y[k] : x[k];
+    }
+    return res;
+}
+
+/**
+ * @brief Maximum, @f$ x_k < y_k\,?\,y_k : x_k @f$.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+constexpr simd<T, W> max(const simd<T, W>& x, const simd<T, W>& y)
+{
+    simd<T, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = x[k] < y[k] ? y[k] : x[k];
+    }
+    return res;
+}
+
+/**
+ * @brief Floating point minimum, ignoring NaN as `std::fmin()` does.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+constexpr simd<T, W> fmin(const simd<T, W>& x, const simd<T, W>& y)
+{
+    simd<T, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = x[k] < y[k] || y[k] != y[k] ? x[k] : y[k];
+    }
+    return res;
+}
+
+/**
+ * @brief Floating point maximum, ignoring NaN as `std::fmax()` does.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+constexpr simd<T, W> fmax(const simd<T, W>& x, const simd<T, W>& y)
+{
+    simd<T, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = x[k] > y[k] || y[k] != y[k] ? x[k] : y[k];
+    }
+    return res;
+}
+
+/**
+ * @brief Sign bit set?
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline simd_mask<T, W> signbit(const simd<T, W>& x)
+{
+    simd_mask<T, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res.set(k, std::signbit(x[k]));
+    }
+    return res;
+}
+
+/**
+ * @brief Is NaN?
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+constexpr simd_mask<T, W> isnan(const simd<T, W>& x)
+{
+    return x != x;
+}
+
+/**
+ * @brief Is Inf?
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+constexpr simd_mask<T, W> isinf(const simd<T, W>& x)
+{
+    return pre::fabs(x) == simd<T, W>(pre::numeric_limits<T>::infinity());
+}
+
+/**
+ * @brief Is finite?
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+constexpr simd_mask<T, W> isfinite(const simd<T, W>& x)
+{
+    return pre::fabs(x) <= simd<T, W>(pre::numeric_limits<T>::max());
+}
+
+/**
+ * @brief Is normal?
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+constexpr simd_mask<T, W> isnormal(const simd<T, W>& x)
+{
+    simd<T, W> a = pre::fabs(x);
+    return a >= simd<T, W>(pre::numeric_limits<T>::min()) &&
+           a <= simd<T, W>(pre::numeric_limits<T>::max());
+}
+
+/**@}*/
+
+/**@}*/
+
+} // namespace pre
+
+#endif // #ifndef PREFORM_SIMD_HPP
@@ -0,0 +1,2380 @@
+/* Copyright (c) 2018-20 M. Grady Saunders
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *   1. Redistributions of source code must retain the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer.
+ * 
+ *   2. Redistributions in binary form must reproduce the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer in the documentation and/or other materials
+ *      provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*+-+*/
+// A ruby script generates this file, DO NOT EDIT
+
+namespace pre {
+
+/**
+ * @addtogroup simd
+ */
+/**@{*/
+
+/**
+ * @name Unary operators (simd)
+ */
+/**@{*/
+
+/**
+ * @brief Lanewise `operator+`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+constexpr simd<decltype(+T()), W> operator+(const simd<T, W>& x)
+{
+    simd<decltype(+T()), W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = +x[k];
+    }
+    return res;
+}
+
+/**
+ * @brief Lanewise `operator-`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+constexpr simd<decltype(-T()), W> operator-(const simd<T, W>& x)
+{
+    simd<decltype(-T()), W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = -x[k];
+    }
+    return res;
+}
+
+/**
+ * @brief Lanewise `operator~`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+constexpr simd<decltype(~T()), W> operator~(const simd<T, W>& x)
+{
+    simd<decltype(~T()), W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = ~x[k];
+    }
+    return res;
+}
+
+/**@}*/
+
+/**
+ * @name Binary operators (simd/simd)
+ */
+/**@{*/
+
+/**
+ * @brief Lanewise `operator+`.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr simd<std::common_type_t<T, U>, W> operator+(
+                    const simd<T, W>& x,
+                    const simd<U, W>& y)
+{
+    simd<std::common_type_t<T, U>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = x[k] + y[k];
+    }
+    return res;
+}
+
+/**
+ * @brief Lanewise `operator-`.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr simd<std::common_type_t<T, U>, W> operator-(
+                    const simd<T, W>& x,
+                    const simd<U, W>& y)
+{
+    simd<std::common_type_t<T, U>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = x[k] - y[k];
+    }
+    return res;
+}
+
+/**
+ * @brief Lanewise `operator*`.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr simd<std::common_type_t<T, U>, W> operator*(
+                    const simd<T, W>& x,
+                    const simd<U, W>& y)
+{
+    simd<std::common_type_t<T, U>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = x[k] * y[k];
+    }
+    return res;
+}
+
+/**
+ * @brief Lanewise `operator/`.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr simd<std::common_type_t<T, U>, W> operator/(
+                    const simd<T, W>& x,
+                    const simd<U, W>& y)
+{
+    simd<std::common_type_t<T, U>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = x[k] / y[k];
+    }
+    return res;
+}
+
+/**
+ * @brief Lanewise `operator%`.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr simd<std::common_type_t<T, U>, W> operator%(
+                    const simd<T, W>& x,
+                    const simd<U, W>& y)
+{
+    simd<std::common_type_t<T, U>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = x[k] % y[k];
+    }
+    return res;
+}
+
+/**
+ * @brief Lanewise `operator&`.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr simd<std::common_type_t<T, U>, W> operator&(
+                    const simd<T, W>& x,
+                    const simd<U, W>& y)
+{
+    simd<std::common_type_t<T, U>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = x[k] & y[k];
+    }
+    return res;
+}
+
+/**
+ * @brief Lanewise `operator|`.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr simd<std::common_type_t<T, U>, W> operator|(
+                    const simd<T, W>& x,
+                    const simd<U, W>& y)
+{
+    simd<std::common_type_t<T, U>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = x[k] | y[k];
+    }
+    return res;
+}
+
+/**
+ * @brief Lanewise `operator^`.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr simd<std::common_type_t<T, U>, W> operator^(
+                    const simd<T, W>& x,
+                    const simd<U, W>& y)
+{
+    simd<std::common_type_t<T, U>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = x[k] ^ y[k];
+    }
+    return res;
+}
+
+/**
+ * @brief Lanewise `operator>>`.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr simd<std::common_type_t<T, U>, W> operator>>(
+                    const simd<T, W>& x,
+                    const simd<U, W>& y)
+{
+    simd<std::common_type_t<T, U>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = x[k] >> y[k];
+    }
+    return res;
+}
+
+/**
+ * @brief Lanewise `operator<<`.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr simd<std::common_type_t<T, U>, W> operator<<(
+                    const simd<T, W>& x,
+                    const simd<U, W>& y)
+{
+    simd<std::common_type_t<T, U>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = x[k] << y[k];
+    }
+    return res;
+}
+
+/**
+ * @brief Lanewise `operator+=`.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr simd<T, W>& operator+=(simd<T, W>& x, const simd<U, W>& y)
+{
+    for (std::size_t k = 0; k < W; k++) {
+        x[k] += y[k];
+    }
+    return x;
+}
+
+/**
+ * @brief Lanewise `operator-=`.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr simd<T, W>& operator-=(simd<T, W>& x, const simd<U, W>& y)
+{
+    for (std::size_t k = 0; k < W; k++) {
+        x[k] -= y[k];
+    }
+    return x;
+}
+
+/**
+ * @brief Lanewise `operator*=`.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr simd<T, W>& operator*=(simd<T, W>& x, const simd<U, W>& y)
+{
+    for (std::size_t k = 0; k < W; k++) {
+        x[k] *= y[k];
+    }
+    return x;
+}
+
+/**
+ * @brief Lanewise `operator/=`.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr simd<T, W>& operator/=(simd<T, W>& x, const simd<U, W>& y)
+{
+    for (std::size_t k = 0; k < W; k++) {
+        x[k] /= y[k];
+    }
+    return x;
+}
+
+/**
+ * @brief Lanewise `operator%=`.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr simd<T, W>& operator%=(simd<T, W>& x, const simd<U, W>& y)
+{
+    for (std::size_t k = 0; k < W; k++) {
+        x[k] %= y[k];
+    }
+    return x;
+}
+
+/**
+ * @brief Lanewise `operator&=`.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr simd<T, W>& operator&=(simd<T, W>& x, const simd<U, W>& y)
+{
+    for (std::size_t k = 0; k < W; k++) {
+        x[k] &= y[k];
+    }
+    return x;
+}
+
+/**
+ * @brief Lanewise `operator|=`.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr simd<T, W>& operator|=(simd<T, W>& x, const simd<U, W>& y)
+{
+    for (std::size_t k = 0; k < W; k++) {
+        x[k] |= y[k];
+    }
+    return x;
+}
+
+/**
+ * @brief Lanewise `operator^=`.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr simd<T, W>& operator^=(simd<T, W>& x, const simd<U, W>& y)
+{
+    for (std::size_t k = 0; k < W; k++) {
+        x[k] ^= y[k];
+    }
+    return x;
+}
+
+/**
+ * @brief Lanewise `operator>>=`.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr simd<T, W>& operator>>=(simd<T, W>& x, const simd<U, W>& y)
+{
+    for (std::size_t k = 0; k < W; k++) {
+        x[k] >>= y[k];
+    }
+    return x;
+}
+
+/**
+ * @brief Lanewise `operator<<=`.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr simd<T, W>& operator<<=(simd<T, W>& x, const simd<U, W>& y)
+{
+    for (std::size_t k = 0; k < W; k++) {
+        x[k] <<= y[k];
+    }
+    return x;
+}
+
+/**
+ * @brief Lanewise `operator==`.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr simd_mask<std::common_type_t<T, U>, W> operator==(
+                    const simd<T, W>& x,
+                    const simd<U, W>& y)
+{
+    simd_mask<std::common_type_t<T, U>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res.set(k, x[k] == y[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Lanewise `operator!=`.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr simd_mask<std::common_type_t<T, U>, W> operator!=(
+                    const simd<T, W>& x,
+                    const simd<U, W>& y)
+{
+    simd_mask<std::common_type_t<T, U>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res.set(k, x[k] != y[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Lanewise `operator<`.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr simd_mask<std::common_type_t<T, U>, W> operator<(
+                    const simd<T, W>& x,
+                    const simd<U, W>& y)
+{
+    simd_mask<std::common_type_t<T, U>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res.set(k, x[k] < y[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Lanewise `operator>`.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr simd_mask<std::common_type_t<T, U>, W> operator>(
+                    const simd<T, W>& x,
+                    const simd<U, W>& y)
+{
+    simd_mask<std::common_type_t<T, U>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res.set(k, x[k] > y[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Lanewise `operator<=`.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr simd_mask<std::common_type_t<T, U>, W> operator<=(
+                    const simd<T, W>& x,
+                    const simd<U, W>& y)
+{
+    simd_mask<std::common_type_t<T, U>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res.set(k, x[k] <= y[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Lanewise `operator>=`.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr simd_mask<std::common_type_t<T, U>, W> operator>=(
+                    const simd<T, W>& x,
+                    const simd<U, W>& y)
+{
+    simd_mask<std::common_type_t<T, U>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res.set(k, x[k] >= y[k]);
+    }
+    return res;
+}
+
+/**@}*/
+
+/**
+ * @name Binary operators (simd/entry)
+ */
+/**@{*/
+
+/**
+ * @brief Lanewise `operator+`, broadcasting entry.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr std::enable_if_t<std::is_arithmetic<U>::value,
+    simd<std::common_type_t<T, U>, W>> operator+(
+                        const simd<T, W>& x, const U& y)
+{
+    simd<std::common_type_t<T, U>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = x[k] + y;
+    }
+    return res;
+}
+
+/**
+ * @brief Lanewise `operator-`, broadcasting entry.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr std::enable_if_t<std::is_arithmetic<U>::value,
+    simd<std::common_type_t<T, U>, W>> operator-(
+                        const simd<T, W>& x, const U& y)
+{
+    simd<std::common_type_t<T, U>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = x[k] - y;
+    }
+    return res;
+}
+
+/**
+ * @brief Lanewise `operator*`, broadcasting entry.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr std::enable_if_t<std::is_arithmetic<U>::value,
+    simd<std::common_type_t<T, U>, W>> operator*(
+                        const simd<T, W>& x, const U& y)
+{
+    simd<std::common_type_t<T, U>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = x[k] * y;
+    }
+    return res;
+}
+
+/**
+ * @brief Lanewise `operator/`, broadcasting entry.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr std::enable_if_t<std::is_arithmetic<U>::value,
+    simd<std::common_type_t<T, U>, W>> operator/(
+                        const simd<T, W>& x, const U& y)
+{
+    simd<std::common_type_t<T, U>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = x[k] / y;
+    }
+    return res;
+}
+
+/**
+ * @brief Lanewise `operator%`, broadcasting entry.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr std::enable_if_t<std::is_arithmetic<U>::value,
+    simd<std::common_type_t<T, U>, W>> operator%(
+                        const simd<T, W>& x, const U& y)
+{
+    simd<std::common_type_t<T, U>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = x[k] % y;
+    }
+    return res;
+}
+
+/**
+ * @brief Lanewise `operator&`, broadcasting entry.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr std::enable_if_t<std::is_arithmetic<U>::value,
+    simd<std::common_type_t<T, U>, W>> operator&(
+                        const simd<T, W>& x, const U& y)
+{
+    simd<std::common_type_t<T, U>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = x[k] & y;
+    }
+    return res;
+}
+
+/**
+ * @brief Lanewise `operator|`, broadcasting entry.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr std::enable_if_t<std::is_arithmetic<U>::value,
+    simd<std::common_type_t<T, U>, W>> operator|(
+                        const simd<T, W>& x, const U& y)
+{
+    simd<std::common_type_t<T, U>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = x[k] | y;
+    }
+    return res;
+}
+
+/**
+ * @brief Lanewise `operator^`, broadcasting entry.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr std::enable_if_t<std::is_arithmetic<U>::value,
+    simd<std::common_type_t<T, U>, W>> operator^(
+                        const simd<T, W>& x, const U& y)
+{
+    simd<std::common_type_t<T, U>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = x[k] ^ y;
+    }
+    return res;
+}
+
+/**
+ * @brief Lanewise `operator>>`, broadcasting entry.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr std::enable_if_t<std::is_arithmetic<U>::value,
+    simd<std::common_type_t<T, U>, W>> operator>>(
+                        const simd<T, W>& x, const U& y)
+{
+    simd<std::common_type_t<T, U>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = x[k] >> y;
+    }
+    return res;
+}
+
+/**
+ * @brief Lanewise `operator<<`, broadcasting entry.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr std::enable_if_t<std::is_arithmetic<U>::value,
+    simd<std::common_type_t<T, U>, W>> operator<<(
+                        const simd<T, W>& x, const U& y)
+{
+    simd<std::common_type_t<T, U>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = x[k] << y;
+    }
+    return res;
+}
+
+/**
+ * @brief Lanewise `operator+=`, broadcasting entry.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr std::enable_if_t<std::is_arithmetic<U>::value,
+    simd<T, W>&> operator+=(simd<T, W>& x, const U& y)
+{
+    for (std::size_t k = 0; k < W; k++) {
+        x[k] += y;
+    }
+    return x;
+}
+
+/**
+ * @brief Lanewise `operator-=`, broadcasting entry.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr std::enable_if_t<std::is_arithmetic<U>::value,
+    simd<T, W>&> operator-=(simd<T, W>& x, const U& y)
+{
+    for (std::size_t k = 0; k < W; k++) {
+        x[k] -= y;
+    }
+    return x;
+}
+
+/**
+ * @brief Lanewise `operator*=`, broadcasting entry.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr std::enable_if_t<std::is_arithmetic<U>::value,
+    simd<T, W>&> operator*=(simd<T, W>& x, const U& y)
+{
+    for (std::size_t k = 0; k < W; k++) {
+        x[k] *= y;
+    }
+    return x;
+}
+
+/**
+ * @brief Lanewise `operator/=`, broadcasting entry.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr std::enable_if_t<std::is_arithmetic<U>::value,
+    simd<T, W>&> operator/=(simd<T, W>& x, const U& y)
+{
+    for (std::size_t k = 0; k < W; k++) {
+        x[k] /= y;
+    }
+    return x;
+}
+
+/**
+ * @brief Lanewise `operator%=`, broadcasting entry.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr std::enable_if_t<std::is_arithmetic<U>::value,
+    simd<T, W>&> operator%=(simd<T, W>& x, const U& y)
+{
+    for (std::size_t k = 0; k < W; k++) {
+        x[k] %= y;
+    }
+    return x;
+}
+
+/**
+ * @brief Lanewise `operator&=`, broadcasting entry.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr std::enable_if_t<std::is_arithmetic<U>::value,
+    simd<T, W>&> operator&=(simd<T, W>& x, const U& y)
+{
+    for (std::size_t k = 0; k < W; k++) {
+        x[k] &= y;
+    }
+    return x;
+}
+
+/**
+ * @brief Lanewise `operator|=`, broadcasting entry.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr std::enable_if_t<std::is_arithmetic<U>::value,
+    simd<T, W>&> operator|=(simd<T, W>& x, const U& y)
+{
+    for (std::size_t k = 0; k < W; k++) {
+        x[k] |= y;
+    }
+    return x;
+}
+
+/**
+ * @brief Lanewise `operator^=`, broadcasting entry.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr std::enable_if_t<std::is_arithmetic<U>::value,
+    simd<T, W>&> operator^=(simd<T, W>& x, const U& y)
+{
+    for (std::size_t k = 0; k < W; k++) {
+        x[k] ^= y;
+    }
+    return x;
+}
+
+/**
+ * @brief Lanewise `operator>>=`, broadcasting entry.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr std::enable_if_t<std::is_arithmetic<U>::value,
+    simd<T, W>&> operator>>=(simd<T, W>& x, const U& y)
+{
+    for (std::size_t k = 0; k < W; k++) {
+        x[k] >>= y;
+    }
+    return x;
+}
+
+/**
+ * @brief Lanewise `operator<<=`, broadcasting entry.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr std::enable_if_t<std::is_arithmetic<U>::value,
+    simd<T, W>&> operator<<=(simd<T, W>& x, const U& y)
+{
+    for (std::size_t k = 0; k < W; k++) {
+        x[k] <<= y;
+    }
+    return x;
+}
+
+/**
+ * @brief Lanewise `operator==`, broadcasting entry.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr std::enable_if_t<std::is_arithmetic<U>::value,
+    simd_mask<std::common_type_t<T, U>, W>> operator==(
+                        const simd<T, W>& x, const U& y)
+{
+    simd_mask<std::common_type_t<T, U>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res.set(k, x[k] == y);
+    }
+    return res;
+}
+
+/**
+ * @brief Lanewise `operator!=`, broadcasting entry.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr std::enable_if_t<std::is_arithmetic<U>::value,
+    simd_mask<std::common_type_t<T, U>, W>> operator!=(
+                        const simd<T, W>& x, const U& y)
+{
+    simd_mask<std::common_type_t<T, U>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res.set(k, x[k] != y);
+    }
+    return res;
+}
+
+/**
+ * @brief Lanewise `operator<`, broadcasting entry.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr std::enable_if_t<std::is_arithmetic<U>::value,
+    simd_mask<std::common_type_t<T, U>, W>> operator<(
+                        const simd<T, W>& x, const U& y)
+{
+    simd_mask<std::common_type_t<T, U>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res.set(k, x[k] < y);
+    }
+    return res;
+}
+
+/**
+ * @brief Lanewise `operator>`, broadcasting entry.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr std::enable_if_t<std::is_arithmetic<U>::value,
+    simd_mask<std::common_type_t<T, U>, W>> operator>(
+                        const simd<T, W>& x, const U& y)
+{
+    simd_mask<std::common_type_t<T, U>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res.set(k, x[k] > y);
+    }
+    return res;
+}
+
+/**
+ * @brief Lanewise `operator<=`, broadcasting entry.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr std::enable_if_t<std::is_arithmetic<U>::value,
+    simd_mask<std::common_type_t<T, U>, W>> operator<=(
+                        const simd<T, W>& x, const U& y)
+{
+    simd_mask<std::common_type_t<T, U>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res.set(k, x[k] <= y);
+    }
+    return res;
+}
+
+/**
+ * @brief Lanewise `operator>=`, broadcasting entry.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr std::enable_if_t<std::is_arithmetic<U>::value,
+    simd_mask<std::common_type_t<T, U>, W>> operator>=(
+                        const simd<T, W>& x, const U& y)
+{
+    simd_mask<std::common_type_t<T, U>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res.set(k, x[k] >= y);
+    }
+    return res;
+}
+
+/**@}*/
+
+/**
+ * @name Binary operators (entry/simd)
+ */
+/**@{*/
+
+/**
+ * @brief Lanewise `operator+`, broadcasting entry.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr std::enable_if_t<std::is_arithmetic<T>::value,
+    simd<std::common_type_t<T, U>, W>> operator+(
+                        const T& x, const simd<U, W>& y)
+{
+    simd<std::common_type_t<T, U>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = x + y[k];
+    }
+    return res;
+}
+
+/**
+ * @brief Lanewise `operator-`, broadcasting entry.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr std::enable_if_t<std::is_arithmetic<T>::value,
+    simd<std::common_type_t<T, U>, W>> operator-(
+                        const T& x, const simd<U, W>& y)
+{
+    simd<std::common_type_t<T, U>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = x - y[k];
+    }
+    return res;
+}
+
+/**
+ * @brief Lanewise `operator*`, broadcasting entry.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr std::enable_if_t<std::is_arithmetic<T>::value,
+    simd<std::common_type_t<T, U>, W>> operator*(
+                        const T& x, const simd<U, W>& y)
+{
+    simd<std::common_type_t<T, U>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = x * y[k];
+    }
+    return res;
+}
+
+/**
+ * @brief Lanewise `operator/`, broadcasting entry.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr std::enable_if_t<std::is_arithmetic<T>::value,
+    simd<std::common_type_t<T, U>, W>> operator/(
+                        const T& x, const simd<U, W>& y)
+{
+    simd<std::common_type_t<T, U>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = x / y[k];
+    }
+    return res;
+}
+
+/**
+ * @brief Lanewise `operator%`, broadcasting entry.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr std::enable_if_t<std::is_arithmetic<T>::value,
+    simd<std::common_type_t<T, U>, W>> operator%(
+                        const T& x, const simd<U, W>& y)
+{
+    simd<std::common_type_t<T, U>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = x % y[k];
+    }
+    return res;
+}
+
+/**
+ * @brief Lanewise `operator&`, broadcasting entry.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr std::enable_if_t<std::is_arithmetic<T>::value,
+    simd<std::common_type_t<T, U>, W>> operator&(
+                        const T& x, const simd<U, W>& y)
+{
+    simd<std::common_type_t<T, U>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = x & y[k];
+    }
+    return res;
+}
+
+/**
+ * @brief Lanewise `operator|`, broadcasting entry.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr std::enable_if_t<std::is_arithmetic<T>::value,
+    simd<std::common_type_t<T, U>, W>> operator|(
+                        const T& x, const simd<U, W>& y)
+{
+    simd<std::common_type_t<T, U>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = x | y[k];
+    }
+    return res;
+}
+
+/**
+ * @brief Lanewise `operator^`, broadcasting entry.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr std::enable_if_t<std::is_arithmetic<T>::value,
+    simd<std::common_type_t<T, U>, W>> operator^(
+                        const T& x, const simd<U, W>& y)
+{
+    simd<std::common_type_t<T, U>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = x ^ y[k];
+    }
+    return res;
+}
+
+/**
+ * @brief Lanewise `operator>>`, broadcasting entry.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr std::enable_if_t<std::is_arithmetic<T>::value,
+    simd<std::common_type_t<T, U>, W>> operator>>(
+                        const T& x, const simd<U, W>& y)
+{
+    simd<std::common_type_t<T, U>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = x >> y[k];
+    }
+    return res;
+}
+
+/**
+ * @brief Lanewise `operator<<`, broadcasting entry.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr std::enable_if_t<std::is_arithmetic<T>::value,
+    simd<std::common_type_t<T, U>, W>> operator<<(
+                        const T& x, const simd<U, W>& y)
+{
+    simd<std::common_type_t<T, U>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = x << y[k];
+    }
+    return res;
+}
+
+/**
+ * @brief Lanewise `operator==`, broadcasting entry.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr std::enable_if_t<std::is_arithmetic<T>::value,
+    simd_mask<std::common_type_t<T, U>, W>> operator==(
+                        const T& x, const simd<U, W>& y)
+{
+    simd_mask<std::common_type_t<T, U>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res.set(k, x == y[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Lanewise `operator!=`, broadcasting entry.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr std::enable_if_t<std::is_arithmetic<T>::value,
+    simd_mask<std::common_type_t<T, U>, W>> operator!=(
+                        const T& x, const simd<U, W>& y)
+{
+    simd_mask<std::common_type_t<T, U>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res.set(k, x != y[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Lanewise `operator<`, broadcasting entry.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr std::enable_if_t<std::is_arithmetic<T>::value,
+    simd_mask<std::common_type_t<T, U>, W>> operator<(
+                        const T& x, const simd<U, W>& y)
+{
+    simd_mask<std::common_type_t<T, U>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res.set(k, x < y[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Lanewise `operator>`, broadcasting entry.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr std::enable_if_t<std::is_arithmetic<T>::value,
+    simd_mask<std::common_type_t<T, U>, W>> operator>(
+                        const T& x, const simd<U, W>& y)
+{
+    simd_mask<std::common_type_t<T, U>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res.set(k, x > y[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Lanewise `operator<=`, broadcasting entry.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr std::enable_if_t<std::is_arithmetic<T>::value,
+    simd_mask<std::common_type_t<T, U>, W>> operator<=(
+                        const T& x, const simd<U, W>& y)
+{
+    simd_mask<std::common_type_t<T, U>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res.set(k, x <= y[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Lanewise `operator>=`, broadcasting entry.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr std::enable_if_t<std::is_arithmetic<T>::value,
+    simd_mask<std::common_type_t<T, U>, W>> operator>=(
+                        const T& x, const simd<U, W>& y)
+{
+    simd_mask<std::common_type_t<T, U>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res.set(k, x >= y[k]);
+    }
+    return res;
+}
+
+/**@}*/
+
+/**
+ * @name Math wrappers (simd)
+ */
+/**@{*/
+
+/**
+ * @brief Wrap `pre::abs()`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline auto abs(
+            const simd<T, W>& x)
+{
+    simd<
+        std::decay_t<decltype(pre::abs(
+        std::declval<T>()))>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = pre::abs(x[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Wrap `pre::arg()`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline auto arg(
+            const simd<T, W>& x)
+{
+    simd<
+        std::decay_t<decltype(pre::arg(
+        std::declval<T>()))>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = pre::arg(x[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Wrap `pre::real()`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline auto real(
+            const simd<T, W>& x)
+{
+    simd<
+        std::decay_t<decltype(pre::real(
+        std::declval<T>()))>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = pre::real(x[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Wrap `pre::imag()`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline auto imag(
+            const simd<T, W>& x)
+{
+    simd<
+        std::decay_t<decltype(pre::imag(
+        std::declval<T>()))>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = pre::imag(x[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Wrap `pre::conj()`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline auto conj(
+            const simd<T, W>& x)
+{
+    simd<
+        std::decay_t<decltype(pre::conj(
+        std::declval<T>()))>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = pre::conj(x[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Wrap `pre::norm()`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline auto norm(
+            const simd<T, W>& x)
+{
+    simd<
+        std::decay_t<decltype(pre::norm(
+        std::declval<T>()))>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = pre::norm(x[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Wrap `pre::fabs()`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline auto fabs(
+            const simd<T, W>& x)
+{
+    simd<
+        std::decay_t<decltype(pre::fabs(
+        std::declval<T>()))>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = pre::fabs(x[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Wrap `pre::fma()`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline auto fma(
+            const simd<T, W>& x,
+            const simd<T, W>& y,
+            const simd<T, W>& z)
+{
+    simd<
+        std::decay_t<decltype(pre::fma(
+        std::declval<T>(),
+        std::declval<T>(),
+        std::declval<T>()))>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = pre::fma(x[k], y[k], z[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Wrap `pre::fdim()`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline auto fdim(
+            const simd<T, W>& x,
+            const simd<T, W>& y)
+{
+    simd<
+        std::decay_t<decltype(pre::fdim(
+        std::declval<T>(),
+        std::declval<T>()))>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = pre::fdim(x[k], y[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Wrap `pre::fmod()`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline auto fmod(
+            const simd<T, W>& x,
+            const simd<T, W>& y)
+{
+    simd<
+        std::decay_t<decltype(pre::fmod(
+        std::declval<T>(),
+        std::declval<T>()))>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = pre::fmod(x[k], y[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Wrap `pre::remquo()`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline auto remquo(
+            const simd<T, W>& x,
+            const simd<T, W>& y,
+            simd<int, W>* q)
+{
+    simd<
+        std::decay_t<decltype(pre::remquo(
+        std::declval<T>(),
+        std::declval<T>(),
+        std::declval<int*>()))>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = pre::remquo(x[k], y[k], &(*q)[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Wrap `pre::remainder()`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline auto remainder(
+            const simd<T, W>& x,
+            const simd<T, W>& y)
+{
+    simd<
+        std::decay_t<decltype(pre::remainder(
+        std::declval<T>(),
+        std::declval<T>()))>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = pre::remainder(x[k], y[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Wrap `pre::nearbyint()`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline auto nearbyint(
+            const simd<T, W>& x)
+{
+    simd<
+        std::decay_t<decltype(pre::nearbyint(
+        std::declval<T>()))>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = pre::nearbyint(x[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Wrap `pre::floor()`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline auto floor(
+            const simd<T, W>& x)
+{
+    simd<
+        std::decay_t<decltype(pre::floor(
+        std::declval<T>()))>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = pre::floor(x[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Wrap `pre::ceil()`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline auto ceil(
+            const simd<T, W>& x)
+{
+    simd<
+        std::decay_t<decltype(pre::ceil(
+        std::declval<T>()))>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = pre::ceil(x[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Wrap `pre::trunc()`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline auto trunc(
+            const simd<T, W>& x)
+{
+    simd<
+        std::decay_t<decltype(pre::trunc(
+        std::declval<T>()))>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = pre::trunc(x[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Wrap `pre::round()`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline auto round(
+            const simd<T, W>& x)
+{
+    simd<
+        std::decay_t<decltype(pre::round(
+        std::declval<T>()))>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = pre::round(x[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Wrap `pre::rint()`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline auto rint(
+            const simd<T, W>& x)
+{
+    simd<
+        std::decay_t<decltype(pre::rint(
+        std::declval<T>()))>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = pre::rint(x[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Wrap `pre::lrint()`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline auto lrint(
+            const simd<T, W>& x)
+{
+    simd<
+        std::decay_t<decltype(pre::lrint(
+        std::declval<T>()))>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = pre::lrint(x[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Wrap `pre::llrint()`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline auto llrint(
+            const simd<T, W>& x)
+{
+    simd<
+        std::decay_t<decltype(pre::llrint(
+        std::declval<T>()))>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = pre::llrint(x[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Wrap `pre::lround()`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline auto lround(
+            const simd<T, W>& x)
+{
+    simd<
+        std::decay_t<decltype(pre::lround(
+        std::declval<T>()))>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = pre::lround(x[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Wrap `pre::llround()`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline auto llround(
+            const simd<T, W>& x)
+{
+    simd<
+        std::decay_t<decltype(pre::llround(
+        std::declval<T>()))>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = pre::llround(x[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Wrap `pre::frexp()`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline auto frexp(
+            const simd<T, W>& x,
+            simd<int, W>* p)
+{
+    simd<
+        std::decay_t<decltype(pre::frexp(
+        std::declval<T>(),
+        std::declval<int*>()))>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = pre::frexp(x[k], &(*p)[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Wrap `pre::ldexp()`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline auto ldexp(
+            const simd<T, W>& x,
+            const simd<int, W>& p)
+{
+    simd<
+        std::decay_t<decltype(pre::ldexp(
+        std::declval<T>(),
+        std::declval<int>()))>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = pre::ldexp(x[k], p[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Wrap `pre::logb()`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline auto logb(
+            const simd<T, W>& x)
+{
+    simd<
+        std::decay_t<decltype(pre::logb(
+        std::declval<T>()))>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = pre::logb(x[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Wrap `pre::ilogb()`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline auto ilogb(
+            const simd<T, W>& x)
+{
+    simd<
+        std::decay_t<decltype(pre::ilogb(
+        std::declval<T>()))>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = pre::ilogb(x[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Wrap `pre::scalbn()`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline auto scalbn(
+            const simd<T, W>& x,
+            const simd<int, W>& p)
+{
+    simd<
+        std::decay_t<decltype(pre::scalbn(
+        std::declval<T>(),
+        std::declval<int>()))>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = pre::scalbn(x[k], p[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Wrap `pre::scalbln()`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline auto scalbln(
+            const simd<T, W>& x,
+            const simd<long, W>& p)
+{
+    simd<
+        std::decay_t<decltype(pre::scalbln(
+        std::declval<T>(),
+        std::declval<long>()))>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = pre::scalbln(x[k], p[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Wrap `pre::modf()`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline auto modf(
+            const simd<T, W>& x,
+            simd<T, W>* p)
+{
+    simd<
+        std::decay_t<decltype(pre::modf(
+        std::declval<T>(),
+        std::declval<T*>()))>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = pre::modf(x[k], &(*p)[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Wrap `pre::nextafter()`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline auto nextafter(
+            const simd<T, W>& x,
+            const simd<T, W>& y)
+{
+    simd<
+        std::decay_t<decltype(pre::nextafter(
+        std::declval<T>(),
+        std::declval<T>()))>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = pre::nextafter(x[k], y[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Wrap `pre::copysign()`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline auto copysign(
+            const simd<T, W>& x,
+            const simd<T, W>& y)
+{
+    simd<
+        std::decay_t<decltype(pre::copysign(
+        std::declval<T>(),
+        std::declval<T>()))>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = pre::copysign(x[k], y[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Wrap `pre::exp()`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline auto exp(
+            const simd<T, W>& x)
+{
+    simd<
+        std::decay_t<decltype(pre::exp(
+        std::declval<T>()))>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = pre::exp(x[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Wrap `pre::log()`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline auto log(
+            const simd<T, W>& x)
+{
+    simd<
+        std::decay_t<decltype(pre::log(
+        std::declval<T>()))>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = pre::log(x[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Wrap `pre::exp2()`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline auto exp2(
+            const simd<T, W>& x)
+{
+    simd<
+        std::decay_t<decltype(pre::exp2(
+        std::declval<T>()))>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = pre::exp2(x[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Wrap `pre::log2()`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline auto log2(
+            const simd<T, W>& x)
+{
+    simd<
+        std::decay_t<decltype(pre::log2(
+        std::declval<T>()))>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = pre::log2(x[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Wrap `pre::log10()`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline auto log10(
+            const simd<T, W>& x)
+{
+    simd<
+        std::decay_t<decltype(pre::log10(
+        std::declval<T>()))>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = pre::log10(x[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Wrap `pre::expm1()`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline auto expm1(
+            const simd<T, W>& x)
+{
+    simd<
+        std::decay_t<decltype(pre::expm1(
+        std::declval<T>()))>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = pre::expm1(x[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Wrap `pre::log1p()`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline auto log1p(
+            const simd<T, W>& x)
+{
+    simd<
+        std::decay_t<decltype(pre::log1p(
+        std::declval<T>()))>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = pre::log1p(x[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Wrap `pre::pow()`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline auto pow(
+            const simd<T, W>& x,
+            const simd<T, W>& y)
+{
+    simd<
+        std::decay_t<decltype(pre::pow(
+        std::declval<T>(),
+        std::declval<T>()))>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = pre::pow(x[k], y[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Wrap `pre::cbrt()`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline auto cbrt(
+            const simd<T, W>& x)
+{
+    simd<
+        std::decay_t<decltype(pre::cbrt(
+        std::declval<T>()))>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = pre::cbrt(x[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Wrap `pre::hypot()`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline auto hypot(
+            const simd<T, W>& x,
+            const simd<T, W>& y)
+{
+    simd<
+        std::decay_t<decltype(pre::hypot(
+        std::declval<T>(),
+        std::declval<T>()))>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = pre::hypot(x[k], y[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Wrap `pre::erf()`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline auto erf(
+            const simd<T, W>& x)
+{
+    simd<
+        std::decay_t<decltype(pre::erf(
+        std::declval<T>()))>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = pre::erf(x[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Wrap `pre::erfc()`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline auto erfc(
+            const simd<T, W>& x)
+{
+    simd<
+        std::decay_t<decltype(pre::erfc(
+        std::declval<T>()))>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = pre::erfc(x[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Wrap `pre::lgamma()`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline auto lgamma(
+            const simd<T, W>& x)
+{
+    simd<
+        std::decay_t<decltype(pre::lgamma(
+        std::declval<T>()))>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = pre::lgamma(x[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Wrap `pre::tgamma()`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline auto tgamma(
+            const simd<T, W>& x)
+{
+    simd<
+        std::decay_t<decltype(pre::tgamma(
+        std::declval<T>()))>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = pre::tgamma(x[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Wrap `pre::sin()`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline auto sin(
+            const simd<T, W>& x)
+{
+    simd<
+        std::decay_t<decltype(pre::sin(
+        std::declval<T>()))>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = pre::sin(x[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Wrap `pre::cos()`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline auto cos(
+            const simd<T, W>& x)
+{
+    simd<
+        std::decay_t<decltype(pre::cos(
+        std::declval<T>()))>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = pre::cos(x[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Wrap `pre::tan()`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline auto tan(
+            const simd<T, W>& x)
+{
+    simd<
+        std::decay_t<decltype(pre::tan(
+        std::declval<T>()))>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = pre::tan(x[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Wrap `pre::asin()`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline auto asin(
+            const simd<T, W>& x)
+{
+    simd<
+        std::decay_t<decltype(pre::asin(
+        std::declval<T>()))>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = pre::asin(x[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Wrap `pre::acos()`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline auto acos(
+            const simd<T, W>& x)
+{
+    simd<
+        std::decay_t<decltype(pre::acos(
+        std::declval<T>()))>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = pre::acos(x[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Wrap `pre::atan()`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline auto atan(
+            const simd<T, W>& x)
+{
+    simd<
+        std::decay_t<decltype(pre::atan(
+        std::declval<T>()))>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = pre::atan(x[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Wrap `pre::atan2()`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline auto atan2(
+            const simd<T, W>& y,
+            const simd<T, W>& x)
+{
+    simd<
+        std::decay_t<decltype(pre::atan2(
+        std::declval<T>(),
+        std::declval<T>()))>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = pre::atan2(y[k], x[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Wrap `pre::sinh()`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline auto sinh(
+            const simd<T, W>& x)
+{
+    simd<
+        std::decay_t<decltype(pre::sinh(
+        std::declval<T>()))>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = pre::sinh(x[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Wrap `pre::cosh()`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline auto cosh(
+            const simd<T, W>& x)
+{
+    simd<
+        std::decay_t<decltype(pre::cosh(
+        std::declval<T>()))>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = pre::cosh(x[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Wrap `pre::tanh()`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline auto tanh(
+            const simd<T, W>& x)
+{
+    simd<
+        std::decay_t<decltype(pre::tanh(
+        std::declval<T>()))>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = pre::tanh(x[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Wrap `pre::asinh()`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline auto asinh(
+            const simd<T, W>& x)
+{
+    simd<
+        std::decay_t<decltype(pre::asinh(
+        std::declval<T>()))>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = pre::asinh(x[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Wrap `pre::acosh()`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline auto acosh(
+            const simd<T, W>& x)
+{
+    simd<
+        std::decay_t<decltype(pre::acosh(
+        std::declval<T>()))>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = pre::acosh(x[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Wrap `pre::atanh()`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline auto atanh(
+            const simd<T, W>& x)
+{
+    simd<
+        std::decay_t<decltype(pre::atanh(
+        std::declval<T>()))>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = pre::atanh(x[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Wrap `pre::csc()`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline auto csc(
+            const simd<T, W>& x)
+{
+    simd<
+        std::decay_t<decltype(pre::csc(
+        std::declval<T>()))>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = pre::csc(x[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Wrap `pre::sec()`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline auto sec(
+            const simd<T, W>& x)
+{
+    simd<
+        std::decay_t<decltype(pre::sec(
+        std::declval<T>()))>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = pre::sec(x[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Wrap `pre::cot()`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline auto cot(
+            const simd<T, W>& x)
+{
+    simd<
+        std::decay_t<decltype(pre::cot(
+        std::declval<T>()))>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = pre::cot(x[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Wrap `pre::csch()`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline auto csch(
+            const simd<T, W>& x)
+{
+    simd<
+        std::decay_t<decltype(pre::csch(
+        std::declval<T>()))>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = pre::csch(x[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Wrap `pre::sech()`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline auto sech(
+            const simd<T, W>& x)
+{
+    simd<
+        std::decay_t<decltype(pre::sech(
+        std::declval<T>()))>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = pre::sech(x[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Wrap `pre::coth()`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline auto coth(
+            const simd<T, W>& x)
+{
+    simd<
+        std::decay_t<decltype(pre::coth(
+        std::declval<T>()))>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = pre::coth(x[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Wrap `pre::acsc()`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline auto acsc(
+            const simd<T, W>& x)
+{
+    simd<
+        std::decay_t<decltype(pre::acsc(
+        std::declval<T>()))>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = pre::acsc(x[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Wrap `pre::asec()`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline auto asec(
+            const simd<T, W>& x)
+{
+    simd<
+        std::decay_t<decltype(pre::asec(
+        std::declval<T>()))>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = pre::asec(x[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Wrap `pre::acot()`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline auto acot(
+            const simd<T, W>& x)
+{
+    simd<
+        std::decay_t<decltype(pre::acot(
+        std::declval<T>()))>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = pre::acot(x[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Wrap `pre::acsch()`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline auto acsch(
+            const simd<T, W>& x)
+{
+    simd<
+        std::decay_t<decltype(pre::acsch(
+        std::declval<T>()))>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = pre::acsch(x[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Wrap `pre::asech()`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline auto asech(
+            const simd<T, W>& x)
+{
+    simd<
+        std::decay_t<decltype(pre::asech(
+        std::declval<T>()))>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = pre::asech(x[k]);
+    }
+    return res;
+}
+
+/**
+ * @brief Wrap `pre::acoth()`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline auto acoth(
+            const simd<T, W>& x)
+{
+    simd<
+        std::decay_t<decltype(pre::acoth(
+        std::declval<T>()))>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = pre::acoth(x[k]);
+    }
+    return res;
+}
+
+/**@}*/
+
+/**@}*/
+
+} // namespace pre
+
@@ -0,0 +1,390 @@
+tab2 = "        "
+tab3 = "            "
+funcs = [
+['abs',         [['T','x']]],
+['arg',         [['T','x']]],
+['real',        [['T','x']]],
+['imag',        [['T','x']]],
+['conj',        [['T','x']]],
+['norm',        [['T','x']]],
+['fabs',        [['T','x']]],
+['fma',         [['T','x'], ['T','y'], ['T','z']]],
+['fdim',        [['T','x'], ['T','y']]],
+['fmod',        [['T','x'], ['T','y']]],
+['remquo',      [['T','x'], ['T','y'], ['int*','q']]],
+['remainder',   [['T','x'], ['T','y']]],
+['nearbyint',   [['T','x']]],
+['floor',       [['T','x']]],
+['ceil',        [['T','x']]],
+['trunc',       [['T','x']]],
+['round',       [['T','x']]],
+['rint',        [['T','x']]],
+['lrint',       [['T','x']]],
+['llrint',      [['T','x']]],
+['lround',      [['T','x']]],
+['llround',     [['T','x']]],
+['frexp',       [['T','x'], ['int*','p']]],
+['ldexp',       [['T','x'], ['int','p']]],
+['logb',        [['T','x']]],
+['ilogb',       [['T','x']]],
+['scalbn',      [['T','x'], ['int','p']]],
+['scalbln',     [['T','x'], ['long','p']]],
+['modf',        [['T','x'], ['T*','p']]],
+['nextafter',   [['T','x'], ['T','y']]],
+['copysign',    [['T','x'], ['T','y']]],
+['exp',         [['T','x']]],
+['log',         [['T','x']]],
+['exp2',        [['T','x']]],
+['log2',        [['T','x']]],
+['log10',       [['T','x']]],
+['expm1',       [['T','x']]],
+['log1p',       [['T','x']]],
+['pow',         [['T','x'], ['T','y']]],
+['cbrt',        [['T','x']]],
+['hypot',       [['T','x'], ['T','y']]],
+['erf',         [['T','x']]],
+['erfc',        [['T','x']]],
+['lgamma',      [['T','x']]],
+['tgamma',      [['T','x']]],
+['sin',         [['T','x']]],
+['cos',         [['T','x']]],
+['tan',         [['T','x']]],
+['asin',        [['T','x']]],
+['acos',        [['T','x']]],
+['atan',        [['T','x']]],
+['atan2',       [['T','y'], ['T','x']]],
+['sinh',        [['T','x']]],
+['cosh',        [['T','x']]],
+['tanh',        [['T','x']]],
+['asinh',       [['T','x']]],
+['acosh',       [['T','x']]],
+['atanh',       [['T','x']]],
+['csc',         [['T','x']]],
+['sec',         [['T','x']]],
+['cot',         [['T','x']]],
+['csch',        [['T','x']]],
+['sech',        [['T','x']]],
+['coth',        [['T','x']]],
+['acsc',        [['T','x']]],
+['asec',        [['T','x']]],
+['acot',        [['T','x']]],
+['acsch',       [['T','x']]],
+['asech',       [['T','x']]],
+['acoth',       [['T','x']]]
+]
+
+OP1 = ['+', '-', '~']
+OP2 = ['+', '-', '*', '/', '%', '&', '|', '^', '>>', '<<']
+OPC = ['==', '!=', '<', '>', '<=', '>=']
+
+puts <<STR
+namespace pre {
+
+/**
+ * @addtogroup simd
+ */
+/**@{*/
+
+STR
+
+#------------------------------------------------------------------------------
+
+puts <<STR
+/**
+ * @name Unary operators (simd)
+ */
+/**@{*/
+
+STR
+
+for op1 in OP1
+    puts <<STR
+/**
+ * @brief Lanewise `operator#{op1}`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+constexpr simd<decltype(#{op1}T()), W> operator#{op1}(const simd<T, W>& x)
+{
+    simd<decltype(#{op1}T()), W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = #{op1}x[k];
+    }
+    return res;
+}
+
+STR
+end
+
+puts <<STR
+/**@}*/
+
+STR
+
+#------------------------------------------------------------------------------
+
+puts <<STR
+/**
+ * @name Binary operators (simd/simd)
+ */
+/**@{*/
+
+STR
+
+for op2 in OP2
+    puts <<STR
+/**
+ * @brief Lanewise `operator#{op2}`.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr simd<std::common_type_t<T, U>, W> operator#{op2}(
+                    const simd<T, W>& x,
+                    const simd<U, W>& y)
+{
+    simd<std::common_type_t<T, U>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = x[k] #{op2} y[k];
+    }
+    return res;
+}
+
+STR
+end
+
+for op2 in OP2
+    puts <<STR
+/**
+ * @brief Lanewise `operator#{op2}=`.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr simd<T, W>& operator#{op2}=(simd<T, W>& x, const simd<U, W>& y)
+{
+    for (std::size_t k = 0; k < W; k++) {
+        x[k] #{op2}= y[k];
+    }
+    return x;
+}
+
+STR
+end
+
+for opc in OPC
+    puts <<STR
+/**
+ * @brief Lanewise `operator#{opc}`.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr simd_mask<std::common_type_t<T, U>, W> operator#{opc}(
+                    const simd<T, W>& x,
+                    const simd<U, W>& y)
+{
+    simd_mask<std::common_type_t<T, U>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res.set(k, x[k] #{opc} y[k]);
+    }
+    return res;
+}
+
+STR
+end
+
+puts <<STR
+/**@}*/
+
+STR
+
+#------------------------------------------------------------------------------
+
+puts <<STR
+/**
+ * @name Binary operators (simd/entry)
+ */
+/**@{*/
+
+STR
+
+for op2 in OP2
+    puts <<STR
+/**
+ * @brief Lanewise `operator#{op2}`, broadcasting entry.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr std::enable_if_t<std::is_arithmetic<U>::value,
+    simd<std::common_type_t<T, U>, W>> operator#{op2}(
+                        const simd<T, W>& x, const U& y)
+{
+    simd<std::common_type_t<T, U>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = x[k] #{op2} y;
+    }
+    return res;
+}
+
+STR
+end
+
+for op2 in OP2
+    puts <<STR
+/**
+ * @brief Lanewise `operator#{op2}=`, broadcasting entry.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr std::enable_if_t<std::is_arithmetic<U>::value,
+    simd<T, W>&> operator#{op2}=(simd<T, W>& x, const U& y)
+{
+    for (std::size_t k = 0; k < W; k++) {
+        x[k] #{op2}= y;
+    }
+    return x;
+}
+
+STR
+end
+
+for opc in OPC
+    puts <<STR
+/**
+ * @brief Lanewise `operator#{opc}`, broadcasting entry.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr std::enable_if_t<std::is_arithmetic<U>::value,
+    simd_mask<std::common_type_t<T, U>, W>> operator#{opc}(
+                        const simd<T, W>& x, const U& y)
+{
+    simd_mask<std::common_type_t<T, U>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res.set(k, x[k] #{opc} y);
+    }
+    return res;
+}
+
+STR
+end
+
+puts <<STR
+/**@}*/
+
+STR
+
+#------------------------------------------------------------------------------
+
+puts <<STR
+/**
+ * @name Binary operators (entry/simd)
+ */
+/**@{*/
+
+STR
+
+for op2 in OP2
+    puts <<STR
+/**
+ * @brief Lanewise `operator#{op2}`, broadcasting entry.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr std::enable_if_t<std::is_arithmetic<T>::value,
+    simd<std::common_type_t<T, U>, W>> operator#{op2}(
+                        const T& x, const simd<U, W>& y)
+{
+    simd<std::common_type_t<T, U>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = x #{op2} y[k];
+    }
+    return res;
+}
+
+STR
+end
+
+for opc in OPC
+    puts <<STR
+/**
+ * @brief Lanewise `operator#{opc}`, broadcasting entry.
+ */
+template <typename T, typename U, std::size_t W>
+__attribute__((always_inline))
+constexpr std::enable_if_t<std::is_arithmetic<T>::value,
+    simd_mask<std::common_type_t<T, U>, W>> operator#{opc}(
+                        const T& x, const simd<U, W>& y)
+{
+    simd_mask<std::common_type_t<T, U>, W> res;
+    for (std::size_t k = 0; k < W; k++) {
+        res.set(k, x #{opc} y[k]);
+    }
+    return res;
+}
+
+STR
+end
+
+puts <<STR
+/**@}*/
+
+STR
+
+#------------------------------------------------------------------------------
+
+puts <<STR
+/**
+ * @name Math wrappers (simd)
+ */
+/**@{*/
+
+STR
+
+for func in funcs
+    funcname = func[0]
+    args1 = []
+    args2 = []
+    args3 = []
+    for arg in func[1]
+        if arg[0][-1] != '*'
+            args1 << "const simd<#{arg[0]}, W>& #{arg[1]}"
+            args3 << "#{arg[1]}[k]"
+        else
+            args1 << "simd<#{arg[0].slice(0..-2)}, W>* #{arg[1]}"
+            args3 << "&(*#{arg[1]})[k]"
+        end
+        args2 << "std::declval<#{arg[0]}>()"
+    end
+    args1 = args1.join ",\n#{tab3}"
+    args2 = args2.join ",\n#{tab2}"
+    args3 = args3.join ", "
+    restype = "simd<\n#{tab2}std::decay_t<decltype(pre::#{funcname}(\n#{tab2}#{args2}))>, W>"
+    puts <<STR
+/**
+ * @brief Wrap `pre::#{funcname}()`.
+ */
+template <typename T, std::size_t W>
+__attribute__((always_inline))
+inline auto #{funcname}(
+            #{args1})
+{
+    #{restype} res;
+    for (std::size_t k = 0; k < W; k++) {
+        res[k] = pre::#{funcname}(#{args3});
+    }
+    return res;
+}
+
+STR
+end
+
+puts <<STR
+/**@}*/
+
+STR
+
+puts <<STR
+/**@}*/
+
+} // namespace pre
+
+STR
@@ -0,0 +1,378 @@
+/* Copyright (c) 2018-20 M. Grady Saunders
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer.
+ *
+ *   2. Redistributions in binary form must reproduce the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer in the documentation and/or other materials
+ *      provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*+-+*/
+#if !DOXYGEN
+#if !(__cplusplus >= 201103L)
+#error "preform/size_class_allocator.hpp requires >=C++11"
+#endif // #if !(__cplusplus >= 201103L)
+#endif // #if !DOXYGEN
+#pragma once
+#ifndef PREFORM_SIZE_CLASS_ALLOCATOR_HPP
+#define PREFORM_SIZE_CLASS_ALLOCATOR_HPP
+
+// for std::size_t
+#include <cstddef>
+
+// for std::allocator, std::shared_ptr, std::unique_ptr
+#include <memory>
+
+// for pre::concurrent_memory_pool
+#include <preform/memory_pool.hpp>
+
+namespace pre {
+
+/**
+ * @defgroup size_class_allocator Size class allocator
+ *
+ * `<preform/size_class_allocator.hpp>`
+ *
+ * __C++ version__: >=C++11
+ */
+/**@{*/
+
+/**
+ * @brief Size class memory pool.
+ *
+ * General-purpose thread-safe allocator, which rounds each request
+ * up to one of 28 size classes, from 16 to 4096 bytes, and serves
+ * it from the `concurrent_memory_pool` for that class. Classes are
+ * 16 bytes apart up to 128 bytes, then 4 per doubling, so that
+ * rounding wastes at most 25%. Larger requests go directly to the
+ * internal allocator.
+ *
+ * @tparam Talloc
+ * Internal allocator type, which must be thread-safe.
+ */
+template <typename Talloc = std::allocator<char>>
+class size_class_memory_pool
+{
+public:
+
+    /**
+     * @brief Size class count.
+     */
+    static constexpr std::size_t class_count = 28;
+
+    /**
+     * @brief Maximum size class size in bytes.
+     */
+    static constexpr std::size_t max_class_size = 4096;
+
+    /**
+     * @brief Alignment of size class allocations.
+     */
+    static constexpr std::size_t class_alignment = 16;
+
+public:
+
+    /**
+     * @brief Constructor.
+     */
+    size_class_memory_pool(const Talloc& alloc = Talloc()) :
+            byte_alloc_(alloc)
+    {
+        for (std::size_t index = 0;
+                         index < class_count; index++) {
+            // Aim for first pool of 64KB.
+            std::size_t elem_size = class_size(index);
+            pools_[index].reset(
+                new concurrent_memory_pool<Talloc>(
+                    elem_size, 65536 / elem_size,
+                    elem_size <= 256 ? 64 : 16, alloc));
+        }
+    }
+
+    /**
+     * @brief Non-copyable.
+     */
+    size_class_memory_pool(const size_class_memory_pool&) = delete;
+
+public:
+
+    /**
+     * @brief Allocate bytes.
+     *
+     * @note
+     * This is thread-safe.
+     */
+    void* allocate(std::size_t size)
+    {
+        if (size == 0) {
+            return nullptr;
+        }
+        if (size > max_class_size) {
+            return static_cast<void*>(byte_alloc_.allocate(size));
+        }
+        return pools_[class_index(size)]->allocate();
+    }
+
+    /**
+     * @brief Deallocate bytes.
+     *
+     * @param[in] ptr
+     * Pointer returned by `allocate()`.
+     *
+     * @param[in] size
+     * Size passed to `allocate()`.
+     *
+     * @note
+     * This is thread-safe.
+     */
+    void deallocate(void* ptr, std::size_t size)
+    {
+        if (ptr == nullptr || size == 0) {
+            return;
+        }
+        if (size > max_class_size) {
+            byte_alloc_.deallocate(static_cast<char*>(ptr), size);
+            return;
+        }
+        pools_[class_index(size)]->deallocate(ptr);
+    }
+
+    /**
+     * @brief Size class index.
+     *
+     * @param[in] size
+     * Size in bytes, in @f$ [1, 4096] @f$.
+     */
+    static std::size_t class_index(std::size_t size)
+    {
+        if (size <= 128) {
+            return (size + 15) / 16 - 1;
+        }
+        std::size_t shift = 0;
+        while (size > (std::size_t(256) << shift)) {
+            shift++;
+        }
+        std::size_t step = std::size_t(32) << shift;
+        return 8 + 4 * shift +
+            (size - (std::size_t(128) << shift) + step - 1) / step - 1;
+    }
+
+    /**
+     * @brief Size class size in bytes.
+     *
+     * @param[in] index
+     * Size class index.
+     */
+    static std::size_t class_size(std::size_t index)
+    {
+        if (index < 8) {
+            return 16 * (index + 1);
+        }
+        std::size_t shift = (index - 8) / 4;
+        return (std::size_t(128) << shift) +
+               (std::size_t(32) << shift) * ((index - 8) % 4 + 1);
+    }
+
+    /**
+     * @brief Default instance, shared by default-constructed
+     * allocators.
+     */
+    static const std::shared_ptr<size_class_memory_pool>& instance()
+    {
+        static std::shared_ptr<size_class_memory_pool> pool(
+                new size_class_memory_pool());
+        return pool;
+    }
+
+private:
+
+    /**
+     * @brief Byte allocator type.
+     */
+    typedef typename std::allocator_traits<Talloc>::
+            template rebind_alloc<char> byte_allocator;
+
+    /**
+     * @brief Byte allocator.
+     */
+    byte_allocator byte_alloc_;
+
+    /**
+     * @brief Pools, one per size class.
+     */
+    std::unique_ptr<concurrent_memory_pool<Talloc>> pools_[class_count];
+};
+
+/**
+ * @brief Size class allocator.
+ *
+ * Drop-in replacement for `std::allocator`, with per-thread caches
+ * through the underlying `size_class_memory_pool`. Objects with
+ * alignment greater than 16 bytes bypass the size classes.
+ *
+ * @tparam T
+ * Value type.
+ *
+ * @tparam Talloc
+ * Internal allocator type, which must be thread-safe.
+ */
+template <typename T, typename Talloc = std::allocator<char>>
+class size_class_allocator
+{
+public:
+
+    /**
+     * @brief Value type.
+     */
+    typedef T value_type;
+
+    /**
+     * @brief Propagate on container copy assignment.
+     */
+    typedef std::true_type propagate_on_container_copy_assignment;
+
+    /**
+     * @brief Propagate on container move assignment.
+     */
+    typedef std::true_type propagate_on_container_move_assignment;
+
+    /**
+     * @brief Propagate on container swap.
+     */
+    typedef std::true_type propagate_on_container_swap;
+
+    /**
+     * @brief Is _not_ always equal.
+     */
+    typedef std::false_type is_always_equal;
+
+public:
+
+    /**
+     * @brief Constructor, sharing default pool.
+     */
+    size_class_allocator() :
+            pool_(size_class_memory_pool<Talloc>::instance())
+    {
+    }
+
+    /**
+     * @brief Constructor.
+     *
+     * @param[in] pool
+     * Underlying pool, to share with other allocators.
+     */
+    explicit size_class_allocator(
+            std::shared_ptr<size_class_memory_pool<Talloc>> pool) :
+                pool_(std::move(pool))
+    {
+    }
+
+    /**
+     * @brief Copy constructor.
+     */
+    template <typename U>
+    size_class_allocator(const size_class_allocator<U, Talloc>& other) :
+            pool_(other.pool_)
+    {
+    }
+
+    /**
+     * @brief Copy assignment.
+     */
+    template <typename U>
+    size_class_allocator& operator=(
+                    const size_class_allocator<U, Talloc>& other)
+    {
+        this->pool_ = other.pool_;
+        return *this;
+    }
+
+    /**
+     * @brief Allocate.
+     *
+     * @param[in] n
+     * Number of objects.
+     */
+    [[nodiscard]]
+    T* allocate(std::size_t n)
+    {
+        if (alignof(T) >
+            size_class_memory_pool<Talloc>::class_alignment) {
+            return std::allocator<T>().allocate(n);
+        }
+        return static_cast<T*>(pool_->allocate(sizeof(T) * n));
+    }
+
+    /**
+     * @brief Deallocate.
+     *
+     * @param[in] ptr
+     * Pointer.
+     *
+     * @param[in] n
+     * Number of objects.
+     */
+    void deallocate(T* ptr, std::size_t n)
+    {
+        if (alignof(T) >
+            size_class_memory_pool<Talloc>::class_alignment) {
+            std::allocator<T>().deallocate(ptr, n);
+            return;
+        }
+        pool_->deallocate(ptr, sizeof(T) * n);
+    }
+
+    /**
+     * @brief Equal?
+     */
+    template <typename U>
+    bool operator==(const size_class_allocator<U, Talloc>& other) const
+    {
+        return pool_.get() == other.pool_.get();
+    }
+
+    /**
+     * @brief Not equal?
+     */
+    template <typename U>
+    bool operator!=(const size_class_allocator<U, Talloc>& other) const
+    {
+        return pool_.get() != other.pool_.get();
+    }
+
+private:
+
+    /**
+     * @brief Pool.
+     */
+    std::shared_ptr<size_class_memory_pool<Talloc>> pool_;
+
+    // Declare friend.
+    template <typename, typename>
+    friend class size_class_allocator;
+};
+
+/**@}*/
+
+} // namespace pre
+
+#endif // #ifndef PREFORM_SIZE_CLASS_ALLOCATOR_HPP
@@ -0,0 +1,809 @@
+/* Copyright (c) 2018-20 M. Grady Saunders
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer.
+ *
+ *   2. Redistributions in binary form must reproduce the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer in the documentation and/or other materials
+ *      provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*+-+*/
+#if !DOXYGEN
+#if !(__cplusplus >= 201703L)
+#error "preform/sparse_image3.hpp requires >=C++17"
+#endif // #if !(__cplusplus >= 201703L)
+#endif // #if !DOXYGEN
+#pragma once
+#ifndef PREFORM_SPARSE_IMAGE3_HPP
+#define PREFORM_SPARSE_IMAGE3_HPP
+
+// for std::fill, std::find
+#include <algorithm>
+
+// for std::uint8_t, std::uint32_t
+#include <cstdint>
+
+// for std::vector
+#include <vector>
+
+// for pre::image3
+#include <preform/image3.hpp>
+
+namespace pre {
+
+/**
+ * @defgroup sparse_image3 Sparse image (3-dimensional)
+ *
+ * `<preform/sparse_image3.hpp>`
+ *
+ * __C++ version__: >=C++17
+ */
+/**@{*/
+
+/**
+ * @brief Sparse image (3-dimensional).
+ *
+ * Volume stored as @f$ 8^3 @f$ bricks, allocated only where some
+ * entry differs from a shared background value, and indexed through
+ * a dense top-level occupancy grid of bricks. For mostly empty
+ * volumes, such as participating-media grids, memory is then
+ * proportional to the occupied bricks rather than to the full
+ * volume.
+ *
+ * Sampling follows `image3`, and additionally the image answers
+ * empty-space skipping queries for ray marching.
+ *
+ * @note
+ * Reads are safe for any number of threads at once, writes are not.
+ */
+template <
+    typename Tfloat,
+    typename T, std::size_t N,
+    typename Talloc = std::allocator<T>
+    >
+class sparse_image3
+{
+public:
+
+    // Sanity check.
+    static_assert(
+        std::is_floating_point<Tfloat>::value,
+        "Tfloat must be floating point");
+
+    // Sanity check.
+    static_assert(
+        std::is_arithmetic<T>::value,
+        "T must be arithmetic");
+
+    /**
+     * @brief Float type.
+     */
+    typedef Tfloat float_type;
+
+    /**
+     * @brief Entry type.
+     */
+    typedef T entry_type;
+
+    /**
+     * @brief Value type.
+     */
+    typedef multi<T, N> value_type;
+
+    /**
+     * @brief Size type.
+     */
+    typedef std::size_t size_type;
+
+    /**
+     * @brief Allocator type.
+     */
+    typedef typename std::allocator_traits<Talloc>::
+            template rebind_alloc<value_type> allocator_type;
+
+    /**
+     * @brief Brick size, in entries along each dimension.
+     */
+    static constexpr size_type brick_size = 8;
+
+    /**
+     * @brief Brick volume, in entries.
+     */
+    static constexpr size_type brick_volume =
+            brick_size * brick_size * brick_size;
+
+public:
+
+    /**
+     * @brief Default constructor.
+     */
+    sparse_image3() = default;
+
+    /**
+     * @brief Constructor.
+     *
+     * @param[in] count
+     * Count.
+     *
+     * @param[in] background
+     * Background value, for entries in empty bricks.
+     *
+     * @param[in] alloc
+     * Allocator.
+     */
+    explicit sparse_image3(
+            multi<size_type, 3> count,
+            const value_type& background = value_type(),
+            const allocator_type& alloc = allocator_type()) :
+                bricks_data_(alloc)
+    {
+        resize(count, background);
+    }
+
+    /**
+     * @brief Constructor, from dense image.
+     *
+     * Allocate only bricks with some entry different from
+     * `background`. The cycle mode is copied.
+     *
+     * @param[in] image
+     * Image.
+     *
+     * @param[in] background
+     * Background value, for entries in empty bricks.
+     */
+    template <typename Tother_alloc>
+    explicit sparse_image3(
+            const image3<Tfloat, T, N, Tother_alloc>& image,
+            const value_type& background = value_type()) :
+                sparse_image3(image.user_size(), background)
+    {
+        cycle_mode_ = image.cycle_mode();
+        for (size_type i = 0; i < user_size_[0]; i++)
+        for (size_type j = 0; j < user_size_[1]; j++)
+        for (size_type k = 0; k < user_size_[2]; k++) {
+            set({i, j, k}, image(i, j, k));
+        }
+    }
+
+public:
+
+    /**
+     * @name Accessors
+     */
+    /**@{*/
+
+    /**
+     * @brief Empty?
+     */
+    bool empty() const noexcept
+    {
+        return (user_size_ == size_type(0)).any();
+    }
+
+    /**
+     * @brief User size.
+     */
+    multi<size_type, 3> user_size() const noexcept
+    {
+        return user_size_;
+    }
+
+    /**
+     * @brief Brick grid size.
+     */
+    multi<size_type, 3> brick_grid_size() const noexcept
+    {
+        return grid_size_;
+    }
+
+    /**
+     * @brief Background value.
+     */
+    const value_type& background() const noexcept
+    {
+        return background_;
+    }
+
+    /**
+     * @brief Allocated brick count.
+     */
+    size_type brick_count() const noexcept
+    {
+        return bricks_data_.size() / brick_volume - free_bricks_.size();
+    }
+
+    /**
+     * @brief Approximate memory footprint, in bytes.
+     */
+    size_type memory_usage() const noexcept
+    {
+        return bricks_data_.capacity() * sizeof(value_type) +
+               grid_.capacity() * sizeof(std::uint32_t) +
+               near_.capacity() * sizeof(std::uint8_t) +
+               free_bricks_.capacity() * sizeof(std::uint32_t);
+    }
+
+    /**
+     * @brief Get cycle mode.
+     */
+    multi<int, 3> cycle_mode() const
+    {
+        return cycle_mode_;
+    }
+
+    /**
+     * @brief Set cycle mode.
+     */
+    multi<int, 3> cycle_mode(multi<int, 3> mode)
+    {
+        multi<int, 3> prev = cycle_mode_;
+        cycle_mode_ = mode;
+        return prev;
+    }
+
+    /**
+     * @brief Set cycle mode.
+     */
+    multi<int, 3> cycle_mode(int mode)
+    {
+        return cycle_mode(multi<int, 3>(mode));
+    }
+
+    /**
+     * @brief Entry.
+     */
+    const value_type& operator()(
+            size_type i, size_type j, size_type k) const
+    {
+        return at_({int(i), int(j), int(k)});
+    }
+
+    /**
+     * @brief Is brick empty?
+     *
+     * @param[in] brick
+     * Brick index, in the brick grid.
+     */
+    bool brick_empty(multi<size_type, 3> brick) const
+    {
+        return grid_[grid_index_(brick)] == 0;
+    }
+
+    /**@}*/
+
+public:
+
+    /**
+     * @name Modifiers
+     */
+    /**@{*/
+
+    /**
+     * @brief Resize, discarding all entries.
+     *
+     * @param[in] count
+     * Count.
+     *
+     * @param[in] background
+     * Background value, for entries in empty bricks.
+     */
+    void resize(
+            multi<size_type, 3> count,
+            const value_type& background = value_type())
+    {
+        user_size_ = count;
+        grid_size_ = (count + (brick_size - 1)) / brick_size;
+        background_ = background;
+        grid_.assign(grid_size_.prod(), 0);
+        near_.assign(grid_size_.prod(), 0);
+        bricks_data_.clear();
+        free_bricks_.clear();
+    }
+
+    /**
+     * @brief Set entry, allocating its brick if necessary.
+     *
+     * @param[in] ind
+     * Index.
+     *
+     * @param[in] value
+     * Value.
+     */
+    void set(multi<size_type, 3> ind, const value_type& value)
+    {
+        size_type cell = grid_index_(ind / brick_size);
+        if (grid_[cell] == 0) {
+            if ((value == background_).all()) {
+                return;
+            }
+            allocate_brick_(ind / brick_size);
+        }
+        bricks_data_[brick_offset_(grid_[cell], ind)] = value;
+    }
+
+    /**
+     * @brief Free bricks whose entries all equal the background.
+     */
+    void compact()
+    {
+        for (size_type i = 0; i < grid_size_[0]; i++)
+        for (size_type j = 0; j < grid_size_[1]; j++)
+        for (size_type k = 0; k < grid_size_[2]; k++) {
+            multi<size_type, 3> brick = {i, j, k};
+            std::uint32_t slot = grid_[grid_index_(brick)];
+            if (slot == 0) {
+                continue;
+            }
+            const value_type* data =
+                &bricks_data_[(slot - 1) * brick_volume];
+            bool uniform = true;
+            for (size_type n = 0; n < brick_volume && uniform; n++) {
+                uniform = (data[n] == background_).all();
+            }
+            if (uniform) {
+                free_brick_(brick);
+            }
+        }
+    }
+
+    /**@}*/
+
+public:
+
+    /**
+     * @name Sampling
+     */
+    /**@{*/
+
+    /**
+     * @brief Sample, no interpolation.
+     *
+     * @param[in] loc
+     * Location.
+     */
+    multi<float_type, N> sample0(multi<float_type, 3> loc) const
+    {
+        if (empty()) {
+            return {};
+        }
+        else {
+            return fetch(fastfloor(loc));
+        }
+    }
+
+    /**
+     * @brief Sample, linear interpolation.
+     *
+     * @param[in] loc
+     * Location.
+     */
+    multi<float_type, N> sample1(multi<float_type, 3> loc) const
+    {
+        if (empty()) {
+            return {};
+        }
+        else {
+            // Shift.
+            loc -= float_type(0.5);
+
+            // Floor.
+            multi<int, 3> ind = fastfloor(loc);
+            loc -= ind;
+
+            // Interpolate.
+            multi<float_type, N> val2[2];
+            for (int k = 0; k < 2; k++) {
+
+                multi<float_type, N> val0[2];
+                for (int i = 0; i < 2; i++) {
+
+                    multi<float_type, N> val1[2];
+                    for (int j = 0; j < 2; j++) {
+                        val1[j] =
+                            fetch(ind +
+                            multi<int, 3>{i, j, k});
+                    }
+
+                    // Linear interpolation.
+                    val0[i] = lerp(loc[1], val1[0], val1[1]);
+                }
+
+                // Linear interpolation.
+                val2[k] = lerp(loc[0], val0[0], val0[1]);
+            }
+
+            // Linear interpolation.
+            return lerp(loc[2], val2[0], val2[1]);
+        }
+    }
+
+    /**
+     * @brief Sample, cubic interpolation.
+     *
+     * @param[in] loc
+     * Location.
+     */
+    multi<float_type, N> sample3(multi<float_type, 3> loc) const
+    {
+        if (empty()) {
+            return {};
+        }
+        else {
+            // Shift.
+            loc -= float_type(0.5);
+
+            // Floor.
+            multi<int, 3> ind = fastfloor(loc);
+            loc -= ind;
+
+            // Interpolate.
+            multi<float_type, N> val2[4];
+            for (int k = 0; k < 4; k++) {
+
+                multi<float_type, N> val0[4];
+                for (int i = 0; i < 4; i++) {
+
+                    multi<float_type, N> val1[4];
+                    for (int j = 0; j < 4; j++) {
+                        val1[j] =
+                            fetch(ind +
+                            multi<int, 3>{
+                                i - 1,
+                                j - 1,
+                                k - 1
+                            });
+                    }
+
+                    // Catmull-Rom interpolation.
+                    val0[i] =
+                        catmull(
+                            loc[1],
+                            val1[0], val1[1],
+                            val1[2], val1[3]);
+                }
+
+                // Catmull-Rom interpolation.
+                val2[k] =
+                    catmull(
+                        loc[0],
+                        val0[0], val0[1],
+                        val0[2], val0[3]);
+            }
+
+            // Catmull-Rom interpolation.
+            return
+                catmull(
+                    loc[2],
+                    val2[0], val2[1],
+                    val2[2], val2[3]);
+        }
+    }
+
+    /**
+     * @brief Sample.
+     *
+     * @param[in] samp
+     * Sampling method, either 0, 1, or 3.
+     *
+     * @param[in] loc
+     * Location.
+     */
+    multi<float_type, N> sample(int samp, multi<float_type, 3> loc) const
+    {
+        switch (samp) {
+            default:
+            case 0: return sample0(loc);
+            case 1: return sample1(loc);
+            case 3: return sample3(loc);
+        }
+
+        // Unreachable.
+        return {};
+    }
+
+    /**@}*/
+
+public:
+
+    /**
+     * @name Empty-space skipping
+     */
+    /**@{*/
+
+    /**
+     * @brief Skip empty space along ray.
+     *
+     * Walk the brick grid along the ray, and find the first
+     * parameter at which any sampling method may return something
+     * other than the background. That is, every sample along the
+     * ray before the returned parameter is the background, up to
+     * interpolation round-off.
+     * Bricks adjacent to occupied bricks count as occupied, to
+     * cover filter footprints, and everything outside of the
+     * volume counts as occupied, to stay conservative under any
+     * cycle mode.
+     *
+     * @param[in] loc
+     * Ray origin, in the same units as sampling locations.
+     *
+     * @param[in] dir
+     * Ray direction.
+     *
+     * @param[in] tmin
+     * Ray parameter minimum.
+     *
+     * @param[in] tmax
+     * Ray parameter maximum.
+     *
+     * @returns
+     * Ray parameter in @f$ [t_{\min}, t_{\max}] @f$, which is
+     * @f$ t_{\max} @f$ if the ray is empty throughout.
+     */
+    float_type skip_empty(
+            multi<float_type, 3> loc,
+            multi<float_type, 3> dir,
+            float_type tmin,
+            float_type tmax) const
+    {
+        if (empty() || !(tmin < tmax)) {
+            return tmin;
+        }
+
+        // Start cell.
+        multi<float_type, 3> pos = (loc + tmin * dir) / float_type(brick_size);
+        multi<int, 3> cell = fastfloor(pos);
+        for (int l = 0; l < 3; l++) {
+            if (!(pos[l] >= 0 && pos[l] < float_type(grid_size_[l]))) {
+                return tmin;
+            }
+        }
+
+        // Set up traversal.
+        multi<int, 3> step;
+        multi<float_type, 3> tnext;
+        multi<float_type, 3> tdelta;
+        for (int l = 0; l < 3; l++) {
+            float_type d = dir[l] / float_type(brick_size);
+            if (d > 0) {
+                step[l] = +1;
+                tdelta[l] = 1 / d;
+                tnext[l] = tmin + (float_type(cell[l] + 1) - pos[l]) / d;
+            }
+            else if (d < 0) {
+                step[l] = -1;
+                tdelta[l] = -1 / d;
+                tnext[l] = tmin + (float_type(cell[l]) - pos[l]) / d;
+            }
+            else {
+                step[l] = 0;
+                tdelta[l] = 0;
+                tnext[l] = tmax;
+            }
+        }
+
+        // Traverse.
+        float_type t = tmin;
+        while (true) {
+            if (near_[grid_index_(multi<size_type, 3>(cell))] != 0) {
+                return t;
+            }
+            int l = 0;
+            if (tnext[1] < tnext[l]) l = 1;
+            if (tnext[2] < tnext[l]) l = 2;
+            t = tnext[l];
+            if (!(t < tmax)) {
+                return tmax;
+            }
+            cell[l] += step[l];
+            tnext[l] += tdelta[l];
+            if (!(cell[l] >= 0 && cell[l] < int(grid_size_[l]))) {
+                return t;
+            }
+        }
+    }
+
+    /**@}*/
+
+private:
+
+    /**
+     * @brief User size.
+     */
+    multi<size_type, 3> user_size_ = {};
+
+    /**
+     * @brief Brick grid size.
+     */
+    multi<size_type, 3> grid_size_ = {};
+
+    /**
+     * @brief Background value.
+     */
+    value_type background_ = {};
+
+    /**
+     * @brief Cycle mode.
+     *
+     *  Value | Behavior
+     * -------|----------
+     *  0     | Clamp
+     *  +1    | Repeat
+     *  -1    | Repeat with mirroring
+     */
+    multi<int, 3> cycle_mode_ = {};
+
+    /**
+     * @brief Brick grid, holding brick slot plus 1, or 0 if empty.
+     */
+    std::vector<std::uint32_t> grid_;
+
+    /**
+     * @brief Brick grid, holding count of occupied bricks in
+     * each 3x3x3 neighborhood, with wrapping.
+     */
+    std::vector<std::uint8_t> near_;
+
+    /**
+     * @brief Brick data.
+     */
+    std::vector<value_type, allocator_type> bricks_data_;
+
+    /**
+     * @brief Free brick slots, plus 1.
+     */
+    std::vector<std::uint32_t> free_bricks_;
+
+#if !DOXYGEN
+
+    /**
+     * @brief Grid index.
+     */
+    size_type grid_index_(multi<size_type, 3> brick) const noexcept
+    {
+        return (brick[0] * grid_size_[1] + brick[1]) *
+                grid_size_[2] + brick[2];
+    }
+
+    /**
+     * @brief Brick data offset.
+     */
+    static size_type brick_offset_(
+            std::uint32_t slot, multi<size_type, 3> ind) noexcept
+    {
+        ind %= brick_size;
+        return (slot - 1) * brick_volume +
+               (ind[0] * brick_size + ind[1]) * brick_size + ind[2];
+    }
+
+    /**
+     * @brief Update neighborhood counts around brick.
+     */
+    void update_near_(multi<size_type, 3> brick, int delta)
+    {
+        // Collect distinct cells, as the grid may be thinner than 3.
+        size_type cells[27];
+        int cell_count = 0;
+        for (int di = -1; di <= 1; di++)
+        for (int dj = -1; dj <= 1; dj++)
+        for (int dk = -1; dk <= 1; dk++) {
+            multi<int, 3> cell = multi<int, 3>(brick) +
+                                 multi<int, 3>{di, dj, dk};
+            for (int l = 0; l < 3; l++) {
+                cell[l] = repeat(cell[l], int(grid_size_[l]));
+            }
+            size_type index = grid_index_(multi<size_type, 3>(cell));
+            if (std::find(cells, cells + cell_count, index) ==
+                          cells + cell_count) {
+                cells[cell_count++] = index;
+            }
+        }
+        for (int n = 0; n < cell_count; n++) {
+            near_[cells[n]] += delta;
+        }
+    }
+
+    /**
+     * @brief Allocate brick, filled with background.
+     */
+    void allocate_brick_(multi<size_type, 3> brick)
+    {
+        std::uint32_t slot;
+        if (!free_bricks_.empty()) {
+            slot = free_bricks_.back();
+            free_bricks_.pop_back();
+            std::fill(
+                bricks_data_.begin() + (slot - 1) * brick_volume,
+                bricks_data_.begin() + slot * brick_volume,
+                background_);
+        }
+        else {
+            slot = std::uint32_t(bricks_data_.size() / brick_volume + 1);
+            bricks_data_.resize(slot * brick_volume, background_);
+        }
+        grid_[grid_index_(brick)] = slot;
+        update_near_(brick, +1);
+    }
+
+    /**
+     * @brief Free brick.
+     */
+    void free_brick_(multi<size_type, 3> brick)
+    {
+        std::uint32_t& slot = grid_[grid_index_(brick)];
+        free_bricks_.push_back(slot);
+        slot = 0;
+        update_near_(brick, -1);
+    }
+
+    /**
+     * @brief Entry at index, in range.
+     */
+    const value_type& at_(multi<int, 3> ind) const
+    {
+        multi<size_type, 3> loc = ind;
+        std::uint32_t slot = grid_[grid_index_(loc / brick_size)];
+        if (slot == 0) {
+            return background_;
+        }
+        else {
+            return bricks_data_[brick_offset_(slot, loc)];
+        }
+    }
+
+    /**
+     * @brief Cycle.
+     */
+    multi<int, 3> cycle(multi<int, 3> ind) const
+    {
+        for (int l = 0; l < 3; l++) {
+            switch (cycle_mode_[l]) {
+                default:
+                case 0:
+                    ind[l] = clamp(ind[l], int(user_size_[l]));
+                    break;
+                case +1:
+                    ind[l] = repeat(ind[l], int(user_size_[l]));
+                    break;
+                case -1:
+                    ind[l] = mirror(ind[l], int(user_size_[l]));
+                    break;
+            }
+        }
+        return ind;
+    }
+
+    /**
+     * @brief Fetch.
+     */
+    multi<float_type, N> fetch(multi<int, 3> ind) const
+    {
+        return fstretch<float_type>(at_(cycle(ind)));
+    }
+
+#endif // #if !DOXYGEN
+};
+
+/**@}*/
+
+} // namespace pre
+
+#endif // #ifndef PREFORM_SPARSE_IMAGE3_HPP
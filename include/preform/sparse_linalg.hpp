@@ -0,0 +1,351 @@
+/* Copyright (c) 2018-20 M. Grady Saunders
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *   1. Redistributions of source code must retain the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer.
+ * 
+ *   2. Redistributions in binary form must reproduce the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer in the documentation and/or other materials
+ *      provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*+-+*/
+#if !DOXYGEN
+#if !(__cplusplus >= 201402L)
+#error "preform/sparse_linalg.hpp requires >=C++14"
+#endif // #if !(__cplusplus >= 201402L)
+#endif // #if !DOXYGEN
+#pragma once
+#ifndef PREFORM_SPARSE_LINALG_HPP
+#define PREFORM_SPARSE_LINALG_HPP
+
+#include <vector>
+#include <preform/math.hpp>
+#include <preform/dense_vector_view.hpp>
+
+namespace pre {
+
+/**
+ * @defgroup sparse_linalg Sparse linear algebra
+ *
+ * `<preform/sparse_linalg.hpp>`
+ *
+ * __C++ version__: >=C++14
+ */
+/**@{*/
+
+/**
+ * @brief Compressed sparse row (CSR) matrix view.
+ *
+ * Row @f$ i @f$ of the matrix holds entries `val_[k]` in columns
+ * `col_ind_[k]` for @f$ k \in [r_i, r_{i+1}) @f$, where
+ * @f$ r_i @f$ is `row_ptr_[i]`. The view does not manage memory.
+ *
+ * @tparam Tvalue
+ * Value type.
+ */
+template <typename Tvalue>
+struct csr_matrix_view
+{
+public:
+
+    /**
+     * @brief Value type.
+     */
+    typedef std::decay_t<Tvalue> value_type;
+
+public:
+
+    /**
+     * @brief Row pointers, of size `size0_ + 1`.
+     */
+    const int* row_ptr_ = nullptr;
+
+    /**
+     * @brief Column indices, of size `row_ptr_[size0_]`.
+     */
+    const int* col_ind_ = nullptr;
+
+    /**
+     * @brief Values, of size `row_ptr_[size0_]`.
+     */
+    Tvalue* val_ = nullptr;
+
+    /**
+     * @brief Size of 0th dimension.
+     */
+    int size0_ = 0;
+
+    /**
+     * @brief Size of 1st dimension.
+     */
+    int size1_ = 0;
+
+public:
+
+    /**
+     * @brief Size of 0th dimension.
+     */
+    constexpr int size0() const
+    {
+        return size0_;
+    }
+
+    /**
+     * @brief Size of 1st dimension.
+     */
+    constexpr int size1() const
+    {
+        return size1_;
+    }
+
+    /**
+     * @brief Number of stored entries.
+     */
+    constexpr int nonzeros() const
+    {
+        return size0_ > 0 ? row_ptr_[size0_] : 0;
+    }
+
+    /**
+     * @brief Empty?
+     */
+    constexpr bool empty() const
+    {
+        return !(size0_ > 0 && size1_ > 0);
+    }
+
+    /**
+     * @brief Cast as const view.
+     */
+    constexpr operator csr_matrix_view<const value_type>() const
+    {
+        return {
+            row_ptr_,
+            col_ind_,
+            val_,
+            size0_,
+            size1_
+        };
+    }
+};
+
+/**
+ * @brief Sparse linear algebra.
+ *
+ * @tparam Tvalue
+ * Value type, must be either floating point or complex.
+ */
+template <typename Tvalue>
+struct sparse_linalg
+{
+public:
+
+    // Sanity check.
+    static_assert(
+        std::is_floating_point<Tvalue>::value || is_complex<Tvalue>::value,
+        "Tvalue must be floating point or complex");
+
+    /**
+     * @brief Value type.
+     */
+    typedef Tvalue value_type;
+
+    /**
+     * @brief Float type.
+     */
+    typedef decltype(pre::real(Tvalue())) float_type;
+
+    /**
+     * @brief Matrix-vector product.
+     *
+     * @param[in] a
+     * Matrix @f$ \mathbf{A} @f$.
+     *
+     * @param[in] x
+     * Vector @f$ \mathbf{x} @f$.
+     *
+     * @param[out] y
+     * Vector @f$ \mathbf{y} = \mathbf{A}\mathbf{x} @f$.
+     *
+     * @throw std::invalid_argument
+     * Unless `a.size1() == x.size()` and `a.size0() == y.size()`.
+     */
+    static void gemv(
+                csr_matrix_view<const value_type> a,
+                dense_vector_view<const value_type*> x,
+                dense_vector_view<value_type*> y)
+    {
+        // Ensure valid.
+        if (a.size1() != x.size() ||
+            a.size0() != y.size()) {
+            throw std::invalid_argument(__PRETTY_FUNCTION__);
+        }
+
+        for (int i = 0; i < a.size0(); i++) {
+            value_type tmp = value_type();
+            for (int k = a.row_ptr_[i]; k < a.row_ptr_[i + 1]; k++) {
+                tmp += a.val_[k] * x[a.col_ind_[k]];
+            }
+            y[i] = tmp;
+        }
+    }
+
+    /**
+     * @brief Conjugate gradient solve, with Jacobi preconditioner.
+     *
+     * @param[in] a
+     * Hermitian positive definite matrix @f$ \mathbf{A} @f$.
+     *
+     * @param[in] b
+     * Vector @f$ \mathbf{b} @f$.
+     *
+     * @param[inout] x
+     * Vector @f$ \mathbf{x} @f$, on input the initial guess, on output
+     * the approximate solution of @f$ \mathbf{A}\mathbf{x} = \mathbf{b} @f$.
+     *
+     * @param[in] tol
+     * Tolerance on the relative residual
+     * @f$ \lVert \mathbf{b} - \mathbf{A}\mathbf{x} \rVert /
+     *     \lVert \mathbf{b} \rVert @f$. By default, the square root
+     * of machine epsilon, as the recursively updated residual of
+     * conjugate gradient typically stagnates well above epsilon.
+     *
+     * @param[in] max_iters
+     * Maximum number of iterations.
+     *
+     * @param[out] res
+     * _Optional_. Relative residual on output, as updated by
+     * the iteration.
+     *
+     * @returns
+     * Number of iterations. If equal to `max_iters`, the solve
+     * may not have converged.
+     *
+     * @throw std::invalid_argument
+     * Unless `a` is square and `a.size0() == b.size() == x.size()`.
+     *
+     * @throw std::runtime_error
+     * If zero or non-finite diagonal entry.
+     */
+    static int cg(
+                csr_matrix_view<const value_type> a,
+                dense_vector_view<const value_type*> b,
+                dense_vector_view<value_type*> x,
+                float_type tol =
+                    pre::sqrt(pre::numeric_limits<float_type>::epsilon()),
+                int max_iters = 1000,
+                float_type* res = nullptr)
+    {
+        // Ensure valid.
+        if (a.size0() != a.size1() ||
+            a.size0() != b.size() ||
+            a.size0() != x.size()) {
+            throw std::invalid_argument(__PRETTY_FUNCTION__);
+        }
+
+        // Temporary buffer.
+        const int n = a.size0();
+        static thread_local std::vector<value_type> tmpbuf;
+        tmpbuf.resize(std::size_t(n) * 4);
+        value_type* invd = &tmpbuf[0];
+        value_type* r = invd + n;
+        value_type* z = r + n;
+        value_type* p = z + n;
+        value_type* q = z;
+
+        // Inverse diagonal.
+        for (int i = 0; i < n; i++) {
+            value_type aii = value_type();
+            for (int k = a.row_ptr_[i]; k < a.row_ptr_[i + 1]; k++) {
+                if (a.col_ind_[k] == i) {
+                    aii += a.val_[k];
+                }
+            }
+            if (!(aii != value_type()) || !pre::isfinite(aii)) {
+                throw std::runtime_error(__PRETTY_FUNCTION__);
+            }
+            invd[i] = value_type(1) / aii;
+        }
+
+        // Initial residual.
+        float_type bb = 0;
+        for (int i = 0; i < n; i++) {
+            value_type tmp = b[i];
+            for (int k = a.row_ptr_[i]; k < a.row_ptr_[i + 1]; k++) {
+                tmp -= a.val_[k] * x[a.col_ind_[k]];
+            }
+            r[i] = tmp;
+            bb += pre::norm(b[i]);
+        }
+        float_type tol2 = tol * tol * bb;
+
+        // Iterate.
+        value_type rz = value_type();
+        float_type rr = 0;
+        for (int i = 0; i < n; i++) {
+            p[i] = invd[i] * r[i];
+            rz += pre::conj(r[i]) * p[i];
+            rr += pre::norm(r[i]);
+        }
+        int iter = 0;
+        for (; iter < max_iters && rr > tol2; iter++) {
+
+            // Step.
+            value_type pq = value_type();
+            for (int i = 0; i < n; i++) {
+                value_type tmp = value_type();
+                for (int k = a.row_ptr_[i]; k < a.row_ptr_[i + 1]; k++) {
+                    tmp += a.val_[k] * p[a.col_ind_[k]];
+                }
+                q[i] = tmp;
+                pq += pre::conj(p[i]) * tmp;
+            }
+            value_type alpha = rz / pq;
+            for (int i = 0; i < n; i++) {
+                x[i] += alpha * p[i];
+                r[i] -= alpha * q[i];
+            }
+
+            // Next direction.
+            value_type rznext = value_type();
+            rr = 0;
+            for (int i = 0; i < n; i++) {
+                z[i] = invd[i] * r[i];
+                rznext += pre::conj(r[i]) * z[i];
+                rr += pre::norm(r[i]);
+            }
+            value_type beta = rznext / rz;
+            rz = rznext;
+            for (int i = 0; i < n; i++) {
+                p[i] = z[i] + beta * p[i];
+            }
+        }
+        if (res) {
+            *res = bb > 0 ? pre::sqrt(rr / bb) : pre::sqrt(rr);
+        }
+        return iter;
+    }
+};
+
+/**@}*/
+
+} // namespace pre
+
+#endif // #ifndef PREFORM_SPARSE_LINALG_HPP
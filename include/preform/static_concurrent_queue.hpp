@@ -0,0 +1,562 @@
+/* Copyright (c) 2018-20 M. Grady Saunders
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer.
+ *
+ *   2. Redistributions in binary form must reproduce the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer in the documentation and/or other materials
+ *      provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*+-+*/
+#if !DOXYGEN
+#if !(__cplusplus >= 201703L)
+#error "preform/static_concurrent_queue.hpp requires >=C++17"
+#endif // #if !(__cplusplus >= 201703L)
+#endif // #if !DOXYGEN
+#pragma once
+#ifndef PREFORM_STATIC_CONCURRENT_QUEUE_HPP
+#define PREFORM_STATIC_CONCURRENT_QUEUE_HPP
+
+// for std::min
+#include <algorithm>
+
+// for std::atomic
+#include <atomic>
+
+// for std::size_t
+#include <cstddef>
+
+// for std::is_default_constructible, std::is_move_assignable, ...
+#include <type_traits>
+
+// for std::move
+#include <utility>
+
+namespace pre {
+
+/**
+ * @defgroup static_concurrent_queue Static concurrent queue
+ *
+ * `<preform/static_concurrent_queue.hpp>`
+ *
+ * __C++ version__: >=C++17
+ *
+ * Lock-free bounded queues, with the same fixed-capacity, no-allocation
+ * design as `static_queue`, to pass work between threads. Head and tail
+ * indices sit on separate cache lines, so producers and consumers do
+ * not invalidate each other's lines on every operation, and batch
+ * push and pop amortize synchronization over many elements.
+ */
+/**@{*/
+
+/**
+ * @brief Static single-producer single-consumer queue.
+ *
+ * Ring of `N` elements. The producer owns the tail index and the
+ * consumer owns the head index, and each keeps a cached copy of
+ * the other's index, refreshing it only when the ring appears full
+ * or empty, so that most operations touch no shared cache line.
+ *
+ * @note
+ * At most one thread may push and at most one thread may pop at a
+ * time. Operations never block: pushing into a full queue and popping
+ * from an empty queue fail.
+ *
+ * @tparam T
+ * Queue value type, which must be
+ * - default constructible,
+ * - move assignable, and
+ * - destructible.
+ *
+ * @tparam N
+ * Queue capacity, which must be a power of 2.
+ */
+template <typename T, std::size_t N>
+class static_spsc_queue
+{
+public:
+
+    // Sanity check.
+    static_assert(N > 0 && (N & (N - 1)) == 0, "N must be a power of 2");
+
+    // Sanity check.
+    static_assert(
+        std::is_default_constructible<T>::value &&
+        std::is_move_assignable<T>::value &&
+        std::is_destructible<T>::value,
+        "T must be default constructible, move assignable, and "
+        "destructible.");
+
+    /**
+     * @brief Size type.
+     */
+    typedef std::size_t size_type;
+
+    /**
+     * @brief Value type.
+     */
+    typedef T value_type;
+
+    /**
+     * @brief Cache line size.
+     */
+    static constexpr size_type cache_line_size = 64;
+
+public:
+
+    /**
+     * @brief Default constructor.
+     */
+    static_spsc_queue() = default;
+
+    /**
+     * @brief Non-copyable.
+     */
+    static_spsc_queue(const static_spsc_queue&) = delete;
+
+public:
+
+    /**
+     * @brief Capacity.
+     */
+    constexpr size_type capacity() const noexcept
+    {
+        return N;
+    }
+
+    /**
+     * @brief Size.
+     *
+     * @note
+     * Approximate if other threads are pushing or popping.
+     */
+    size_type size() const noexcept
+    {
+        size_type head = head_.load(std::memory_order_acquire);
+        size_type tail = tail_.load(std::memory_order_acquire);
+        return tail - head;
+    }
+
+    /**
+     * @brief Empty?
+     *
+     * @note
+     * Approximate if other threads are pushing or popping.
+     */
+    bool empty() const noexcept
+    {
+        return size() == 0;
+    }
+
+    /**
+     * @brief Try to push, from producer thread.
+     *
+     * @returns
+     * False if full.
+     */
+    template <typename U>
+    bool try_push(U&& val)
+    {
+        size_type tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_cache_ == N) {
+            head_cache_ = head_.load(std::memory_order_acquire);
+            if (tail - head_cache_ == N) {
+                return false;
+            }
+        }
+        arr_[tail & (N - 1)] = std::forward<U>(val);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Try to pop, from consumer thread.
+     *
+     * @returns
+     * False if empty.
+     */
+    bool try_pop(value_type& val)
+    {
+        size_type head = head_.load(std::memory_order_relaxed);
+        if (head == tail_cache_) {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+            if (head == tail_cache_) {
+                return false;
+            }
+        }
+        val = std::move(arr_[head & (N - 1)]);
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Push as many as possible of `n` values, from producer
+     * thread, moving from `vals`.
+     *
+     * @returns
+     * Count pushed.
+     */
+    size_type push_many(value_type* vals, size_type n)
+    {
+        size_type tail = tail_.load(std::memory_order_relaxed);
+        if (N - (tail - head_cache_) < n) {
+            head_cache_ = head_.load(std::memory_order_acquire);
+        }
+        size_type m = std::min(n, N - (tail - head_cache_));
+        for (size_type k = 0; k < m; k++) {
+            arr_[(tail + k) & (N - 1)] = std::move(vals[k]);
+        }
+        if (m > 0) {
+            tail_.store(tail + m, std::memory_order_release);
+        }
+        return m;
+    }
+
+    /**
+     * @brief Pop as many as possible of `n` values, from consumer
+     * thread, moving into `vals`.
+     *
+     * @returns
+     * Count popped.
+     */
+    size_type pop_many(value_type* vals, size_type n)
+    {
+        size_type head = head_.load(std::memory_order_relaxed);
+        if (tail_cache_ - head < n) {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+        }
+        size_type m = std::min(n, tail_cache_ - head);
+        for (size_type k = 0; k < m; k++) {
+            vals[k] = std::move(arr_[(head + k) & (N - 1)]);
+        }
+        if (m > 0) {
+            head_.store(head + m, std::memory_order_release);
+        }
+        return m;
+    }
+
+private:
+
+    /**
+     * @brief Head index, owned by consumer.
+     */
+    alignas(cache_line_size) std::atomic<size_type> head_ = {0};
+
+    /**
+     * @brief Tail index cache, owned by consumer.
+     */
+    size_type tail_cache_ = 0;
+
+    /**
+     * @brief Tail index, owned by producer.
+     */
+    alignas(cache_line_size) std::atomic<size_type> tail_ = {0};
+
+    /**
+     * @brief Head index cache, owned by producer.
+     */
+    size_type head_cache_ = 0;
+
+    /**
+     * @brief Array.
+     */
+    alignas(cache_line_size) value_type arr_[N] = {};
+};
+
+/**
+ * @brief Static multi-producer multi-consumer queue.
+ *
+ * Ring of `N` cells, after Vyukov's bounded queue. Each cell carries
+ * a sequence number which says whether it is ready for the producer
+ * or the consumer of a given position, so producers and consumers
+ * each claim positions with compare-and-swap on their own index, and
+ * synchronize through the claimed cells only. Batch operations claim
+ * runs of consecutive ready cells with one compare-and-swap.
+ *
+ * @note
+ * Operations never block: pushing into a full queue and popping from
+ * an empty queue fail. The queue is lock-free in that some thread always
+ * makes progress, but a thread preempted between claiming and publishing
+ * a cell delays consumers of that cell.
+ *
+ * @tparam T
+ * Queue value type, which must be
+ * - default constructible,
+ * - move assignable, and
+ * - destructible.
+ *
+ * @tparam N
+ * Queue capacity, which must be a power of 2.
+ */
+template <typename T, std::size_t N>
+class static_mpmc_queue
+{
+public:
+
+    // Sanity check.
+    static_assert(N > 0 && (N & (N - 1)) == 0, "N must be a power of 2");
+
+    // Sanity check.
+    static_assert(
+        std::is_default_constructible<T>::value &&
+        std::is_move_assignable<T>::value &&
+        std::is_destructible<T>::value,
+        "T must be default constructible, move assignable, and "
+        "destructible.");
+
+    /**
+     * @brief Size type.
+     */
+    typedef std::size_t size_type;
+
+    /**
+     * @brief Value type.
+     */
+    typedef T value_type;
+
+    /**
+     * @brief Cache line size.
+     */
+    static constexpr size_type cache_line_size = 64;
+
+public:
+
+    /**
+     * @brief Default constructor.
+     */
+    static_mpmc_queue()
+    {
+        for (size_type k = 0; k < N; k++) {
+            cells_[k].seq.store(k, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Non-copyable.
+     */
+    static_mpmc_queue(const static_mpmc_queue&) = delete;
+
+public:
+
+    /**
+     * @brief Capacity.
+     */
+    constexpr size_type capacity() const noexcept
+    {
+        return N;
+    }
+
+    /**
+     * @brief Size.
+     *
+     * @note
+     * Approximate if other threads are pushing or popping.
+     */
+    size_type size() const noexcept
+    {
+        size_type head = head_.load(std::memory_order_acquire);
+        size_type tail = tail_.load(std::memory_order_acquire);
+        return tail > head ? tail - head : 0;
+    }
+
+    /**
+     * @brief Empty?
+     *
+     * @note
+     * Approximate if other threads are pushing or popping.
+     */
+    bool empty() const noexcept
+    {
+        return size() == 0;
+    }
+
+    /**
+     * @brief Try to push.
+     *
+     * @returns
+     * False if full.
+     */
+    template <typename U>
+    bool try_push(U&& val)
+    {
+        size_type pos = tail_.load(std::memory_order_relaxed);
+        if (claim_(tail_, pos, 1, 0) == 0) {
+            return false;
+        }
+        cell_type& cell = cells_[pos & (N - 1)];
+        cell.value = std::forward<U>(val);
+        cell.seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Try to pop.
+     *
+     * @returns
+     * False if empty.
+     */
+    bool try_pop(value_type& val)
+    {
+        size_type pos = head_.load(std::memory_order_relaxed);
+        if (claim_(head_, pos, 1, 1) == 0) {
+            return false;
+        }
+        cell_type& cell = cells_[pos & (N - 1)];
+        val = std::move(cell.value);
+        cell.seq.store(pos + N, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Push as many as possible of `n` values, moving from `vals`.
+     *
+     * @returns
+     * Count pushed, which values are contiguous in the queue.
+     */
+    size_type push_many(value_type* vals, size_type n)
+    {
+        size_type pos = tail_.load(std::memory_order_relaxed);
+        size_type m = claim_(tail_, pos, n, 0);
+        for (size_type k = 0; k < m; k++) {
+            cell_type& cell = cells_[(pos + k) & (N - 1)];
+            cell.value = std::move(vals[k]);
+            cell.seq.store(pos + k + 1, std::memory_order_release);
+        }
+        return m;
+    }
+
+    /**
+     * @brief Pop as many as possible of `n` values, moving into `vals`.
+     *
+     * @returns
+     * Count popped.
+     */
+    size_type pop_many(value_type* vals, size_type n)
+    {
+        size_type pos = head_.load(std::memory_order_relaxed);
+        size_type m = claim_(head_, pos, n, 1);
+        for (size_type k = 0; k < m; k++) {
+            cell_type& cell = cells_[(pos + k) & (N - 1)];
+            vals[k] = std::move(cell.value);
+            cell.seq.store(pos + k + N, std::memory_order_release);
+        }
+        return m;
+    }
+
+private:
+
+    /**
+     * @brief Cell.
+     */
+    struct cell_type
+    {
+        /**
+         * @brief Sequence number.
+         *
+         * For position @f$ p @f$ of the cell, this is @f$ p @f$ when
+         * ready for the producer, and @f$ p + 1 @f$ when ready for the
+         * consumer.
+         */
+        std::atomic<size_type> seq;
+
+        /**
+         * @brief Value.
+         */
+        value_type value = {};
+    };
+
+    /**
+     * @brief Head index, shared by consumers.
+     */
+    alignas(cache_line_size) std::atomic<size_type> head_ = {0};
+
+    /**
+     * @brief Tail index, shared by producers.
+     */
+    alignas(cache_line_size) std::atomic<size_type> tail_ = {0};
+
+    /**
+     * @brief Cells.
+     */
+    alignas(cache_line_size) cell_type cells_[N];
+
+#if !DOXYGEN
+
+    /**
+     * @brief Claim up to `n` consecutive positions from index, which
+     * are ready when their sequence numbers are position plus `lag`.
+     *
+     * @param[in] index
+     * Index.
+     *
+     * @param[inout] pos
+     * Position, updated to first claimed position.
+     *
+     * @returns
+     * Count claimed.
+     */
+    size_type claim_(
+            std::atomic<size_type>& index,
+            size_type& pos,
+            size_type n,
+            size_type lag)
+    {
+        while (true) {
+
+            // Count ready cells.
+            size_type m = 0;
+            bool stale = false;
+            while (m < n && m < N) {
+                size_type seq =
+                    cells_[(pos + m) & (N - 1)].seq.load(
+                    std::memory_order_acquire);
+                if (seq != pos + m + lag) {
+                    // Sequence ahead of position means another thread
+                    // already claimed it, so the position is stale.
+                    stale = m == 0 && seq > pos + lag;
+                    break;
+                }
+                m++;
+            }
+            if (m == 0) {
+                if (!stale) {
+                    return 0; // Full or empty.
+                }
+                pos = index.load(std::memory_order_relaxed);
+                continue;
+            }
+            if (index.compare_exchange_weak(
+                        pos, pos + m,
+                        std::memory_order_relaxed,
+                        std::memory_order_relaxed)) {
+                return m;
+            }
+        }
+    }
+
+#endif // #if !DOXYGEN
+};
+
+/**@}*/
+
+} // namespace pre
+
+#endif // #ifndef PREFORM_STATIC_CONCURRENT_QUEUE_HPP
@@ -0,0 +1,870 @@
+/* Copyright (c) 2018-20 M. Grady Saunders
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer.
+ *
+ *   2. Redistributions in binary form must reproduce the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer in the documentation and/or other materials
+ *      provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*+-+*/
+#if !DOXYGEN
+#if !(__cplusplus >= 201703L)
+#error "preform/texture_cache.hpp requires >=C++17"
+#endif // #if !(__cplusplus >= 201703L)
+#endif // #if !DOXYGEN
+#pragma once
+#ifndef PREFORM_TEXTURE_CACHE_HPP
+#define PREFORM_TEXTURE_CACHE_HPP
+
+// for std::atomic
+#include <atomic>
+
+// for std::function
+#include <functional>
+
+// for std::list
+#include <list>
+
+// for std::shared_ptr
+#include <memory>
+
+// for std::mutex, std::once_flag, std::call_once
+#include <mutex>
+
+// for std::invalid_argument
+#include <stdexcept>
+
+// for std::unordered_map
+#include <unordered_map>
+
+// for std::vector
+#include <vector>
+
+// for pre::image2, pre::image_storage_traits
+#include <preform/image2.hpp>
+
+namespace pre {
+
+/**
+ * @defgroup texture_cache Texture cache
+ *
+ * `<preform/texture_cache.hpp>`
+ *
+ * __C++ version__: >=C++17
+ */
+/**@{*/
+
+/**
+ * @brief Texture cache.
+ *
+ * Cache of square tiles of mipmapped textures, which loads tiles
+ * lazily on first lookup and evicts least recently used tiles once
+ * the resident tiles exceed a fixed byte budget. The working set is
+ * thus bounded, however large the textures.
+ *
+ * Lookups are safe for any number of threads at once. Tiles are
+ * distributed over independently locked shards, each with its own
+ * LRU list, and loading happens outside of any shard lock, exactly
+ * once per tile. Evicted tiles stay alive until the last lookup
+ * using them returns.
+ *
+ * The budget is global. A miss evicts from the LRU end of its own
+ * shard first, then from the other shards in turn, so eviction order
+ * is only approximately least recently used across shards. The tile
+ * just loaded is never evicted, so the resident bytes exceed the
+ * budget by at most one tile per thread missing at once.
+ *
+ * Texture coordinates are normalized, such that @f$ [0, 1]^2 @f$
+ * covers the texture, and boundaries follow the cycle mode of the
+ * texture, as in `image2`.
+ *
+ * @note
+ * Textures must be added before any concurrent lookups.
+ */
+template <
+    typename Tfloat,
+    typename T, std::size_t N,
+    typename Talloc = std::allocator<T>
+    >
+class texture_cache
+{
+public:
+
+    /**
+     * @brief Float type.
+     */
+    typedef Tfloat float_type;
+
+    /**
+     * @brief Size type.
+     */
+    typedef std::size_t size_type;
+
+    /**
+     * @brief Image type, for each tile.
+     */
+    typedef image2<Tfloat, T, N, Talloc> image_type;
+
+    /**
+     * @brief Tile loader type.
+     *
+     * Fills a tile, already sized, with texels of the given level
+     * starting at the given origin.
+     */
+    typedef std::function<
+            void(int level, multi<size_type, 2> origin, image_type& tile)>
+                loader_type;
+
+public:
+
+    /**
+     * @brief Constructor.
+     *
+     * @param[in] byte_budget
+     * Budget for resident tiles, in bytes.
+     *
+     * @param[in] tile_size
+     * Tile size, in texels.
+     */
+    explicit texture_cache(
+            size_type byte_budget,
+            size_type tile_size = 64) :
+                byte_budget_(byte_budget),
+                tile_size_(tile_size)
+    {
+        if (tile_size_ == 0) {
+            throw std::invalid_argument(__PRETTY_FUNCTION__);
+        }
+    }
+
+    /**
+     * @brief Non-copyable.
+     */
+    texture_cache(const texture_cache&) = delete;
+
+public:
+
+    /**
+     * @brief Add texture.
+     *
+     * @param[in] level_sizes
+     * Size of each mip level, starting from the finest.
+     *
+     * @param[in] loader
+     * Tile loader.
+     *
+     * @param[in] cycle_mode
+     * Cycle mode, as in `image2`.
+     *
+     * @returns
+     * Texture index.
+     *
+     * @throw std::invalid_argument
+     * If there are no levels, or any level is empty.
+     */
+    size_type add_texture(
+            std::vector<multi<size_type, 2>> level_sizes,
+            loader_type loader,
+            multi<int, 2> cycle_mode = {})
+    {
+        if (level_sizes.empty()) {
+            throw std::invalid_argument(__PRETTY_FUNCTION__);
+        }
+        for (const multi<size_type, 2>& level_size : level_sizes) {
+            if ((level_size == size_type(0)).any()) {
+                throw std::invalid_argument(__PRETTY_FUNCTION__);
+            }
+        }
+        textures_.push_back(texture_type{
+                std::move(level_sizes),
+                std::move(loader),
+                cycle_mode});
+        return textures_.size() - 1;
+    }
+
+    /**
+     * @brief Add texture from in-memory mip chain.
+     *
+     * Tiles are copied from the mip chain as needed, e.g., to share a
+     * budget between resident textures and textures loaded from disk.
+     *
+     * @param[in] mips
+     * Mip chain, starting from the finest level.
+     *
+     * @param[in] cycle_mode
+     * Cycle mode, as in `image2`.
+     */
+    size_type add_texture(
+            std::shared_ptr<const std::vector<image_type>> mips,
+            multi<int, 2> cycle_mode = {})
+    {
+        std::vector<multi<size_type, 2>> level_sizes;
+        for (const image_type& mip : *mips) {
+            level_sizes.push_back(mip.user_size());
+        }
+        return add_texture(
+                std::move(level_sizes),
+                [mips](int level,
+                       multi<size_type, 2> origin,
+                       image_type& tile) {
+                    const image_type& mip = (*mips)[level];
+                    for (size_type i = 0; i < tile.user_size()[0]; i++)
+                    for (size_type j = 0; j < tile.user_size()[1]; j++) {
+                        tile(i, j) = mip(origin[0] + i, origin[1] + j);
+                    }
+                },
+                cycle_mode);
+    }
+
+    /**
+     * @brief Texture count.
+     */
+    size_type texture_count() const noexcept
+    {
+        return textures_.size();
+    }
+
+    /**
+     * @brief Level count.
+     */
+    int levels(size_type tex) const
+    {
+        return int(textures_[tex].level_sizes.size());
+    }
+
+    /**
+     * @brief Level size.
+     */
+    multi<size_type, 2> level_size(size_type tex, int level) const
+    {
+        return textures_[tex].level_sizes[level];
+    }
+
+    /**
+     * @brief Drop all resident tiles.
+     *
+     * @note
+     * This is thread-safe.
+     */
+    void clear()
+    {
+        for (shard_type& shard : shards_) {
+            std::unique_lock<std::mutex> lock(shard.mutex);
+            bytes_.fetch_sub(shard.bytes, std::memory_order_relaxed);
+            shard.entries.clear();
+            shard.lru.clear();
+            shard.bytes = 0;
+        }
+    }
+
+    /**
+     * @brief Bytes in resident tiles.
+     */
+    size_type bytes_used() const noexcept
+    {
+        return bytes_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Tile lookups that found a resident tile.
+     */
+    size_type hits() const noexcept
+    {
+        return hits_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Tile lookups that loaded a tile.
+     */
+    size_type misses() const noexcept
+    {
+        return misses_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Tiles evicted.
+     */
+    size_type evictions() const noexcept
+    {
+        return evictions_.load(std::memory_order_relaxed);
+    }
+
+public:
+
+    /**
+     * @name Lookups
+     */
+    /**@{*/
+
+    /**
+     * @brief Fetch texel.
+     *
+     * @param[in] tex
+     * Texture index.
+     *
+     * @param[in] level
+     * Level, clamped to range.
+     *
+     * @param[in] ind
+     * Texel index, cycled to range.
+     */
+    multi<float_type, N> fetch(
+            size_type tex, int level, multi<int, 2> ind) const
+    {
+        tile_cursor cursor;
+        return fetch(cursor, tex, clamp(level, levels(tex)), ind);
+    }
+
+    /**
+     * @brief Sample, linear interpolation within level.
+     *
+     * @param[in] tex
+     * Texture index.
+     *
+     * @param[in] level
+     * Level, clamped to range.
+     *
+     * @param[in] uv
+     * Texture coordinates.
+     */
+    multi<float_type, N> sample_bilinear(
+            size_type tex, int level, multi<float_type, 2> uv) const
+    {
+        tile_cursor cursor;
+        return sample_bilinear(cursor, tex, clamp(level, levels(tex)), uv);
+    }
+
+    /**
+     * @brief Sample, linear interpolation within and across levels.
+     *
+     * @param[in] tex
+     * Texture index.
+     *
+     * @param[in] uv
+     * Texture coordinates.
+     *
+     * @param[in] lod
+     * Level of detail, the fractional level.
+     */
+    multi<float_type, N> sample_trilinear(
+            size_type tex,
+            multi<float_type, 2> uv,
+            float_type lod) const
+    {
+        tile_cursor cursor;
+        return sample_trilinear(cursor, tex, uv, lod);
+    }
+
+    /**
+     * @brief Sample, linear interpolation within and across levels,
+     * choosing level of detail from screen-space derivatives.
+     *
+     * @param[in] tex
+     * Texture index.
+     *
+     * @param[in] uv
+     * Texture coordinates.
+     *
+     * @param[in] duvdx
+     * Texture coordinate derivatives with respect to @f$ x @f$.
+     *
+     * @param[in] duvdy
+     * Texture coordinate derivatives with respect to @f$ y @f$.
+     */
+    multi<float_type, N> sample_trilinear(
+            size_type tex,
+            multi<float_type, 2> uv,
+            multi<float_type, 2> duvdx,
+            multi<float_type, 2> duvdy) const
+    {
+        multi<float_type, 2> size0 = level_size(tex, 0);
+        float_type len =
+            std::max(
+                length(duvdx * size0),
+                length(duvdy * size0));
+        return sample_trilinear(tex, uv, lod_of(len));
+    }
+
+    /**
+     * @brief Sample, anisotropic filtering.
+     *
+     * Choose level of detail from the minor axis of the footprint,
+     * then average trilinear samples along the major axis.
+     *
+     * @param[in] tex
+     * Texture index.
+     *
+     * @param[in] uv
+     * Texture coordinates.
+     *
+     * @param[in] duvdx
+     * Texture coordinate derivatives with respect to @f$ x @f$.
+     *
+     * @param[in] duvdy
+     * Texture coordinate derivatives with respect to @f$ y @f$.
+     *
+     * @param[in] max_aniso
+     * Maximum anisotropy, which is also the maximum sample count.
+     */
+    multi<float_type, N> sample_anisotropic(
+            size_type tex,
+            multi<float_type, 2> uv,
+            multi<float_type, 2> duvdx,
+            multi<float_type, 2> duvdy,
+            int max_aniso = 8) const
+    {
+        multi<float_type, 2> size0 = level_size(tex, 0);
+        float_type lenx = length(duvdx * size0);
+        float_type leny = length(duvdy * size0);
+        multi<float_type, 2> major = duvdx;
+        float_type len_major = lenx;
+        float_type len_minor = leny;
+        if (lenx < leny) {
+            major = duvdy;
+            len_major = leny;
+            len_minor = lenx;
+        }
+        if (max_aniso < 1) {
+            max_aniso = 1;
+        }
+        len_minor = std::max(len_minor, len_major / float_type(max_aniso));
+
+        // Sample count.
+        int count = 1;
+        if (len_minor > 0) {
+            count = std::min(
+                    int(fastceil(len_major / len_minor)), max_aniso);
+            count = std::max(count, 1);
+        }
+
+        // Average along major axis.
+        tile_cursor cursor;
+        float_type lod = lod_of(len_minor);
+        multi<float_type, N> res = {};
+        for (int k = 0; k < count; k++) {
+            float_type t = (float_type(k) + float_type(0.5)) /
+                            float_type(count) - float_type(0.5);
+            res += sample_trilinear(cursor, tex, uv + t * major, lod);
+        }
+        return res / float_type(count);
+    }
+
+    /**@}*/
+
+private:
+
+    /**
+     * @brief Texture.
+     */
+    struct texture_type
+    {
+        /**
+         * @brief Level sizes.
+         */
+        std::vector<multi<size_type, 2>> level_sizes;
+
+        /**
+         * @brief Loader.
+         */
+        loader_type loader;
+
+        /**
+         * @brief Cycle mode.
+         */
+        multi<int, 2> cycle_mode = {};
+    };
+
+    /**
+     * @brief Tile key.
+     */
+    struct tile_key
+    {
+        /**
+         * @brief Texture index.
+         */
+        std::uint32_t tex = 0;
+
+        /**
+         * @brief Level.
+         */
+        std::uint32_t level = 0;
+
+        /**
+         * @brief Tile index.
+         */
+        std::uint32_t tile[2] = {};
+
+        /**
+         * @brief Equal?
+         */
+        bool operator==(const tile_key& other) const noexcept
+        {
+            return tex == other.tex &&
+                   level == other.level &&
+                   tile[0] == other.tile[0] &&
+                   tile[1] == other.tile[1];
+        }
+
+        /**
+         * @brief Hash.
+         */
+        std::size_t hash() const noexcept
+        {
+            std::uint64_t h =
+                (std::uint64_t(tex) << 40) ^
+                (std::uint64_t(level) << 32) ^
+                (std::uint64_t(tile[0]) << 16) ^
+                (std::uint64_t(tile[1]));
+            h *= 0x9e3779b97f4a7c15ULL;
+            return std::size_t(h ^ (h >> 29));
+        }
+    };
+
+    /**
+     * @brief Tile key hasher.
+     */
+    struct tile_key_hash
+    {
+        std::size_t operator()(const tile_key& key) const noexcept
+        {
+            return key.hash();
+        }
+    };
+
+    /**
+     * @brief Tile, loaded exactly once.
+     */
+    struct tile_type
+    {
+        /**
+         * @brief Once flag.
+         */
+        std::once_flag once;
+
+        /**
+         * @brief Image.
+         */
+        image_type image;
+    };
+
+    /**
+     * @brief Shard entry.
+     */
+    struct entry_type
+    {
+        /**
+         * @brief Tile.
+         */
+        std::shared_ptr<tile_type> tile;
+
+        /**
+         * @brief Position in LRU list.
+         */
+        typename std::list<tile_key>::iterator lru_itr;
+
+        /**
+         * @brief Bytes.
+         */
+        size_type bytes = 0;
+    };
+
+    /**
+     * @brief Shard.
+     */
+    struct shard_type
+    {
+        /**
+         * @brief Mutex.
+         */
+        mutable std::mutex mutex;
+
+        /**
+         * @brief Entries.
+         */
+        std::unordered_map<tile_key, entry_type, tile_key_hash> entries;
+
+        /**
+         * @brief Keys, most recently used first.
+         */
+        std::list<tile_key> lru;
+
+        /**
+         * @brief Bytes.
+         */
+        size_type bytes = 0;
+    };
+
+    /**
+     * @brief Cursor, remembering most recent tile of a lookup.
+     */
+    struct tile_cursor
+    {
+        /**
+         * @brief Key.
+         */
+        tile_key key;
+
+        /**
+         * @brief Tile, or `nullptr`.
+         */
+        std::shared_ptr<tile_type> tile;
+    };
+
+    /**
+     * @brief Shard count.
+     */
+    static constexpr size_type shard_count = 16;
+
+    /**
+     * @brief Byte budget.
+     */
+    size_type byte_budget_ = 0;
+
+    /**
+     * @brief Tile size.
+     */
+    size_type tile_size_ = 0;
+
+    /**
+     * @brief Textures.
+     */
+    std::vector<texture_type> textures_;
+
+    /**
+     * @brief Shards.
+     */
+    mutable shard_type shards_[shard_count];
+
+    /**
+     * @brief Bytes in resident tiles, over all shards.
+     */
+    mutable std::atomic<size_type> bytes_ = {0};
+
+    /**
+     * @brief Hits.
+     */
+    mutable std::atomic<size_type> hits_ = {0};
+
+    /**
+     * @brief Misses.
+     */
+    mutable std::atomic<size_type> misses_ = {0};
+
+    /**
+     * @brief Evictions.
+     */
+    mutable std::atomic<size_type> evictions_ = {0};
+
+#if !DOXYGEN
+
+    /**
+     * @brief Length.
+     */
+    static float_type length(multi<float_type, 2> v)
+    {
+        return pre::sqrt(dot(v, v));
+    }
+
+    /**
+     * @brief Level of detail from footprint length in texels.
+     */
+    static float_type lod_of(float_type len)
+    {
+        return len > 1 ? pre::log2(len) : float_type(0);
+    }
+
+    /**
+     * @brief Evict least recently used tiles of locked shard, while
+     * over budget, keeping the given number of most recently used.
+     */
+    void evict(shard_type& shard, size_type keep) const
+    {
+        while (bytes_.load(std::memory_order_relaxed) > byte_budget_ &&
+               shard.lru.size() > keep) {
+            auto itr = shard.entries.find(shard.lru.back());
+            shard.bytes -= itr->second.bytes;
+            bytes_.fetch_sub(itr->second.bytes, std::memory_order_relaxed);
+            shard.entries.erase(itr);
+            shard.lru.pop_back();
+            evictions_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Find or load tile.
+     */
+    const image_type& find_tile(
+            tile_cursor& cursor,
+            size_type tex, int level,
+            multi<size_type, 2> tile) const
+    {
+        tile_key key;
+        key.tex = std::uint32_t(tex);
+        key.level = std::uint32_t(level);
+        key.tile[0] = std::uint32_t(tile[0]);
+        key.tile[1] = std::uint32_t(tile[1]);
+        if (cursor.tile && cursor.key == key) {
+            return cursor.tile->image;
+        }
+
+        // Find or insert.
+        const texture_type& texture = textures_[tex];
+        multi<size_type, 2> origin = tile * tile_size_;
+        multi<size_type, 2> count =
+            pre::min(
+                multi<size_type, 2>(tile_size_),
+                texture.level_sizes[level] - origin);
+        size_type shard_index = key.hash() % shard_count;
+        shard_type& shard = shards_[shard_index];
+        std::shared_ptr<tile_type> found;
+        bool inserted = false;
+        {
+            std::unique_lock<std::mutex> lock(shard.mutex);
+            auto itr = shard.entries.find(key);
+            if (itr != shard.entries.end()) {
+                hits_.fetch_add(1, std::memory_order_relaxed);
+                shard.lru.splice(
+                    shard.lru.begin(), shard.lru, itr->second.lru_itr);
+                found = itr->second.tile;
+            }
+            else {
+                misses_.fetch_add(1, std::memory_order_relaxed);
+                found = std::make_shared<tile_type>();
+                shard.lru.push_front(key);
+                entry_type entry;
+                entry.tile = found;
+                entry.lru_itr = shard.lru.begin();
+                entry.bytes = count.prod() *
+                    sizeof(typename image_type::value_type);
+                shard.bytes += entry.bytes;
+                bytes_.fetch_add(entry.bytes, std::memory_order_relaxed);
+                shard.entries.emplace(key, std::move(entry));
+                inserted = true;
+
+                // Evict, but never the tile just inserted.
+                evict(shard, 1);
+            }
+        }
+
+        // Evict from other shards, one lock at a time.
+        if (inserted) {
+            for (size_type offset = 1;
+                           offset < shard_count &&
+                           bytes_.load(std::memory_order_relaxed) >
+                           byte_budget_; offset++) {
+                shard_type& other =
+                    shards_[(shard_index + offset) % shard_count];
+                std::unique_lock<std::mutex> lock(other.mutex);
+                evict(other, 0);
+            }
+        }
+
+        // Load, outside of lock.
+        std::call_once(found->once, [&]() {
+            found->image.resize(count);
+            texture.loader(level, origin, found->image);
+        });
+        cursor.key = key;
+        cursor.tile = std::move(found);
+        return cursor.tile->image;
+    }
+
+    /**
+     * @brief Fetch texel.
+     */
+    multi<float_type, N> fetch(
+            tile_cursor& cursor,
+            size_type tex, int level,
+            multi<int, 2> ind) const
+    {
+        const texture_type& texture = textures_[tex];
+        multi<size_type, 2> size = texture.level_sizes[level];
+        for (int l = 0; l < 2; l++) {
+            switch (texture.cycle_mode[l]) {
+                default:
+                case 0:  ind[l] = clamp(ind[l], int(size[l])); break;
+                case +1: ind[l] = repeat(ind[l], int(size[l])); break;
+                case -1: ind[l] = mirror(ind[l], int(size[l])); break;
+            }
+        }
+        multi<size_type, 2> loc = ind;
+        const image_type& tile =
+            find_tile(cursor, tex, level, loc / tile_size_);
+        loc %= tile_size_;
+        return image_storage_traits<T>::template decode<float_type>(
+                    tile(loc[0], loc[1]));
+    }
+
+    /**
+     * @brief Sample, linear interpolation within level.
+     */
+    multi<float_type, N> sample_bilinear(
+            tile_cursor& cursor,
+            size_type tex, int level,
+            multi<float_type, 2> uv) const
+    {
+        multi<float_type, 2> loc =
+            uv * multi<float_type, 2>(level_size(tex, level)) -
+            float_type(0.5);
+        multi<int, 2> ind = fastfloor(loc);
+        loc -= ind;
+        multi<float_type, N> val[2][2];
+        for (int i = 0; i < 2; i++)
+        for (int j = 0; j < 2; j++) {
+            val[i][j] = fetch(cursor, tex, level, ind + multi<int, 2>{i, j});
+        }
+        return lerp(loc[0],
+                    lerp(loc[1], val[0][0], val[0][1]),
+                    lerp(loc[1], val[1][0], val[1][1]));
+    }
+
+    /**
+     * @brief Sample, linear interpolation within and across levels.
+     */
+    multi<float_type, N> sample_trilinear(
+            tile_cursor& cursor,
+            size_type tex,
+            multi<float_type, 2> uv,
+            float_type lod) const
+    {
+        int last = levels(tex) - 1;
+        if (!(lod > 0)) {
+            return sample_bilinear(cursor, tex, 0, uv);
+        }
+        if (!(lod < float_type(last))) {
+            return sample_bilinear(cursor, tex, last, uv);
+        }
+        int level = int(lod);
+        float_type t = lod - float_type(level);
+        return lerp(t,
+                    sample_bilinear(cursor, tex, level, uv),
+                    sample_bilinear(cursor, tex, level + 1, uv));
+    }
+
+#endif // #if !DOXYGEN
+};
+
+/**@}*/
+
+} // namespace pre
+
+#endif // #ifndef PREFORM_TEXTURE_CACHE_HPP
@@ -38,9 +38,15 @@
 // for std::chrono::milliseconds
 #include <chrono>
 
-// for std::shared_ptr
+// for std::shared_ptr, std::unique_ptr
 #include <memory>
 
+// for std::min
+#include <algorithm>
+
+// for std::memcpy
+#include <cstring>
+
 // for std::vector
 #include <vector>
 
@@ -53,15 +59,46 @@
 // for std::mutex
 #include <mutex>
 
-// for std::queue
-#include <queue>
+// for std::deque
+#include <deque>
+
+// for std::atomic
+#include <atomic>
 
 // for std::condition_variable
 #include <condition_variable>
 
-// for std::function
+// for std::bind
 #include <functional>
 
+// for std::exception_ptr
+#include <exception>
+
+// for std::decay, std::integral_constant
+#include <type_traits>
+
+// for std::ifstream
+#include <fstream>
+
+// for std::string
+#include <string>
+
+#if defined(__linux__)
+
+// for pthread_setaffinity_np
+#include <pthread.h>
+
+// for cpu_set_t, CPU_ZERO, CPU_SET
+#include <sched.h>
+
+#endif // #if defined(__linux__)
+
+// for pre::memory_pool
+#include <preform/memory_pool.hpp>
+
+// for pre::memory_arena
+#include <preform/memory_arena.hpp>
+
 namespace pre {
 
 /**
@@ -73,6 +110,61 @@ namespace pre {
  */
 /**@{*/
 
+/**
+ * @brief Thread pool scheduling mode.
+ */
+enum class thread_pool_mode {
+
+    /**
+     * @brief Every worker pops from one shared queue.
+     */
+    shared_queue,
+
+    /**
+     * @brief Every worker pops from its own deque, and steals
+     * from other deques when idle.
+     *
+     * Tasks submitted from inside a task go to the local deque of
+     * the submitting worker, where they are popped last-in first-out.
+     * Tasks submitted from outside the pool are distributed round-robin.
+     * Idle workers steal first-in first-out from the other deques.
+     */
+    work_stealing
+};
+
+/**
+ * @brief Thread pool affinity policy.
+ *
+ * Unless the policy is `none`, workers are grouped into NUMA nodes
+ * in contiguous blocks. On Linux, NUMA nodes are read from
+ * `/sys/devices/system/node`, and workers are pinned with
+ * `pthread_setaffinity_np()`. Elsewhere, all cores form one node and
+ * workers are not pinned.
+ */
+enum class thread_pool_affinity {
+
+    /**
+     * @brief Let the OS schedule workers, as one node.
+     */
+    none,
+
+    /**
+     * @brief Pin every worker to one core of its node.
+     */
+    core,
+
+    /**
+     * @brief Pin every worker to all cores of its node.
+     */
+    numa_node
+};
+
+#if !DOXYGEN
+
+class task_group;
+
+#endif // #if !DOXYGEN
+
 /**
  * @brief Thread pool.
  */
@@ -86,17 +178,87 @@ public:
      * @param[in] n
      * Number of threads. If less than 1, uses
      * `std::thread::hardware_concurrency()`.
+     *
+     * @param[in] mode
+     * Scheduling mode.
+     *
+     * @param[in] affinity
+     * Affinity policy.
      */
-    thread_pool(int n = 0)
+    thread_pool(
+            int n = 0,
+            thread_pool_mode mode = thread_pool_mode::shared_queue,
+            thread_pool_affinity affinity = thread_pool_affinity::none) :
+                mode_(mode),
+                affinity_(affinity)
     {
         if (n < 1) {
             n = std::thread::hardware_concurrency();
         }
+        if (n < 1) {
+            n = 1;
+        }
+
+        // Detect nodes.
+        if (affinity_ != thread_pool_affinity::none) {
+            node_cpus_ = detect_node_cpus_();
+        }
+        if (node_cpus_.empty()) {
+            node_cpus_.resize(1);
+        }
+
+        // Assign workers to nodes in contiguous blocks.
+        std::size_t nworkers = n;
+        std::size_t nnodes = node_cpus_.size();
+        worker_nodes_.resize(nworkers);
+        node_workers_.resize(nnodes);
+        for (std::size_t index = 0; index < nworkers; index++) {
+            std::size_t node = index * nnodes / nworkers;
+            worker_nodes_[index] = node;
+            node_workers_[node].push_back(index);
+        }
+
+        // Allocate queues, one shared queue per node or one deque
+        // per worker.
+        std::size_t nqueues =
+                mode_ == thread_pool_mode::work_stealing ?
+                nworkers : nnodes;
+        queues_.reserve(nqueues);
+        for (std::size_t queue = 0; queue < nqueues; queue++) {
+            queues_.emplace_back(new task_queue());
+        }
+
+        // Initialize pop orders, preferring queues on the same node.
+        // The last pop order is for threads outside the pool.
+        pop_orders_.resize(nworkers + 1);
+        for (std::size_t index = 0; index < nworkers; index++) {
+            std::vector<std::size_t>& order = pop_orders_[index];
+            std::size_t node = worker_nodes_[index];
+            for (int same_node = 1; same_node >= 0; same_node--) {
+                for (std::size_t offset = 0;
+                                 offset < nqueues; offset++) {
+                    std::size_t queue = (index + offset) % nqueues;
+                    std::size_t queue_node =
+                        mode_ == thread_pool_mode::work_stealing ?
+                        worker_nodes_[queue] : queue;
+                    if ((queue_node == node) == bool(same_node) &&
+                        !(mode_ == thread_pool_mode::work_stealing &&
+                          queue == index)) {
+                        order.push_back(queue);
+                    }
+                }
+            }
+        }
+        for (std::size_t queue = 0; queue < nqueues; queue++) {
+            pop_orders_[nworkers].push_back(queue);
+        }
 
-        threads_.reserve(n);
+        // Arenas, allocated by each worker.
+        arenas_.resize(nworkers);
 
-        while (n-- > 0) {
-            threads_.emplace_back(worker(*this));
+        threads_.reserve(nworkers);
+        for (std::size_t index = 0; index < nworkers; index++) {
+            threads_.emplace_back(worker(*this, index));
         }
     }
 
@@ -132,27 +294,281 @@ public:
                 std::forward<Args>(args)...))>
 #endif // #if !DOXYGEN
     {
+        // Delegate.
+        return enqueue_future(
+                std::forward<Func>(func),
+                std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Enqueue task, fire-and-forget.
+     *
+     * The bound task is stored inline in a fixed-size task slot
+     * if it fits, so small tasks do not allocate.
+     *
+     * @note
+     * If the task throws, the first such exception is held by the
+     * pool until `rethrow_if_exception()`, instead of escaping the
+     * worker or helping thread.
+     */
+    template <
+        typename Func,
+        typename... Args
+        >
+    inline void enqueue(Func&& func, Args&&... args)
+    {
+        // Delegate.
+        enqueue_to_node(
+                npos,
+                std::forward<Func>(func),
+                std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Enqueue task, with future.
+     *
+     * The bound task and its promise are stored inline in a
+     * fixed-size task slot if they fit, and the promise shared state
+     * is allocated from a pooled slab instead of the heap.
+     *
+     * @returns
+     * `std::future<decltype(std::forward<Func>(func)(std::forward<Args>(args)...))>`.
+     */
+    template <
+        typename Func,
+        typename... Args
+        >
+    inline auto enqueue_future(Func&& func, Args&&... args)
+#if !DOXYGEN
+        -> std::future<decltype(
+                std::forward<Func>(func)(
+                std::forward<Args>(args)...))>
+#endif // #if !DOXYGEN
+    {
+        // Delegate.
+        return submit_to_node(
+                npos,
+                std::forward<Func>(func),
+                std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Enqueue task on node-local queue, fire-and-forget.
+     *
+     * @param[in] node
+     * Node index. If not less than `node_count()`, behaves
+     * as `enqueue()`.
+     */
+    template <
+        typename Func,
+        typename... Args
+        >
+    inline void enqueue_to_node(
+                std::size_t node,
+                Func&& func, Args&&... args)
+    {
+        auto bind =
+                std::bind(
+                std::forward<Func>(func),
+                std::forward<Args>(args)...);
+        push_task_(
+            task_slot(
+            detached_task<decltype(bind)>{this, std::move(bind)}), node);
+    }
+
+    /**
+     * @brief Submit task on node-local queue.
+     *
+     * @param[in] node
+     * Node index. If not less than `node_count()`, behaves
+     * as `submit()`.
+     *
+     * @returns
+     * `std::future<decltype(std::forward<Func>(func)(std::forward<Args>(args)...))>`.
+     */
+    template <
+        typename Func,
+        typename... Args
+        >
+    inline auto submit_to_node(
+                std::size_t node,
+                Func&& func, Args&&... args)
+#if !DOXYGEN
+        -> std::future<decltype(
+                std::forward<Func>(func)(
+                std::forward<Args>(args)...))>
+#endif // #if !DOXYGEN
+    {
+        typedef decltype(
+                std::forward<Func>(func)(
+                std::forward<Args>(args)...)) result_type;
+
         // Bind arguments.
         auto bind =
                 std::bind(
                 std::forward<Func>(func),
                 std::forward<Args>(args)...);
 
-        // Allocate packaged task.
-        auto bind_ptr =
-                std::make_shared<
-                std::packaged_task<decltype(bind())()>>(bind);
+        // Promise task.
+        promise_task<decltype(bind), result_type> task = {
+            std::move(bind),
+            std::promise<result_type>(
+                std::allocator_arg,
+                slab_allocator<char>(slab_))
+        };
+        std::future<result_type> future = task.promise.get_future();
 
         // Push.
-        queue_.push([bind_ptr]() -> void {
-            (*bind_ptr)();
-        });
-
-        // Notify one waiting thread.
-        cv_.notify_one();
+        push_task_(task_slot(std::move(task)), node);
 
         // Return future.
-        return bind_ptr->get_future();
+        return future;
+    }
+
+    /**
+     * @brief Parallel for.
+     *
+     * Split the index range into chunks of `grain` indices, and
+     * invoke `func` on every index. Idle workers and the calling thread
+     * claim chunks dynamically, so chunks of uneven cost balance
+     * out. Returns once every index has been processed.
+     *
+     * @param[in] begin
+     * Index range begin.
+     *
+     * @param[in] end
+     * Index range end.
+     *
+     * @param[in] grain
+     * Indices per chunk. If less than 1, uses 1.
+     *
+     * @param[in] func
+     * Function with signature equivalent to `void(Tint)`.
+     *
+     * @note
+     * This allocates one shared state per call, not one future
+     * per index or per chunk. If `func` throws, the first exception
+     * is rethrown in the calling thread.
+     */
+    template <typename Tint, typename Func>
+    inline void parallel_for(Tint begin, Tint end, Tint grain, Func&& func)
+    {
+        if (!(begin < end)) {
+            return;
+        }
+        if (grain < Tint(1)) {
+            grain = Tint(1);
+        }
+
+        // Chunk count.
+        std::size_t count = std::size_t(end - begin);
+        std::size_t nchunks =
+                (count + std::size_t(grain) - 1) / std::size_t(grain);
+
+        // Chunk function.
+        auto chunk_func = [&](std::size_t chunk) {
+            Tint from = begin + Tint(chunk * std::size_t(grain));
+            Tint to = end - from > grain ? from + grain : end;
+            for (Tint index = from; index < to; ++index) {
+                func(index);
+            }
+        };
+
+        // Delegate.
+        run_chunks_(nchunks, chunk_func);
+    }
+
+    /**
+     * @brief Parallel reduce.
+     *
+     * Split the index range into chunks, accumulate
+     * `combine(acc, func(index))` in each chunk starting from
+     * `identity`, then combine chunk results in index order. Since chunk
+     * boundaries depend only on the range and the number of threads,
+     * the result is deterministic for a given pool.
+     *
+     * @param[in] begin
+     * Index range begin.
+     *
+     * @param[in] end
+     * Index range end.
+     *
+     * @param[in] identity
+     * Identity value of `combine`.
+     *
+     * @param[in] func
+     * Function with signature equivalent to `T(Tint)`.
+     *
+     * @param[in] combine
+     * Function with signature equivalent to `T(const T&, const T&)`.
+     */
+    template <
+        typename Tint,
+        typename T,
+        typename Func,
+        typename Combine
+        >
+    inline T parallel_reduce(
+                Tint begin, Tint end,
+                T identity,
+                Func&& func,
+                Combine&& combine)
+    {
+        if (!(begin < end)) {
+            return identity;
+        }
+
+        // Chunk count, about 4 chunks per thread.
+        std::size_t count = std::size_t(end - begin);
+        std::size_t grain = count / (4 * (size() + 1));
+        if (grain < 1) {
+            grain = 1;
+        }
+        std::size_t nchunks = (count + grain - 1) / grain;
+
+        // Chunk results.
+        std::vector<T> results(nchunks, identity);
+
+        // Chunk function.
+        auto chunk_func = [&](std::size_t chunk) {
+            Tint from = begin + Tint(chunk * grain);
+            Tint to = std::size_t(end - from) > grain ?
+                            from + Tint(grain) : end;
+            T result = identity;
+            for (Tint index = from; index < to; ++index) {
+                result = combine(result, func(index));
+            }
+            results[chunk] = std::move(result);
+        };
+
+        // Delegate.
+        run_chunks_(nchunks, chunk_func);
+
+        // Combine in order.
+        T result = identity;
+        for (const T& chunk_result : results) {
+            result = combine(result, chunk_result);
+        }
+        return result;
+    }
+
+    /**
+     * @brief Rethrow exception from fire-and-forget task, if any.
+     *
+     * @throw
+     * Rethrows the first exception thrown by any task enqueued
+     * without a future since the previous call.
+     */
+    void rethrow_if_exception()
+    {
+        std::exception_ptr error;
+        {
+            std::unique_lock<std::mutex> lock(error_mutex_);
+            std::swap(error, error_);
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
     }
 
     /**
@@ -172,15 +588,489 @@ public:
         }
     }
 
+public:
+
+    /**
+     * @name Accessors
+     */
+    /**@{*/
+
+    /**
+     * @brief Scheduling mode.
+     */
+    thread_pool_mode mode() const
+    {
+        return mode_;
+    }
+
+    /**
+     * @brief Affinity policy.
+     */
+    thread_pool_affinity affinity() const
+    {
+        return affinity_;
+    }
+
+    /**
+     * @brief Number of threads.
+     */
+    std::size_t size() const
+    {
+        return worker_nodes_.size();
+    }
+
+    /**
+     * @brief Number of nodes.
+     */
+    std::size_t node_count() const
+    {
+        return node_cpus_.size();
+    }
+
+    /**
+     * @brief Node of worker.
+     *
+     * @param[in] index
+     * Worker index in `[0, size())`.
+     */
+    std::size_t worker_node(std::size_t index) const
+    {
+        return worker_nodes_[index];
+    }
+
+    /**
+     * @brief Memory arena local to calling thread.
+     *
+     * On a worker thread, returns the arena of that worker. Each
+     * worker constructs its arena on its own thread after pinning, so
+     * initial blocks are first touched on the node of the worker.
+     * On any other thread, returns a thread-local arena.
+     *
+     * @note
+     * The arena is not thread-safe, and must not be shared with
+     * other threads.
+     */
+    static memory_arena<>& local_arena()
+    {
+        worker_info& info = this_worker_();
+        if (info.arena) {
+            return *info.arena;
+        }
+        else {
+            static thread_local memory_arena<> arena;
+            return arena;
+        }
+    }
+
+    /**@}*/
+
 private:
 
     /**
-     * @brief Task.
+     * @brief Task slot size in bytes.
+     */
+    static constexpr std::size_t task_slot_size = 48;
+
+    /**
+     * @brief Task slot.
+     *
+     * Move-only type-erased `void()` callable, which stores callables
+     * of up to `task_slot_size` bytes inline and larger callables on
+     * the heap. Unlike `std::function`, this never allocates for small
+     * tasks.
+     */
+    class task_slot
+    {
+    public:
+
+        /**
+         * @brief Default constructor.
+         */
+        task_slot() = default;
+
+        /**
+         * @brief Constructor.
+         */
+        template <typename Func>
+        task_slot(Func&& func)
+        {
+            typedef typename std::decay<Func>::type func_type;
+            construct_<func_type>(
+                std::forward<Func>(func),
+                std::integral_constant<bool,
+                    sizeof(func_type) <= task_slot_size &&
+                    alignof(func_type) <= alignof(std::max_align_t)>());
+        }
+
+        /**
+         * @brief Non-copyable.
+         */
+        task_slot(const task_slot&) = delete;
+
+        /**
+         * @brief Move constructor.
+         */
+        task_slot(task_slot&& other)
+        {
+            move_from_(other);
+        }
+
+        /**
+         * @brief Destructor.
+         */
+        ~task_slot()
+        {
+            reset();
+        }
+
+        /**
+         * @brief Non-copyable.
+         */
+        task_slot& operator=(const task_slot&) = delete;
+
+        /**
+         * @brief Move assignment.
+         */
+        task_slot& operator=(task_slot&& other)
+        {
+            if (this != &other) {
+                reset();
+                move_from_(other);
+            }
+            return *this;
+        }
+
+    public:
+
+        /**
+         * @brief Invoke.
+         */
+        void operator()()
+        {
+            invoke_(&storage_[0]);
+        }
+
+        /**
+         * @brief Reset to empty.
+         */
+        void reset()
+        {
+            if (manage_) {
+                manage_(nullptr, &storage_[0]);
+                invoke_ = nullptr;
+                manage_ = nullptr;
+            }
+        }
+
+    private:
+
+        /**
+         * @brief Invoke function.
+         */
+        void (*invoke_)(unsigned char*) = nullptr;
+
+        /**
+         * @brief Manage function, moves to destination if
+         * non-null, then destroys source.
+         */
+        void (*manage_)(unsigned char*, unsigned char*) = nullptr;
+
+        /**
+         * @brief Storage.
+         */
+        alignas(std::max_align_t)
+        unsigned char storage_[task_slot_size];
+
+#if !DOXYGEN
+    private:
+
+        // Construct inline.
+        template <typename Tfunc, typename Func>
+        void construct_(Func&& func, std::true_type)
+        {
+            ::new (static_cast<void*>(&storage_[0]))
+                Tfunc(std::forward<Func>(func));
+            invoke_ = [](unsigned char* storage) {
+                (*reinterpret_cast<Tfunc*>(storage))();
+            };
+            manage_ = [](unsigned char* dst, unsigned char* src) {
+                Tfunc* src_func = reinterpret_cast<Tfunc*>(src);
+                if (dst) {
+                    ::new (static_cast<void*>(dst))
+                        Tfunc(std::move(*src_func));
+                }
+                src_func->~Tfunc();
+            };
+        }
+
+        // Construct on heap.
+        template <typename Tfunc, typename Func>
+        void construct_(Func&& func, std::false_type)
+        {
+            Tfunc* func_ptr = new Tfunc(std::forward<Func>(func));
+            std::memcpy(&storage_[0], &func_ptr, sizeof(Tfunc*));
+            invoke_ = [](unsigned char* storage) {
+                Tfunc* func_ptr;
+                std::memcpy(&func_ptr, storage, sizeof(Tfunc*));
+                (*func_ptr)();
+            };
+            manage_ = [](unsigned char* dst, unsigned char* src) {
+                Tfunc* func_ptr;
+                std::memcpy(&func_ptr, src, sizeof(Tfunc*));
+                if (dst) {
+                    std::memcpy(dst, &func_ptr, sizeof(Tfunc*));
+                }
+                else {
+                    delete func_ptr;
+                }
+            };
+        }
+
+        // Move from other, leaving other empty.
+        void move_from_(task_slot& other)
+        {
+            if (other.manage_) {
+                other.manage_(&storage_[0], &other.storage_[0]);
+                invoke_ = other.invoke_;
+                manage_ = other.manage_;
+                other.invoke_ = nullptr;
+                other.manage_ = nullptr;
+            }
+        }
+
+#endif // #if !DOXYGEN
+    };
+
+    /**
+     * @brief Promise slab.
+     *
+     * Thread-safe pooled storage for promise shared states. Shared
+     * states may outlive the thread pool, so allocators share ownership
+     * of the slab.
      */
-    using task_func = std::function<void()>;
+    class promise_slab
+    {
+    public:
+
+        /**
+         * @brief Element size in bytes.
+         */
+        static constexpr std::size_t elem_size = 128;
+
+        /**
+         * @brief Default constructor.
+         */
+        promise_slab() : pool_(elem_size, 4096)
+        {
+        }
+
+    public:
+
+        /**
+         * @brief Allocate.
+         */
+        void* allocate(std::size_t size)
+        {
+            if (size > elem_size) {
+                return ::operator new(size);
+            }
+            else {
+                std::unique_lock<std::mutex> lock(mutex_);
+                return pool_.allocate();
+            }
+        }
+
+        /**
+         * @brief Deallocate.
+         */
+        void deallocate(void* ptr, std::size_t size)
+        {
+            if (size > elem_size) {
+                ::operator delete(ptr);
+            }
+            else {
+                std::unique_lock<std::mutex> lock(mutex_);
+                pool_.deallocate(ptr);
+            }
+        }
+
+    private:
+
+        /**
+         * @brief Memory pool.
+         */
+        memory_pool<> pool_;
+
+        /**
+         * @brief Mutual exclusion object.
+         */
+        std::mutex mutex_;
+    };
+
+    /**
+     * @brief Promise slab allocator.
+     */
+    template <typename T>
+    class slab_allocator
+    {
+    public:
+
+        /**
+         * @brief Value type.
+         */
+        typedef T value_type;
+
+    public:
+
+        /**
+         * @brief Constructor.
+         */
+        slab_allocator(const std::shared_ptr<promise_slab>& slab) :
+                slab_(slab)
+        {
+        }
+
+        /**
+         * @brief Copy constructor.
+         */
+        template <typename U>
+        slab_allocator(const slab_allocator<U>& other) :
+                slab_(other.slab_)
+        {
+        }
+
+    public:
+
+        /**
+         * @brief Allocate.
+         */
+        T* allocate(std::size_t n)
+        {
+            return static_cast<T*>(slab_->allocate(sizeof(T) * n));
+        }
+
+        /**
+         * @brief Deallocate.
+         */
+        void deallocate(T* ptr, std::size_t n)
+        {
+            slab_->deallocate(ptr, sizeof(T) * n);
+        }
+
+        /**
+         * @brief Equal?
+         */
+        template <typename U>
+        bool operator==(const slab_allocator<U>& other) const
+        {
+            return slab_ == other.slab_;
+        }
+
+        /**
+         * @brief Not equal?
+         */
+        template <typename U>
+        bool operator!=(const slab_allocator<U>& other) const
+        {
+            return slab_ != other.slab_;
+        }
+
+    private:
+
+        /**
+         * @brief Slab.
+         */
+        std::shared_ptr<promise_slab> slab_;
+
+        // Declare friend.
+        template <typename>
+        friend class slab_allocator;
+    };
+
+    /**
+     * @brief Detached task, for fire-and-forget tasks.
+     */
+    template <typename Tbind>
+    struct detached_task
+    {
+        /**
+         * @brief Thread pool.
+         */
+        thread_pool* pool;
+
+        /**
+         * @brief Bound task.
+         */
+        Tbind bind;
+
+        /**
+         * @brief Invoke, and hold first exception in pool.
+         */
+        void operator()()
+        {
+            try {
+                bind();
+            }
+            catch (...) {
+                std::unique_lock<std::mutex> lock(pool->error_mutex_);
+                if (!pool->error_) {
+                    pool->error_ = std::current_exception();
+                }
+            }
+        }
+    };
+
+    /**
+     * @brief Promise task.
+     */
+    template <typename Tbind, typename R>
+    struct promise_task
+    {
+        /**
+         * @brief Bound task.
+         */
+        Tbind bind;
+
+        /**
+         * @brief Promise.
+         */
+        std::promise<R> promise;
+
+        /**
+         * @brief Invoke, and set value or exception.
+         */
+        void operator()()
+        {
+            try {
+                set_value_(promise, bind);
+            }
+            catch (...) {
+                promise.set_exception(std::current_exception());
+            }
+        }
+
+#if !DOXYGEN
+    private:
+
+        // Set value.
+        template <typename U>
+        static void set_value_(std::promise<U>& prom, Tbind& func)
+        {
+            prom.set_value(func());
+        }
+
+        // Set value, void variant.
+        static void set_value_(std::promise<void>& prom, Tbind& func)
+        {
+            func();
+            prom.set_value();
+        }
+
+#endif // #if !DOXYGEN
+    };
 
     /**
-     * @brief Thread-safe task queue.
+     * @brief Thread-safe task deque.
      */
     class task_queue
     {
@@ -223,27 +1113,27 @@ private:
         }
 
         /**
-         * @brief Push task.
+         * @brief Push task onto back.
          *
          * @param[in] task
          * Pushed task.
          */
-        void push(const task_func& task)
+        void push(task_slot&& task)
         {
             // Lock.
             std::unique_lock<std::mutex> lock(mutex_);
 
             // Delegate.
-            queue_.push(task);
+            queue_.push_back(std::move(task));
         }
 
         /**
-         * @brief Pop task.
+         * @brief Pop task from front, first-in first-out.
          *
          * @param[out] task
          * Popped task.
          */
-        bool pop(task_func& task)
+        bool pop(task_slot& task)
         {
             // Lock.
             std::unique_lock<std::mutex> lock(mutex_);
@@ -254,7 +1144,29 @@ private:
             else {
                 // Delegate.
                 task = std::move(queue_.front());
-                queue_.pop();
+                queue_.pop_front();
+                return true;
+            }
+        }
+
+        /**
+         * @brief Pop task from back, last-in first-out.
+         *
+         * @param[out] task
+         * Popped task.
+         */
+        bool pop_back(task_slot& task)
+        {
+            // Lock.
+            std::unique_lock<std::mutex> lock(mutex_);
+
+            if (queue_.empty()) {
+                return false;
+            }
+            else {
+                // Delegate.
+                task = std::move(queue_.back());
+                queue_.pop_back();
                 return true;
             }
         }
@@ -262,9 +1174,9 @@ private:
     private:
 
         /**
-         * @brief Queue.
+         * @brief Deque.
          */
-        std::queue<task_func> queue_;
+        std::deque<task_slot> queue_;
 
         /**
          * @brief Mutual exclusion object.
@@ -284,8 +1196,15 @@ private:
          *
          * @param[in] pool
          * Thread pool managing this worker.
+         *
+         * @param[in] index
+         * Worker index.
          */
-        worker(thread_pool& pool) : pool_(pool) {}
+        worker(thread_pool& pool, std::size_t index) :
+                pool_(pool),
+                index_(index)
+        {
+        }
 
     public:
 
@@ -294,21 +1213,31 @@ private:
          */
         void operator()()
         {
-            task_func task;
-            while (!pool_.shutdown_) {
+            // Pin.
+            pool_.pin_worker_(index_);
 
-                bool pop_okay = false;
-                {
-                    std::unique_lock<std::mutex> lock(pool_.cv_mutex_);
-                    if (pool_.queue_.empty()) {
-                        pool_.cv_.wait_for(lock,
-                            std::chrono::milliseconds(50)); // Avoid hanging.
-                    }
-                    pop_okay = pool_.queue_.pop(task);
-                }
+            // Allocate arena on this thread.
+            pool_.arenas_[index_].reset(new memory_arena<>());
 
-                if (pop_okay) {
+            // Identify this thread.
+            this_worker_().pool = &pool_;
+            this_worker_().index = index_;
+            this_worker_().arena = pool_.arenas_[index_].get();
+
+            task_slot task;
+            while (!pool_.shutdown_) {
+                if (pool_.pop_task_(index_, task)) {
                     task();
+                    task.reset();
+                }
+                else {
+                    std::unique_lock<std::mutex> lock(pool_.cv_mutex_);
+                    pool_.cv_.wait_for(lock,
+                        std::chrono::milliseconds(50), // Avoid hanging.
+                        [&]() {
+                            return pool_.shutdown_ ||
+                                   pool_.pending_ > 0;
+                        });
                 }
             }
         }
@@ -319,10 +1248,77 @@ private:
          * @brief Thread pool managing this worker.
          */
         thread_pool& pool_;
+
+        /**
+         * @brief Worker index.
+         */
+        std::size_t index_;
+    };
+
+    /**
+     * @brief Worker info, to identify worker threads.
+     */
+    struct worker_info
+    {
+        /**
+         * @brief Thread pool, or `nullptr` if not a worker.
+         */
+        thread_pool* pool;
+
+        /**
+         * @brief Worker index.
+         */
+        std::size_t index;
+
+        /**
+         * @brief Worker arena, or `nullptr` if not a worker.
+         */
+        memory_arena<>* arena;
     };
 
 private:
 
+    /**
+     * @brief Index meaning no particular node.
+     */
+    static constexpr std::size_t npos = std::size_t(-1);
+
+    /**
+     * @brief Scheduling mode.
+     */
+    thread_pool_mode mode_;
+
+    /**
+     * @brief Affinity policy.
+     */
+    thread_pool_affinity affinity_;
+
+    /**
+     * @brief CPUs of each node.
+     */
+    std::vector<std::vector<int>> node_cpus_;
+
+    /**
+     * @brief Node of each worker.
+     */
+    std::vector<std::size_t> worker_nodes_;
+
+    /**
+     * @brief Workers of each node.
+     */
+    std::vector<std::vector<std::size_t>> node_workers_;
+
+    /**
+     * @brief Queue pop order of each worker, then of threads
+     * outside the pool.
+     */
+    std::vector<std::vector<std::size_t>> pop_orders_;
+
+    /**
+     * @brief Worker arenas.
+     */
+    std::vector<std::unique_ptr<memory_arena<>>> arenas_;
+
     /**
      * @brief Threads.
      */
@@ -331,12 +1327,38 @@ private:
     /**
      * @brief Shutdown flag.
      */
-    bool shutdown_ = false;
+    std::atomic<bool> shutdown_{false};
+
+    /**
+     * @brief Task queues, one shared queue per node or one deque
+     * per worker.
+     */
+    std::vector<std::unique_ptr<task_queue>> queues_;
+
+    /**
+     * @brief Next queue for tasks submitted from outside the pool.
+     */
+    std::atomic<std::size_t> next_queue_{0};
+
+    /**
+     * @brief Count of pushed tasks not yet popped.
+     */
+    std::atomic<std::size_t> pending_{0};
+
+    /**
+     * @brief First exception from fire-and-forget task.
+     */
+    std::exception_ptr error_;
 
     /**
-     * @brief Task queue.
+     * @brief First exception mutual exclusion object.
      */
-    task_queue queue_;
+    std::mutex error_mutex_;
+
+    /**
+     * @brief Promise slab.
+     */
+    std::shared_ptr<promise_slab> slab_ = std::make_shared<promise_slab>();
 
     /**
      * @brief Condition variable.
@@ -347,6 +1369,415 @@ private:
      * @brief Condition variable mutual exclusion object.
      */
     std::mutex cv_mutex_;
+
+#if !DOXYGEN
+private:
+
+    // Worker info for calling thread.
+    static worker_info& this_worker_()
+    {
+        static thread_local worker_info info = {nullptr, 0, nullptr};
+        return info;
+    }
+
+    // Push task.
+    void push_task_(task_slot&& task, std::size_t node = npos)
+    {
+        std::size_t index = 0;
+        worker_info& info = this_worker_();
+        bool inside = info.pool == this;
+        if (mode_ == thread_pool_mode::work_stealing) {
+            if (inside &&
+                    (node == npos ||
+                     node == worker_nodes_[info.index])) {
+                // Push onto local deque.
+                index = info.index;
+            }
+            else if (node < node_workers_.size() &&
+                    !node_workers_[node].empty()) {
+                // Distribute round-robin on node.
+                index = node_workers_[node][
+                        next_queue_++ % node_workers_[node].size()];
+            }
+            else {
+                // Distribute round-robin.
+                index = next_queue_++ % queues_.size();
+            }
+        }
+        else {
+            if (node < queues_.size()) {
+                // Push onto node queue.
+                index = node;
+            }
+            else if (inside) {
+                // Push onto local node queue.
+                index = worker_nodes_[info.index];
+            }
+            else if (queues_.size() > 1) {
+                // Distribute round-robin.
+                index = next_queue_++ % queues_.size();
+            }
+        }
+        pending_++;
+        queues_[index]->push(std::move(task));
+
+        // Notify one waiting thread.
+        cv_.notify_one();
+    }
+
+    // Pop task for worker, or for thread outside the pool if index
+    // is the number of workers.
+    bool pop_task_(std::size_t index, task_slot& task)
+    {
+        bool pop_okay = false;
+        if (mode_ == thread_pool_mode::work_stealing &&
+            index < worker_nodes_.size()) {
+            // Pop from local deque.
+            pop_okay = queues_[index]->pop_back(task);
+        }
+        for (std::size_t queue : pop_orders_[index]) {
+            if (pop_okay) {
+                break;
+            }
+            // Pop or steal.
+            pop_okay = queues_[queue]->pop(task);
+        }
+        if (pop_okay) {
+            pending_--;
+        }
+        return pop_okay;
+    }
+
+    // Pin worker.
+    void pin_worker_(std::size_t index)
+    {
+#if defined(__linux__)
+        std::size_t node = worker_nodes_[index];
+        const std::vector<int>& cpus = node_cpus_[node];
+        if (affinity_ == thread_pool_affinity::none ||
+            cpus.empty()) {
+            return;
+        }
+        cpu_set_t cpu_set;
+        CPU_ZERO(&cpu_set);
+        if (affinity_ == thread_pool_affinity::core) {
+            // Position of worker on node.
+            std::size_t pos = 0;
+            while (node_workers_[node][pos] != index) {
+                pos++;
+            }
+            CPU_SET(cpus[pos % cpus.size()], &cpu_set);
+        }
+        else {
+            for (int cpu : cpus) {
+                CPU_SET(cpu, &cpu_set);
+            }
+        }
+        // Ignore failure, e.g., if restricted by cgroup.
+        (void) pthread_setaffinity_np(
+                pthread_self(), sizeof(cpu_set_t), &cpu_set);
+#else
+        (void) index;
+#endif // #if defined(__linux__)
+    }
+
+    // Detect CPUs of each node.
+    static std::vector<std::vector<int>> detect_node_cpus_()
+    {
+        std::vector<std::vector<int>> node_cpus;
+#if defined(__linux__)
+        for (int node = 0; node < 256; node++) {
+            std::ifstream ifs(
+                std::string("/sys/devices/system/node/node")
+                    .append(std::to_string(node))
+                    .append("/cpulist"));
+            std::string cpulist;
+            if (!(ifs >> cpulist)) {
+                continue;
+            }
+
+            // Parse list of ranges, e.g., 0-3,8-11.
+            std::vector<int> cpus;
+            std::size_t pos = 0;
+            while (pos < cpulist.size()) {
+                std::size_t len = 0;
+                int cpu0 = std::stoi(cpulist.substr(pos), &len);
+                int cpu1 = cpu0;
+                pos += len;
+                if (pos < cpulist.size() && cpulist[pos] == '-') {
+                    cpu1 = std::stoi(cpulist.substr(pos + 1), &len);
+                    pos += len + 1;
+                }
+                for (int cpu = cpu0; cpu <= cpu1; cpu++) {
+                    cpus.push_back(cpu);
+                }
+                if (pos < cpulist.size() && cpulist[pos] == ',') {
+                    pos++;
+                }
+            }
+            if (!cpus.empty()) {
+                node_cpus.push_back(cpus);
+            }
+        }
+#endif // #if defined(__linux__)
+        if (node_cpus.empty()) {
+            // Default to one node.
+            node_cpus.resize(1);
+            int ncpus = std::thread::hardware_concurrency();
+            for (int cpu = 0; cpu < ncpus; cpu++) {
+                node_cpus[0].push_back(cpu);
+            }
+        }
+        return node_cpus;
+    }
+
+    // Run one pending task on calling thread, if any.
+    bool run_pending_task_()
+    {
+        std::size_t index = worker_nodes_.size();
+        worker_info& info = this_worker_();
+        if (info.pool == this) {
+            index = info.index;
+        }
+        task_slot task;
+        if (pop_task_(index, task)) {
+            task();
+            return true;
+        }
+        else {
+            return false;
+        }
+    }
+
+    // Run chunks on calling thread and idle workers.
+    template <typename Func>
+    void run_chunks_(std::size_t nchunks, Func& func)
+    {
+        // Shared state, outlives the call if helpers start late.
+        struct chunk_state
+        {
+            // Next unclaimed chunk.
+            std::atomic<std::size_t> next{0};
+
+            // Completed chunks.
+            std::atomic<std::size_t> done{0};
+
+            // Chunk count.
+            std::size_t count = 0;
+
+            // Chunk function, valid only while chunks remain.
+            Func* func = nullptr;
+
+            // First exception.
+            std::exception_ptr error;
+
+            // First exception mutual exclusion object.
+            std::mutex error_mutex;
+
+            // Claim and run chunks until none remain.
+            void run()
+            {
+                std::size_t chunk;
+                while ((chunk = next++) < count) {
+                    try {
+                        (*func)(chunk);
+                    }
+                    catch (...) {
+                        std::unique_lock<std::mutex> lock(error_mutex);
+                        if (!error) {
+                            error = std::current_exception();
+                        }
+                    }
+                    done++;
+                }
+            }
+        };
+
+        std::shared_ptr<chunk_state> state =
+        std::make_shared<chunk_state>();
+        state->count = nchunks;
+        state->func = &func;
+
+        // Submit helpers.
+        std::size_t nhelpers = std::min(nchunks - 1, size());
+        for (std::size_t helper = 0; helper < nhelpers; helper++) {
+            push_task_([state]() {
+                state->run();
+            });
+        }
+
+        // Participate.
+        state->run();
+
+        // Wait for chunks claimed by helpers. These are in progress
+        // on running threads, so this cannot deadlock. Meanwhile, run
+        // pending tasks instead of idling.
+        while (state->done < nchunks) {
+            if (!run_pending_task_()) {
+                std::this_thread::yield();
+            }
+        }
+
+        // Rethrow.
+        if (state->error) {
+            std::rethrow_exception(state->error);
+        }
+    }
+
+#endif // #if !DOXYGEN
+
+    // Declare friend.
+    friend class task_group;
+};
+
+/**
+ * @brief Task group.
+ *
+ * Group of tasks run on a thread pool and waited on together.
+ * Unlike blocking on `std::future`, waiting on a task group runs
+ * pending tasks of the pool, so a task may safely spawn and wait on
+ * sub-tasks from inside the pool without deadlocking or leaving a
+ * core idle.
+ */
+class task_group
+{
+public:
+
+    /**
+     * @brief Constructor.
+     *
+     * @param[in] pool
+     * Thread pool.
+     */
+    explicit task_group(thread_pool& pool) : pool_(pool)
+    {
+    }
+
+    /**
+     * @brief Non-copyable.
+     */
+    task_group(const task_group&) = delete;
+
+    /**
+     * @brief Destructor.
+     *
+     * @note
+     * Waits, but discards any exception.
+     */
+    ~task_group()
+    {
+        try {
+            wait();
+        }
+        catch (...) {
+            // Discard.
+        }
+    }
+
+public:
+
+    /**
+     * @brief Run task.
+     */
+    template <
+        typename Func,
+        typename... Args
+        >
+    inline void run(Func&& func, Args&&... args)
+    {
+        auto bind =
+                std::bind(
+                std::forward<Func>(func),
+                std::forward<Args>(args)...);
+        pending_++;
+        pool_.push_task_(
+            thread_pool::task_slot(
+            group_task<decltype(bind)>{this, std::move(bind)}));
+    }
+
+    /**
+     * @brief Wait for all tasks, running pending tasks meanwhile.
+     *
+     * @throw
+     * Rethrows the first exception thrown by any task since the
+     * previous wait.
+     */
+    void wait()
+    {
+        while (pending_ > 0) {
+            if (!pool_.run_pending_task_()) {
+                std::this_thread::yield();
+            }
+        }
+
+        // Rethrow.
+        std::exception_ptr error;
+        {
+            std::unique_lock<std::mutex> lock(error_mutex_);
+            std::swap(error, error_);
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+private:
+
+    /**
+     * @brief Thread pool.
+     */
+    thread_pool& pool_;
+
+    /**
+     * @brief Count of tasks not yet finished.
+     */
+    std::atomic<std::size_t> pending_{0};
+
+    /**
+     * @brief First exception.
+     */
+    std::exception_ptr error_;
+
+    /**
+     * @brief First exception mutual exclusion object.
+     */
+    std::mutex error_mutex_;
+
+    /**
+     * @brief Group task.
+     */
+    template <typename Tbind>
+    struct group_task
+    {
+        /**
+         * @brief Task group.
+         */
+        task_group* group;
+
+        /**
+         * @brief Bound task.
+         */
+        Tbind bind;
+
+        /**
+         * @brief Invoke, then mark finished.
+         */
+        void operator()()
+        {
+            try {
+                bind();
+            }
+            catch (...) {
+                std::unique_lock<std::mutex> lock(group->error_mutex_);
+                if (!group->error_) {
+                    group->error_ = std::current_exception();
+                }
+            }
+
+            // Last access to group.
+            group->pending_--;
+        }
+    };
 };
 
 /**@}*/
@@ -35,6 +35,15 @@
 #ifndef PREFORM_WORLEY_NOISE2_HPP
 #define PREFORM_WORLEY_NOISE2_HPP
 
+// for std::fill, std::min
+#include <algorithm>
+
+// for std::size_t
+#include <cstddef>
+
+// for std::uint64_t
+#include <cstdint>
+
 // for pre::wrap, pre::cantor
 #include <preform/misc_int.hpp>
 
@@ -123,18 +132,8 @@ public:
         for (wk[0] = w0[0] - 1; wk[0] <= w0[0] + 1; wk[0]++)
         for (wk[1] = w0[1] - 1; wk[1] <= w0[1] + 1; wk[1]++) {
 
-            // Generator.
-            pcg32 gen(
-                seed_,
-                cantor(
-                    period_[0] <= 0 ? wk[0] : repeat(wk[0], period_[0]),
-                    period_[1] <= 0 ? wk[1] : repeat(wk[1], period_[1])));
-
             // Vertex.
-            multi<float_type, 2> vk = {
-                float_type(wk[0]) + pre::generate_canonical<float_type>(gen),
-                float_type(wk[1]) + pre::generate_canonical<float_type>(gen)
-            };
+            multi<float_type, 2> vk = vertex_(wk);
 
             // Offset.
             multi<float_type, 2> tk = t - vk;
@@ -166,8 +165,188 @@ public:
         return s;
     }
 
+    /**
+     * @brief Evaluate many.
+     *
+     * Equivalent to `evaluate()` at each point, for coordinates in
+     * structure-of-arrays layout. Vertices come from a cache of
+     * recently visited cells, so coherent points generate each cell
+     * once, and points go in groups of 8 with the nearest and second
+     * nearest searches as straight loops across the group.
+     *
+     * @param[in] t
+     * Coordinate arrays, one per dimension.
+     *
+     * @param[in] n
+     * Count.
+     *
+     * @param[out] s
+     * Noise values.
+     *
+     * @param[out] ds_dt
+     * Noise partial derivative arrays, one per dimension. _Optional_.
+     *
+     * @param[out] s2
+     * Noise values for second nearest vertices, normalized the same
+     * way. _Optional_.
+     */
+    void evaluate_many(
+            multi<const float_type*, 2> t,
+            std::size_t n,
+            float_type* s,
+            multi<float_type*, 2> ds_dt = {},
+            float_type* s2 = nullptr) const
+    {
+        // Points per group.
+        constexpr std::size_t lanes = 8;
+
+        // Vertex cache.
+        vertex_cache_ cache;
+
+        // Want partial derivatives?
+        bool want_ds_dt = false;
+        for (int d = 0; d < 2; d++) {
+            want_ds_dt = want_ds_dt || ds_dt[d];
+        }
+
+        for (std::size_t k0 = 0; k0 < n; k0 += lanes) {
+            std::size_t m = std::min(lanes, n - k0);
+
+            // Coordinates and vertices, by neighboring cell.
+            float_type tj[2][lanes] = {};
+            float_type vj[9][2][lanes] = {};
+            for (std::size_t j = 0; j < m; j++) {
+                multi<float_type, 2> tl;
+                for (int d = 0; d < 2; d++) {
+                    tl[d] = tj[d][j] = t[d][k0 + j];
+                }
+                multi<int, 2> w0 = pre::floor(tl);
+                int c = 0;
+                for (int c0 = -1; c0 <= 1; c0++)
+                for (int c1 = -1; c1 <= 1; c1++) {
+                    const multi<float_type, 2>& v =
+                        cached_vertex_(cache, w0 + multi<int, 2>{c0, c1});
+                    for (int d = 0; d < 2; d++) {
+                        vj[c][d][j] = v[d];
+                    }
+                    c++;
+                }
+            }
+
+            // Nearest and second nearest.
+            float_type sj[lanes];
+            float_type s2j[lanes];
+            float_type ds_dtj[2][lanes] = {};
+            std::fill(&sj[0], &sj[0] + lanes,
+                      pre::numeric_limits<float_type>::infinity());
+            std::fill(&s2j[0], &s2j[0] + lanes,
+                      pre::numeric_limits<float_type>::infinity());
+            for (int c = 0; c < 9; c++)
+            for (std::size_t j = 0; j < lanes; j++) {
+
+                // Offset.
+                float_type tk[2];
+                for (int d = 0; d < 2; d++) {
+                    tk[d] = tj[d][j] - vj[c][d][j];
+                }
+
+                // Half square distance.
+                float_type sk =
+                    float_type(0.5) * (tk[0] * tk[0] + tk[1] * tk[1]);
+                bool nearer = sj[j] > sk;
+                s2j[j] = nearer ? sj[j] : std::min(s2j[j], sk);
+                sj[j] = nearer ? sk : sj[j];
+                if (want_ds_dt) {
+                    for (int d = 0; d < 2; d++) {
+                        ds_dtj[d][j] = nearer ? tk[d] : ds_dtj[d][j];
+                    }
+                }
+            }
+
+            // Square root and chain rule.
+            for (std::size_t j = 0; j < m; j++) {
+                float_type sk = pre::sqrt(sj[j]);
+                s[k0 + j] = sk;
+                if (s2) {
+                    s2[k0 + j] = pre::sqrt(s2j[j]);
+                }
+                for (int d = 0; d < 2; d++) {
+                    if (ds_dt[d]) {
+                        ds_dt[d][k0 + j] =
+                            sk == float_type(0) ? float_type(0) :
+                            ds_dtj[d][j] / (float_type(2) * sk);
+                    }
+                }
+            }
+        }
+    }
+
 private:
 
+    /**
+     * @brief Vertex in cell.
+     */
+    multi<float_type, 2> vertex_(multi<int, 2> w) const
+    {
+        // Generator.
+        pcg32 gen(
+            seed_,
+            cantor(
+                period_[0] <= 0 ? w[0] : repeat(w[0], period_[0]),
+                period_[1] <= 0 ? w[1] : repeat(w[1], period_[1])));
+
+        // Vertex.
+        return {
+            float_type(w[0]) + pre::generate_canonical<float_type>(gen),
+            float_type(w[1]) + pre::generate_canonical<float_type>(gen)
+        };
+    }
+
+    /**
+     * @brief Vertex cache, direct mapped by cell.
+     */
+    struct vertex_cache_
+    {
+        /**
+         * @brief Cells.
+         */
+        multi<int, 2> cell[64] = {};
+
+        /**
+         * @brief Vertices.
+         */
+        multi<float_type, 2> v[64] = {};
+
+        /**
+         * @brief Valid bits.
+         */
+        std::uint64_t valid = 0;
+    };
+
+    /**
+     * @brief Cached vertex in cell.
+     *
+     * @param[inout] cache
+     * Cache.
+     *
+     * @param[in] w
+     * Cell.
+     */
+    const multi<float_type, 2>& cached_vertex_(
+                vertex_cache_& cache,
+                multi<int, 2> w) const
+    {
+        // Index by cell modulo 8 x 8, such that no 3 x 3 neighborhood
+        // conflicts with itself.
+        int k = (w[0] & 7) | (w[1] & 7) << 3;
+        if (!((cache.valid >> k) & 1) || !(cache.cell[k] == w).all()) {
+            cache.cell[k] = w;
+            cache.v[k] = vertex_(w);
+            cache.valid |= std::uint64_t(1) << k;
+        }
+        return cache.v[k];
+    }
+
     /**
      * @brief Seed.
      */
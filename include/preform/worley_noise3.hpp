@@ -35,6 +35,15 @@
 #ifndef PREFORM_WORLEY_NOISE3_HPP
 #define PREFORM_WORLEY_NOISE3_HPP
 
+// for std::fill, std::min
+#include <algorithm>
+
+// for std::size_t
+#include <cstddef>
+
+// for std::uint64_t
+#include <cstdint>
+
 // for pre::wrap, pre::cantor
 #include <preform/misc_int.hpp>
 
@@ -124,20 +133,8 @@ public:
         for (wk[1] = w0[1] - 1; wk[1] <= w0[1] + 1; wk[1]++)
         for (wk[2] = w0[2] - 1; wk[2] <= w0[2] + 1; wk[2]++) {
 
-            // Generator.
-            pcg32 gen(
-                seed_,
-                cantor(
-                    period_[0] <= 0 ? wk[0] : repeat(wk[0], period_[0]),
-                    period_[1] <= 0 ? wk[1] : repeat(wk[1], period_[1]),
-                    period_[2] <= 0 ? wk[2] : repeat(wk[2], period_[2])));
-
             // Vertex.
-            multi<float_type, 3> vk = {
-                float_type(wk[0]) + pre::generate_canonical<float_type>(gen),
-                float_type(wk[1]) + pre::generate_canonical<float_type>(gen),
-                float_type(wk[2]) + pre::generate_canonical<float_type>(gen)
-            };
+            multi<float_type, 3> vk = vertex_(wk);
 
             // Offset.
             multi<float_type, 3> tk = t - vk;
@@ -168,8 +165,194 @@ public:
         return s;
     }
 
+    /**
+     * @brief Evaluate many.
+     *
+     * Equivalent to `evaluate()` at each point, for coordinates in
+     * structure-of-arrays layout. Vertices come from a cache of
+     * recently visited cells, so coherent points generate each cell
+     * once, and points go in groups of 8 with the nearest and second
+     * nearest searches as straight loops across the group.
+     *
+     * @param[in] t
+     * Coordinate arrays, one per dimension.
+     *
+     * @param[in] n
+     * Count.
+     *
+     * @param[out] s
+     * Noise values.
+     *
+     * @param[out] ds_dt
+     * Noise partial derivative arrays, one per dimension. _Optional_.
+     *
+     * @param[out] s2
+     * Noise values for second nearest vertices, normalized the same
+     * way. _Optional_.
+     */
+    void evaluate_many(
+            multi<const float_type*, 3> t,
+            std::size_t n,
+            float_type* s,
+            multi<float_type*, 3> ds_dt = {},
+            float_type* s2 = nullptr) const
+    {
+        // Points per group.
+        constexpr std::size_t lanes = 8;
+
+        // Vertex cache.
+        vertex_cache_ cache;
+
+        // Want partial derivatives?
+        bool want_ds_dt = false;
+        for (int d = 0; d < 3; d++) {
+            want_ds_dt = want_ds_dt || ds_dt[d];
+        }
+
+        for (std::size_t k0 = 0; k0 < n; k0 += lanes) {
+            std::size_t m = std::min(lanes, n - k0);
+
+            // Coordinates and vertices, by neighboring cell.
+            float_type tj[3][lanes] = {};
+            float_type vj[27][3][lanes] = {};
+            for (std::size_t j = 0; j < m; j++) {
+                multi<float_type, 3> tl;
+                for (int d = 0; d < 3; d++) {
+                    tl[d] = tj[d][j] = t[d][k0 + j];
+                }
+                multi<int, 3> w0 = pre::floor(tl);
+                int c = 0;
+                for (int c0 = -1; c0 <= 1; c0++)
+                for (int c1 = -1; c1 <= 1; c1++)
+                for (int c2 = -1; c2 <= 1; c2++) {
+                    const multi<float_type, 3>& v =
+                        cached_vertex_(cache, w0 + multi<int, 3>{c0, c1, c2});
+                    for (int d = 0; d < 3; d++) {
+                        vj[c][d][j] = v[d];
+                    }
+                    c++;
+                }
+            }
+
+            // Nearest and second nearest.
+            float_type sj[lanes];
+            float_type s2j[lanes];
+            float_type ds_dtj[3][lanes] = {};
+            std::fill(&sj[0], &sj[0] + lanes,
+                      pre::numeric_limits<float_type>::infinity());
+            std::fill(&s2j[0], &s2j[0] + lanes,
+                      pre::numeric_limits<float_type>::infinity());
+            for (int c = 0; c < 27; c++)
+            for (std::size_t j = 0; j < lanes; j++) {
+
+                // Offset.
+                float_type tk[3];
+                for (int d = 0; d < 3; d++) {
+                    tk[d] = tj[d][j] - vj[c][d][j];
+                }
+
+                // Third square distance.
+                float_type sk =
+                    (tk[0] * tk[0] + tk[1] * tk[1] + tk[2] * tk[2]) /
+                    float_type(3);
+                bool nearer = sj[j] > sk;
+                s2j[j] = nearer ? sj[j] : std::min(s2j[j], sk);
+                sj[j] = nearer ? sk : sj[j];
+                if (want_ds_dt) {
+                    for (int d = 0; d < 3; d++) {
+                        float_type dsk =
+                            (float_type(2) / float_type(3)) * tk[d];
+                        ds_dtj[d][j] = nearer ? dsk : ds_dtj[d][j];
+                    }
+                }
+            }
+
+            // Square root and chain rule.
+            for (std::size_t j = 0; j < m; j++) {
+                float_type sk = pre::sqrt(sj[j]);
+                s[k0 + j] = sk;
+                if (s2) {
+                    s2[k0 + j] = pre::sqrt(s2j[j]);
+                }
+                for (int d = 0; d < 3; d++) {
+                    if (ds_dt[d]) {
+                        ds_dt[d][k0 + j] =
+                            sk == float_type(0) ? float_type(0) :
+                            ds_dtj[d][j] / (float_type(2) * sk);
+                    }
+                }
+            }
+        }
+    }
+
 private:
 
+    /**
+     * @brief Vertex in cell.
+     */
+    multi<float_type, 3> vertex_(multi<int, 3> w) const
+    {
+        // Generator.
+        pcg32 gen(
+            seed_,
+            cantor(
+                period_[0] <= 0 ? w[0] : repeat(w[0], period_[0]),
+                period_[1] <= 0 ? w[1] : repeat(w[1], period_[1]),
+                period_[2] <= 0 ? w[2] : repeat(w[2], period_[2])));
+
+        // Vertex.
+        return {
+            float_type(w[0]) + pre::generate_canonical<float_type>(gen),
+            float_type(w[1]) + pre::generate_canonical<float_type>(gen),
+            float_type(w[2]) + pre::generate_canonical<float_type>(gen)
+        };
+    }
+
+    /**
+     * @brief Vertex cache, direct mapped by cell.
+     */
+    struct vertex_cache_
+    {
+        /**
+         * @brief Cells.
+         */
+        multi<int, 3> cell[64] = {};
+
+        /**
+         * @brief Vertices.
+         */
+        multi<float_type, 3> v[64] = {};
+
+        /**
+         * @brief Valid bits.
+         */
+        std::uint64_t valid = 0;
+    };
+
+    /**
+     * @brief Cached vertex in cell.
+     *
+     * @param[inout] cache
+     * Cache.
+     *
+     * @param[in] w
+     * Cell.
+     */
+    const multi<float_type, 3>& cached_vertex_(
+                vertex_cache_& cache,
+                multi<int, 3> w) const
+    {
+        // Index by cell modulo 4 x 4 x 4, such that no 3 x 3 x 3
+        // neighborhood conflicts with itself.
+        int k = (w[0] & 3) | (w[1] & 3) << 2 | (w[2] & 3) << 4;
+        if (!((cache.valid >> k) & 1) || !(cache.cell[k] == w).all()) {
+            cache.cell[k] = w;
+            cache.v[k] = vertex_(w);
+            cache.valid |= std::uint64_t(1) << k;
+        }
+        return cache.v[k];
+    }
+
     /**
      * @brief Seed.
      */
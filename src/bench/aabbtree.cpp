@@ -0,0 +1,167 @@
+#include <vector>
+#include <preform/random.hpp>
+#include <preform/multi_random.hpp>
+#include <preform/memory_arena_allocator.hpp>
+#include <preform/aabbtree.hpp>
+#include "bench.hpp"
+
+// Float type.
+typedef float Float;
+
+// 3-dimensional vector type.
+typedef pre::vec3<Float> Vec3f;
+
+// 3-dimensional axis-aligned bounding box type.
+typedef pre::aabb3<Float> AABB3f;
+
+// Axis-aligned bounding box tree.
+typedef pre::aabbtree3<Float,
+        pre::aabbtree_split_surface_area<16>,
+        pre::memory_arena_allocator<char>> AABBTree3;
+
+// Linear axis-aligned bounding box tree.
+typedef pre::linear_aabbtree3<Float> LinearAABBTree3;
+
+// Wide axis-aligned bounding box tree.
+typedef pre::wide_aabbtree3<Float, 4> WideAABBTree3x4;
+
+// Ray.
+struct Ray
+{
+    Vec3f org;
+    Vec3f dir;
+};
+
+// Ray-box intersection parameter, or infinity if none.
+Float rayBox(
+        const AABB3f& box,
+        const Vec3f& ray_org,
+        const Vec3f& ray_dir,
+        Float tmin,
+        Float tmax)
+{
+    for (int k = 0; k < 3; k++) {
+        Float t0 = (box[0][k] - ray_org[k]) / ray_dir[k];
+        Float t1 = (box[1][k] - ray_org[k]) / ray_dir[k];
+        if (t0 > t1) {
+            std::swap(t0, t1);
+        }
+        tmin = std::max(tmin, t0);
+        tmax = std::min(tmax, t1);
+    }
+    return tmin <= tmax ? tmin : pre::numeric_limits<Float>::infinity();
+}
+
+// Trace rays against tree, return hit count.
+template <typename Tree>
+std::size_t traceRays(
+        const Tree& tree,
+        const std::vector<AABB3f>& boxes,
+        const std::vector<Ray>& rays,
+        bool any_hit)
+{
+    std::size_t nhits = 0;
+    for (const Ray& ray : rays) {
+        Float tmax = pre::numeric_limits<Float>::infinity();
+        auto func = [&](std::size_t index, Float tmin, Float& tmax) {
+            Float t = rayBox(boxes[index], ray.org, ray.dir, tmin, tmax);
+            if (t < tmax) {
+                tmax = t;
+                return true;
+            }
+            return false;
+        };
+        if (any_hit) {
+            nhits += tree.ray_any_hit(ray.org, ray.dir, 0, tmax, func);
+        }
+        else {
+            nhits += tree.ray_closest_hit(
+                ray.org, ray.dir, 0, tmax, func) != Tree::npos;
+        }
+    }
+    return nhits;
+}
+
+int main(int argc, char** argv)
+{
+    bench::parseOptions(argc, argv);
+
+    // Generate boxes.
+    pre::pcg32 pcg(1);
+    const int nboxes = 262144;
+    std::vector<AABB3f> boxes(nboxes);
+    for (AABB3f& box : boxes) {
+        Vec3f point = pre::generate_canonical<Float, 3>(pcg) * 500 - 250;
+        Vec3f half_extent = pre::generate_canonical<Float, 3>(pcg) * 8 + 1;
+        box = {point - half_extent, point + half_extent};
+    }
+
+    // Generate rays.
+    const int nrays = 65536;
+    std::vector<Ray> rays(nrays);
+    for (Ray& ray : rays) {
+        ray.org = pre::generate_canonical<Float, 3>(pcg) * 600 - 300;
+        ray.dir = pre::generate_canonical<Float, 3>(pcg) * 2 - 1;
+    }
+
+    // Generate query boxes.
+    const int nqueries = 4096;
+    std::vector<AABB3f> query_boxes(nqueries);
+    for (AABB3f& box : query_boxes) {
+        Vec3f point = pre::generate_canonical<Float, 3>(pcg) * 500 - 250;
+        Vec3f half_extent = pre::generate_canonical<Float, 3>(pcg) * 4 + 1;
+        box = {point - half_extent, point + half_extent};
+    }
+
+    // Build.
+    {
+        AABBTree3 tree;
+        bench::run("aabbtree/build_sah", nboxes,
+            [&] { tree.clear(); },
+            [&] {
+                tree.init(boxes.begin(), boxes.end());
+                bench::keep(tree);
+            });
+        bench::run("aabbtree/build_morton", nboxes,
+            [&] { tree.clear(); },
+            [&] {
+                tree.init_morton(
+                    boxes.begin(), boxes.end(),
+                    [](const AABB3f& box) { return box; });
+                bench::keep(tree);
+            });
+    }
+
+    // Build once more for traversal, then sort boxes to match proxies.
+    AABBTree3 tree;
+    tree.init(boxes.begin(), boxes.end());
+    tree.sort(boxes.begin(), boxes.end());
+    LinearAABBTree3 linear_tree(tree);
+    WideAABBTree3x4 wide_tree(tree);
+    bench::run("aabbtree/flatten_linear", nboxes, [&] {
+        LinearAABBTree3 other(tree);
+        bench::keep(other);
+    });
+
+    // Overlap queries.
+    bench::run("aabbtree/overlap", nqueries, [&] {
+        std::size_t noverlaps = 0;
+        for (const AABB3f& box : query_boxes) {
+            tree.overlap(box, [&](std::size_t) { noverlaps++; });
+        }
+        bench::keep(noverlaps);
+    });
+
+    // Ray traversal.
+    for (int any_hit = 0; any_hit < 2; any_hit++) {
+        const char* suffix = any_hit ? "any_hit" : "closest_hit";
+        bench::run(std::string("linear_aabbtree/") + suffix, nrays, [&] {
+            bench::keep(traceRays(linear_tree, boxes, rays, any_hit));
+        });
+        bench::run(std::string("wide_aabbtree4/") + suffix, nrays, [&] {
+            bench::keep(traceRays(wide_tree, boxes, rays, any_hit));
+        });
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,130 @@
+#include <vector>
+#include <preform/random.hpp>
+#include <preform/memory_arena.hpp>
+#include <preform/memory_pool.hpp>
+#include <preform/size_class_allocator.hpp>
+#include "bench.hpp"
+
+// Allocation request.
+struct Request
+{
+    // Size in bytes.
+    std::size_t size = 0;
+
+    // Slot to allocate into, or free if already allocated.
+    std::size_t slot = 0;
+};
+
+// Generate random requests over a fixed number of live slots.
+std::vector<Request> generateRequests(
+        std::size_t count,
+        std::size_t slots,
+        std::size_t max_size)
+{
+    pre::pcg32 pcg(1);
+    std::vector<Request> requests(count);
+    std::vector<std::size_t> sizes(slots);
+    for (Request& request : requests) {
+        request.slot = pcg(slots);
+        if (sizes[request.slot] == 0) {
+            sizes[request.slot] = 16 + pcg(max_size - 15);
+        }
+        request.size = sizes[request.slot];
+    }
+    return requests;
+}
+
+// Replay requests, allocating into empty slots and freeing full slots.
+template <typename Alloc, typename Dealloc>
+void replay(
+        const std::vector<Request>& requests,
+        std::vector<void*>& ptrs,
+        Alloc&& alloc,
+        Dealloc&& dealloc)
+{
+    for (const Request& request : requests) {
+        void*& ptr = ptrs[request.slot];
+        if (ptr) {
+            dealloc(ptr, request.size);
+            ptr = nullptr;
+        }
+        else {
+            ptr = alloc(request.size);
+            *static_cast<char*>(ptr) = 0;
+        }
+    }
+    for (const Request& request : requests) {
+        void*& ptr = ptrs[request.slot];
+        if (ptr) {
+            dealloc(ptr, request.size);
+            ptr = nullptr;
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    bench::parseOptions(argc, argv);
+
+    const std::size_t n = 1048576;
+    const std::size_t slots = 4096;
+    std::vector<void*> ptrs(slots);
+
+    // Fixed size.
+    {
+        std::vector<Request> requests = generateRequests(n, slots, 16);
+        bench::run("fixed/operator_new", n, [&] {
+            replay(requests, ptrs,
+                [](std::size_t) { return ::operator new(64); },
+                [](void* ptr, std::size_t) { ::operator delete(ptr); });
+        });
+        pre::memory_pool<> pool(64, 4096);
+        bench::run("fixed/memory_pool", n, [&] {
+            replay(requests, ptrs,
+                [&](std::size_t) { return pool.allocate(); },
+                [&](void* ptr, std::size_t) { pool.deallocate(ptr); });
+        });
+        pre::concurrent_memory_pool<> concurrent_pool(64, 4096);
+        bench::run("fixed/concurrent_memory_pool", n, [&] {
+            replay(requests, ptrs,
+                [&](std::size_t) { return concurrent_pool.allocate(); },
+                [&](void* ptr, std::size_t) {
+                    concurrent_pool.deallocate(ptr);
+                });
+        });
+    }
+
+    // Mixed sizes.
+    {
+        std::vector<Request> requests = generateRequests(n, slots, 1024);
+        bench::run("mixed/operator_new", n, [&] {
+            replay(requests, ptrs,
+                [](std::size_t size) { return ::operator new(size); },
+                [](void* ptr, std::size_t) { ::operator delete(ptr); });
+        });
+        pre::size_class_memory_pool<> size_class_pool;
+        bench::run("mixed/size_class_memory_pool", n, [&] {
+            replay(requests, ptrs,
+                [&](std::size_t size) {
+                    return size_class_pool.allocate(size);
+                },
+                [&](void* ptr, std::size_t size) {
+                    size_class_pool.deallocate(ptr, size);
+                });
+        });
+    }
+
+    // Arena, allocate only then clear.
+    {
+        pre::memory_arena<> arena;
+        bench::run("arena/allocate", n,
+            [&] { arena.clear(); },
+            [&] {
+                for (std::size_t k = 0; k < n; k++) {
+                    *static_cast<char*>(arena.allocate(16 + k % 64)) = 0;
+                }
+            });
+    }
+
+    return EXIT_SUCCESS;
+}
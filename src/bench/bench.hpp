@@ -0,0 +1,198 @@
+#pragma once
+#ifndef BENCH_HPP
+#define BENCH_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include <preform/timer.hpp>
+#include <preform/option_parser.hpp>
+
+namespace bench {
+
+// Timer.
+typedef pre::steady_timer Timer;
+
+// Options shared by all benchmark programs.
+struct Options
+{
+    // Timed samples per benchmark.
+    int samples = 15;
+
+    // Untimed warmup runs per benchmark.
+    int warmups = 2;
+
+    // Run only benchmarks whose name contains this.
+    std::string filter;
+};
+
+// Global options.
+inline Options& options()
+{
+    static Options opts;
+    return opts;
+}
+
+// Keep value alive, so the compiler can't discard its computation.
+template <typename T>
+inline void keep(const T& value)
+{
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+// Parse options common to all benchmark programs.
+inline void parseOptions(int argc, char** argv)
+{
+    Options& opts = options();
+
+    // Option parser.
+    pre::option_parser opt_parser("[OPTIONS]");
+
+    // Specify samples.
+    opt_parser.on_option(
+    "-n", "--samples", 1,
+    [&](char** argv) {
+        try {
+            opts.samples = std::stoi(argv[0]);
+            if (!(opts.samples > 0)) {
+                throw std::exception(); // Trigger catch block.
+            }
+        }
+        catch (const std::exception&) {
+            throw
+                std::runtime_error(
+                std::string("-n/--samples expects 1 positive integer ")
+                    .append("(can't parse ").append(argv[0])
+                    .append(")"));
+        }
+    })
+    << "Specify timed samples per benchmark. By default, 15.\n";
+
+    // Specify warmups.
+    opt_parser.on_option(
+    "-w", "--warmups", 1,
+    [&](char** argv) {
+        try {
+            opts.warmups = std::stoi(argv[0]);
+            if (!(opts.warmups >= 0)) {
+                throw std::exception(); // Trigger catch block.
+            }
+        }
+        catch (const std::exception&) {
+            throw
+                std::runtime_error(
+                std::string("-w/--warmups expects 1 non-negative integer ")
+                    .append("(can't parse ").append(argv[0])
+                    .append(")"));
+        }
+    })
+    << "Specify untimed warmup runs per benchmark. By default, 2.\n";
+
+    // Specify filter.
+    opt_parser.on_option(
+    "-f", "--filter", 1,
+    [&](char** argv) {
+        opts.filter = argv[0];
+    })
+    << "Run only benchmarks whose name contains the given string.\n";
+
+    // Display help.
+    opt_parser.on_option(
+    "-h", "--help", 0,
+    [&](char**) {
+        std::cout << opt_parser << std::endl;
+        std::exit(EXIT_SUCCESS);
+    })
+    << "Display this help and exit.\n"
+    << "Each benchmark prints one JSON object per line, with time per\n"
+    << "item in nanoseconds over the timed samples.\n";
+
+    try {
+        // Parse args.
+        opt_parser.parse(argc, argv);
+    }
+    catch (const std::exception& exception) {
+        std::cerr << "Unhandled exception!\n";
+        std::cerr << "exception.what(): " << exception.what() << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+// Percentile of sorted samples, by nearest rank.
+inline double percentile(const std::vector<double>& sorted, double p)
+{
+    std::size_t rank = std::size_t(p * double(sorted.size()) + 0.5);
+    rank = std::max<std::size_t>(rank, 1);
+    rank = std::min<std::size_t>(rank, sorted.size());
+    return sorted[rank - 1];
+}
+
+// Run benchmark.
+//
+// Calls setup() before each run and times func(), which processes
+// items items. Prints one JSON object on a line of its own.
+template <typename Tsetup, typename Tfunc>
+inline void run(
+        const std::string& name,
+        std::size_t items,
+        Tsetup&& setup,
+        Tfunc&& func)
+{
+    const Options& opts = options();
+    if (!opts.filter.empty() &&
+        name.find(opts.filter) == std::string::npos) {
+        return;
+    }
+
+    // Warmup.
+    for (int run = 0; run < opts.warmups; run++) {
+        setup();
+        func();
+    }
+
+    // Time samples.
+    std::vector<double> ns_per_item;
+    ns_per_item.reserve(opts.samples);
+    for (int run = 0; run < opts.samples; run++) {
+        setup();
+        Timer timer;
+        func();
+        std::int64_t ns = timer.read<std::nano>();
+        ns_per_item.push_back(double(ns) / double(items));
+    }
+    std::sort(ns_per_item.begin(), ns_per_item.end());
+
+    double p50 = percentile(ns_per_item, 0.50);
+    std::cout << "{\"name\": \"" << name << "\"";
+    std::cout << ", \"items\": " << items;
+    std::cout << ", \"samples\": " << opts.samples;
+    std::cout << ", \"ns_per_item\": {";
+    std::cout << "\"min\": " << ns_per_item.front();
+    std::cout << ", \"p50\": " << p50;
+    std::cout << ", \"p90\": " << percentile(ns_per_item, 0.90);
+    std::cout << ", \"p99\": " << percentile(ns_per_item, 0.99);
+    std::cout << ", \"max\": " << ns_per_item.back();
+    std::cout << "}";
+    std::cout << ", \"items_per_sec\": " << (p50 > 0 ? 1e9 / p50 : 0);
+    std::cout << "}\n";
+    std::cout.flush();
+}
+
+// Run benchmark without setup.
+template <typename Tfunc>
+inline void run(
+        const std::string& name,
+        std::size_t items,
+        Tfunc&& func)
+{
+    run(name, items, [] {}, std::forward<Tfunc>(func));
+}
+
+} // namespace bench
+
+#endif // #ifndef BENCH_HPP
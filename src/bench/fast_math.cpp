@@ -0,0 +1,47 @@
+#include <vector>
+#include <preform/random.hpp>
+#include <preform/fast_math.hpp>
+#include "bench.hpp"
+
+// Float type.
+typedef float Float;
+
+// Benchmark each function with math policy.
+template <typename Tmath>
+void benchMath(const std::string& prefix)
+{
+    // Arguments in (-1, 1).
+    pre::pcg32 pcg(1);
+    const std::size_t n = 65536;
+    std::vector<Float> x(n);
+    std::vector<Float> y(n);
+    for (Float& value : x) {
+        value = pre::generate_canonical<Float>(pcg) * Float(1.99) -
+                                                      Float(0.995);
+    }
+
+    // Benchmark function over arguments.
+    auto benchFunc = [&](const char* name, auto&& func) {
+        bench::run(prefix + name, n, [&] {
+            for (std::size_t k = 0; k < n; k++) {
+                y[k] = func(x[k]);
+            }
+            bench::keep(y[0]);
+        });
+    };
+    benchFunc("exp", [](Float t) { return Tmath::exp(t * 20); });
+    benchFunc("log", [](Float t) { return Tmath::log(t + 1); });
+    benchFunc("pow", [](Float t) { return Tmath::pow(t + 1, Float(2.4)); });
+    benchFunc("erf", [](Float t) { return Tmath::erf(t * 3); });
+    benchFunc("erfinv", [](Float t) { return Tmath::erfinv(t); });
+    benchFunc("atan2", [](Float t) { return Tmath::atan2(t, Float(0.3)); });
+    benchFunc("acos", [](Float t) { return Tmath::acos(t); });
+}
+
+int main(int argc, char** argv)
+{
+    bench::parseOptions(argc, argv);
+    benchMath<pre::precise_math>("precise_math/");
+    benchMath<pre::fast_math>("fast_math/");
+    return EXIT_SUCCESS;
+}
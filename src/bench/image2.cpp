@@ -0,0 +1,110 @@
+#include <vector>
+#include <preform/random.hpp>
+#include <preform/multi_random.hpp>
+#include <preform/image2.hpp>
+#include <preform/image_filters.hpp>
+#include <preform/simplex_noise2.hpp>
+#include "bench.hpp"
+
+// Float type.
+typedef float Float;
+
+// 2-dimensional vector type.
+typedef pre::vec2<Float> Vec2f;
+
+// Image.
+typedef pre::image2<Float, Float, 3> Image2x3;
+
+// Image Mitchell filter.
+typedef pre::mitchell_filter2<Float> MitchellFilter2;
+
+// Simplex noise.
+typedef pre::simplex_noise2<Float> SimplexNoise2;
+
+// Fill image with noise.
+void fillImage(Image2x3& image, std::size_t size)
+{
+    SimplexNoise2 noise(1);
+    image.resize({size, size});
+    for (std::size_t i = 0; i < size; i++)
+    for (std::size_t j = 0; j < size; j++) {
+        Vec2f loc = Vec2f{Float(i), Float(j)} / 32;
+        image(i, j) = {
+            noise.evaluate(loc),
+            noise.evaluate(loc + 17),
+            noise.evaluate(loc + 31)
+        };
+    }
+}
+
+int main(int argc, char** argv)
+{
+    bench::parseOptions(argc, argv);
+
+    Image2x3 source;
+    fillImage(source, 512);
+    Image2x3 image;
+
+    // Resample up and down, for each up-sampling method.
+    for (int samp : {0, 1, 3}) {
+        std::string suffix = std::to_string(samp);
+        bench::run("image2/resample_up_samp" + suffix, 1024 * 1024,
+            [&] { image = source; },
+            [&] {
+                image.resample(samp, {1024, 1024});
+                bench::keep(image(0, 0));
+            });
+    }
+    bench::run("image2/resample_down", 256 * 256,
+        [&] { image = source; },
+        [&] {
+            image.resample(1, {256, 256});
+            bench::keep(image(0, 0));
+        });
+    bench::run("image2/resample_separable", 1024 * 1024,
+        [&] { image = source; },
+        [&] {
+            image.resample_separable({1024, 1024}, MitchellFilter2());
+            bench::keep(image(0, 0));
+        });
+
+    // Mip downsample, items are source pixels.
+    bench::run("image2/mip_downsample", 512 * 512,
+        [&] { image = source; },
+        [&] {
+            image.mip_downsample();
+            bench::keep(image(0, 0));
+        });
+
+    // Mip chain, items are source pixels.
+    bench::run("image2/mip_chain", 512 * 512,
+        [&] { image = source; },
+        [&] {
+            while (!(image.user_size() == 1U).any()) {
+                image.mip_downsample();
+            }
+            bench::keep(image(0, 0));
+        });
+
+    // Reconstruct splats.
+    {
+        const int n = 262144;
+        pre::pcg32 pcg(1);
+        std::vector<Vec2f> locs(n);
+        for (Vec2f& loc : locs) {
+            loc = pre::generate_canonical<Float, 2>(pcg) * 512;
+        }
+        bench::run("image2/reconstruct", n,
+            [&] { image.clear(); image.resize({512, 512}); },
+            [&] {
+                for (const Vec2f& loc : locs) {
+                    image.reconstruct(
+                        pre::vec3<Float>{1, 1, 1}, loc,
+                        Vec2f{2, 2}, MitchellFilter2());
+                }
+                bench::keep(image(0, 0));
+            });
+    }
+
+    return EXIT_SUCCESS;
+}
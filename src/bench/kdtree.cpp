@@ -0,0 +1,99 @@
+#include <vector>
+#include <preform/random.hpp>
+#include <preform/multi_random.hpp>
+#include <preform/kdtree.hpp>
+#include "bench.hpp"
+
+// Float type.
+typedef float Float;
+
+// 3-dimensional vector type.
+typedef pre::vec3<Float> Vec3f;
+
+// Kd tree.
+typedef pre::kdtree<Float, 3, int> KdTree3;
+
+// Linear kd tree.
+typedef pre::linear_kdtree<Float, 3, int> LinearKdTree3;
+
+int main(int argc, char** argv)
+{
+    bench::parseOptions(argc, argv);
+
+    // Generate points.
+    pre::pcg32 pcg(1);
+    const int npoints = 262144;
+    std::vector<Vec3f> points(npoints);
+    for (Vec3f& point : points) {
+        point = pre::generate_canonical<Float, 3>(pcg);
+    }
+
+    // Generate queries.
+    const int nqueries = 16384;
+    std::vector<Vec3f> queries(nqueries);
+    for (Vec3f& query : queries) {
+        query = pre::generate_canonical<Float, 3>(pcg);
+    }
+
+    // Value constructor.
+    auto func = [&](const Vec3f& point) {
+        return KdTree3::value_type(point, int(&point - &points[0]));
+    };
+
+    // Build.
+    {
+        KdTree3 tree;
+        bench::run("kdtree/build", npoints,
+            [&] { tree.clear(); },
+            [&] {
+                tree.init(points.begin(), points.end(), func);
+                bench::keep(tree);
+            });
+    }
+
+    KdTree3 tree;
+    tree.init(points.begin(), points.end(), func);
+    LinearKdTree3 linear_tree(tree);
+
+    // Nearest neighbor.
+    bench::run("kdtree/nearest", nqueries, [&] {
+        Float dist2 = 0;
+        for (const Vec3f& query : queries) {
+            dist2 += tree.nearest(query).second;
+        }
+        bench::keep(dist2);
+    });
+    bench::run("linear_kdtree/nearest", nqueries, [&] {
+        Float dist2 = 0;
+        for (const Vec3f& query : queries) {
+            dist2 += linear_tree.nearest(query).second;
+        }
+        bench::keep(dist2);
+    });
+
+    // K nearest neighbors.
+    for (int k : {8, 32}) {
+        std::vector<KdTree3::node_dist2_pair_type> near(k * nqueries);
+        std::vector<LinearKdTree3::value_dist2_pair_type> linear_near(k);
+        std::string suffix = std::to_string(k);
+        bench::run("kdtree/nearest_k" + suffix, nqueries, [&] {
+            for (const Vec3f& query : queries) {
+                tree.nearest(query, &near[0], &near[0] + k);
+            }
+            bench::keep(near[0]);
+        });
+        bench::run("kdtree/nearest_k" + suffix + "_batch", nqueries, [&] {
+            tree.nearest(&queries[0], nqueries, k, &near[0]);
+            bench::keep(near[0]);
+        });
+        bench::run("linear_kdtree/nearest_k" + suffix, nqueries, [&] {
+            for (const Vec3f& query : queries) {
+                linear_tree.nearest(
+                        query, &linear_near[0], &linear_near[0] + k);
+            }
+            bench::keep(linear_near[0]);
+        });
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,94 @@
+#include <vector>
+#include <preform/random.hpp>
+#include <preform/multi_random.hpp>
+#include <preform/microsurface.hpp>
+#include "bench.hpp"
+
+// Float type.
+typedef float Float;
+
+// 2-dimensional vector type.
+typedef pre::vec2<Float> Vec2f;
+
+// 3-dimensional vector type.
+typedef pre::vec3<Float> Vec3f;
+
+// Lambertian with Trowbridge-Reitz slope distribution.
+typedef pre::microsurface_lambertian_bsdf<
+        Float,
+        pre::microsurface_trowbridge_reitz_slope,
+        pre::microsurface_uniform_height>
+            LambertianTrowbridgeReitz;
+
+// Dielectric with Beckmann slope distribution.
+typedef pre::microsurface_dielectric_bsdf<
+        Float,
+        pre::microsurface_beckmann_slope,
+        pre::microsurface_uniform_height>
+            DielectricBeckmann;
+
+// Dielectric with fast Beckmann slope distribution.
+typedef pre::microsurface_dielectric_bsdf<
+        Float,
+        pre::microsurface_beckmann_slope_fast,
+        pre::microsurface_uniform_height>
+            DielectricBeckmannFast;
+
+// Benchmark fs() and fs_pdf_sample() over direction pairs.
+template <typename Surf>
+void benchSurface(
+        const std::string& name,
+        const Surf& surf,
+        const std::vector<Vec3f>& wos,
+        const std::vector<Vec3f>& wis)
+{
+    std::size_t n = wos.size();
+    pre::pcg32 pcg(1);
+    bench::run(name + "/fs", n, [&] {
+        Float f = 0;
+        for (std::size_t k = 0; k < n; k++) {
+            f += surf.fs(pcg, wos[k], wis[k]);
+        }
+        bench::keep(f);
+    });
+    bench::run(name + "/fs_pdf_sample", n, [&] {
+        Vec3f w = {};
+        for (std::size_t k = 0; k < n; k++) {
+            unsigned order = 0;
+            w += surf.fs_pdf_sample(pcg, wos[k], order);
+        }
+        bench::keep(w);
+    });
+}
+
+int main(int argc, char** argv)
+{
+    bench::parseOptions(argc, argv);
+
+    // Generate direction pairs, outgoing in the upper hemisphere.
+    pre::pcg32 pcg(1);
+    const int n = 16384;
+    std::vector<Vec3f> wos(n);
+    std::vector<Vec3f> wis(n);
+    for (int k = 0; k < n; k++) {
+        wos[k] = Vec3f::cosine_hemisphere_pdf_sample(
+                 pre::generate_canonical<Float, 2>(pcg));
+        wis[k] = Vec3f::uniform_sphere_pdf_sample(
+                 pre::generate_canonical<Float, 2>(pcg));
+    }
+
+    // Roughness.
+    Vec2f alpha = {Float(0.3), Float(0.5)};
+
+    benchSurface(
+        "LambertianTrowbridgeReitz",
+         LambertianTrowbridgeReitz(0.7, 0.3, alpha), wos, wis);
+    benchSurface(
+        "DielectricBeckmann",
+         DielectricBeckmann(1, 1, Float(1) / Float(1.5), alpha), wos, wis);
+    benchSurface(
+        "DielectricBeckmannFast",
+         DielectricBeckmannFast(1, 1, Float(1) / Float(1.5), alpha), wos, wis);
+
+    return EXIT_SUCCESS;
+}
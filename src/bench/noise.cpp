@@ -0,0 +1,77 @@
+#include <vector>
+#include <preform/random.hpp>
+#include <preform/simplex_noise2.hpp>
+#include <preform/simplex_noise3.hpp>
+#include <preform/worley_noise2.hpp>
+#include <preform/worley_noise3.hpp>
+#include "bench.hpp"
+
+// Float type.
+typedef float Float;
+
+// Noise.
+typedef pre::simplex_noise2<Float> SimplexNoise2;
+typedef pre::simplex_noise3<Float> SimplexNoise3;
+typedef pre::worley_noise2<Float> WorleyNoise2;
+typedef pre::worley_noise3<Float> WorleyNoise3;
+
+// Coordinates, in structure-of-arrays layout.
+struct Coords
+{
+    std::vector<Float> t[3];
+};
+
+// Benchmark evaluate() and evaluate_many() over coordinates.
+template <std::size_t N, typename Noise>
+void benchNoise(
+        const std::string& name,
+        const Noise& noise,
+        const Coords& coords)
+{
+    std::size_t n = coords.t[0].size();
+    std::vector<Float> s(n);
+    bench::run(name + "/evaluate", n, [&] {
+        for (std::size_t k = 0; k < n; k++) {
+            pre::multi<Float, N> t;
+            for (std::size_t dim = 0; dim < N; dim++) {
+                t[dim] = coords.t[dim][k];
+            }
+            s[k] = noise.evaluate(t);
+        }
+        bench::keep(s[0]);
+    });
+    bench::run(name + "/evaluate_many", n, [&] {
+        pre::multi<const Float*, N> t;
+        for (std::size_t dim = 0; dim < N; dim++) {
+            t[dim] = &coords.t[dim][0];
+        }
+        noise.evaluate_many(t, n, &s[0]);
+        bench::keep(s[0]);
+    });
+}
+
+int main(int argc, char** argv)
+{
+    bench::parseOptions(argc, argv);
+
+    // Generate coordinates along a jittered scanline pattern, so that
+    // neighboring points mostly share lattice cells.
+    pre::pcg32 pcg(1);
+    const int n = 65536;
+    Coords coords;
+    for (std::vector<Float>& t : coords.t) {
+        t.resize(n);
+    }
+    for (int k = 0; k < n; k++) {
+        coords.t[0][k] = Float(k % 256) / 16;
+        coords.t[1][k] = Float(k / 256) / 16;
+        coords.t[2][k] = pre::generate_canonical<Float>(pcg) * 4;
+    }
+
+    benchNoise<2>("simplex_noise2", SimplexNoise2(1), coords);
+    benchNoise<3>("simplex_noise3", SimplexNoise3(1), coords);
+    benchNoise<2>("worley_noise2", WorleyNoise2(1), coords);
+    benchNoise<3>("worley_noise3", WorleyNoise3(1), coords);
+
+    return EXIT_SUCCESS;
+}
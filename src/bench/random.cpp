@@ -0,0 +1,100 @@
+#include <vector>
+#include <preform/random.hpp>
+#include <preform/piecewise_constant_distribution2.hpp>
+#include "bench.hpp"
+
+// Float type.
+typedef float Float;
+
+// Piecewise constant 2-dimensional distribution.
+typedef pre::piecewise_constant_distribution2<Float>
+        PiecewiseConstantDistribution2;
+
+// Benchmark sampling from distribution.
+template <typename Dist>
+void benchDistribution(const std::string& name, const Dist& dist)
+{
+    const int n = 1048576;
+    pre::pcg32 pcg(1);
+    bench::run(name, n, [&] {
+        typename Dist::value_type x = typename Dist::value_type();
+        for (int k = 0; k < n; k++) {
+            x += dist(pcg);
+        }
+        bench::keep(x);
+    });
+}
+
+int main(int argc, char** argv)
+{
+    bench::parseOptions(argc, argv);
+
+    // Engine.
+    {
+        const int n = 1048576;
+        pre::pcg32 pcg(1);
+        bench::run("pcg32", n, [&] {
+            std::uint32_t x = 0;
+            for (int k = 0; k < n; k++) {
+                x ^= pcg();
+            }
+            bench::keep(x);
+        });
+        bench::run("generate_canonical", n, [&] {
+            Float x = 0;
+            for (int k = 0; k < n; k++) {
+                x += pre::generate_canonical<Float>(pcg);
+            }
+            bench::keep(x);
+        });
+    }
+
+    // Univariate distributions.
+    benchDistribution("uniform_int_distribution",
+        pre::uniform_int_distribution<Float>(0, 999));
+    benchDistribution("normal_distribution",
+        pre::normal_distribution<Float>(0, 1));
+    benchDistribution("exponential_distribution",
+        pre::exponential_distribution<Float>(1));
+    benchDistribution("poisson_distribution",
+        pre::poisson_distribution<Float>(4));
+    benchDistribution("poisson_distribution_large",
+        pre::poisson_distribution<Float>(200));
+    benchDistribution("binomial_distribution",
+        pre::binomial_distribution<Float>(100, 0.3));
+
+    // Piecewise constant distributions.
+    {
+        pre::pcg32 pcg(1);
+        std::vector<Float> x(1025);
+        std::vector<Float> y(1024);
+        for (int k = 0; k < 1025; k++) {
+            x[k] = Float(k);
+        }
+        for (Float& yk : y) {
+            yk = pre::generate_canonical<Float>(pcg);
+        }
+        benchDistribution("piecewise_constant_distribution",
+            pre::piecewise_constant_distribution<Float>(
+                x.begin(), x.end(), y.begin()));
+
+        auto func = [&](int k0, int k1) {
+            return y[(k0 * 31 + k1) % 1024];
+        };
+        for (auto mode : {
+                PiecewiseConstantDistribution2::sample_mode::cdfinv,
+                PiecewiseConstantDistribution2::sample_mode::alias,
+                PiecewiseConstantDistribution2::sample_mode::warp}) {
+            const char* suffix =
+                mode == PiecewiseConstantDistribution2::sample_mode::cdfinv ?
+                    "cdfinv" :
+                mode == PiecewiseConstantDistribution2::sample_mode::alias ?
+                    "alias" : "warp";
+            benchDistribution(
+                std::string("piecewise_constant_distribution2/") + suffix,
+                PiecewiseConstantDistribution2({256, 256}, func, mode));
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 #include <random>
@@ -9,6 +10,7 @@
 #include <preform/image2.hpp>
 #include <preform/image_filters.hpp>
 #include <preform/float_interval.hpp>
+#include <preform/thread_pool.hpp>
 #include <preform/option_parser.hpp>
 
 // Float type.
@@ -120,9 +122,32 @@ Vec2f generateCanonical2()
     };
 }
 
+// Average 32 random walks, advanced together as one wavefront.
+template <typename Surf>
+Float averageFs(
+        const Surf& surf,
+        pre::pcg32& gen,
+        const Vec3f& wo,
+        const Vec3f& wi)
+{
+    Vec3f wos[32];
+    Vec3f wis[32];
+    Float fs[32];
+    std::fill(&wos[0], &wos[0] + 32, wo);
+    std::fill(&wis[0], &wis[0] + 32, wi);
+    surf.fs_many(gen, &wos[0], &wis[0], 32, &fs[0]);
+    Float res = 0;
+    for (int j = 0; j < 32; j++) {
+        res = 
+        res + (fs[j] - res) / (j + 1);
+    }
+    return res;
+}
+
 Float brdf(
         int mode,
         Float roughness,
+        pre::pcg32& gen,
         Vec3f wo,
         Vec3f wi)
 {
@@ -142,10 +167,7 @@ Float brdf(
                 Vec2f{roughness,
                       roughness}
             };
-            for (int j = 0; j < 32; j++) {
-                res = 
-                res + (surf.fs(pcg, wo, wi) - res) / (j + 1);
-            }
+            res = averageFs(surf, gen, wo, wi);
             break;
         }
 
@@ -156,10 +178,7 @@ Float brdf(
                 Vec2f{roughness,
                       roughness}
             };
-            for (int j = 0; j < 32; j++) {
-                res = 
-                res + (surf.fs(pcg, wo, wi) - res) / (j + 1);
-            }
+            res = averageFs(surf, gen, wo, wi);
             break;
         }
 
@@ -171,10 +190,7 @@ Float brdf(
                 Vec2f{roughness,
                       roughness}
             };
-            for (int j = 0; j < 32; j++) {
-                res = 
-                res + (surf.fs(pcg, wo, wi) - res) / (j + 1);
-            }
+            res = averageFs(surf, gen, wo, wi);
             break;
         }
 
@@ -186,10 +202,7 @@ Float brdf(
                 Vec2f{roughness,
                       roughness}
             };
-            for (int j = 0; j < 32; j++) {
-                res = 
-                res + (surf.fs(pcg, wo, wi) - res) / (j + 1);
-            }
+            res = averageFs(surf, gen, wo, wi);
             break;
         }
 
@@ -199,10 +212,7 @@ Float brdf(
                 Vec2f{roughness,
                       roughness}
             };
-            for (int j = 0; j < 32; j++) {
-                res = 
-                res + (surf.fs(pcg, wo, wi) - res) / (j + 1);
-            }
+            res = averageFs(surf, gen, wo, wi);
             break;
         }
 
@@ -212,10 +222,7 @@ Float brdf(
                 Vec2f{roughness,
                       roughness}
             };
-            for (int j = 0; j < 32; j++) {
-                res = 
-                res + (surf.fs(pcg, wo, wi) - res) / (j + 1);
-            }
+            res = averageFs(surf, gen, wo, wi);
             break;
         }
 
@@ -491,11 +498,18 @@ int main(int argc, char** argv)
     l0 = pre::normalize(l0);
     l1 = pre::normalize(l1);
 
-    for (int i = 0; i < image_dim[0]; i++)
-    for (int j = 0; j < image_dim[1]; j++) {
-        // Supersample.
+    // Evaluate supersamples in parallel, one row per task, then
+    // reconstruct sequentially, since filter footprints overlap.
+    std::vector<Float> samples(image_dim[0] * image_dim[1] * 9);
+    std::vector<char> samples_hit(image_dim[0] * image_dim[1] * 9);
+    pre::thread_pool pool;
+    pool.parallel_for(0, image_dim[0], 1, [&](int i) {
+        // Permuted congruential generator, one stream per row.
+        pre::pcg32 gen(seed, i);
+        for (int j = 0; j < image_dim[1]; j++)
         for (int k = 0; k < 3; k++)
         for (int l = 0; l < 3; l++) {
+            int sample_index = ((i * image_dim[1] + j) * 3 + k) * 3 + l;
             Vec2f image_loc = {
                 Float(i) + Float(k) / 3,
                 Float(j) + Float(l) / 3
@@ -517,10 +531,27 @@ int main(int argc, char** argv)
                 Vec3f wo = pre::dot(pre::transpose(tbn), -ray.d);
                 Vec3f wi0 = pre::dot(pre::transpose(tbn), l0);
                 Vec3f wi1 = pre::dot(pre::transpose(tbn), l1);
-                Vec1f f = {
-                    brdf(mode, roughness, wo, wi0) +
-                    brdf(mode, roughness, wo, wi1)
+                samples[sample_index] =
+                    brdf(mode, roughness, gen, wo, wi0) +
+                    brdf(mode, roughness, gen, wo, wi1);
+                samples_hit[sample_index] = 1;
+            }
+        }
+    });
+    pool.shutdown();
+
+    for (int i = 0; i < image_dim[0]; i++)
+    for (int j = 0; j < image_dim[1]; j++) {
+        // Supersample.
+        for (int k = 0; k < 3; k++)
+        for (int l = 0; l < 3; l++) {
+            int sample_index = ((i * image_dim[1] + j) * 3 + k) * 3 + l;
+            if (samples_hit[sample_index]) {
+                Vec2f image_loc = {
+                    Float(i) + Float(k) / 3,
+                    Float(j) + Float(l) / 3
                 };
+                Vec1f f = {samples[sample_index]};
                 image.reconstruct(
                         f / 9,
                         image_loc,
@@ -1,5 +1,7 @@
+#include <algorithm>
 #include <iostream>
 #include <random>
+#include <sstream>
 #include <preform/random.hpp>
 #include <preform/multi_random.hpp>
 #include <preform/memory_arena.hpp>
@@ -25,6 +27,16 @@ typedef pre::aabbtree3<Float,
 // Linear axis-aligned bounding box tree.
 typedef pre::linear_aabbtree3<float> LinearAABBTree3;
 
+// Wide axis-aligned bounding box trees.
+typedef pre::wide_aabbtree3<float, 4> WideAABBTree3x4;
+typedef pre::wide_aabbtree3<float, 8> WideAABBTree3x8;
+
+// Quantized linear axis-aligned bounding box trees.
+typedef pre::quantized_linear_aabbtree3<float, std::uint8_t>
+        QuantizedLinearAABBTree3x8;
+typedef pre::quantized_linear_aabbtree3<float, std::uint16_t>
+        QuantizedLinearAABBTree3x16;
+
 // Timer.
 typedef pre::steady_timer Timer;
 
@@ -43,6 +55,26 @@ Vec3f generateCanonical3()
     return pre::generate_canonical<Float, 3>(pcg);
 }
 
+// Ray-box intersection parameter, or infinity if none.
+Float rayBox(
+        const AABB3f& box,
+        const Vec3f& ray_org,
+        const Vec3f& ray_dir,
+        Float tmin,
+        Float tmax)
+{
+    for (int k = 0; k < 3; k++) {
+        Float t0 = (box[0][k] - ray_org[k]) / ray_dir[k];
+        Float t1 = (box[1][k] - ray_org[k]) / ray_dir[k];
+        if (t0 > t1) {
+            std::swap(t0, t1);
+        }
+        tmin = std::max(tmin, t0);
+        tmax = std::min(tmax, t1);
+    }
+    return tmin <= tmax ? tmin : pre::numeric_limits<Float>::infinity();
+}
+
 int depth_histogram[64] = {};
 
 int count_histogram[16] = {};
@@ -63,6 +95,134 @@ void process(const LinearAABBTree3::node_type* node, int depth = 0)
     }
 }
 
+// Check parent and child links and boxes, counting proxies.
+bool checkLinks(
+        const AABBTree3& tree,
+        const AABBTree3::node_type* node,
+        const AABBTree3::node_type* parent,
+        std::size_t& nproxies)
+{
+    if (node->parent != parent) {
+        return false;
+    }
+    if (!node->count) {
+        return node->left && node->right &&
+               node->box.contains<true, true>(node->left->box) &&
+               node->box.contains<true, true>(node->right->box) &&
+               checkLinks(tree, node->left, node, nproxies) &&
+               checkLinks(tree, node->right, node, nproxies);
+    }
+    for (std::size_t pos = node->first_index;
+                     pos < node->first_index + node->count; pos++) {
+        const auto& proxy = tree.proxies()[pos];
+        if (proxy.value_index == AABBTree3::npos ||
+            !node->box.contains<true, true>(proxy.box)) {
+            return false;
+        }
+        nproxies++;
+    }
+    return true;
+}
+
+// Test dynamic updates.
+void testDynamic(int nboxes, int nops)
+{
+    std::cout << "Testing dynamic updates:\n";
+    std::cout << "This test initializes a tree of " << nboxes << " boxes,\n";
+    std::cout << "then randomly inserts, removes, and updates boxes " << nops;
+    std::cout << "\ntimes. After each operation, it checks parent and child\n";
+    std::cout << "links and boxes, and compares an overlap query against a\n";
+    std::cout << "linear scan. This should print 0 bad links and 0\n";
+    std::cout << "mismatched queries.\n";
+    std::cout.flush();
+
+    // Random box.
+    auto generateBox = [](Float size) -> AABB3f {
+        Vec3f point = generateCanonical3() * 100 - 50;
+        Vec3f half_extent = generateCanonical3() * size + Float(0.5);
+        return {point - half_extent, point + half_extent};
+    };
+
+    std::vector<AABB3f> boxes(nboxes);
+    std::vector<bool> alive(nboxes, true);
+    for (AABB3f& box : boxes) {
+        box = generateBox(4);
+    }
+    AABBTree3 tree;
+    tree.init(
+        &boxes[0],
+        &boxes[0] + nboxes,
+        [](const AABB3f& box) -> AABB3f { return box; });
+
+    int nbad_links = 0;
+    int nmismatches = 0;
+    std::size_t nalive = nboxes;
+    std::vector<std::size_t> result;
+    std::vector<std::size_t> expect;
+    for (int op = 0; op < nops; op++) {
+        int kind = pcg(3);
+        if (kind == 0 || nalive == 0) {
+            // Insert.
+            boxes.push_back(generateBox(4));
+            alive.push_back(true);
+            if (tree.insert(boxes.back()) != boxes.size() - 1) {
+                nbad_links++;
+            }
+            nalive++;
+        }
+        else {
+            std::size_t value_index;
+            do {
+                value_index = pcg(boxes.size());
+            } while (!alive[value_index]);
+            if (kind == 1) {
+                // Remove.
+                tree.remove(value_index);
+                alive[value_index] = false;
+                nalive--;
+            }
+            else {
+                // Update.
+                boxes[value_index] = generateBox(8);
+                tree.update(value_index, boxes[value_index]);
+            }
+        }
+
+        // Check links.
+        std::size_t nproxies = 0;
+        if (tree.root() ?
+                !checkLinks(tree, tree.root(), nullptr, nproxies) ||
+                nproxies != nalive : nalive != 0) {
+            nbad_links++;
+        }
+
+        // Check query.
+        AABB3f query_box = generateBox(16);
+        result.clear();
+        expect.clear();
+        tree.overlap(query_box, [&](std::size_t value_index) {
+            result.push_back(value_index);
+        });
+        for (std::size_t value_index = 0;
+                         value_index < boxes.size(); value_index++) {
+            if (alive[value_index] &&
+                boxes[value_index].overlaps<true, true>(query_box)) {
+                expect.push_back(value_index);
+            }
+        }
+        std::sort(result.begin(), result.end());
+        if (result != expect) {
+            nmismatches++;
+        }
+    }
+
+    // Print test result.
+    std::cout << "Result: " << nbad_links << ", " << nmismatches << " ";
+    std::cout << "(" << nalive << " boxes, ";
+    std::cout << tree.node_count() << " nodes)\n\n";
+    std::cout.flush();
+}
+
 int main(int argc, char** argv)
 {
     int seed = 0;
@@ -163,9 +323,78 @@ int main(int argc, char** argv)
     std::cout << "done (" << timer.read<std::micro>() / 1e6 << " sec).\n\n";
     std::cout.flush();
 
-    // Don't need this anymore.
-    delete[] boxes;
-    boxes = nullptr;
+    // Initialize axis-aligned bounding box trees in parallel.
+    std::cout << "Initializing axis-aligned bounding box trees "
+                 "in parallel... ";
+    std::cout.flush();
+    {
+        pre::thread_pool pool;
+        timer = Timer();
+        AABBTree3 parallel_tree;
+        parallel_tree.init(
+            pool,
+            &boxes[0],
+            &boxes[0] + nboxes,
+            [](const AABB3f& box) -> AABB3f { return box; });
+        double parallel_time = timer.read<std::micro>() / 1e6;
+        timer = Timer();
+        AABBTree3 parallel_morton_tree;
+        parallel_morton_tree.init_morton(
+            pool,
+            &boxes[0],
+            &boxes[0] + nboxes,
+            [](const AABB3f& box) -> AABB3f { return box; });
+        std::cout << "done (" << parallel_time << " sec, ";
+        std::cout << timer.read<std::micro>() / 1e6 << " sec from "
+                     "Morton codes, ";
+        std::cout << parallel_tree.node_count() << " nodes, ";
+        std::cout << parallel_morton_tree.node_count() << " nodes from "
+                     "Morton codes).\n\n";
+        std::cout.flush();
+    }
+
+    // Initialize axis-aligned bounding box tree from Morton codes.
+    std::cout << "Initializing axis-aligned bounding box tree "
+                 "(Morton codes)... ";
+    std::cout.flush();
+    timer = Timer();
+    {
+        AABBTree3 morton_tree;
+        morton_tree.init_morton(
+            &boxes[0],
+            &boxes[0] + nboxes,
+            [](const AABB3f& box) -> AABB3f { return box; });
+        double morton_time = timer.read<std::micro>() / 1e6;
+        LinearAABBTree3 morton_linear_tree(morton_tree);
+        double area = 0;
+        double morton_area = 0;
+        LinearAABBTree3 sah_linear_tree(*tree);
+        for (const auto& node : sah_linear_tree) {
+            area += node.box.surface_area();
+        }
+        for (const auto& node : morton_linear_tree) {
+            morton_area += node.box.surface_area();
+        }
+        std::cout << "done (" << morton_time << " sec, ";
+        std::cout << morton_tree.node_count() << " nodes, ";
+        std::cout << morton_area / area << "x total surface area).\n\n";
+        std::cout.flush();
+    }
+
+    // Sort boxes to match proxies.
+    tree->sort(&boxes[0], &boxes[0] + nboxes);
+
+    // Statistics.
+    std::cout << "Computing axis-aligned bounding box tree statistics... ";
+    std::cout.flush();
+    timer = Timer();
+    pre::aabbtree_stats stats = tree->stats();
+    std::cout << "done (" << timer.read<std::micro>() / 1e6 << " sec, ";
+    std::cout << stats.leaf_count << " leaves, ";
+    std::cout << "max depth " << stats.max_depth << ", ";
+    std::cout << "SAH cost " << stats.sah_cost << ", ";
+    std::cout << "overlap ratio " << stats.overlap_ratio << ").\n\n";
+    std::cout.flush();
 
     // Initialize linear axis-aligned bounding box tree.
     std::cout << "Initializing linear axis-aligned bounding box tree... ";
@@ -175,10 +404,402 @@ int main(int argc, char** argv)
     std::cout << "done (" << timer.read<std::micro>() / 1e6 << " sec).\n\n";
     std::cout.flush();
 
+    // Write and map linear axis-aligned bounding box tree.
+    std::cout << "Writing and mapping linear axis-aligned bounding box "
+                 "tree... ";
+    std::cout.flush();
+    {
+        std::stringstream ss;
+        linear_tree->write(ss);
+        std::string data = ss.str();
+        timer = Timer();
+        LinearAABBTree3 mapped_tree;
+        mapped_tree.map(data.data(), data.size());
+        double map_time = timer.read<std::micro>() / 1e6;
+        std::stringstream swapped_ss;
+        linear_tree->write(
+                swapped_ss,
+                pre::host_byte_order() == pre::byte_order::little ?
+                pre::byte_order::big : pre::byte_order::little);
+        LinearAABBTree3 swapped_tree;
+        swapped_tree.read(swapped_ss);
+        int nmismatches = 0;
+        for (std::size_t k = 0; k < linear_tree->size(); k++) {
+            for (const LinearAABBTree3* other :
+                    {&mapped_tree, &swapped_tree}) {
+                const auto& node0 = (*linear_tree)[k];
+                const auto& node1 = (*other)[k];
+                if (!(node0.box[0] == node1.box[0]).all() ||
+                    !(node0.box[1] == node1.box[1]).all() ||
+                    node0.right_offset != node1.right_offset ||
+                    node0.count != node1.count ||
+                    node0.split_dim != node1.split_dim) {
+                    nmismatches++;
+                }
+            }
+        }
+        std::cout << "done (" << map_time << " sec to map, ";
+        std::cout << data.size() << " bytes, ";
+        std::cout << nmismatches << " mismatches).\n\n";
+        std::cout.flush();
+    }
+
+    // Initialize wide axis-aligned bounding box trees.
+    std::cout << "Initializing wide axis-aligned bounding box trees... ";
+    std::cout.flush();
+    timer = Timer();
+    WideAABBTree3x4* wide_tree4 = new WideAABBTree3x4(*tree);
+    WideAABBTree3x8* wide_tree8 = new WideAABBTree3x8(*tree);
+    std::cout << "done (" << timer.read<std::micro>() / 1e6 << " sec, ";
+    std::cout << linear_tree->size() << " binary nodes, ";
+    std::cout << wide_tree4->size() << " 4-wide nodes, ";
+    std::cout << wide_tree8->size() << " 8-wide nodes).\n\n";
+    std::cout.flush();
+
+    // Initialize quantized linear axis-aligned bounding box trees.
+    std::cout << "Initializing quantized linear axis-aligned "
+                 "bounding box trees... ";
+    std::cout.flush();
+    timer = Timer();
+    QuantizedLinearAABBTree3x8* quantized_tree8 =
+        new QuantizedLinearAABBTree3x8(*tree);
+    QuantizedLinearAABBTree3x16* quantized_tree16 =
+        new QuantizedLinearAABBTree3x16(*tree);
+    std::cout << "done (" << timer.read<std::micro>() / 1e6 << " sec, ";
+    std::cout << sizeof(LinearAABBTree3::node_type) << " bytes per node, ";
+    std::cout << sizeof(QuantizedLinearAABBTree3x8::node_type)
+              << " bytes per 8-bit node, ";
+    std::cout << sizeof(QuantizedLinearAABBTree3x16::node_type)
+              << " bytes per 16-bit node).\n\n";
+    std::cout.flush();
+
+    // Update dynamically.
+    {
+        std::cout << "Updating " << nboxes / 16 << " random boxes "
+                     "dynamically... ";
+        std::cout.flush();
+        AABBTree3 dynamic_tree;
+        dynamic_tree.init(
+            &boxes[0],
+            &boxes[0] + nboxes,
+            [](const AABB3f& box) -> AABB3f { return box; });
+        timer = Timer();
+        for (int k = 0; k < nboxes / 16; k++) {
+            int value_index = pcg(nboxes);
+            Vec3f offset = generateCanonical3() * 2 - 1;
+            dynamic_tree.update(
+                value_index, {
+                boxes[value_index][0] + offset,
+                boxes[value_index][1] + offset
+            });
+        }
+        for (int k = 0; k < nboxes / 256; k++) {
+            Vec3f point = generateCanonical3() * 500 - 250;
+            dynamic_tree.remove(k * 2);
+            dynamic_tree.insert({point - 1, point + 1});
+        }
+        std::cout << "done (" << timer.read<std::micro>() / 1e6 << " sec, ";
+        std::cout << dynamic_tree.node_count() << " nodes).\n\n";
+        std::cout.flush();
+    }
+
+    // Dynamic updates.
+    testDynamic(1024, 4096);
+
+    // Insert degenerately.
+    {
+        std::cout << "Testing deep traversal:\n";
+        std::cout << "This test inserts 4096 boxes of exponentially\n";
+        std::cout << "growing extent, which makes the tree far deeper than\n";
+        std::cout << "the static traversal stack, then queries an overlap\n";
+        std::cout << "containing everything. This should count to 4096.\n";
+        std::cout.flush();
+        AABBTree3 deep_tree;
+        for (int k = 0; k < 4096; k++) {
+            Float extent = std::ldexp(Float(1), k % 100);
+            deep_tree.insert({
+                Vec3f{Float(k), 0, 0},
+                Vec3f{Float(k) + extent, extent, extent}
+            });
+        }
+        std::size_t noverlaps = 0;
+        deep_tree.overlap(
+            AABB3f{Vec3f(Float(0)), Vec3f(Float(1e30))},
+            [&](std::size_t) { noverlaps++; });
+        std::cout << "Result: " << noverlaps << " ";
+        std::cout << "(" << deep_tree.stats().max_depth << " depth)\n\n";
+        std::cout.flush();
+    }
+
+    // Overlap queries.
+    {
+        std::cout << "Querying 4096 random boxes for overlaps... ";
+        std::cout.flush();
+        std::vector<AABB3f> query_boxes(4096);
+        for (AABB3f& query_box : query_boxes) {
+            Vec3f point = generateCanonical3() * 500 - 250;
+            Vec3f half_extent = generateCanonical3() * 4 + 1;
+            query_box = {
+                point - half_extent,
+                point + half_extent
+            };
+        }
+        timer = Timer();
+        std::size_t noverlaps = 0;
+        for (const AABB3f& query_box : query_boxes) {
+            tree->overlap(query_box, [&](std::size_t) { noverlaps++; });
+        }
+        std::cout << "done (" << timer.read<std::micro>() / 1e6 << " sec, ";
+        std::cout << noverlaps << " overlaps).\n\n";
+        std::cout.flush();
+
+        std::cout << "Querying overlapping pairs against tree of "
+                     "query boxes... ";
+        std::cout.flush();
+        AABBTree3 query_tree;
+        query_tree.init(query_boxes.begin(), query_boxes.end());
+        timer = Timer();
+        std::size_t npairs = 0;
+        tree->overlapping_pairs(
+            query_tree,
+            [&](std::size_t, std::size_t) { npairs++; });
+        double pairs_time = timer.read<std::micro>() / 1e6;
+        pre::thread_pool pool;
+        timer = Timer();
+        std::atomic<std::size_t> npairs_parallel(0);
+        tree->overlapping_pairs(
+            pool, query_tree,
+            [&](std::size_t, std::size_t) { npairs_parallel++; });
+        std::cout << "done (" << pairs_time << " sec, ";
+        std::cout << timer.read<std::micro>() / 1e6 << " sec in parallel, ";
+        std::cout << npairs << " pairs, ";
+        std::cout << npairs_parallel << " pairs in parallel).\n\n";
+        std::cout.flush();
+    }
+
     // Don't need this anymore.
     delete tree;
     tree = nullptr;
 
+    // Ray traversal.
+    {
+        // Intersect against box proxy.
+        auto intersect = [&](
+                const Vec3f& ray_org,
+                const Vec3f& ray_dir,
+                std::size_t index, Float tmin, Float& tmax) -> bool {
+            Float t = rayBox(boxes[index], ray_org, ray_dir, tmin, tmax);
+            if (t < tmax) {
+                tmax = t;
+                return true;
+            }
+            return false;
+        };
+
+        // Check closest hits against brute force.
+        std::cout << "Checking closest hits against brute force... ";
+        std::cout.flush();
+        int nmismatches = 0;
+        for (int ray = 0; ray < 256; ray++) {
+            Vec3f ray_org = generateCanonical3() * 600 - 300;
+            Vec3f ray_dir = generateCanonical3() * 2 - 1;
+            Float tmax0 = pre::numeric_limits<Float>::infinity();
+            Float tmax1 = pre::numeric_limits<Float>::infinity();
+            for (int k = 0; k < nboxes; k++) {
+                intersect(ray_org, ray_dir, k, 0, tmax0);
+            }
+            linear_tree->ray_closest_hit(
+                ray_org, ray_dir, 0, tmax1,
+                [&](std::size_t index, Float tmin, Float& tmax) {
+                    return intersect(ray_org, ray_dir, index, tmin, tmax);
+                });
+            if (!(tmax0 == tmax1)) {
+                nmismatches++;
+            }
+        }
+        std::cout << "done (" << nmismatches << " mismatches).\n\n";
+        std::cout.flush();
+
+        // Time any hit and closest hit.
+        for (int any_hit = 1; any_hit >= 0; any_hit--) {
+            std::cout << "Tracing 65536 random rays ("
+                      << (any_hit ? "any hit" : "closest hit") << ")... ";
+            std::cout.flush();
+            int nhits = 0;
+            timer = Timer();
+            for (int ray = 0; ray < 65536; ray++) {
+                Vec3f ray_org = generateCanonical3() * 600 - 300;
+                Vec3f ray_dir = generateCanonical3() * 2 - 1;
+                Float tmax = pre::numeric_limits<Float>::infinity();
+                auto func =
+                [&](std::size_t index, Float tmin, Float& tmax) {
+                    return intersect(ray_org, ray_dir, index, tmin, tmax);
+                };
+                if (any_hit) {
+                    nhits += linear_tree->ray_any_hit(
+                            ray_org, ray_dir, 0, tmax, func);
+                }
+                else {
+                    nhits += linear_tree->ray_closest_hit(
+                            ray_org, ray_dir, 0, tmax, func) !=
+                            LinearAABBTree3::npos;
+                }
+            }
+            std::cout << "done (" << timer.read<std::micro>() / 1e6
+                      << " sec, " << nhits << " hits).\n\n";
+            std::cout.flush();
+        }
+
+        // Trace other trees, checking against binary tree.
+        auto traceOther = [&](const auto& other_tree, const char* name) {
+            std::cout << "Tracing 65536 random rays (closest hit, "
+                      << name << ")... ";
+            std::cout.flush();
+            int nhits = 0;
+            int nmismatches = 0;
+            double other_time = 0;
+            for (int ray = 0; ray < 65536; ray++) {
+                Vec3f ray_org = generateCanonical3() * 600 - 300;
+                Vec3f ray_dir = generateCanonical3() * 2 - 1;
+                auto func =
+                [&](std::size_t index, Float tmin, Float& tmax) {
+                    return intersect(ray_org, ray_dir, index, tmin, tmax);
+                };
+                Float tmax0 = pre::numeric_limits<Float>::infinity();
+                Float tmax1 = pre::numeric_limits<Float>::infinity();
+                linear_tree->ray_closest_hit(ray_org, ray_dir, 0, tmax0, func);
+                timer = Timer();
+                nhits += other_tree.ray_closest_hit(
+                        ray_org, ray_dir, 0, tmax1, func) != other_tree.npos;
+                other_time += timer.read<std::micro>() / 1e6;
+                if (!(tmax0 == tmax1)) {
+                    nmismatches++;
+                }
+            }
+            std::cout << "done (" << other_time << " sec, "
+                      << nhits << " hits, "
+                      << nmismatches << " mismatches).\n\n";
+            std::cout.flush();
+        };
+        traceOther(*wide_tree4, "4-wide");
+        traceOther(*wide_tree8, "8-wide");
+        traceOther(*quantized_tree8, "8-bit quantized");
+        traceOther(*quantized_tree16, "16-bit quantized");
+
+        // Trace coherent packets, checking against single rays.
+        std::cout << "Tracing 8192 coherent 8-ray packets... ";
+        std::cout.flush();
+        {
+            int nhits = 0;
+            int nmismatches = 0;
+            double packet_time = 0;
+            for (int packet_index = 0; packet_index < 8192; packet_index++) {
+                LinearAABBTree3::ray_packet<8> packet;
+                Vec3f ray_org = generateCanonical3() * 600 - 300;
+                Vec3f ray_dir = generateCanonical3() * 2 - 1;
+                for (int lane = 0; lane < 8; lane++) {
+                    Vec3f lane_dir =
+                        ray_dir + (generateCanonical3() * 2 - 1) * 0.01f;
+                    for (int k = 0; k < 3; k++) {
+                        packet.org[k][lane] = ray_org[k];
+                        packet.dir[k][lane] = lane_dir[k];
+                    }
+                    packet.tmin[lane] = 0;
+                    packet.tmax[lane] = pre::numeric_limits<Float>::infinity();
+                }
+                pre::multi<std::size_t, 8> hit_index;
+                timer = Timer();
+                std::uint32_t hit_mask =
+                linear_tree->ray_packet_closest_hit(
+                    packet, hit_index, 0xFF,
+                    [&](std::size_t index, std::size_t lane,
+                        Float tmin, Float& tmax) {
+                        Vec3f lane_dir = {
+                            packet.dir[0][lane],
+                            packet.dir[1][lane],
+                            packet.dir[2][lane]
+                        };
+                        return intersect(
+                               ray_org, lane_dir, index, tmin, tmax);
+                    });
+                packet_time += timer.read<std::micro>() / 1e6;
+                for (int lane = 0; lane < 8; lane++) {
+                    Vec3f lane_dir = {
+                        packet.dir[0][lane],
+                        packet.dir[1][lane],
+                        packet.dir[2][lane]
+                    };
+                    Float tmax = pre::numeric_limits<Float>::infinity();
+                    linear_tree->ray_closest_hit(
+                        ray_org, lane_dir, 0, tmax,
+                        [&](std::size_t index, Float tmin, Float& tmax) {
+                            return intersect(
+                                   ray_org, lane_dir, index, tmin, tmax);
+                        });
+                    if (!(tmax == packet.tmax[lane])) {
+                        nmismatches++;
+                    }
+                    nhits += (hit_mask >> lane) & 1;
+                }
+            }
+            std::cout << "done (" << packet_time << " sec, "
+                      << nhits << " hits, "
+                      << nmismatches << " mismatches).\n\n";
+            std::cout.flush();
+        }
+
+        // Trace incoherent stream, checking against single rays.
+        std::cout << "Tracing 65536 random rays (stream closest hit)... ";
+        std::cout.flush();
+        {
+            std::vector<Vec3f> ray_org(65536);
+            std::vector<Vec3f> ray_dir(65536);
+            std::vector<Float> ray_tmin(65536, 0);
+            std::vector<Float> ray_tmax(65536,
+                    pre::numeric_limits<Float>::infinity());
+            std::vector<std::size_t> hit_index(65536);
+            for (int ray = 0; ray < 65536; ray++) {
+                ray_org[ray] = generateCanonical3() * 600 - 300;
+                ray_dir[ray] = generateCanonical3() * 2 - 1;
+            }
+            timer = Timer();
+            std::size_t nhits =
+            linear_tree->ray_stream_closest_hit(
+                65536,
+                ray_org.data(), ray_dir.data(),
+                ray_tmin.data(), ray_tmax.data(),
+                hit_index.data(),
+                [&](std::size_t index, std::size_t ray,
+                    Float tmin, Float& tmax) {
+                    return intersect(
+                           ray_org[ray], ray_dir[ray], index, tmin, tmax);
+                });
+            double stream_time = timer.read<std::micro>() / 1e6;
+            int nmismatches = 0;
+            for (int ray = 0; ray < 65536; ray++) {
+                Float tmax = pre::numeric_limits<Float>::infinity();
+                linear_tree->ray_closest_hit(
+                    ray_org[ray], ray_dir[ray], 0, tmax,
+                    [&](std::size_t index, Float tmin, Float& tmax) {
+                        return intersect(
+                               ray_org[ray], ray_dir[ray],
+                               index, tmin, tmax);
+                    });
+                if (!(tmax == ray_tmax[ray])) {
+                    nmismatches++;
+                }
+            }
+            std::cout << "done (" << stream_time << " sec, "
+                      << nhits << " hits, "
+                      << nmismatches << " mismatches).\n\n";
+            std::cout.flush();
+        }
+    }
+
+    // Don't need this anymore.
+    delete[] boxes;
+    boxes = nullptr;
+
     try {
         // Process.
         process(linear_tree->begin());
@@ -235,8 +856,28 @@ int main(int argc, char** argv)
     std::cout << "\n";
     std::cout.flush();
 
+    // Histograms should match statistics.
+    bool stats_match = true;
+    for (int depth = 0; depth < 64; depth++) {
+        stats_match &= depth_histogram[depth] == int(
+            depth < int(stats.depth_histogram.size()) ?
+                stats.depth_histogram[depth] : 0);
+    }
+    for (int count = 0; count < 16; count++) {
+        stats_match &= count_histogram[count] == int(
+            count < int(stats.leaf_size_histogram.size()) ?
+                stats.leaf_size_histogram[count] : 0);
+    }
+    std::cout << "Histograms match statistics? ";
+    std::cout << (stats_match ? "Yes" : "No") << "\n\n";
+    std::cout.flush();
+
     // Clean up.
     delete linear_tree;
+    delete wide_tree4;
+    delete wide_tree8;
+    delete quantized_tree8;
+    delete quantized_tree16;
 
     // Done.
     return EXIT_SUCCESS;
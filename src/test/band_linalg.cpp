@@ -0,0 +1,250 @@
+#include <algorithm>
+#include <complex>
+#include <iostream>
+#include <random>
+#include <vector>
+#include <preform/random.hpp>
+#include <preform/option_parser.hpp>
+#include <preform/band_linalg.hpp>
+
+// Float type.
+typedef double Float;
+
+// Complex type.
+typedef std::complex<Float> Complex;
+
+// Permuted congruential generator.
+pre::pcg32 pcg;
+
+// Generate random value in [-1,1).
+template <typename T>
+T generate();
+
+template <>
+Float generate<Float>()
+{
+    return pre::generate_canonical<Float>(pcg) * 2 - 1;
+}
+
+template <>
+Complex generate<Complex>()
+{
+    return {generate<Float>(), generate<Float>()};
+}
+
+// Band matrix, stored by diagonals in columns.
+template <typename T>
+struct BandMatrix
+{
+    int n = 0;
+    int kl = 0;
+    int ku = 0;
+    std::vector<T> values;
+
+    BandMatrix(int n, int kl, int ku) :
+        n(n), kl(kl), ku(ku), values(std::size_t(kl + ku + 1) * n)
+    {
+    }
+
+    // Entry, zero outside the band.
+    T operator()(int i, int j) const
+    {
+        if (i - j > kl || j - i > ku) {
+            return T();
+        }
+        return values[std::size_t(j) * (kl + ku + 1) + ku + i - j];
+    }
+
+    T& operator()(int i, int j)
+    {
+        return values[std::size_t(j) * (kl + ku + 1) + ku + i - j];
+    }
+
+    pre::dense_matrix_view<T*> view()
+    {
+        return {&values[0], 1, kl + ku + 1, kl + ku + 1, n};
+    }
+};
+
+// Maximum relative residual over right-hand sides, where the matrix
+// entry function is Hermitian-aware.
+template <typename T, typename Entry>
+Float residual(
+        Entry&& entry, int n, int kl, int ku,
+        const std::vector<T>& x, const std::vector<T>& b, int k)
+{
+    Float res = 0;
+    for (int c = 0; c < k; c++) {
+        Float rr = 0;
+        Float bb = 0;
+        for (int i = 0; i < n; i++) {
+            T tmp = b[std::size_t(i) * k + c];
+            for (int j = std::max(i - kl, 0);
+                     j <= std::min(i + ku, n - 1); j++) {
+                tmp -= entry(i, j) * x[std::size_t(j) * k + c];
+            }
+            rr += pre::norm(tmp);
+            bb += pre::norm(b[std::size_t(i) * k + c]);
+        }
+        res = std::max(res, pre::sqrt(rr / bb));
+    }
+    return res;
+}
+
+// Test Cholesky decomposition.
+void testChol()
+{
+    std::cout << "Testing Cholesky decomposition:\n";
+    std::cout << "This test factors 64 random Hermitian positive definite\n";
+    std::cout << "complex band matrices, of size up to 256 with up to 8\n";
+    std::cout << "subdiagonals, solves 3 right-hand sides each, and\n";
+    std::cout << "computes the relative residual. This should print 1 for\n";
+    std::cout << "residuals below 1e-12.\n";
+    std::cout.flush();
+
+    Float max_res = 0;
+    for (int count = 0; count < 64; count++) {
+        const int n = 1 + int(pcg(256));
+        const int kl = int(pcg(9));
+        const int k = 3;
+
+        // Lower triangle, with diagonal dominance.
+        BandMatrix<Complex> a(n, kl, 0);
+        for (int j = 0; j < n; j++) {
+            a(j, j) = 3 * kl + 1 + pre::generate_canonical<Float>(pcg);
+            for (int i = j + 1; i <= std::min(j + kl, n - 1); i++) {
+                a(i, j) = generate<Complex>();
+            }
+        }
+        auto entry = [&](int i, int j) {
+            return i >= j ? a(i, j) : pre::conj(a(j, i));
+        };
+        std::vector<Complex> b(std::size_t(n) * k);
+        for (Complex& value : b) {
+            value = generate<Complex>();
+        }
+
+        // Factor and solve.
+        BandMatrix<Complex> l = a;
+        std::vector<Complex> x = b;
+        pre::band_linalg<Complex>::chol(l.view());
+        pre::band_linalg<Complex>::chol_solve(
+                l.view(), {&x[0], k, 1, n, k});
+        max_res = std::max(max_res, residual(entry, n, kl, kl, x, b, k));
+    }
+
+    // Print test result.
+    std::cout << "Result: " << (max_res < Float(1e-12)) << " ";
+    std::cout << "(" << max_res << ")\n\n";
+    std::cout.flush();
+}
+
+// Test LU-decomposition.
+void testLu()
+{
+    std::cout << "Testing LU-decomposition:\n";
+    std::cout << "This test factors 64 random diagonally dominant band\n";
+    std::cout << "matrices, of size up to 256 with up to 8 subdiagonals\n";
+    std::cout << "and superdiagonals, solves 3 right-hand sides each, and\n";
+    std::cout << "computes the relative residual. This should print 1 for\n";
+    std::cout << "residuals below 1e-12.\n";
+    std::cout.flush();
+
+    Float max_res = 0;
+    for (int count = 0; count < 64; count++) {
+        const int n = 1 + int(pcg(256));
+        const int kl = int(pcg(9));
+        const int ku = int(pcg(9));
+        const int k = 3;
+
+        // Band, with diagonal dominance.
+        BandMatrix<Float> a(n, kl, ku);
+        for (int j = 0; j < n; j++) {
+            for (int i = std::max(j - ku, 0);
+                     i <= std::min(j + kl, n - 1); i++) {
+                a(i, j) = generate<Float>();
+            }
+            a(j, j) = (kl + ku + 1) * (pcg(2) ? 1 : -1);
+        }
+        auto entry = [&](int i, int j) {
+            return a(i, j);
+        };
+        std::vector<Float> b(std::size_t(n) * k);
+        for (Float& value : b) {
+            value = generate<Float>();
+        }
+
+        // Factor and solve.
+        BandMatrix<Float> lu = a;
+        std::vector<Float> x = b;
+        pre::band_linalg<Float>::lu(lu.view(), kl);
+        pre::band_linalg<Float>::lu_solve(
+                lu.view(), kl, {&x[0], k, 1, n, k});
+        max_res = std::max(max_res, residual(entry, n, kl, ku, x, b, k));
+    }
+
+    // Print test result.
+    std::cout << "Result: " << (max_res < Float(1e-12)) << " ";
+    std::cout << "(" << max_res << ")\n\n";
+    std::cout.flush();
+}
+
+int main(int argc, char** argv)
+{
+    int seed = 0;
+
+    // Option parser.
+    pre::option_parser opt_parser("[OPTIONS]");
+
+    // Specify seed.
+    opt_parser.on_option(
+    "-s", "--seed", 1,
+    [&](char** argv) {
+        try {
+            seed = std::stoi(argv[0]);
+        }
+        catch (const std::exception&) {
+            throw
+                std::runtime_error(
+                std::string("-s/--seed expects 1 integer ")
+                    .append("(can't parse ").append(argv[0])
+                    .append(")"));
+        }
+    })
+    << "Specify seed. By default, random.\n";
+
+    // Display help.
+    opt_parser.on_option(
+    "-h", "--help", 0,
+    [&](char**) {
+        std::cout << opt_parser << std::endl;
+        std::exit(EXIT_SUCCESS);
+    })
+    << "Display this help and exit.\n";
+
+    try {
+        // Parse args.
+        opt_parser.parse(argc, argv);
+    }
+    catch (const std::exception& exception) {
+        std::cerr << "Unhandled exception!\n";
+        std::cerr << "exception.what(): " << exception.what() << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+
+    // Seed.
+    if (seed == 0) {
+        seed = std::random_device()();
+    }
+    std::cout << "seed = " << seed << "\n\n";
+    std::cout.flush();
+    pcg = pre::pcg32(seed);
+
+    // Cholesky decomposition.
+    testChol();
+
+    // LU-decomposition.
+    testLu();
+
+    return EXIT_SUCCESS;
+}
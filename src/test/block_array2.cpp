@@ -0,0 +1,124 @@
+#include <iostream>
+#include <preform/thread_pool.hpp>
+#include <preform/block_array2.hpp>
+#include <preform/timer.hpp>
+#include <preform/option_parser.hpp>
+
+// Thread pool.
+typedef pre::thread_pool ThreadPool;
+
+// Thread pool mode.
+typedef pre::thread_pool_mode ThreadPoolMode;
+
+// Block array.
+typedef pre::block_array2<long long> BlockArray2;
+
+// Timer.
+typedef pre::steady_timer Timer;
+
+// Test block array algorithms.
+void testBlockArray(const char* name, ThreadPoolMode mode, int nthreads)
+{
+    std::cout << "Testing block array algorithms with " << name << ":\n";
+    std::cout << "This test fills a 1000 by 700 block array with flat\n";
+    std::cout << "indices, then sums a repeating 3 by 3 box filter over it\n";
+    std::cout << "in parallel. This should sum to 2204996850000 both\n";
+    std::cout << "times, with 0 mismatches against the sequential filter.\n";
+    std::cout.flush();
+
+    // Thread pool.
+    ThreadPool thread_pool(nthreads, mode);
+
+    // Sum.
+    auto func = [](const auto&, long long value) { return value; };
+    auto combine = [](long long lhs, long long rhs) { return lhs + rhs; };
+
+    // Box filter.
+    auto filter = [](const auto&, const auto& accessor) {
+        long long value = 0;
+        for (int offset1 = -1; offset1 <= 1; offset1++)
+        for (int offset0 = -1; offset0 <= 1; offset0++) {
+            value += accessor(offset0, offset1);
+        }
+        return value;
+    };
+
+    // Execute.
+    Timer timer;
+    BlockArray2 src({1000, 700});
+    src.for_each_index(thread_pool, [](const auto& loc, long long& value) {
+        value = loc[0] * 700 + loc[1];
+    });
+    BlockArray2 dst;
+    dst.stencil(thread_pool, src, {1, 1}, {1, 1}, filter);
+    BlockArray2 ref;
+    ref.stencil(src, {1, 1}, {1, 1}, filter);
+    long long sum0 = src.reduce(thread_pool, 0LL, func, combine) * 9;
+    long long sum1 = dst.reduce(thread_pool, 0LL, func, combine);
+    long long mismatches =
+    ref.reduce(thread_pool, 0LL,
+        [&](const auto& loc, long long value) {
+            return (long long)(dst[loc] != value);
+        },
+        combine);
+
+    // Print test result.
+    std::cout << "Result: " << sum0 << ", " << sum1 << ", ";
+    std::cout << mismatches << " ";
+    std::cout << "(" << timer.read<std::micro>() / 1e3 << " ms)\n\n";
+    std::cout.flush();
+}
+
+int main(int argc, char** argv)
+{
+    int nthreads = 8;
+
+    // Option parser.
+    pre::option_parser opt_parser("[OPTIONS]");
+
+    // Specify number of threads.
+    opt_parser.on_option(
+    "-n", "--nthreads", 1,
+    [&](char** argv) {
+        try {
+            nthreads = std::stoi(argv[0]);
+            if (!(nthreads >= 1 &&
+                  nthreads <= 64)) {
+                throw std::exception();
+            }
+        }
+        catch (const std::exception&) {
+            throw
+                std::runtime_error(
+                std::string("-n/--nthreads expects 1 integer in [1,64] ")
+                    .append("(can't parse ").append(argv[0])
+                    .append(")"));
+        }
+    })
+    << "Specify number of threads. By default, 8.\n";
+
+    // Display help.
+    opt_parser.on_option(
+    "-h", "--help", 0,
+    [&](char**) {
+        std::cout << opt_parser << std::endl;
+        std::exit(EXIT_SUCCESS);
+    })
+    << "Display this help and exit.\n";
+
+    try {
+        // Parse args.
+        opt_parser.parse(argc, argv);
+    }
+    catch (const std::exception& exception) {
+        std::cerr << "Unhandled exception!\n";
+        std::cerr << "exception.what(): " << exception.what() << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+
+    // Block array algorithms.
+    testBlockArray("shared queue", ThreadPoolMode::shared_queue, nthreads);
+    testBlockArray("work stealing", ThreadPoolMode::work_stealing, nthreads);
+
+    return EXIT_SUCCESS;
+}
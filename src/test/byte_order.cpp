@@ -1,6 +1,7 @@
 #include <iostream>
 #include <iomanip>
 #include <fstream>
+#include <vector>
 #include <preform/byte_order.hpp>
 #include <preform/option_parser.hpp>
 
@@ -105,6 +106,11 @@ int main(int argc, char** argv)
         double df = 1.234;
         long double ldf = 1.234L;
         std::string str = "Hello world!";
+        std::uint16_t u16s[4] = {0x0102, 0x0304, 0x0506, 0x0708};
+        std::vector<std::uint32_t> u32s(1000);
+        for (std::size_t k = 0; k < u32s.size(); k++) {
+            u32s[k] = std::uint32_t(k * 0x01010101UL);
+        }
 
         std::cout << "Writing " << filename;
         std::cout << " with byte order " << pre::to_string(write_order);
@@ -118,6 +124,10 @@ int main(int argc, char** argv)
         std::cout << "double: "         << df  << '\n';
         std::cout << "long double: "    << ldf << '\n';
         std::cout << "std::string: "    << str << '\n';
+        std::cout << "std::uint16_t[4]: ";
+        for (std::uint16_t u16 : u16s) std::cout << u16 << ' ';
+        std::cout << '\n';
+        std::cout << "std::uint32_t[1000], last: " << u32s.back() << '\n';
         std::cout << '\n';
         std::cout.flush();
 
@@ -131,6 +141,8 @@ int main(int argc, char** argv)
         pre::byte_stream(ofs, write_order) << df;
         pre::byte_stream(ofs, write_order) << ldf;
         pre::byte_stream(ofs, write_order) << str;
+        pre::byte_stream(ofs, write_order) << u16s;
+        pre::byte_stream(ofs, write_order).write(u32s.data(), u32s.size());
         ofs.close();
     }
 
@@ -142,6 +154,8 @@ int main(int argc, char** argv)
         double df;
         long double ldf;
         std::string str;
+        std::uint16_t u16s[4];
+        std::vector<std::uint32_t> u32s(1000);
 
         std::cout << "Reading " << filename;
         std::cout << " with byte order " << pre::to_string(read_order);
@@ -159,6 +173,8 @@ int main(int argc, char** argv)
         pre::byte_stream(ifs, read_order) >> df;
         pre::byte_stream(ifs, read_order) >> ldf;
         pre::byte_stream(ifs, read_order) >> str;
+        pre::byte_stream(ifs, read_order) >> u16s;
+        pre::byte_stream(ifs, read_order).read(u32s.data(), u32s.size());
         ifs.close();
 
         // Read output.
@@ -168,6 +184,10 @@ int main(int argc, char** argv)
         std::cout << "double: "         << df  << '\n';
         std::cout << "long double: "    << ldf << '\n';
         std::cout << "std::string: "    << str << '\n';
+        std::cout << "std::uint16_t[4]: ";
+        for (std::uint16_t u16 : u16s) std::cout << u16 << ' ';
+        std::cout << '\n';
+        std::cout << "std::uint32_t[1000], last: " << u32s.back() << '\n';
         std::cout << '\n';
         std::cout.flush();
     }
@@ -0,0 +1,241 @@
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <preform/random.hpp>
+#include <preform/multi_random.hpp>
+#include <preform/option_parser.hpp>
+#include <preform/color.hpp>
+
+// Float type.
+typedef float Float;
+
+// 3-dimensional vector.
+typedef pre::vec3<Float> Vec3f;
+
+// Wavelength packet.
+typedef pre::multi<Float, 8> Packet;
+
+// RGB to spectrum table.
+typedef pre::rgb_to_spectrum_table<Float> RgbToSpectrumTable;
+
+// Permuted congruential generator.
+pre::pcg32 pcg;
+
+// RGB to spectrum table, at default resolution.
+RgbToSpectrumTable table;
+
+// Spectrum of coefficients to XYZ, by stratified wavelength packets.
+Vec3f spectrumToXyz(const Vec3f& coeffs)
+{
+    constexpr int m = 470;
+    Vec3f xyz = {};
+    for (int j = 0; j < m; j++) {
+        Packet lambda;
+        Packet pdf;
+        for (int k = 0; k < 8; k++) {
+            lambda[k] = Float(0.360) +
+                        Float(0.470) * (j * 8 + k + Float(0.5)) / (m * 8);
+            pdf[k] = 1 / Float(0.470);
+        }
+        xyz += pre::spectrum_to_xyz(
+               lambda, RgbToSpectrumTable::evaluate(coeffs, lambda), pdf);
+    }
+    return xyz / Float(m);
+}
+
+// Test round trip.
+void testRoundTrip()
+{
+    std::cout << "Testing round trip:\n";
+    std::cout << "This test upsamples RGB reflectances to spectra with\n";
+    std::cout << "the table, integrates them to XYZ, and converts back\n";
+    std::cout << "to RGB, for 2048 random colors in [0.2,0.8]^3 scaled by\n";
+    std::cout << "[0.01,1], and for a gray ramp from black to white. This\n";
+    std::cout << "should print 1 for errors below 2e-3 for each, and 1 for\n";
+    std::cout << "spectra in [0,1].\n";
+    std::cout.flush();
+
+    Float max_error[2] = {};
+    bool bounded = true;
+    for (int count = 0; count < 2048 + 33; count++) {
+        Vec3f rgb;
+        if (count < 2048) {
+            rgb = pre::generate_canonical<Float, 3>(pcg) *
+                  Float(0.6) + Float(0.2);
+            rgb *= Float(0.01) +
+                   Float(0.99) * pre::generate_canonical<Float>(pcg);
+        }
+        else {
+            rgb = Vec3f(Float(count - 2048) / 32);
+        }
+        Vec3f coeffs = table.coeffs(rgb);
+        for (int k = 0; k <= 47; k++) {
+            Float value = RgbToSpectrumTable::evaluate(
+                          coeffs, Float(0.360) + Float(0.010) * k);
+            bounded = bounded && value >= 0 && value <= 1;
+        }
+        Vec3f diff = pre::abs(pre::xyz_to_rgb(spectrumToXyz(coeffs)) - rgb);
+        Float& error = max_error[count >= 2048];
+        error = std::max({error, diff[0], diff[1], diff[2]});
+    }
+
+    // Print test result.
+    std::cout << "Result: ";
+    std::cout << (max_error[0] < Float(2e-3)) << " ";
+    std::cout << "(" << max_error[0] << "), ";
+    std::cout << (max_error[1] < Float(2e-3)) << " ";
+    std::cout << "(" << max_error[1] << "), " << bounded << "\n\n";
+    std::cout.flush();
+}
+
+// Test spectral integration.
+void testSpectrumToXyz()
+{
+    std::cout << "Testing spectral integration:\n";
+    std::cout << "This test integrates the equal-energy spectrum to XYZ\n";
+    std::cout << "and converts to RGB, then compares bulk integration of\n";
+    std::cout << "256 random packets against integrating each packet.\n";
+    std::cout << "This should print 1 for white within 1e-3, and 0\n";
+    std::cout << "mismatches.\n";
+    std::cout.flush();
+
+    // Equal-energy spectrum, where the third coefficient saturates
+    // the sigmoid to 1.
+    Vec3f white = pre::xyz_to_rgb(spectrumToXyz({0, 0, Float(1e4)}));
+    bool is_white = !(pre::abs(white - Float(1)) > Float(1e-3)).any();
+
+    // Bulk integration.
+    constexpr int n = 256;
+    Packet lambda[n];
+    Packet value[n];
+    Packet pdf[n];
+    for (int j = 0; j < n; j++) {
+        for (int k = 0; k < 8; k++) {
+            lambda[j][k] = Float(0.340) + Float(0.510) *
+                           pre::generate_canonical<Float>(pcg);
+            value[j][k] = pre::generate_canonical<Float>(pcg);
+            pdf[j][k] = k == 3 ? 0 : 2 + pre::generate_canonical<Float>(pcg);
+        }
+    }
+    Vec3f xyz[n];
+    pre::spectrum_to_xyz(lambda, value, pdf, xyz, n);
+    int nmismatches = 0;
+    for (int j = 0; j < n; j++) {
+        Vec3f expect = pre::spectrum_to_xyz(lambda[j], value[j], pdf[j]);
+        nmismatches +=
+            (pre::abs(xyz[j] - expect) >
+             Float(1e-5) * (pre::abs(expect) + 1)).any();
+    }
+
+    // Print test result.
+    std::cout << "Result: " << is_white << " ";
+    std::cout << "(" << white[0] << ", " << white[1] << ", ";
+    std::cout << white[2] << "), " << nmismatches << "\n\n";
+    std::cout.flush();
+}
+
+// Test serialization.
+void testSerialization()
+{
+    std::cout << "Testing serialization:\n";
+    std::cout << "This test saves and loads the table, and compares 4096\n";
+    std::cout << "random lookups, then loads garbage and a truncated\n";
+    std::cout << "table. This should print 0 mismatches, and 2 rejected\n";
+    std::cout << "tables.\n";
+    std::cout.flush();
+
+    std::stringstream stream;
+    table.save(stream);
+    std::string bytes = stream.str();
+    RgbToSpectrumTable loaded;
+    loaded.load(stream);
+    int nmismatches = loaded.resolution() != table.resolution();
+    for (int count = 0; count < 4096; count++) {
+        Vec3f rgb = pre::generate_canonical<Float, 3>(pcg);
+        nmismatches += !(loaded.coeffs(rgb) == table.coeffs(rgb)).all();
+    }
+    int nrejected = 0;
+    for (std::string garbage : {
+            std::string("garbage"),
+            bytes.substr(0, bytes.size() / 2)}) {
+        try {
+            std::stringstream bad(garbage);
+            loaded.load(bad);
+        }
+        catch (const std::runtime_error&) {
+            nrejected++;
+        }
+    }
+
+    // Print test result.
+    std::cout << "Result: " << nmismatches << ", " << nrejected << "\n\n";
+    std::cout.flush();
+}
+
+int main(int argc, char** argv)
+{
+    int seed = 0;
+
+    // Option parser.
+    pre::option_parser opt_parser("[OPTIONS]");
+
+    // Specify seed.
+    opt_parser.on_option(
+    "-s", "--seed", 1,
+    [&](char** argv) {
+        try {
+            seed = std::stoi(argv[0]);
+        }
+        catch (const std::exception&) {
+            throw
+                std::runtime_error(
+                std::string("-s/--seed expects 1 integer ")
+                    .append("(can't parse ").append(argv[0])
+                    .append(")"));
+        }
+    })
+    << "Specify seed. By default, random.\n";
+
+    // Display help.
+    opt_parser.on_option(
+    "-h", "--help", 0,
+    [&](char**) {
+        std::cout << opt_parser << std::endl;
+        std::exit(EXIT_SUCCESS);
+    })
+    << "Display this help and exit.\n";
+
+    try {
+        // Parse args.
+        opt_parser.parse(argc, argv);
+    }
+    catch (const std::exception& exception) {
+        std::cerr << "Unhandled exception!\n";
+        std::cerr << "exception.what(): " << exception.what() << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+
+    // Seed.
+    if (seed == 0) {
+        seed = std::random_device()();
+    }
+    std::cout << "seed = " << seed << "\n\n";
+    std::cout.flush();
+    pcg = pre::pcg32(seed);
+
+    // Table, which takes a few seconds.
+    table.init();
+
+    // Round trip.
+    testRoundTrip();
+
+    // Spectral integration.
+    testSpectrumToXyz();
+
+    // Serialization.
+    testSerialization();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,358 @@
+#include <algorithm>
+#include <array>
+#include <iostream>
+#include <map>
+#include <random>
+#include <vector>
+#include <preform/random.hpp>
+#include <preform/multi_random.hpp>
+#include <preform/thread_pool.hpp>
+#include <preform/timer.hpp>
+#include <preform/option_parser.hpp>
+#include <preform/exact_predicates.hpp>
+#include <preform/delaunay.hpp>
+#include <preform/delaunay_locator.hpp>
+
+// Float type.
+typedef double Float;
+
+// 2-dimensional vector.
+typedef pre::vec2<Float> Vec2f;
+
+// Delaunay triangulation.
+typedef pre::delaunay_triangulation<Float> DelaunayTriangulation;
+
+// Delaunay locator.
+typedef pre::delaunay_locator<Float> DelaunayLocator;
+
+// Triangle as indices.
+typedef std::array<long long, 3> Triangle;
+
+// Timer.
+typedef pre::steady_timer Timer;
+
+// Permuted congruential generator.
+pre::pcg32 pcg;
+
+// Generate canonical random 2-dimensional vector.
+Vec2f generateCanonical2()
+{
+    return pre::generate_canonical<Float, 2>(pcg);
+}
+
+// Triangles, each rotated to start at its least index, sorted.
+std::vector<Triangle> sortedTriangles(const DelaunayTriangulation& delaunay)
+{
+    std::vector<Triangle> triangles;
+    for (const auto& triangle : delaunay.triangles()) {
+        Triangle tri = {triangle.a, triangle.b, triangle.c};
+        std::rotate(
+            tri.begin(),
+            std::min_element(tri.begin(), tri.end()), tri.end());
+        triangles.push_back(tri);
+    }
+    std::sort(triangles.begin(), triangles.end());
+    return triangles;
+}
+
+// Check triangulation, printing triangle count, expected triangle
+// count, clockwise or degenerate triangles, and non-Delaunay edges.
+void checkTriangulation(
+        const DelaunayTriangulation& delaunay,
+        std::size_t npoints)
+{
+    auto points = delaunay.points();
+    std::size_t ntriangles = 0;
+    std::size_t nclockwise = 0;
+    std::map<std::pair<long long, long long>, long long> opposite;
+    for (const auto& triangle : delaunay.triangles()) {
+        ntriangles++;
+        if (!(pre::orient2d_sign(
+                    points[triangle.a],
+                    points[triangle.b],
+                    points[triangle.c]) > 0)) {
+            nclockwise++;
+        }
+        for (int k = 0; k < 3; k++) {
+            opposite[{triangle[k], triangle[(k + 1) % 3]}] =
+                triangle[(k + 2) % 3];
+        }
+    }
+
+    // Each interior edge is Delaunay if the vertex opposite it in
+    // the neighboring triangle is not strictly inside the circumcircle.
+    std::size_t nnon_delaunay = 0;
+    for (const auto& [edge, c] : opposite) {
+        auto itr = opposite.find({edge.second, edge.first});
+        if (itr != opposite.end()) {
+            if (pre::incircle_sign(
+                    points[edge.first],
+                    points[edge.second],
+                    points[c],
+                    points[itr->second]) > 0) {
+                nnon_delaunay++;
+            }
+        }
+    }
+
+    // Euler's formula, for h points on the hull.
+    std::size_t nhull = delaunay.boundary_edges().size();
+    std::cout << "Result: " << ntriangles << ", ";
+    std::cout << 2 * npoints - 2 - nhull << ", ";
+    std::cout << nclockwise << ", " << nnon_delaunay << " ";
+}
+
+// Test triangulation.
+void testTriangulation(int npoints)
+{
+    std::cout << "Testing triangulation:\n";
+    std::cout << "This test triangulates " << npoints << " random points ";
+    std::cout << "with init(), init_brio(),\n";
+    std::cout << "and init_brio() in parallel. For each, this should print\n";
+    std::cout << "equal triangle counts 2n - 2 - h, for h points on the\n";
+    std::cout << "hull, then 0 clockwise triangles and 0 non-Delaunay\n";
+    std::cout << "edges. It then compares the triangle sets, and finally\n";
+    std::cout << "checks every circumcircle against every point, which\n";
+    std::cout << "should print 0 mismatches and 0 non-empty circles.\n";
+    std::cout.flush();
+
+    std::vector<Vec2f> points(npoints);
+    for (Vec2f& point : points) {
+        point = generateCanonical2();
+    }
+
+    // Triangulate.
+    DelaunayTriangulation delaunay;
+    DelaunayTriangulation delaunay_brio;
+    DelaunayTriangulation delaunay_parallel;
+    Timer timer;
+    delaunay.init(points.begin(), points.end());
+    double delaunay_time = timer.read<std::micro>() / 1e3;
+    checkTriangulation(delaunay, npoints);
+    std::cout << "(" << delaunay_time << " ms)\n";
+    timer = Timer();
+    delaunay_brio.init_brio(points.begin(), points.end());
+    double delaunay_brio_time = timer.read<std::micro>() / 1e3;
+    checkTriangulation(delaunay_brio, npoints);
+    std::cout << "(" << delaunay_brio_time << " ms)\n";
+    pre::thread_pool pool;
+    timer = Timer();
+    delaunay_parallel.init_brio(pool, points.begin(), points.end());
+    double delaunay_parallel_time = timer.read<std::micro>() / 1e3;
+    checkTriangulation(delaunay_parallel, npoints);
+    std::cout << "(" << delaunay_parallel_time << " ms)\n";
+
+    // Compare.
+    std::vector<Triangle> triangles = sortedTriangles(delaunay);
+    int nmismatches = 0;
+    nmismatches += triangles != sortedTriangles(delaunay_brio);
+    nmismatches += triangles != sortedTriangles(delaunay_parallel);
+
+    // Empty circumcircles.
+    std::size_t nnon_empty = 0;
+    auto delaunay_points = delaunay.points();
+    for (const Triangle& tri : triangles) {
+        for (const Vec2f& point : delaunay_points) {
+            if (pre::incircle_sign(
+                    delaunay_points[tri[0]],
+                    delaunay_points[tri[1]],
+                    delaunay_points[tri[2]], point) > 0) {
+                nnon_empty++;
+            }
+        }
+    }
+
+    // Print test result.
+    std::cout << "Result: " << nmismatches << ", " << nnon_empty << "\n\n";
+    std::cout.flush();
+}
+
+// Test large triangulation.
+void testLargeTriangulation(int npoints)
+{
+    std::cout << "Testing large triangulation:\n";
+    std::cout << "This test triangulates " << npoints << " random points, ";
+    std::cout << "a quarter of\n";
+    std::cout << "them on a regular grid, with init_brio() and in parallel,\n";
+    std::cout << "which partitions points into cells. For each, this\n";
+    std::cout << "should print equal triangle counts, then 0 clockwise\n";
+    std::cout << "triangles and 0 non-Delaunay edges.\n";
+    std::cout.flush();
+
+    std::vector<Vec2f> points(npoints);
+    int ngrid = int(std::sqrt(npoints / 4));
+    for (int k = 0; k < npoints; k++) {
+        if (k < ngrid * ngrid) {
+            points[k] = Vec2f{Float(k % ngrid), Float(k / ngrid)};
+            points[k] /= Float(ngrid);
+        }
+        else {
+            points[k] = generateCanonical2();
+        }
+    }
+
+    // Triangulate.
+    DelaunayTriangulation delaunay_brio;
+    DelaunayTriangulation delaunay_parallel;
+    Timer timer;
+    delaunay_brio.init_brio(points.begin(), points.end());
+    double delaunay_brio_time = timer.read<std::micro>() / 1e3;
+    checkTriangulation(delaunay_brio, delaunay_brio.points().size());
+    std::cout << "(" << delaunay_brio_time << " ms)\n";
+    pre::thread_pool pool;
+    timer = Timer();
+    delaunay_parallel.init_brio(pool, points.begin(), points.end());
+    double delaunay_parallel_time = timer.read<std::micro>() / 1e3;
+    checkTriangulation(
+        delaunay_parallel, delaunay_parallel.points().size());
+    std::cout << "(" << delaunay_parallel_time << " ms)\n\n";
+    std::cout.flush();
+}
+
+// Locate point by linear scan, with exact orientation tests.
+bool locateLinear(
+        const DelaunayTriangulation& delaunay,
+        const Vec2f& point)
+{
+    auto points = delaunay.points();
+    for (const auto& triangle : delaunay.triangles()) {
+        if (pre::orient2d_sign(
+                points[triangle.a], points[triangle.b], point) >= 0 &&
+            pre::orient2d_sign(
+                points[triangle.b], points[triangle.c], point) >= 0 &&
+            pre::orient2d_sign(
+                points[triangle.c], points[triangle.a], point) >= 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Test locator.
+void testLocator(int npoints, int nqueries)
+{
+    std::cout << "Testing locator:\n";
+    std::cout << "This test locates " << nqueries << " random points, ";
+    std::cout << "some outside the hull,\n";
+    std::cout << "in a triangulation of " << npoints << " random points, ";
+    std::cout << "singly and in batches\n";
+    std::cout << "in serial and in parallel, then compares against a\n";
+    std::cout << "linear scan, and checks that each containing triangle\n";
+    std::cout << "contains the point and reproduces it by barycentric\n";
+    std::cout << "interpolation. This should print 0 mismatches for each.\n";
+    std::cout.flush();
+
+    std::vector<Vec2f> points(npoints);
+    for (Vec2f& point : points) {
+        point = generateCanonical2();
+    }
+    std::vector<Vec2f> queries(nqueries);
+    for (Vec2f& query : queries) {
+        query = generateCanonical2() * Float(1.2) - Float(0.1);
+    }
+    DelaunayTriangulation delaunay;
+    delaunay.init_brio(points.begin(), points.end());
+    DelaunayLocator locator(delaunay);
+    std::vector<DelaunayLocator::location_type> locs(nqueries);
+    std::vector<DelaunayLocator::location_type> parallel_locs(nqueries);
+    locator.locate(queries.data(), nqueries, locs.data());
+    pre::thread_pool pool;
+    locator.locate(
+            pool, queries.data(), nqueries, parallel_locs.data(), 64);
+
+    int nmismatches[3] = {};
+    auto delaunay_points = delaunay.points();
+    auto delaunay_triangles = delaunay.triangles();
+    for (int k = 0; k < nqueries; k++) {
+        const Vec2f& query = queries[k];
+        DelaunayLocator::location_type loc = locator.locate(query);
+        bool found = locateLinear(delaunay, query);
+        nmismatches[0] += bool(loc) != found;
+        nmismatches[1] +=
+            locs[k].triangle != loc.triangle ||
+            parallel_locs[k].triangle != loc.triangle;
+        if (loc) {
+            const auto& triangle = delaunay_triangles[loc.triangle];
+            const Vec2f& pa = delaunay_points[triangle.a];
+            const Vec2f& pb = delaunay_points[triangle.b];
+            const Vec2f& pc = delaunay_points[triangle.c];
+            Vec2f interp =
+                loc.bary[0] * pa +
+                loc.bary[1] * pb +
+                loc.bary[2] * pc;
+            nmismatches[2] +=
+                pre::orient2d_sign(pa, pb, query) < 0 ||
+                pre::orient2d_sign(pb, pc, query) < 0 ||
+                pre::orient2d_sign(pc, pa, query) < 0 ||
+                pre::length(interp - query) > Float(1e-9);
+        }
+    }
+
+    // Print test result.
+    std::cout << "Result: " << nmismatches[0] << ", ";
+    std::cout << nmismatches[1] << ", " << nmismatches[2] << "\n\n";
+    std::cout.flush();
+}
+
+int main(int argc, char** argv)
+{
+    int seed = 0;
+
+    // Option parser.
+    pre::option_parser opt_parser("[OPTIONS]");
+
+    // Specify seed.
+    opt_parser.on_option(
+    "-s", "--seed", 1,
+    [&](char** argv) {
+        try {
+            seed = std::stoi(argv[0]);
+        }
+        catch (const std::exception&) {
+            throw
+                std::runtime_error(
+                std::string("-s/--seed expects 1 integer ")
+                    .append("(can't parse ").append(argv[0])
+                    .append(")"));
+        }
+    })
+    << "Specify seed. By default, random.\n";
+
+    // Display help.
+    opt_parser.on_option(
+    "-h", "--help", 0,
+    [&](char**) {
+        std::cout << opt_parser << std::endl;
+        std::exit(EXIT_SUCCESS);
+    })
+    << "Display this help and exit.\n";
+
+    try {
+        // Parse args.
+        opt_parser.parse(argc, argv);
+    }
+    catch (const std::exception& exception) {
+        std::cerr << "Unhandled exception!\n";
+        std::cerr << "exception.what(): " << exception.what() << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+
+    // Seed.
+    if (seed == 0) {
+        seed = std::random_device()();
+    }
+    std::cout << "seed = " << seed << "\n\n";
+    std::cout.flush();
+    pcg = pre::pcg32(seed);
+
+    // Triangulation.
+    testTriangulation(1024);
+
+    // Large triangulation.
+    testLargeTriangulation(131072);
+
+    // Locator.
+    testLocator(4096, 16384);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,391 @@
+#include <algorithm>
+#include <complex>
+#include <iostream>
+#include <random>
+#include <vector>
+#include <preform/random.hpp>
+#include <preform/option_parser.hpp>
+#include <preform/thread_pool.hpp>
+#include <preform/dense_linalg.hpp>
+
+// Float type.
+typedef double Float;
+
+// Complex type.
+typedef std::complex<Float> Complex;
+
+// Thread pool.
+typedef pre::thread_pool ThreadPool;
+
+// Permuted congruential generator.
+pre::pcg32 pcg;
+
+// Thread pool, for parallel forms.
+ThreadPool* pool = nullptr;
+
+// Generate random value in [-1,1).
+template <typename T>
+T generate();
+
+template <>
+Float generate<Float>()
+{
+    return pre::generate_canonical<Float>(pcg) * 2 - 1;
+}
+
+template <>
+Complex generate<Complex>()
+{
+    return {generate<Float>(), generate<Float>()};
+}
+
+// Dense matrix, row-major.
+template <typename T>
+struct Matrix
+{
+    int m = 0;
+    int n = 0;
+    std::vector<T> values;
+
+    Matrix(int m, int n) : m(m), n(n), values(std::size_t(m) * n)
+    {
+    }
+
+    T& operator()(int i, int j)
+    {
+        return values[std::size_t(i) * n + j];
+    }
+
+    const T& operator()(int i, int j) const
+    {
+        return values[std::size_t(i) * n + j];
+    }
+
+    pre::dense_matrix_view<T*> view()
+    {
+        return {&values[0], n, 1, m, n};
+    }
+};
+
+// Generate random matrix.
+template <typename T>
+Matrix<T> generateMatrix(int m, int n)
+{
+    Matrix<T> a(m, n);
+    for (T& value : a.values) {
+        value = generate<T>();
+    }
+    return a;
+}
+
+// Product, by definition.
+template <typename T>
+Matrix<T> product(const Matrix<T>& a, const Matrix<T>& b, bool adjb = false)
+{
+    Matrix<T> c(a.m, adjb ? b.m : b.n);
+    for (int i = 0; i < c.m; i++)
+    for (int j = 0; j < c.n; j++) {
+        T tmp = T();
+        for (int k = 0; k < a.n; k++) {
+            tmp += a(i, k) * (adjb ? pre::conj(b(j, k)) : b(k, j));
+        }
+        c(i, j) = tmp;
+    }
+    return c;
+}
+
+// Relative difference, in the Frobenius norm.
+template <typename T>
+Float difference(const Matrix<T>& a, const Matrix<T>& b)
+{
+    Float dd = 0;
+    Float bb = 0;
+    for (std::size_t k = 0; k < a.values.size(); k++) {
+        dd += pre::norm(a.values[k] - b.values[k]);
+        bb += pre::norm(b.values[k]);
+    }
+    return pre::sqrt(dd / std::max(bb, Float(1)));
+}
+
+// Generate size, either small or beyond the blocking thresholds.
+int generateSize()
+{
+    return pcg(2) ? 1 + int(pcg(16)) : 64 + int(pcg(128));
+}
+
+// Test matrix products.
+template <typename T>
+void testProducts(const char* name)
+{
+    std::cout << "Testing matrix products for " << name << ":\n";
+    std::cout << "This test computes 32 random products with gemm() and\n";
+    std::cout << "gemv(), with random factors and transposed operands, of\n";
+    std::cout << "sizes up to 191, serially and in parallel, and compares\n";
+    std::cout << "against the definition. This should print 1 for\n";
+    std::cout << "relative errors below 1e-13.\n";
+    std::cout.flush();
+
+    Float max_error = 0;
+    for (int count = 0; count < 32; count++) {
+        int m = generateSize();
+        int n = generateSize();
+        int k = generateSize();
+        bool trans = pcg(2);
+        T alpha = generate<T>();
+        T beta = pcg(2) ? generate<T>() : T();
+        Matrix<T> a = generateMatrix<T>(m, k);
+        Matrix<T> b = generateMatrix<T>(k, n);
+        Matrix<T> at(k, m);
+        Matrix<T> bt(n, k);
+        for (int i = 0; i < m; i++)
+        for (int j = 0; j < k; j++) {
+            at(j, i) = a(i, j);
+        }
+        for (int i = 0; i < k; i++)
+        for (int j = 0; j < n; j++) {
+            bt(j, i) = b(i, j);
+        }
+        auto aview = trans ? at.view().transpose() : a.view();
+        auto bview = trans ? bt.view().transpose() : b.view();
+        Matrix<T> c = generateMatrix<T>(m, n);
+
+        // Expect.
+        Matrix<T> expect = product(a, b);
+        for (int i = 0; i < m; i++)
+        for (int j = 0; j < n; j++) {
+            expect(i, j) = alpha * expect(i, j) +
+                           (beta == T() ? T() : beta * c(i, j));
+        }
+
+        // Matrix-matrix, serial and parallel.
+        for (int parallel = 0; parallel < 2; parallel++) {
+            Matrix<T> res = c;
+            if (parallel) {
+                pre::dense_linalg<T>::gemm(
+                     *pool, alpha, aview, bview, beta, res.view());
+            }
+            else {
+                pre::dense_linalg<T>::gemm(
+                     alpha, aview, bview, beta, res.view());
+            }
+            max_error = std::max(max_error, difference(res, expect));
+        }
+
+        // Matrix-vector, with the first column.
+        for (int parallel = 0; parallel < 2; parallel++) {
+            Matrix<T> res = c;
+            if (parallel) {
+                pre::dense_linalg<T>::gemv(
+                     *pool, alpha, aview,
+                     bview.transpose()[0], beta,
+                     res.view().transpose()[0]);
+            }
+            else {
+                pre::dense_linalg<T>::gemv(
+                     alpha, aview,
+                     bview.transpose()[0], beta,
+                     res.view().transpose()[0]);
+            }
+            Float dd = 0;
+            Float bb = 0;
+            for (int i = 0; i < m; i++) {
+                dd += pre::norm(res(i, 0) - expect(i, 0));
+                bb += pre::norm(expect(i, 0));
+            }
+            max_error =
+                std::max(max_error, pre::sqrt(dd / std::max(bb, Float(1))));
+        }
+    }
+
+    // Print test result.
+    std::cout << "Result: " << (max_error < Float(1e-13)) << " ";
+    std::cout << "(" << max_error << ")\n\n";
+    std::cout.flush();
+}
+
+// Test QR-decomposition.
+template <typename T>
+void testQr(const char* name)
+{
+    std::cout << "Testing QR-decomposition for " << name << ":\n";
+    std::cout << "This test decomposes 32 random matrices, of sizes up\n";
+    std::cout << "to 191, serially and in parallel, and computes the\n";
+    std::cout << "residual of QR against the input, the residual of the\n";
+    std::cout << "adjoint of Q times Q against identity, and the largest\n";
+    std::cout << "entry below the diagonal of R. This should print 1 for\n";
+    std::cout << "each below 1e-13.\n";
+    std::cout.flush();
+
+    Float max_error[3] = {};
+    for (int count = 0; count < 32; count++) {
+        int m = generateSize();
+        int n = generateSize();
+        Matrix<T> x = generateMatrix<T>(m, n);
+        for (int parallel = 0; parallel < 2; parallel++) {
+            Matrix<T> r = x;
+            Matrix<T> q(m, m);
+            if (parallel) {
+                pre::dense_linalg<T>::qr(*pool, r.view(), q.view());
+            }
+            else {
+                pre::dense_linalg<T>::qr(r.view(), q.view());
+            }
+            max_error[0] = std::max(max_error[0], difference(product(q, r), x));
+            Matrix<T> qhq(m, m);
+            Matrix<T> eye(m, m);
+            for (int i = 0; i < m; i++)
+            for (int j = 0; j < m; j++) {
+                T tmp = T();
+                for (int l = 0; l < m; l++) {
+                    tmp += pre::conj(q(l, i)) * q(l, j);
+                }
+                qhq(i, j) = tmp;
+                eye(i, j) = i == j ? 1 : 0;
+            }
+            max_error[1] = std::max(max_error[1], difference(qhq, eye));
+            for (int i = 0; i < m; i++)
+            for (int j = 0; j < std::min(i, n); j++) {
+                max_error[2] = std::max(max_error[2], pre::abs(r(i, j)));
+            }
+        }
+    }
+
+    // Print test result.
+    std::cout << "Result: ";
+    std::cout << (max_error[0] < Float(1e-13)) << " ";
+    std::cout << "(" << max_error[0] << "), ";
+    std::cout << (max_error[1] < Float(1e-13)) << " ";
+    std::cout << "(" << max_error[1] << "), ";
+    std::cout << (max_error[2] < Float(1e-13)) << " ";
+    std::cout << "(" << max_error[2] << ")\n\n";
+    std::cout.flush();
+}
+
+// Test Cholesky decomposition.
+template <typename T>
+void testChol(const char* name)
+{
+    std::cout << "Testing Cholesky decomposition for " << name << ":\n";
+    std::cout << "This test decomposes 32 random Hermitian positive\n";
+    std::cout << "definite matrices, of sizes up to 191, serially and in\n";
+    std::cout << "parallel, and 32 random positive semi-definite matrices\n";
+    std::cout << "of deficient rank with pivoting, and computes the\n";
+    std::cout << "residual of the adjoint product of L, permuted, against\n";
+    std::cout << "the input. This should print 1 for each below 1e-13.\n";
+    std::cout.flush();
+
+    Float max_error[2] = {};
+    for (int count = 0; count < 32; count++) {
+        int n = generateSize();
+        Matrix<T> b = generateMatrix<T>(n, n);
+        Matrix<T> a = product(b, b, true);
+        for (int i = 0; i < n; i++) {
+            a(i, i) += n;
+        }
+        for (int parallel = 0; parallel < 2; parallel++) {
+            Matrix<T> l = a;
+            if (parallel) {
+                pre::dense_linalg<T>::chol(*pool, l.view());
+            }
+            else {
+                pre::dense_linalg<T>::chol(l.view());
+            }
+            max_error[0] =
+                std::max(max_error[0], difference(product(l, l, true), a));
+        }
+    }
+    for (int count = 0; count < 32; count++) {
+        int n = generateSize();
+        int rank = 1 + int(pcg(std::uint32_t(n)));
+        Matrix<T> b = generateMatrix<T>(n, rank);
+        Matrix<T> a = product(b, b, true);
+        Matrix<T> l = a;
+        std::vector<int> p(n);
+        pre::dense_linalg<T>::chol(l.view(), {&p[0], 1, n});
+        Matrix<T> llh = product(l, l, true);
+        Matrix<T> expect(n, n);
+        for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++) {
+            expect(i, j) = a(p[i], p[j]);
+        }
+        max_error[1] = std::max(max_error[1], difference(llh, expect));
+    }
+
+    // Print test result.
+    std::cout << "Result: ";
+    std::cout << (max_error[0] < Float(1e-13)) << " ";
+    std::cout << "(" << max_error[0] << "), ";
+    std::cout << (max_error[1] < Float(1e-13)) << " ";
+    std::cout << "(" << max_error[1] << ")\n\n";
+    std::cout.flush();
+}
+
+int main(int argc, char** argv)
+{
+    int seed = 0;
+
+    // Option parser.
+    pre::option_parser opt_parser("[OPTIONS]");
+
+    // Specify seed.
+    opt_parser.on_option(
+    "-s", "--seed", 1,
+    [&](char** argv) {
+        try {
+            seed = std::stoi(argv[0]);
+        }
+        catch (const std::exception&) {
+            throw
+                std::runtime_error(
+                std::string("-s/--seed expects 1 integer ")
+                    .append("(can't parse ").append(argv[0])
+                    .append(")"));
+        }
+    })
+    << "Specify seed. By default, random.\n";
+
+    // Display help.
+    opt_parser.on_option(
+    "-h", "--help", 0,
+    [&](char**) {
+        std::cout << opt_parser << std::endl;
+        std::exit(EXIT_SUCCESS);
+    })
+    << "Display this help and exit.\n";
+
+    try {
+        // Parse args.
+        opt_parser.parse(argc, argv);
+    }
+    catch (const std::exception& exception) {
+        std::cerr << "Unhandled exception!\n";
+        std::cerr << "exception.what(): " << exception.what() << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+
+    // Seed.
+    if (seed == 0) {
+        seed = std::random_device()();
+    }
+    std::cout << "seed = " << seed << "\n\n";
+    std::cout.flush();
+    pcg = pre::pcg32(seed);
+
+    // Thread pool.
+    ThreadPool thread_pool(4);
+    pool = &thread_pool;
+
+    // Matrix products.
+    testProducts<Float>("double");
+    testProducts<Complex>("std::complex<double>");
+
+    // QR-decomposition.
+    testQr<Float>("double");
+    testQr<Complex>("std::complex<double>");
+
+    // Cholesky decomposition.
+    testChol<Float>("double");
+    testChol<Complex>("std::complex<double>");
+
+    return EXIT_SUCCESS;
+}
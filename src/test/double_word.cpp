@@ -0,0 +1,309 @@
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <preform/random.hpp>
+#include <preform/option_parser.hpp>
+#include <preform/quadmath.hpp>
+#include <preform/double_word.hpp>
+
+// Quad type, for reference.
+typedef __float128 Quad;
+
+// Permuted congruential generator.
+pre::pcg32 pcg;
+
+// Samples per function.
+int nsamples = 65536;
+
+// Functions exceeding their bounds.
+int nfailures = 0;
+
+// Generate double word with exponent in range, and random low part.
+template <typename T>
+pre::double_word<T> generateDoubleWord(int emin, int emax, bool neg = false)
+{
+    int e = emin + int(pcg(std::uint32_t(emax - emin + 1)));
+    T hi = pre::ldexp(1 + pre::generate_canonical<T>(pcg), e);
+    if (neg && pcg(2)) {
+        hi = -hi;
+    }
+    if (!(pre::fabs(hi) >= pre::numeric_limits<T>::min() /
+                           pre::numeric_limits<T>::epsilon())) {
+        return hi;
+    }
+    T lo = pre::ldexp(pre::numeric_limits<T>::epsilon(), e) *
+           (pre::generate_canonical<T>(pcg) - T(0.5));
+    return pre::double_word<T>::normalize(hi, lo);
+}
+
+// Generate double word uniformly in interval, with random low part.
+template <typename T>
+pre::double_word<T> generateDoubleWordIn(T a, T b)
+{
+    T hi = a + (b - a) * pre::generate_canonical<T>(pcg);
+    int e = 0;
+    pre::frexp(hi, &e);
+    T lo = pre::ldexp(pre::numeric_limits<T>::epsilon(), e - 1) *
+           (pre::generate_canonical<T>(pcg) - T(0.5));
+    return pre::double_word<T>::normalize(hi, lo);
+}
+
+// Check function against quad reference, by relative error in u^2.
+template <typename T, typename Func, typename Ref, typename Gen>
+void check(const char* name, Func&& func, Ref&& ref, Gen&& gen,
+           double bound)
+{
+    Quad u = Quad(pre::numeric_limits<T>::epsilon()) / 2;
+    T min = pre::numeric_limits<pre::double_word<T>>::min().hi();
+    T max = pre::numeric_limits<T>::max();
+    double max_error = 0;
+    int nnonfinite = 0;
+    for (int k = 0; k < nsamples; k++) {
+        pre::double_word<T> x = gen();
+        pre::double_word<T> y = func(x);
+        Quad expect = ref(Quad(x));
+        if (!(pre::fabs(expect) >= Quad(min) &&
+              pre::fabs(expect) <= Quad(max))) {
+            continue;
+        }
+        if (!pre::isfinite(y)) {
+            nnonfinite++;
+            continue;
+        }
+        double error =
+            double(pre::fabs((Quad(y) - expect) / expect) / (u * u));
+        max_error = std::max(max_error, error);
+    }
+    bool pass = max_error <= bound && nnonfinite == 0;
+    nfailures += !pass;
+    std::cout << "  " << std::setw(6) << name << ": ";
+    std::cout << std::setw(10) << max_error << " u^2 ";
+    std::cout << "(bound " << bound << ")";
+    if (nnonfinite > 0) {
+        std::cout << ", " << nnonfinite << " non-finite";
+    }
+    std::cout << (pass ? "\n" : " FAILED\n");
+}
+
+// Test double word.
+template <typename T>
+void testDoubleWord(const char* name)
+{
+    typedef pre::double_word<T> DoubleWord;
+    constexpr int emin = pre::numeric_limits<DoubleWord>::min_exponent;
+    constexpr int emax = pre::numeric_limits<T>::max_exponent - 1;
+    constexpr int edenorm =
+        pre::numeric_limits<T>::min_exponent -
+        pre::numeric_limits<T>::digits;
+    const T exp_max = T(0.99) * pre::log(pre::numeric_limits<T>::max());
+
+    std::cout << "Testing " << name << ":\n";
+    std::cout << "This test compares arithmetic and math functions on\n";
+    std::cout << nsamples << " random arguments each, across the exponent ";
+    std::cout << "range\nwhere sensible, against __float128, and prints ";
+    std::cout << "the maximum\nrelative error in units of u^2, where u is ";
+    std::cout << "the unit\nroundoff of the float type. This should print ";
+    std::cout << "0\nfunctions exceeding their documented bounds.\n";
+    std::cout.flush();
+
+    auto any = [&]() { return generateDoubleWord<T>(emin, emax, true); };
+    auto half = [&]() {
+        return generateDoubleWord<T>(emin / 2, emax / 2, true);
+    };
+    auto positive = [&]() { return generateDoubleWord<T>(emin, emax); };
+    auto tiny = [&]() { return generateDoubleWord<T>(edenorm, emin); };
+
+    // Arithmetic.
+    DoubleWord y;
+    Quad qy;
+    check<T>("add",
+        [&](DoubleWord x) { y = half(); return x + y; },
+        [&](Quad x) { qy = Quad(y); return x + qy; }, half, 3);
+    check<T>("mul",
+        [&](DoubleWord x) { y = half(); return x * y; },
+        [&](Quad x) { qy = Quad(y); return x * qy; }, half, 5);
+    check<T>("div",
+        [&](DoubleWord x) { y = half(); return x / y; },
+        [&](Quad x) { qy = Quad(y); return x / qy; }, half, 15);
+    check<T>("sqrt",
+        [](DoubleWord x) { return pre::sqrt(x); },
+        [](Quad x) { return pre::sqrt(x); }, positive, 4);
+    check<T>("cbrt",
+        [](DoubleWord x) { return pre::cbrt(x); },
+        [](Quad x) { return pre::cbrt(x); }, any, 4);
+
+    // Exponentials and logarithms.
+    check<T>("exp",
+        [](DoubleWord x) { return pre::exp(x); },
+        [](Quad x) { return pre::exp(x); },
+        [&]() { return generateDoubleWordIn<T>(-exp_max, exp_max); }, 8);
+    check<T>("expm1",
+        [](DoubleWord x) { return pre::expm1(x); },
+        [](Quad x) { return pre::expm1(x); },
+        [&]() {
+            return pcg(2) ?
+                generateDoubleWord<T>(emin / 2, 0, true) :
+                generateDoubleWordIn<T>(-exp_max, exp_max);
+        }, 16);
+    check<T>("log",
+        [](DoubleWord x) { return pre::log(x); },
+        [](Quad x) { return pre::log(x); }, positive, 16);
+    check<T>("log",
+        [](DoubleWord x) { return pre::log(x); },
+        [](Quad x) { return pre::log(x); }, tiny, 16);
+    check<T>("log",
+        [](DoubleWord x) { return pre::log(x); },
+        [](Quad x) { return pre::log(x); },
+        [&]() { return generateDoubleWordIn<T>(T(0.9), T(1.1)); }, 16);
+    check<T>("log1p",
+        [](DoubleWord x) { return pre::log1p(x); },
+        [](Quad x) { return pre::log1p(x); },
+        [&]() {
+            return pcg(2) ?
+                generateDoubleWord<T>(emin, -1, true) :
+                generateDoubleWord<T>(emin, emax);
+        }, 16);
+    check<T>("log2",
+        [](DoubleWord x) { return pre::log2(x); },
+        [](Quad x) { return pre::log2(x); }, positive, 12);
+    check<T>("log10",
+        [](DoubleWord x) { return pre::log10(x); },
+        [](Quad x) { return pre::log10(x); }, positive, 12);
+    check<T>("pow",
+        [&](DoubleWord x) {
+            y = generateDoubleWordIn<T>(T(-8), T(8));
+            return pre::pow(x, y);
+        },
+        [&](Quad x) { qy = Quad(y); return pre::pow(x, qy); },
+        [&]() { return generateDoubleWordIn<T>(T(0.01), T(100)); }, 256);
+
+    // Trigonometric functions, near the origin and at large arguments.
+    auto trig = [&]() {
+        return pcg(2) ?
+            generateDoubleWordIn<T>(T(-8), T(8)) :
+            generateDoubleWord<T>(3, pre::numeric_limits<T>::digits - 12,
+                                  true);
+    };
+    check<T>("sin",
+        [](DoubleWord x) { return pre::sin(x); },
+        [](Quad x) { return pre::sin(x); }, trig, 8);
+    check<T>("cos",
+        [](DoubleWord x) { return pre::cos(x); },
+        [](Quad x) { return pre::cos(x); }, trig, 8);
+    check<T>("tan",
+        [](DoubleWord x) { return pre::tan(x); },
+        [](Quad x) { return pre::tan(x); }, trig, 16);
+    check<T>("atan",
+        [](DoubleWord x) { return pre::atan(x); },
+        [](Quad x) { return pre::atan(x); }, any, 8);
+    check<T>("asin",
+        [](DoubleWord x) { return pre::asin(x); },
+        [](Quad x) { return pre::asin(x); },
+        [&]() { return generateDoubleWordIn<T>(T(-1), T(1)); }, 8);
+    check<T>("acos",
+        [](DoubleWord x) { return pre::acos(x); },
+        [](Quad x) { return pre::acos(x); },
+        [&]() { return generateDoubleWordIn<T>(T(-1), T(1)); }, 8);
+
+    // Hyperbolic functions.
+    check<T>("sinh",
+        [](DoubleWord x) { return pre::sinh(x); },
+        [](Quad x) { return pre::sinh(x); },
+        [&]() {
+            return pcg(2) ?
+                generateDoubleWord<T>(emin / 2, 0, true) :
+                generateDoubleWordIn<T>(-exp_max, exp_max);
+        }, 16);
+    check<T>("cosh",
+        [](DoubleWord x) { return pre::cosh(x); },
+        [](Quad x) { return pre::cosh(x); },
+        [&]() { return generateDoubleWordIn<T>(-exp_max, exp_max); }, 16);
+    check<T>("tanh",
+        [](DoubleWord x) { return pre::tanh(x); },
+        [](Quad x) { return pre::tanh(x); },
+        [&]() {
+            return pcg(2) ?
+                generateDoubleWord<T>(emin / 2, 0, true) :
+                generateDoubleWordIn<T>(T(-40), T(40));
+        }, 16);
+    check<T>("asinh",
+        [](DoubleWord x) { return pre::asinh(x); },
+        [](Quad x) { return pre::asinh(x); }, any, 16);
+    check<T>("acosh",
+        [](DoubleWord x) { return pre::acosh(x); },
+        [](Quad x) { return pre::acosh(x); },
+        [&]() {
+            return pcg(2) ?
+                generateDoubleWordIn<T>(T(1), T(2)) :
+                generateDoubleWord<T>(1, emax);
+        }, 16);
+    check<T>("atanh",
+        [](DoubleWord x) { return pre::atanh(x); },
+        [](Quad x) { return pre::atanh(x); },
+        [&]() { return generateDoubleWordIn<T>(T(-0.99), T(0.99)); }, 16);
+
+    // Print test result.
+    std::cout << "Result: " << nfailures << "\n\n";
+    std::cout.flush();
+    nfailures = 0;
+}
+
+int main(int argc, char** argv)
+{
+    int seed = 0;
+
+    // Option parser.
+    pre::option_parser opt_parser("[OPTIONS]");
+
+    // Specify seed.
+    opt_parser.on_option(
+    "-s", "--seed", 1,
+    [&](char** argv) {
+        try {
+            seed = std::stoi(argv[0]);
+        }
+        catch (const std::exception&) {
+            throw
+                std::runtime_error(
+                std::string("-s/--seed expects 1 integer ")
+                    .append("(can't parse ").append(argv[0])
+                    .append(")"));
+        }
+    })
+    << "Specify seed. By default, random.\n";
+
+    // Display help.
+    opt_parser.on_option(
+    "-h", "--help", 0,
+    [&](char**) {
+        std::cout << opt_parser << std::endl;
+        std::exit(EXIT_SUCCESS);
+    })
+    << "Display this help and exit.\n";
+
+    try {
+        // Parse args.
+        opt_parser.parse(argc, argv);
+    }
+    catch (const std::exception& exception) {
+        std::cerr << "Unhandled exception!\n";
+        std::cerr << "exception.what(): " << exception.what() << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+
+    // Seed.
+    if (seed == 0) {
+        seed = std::random_device()();
+    }
+    std::cout << "seed = " << seed << "\n\n";
+    std::cout.flush();
+    pcg = pre::pcg32(seed);
+
+    // Double-double.
+    testDoubleWord<double>("double_word<double>");
+
+    // Float-float.
+    testDoubleWord<float>("double_word<float>");
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,162 @@
+#include <iostream>
+#include <random>
+#include <string>
+#include <preform/random.hpp>
+#include <preform/option_parser.hpp>
+#include <preform/fast_math.hpp>
+
+// Permuted congruential generator.
+pre::pcg32 pcg;
+
+// Float ulp at reference value.
+double floatUlp(double ref)
+{
+    float f = pre::fabs(float(ref));
+    if (!(f >= pre::numeric_limits<float>::min())) {
+        return pre::numeric_limits<float>::denorm_min();
+    }
+    return pre::nextafter(f, pre::numeric_limits<float>::infinity()) - f;
+}
+
+// Test approximation accuracy.
+template <typename Tfast, typename Tprecise>
+void testAccuracy(
+        const char* name,
+        double xmin,
+        double xmax,
+        double max_ulp,
+        Tfast&& fast,
+        Tprecise&& precise)
+{
+    std::cout << "Testing " << name << " accuracy:\n";
+    std::cout << "This test evaluates " << name << " at random floats\n";
+    std::cout << "between " << xmin << " and " << xmax << ", and verifies\n";
+    std::cout << "that the error never exceeds " << max_ulp << " ulp.\n";
+    std::cout.flush();
+
+    double err = 0;
+    for (int k = 0; k < 65536; k++) {
+        float x = float(xmin + (xmax - xmin) *
+                        pre::generate_canonical<double>(pcg));
+        double ref = precise(double(x));
+        double res = fast(x);
+        err = pre::fmax(err, pre::fabs(res - ref) / floatUlp(ref));
+        if (!(err <= max_ulp)) {
+            std::cerr << "Failure!\n";
+            std::cerr << "x = " << x << "\n";
+            std::cerr << "res = " << res << "\n";
+            std::cerr << "ref = " << ref << "\n\n";
+            std::exit(EXIT_FAILURE);
+        }
+    }
+
+    std::cout << "Success (65536 tests, max " << err << " ulp).\n\n";
+    std::cout.flush();
+}
+
+// Test special cases.
+void testSpecialCases()
+{
+    const float inf = pre::numeric_limits<float>::infinity();
+    const float nan = pre::numeric_limits<float>::quiet_NaN();
+    std::cout << "Testing special cases:\n";
+    std::cout << "fast_exp(-inf): " << pre::fast_exp(-inf) << "\n";
+    std::cout << "fast_exp(+inf): " << pre::fast_exp(+inf) << "\n";
+    std::cout << "fast_exp(nan): " << pre::fast_exp(nan) << "\n";
+    std::cout << "fast_log(0): " << pre::fast_log(0.0f) << "\n";
+    std::cout << "fast_log(-1): " << pre::fast_log(-1.0f) << "\n";
+    std::cout << "fast_log(+inf): " << pre::fast_log(+inf) << "\n";
+    std::cout << "fast_log(1e-40): " << pre::fast_log(1e-40f) << "\n";
+    std::cout << "fast_pow(0, 2): " << pre::fast_pow(0.0f, 2.0f) << "\n";
+    std::cout << "fast_pow(0, 0): " << pre::fast_pow(0.0f, 0.0f) << "\n";
+    std::cout << "fast_erf(+inf): " << pre::fast_erf(+inf) << "\n";
+    std::cout << "fast_erfinv(-1): " << pre::fast_erfinv(-1.0f) << "\n";
+    std::cout << "fast_erfinv(+1): " << pre::fast_erfinv(+1.0f) << "\n";
+    std::cout << "fast_atan2(+0, -1): " << pre::fast_atan2(+0.0f, -1.0f);
+    std::cout << "\n";
+    std::cout << "fast_atan2(-0, -1): " << pre::fast_atan2(-0.0f, -1.0f);
+    std::cout << "\n";
+    std::cout << "fast_acos(-1): " << pre::fast_acos(-1.0f) << "\n\n";
+    std::cout.flush();
+}
+
+int main(int argc, char** argv)
+{
+    int seed = 0;
+
+    // Option parser.
+    pre::option_parser opt_parser("[OPTIONS]");
+
+    // Specify seed.
+    opt_parser.on_option(
+    "-s", "--seed", 1,
+    [&](char** argv) {
+        try {
+            seed = std::stoi(argv[0]);
+        }
+        catch (const std::exception&) {
+            throw
+                std::runtime_error(
+                std::string("-s/--seed expects 1 integer ")
+                    .append("(can't parse ").append(argv[0])
+                    .append(")"));
+        }
+    })
+    << "Specify seed. By default, random.\n";
+
+    // Display help.
+    opt_parser.on_option(
+    "-h", "--help", 0,
+    [&](char**) {
+        std::cout << opt_parser << std::endl;
+        std::exit(EXIT_SUCCESS);
+    })
+    << "Display this help and exit.\n";
+
+    try {
+        // Parse args.
+        opt_parser.parse(argc, argv);
+    }
+    catch (const std::exception& exception) {
+        std::cerr << "Unhandled exception!\n";
+        std::cerr << "exception.what(): " << exception.what() << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+
+    // Seed.
+    if (seed == 0) {
+        seed = std::random_device()();
+    }
+    std::cout << "seed = " << seed << "\n\n";
+    std::cout.flush();
+    pcg = pre::pcg32(seed);
+
+    // Test accuracy against double precision.
+    testAccuracy("fast_exp", -87, 88, 3,
+        [](float x) { return pre::fast_exp(x); },
+        [](double x) { return pre::exp(x); });
+    testAccuracy("fast_log", 1e-30, 1e4, 3,
+        [](float x) { return pre::fast_log(x); },
+        [](double x) { return pre::log(x); });
+    // Error grows with |y log(x)|, here at most 11.
+    testAccuracy("fast_pow", 0.01, 10, 20,
+        [](float x) { return pre::fast_pow(x, 2.4f); },
+        [](double x) { return pre::pow(x, double(2.4f)); });
+    testAccuracy("fast_erf", -4, 4, 6,
+        [](float x) { return pre::fast_erf(x); },
+        [](double x) { return pre::erf(x); });
+    testAccuracy("fast_erfinv", -0.9999, 0.9999, 3,
+        [](float x) { return pre::fast_erfinv(x); },
+        [](double x) { return pre::erfinv(x); });
+    testAccuracy("fast_atan2", -16, 16, 3,
+        [](float x) { return pre::fast_atan2(x, 0.75f); },
+        [](double x) { return pre::atan2(x, 0.75); });
+    testAccuracy("fast_acos", -1, 1, 3,
+        [](float x) { return pre::fast_acos(x); },
+        [](double x) { return pre::acos(x); });
+
+    // Test special cases.
+    testSpecialCases();
+
+    return EXIT_SUCCESS;
+}
@@ -1,7 +1,10 @@
 #include <iostream>
+#include <memory>
+#include <vector>
 #include <preform/float_atomic.hpp>
 #include <preform/thread_pool.hpp>
 #include <preform/option_parser.hpp>
+#include <preform/timer.hpp>
 
 // Float type.
 typedef float Float;
@@ -12,9 +15,15 @@ typedef std::uint32_t FloatBits;
 // Float atomic.
 typedef pre::float_atomic<Float, FloatBits> FloatAtomic;
 
+// Float atomic buffer.
+typedef pre::float_atomic_buffer<Float, FloatBits> FloatAtomicBuffer;
+
 // Thread pool.
 typedef pre::thread_pool ThreadPool;
 
+// Timer.
+typedef pre::steady_timer Timer;
+
 int main(int argc, char** argv)
 {
     int nthreads = 8;
@@ -91,11 +100,68 @@ int main(int argc, char** argv)
         results[j].wait();
     }
 
+    // Print test result.
+    std::cout << "Result: " << result.loadf() << "\n\n";
+    std::cout.flush();
+
+    // Print test description.
+    std::cout << "Testing float atomic buffer:\n";
+    std::cout << "This test repeats the above, but adds into 16 hot values\n";
+    std::cout << "of a 1024-value buffer, first as plain float atomics and\n";
+    std::cout << "then with one shard per thread. Both should sum to\n";
+    std::cout << "32768, and sharding should be faster with many threads.\n";
+    std::cout.flush();
+
+    // Plain float atomics.
+    std::unique_ptr<FloatAtomic[]> plain(new FloatAtomic[1024]);
+    Timer timer;
+    for (int j = 0; j < 32; j++) {
+        results[j] =
+        thread_pool.submit([&, j]() {
+            for (int k = 0; k < 4096; k++) {
+                plain[(j + k) % 16].fetch_addf(Float(0.25));
+            }
+        });
+    }
+    for (int j = 0; j < 32; j++) {
+        results[j].wait();
+    }
+    double plain_us = timer.read<std::micro>();
+    Float plain_sum = 0;
+    for (int i = 0; i < 1024; i++) {
+        plain_sum += plain[i].loadf();
+    }
+
+    // Sharded buffer.
+    FloatAtomicBuffer buffer(1024, thread_pool.size());
+    timer = Timer();
+    for (int j = 0; j < 32; j++) {
+        results[j] =
+        thread_pool.submit([&, j]() {
+            for (int k = 0; k < 4096; k++) {
+                buffer.add((j + k) % 16, Float(0.25));
+            }
+        });
+    }
+    for (int j = 0; j < 32; j++) {
+        results[j].wait();
+    }
+    double buffer_us = timer.read<std::micro>();
+    std::vector<Float> merged(1024);
+    buffer.merge(merged.data());
+    Float buffer_sum = 0;
+    for (int i = 0; i < 1024; i++) {
+        buffer_sum += merged[i];
+    }
+
     // Shutdown thread pool.
     thread_pool.shutdown();
 
     // Print test result.
-    std::cout << "Result: " << result.loadf() << "\n\n";
+    std::cout << "Plain result: " << plain_sum << " ";
+    std::cout << "(" << plain_us << " us)\n";
+    std::cout << "Buffer result: " << buffer_sum << " ";
+    std::cout << "(" << buffer_us << " us)\n\n";
     std::cout.flush();
 
     return EXIT_SUCCESS;
@@ -5,6 +5,7 @@
 #include <preform/random.hpp>
 #include <preform/option_parser.hpp>
 #include <preform/float_interval.hpp>
+#include <preform/packed_float_interval.hpp>
 
 // High-precision float type.
 typedef long double Highp;
@@ -15,6 +16,9 @@ typedef float Float;
 // Float interval type.
 typedef pre::float_interval<Float> FloatInterval;
 
+// Packed float interval type.
+typedef pre::packed_float_interval<Float> PackedFloatInterval;
+
 // Permuted-congruential generator.
 pre::pcg32 pcg;
 
@@ -160,6 +164,109 @@ void testPairwise()
     std::cout.flush();
 }
 
+void testPacked()
+{
+    std::cout << "Testing packed operations:\n";
+    std::cout << "This test repeats the pairwise test for\n";
+    std::cout << "PackedFloatInterval, including square roots, checking\n";
+    std::cout << "that the result contains the result Highp, and that the\n";
+    std::cout << "result is no more than a few ulps wider than the\n";
+    std::cout << "FloatInterval result.\n";
+    std::cout.flush();
+
+    pre::normal_distribution<Float> distr_val(0, 100);
+    pre::exponential_distribution<Float> distr_err(1);
+    Float max_excess = 0;
+    for (int k = 0; k < 16384; k++) {
+        // Generate random values.
+        Float f0 = distr_val(pcg);
+        Float f1 = distr_val(pcg);
+
+        // Generate random lower and upper bounds.
+        FloatInterval fi0 = {
+            f0,
+            f0 - distr_err(pcg),
+            f0 + distr_err(pcg)
+        };
+        FloatInterval fi1 = {
+            f1,
+            f1 - distr_err(pcg),
+            f1 + distr_err(pcg)
+        };
+        PackedFloatInterval pi0(fi0);
+        PackedFloatInterval pi1(fi1);
+
+        // Generate random high-precision values in intervals.
+        Highp fh0 =
+            pre::lerp(
+            pre::generate_canonical<Highp>(pcg),
+            Highp(fi0.lower_bound()),
+            Highp(fi0.upper_bound()));
+        Highp fh1 =
+            pre::lerp(
+            pre::generate_canonical<Highp>(pcg),
+            Highp(fi1.lower_bound()),
+            Highp(fi1.upper_bound()));
+
+        // Random operation.
+        FloatInterval fi;
+        PackedFloatInterval pi;
+        Highp fh = 0;
+        switch (pcg(5)) {
+            case 0:
+                fi = fi0 + fi1;
+                pi = pi0 + pi1;
+                fh = fh0 + fh1;
+                break;
+            case 1:
+                fi = fi0 - fi1;
+                pi = pi0 - pi1;
+                fh = fh0 - fh1;
+                break;
+            case 2:
+                fi = fi0 * fi1;
+                pi = pi0 * pi1;
+                fh = fh0 * fh1;
+                break;
+            case 3:
+                fi = fi0 / fi1;
+                pi = pi0 / pi1;
+                fh = fh0 / fh1;
+                break;
+            case 4:
+                fi = pre::sqrt(pre::fabs(fi0));
+                pi = pre::sqrt(pre::fabs(pi0));
+                fh = pre::sqrt(pre::fabs(fh0));
+                break;
+            default:
+                break;
+        }
+
+        if (!pre::isnan(fi.value()) &&
+            !pi.contains<true, true>(fh)) {
+            std::cerr << "Failure!\n";
+            std::cerr << "pi0 = " << pi0 << "\n";
+            std::cerr << "pi1 = " << pi1 << "\n";
+            std::cerr << "pi = " << pi << "\n";
+            std::cerr << "fh = " << fh << "\n\n";
+            std::exit(EXIT_FAILURE);
+        }
+        if (pre::isfinite(fi.upper_bound() - fi.lower_bound())) {
+            Float ulp = pre::numeric_limits<Float>::epsilon() *
+                        pre::fmax(
+                            pre::fabs(fi.lower_bound()),
+                            pre::fabs(fi.upper_bound()));
+            max_excess = pre::fmax(max_excess,
+                    ((fi.lower_bound() - pi.lower_bound()) +
+                     (pi.upper_bound() - fi.upper_bound())) / ulp);
+        }
+    }
+
+    std::cout << "Success (16384 tests).\n";
+    std::cout << "max excess width = " << max_excess << " ulps\n\n";
+    std::cout.flush();
+}
+
 int main(int argc, char** argv)
 {
     int seed = 0;
@@ -217,5 +324,8 @@ int main(int argc, char** argv)
     // Test pairwise operations.
     testPairwise();
 
+    // Test packed operations.
+    testPacked();
+
     return EXIT_SUCCESS;
 }
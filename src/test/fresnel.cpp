@@ -0,0 +1,237 @@
+#include <algorithm>
+#include <complex>
+#include <iostream>
+#include <random>
+#include <preform/random.hpp>
+#include <preform/option_parser.hpp>
+#include <preform/simd.hpp>
+#include <preform/fresnel.hpp>
+
+// Float type.
+typedef double Float;
+
+// Complex type.
+typedef std::complex<Float> Complex;
+
+// Lanes.
+typedef pre::simd<Float, 4> Lanes;
+
+// Lane mask.
+typedef pre::simd_mask<Float, 4> LaneMask;
+
+// Fresnel table.
+typedef pre::fresnel_table<Float, 4> FresnelTable;
+
+// Permuted congruential generator.
+pre::pcg32 pcg;
+
+// Generate in range.
+Float generateIn(Float a, Float b)
+{
+    return a + (b - a) * pre::generate_canonical<Float>(pcg);
+}
+
+// Generate refractive index, as a dielectric with or without total
+// internal reflection, or as a conductor with extinction coefficient
+// of at least 0.5, from outside.
+Complex generateEta()
+{
+    switch (pcg(3)) {
+        case 0:
+            return generateIn(Float(0.4), Float(1));
+        case 1:
+            return generateIn(Float(1), Float(2.5));
+        default:
+            return Float(1) /
+                   Complex(generateIn(Float(0.05), Float(3)),
+                           generateIn(Float(0.5), Float(8)));
+    }
+}
+
+// Test dielectric.
+void testDiel()
+{
+    std::cout << "Testing dielectric:\n";
+    std::cout << "This test evaluates the polarized and unpolarized SIMD\n";
+    std::cout << "forms of fresnel_diel() for 4096 random refractive\n";
+    std::cout << "indices and incidence cosines, with and without total\n";
+    std::cout << "internal reflection, and compares each lane against the\n";
+    std::cout << "scalar forms. This should print 0 mismatches beyond an\n";
+    std::cout << "absolute error of 1e-12.\n";
+    std::cout.flush();
+
+    int nmismatches = 0;
+    for (int count = 0; count < 1024; count++) {
+        Lanes eta;
+        Lanes cos_thetai;
+        for (int k = 0; k < 4; k++) {
+            eta[k] = generateIn(Float(0.4), Float(2.5));
+            cos_thetai[k] = generateIn(Float(-1), Float(1));
+        }
+        Lanes cos_thetat, rs, rp, ts, tp, fr, ft;
+        LaneMask refr =
+            pre::fresnel_diel(eta, cos_thetai, cos_thetat, rs, rp, ts, tp);
+        pre::fresnel_diel(eta, cos_thetai, cos_thetat, fr, ft);
+        for (int k = 0; k < 4; k++) {
+            Float expect[7] = {};
+            bool expect_refr =
+                pre::fresnel_diel(
+                    eta[k], cos_thetai[k], expect[0],
+                    expect[1], expect[2], expect[3], expect[4]);
+            pre::fresnel_diel(
+                    eta[k], cos_thetai[k], expect[0], expect[5], expect[6]);
+            Float res[7] = {
+                cos_thetat[k], rs[k], rp[k], ts[k], tp[k], fr[k], ft[k]
+            };
+            bool mismatch = refr[k] != expect_refr;
+            for (int j = 0; j < 7; j++) {
+                mismatch = mismatch ||
+                    !(pre::fabs(res[j] - expect[j]) <= Float(1e-12));
+            }
+            nmismatches += mismatch;
+        }
+    }
+
+    // Print test result.
+    std::cout << "Result: " << nmismatches << "\n\n";
+    std::cout.flush();
+}
+
+// Test conductor.
+void testDielCond()
+{
+    std::cout << "Testing conductor:\n";
+    std::cout << "This test evaluates the SIMD form of fresnel_diel_cond()\n";
+    std::cout << "for 4096 random refractive indices, as conductors or\n";
+    std::cout << "as dielectrics with and without total internal\n";
+    std::cout << "reflection, and random incidence cosines, and compares\n";
+    std::cout << "each lane against the scalar complex form. This should\n";
+    std::cout << "print 0 mismatches beyond an absolute error of 1e-12.\n";
+    std::cout.flush();
+
+    int nmismatches = 0;
+    for (int count = 0; count < 1024; count++) {
+        Complex eta[4];
+        Lanes eta_re;
+        Lanes eta_im;
+        Lanes cos_thetai;
+        for (int k = 0; k < 4; k++) {
+            eta[k] = generateEta();
+            eta_re[k] = eta[k].real();
+            eta_im[k] = eta[k].imag();
+            cos_thetai[k] = generateIn(Float(-1), Float(1));
+        }
+        Lanes fr = pre::fresnel_diel_cond(eta_re, eta_im, cos_thetai);
+        for (int k = 0; k < 4; k++) {
+            Float expect = pre::fresnel_diel_cond(eta[k], cos_thetai[k]);
+            nmismatches += !(pre::fabs(fr[k] - expect) <= Float(1e-12));
+        }
+    }
+
+    // Print test result.
+    std::cout << "Result: " << nmismatches << "\n\n";
+    std::cout.flush();
+}
+
+// Test table.
+void testTable()
+{
+    std::cout << "Testing table:\n";
+    std::cout << "This test tabulates 64 random sets of refractive\n";
+    std::cout << "indices, as conductors or as dielectrics with and\n";
+    std::cout << "without total internal reflection, and compares 1024\n";
+    std::cout << "random lookups each against the scalar form. This\n";
+    std::cout << "should print 1 for errors below 1e-3 for conductors,\n";
+    std::cout << "and 1 for errors below 1e-12 for dielectrics.\n";
+    std::cout.flush();
+
+    Float max_error[2] = {};
+    for (int count = 0; count < 64; count++) {
+        Complex eta[4];
+        for (int k = 0; k < 4; k++) {
+            eta[k] = generateEta();
+        }
+        FresnelTable table;
+        table.init(eta);
+        for (int lookup = 0; lookup < 1024; lookup++) {
+            Float cos_thetai = generateIn(Float(-1), Float(1));
+            Lanes fr = table.fr(cos_thetai);
+            for (int k = 0; k < 4; k++) {
+                Float expect = pre::fresnel_diel_cond(eta[k], cos_thetai);
+                Float& error = max_error[eta[k].imag() == 0];
+                error = std::max(error, pre::fabs(fr[k] - expect));
+            }
+        }
+    }
+
+    // Print test result.
+    std::cout << "Result: ";
+    std::cout << (max_error[0] < Float(1e-3)) << " ";
+    std::cout << "(" << max_error[0] << "), ";
+    std::cout << (max_error[1] < Float(1e-12)) << " ";
+    std::cout << "(" << max_error[1] << ")\n\n";
+    std::cout.flush();
+}
+
+int main(int argc, char** argv)
+{
+    int seed = 0;
+
+    // Option parser.
+    pre::option_parser opt_parser("[OPTIONS]");
+
+    // Specify seed.
+    opt_parser.on_option(
+    "-s", "--seed", 1,
+    [&](char** argv) {
+        try {
+            seed = std::stoi(argv[0]);
+        }
+        catch (const std::exception&) {
+            throw
+                std::runtime_error(
+                std::string("-s/--seed expects 1 integer ")
+                    .append("(can't parse ").append(argv[0])
+                    .append(")"));
+        }
+    })
+    << "Specify seed. By default, random.\n";
+
+    // Display help.
+    opt_parser.on_option(
+    "-h", "--help", 0,
+    [&](char**) {
+        std::cout << opt_parser << std::endl;
+        std::exit(EXIT_SUCCESS);
+    })
+    << "Display this help and exit.\n";
+
+    try {
+        // Parse args.
+        opt_parser.parse(argc, argv);
+    }
+    catch (const std::exception& exception) {
+        std::cerr << "Unhandled exception!\n";
+        std::cerr << "exception.what(): " << exception.what() << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+
+    // Seed.
+    if (seed == 0) {
+        seed = std::random_device()();
+    }
+    std::cout << "seed = " << seed << "\n\n";
+    std::cout.flush();
+    pcg = pre::pcg32(seed);
+
+    // Dielectric.
+    testDiel();
+
+    // Conductor.
+    testDielCond();
+
+    // Table.
+    testTable();
+
+    return EXIT_SUCCESS;
+}
@@ -1,6 +1,7 @@
 #include <iostream>
 #include <iomanip>
 #include <random>
+#include <vector>
 #include <preform/random.hpp>
 #include <preform/option_parser.hpp>
 #include <preform/half.hpp>
@@ -35,6 +36,41 @@ void testHalfAccuracy()
     std::cout.flush();
 }
 
+// Test bulk conversion.
+void testHalfBulk()
+{
+    std::cout << "Testing half bulk conversion:\n";
+    std::cout << "This test converts random single precision floats\n";
+    std::cout << "to half precision and back with float_to_half() and\n";
+    std::cout << "half_to_float(), and verifies that the results match\n";
+    std::cout << "elementwise conversion.\n";
+    std::cout.flush();
+
+    std::vector<float> x0(8191);
+    for (float& x : x0) {
+        x = pre::copysign(
+            pre::pow(2.0f, 40.0f * pre::generate_canonical<float>(pcg) - 30.0f),
+                     pcg(2) == 0 ? +1.0f : -1.0f);
+    }
+    std::vector<pre::half> xh(x0.size());
+    std::vector<float> x1(x0.size());
+    pre::float_to_half(x0.data(), xh.data(), x0.size());
+    pre::half_to_float(xh.data(), x1.data(), x0.size());
+    for (std::size_t k = 0; k < x0.size(); k++) {
+        float xk = pre::half(x0[k]);
+        if (!(x1[k] == xk)) {
+            std::cerr << "Failure!\n";
+            std::cerr << "x0 = " << x0[k] << "\n";
+            std::cerr << "x1 = " << x1[k] << "\n";
+            std::cerr << "xk = " << xk << "\n\n";
+            std::exit(EXIT_FAILURE);
+        }
+    }
+
+    std::cout << "Success (8191 tests).\n\n";
+    std::cout.flush();
+}
+
 // Test half special cases.
 void testHalfSpecialCase(float f)
 {
@@ -101,6 +137,9 @@ int main(int argc, char** argv)
     // Test half accuracy.
     testHalfAccuracy();
 
+    // Test bulk conversion.
+    testHalfBulk();
+
     // Test half special cases.
     std::cout << std::showpos;
     std::cout << std::boolalpha;
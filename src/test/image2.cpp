@@ -0,0 +1,381 @@
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <vector>
+#include <preform/random.hpp>
+#include <preform/multi_random.hpp>
+#include <preform/thread_pool.hpp>
+#include <preform/option_parser.hpp>
+#include <preform/image2.hpp>
+
+// Float type.
+typedef float Float;
+
+// 2-dimensional vector.
+typedef pre::vec2<Float> Vec2f;
+
+// 3-dimensional vector.
+typedef pre::vec3<Float> Vec3f;
+
+// Image.
+typedef pre::image2<Float, Float, 3> Image2;
+
+// Image, with blocks in Morton-ordered 32x32 tiles.
+typedef pre::image2<Float, Float, 3, std::allocator<Float>, 32> TiledImage2;
+
+// Image, half precision storage.
+typedef pre::image2<Float, pre::half, 3> HalfImage2;
+
+// Image, 8-bit sRGB storage.
+typedef pre::image2<Float, pre::srgb8, 3> Srgb8Image2;
+
+// Thread pool.
+typedef pre::thread_pool ThreadPool;
+
+// Permuted congruential generator.
+pre::pcg32 pcg;
+
+// Generate canonical random 2-dimensional vector.
+Vec2f generateCanonical2()
+{
+    return pre::generate_canonical<Float, 2>(pcg);
+}
+
+// Generate canonical random 3-dimensional vector.
+Vec3f generateCanonical3()
+{
+    return pre::generate_canonical<Float, 3>(pcg);
+}
+
+// Source image, 300 by 200.
+Image2 source;
+
+// Copy source image, into any storage.
+template <typename Timage>
+Timage copySource()
+{
+    typedef pre::image_storage_traits<
+            typename Timage::value_type::value_type> traits;
+    Timage image;
+    image.resize(source.user_size());
+    image.cycle_mode(source.cycle_mode());
+    for (std::size_t i = 0; i < source.user_size()[0]; i++)
+    for (std::size_t j = 0; j < source.user_size()[1]; j++) {
+        image(i, j) = traits::encode(source(i, j));
+    }
+    return image;
+}
+
+// Count mismatched texels, or -1 if sizes differ.
+template <typename Timage0, typename Timage1>
+int countMismatches(const Timage0& image0, const Timage1& image1)
+{
+    if (!(image0.user_size() == image1.user_size()).all()) {
+        return -1;
+    }
+    int nmismatches = 0;
+    for (std::size_t i = 0; i < image0.user_size()[0]; i++)
+    for (std::size_t j = 0; j < image0.user_size()[1]; j++) {
+        nmismatches += !(image0(i, j) == image1(i, j)).all();
+    }
+    return nmismatches;
+}
+
+// Random locations, partly outside the image.
+std::vector<Vec2f> randomLocations(std::size_t count)
+{
+    std::vector<Vec2f> locs(count);
+    for (Vec2f& loc : locs) {
+        loc = (generateCanonical2() * Float(1.5) - Float(0.25)) *
+               Vec2f(source.user_size());
+    }
+    return locs;
+}
+
+// Test tiled storage.
+void testTiled()
+{
+    std::cout << "Testing tiled storage:\n";
+    std::cout << "This test copies the image into Morton-ordered 32x32\n";
+    std::cout << "tiles, then samples 4096 random locations with each\n";
+    std::cout << "method, mip downsamples, and resamples, comparing\n";
+    std::cout << "against linear storage. This should print 0 mismatches\n";
+    std::cout << "for each.\n";
+    std::cout.flush();
+
+    TiledImage2 tiled = copySource<TiledImage2>();
+    int nmismatches[3] = {countMismatches(source, tiled)};
+    for (const Vec2f& loc : randomLocations(4096)) {
+        for (int samp : {0, 1, 3}) {
+            nmismatches[1] +=
+                !(tiled.sample(samp, loc) == source.sample(samp, loc)).all();
+        }
+    }
+    Image2 image = source;
+    image.mip_downsample();
+    tiled.mip_downsample();
+    nmismatches[2] += countMismatches(image, tiled);
+    image.resample(3, {173, 257});
+    tiled.resample(3, {173, 257});
+    nmismatches[2] += countMismatches(image, tiled);
+
+    // Print test result.
+    std::cout << "Result: " << nmismatches[0] << ", ";
+    std::cout << nmismatches[1] << ", " << nmismatches[2] << "\n\n";
+    std::cout.flush();
+}
+
+// Test parallel resampling.
+void testParallel()
+{
+    std::cout << "Testing parallel resampling:\n";
+    std::cout << "This test resamples with each method, mip downsamples,\n";
+    std::cout << "and resamples with a separable Mitchell filter, both\n";
+    std::cout << "in parallel and in serial. This should print 0\n";
+    std::cout << "mismatches for each.\n";
+    std::cout.flush();
+
+    ThreadPool pool;
+    int nmismatches[3] = {};
+    for (int samp : {0, 1, 3}) {
+        Image2 serial = source;
+        Image2 parallel = source;
+        serial.resample(samp, {431, 97});
+        parallel.resample(pool, samp, {431, 97});
+        nmismatches[0] += countMismatches(serial, parallel);
+    }
+    {
+        Image2 serial = source;
+        Image2 parallel = source;
+        serial.mip_downsample();
+        parallel.mip_downsample(pool);
+        nmismatches[1] += countMismatches(serial, parallel);
+    }
+    for (pre::multi<std::size_t, 2> count :
+            {pre::multi<std::size_t, 2>{137, 91},
+             pre::multi<std::size_t, 2>{611, 403}}) {
+        Image2 serial = source;
+        Image2 parallel = source;
+        serial.resample_separable(count, pre::mitchell_filter2<Float>());
+        parallel.resample_separable(
+                pool, count, pre::mitchell_filter2<Float>());
+        nmismatches[2] += countMismatches(serial, parallel);
+    }
+
+    // Print test result.
+    std::cout << "Result: " << nmismatches[0] << ", ";
+    std::cout << nmismatches[1] << ", " << nmismatches[2] << "\n\n";
+    std::cout.flush();
+}
+
+// Test filter weight tables.
+void testFilterWeightTable()
+{
+    std::cout << "Testing filter weight tables:\n";
+    std::cout << "This test tabulates Mitchell filter weights for random\n";
+    std::cout << "input and output counts, then compares a separable\n";
+    std::cout << "triangle filter at the same size against the image,\n";
+    std::cout << "and a separable box filter at half size against mip\n";
+    std::cout << "downsampling. This should print 0 tables with weights\n";
+    std::cout << "not summing to 1 or indexes out of range, and 0 for\n";
+    std::cout << "both maximum differences.\n";
+    std::cout.flush();
+
+    int nbad_tables = 0;
+    for (int k = 0; k < 256; k++) {
+        std::size_t in_count = 1 + pcg(512);
+        std::size_t out_count = 1 + pcg(512);
+        auto table =
+            pre::filter_weight_table<Float>::from_separable(
+                in_count, out_count, pre::mitchell_filter2<Float>(), k % 2,
+                [&](int ind) {
+                    return std::min(std::max(ind, 0), int(in_count) - 1);
+                });
+        bool bad = table.size() != out_count;
+        for (std::size_t pos = 0; pos < table.size(); pos++) {
+            Float sum = 0;
+            for (std::size_t tap = 0; tap < table.taps(); tap++) {
+                sum += table.weight(pos)[tap];
+                bad = bad ||
+                    table.index(pos)[tap] < 0 ||
+                    table.index(pos)[tap] >= int(in_count);
+            }
+            bad = bad || !(pre::abs(sum - 1) < Float(1e-5));
+        }
+        nbad_tables += bad;
+    }
+
+    // Maximum difference, summed over channels.
+    auto maxDiff = [](const Image2& image0, const Image2& image1) {
+        Float diff = 0;
+        for (std::size_t i = 0; i < image0.user_size()[0]; i++)
+        for (std::size_t j = 0; j < image0.user_size()[1]; j++) {
+            diff = std::max(diff,
+                   pre::abs(image0(i, j) - image1(i, j)).sum());
+        }
+        return diff;
+    };
+    Image2 identity = source;
+    identity.resample_separable(
+            source.user_size(), pre::triangle_filter2<Float>());
+    Image2 box = source;
+    Image2 mip = source;
+    box.resample_separable(source.user_size() / 2, pre::box_filter2<Float>());
+    mip.mip_downsample();
+
+    // Print test result.
+    std::cout << "Result: " << nbad_tables << ", ";
+    std::cout << (maxDiff(identity, source) < Float(1e-6) ? 0 : 1) << ", ";
+    std::cout << (maxDiff(box, mip) < Float(1e-6) ? 0 : 1) << " ";
+    std::cout << "(" << maxDiff(identity, source) << " and ";
+    std::cout << maxDiff(box, mip) << ")\n\n";
+    std::cout.flush();
+}
+
+// Test sampling many locations.
+void testSampleMany()
+{
+    std::cout << "Testing sampling many locations:\n";
+    std::cout << "This test samples 4096 random locations in one batch\n";
+    std::cout << "with each method, then compares against sampling one\n";
+    std::cout << "location at a time. This should print 0 mismatches for\n";
+    std::cout << "each.\n";
+    std::cout.flush();
+
+    std::vector<Vec2f> locs = randomLocations(4096);
+    std::vector<Vec3f> out(locs.size());
+    int nmismatches[3] = {};
+    int pos = 0;
+    for (int samp : {0, 1, 3}) {
+        source.sample_many(samp, locs.data(), locs.size(), out.data());
+        for (std::size_t k = 0; k < locs.size(); k++) {
+            nmismatches[pos] +=
+                !(out[k] == source.sample(samp, locs[k])).all();
+        }
+        pos++;
+    }
+
+    // Print test result.
+    std::cout << "Result: " << nmismatches[0] << ", ";
+    std::cout << nmismatches[1] << ", " << nmismatches[2] << "\n\n";
+    std::cout.flush();
+}
+
+// Test storage.
+void testStorage()
+{
+    std::cout << "Testing storage:\n";
+    std::cout << "This test copies the image into half precision and\n";
+    std::cout << "8-bit sRGB storage, then compares texels and mip\n";
+    std::cout << "downsampled texels against the float image. This should\n";
+    std::cout << "print 0 texels off by more than half precision, or by\n";
+    std::cout << "more than 1 step in 8-bit sRGB, for each.\n";
+    std::cout.flush();
+
+    HalfImage2 half_image = copySource<HalfImage2>();
+    Srgb8Image2 srgb8_image = copySource<Srgb8Image2>();
+    Image2 image = source;
+    int nbad[4] = {};
+    for (int level = 0; level < 2; level++) {
+        for (std::size_t i = 0; i < image.user_size()[0]; i++)
+        for (std::size_t j = 0; j < image.user_size()[1]; j++) {
+            Vec2f loc = Vec2f{Float(i), Float(j)} + Float(0.5);
+            Vec3f expect = image(i, j);
+            Vec3f half_value = half_image.sample0(loc);
+            Vec3f srgb8_value = srgb8_image.sample0(loc);
+            nbad[2 * level] +=
+                (pre::abs(half_value - expect) >
+                 expect * Float(1.0 / 1024.0) + Float(6e-8)).any();
+            for (int k = 0; k < 3; k++) {
+                nbad[2 * level + 1] +=
+                    !(pre::abs(pre::srgbenc(srgb8_value[k]) -
+                               pre::srgbenc(expect[k])) <=
+                      Float(1.0 / 255.0) + Float(1e-5));
+            }
+        }
+        image.mip_downsample();
+        half_image.mip_downsample();
+        srgb8_image.mip_downsample();
+    }
+
+    // Print test result.
+    std::cout << "Result: " << nbad[0] << ", " << nbad[1] << ", ";
+    std::cout << nbad[2] << ", " << nbad[3] << "\n\n";
+    std::cout.flush();
+}
+
+int main(int argc, char** argv)
+{
+    int seed = 0;
+
+    // Option parser.
+    pre::option_parser opt_parser("[OPTIONS]");
+
+    // Specify seed.
+    opt_parser.on_option(
+    "-s", "--seed", 1,
+    [&](char** argv) {
+        try {
+            seed = std::stoi(argv[0]);
+        }
+        catch (const std::exception&) {
+            throw
+                std::runtime_error(
+                std::string("-s/--seed expects 1 integer ")
+                    .append("(can't parse ").append(argv[0])
+                    .append(")"));
+        }
+    })
+    << "Specify seed. By default, random.\n";
+
+    // Display help.
+    opt_parser.on_option(
+    "-h", "--help", 0,
+    [&](char**) {
+        std::cout << opt_parser << std::endl;
+        std::exit(EXIT_SUCCESS);
+    })
+    << "Display this help and exit.\n";
+
+    try {
+        // Parse args.
+        opt_parser.parse(argc, argv);
+    }
+    catch (const std::exception& exception) {
+        std::cerr << "Unhandled exception!\n";
+        std::cerr << "exception.what(): " << exception.what() << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+
+    // Seed.
+    if (seed == 0) {
+        seed = std::random_device()();
+    }
+    std::cout << "seed = " << seed << "\n\n";
+    std::cout.flush();
+    pcg = pre::pcg32(seed);
+
+    // Source image.
+    source.resize({300, 200});
+    source.cycle_mode({+1, -1});
+    for (Vec3f& texel : source) {
+        texel = generateCanonical3();
+    }
+
+    // Tiled storage.
+    testTiled();
+
+    // Parallel resampling.
+    testParallel();
+
+    // Filter weight tables.
+    testFilterWeightTable();
+
+    // Sampling many locations.
+    testSampleMany();
+
+    // Storage.
+    testStorage();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,337 @@
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include <preform/random.hpp>
+#include <preform/multi_random.hpp>
+#include <preform/thread_pool.hpp>
+#include <preform/option_parser.hpp>
+#include <preform/kdtree.hpp>
+
+// Float type.
+typedef float Float;
+
+// 3-dimensional vector.
+typedef pre::vec3<Float> Vec3f;
+
+// Kd tree.
+typedef pre::kdtree<Float, 3, int> KdTree3;
+
+// Linear kd tree.
+typedef pre::linear_kdtree<Float, 3, int> LinearKdTree3;
+
+// Permuted congruential generator.
+pre::pcg32 pcg;
+
+// Generate canonical random 3-dimensional vector.
+Vec3f generateCanonical3()
+{
+    return pre::generate_canonical<Float, 3>(pcg);
+}
+
+// Points.
+std::vector<Vec3f> points;
+
+// Query points.
+std::vector<Vec3f> query_points;
+
+// Distances-squared from query point to all points, sorted.
+std::vector<Float> linearScan(const Vec3f& point)
+{
+    std::vector<Float> dist2s;
+    dist2s.reserve(points.size());
+    for (const Vec3f& other : points) {
+        Vec3f diff = other - point;
+        dist2s.push_back(pre::dot(diff, diff));
+    }
+    std::sort(dist2s.begin(), dist2s.end());
+    return dist2s;
+}
+
+// Test nearest neighbors.
+void testNearest(const KdTree3& tree, const LinearKdTree3& linear_tree)
+{
+    std::cout << "Testing nearest neighbors:\n";
+    std::cout << "This test queries the nearest neighbor and 8 nearest\n";
+    std::cout << "neighbors of " << query_points.size() << " random points, ";
+    std::cout << "in the kd tree, in the\n";
+    std::cout << "linear kd tree, and batched in serial and in parallel,\n";
+    std::cout << "then compares distances against a linear scan. This\n";
+    std::cout << "should print 0 mismatches for each.\n";
+    std::cout.flush();
+
+    constexpr std::size_t k = 8;
+    std::size_t nquery_points = query_points.size();
+    std::vector<KdTree3::node_dist2_pair_type> batch(nquery_points * k);
+    std::vector<KdTree3::node_dist2_pair_type> parallel_batch(
+                                               nquery_points * k);
+    tree.nearest(query_points.data(), nquery_points, k, batch.data());
+    pre::thread_pool pool;
+    tree.nearest(
+            pool, query_points.data(), nquery_points, k,
+            parallel_batch.data());
+
+    int nmismatches[4] = {};
+    for (std::size_t q = 0; q < nquery_points; q++) {
+        const Vec3f& point = query_points[q];
+        std::vector<Float> expect = linearScan(point);
+
+        // Nearest.
+        if (tree.nearest(point).second != expect[0] ||
+            linear_tree.nearest(point).second != expect[0]) {
+            nmismatches[0]++;
+        }
+
+        // Nearest k.
+        KdTree3::node_dist2_pair_type near[k];
+        LinearKdTree3::value_dist2_pair_type linear_near[k];
+        tree.nearest(point, &near[0], &near[0] + k);
+        linear_tree.nearest(point, &linear_near[0], &linear_near[0] + k);
+        for (std::size_t j = 0; j < k; j++) {
+            if (near[j].second != expect[j]) {
+                nmismatches[1]++;
+                break;
+            }
+        }
+        for (std::size_t j = 0; j < k; j++) {
+            if (linear_near[j].second != expect[j]) {
+                nmismatches[2]++;
+                break;
+            }
+        }
+
+        // Batched.
+        for (std::size_t j = 0; j < k; j++) {
+            if (batch[q * k + j].second != expect[j] ||
+                parallel_batch[q * k + j].second != expect[j]) {
+                nmismatches[3]++;
+                break;
+            }
+        }
+    }
+
+    // Print test result.
+    std::cout << "Result: " << nmismatches[0] << ", ";
+    std::cout << nmismatches[1] << ", " << nmismatches[2] << ", ";
+    std::cout << nmismatches[3] << "\n\n";
+    std::cout.flush();
+}
+
+// Test approximate nearest neighbors.
+void testApproximate(const KdTree3& tree, Float eps)
+{
+    std::cout << "Testing approximate nearest neighbors:\n";
+    std::cout << "This test queries the approximate nearest neighbor and\n";
+    std::cout << "8 nearest neighbors with epsilon " << eps << ", then ";
+    std::cout << "compares distances\n";
+    std::cout << "against a linear scan. This should print 0 results\n";
+    std::cout << "further than 1 + epsilon times the true distance.\n";
+    std::cout.flush();
+
+    constexpr std::size_t k = 8;
+    Float scale2 = (1 + eps) * (1 + eps);
+    int nbad = 0;
+    for (const Vec3f& point : query_points) {
+        std::vector<Float> expect = linearScan(point);
+        if (!(tree.nearest(point, eps).second <= scale2 * expect[0])) {
+            nbad++;
+        }
+        KdTree3::node_dist2_pair_type near[k];
+        tree.nearest(point, &near[0], &near[0] + k, eps);
+        for (std::size_t j = 0; j < k; j++) {
+            if (!(near[j].second <= scale2 * expect[j])) {
+                nbad++;
+                break;
+            }
+        }
+    }
+
+    // Print test result.
+    std::cout << "Result: " << nbad << "\n\n";
+    std::cout.flush();
+}
+
+// Test nearby.
+void testNearby(const KdTree3& tree, const LinearKdTree3& linear_tree)
+{
+    std::cout << "Testing nearby:\n";
+    std::cout << "This test visits points strictly within random radii of\n";
+    std::cout << query_points.size() << " random points, in the kd tree with ";
+    std::cout << "and without distances and\n";
+    std::cout << "stopping early, and in the linear kd tree, then compares\n";
+    std::cout << "against a linear scan. It then queries a negative radius.\n";
+    std::cout << "This should print 0 mismatches for each, and 1 rejected\n";
+    std::cout << "radius.\n";
+    std::cout.flush();
+
+    int nmismatches[4] = {};
+    for (const Vec3f& point : query_points) {
+        Float radius = pre::generate_canonical<Float>(pcg) * Float(0.2);
+        std::vector<int> expect;
+        for (std::size_t pos = 0; pos < points.size(); pos++) {
+            Vec3f diff = points[pos] - point;
+            if (radius * radius > pre::dot(diff, diff)) {
+                expect.push_back(int(pos));
+            }
+        }
+
+        // Without distances.
+        std::vector<int> result;
+        tree.nearby(point, radius, [&](const KdTree3::node_type* node) {
+            result.push_back(node->value.second);
+        });
+        std::sort(result.begin(), result.end());
+        nmismatches[0] += result != expect;
+
+        // With distances.
+        result.clear();
+        bool bad_dist2 = false;
+        tree.nearby(point, radius,
+            [&](const KdTree3::node_type* node, Float dist2) {
+                Vec3f diff = node->value.first - point;
+                bad_dist2 = bad_dist2 || dist2 != pre::dot(diff, diff);
+                result.push_back(node->value.second);
+            });
+        std::sort(result.begin(), result.end());
+        nmismatches[1] += result != expect || bad_dist2;
+
+        // Stopping early.
+        std::size_t count = 0;
+        bool finished =
+        tree.nearby(point, radius, [&](const KdTree3::node_type*) {
+            return ++count < 2;
+        });
+        nmismatches[2] += finished != (expect.size() < 2) ||
+                          count != std::min<std::size_t>(expect.size(), 2);
+
+        // Linear.
+        result.clear();
+        linear_tree.nearby(point, radius,
+            [&](const LinearKdTree3::value_type* value) {
+                result.push_back(value->second);
+                return true;
+            });
+        std::sort(result.begin(), result.end());
+        nmismatches[3] += result != expect;
+    }
+
+    // Negative radius.
+    int nrejected = 0;
+    try {
+        tree.nearby(query_points[0], -1, [](const KdTree3::node_type*) {});
+    }
+    catch (const std::invalid_argument&) {
+        nrejected++;
+    }
+
+    // Print test result.
+    std::cout << "Result: " << nmismatches[0] << ", ";
+    std::cout << nmismatches[1] << ", " << nmismatches[2] << ", ";
+    std::cout << nmismatches[3] << ", " << nrejected << "\n\n";
+    std::cout.flush();
+}
+
+int main(int argc, char** argv)
+{
+    int seed = 0;
+    int npoints = 16384;
+
+    // Option parser.
+    pre::option_parser opt_parser("[OPTIONS]");
+
+    // Specify seed.
+    opt_parser.on_option(
+    "-s", "--seed", 1,
+    [&](char** argv) {
+        try {
+            seed = std::stoi(argv[0]);
+        }
+        catch (const std::exception&) {
+            throw
+                std::runtime_error(
+                std::string("-s/--seed expects 1 integer ")
+                    .append("(can't parse ").append(argv[0])
+                    .append(")"));
+        }
+    })
+    << "Specify seed. By default, random.\n";
+
+    // Specify point count.
+    opt_parser.on_option(
+    "-n", "--npoints", 1,
+    [&](char** argv) {
+        try {
+            npoints = std::stoi(argv[0]);
+            if (!(npoints >= 16)) {
+                throw std::exception();
+            }
+        }
+        catch (const std::exception&) {
+            throw
+                std::runtime_error(
+                std::string("-n/--npoints expects 1 integer >= 16 ")
+                    .append("(can't parse ").append(argv[0])
+                    .append(")"));
+        }
+    })
+    << "Specify point count. By default, 16384.\n";
+
+    // Display help.
+    opt_parser.on_option(
+    "-h", "--help", 0,
+    [&](char**) {
+        std::cout << opt_parser << std::endl;
+        std::exit(EXIT_SUCCESS);
+    })
+    << "Display this help and exit.\n";
+
+    try {
+        // Parse args.
+        opt_parser.parse(argc, argv);
+    }
+    catch (const std::exception& exception) {
+        std::cerr << "Unhandled exception!\n";
+        std::cerr << "exception.what(): " << exception.what() << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+
+    // Seed.
+    if (seed == 0) {
+        seed = std::random_device()();
+    }
+    std::cout << "seed = " << seed << "\n\n";
+    std::cout.flush();
+    pcg = pre::pcg32(seed);
+
+    // Generate points.
+    points.resize(npoints);
+    for (Vec3f& point : points) {
+        point = generateCanonical3();
+    }
+    query_points.resize(256);
+    for (Vec3f& point : query_points) {
+        point = generateCanonical3() * Float(1.2) - Float(0.1);
+    }
+
+    // Initialize.
+    KdTree3 tree;
+    tree.init(
+        points.begin(),
+        points.end(),
+        [&](const Vec3f& point) -> KdTree3::value_type {
+            return {point, int(&point - &points[0])};
+        });
+    LinearKdTree3 linear_tree(tree);
+
+    // Nearest neighbors.
+    testNearest(tree, linear_tree);
+
+    // Approximate nearest neighbors.
+    testApproximate(tree, Float(0.5));
+
+    // Nearby.
+    testNearby(tree, linear_tree);
+
+    return EXIT_SUCCESS;
+}
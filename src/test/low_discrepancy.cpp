@@ -0,0 +1,310 @@
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+#include <preform/random.hpp>
+#include <preform/option_parser.hpp>
+#include <preform/low_discrepancy.hpp>
+
+// Sobol sequence.
+typedef pre::sobol_sequence SobolSequence;
+
+// Halton sequence.
+typedef pre::halton_sequence HaltonSequence;
+
+// Blue-noise tile.
+typedef pre::blue_noise_tile BlueNoiseTile;
+
+// Blue-noise generator.
+typedef pre::blue_noise_generator BlueNoiseGenerator;
+
+// Seed.
+std::uint64_t seed = 0;
+
+// Is every box of a grid hit exactly once?
+bool isStratified(
+        const std::vector<double>& u0,
+        const std::vector<double>& u1,
+        std::size_t count0,
+        std::size_t count1)
+{
+    // Allow radical inverses to round just below bin edges.
+    constexpr double eps = 1e-12;
+    std::vector<int> hits(count0 * count1);
+    for (std::size_t k = 0; k < u0.size(); k++) {
+        std::size_t bin0 = std::size_t((u0[k] + eps) * count0);
+        std::size_t bin1 = std::size_t((u1[k] + eps) * count1);
+        if (!(bin0 < count0 && bin1 < count1)) {
+            return false;
+        }
+        hits[bin0 * count1 + bin1]++;
+    }
+    for (int hit : hits) {
+        if (hit != 1) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Test Sobol sequence.
+void testSobol(bool scramble)
+{
+    std::cout << "Testing " << (scramble ? "scrambled" : "plain") << " ";
+    std::cout << "Sobol sequence:\n";
+    std::cout << "This test checks that the first 4096 points stratify\n";
+    std::cout << "every one of the 16 dimensions into 4096 bins, and the\n";
+    std::cout << "first 2 dimensions into every grid of 4096 boxes of\n";
+    std::cout << "power of 2 sides. It then compares batch generation and\n";
+    std::cout << "sequential generation against sampling each index and\n";
+    std::cout << "dimension, with padded dimensions. This should print 0\n";
+    std::cout << "bad dimensions, 0 bad grids, and 0 mismatches for each.\n";
+    std::cout.flush();
+
+    constexpr std::size_t m = 12;
+    constexpr std::size_t count = 1 << m;
+    SobolSequence sobol(seed, scramble);
+    std::vector<std::vector<double>> u(
+            SobolSequence::max_dimensions, std::vector<double>(count));
+    for (std::size_t dim = 0; dim < SobolSequence::max_dimensions; dim++) {
+        for (std::size_t k = 0; k < count; k++) {
+            u[dim][k] = sobol.sample<double>(std::uint32_t(k), dim);
+        }
+    }
+    int nbad_dims = 0;
+    for (std::size_t dim = 0; dim < SobolSequence::max_dimensions; dim++) {
+        nbad_dims += !isStratified(u[dim], u[dim], count, 1);
+    }
+    int nbad_grids = 0;
+    for (std::size_t a = 0; a <= m; a++) {
+        nbad_grids += !isStratified(
+                u[0], u[1], std::size_t(1) << a, std::size_t(1) << (m - a));
+    }
+
+    // Batch and sequential generation.
+    constexpr std::size_t dims = 20;
+    std::vector<double> batch(count * dims);
+    sobol.generate(37, count, dims, batch.data());
+    int nmismatches[2] = {};
+    sobol.seek(37);
+    for (std::size_t k = 0; k < count; k++) {
+        std::uint32_t index = std::uint32_t(37 + k);
+        for (std::size_t dim = 0; dim < dims; dim++) {
+            nmismatches[0] +=
+                batch[k * dims + dim] != sobol.sample<double>(index, dim);
+            nmismatches[1] +=
+                (sobol() >> 32) != sobol.sample_bits(index, dim);
+        }
+        sobol.next();
+    }
+
+    // Print test result.
+    std::cout << "Result: " << nbad_dims << ", " << nbad_grids << ", ";
+    std::cout << nmismatches[0] << ", " << nmismatches[1] << "\n\n";
+    std::cout.flush();
+}
+
+// Test Halton sequence.
+void testHalton(bool scramble)
+{
+    std::cout << "Testing " << (scramble ? "scrambled" : "plain") << " ";
+    std::cout << "Halton sequence:\n";
+    std::cout << "This test checks that the first b^k points stratify each\n";
+    std::cout << "of the 16 dimensions of base b into b^k bins, for the\n";
+    std::cout << "largest b^k up to 4096, and that the first 5184 points\n";
+    std::cout << "stratify the first 2 dimensions into 64x81 boxes. It then\n";
+    std::cout << "compares batch generation and sequential generation\n";
+    std::cout << "against sampling each index and dimension. This should\n";
+    std::cout << "print 0 bad dimensions, 0 bad grids, and 0 mismatches\n";
+    std::cout << "for each.\n";
+    std::cout.flush();
+
+    HaltonSequence halton(seed, scramble);
+    const std::size_t bases[16] = {
+        2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47, 53
+    };
+    int nbad_dims = 0;
+    for (std::size_t dim = 0; dim < 16; dim++) {
+        std::size_t count = 1;
+        while (count * bases[dim] <= 4096) {
+            count *= bases[dim];
+        }
+        std::vector<double> u(count);
+        for (std::size_t k = 0; k < count; k++) {
+            u[k] = halton.sample<double>(k, dim);
+        }
+        nbad_dims += !isStratified(u, u, count, 1);
+    }
+    std::vector<double> u0(64 * 81);
+    std::vector<double> u1(64 * 81);
+    for (std::size_t k = 0; k < u0.size(); k++) {
+        u0[k] = halton.sample<double>(k, 0);
+        u1[k] = halton.sample<double>(k, 1);
+    }
+    int nbad_grids = !isStratified(u0, u1, 64, 81);
+
+    // Batch and sequential generation.
+    constexpr std::size_t count = 4096;
+    constexpr std::size_t dims = 20;
+    std::vector<double> batch(count * dims);
+    halton.generate(37, count, dims, batch.data());
+    int nmismatches[2] = {};
+    halton.seek(37);
+    for (std::size_t k = 0; k < count; k++) {
+        for (std::size_t dim = 0; dim < dims; dim++) {
+            double expect = halton.sample<double>(37 + k, dim);
+            nmismatches[0] += batch[k * dims + dim] != expect;
+            nmismatches[1] +=
+                !(std::fabs(double(halton()) * 0x1p-64 - expect) < 1e-15);
+        }
+        halton.next();
+    }
+
+    // Print test result.
+    std::cout << "Result: " << nbad_dims << ", " << nbad_grids << ", ";
+    std::cout << nmismatches[0] << ", " << nmismatches[1] << "\n\n";
+    std::cout.flush();
+}
+
+// Test blue noise.
+void testBlueNoise()
+{
+    std::cout << "Testing blue noise:\n";
+    std::cout << "This test generates a 64x64 tile, checks that its ranks\n";
+    std::cout << "form a permutation, and counts adjacent pixels both\n";
+    std::cout << "below rank thresholds at densities 1/16, 1/8, and 1/4,\n";
+    std::cout << "against the expected count for white noise. It then\n";
+    std::cout << "checks that generated values of one dimension fall in\n";
+    std::cout << "distinct rank bins over the tile. This should print 0\n";
+    std::cout << "bad ranks, 1 for fewer than half of the white noise\n";
+    std::cout << "adjacent pairs for each density, and 0 bad dimensions.\n";
+    std::cout.flush();
+
+    BlueNoiseTile tile(6, seed);
+    int n = tile.count();
+    std::vector<int> hits(n);
+    for (int k = 0; k < n; k++) {
+        if (tile.ranks()[k] < std::uint32_t(n)) {
+            hits[tile.ranks()[k]]++;
+        }
+    }
+    int nbad_ranks = 0;
+    for (int hit : hits) {
+        nbad_ranks += hit != 1;
+    }
+
+    // Adjacent pairs.
+    int npairs[3] = {};
+    double nwhite_pairs[3] = {};
+    int densities[3] = {16, 8, 4};
+    for (int pos = 0; pos < 3; pos++) {
+        std::uint32_t threshold = std::uint32_t(n / densities[pos]);
+        for (int y = 0; y < tile.size(); y++)
+        for (int x = 0; x < tile.size(); x++) {
+            if (tile.rank(x, y) < threshold) {
+                npairs[pos] += tile.rank(x + 1, y) < threshold;
+                npairs[pos] += tile.rank(x, y + 1) < threshold;
+            }
+        }
+        nwhite_pairs[pos] =
+            2.0 * n / (densities[pos] * densities[pos]);
+    }
+
+    // Generated values.
+    int nbad_dims = 0;
+    std::uint64_t bin = ~0ULL / std::uint64_t(n);
+    for (int dim = 0; dim < 4; dim++) {
+        std::vector<int> bin_hits(n);
+        for (int y = 0; y < tile.size(); y++)
+        for (int x = 0; x < tile.size(); x++) {
+            BlueNoiseGenerator gen(tile, x + 100, y + 200, 7);
+            gen.dimension(dim);
+            std::uint64_t rank = gen() / bin;
+            if (rank < std::uint64_t(n)) {
+                bin_hits[rank]++;
+            }
+        }
+        for (int hit : bin_hits) {
+            if (hit != 1) {
+                nbad_dims++;
+                break;
+            }
+        }
+    }
+
+    // Print test result.
+    std::cout << "Result: " << nbad_ranks << ", ";
+    for (int pos = 0; pos < 3; pos++) {
+        std::cout << (npairs[pos] < nwhite_pairs[pos] / 2) << ", ";
+    }
+    std::cout << nbad_dims << " ";
+    std::cout << "(" << npairs[0] << ", " << npairs[1] << ", " << npairs[2];
+    std::cout << " adjacent pairs)\n\n";
+    std::cout.flush();
+}
+
+int main(int argc, char** argv)
+{
+    int seed_arg = 0;
+
+    // Option parser.
+    pre::option_parser opt_parser("[OPTIONS]");
+
+    // Specify seed.
+    opt_parser.on_option(
+    "-s", "--seed", 1,
+    [&](char** argv) {
+        try {
+            seed_arg = std::stoi(argv[0]);
+        }
+        catch (const std::exception&) {
+            throw
+                std::runtime_error(
+                std::string("-s/--seed expects 1 integer ")
+                    .append("(can't parse ").append(argv[0])
+                    .append(")"));
+        }
+    })
+    << "Specify seed. By default, random.\n";
+
+    // Display help.
+    opt_parser.on_option(
+    "-h", "--help", 0,
+    [&](char**) {
+        std::cout << opt_parser << std::endl;
+        std::exit(EXIT_SUCCESS);
+    })
+    << "Display this help and exit.\n";
+
+    try {
+        // Parse args.
+        opt_parser.parse(argc, argv);
+    }
+    catch (const std::exception& exception) {
+        std::cerr << "Unhandled exception!\n";
+        std::cerr << "exception.what(): " << exception.what() << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+
+    // Seed.
+    if (seed_arg == 0) {
+        seed_arg = std::random_device()();
+    }
+    std::cout << "seed = " << seed_arg << "\n\n";
+    std::cout.flush();
+    seed = std::uint64_t(seed_arg);
+
+    // Sobol sequence.
+    testSobol(false);
+    testSobol(true);
+
+    // Halton sequence.
+    testHalton(false);
+    testHalton(true);
+
+    // Blue noise.
+    testBlueNoise();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,272 @@
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <preform/random.hpp>
+#include <preform/multi_random.hpp>
+#include <preform/option_parser.hpp>
+#include <preform/image2.hpp>
+#include <preform/image3.hpp>
+#include <preform/mapped_image.hpp>
+
+// Float type.
+typedef float Float;
+
+// 2-dimensional vector.
+typedef pre::vec2<Float> Vec2f;
+
+// 3-dimensional vector.
+typedef pre::vec3<Float> Vec3f;
+
+// Image.
+typedef pre::image2<Float, Float, 3> Image2;
+
+// Volume, 16-bit unsigned integer storage.
+typedef pre::image3<Float, std::uint16_t, 1> Image3;
+
+// Mapped image.
+typedef pre::mapped_image2<Float, Float, 3> MappedImage2;
+
+// Mapped volume.
+typedef pre::mapped_image3<Float, std::uint16_t, 1> MappedImage3;
+
+// Permuted congruential generator.
+pre::pcg32 pcg;
+
+// Generate canonical random 2-dimensional vector.
+Vec2f generateCanonical2()
+{
+    return pre::generate_canonical<Float, 2>(pcg);
+}
+
+// Generate canonical random 3-dimensional vector.
+Vec3f generateCanonical3()
+{
+    return pre::generate_canonical<Float, 3>(pcg);
+}
+
+// Temporary path.
+std::string temporaryPath(const char* name)
+{
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+// Test round trip.
+void testRoundTrip(pre::byte_order order)
+{
+    std::cout << "Testing round trip in " << pre::to_string(order) << " ";
+    std::cout << "endian byte order:\n";
+    std::cout << "This test writes 4 mip levels of a 200x120 image in\n";
+    std::cout << "16x16 tiles, maps the file, then compares every entry,\n";
+    std::cout << "4096 random samples with each method, and loaded levels\n";
+    std::cout << "and regions against the images. This should print 4\n";
+    std::cout << "levels, and 0 mismatches for each.\n";
+    std::cout.flush();
+
+    std::vector<Image2> mips;
+    Image2 image;
+    image.resize({200, 120});
+    image.cycle_mode({+1, -1});
+    for (Vec3f& texel : image) {
+        texel = generateCanonical3();
+    }
+    mips.push_back(image);
+    for (int level = 1; level < 4; level++) {
+        image.mip_downsample();
+        mips.push_back(image);
+    }
+    std::string path = temporaryPath("preform_mapped_image2.bin");
+    MappedImage2::write(path, mips, 16, order);
+
+    MappedImage2 mapped(path);
+    mapped.cycle_mode({+1, -1});
+    int nmismatches[3] = {};
+    for (int level = 0; level < mapped.levels(); level++) {
+        const Image2& mip = mips[level];
+        if (!(mapped.level_size(level) == mip.user_size()).all()) {
+            nmismatches[0]++;
+            continue;
+        }
+        for (std::size_t i = 0; i < mip.user_size()[0]; i++)
+        for (std::size_t j = 0; j < mip.user_size()[1]; j++) {
+            nmismatches[0] += !(mapped(level, {i, j}) == mip(i, j)).all();
+        }
+        for (int k = 0; k < 1024; k++) {
+            Vec2f loc =
+                (generateCanonical2() * Float(1.5) - Float(0.25)) *
+                 Vec2f(mip.user_size());
+            for (int samp : {0, 1, 3}) {
+                nmismatches[1] +=
+                    (pre::abs(mapped.sample(samp, level, loc) -
+                              mip.sample(samp, loc)) > Float(1e-5)).any();
+            }
+        }
+
+        // Load level.
+        Image2 loaded;
+        mapped.load(level, loaded);
+        for (std::size_t i = 0; i < mip.user_size()[0]; i++)
+        for (std::size_t j = 0; j < mip.user_size()[1]; j++) {
+            nmismatches[2] += !(loaded(i, j) == mip(i, j)).all();
+        }
+
+        // Load region.
+        Image2 region;
+        region.resize(
+            pre::min(mip.user_size(), MappedImage2::index_type(16)));
+        MappedImage2::index_type origin =
+            mip.user_size() - region.user_size();
+        mapped.load_region(level, origin, region);
+        for (std::size_t i = 0; i < region.user_size()[0]; i++)
+        for (std::size_t j = 0; j < region.user_size()[1]; j++) {
+            nmismatches[2] +=
+                !(region(i, j) == mip(origin[0] + i, origin[1] + j)).all();
+        }
+    }
+    std::filesystem::remove(path);
+
+    // Print test result.
+    std::cout << "Result: " << mapped.levels() << ", ";
+    std::cout << nmismatches[0] << ", " << nmismatches[1] << ", ";
+    std::cout << nmismatches[2] << "\n\n";
+    std::cout.flush();
+}
+
+// Test volumes.
+void testVolume()
+{
+    std::cout << "Testing volumes:\n";
+    std::cout << "This test writes a 20x17x9 volume of 16-bit entries in\n";
+    std::cout << "16x16x16 tiles and in the other byte order, then\n";
+    std::cout << "maps the file and compares every entry. This should\n";
+    std::cout << "print 0 mismatches.\n";
+    std::cout.flush();
+
+    Image3 volume;
+    volume.resize({20, 17, 9});
+    for (auto& value : volume) {
+        value = {std::uint16_t(pcg(65536))};
+    }
+    pre::byte_order order =
+        pre::host_byte_order() == pre::byte_order::little ?
+        pre::byte_order::big : pre::byte_order::little;
+    std::string path = temporaryPath("preform_mapped_image3.bin");
+    MappedImage3::write(path, std::vector<Image3>{volume},
+                        MappedImage3::size_type(16), order);
+
+    MappedImage3 mapped(path);
+    int nmismatches = 0;
+    for (std::size_t i = 0; i < volume.user_size()[0]; i++)
+    for (std::size_t j = 0; j < volume.user_size()[1]; j++)
+    for (std::size_t k = 0; k < volume.user_size()[2]; k++) {
+        nmismatches +=
+            !(mapped(0, {i, j, k}) == volume(i, j, k)).all();
+    }
+    std::filesystem::remove(path);
+
+    // Print test result.
+    std::cout << "Result: " << nmismatches << "\n\n";
+    std::cout.flush();
+}
+
+// Test malformed files.
+void testMalformed()
+{
+    std::cout << "Testing malformed files:\n";
+    std::cout << "This test maps a truncated file, and a file with the\n";
+    std::cout << "wrong channel count. This should print 2 rejected\n";
+    std::cout << "files.\n";
+    std::cout.flush();
+
+    Image2 image;
+    image.resize({64, 64});
+    std::string path = temporaryPath("preform_mapped_image2.bin");
+    MappedImage2::write(path, std::vector<Image2>{image});
+    int nrejected = 0;
+    try {
+        pre::mapped_image2<Float, Float, 4> mapped(path);
+    }
+    catch (const std::runtime_error&) {
+        nrejected++;
+    }
+    std::filesystem::resize_file(path, 4096 + 64);
+    try {
+        MappedImage2 mapped(path);
+    }
+    catch (const std::runtime_error&) {
+        nrejected++;
+    }
+    std::filesystem::remove(path);
+
+    // Print test result.
+    std::cout << "Result: " << nrejected << "\n\n";
+    std::cout.flush();
+}
+
+int main(int argc, char** argv)
+{
+    int seed = 0;
+
+    // Option parser.
+    pre::option_parser opt_parser("[OPTIONS]");
+
+    // Specify seed.
+    opt_parser.on_option(
+    "-s", "--seed", 1,
+    [&](char** argv) {
+        try {
+            seed = std::stoi(argv[0]);
+        }
+        catch (const std::exception&) {
+            throw
+                std::runtime_error(
+                std::string("-s/--seed expects 1 integer ")
+                    .append("(can't parse ").append(argv[0])
+                    .append(")"));
+        }
+    })
+    << "Specify seed. By default, random.\n";
+
+    // Display help.
+    opt_parser.on_option(
+    "-h", "--help", 0,
+    [&](char**) {
+        std::cout << opt_parser << std::endl;
+        std::exit(EXIT_SUCCESS);
+    })
+    << "Display this help and exit.\n";
+
+    try {
+        // Parse args.
+        opt_parser.parse(argc, argv);
+    }
+    catch (const std::exception& exception) {
+        std::cerr << "Unhandled exception!\n";
+        std::cerr << "exception.what(): " << exception.what() << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+
+    // Seed.
+    if (seed == 0) {
+        seed = std::random_device()();
+    }
+    std::cout << "seed = " << seed << "\n\n";
+    std::cout.flush();
+    pcg = pre::pcg32(seed);
+
+    // Round trip.
+    testRoundTrip(pre::byte_order::little);
+    testRoundTrip(pre::byte_order::big);
+
+    // Volumes.
+    testVolume();
+
+    // Malformed files.
+    testMalformed();
+
+    return EXIT_SUCCESS;
+}
@@ -5,6 +5,7 @@
 #include <preform/multi_random.hpp>
 #include <preform/quat.hpp>
 #include <preform/medium.hpp>
+#include <preform/sparse_image3.hpp>
 #include <preform/neumaier_sum.hpp>
 #include <preform/option_parser.hpp>
 
@@ -46,6 +47,14 @@ typedef pre::microvolume_sggx_specular_phase<Float>
 typedef pre::microvolume_sggx_diffuse_phase<Float>
         MicrovolumeSggxDiffusePhase;
 
+// Sparse density volume.
+typedef pre::sparse_image3<Float, Float, 1>
+        SparseImage3;
+
+// Heterogeneous medium.
+typedef pre::heterogeneous_medium<Float, SparseImage3>
+        HeterogeneousMedium;
+
 // Neumaier sum.
 typedef pre::neumaier_sum<Float> NeumaierSum;
 
@@ -162,6 +171,67 @@ void testPhaseSampling(const char* name, const Func& func, Pred&& pred)
 
 }
 
+// Test heterogeneous medium tracking.
+void testHeterogeneous(int samp)
+{
+    std::cout << "Testing heterogeneous medium with samp = " << samp;
+    std::cout << ":\n";
+    std::cout <<
+        "This test estimates transmittance through a random blob of\n"
+        "density by ratio tracking and by delta tracking, and compares\n"
+        "both against quadrature of the optical depth. The ray starts in\n"
+        "empty space, so that tracking must skip it.\n";
+    std::cout.flush();
+
+    // Density, as a gaussian blob in a mostly empty volume.
+    int n = 64;
+    SparseImage3 volume({
+        std::size_t(n),
+        std::size_t(n),
+        std::size_t(n)});
+    Vec3f center = 24 + 16 * pre::generate_canonical<Float, 3>(pcg);
+    for (int i0 = 0; i0 < n; i0++)
+    for (int i1 = 0; i1 < n; i1++)
+    for (int i2 = 0; i2 < n; i2++) {
+        Vec3f x = (Vec3f{Float(i0), Float(i1), Float(i2)} - center) / 8;
+        Float density = 2 * pre::exp(-pre::dot(x, x));
+        if (density > Float(0.01)) {
+            volume.set({
+                std::size_t(i0),
+                std::size_t(i1),
+                std::size_t(i2)}, {density});
+        }
+    }
+    HeterogeneousMedium medium(volume, 0.01, 0.04, samp);
+
+    // Ray through center.
+    Vec3f loc = {0.5, 0.5, 0.5};
+    Vec3f dir = pre::normalize(center - loc);
+    Float d = 100;
+
+    // Quadrature.
+    NeumaierSum tau = 0;
+    for (int k = 0; k < 100000; k++) {
+        tau += medium.density(loc + (k + Float(0.5)) * Float(1e-3) * dir);
+    }
+    Float tr_ref = pre::exp(-Float(tau) * Float(1e-3) * medium.mu());
+
+    // Ratio tracking and delta tracking.
+    int m = 100000;
+    NeumaierSum tr_ratio = 0;
+    NeumaierSum tr_delta = 0;
+    for (int k = 0; k < m; k++) {
+        tr_ratio += medium.tau(pcg, loc, dir, d) / m;
+        tr_delta += pre::isinf(medium.tau_pdf_sample(pcg, loc, dir, d)) ?
+                    Float(1) / m : 0;
+    }
+    std::cout << "Quadrature: " << tr_ref << "\n";
+    std::cout << "Ratio tracking: " << Float(tr_ratio) << "\n";
+    std::cout << "Delta tracking: " << Float(tr_delta) << "\n";
+    std::cout << "\n\n";
+    std::cout.flush();
+}
+
 int main(int argc, char** argv)
 {
     int seed = 0;
@@ -321,5 +391,10 @@ int main(int argc, char** argv)
              MicrovolumeSggxDiffusePhase(Mat3f(q), s),
              diffuse_pred);
     }
+    {
+        // Test heterogeneous medium tracking.
+        testHeterogeneous(1);
+        testHeterogeneous(3);
+    }
     return 0;
 }
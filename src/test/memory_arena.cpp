@@ -0,0 +1,312 @@
+#define PREFORM_ALLOCATOR_STATS 1
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+#include <preform/random.hpp>
+#include <preform/option_parser.hpp>
+#include <preform/memory_arena.hpp>
+
+// Block allocations, counting calls of at least 1024 bytes.
+std::atomic<int> nblock_allocs(0);
+
+// Byte allocator, counting block allocations.
+template <typename T>
+struct CountingAllocator : std::allocator<T>
+{
+    template <typename U>
+    struct rebind
+    {
+        typedef CountingAllocator<U> other;
+    };
+
+    CountingAllocator() = default;
+
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U>&)
+    {
+    }
+
+    T* allocate(std::size_t n)
+    {
+        if (n * sizeof(T) >= 1024) {
+            nblock_allocs++;
+        }
+        return std::allocator<T>::allocate(n);
+    }
+};
+
+// Memory arena.
+typedef pre::memory_arena<CountingAllocator<char>> MemoryArena;
+
+// Scoped memory arena.
+typedef pre::scoped_arena<CountingAllocator<char>> ScopedArena;
+
+// Concurrent memory arena.
+typedef pre::concurrent_memory_arena<CountingAllocator<char>>
+        ConcurrentMemoryArena;
+
+// Permuted congruential generator.
+pre::pcg32 pcg;
+
+// Fill bytes with pattern.
+void fill(void* ptr, std::size_t size, unsigned char pattern)
+{
+    std::memset(ptr, pattern, size);
+}
+
+// Check bytes against pattern.
+bool check(const void* ptr, std::size_t size, unsigned char pattern)
+{
+    const unsigned char* bytes = static_cast<const unsigned char*>(ptr);
+    for (std::size_t k = 0; k < size; k++) {
+        if (bytes[k] != pattern) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Test markers and scoped arenas.
+void testMarkers()
+{
+    std::cout << "Testing markers:\n";
+    std::cout << "This test runs 1000 cycles of the same allocations in\n";
+    std::cout << "nested scoped arenas, with 4096-byte blocks, checking\n";
+    std::cout << "that outer allocations survive each inner scope, and\n";
+    std::cout << "that every scope rewinds to its marker. This should\n";
+    std::cout << "print 0 corruptions, 0 bad rewinds, and 0 block\n";
+    std::cout << "allocations after the first cycle.\n";
+    std::cout.flush();
+
+    std::vector<std::size_t> sizes(64);
+    for (std::size_t& size : sizes) {
+        size = 1 + pcg(256);
+    }
+    nblock_allocs = 0;
+    MemoryArena arena(4096);
+    int ncorruptions = 0;
+    int nbad_rewinds = 0;
+    int nfirst_allocs = 0;
+    for (int cycle = 0; cycle < 1000; cycle++) {
+        MemoryArena::marker_type start = arena.marker();
+        {
+            ScopedArena outer(arena);
+            std::vector<void*> outer_ptrs;
+            for (std::size_t k = 0; k < 32; k++) {
+                outer_ptrs.push_back(outer.allocate(sizes[k]));
+                fill(outer_ptrs.back(), sizes[k], 0xA5);
+            }
+            for (int inner_cycle = 0; inner_cycle < 4; inner_cycle++) {
+                MemoryArena::marker_type mid = arena.marker();
+                {
+                    ScopedArena inner(arena);
+                    for (std::size_t k = 32; k < 64; k++) {
+                        fill(inner.allocate(sizes[k]), sizes[k], 0x5A);
+                    }
+                }
+                MemoryArena::marker_type end = arena.marker();
+                nbad_rewinds +=
+                    end.full_count != mid.full_count ||
+                    end.offset != mid.offset;
+            }
+            for (std::size_t k = 0; k < 32; k++) {
+                ncorruptions += !check(outer_ptrs[k], sizes[k], 0xA5);
+            }
+        }
+        MemoryArena::marker_type end = arena.marker();
+        nbad_rewinds +=
+            end.full_count != start.full_count ||
+            end.offset != start.offset;
+        if (cycle == 0) {
+            nfirst_allocs = nblock_allocs;
+        }
+    }
+
+    // Print test result.
+    std::cout << "Result: " << ncorruptions << ", " << nbad_rewinds << ", ";
+    std::cout << nblock_allocs - nfirst_allocs << " ";
+    std::cout << "(" << nfirst_allocs << " block allocations in first ";
+    std::cout << "cycle)\n\n";
+    std::cout.flush();
+}
+
+// Test statistics.
+void testStats()
+{
+    std::cout << "Testing statistics:\n";
+    std::cout << "This test allocates 10 and 100 bytes from a 1024-byte\n";
+    std::cout << "block, marks, allocates 2000 bytes, rewinds, then\n";
+    std::cout << "clears. This should print 2110 bytes requested, 128\n";
+    std::cout << "bytes in use after rewinding, a peak of 2128 bytes in\n";
+    std::cout << "use, 3024 bytes reserved in 2 block allocations, then\n";
+    std::cout << "0 bytes in use and 1 reset after clearing.\n";
+    std::cout.flush();
+
+    MemoryArena arena(1024);
+    arena.allocate(10);
+    arena.allocate(100);
+    MemoryArena::marker_type m = arena.marker();
+    arena.allocate(2000);
+    arena.rewind(m);
+    pre::allocator_stats stats = arena.stats();
+    arena.clear();
+    pre::allocator_stats cleared = arena.stats();
+
+    // Print test result.
+    std::cout << "Result: " << stats.bytes_requested << ", ";
+    std::cout << stats.bytes_in_use << ", ";
+    std::cout << stats.peak_bytes_in_use << ", ";
+    std::cout << stats.bytes_reserved << ", ";
+    std::cout << stats.block_allocations << ", ";
+    std::cout << cleared.bytes_in_use << ", ";
+    std::cout << cleared.reset_count << "\n\n";
+    std::cout.flush();
+}
+
+// Test concurrent memory arena.
+void testConcurrent(int nthreads)
+{
+    std::cout << "Testing concurrent memory arena:\n";
+    std::cout << "This test allocates 4096 random sizes and fills them\n";
+    std::cout << "from each of " << nthreads << " threads at once, then ";
+    std::cout << "checks every\n";
+    std::cout << "allocation after all threads finish. Then it clears\n";
+    std::cout << "and repeats. This should print 0 corruptions, and 0\n";
+    std::cout << "block allocations in the second frame.\n";
+    std::cout.flush();
+
+    std::vector<std::vector<std::size_t>> sizes(nthreads);
+    for (std::vector<std::size_t>& thread_sizes : sizes) {
+        thread_sizes.resize(4096);
+        for (std::size_t& size : thread_sizes) {
+            size = 1 + pcg(1024);
+        }
+    }
+    nblock_allocs = 0;
+    ConcurrentMemoryArena arena(65536);
+    int ncorruptions = 0;
+    int nfirst_allocs = 0;
+    for (int frame = 0; frame < 2; frame++) {
+        std::vector<std::vector<void*>> ptrs(nthreads);
+        std::vector<std::thread> threads;
+        for (int thread = 0; thread < nthreads; thread++) {
+            threads.emplace_back([&, thread]() {
+                for (std::size_t size : sizes[thread]) {
+                    void* ptr = arena.allocate(size);
+                    fill(ptr, size, thread);
+                    ptrs[thread].push_back(ptr);
+                }
+            });
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        for (int thread = 0; thread < nthreads; thread++) {
+            for (std::size_t k = 0; k < sizes[thread].size(); k++) {
+                ncorruptions +=
+                    !check(ptrs[thread][k], sizes[thread][k], thread);
+            }
+        }
+        arena.clear();
+        if (frame == 0) {
+            nfirst_allocs = nblock_allocs;
+        }
+    }
+
+    // Print test result.
+    std::cout << "Result: " << ncorruptions << ", ";
+    std::cout << nblock_allocs - nfirst_allocs << " ";
+    std::cout << "(" << nfirst_allocs << " block allocations in first ";
+    std::cout << "frame)\n\n";
+    std::cout.flush();
+}
+
+int main(int argc, char** argv)
+{
+    int seed = 0;
+    int nthreads = 4;
+
+    // Option parser.
+    pre::option_parser opt_parser("[OPTIONS]");
+
+    // Specify seed.
+    opt_parser.on_option(
+    "-s", "--seed", 1,
+    [&](char** argv) {
+        try {
+            seed = std::stoi(argv[0]);
+        }
+        catch (const std::exception&) {
+            throw
+                std::runtime_error(
+                std::string("-s/--seed expects 1 integer ")
+                    .append("(can't parse ").append(argv[0])
+                    .append(")"));
+        }
+    })
+    << "Specify seed. By default, random.\n";
+
+    // Specify number of threads.
+    opt_parser.on_option(
+    "-n", "--nthreads", 1,
+    [&](char** argv) {
+        try {
+            nthreads = std::stoi(argv[0]);
+            if (!(nthreads >= 1 &&
+                  nthreads <= 64)) {
+                throw std::exception();
+            }
+        }
+        catch (const std::exception&) {
+            throw
+                std::runtime_error(
+                std::string("-n/--nthreads expects 1 integer in [1,64] ")
+                    .append("(can't parse ").append(argv[0])
+                    .append(")"));
+        }
+    })
+    << "Specify number of threads. By default, 4.\n";
+
+    // Display help.
+    opt_parser.on_option(
+    "-h", "--help", 0,
+    [&](char**) {
+        std::cout << opt_parser << std::endl;
+        std::exit(EXIT_SUCCESS);
+    })
+    << "Display this help and exit.\n";
+
+    try {
+        // Parse args.
+        opt_parser.parse(argc, argv);
+    }
+    catch (const std::exception& exception) {
+        std::cerr << "Unhandled exception!\n";
+        std::cerr << "exception.what(): " << exception.what() << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+
+    // Seed.
+    if (seed == 0) {
+        seed = std::random_device()();
+    }
+    std::cout << "seed = " << seed << "\n\n";
+    std::cout.flush();
+    pcg = pre::pcg32(seed);
+
+    // Markers.
+    testMarkers();
+
+    // Statistics.
+    testStats();
+
+    // Concurrent memory arena.
+    testConcurrent(nthreads);
+
+    return EXIT_SUCCESS;
+}
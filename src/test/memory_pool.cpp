@@ -0,0 +1,277 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <preform/option_parser.hpp>
+#include <preform/aligned_allocator.hpp>
+#include <preform/memory_pool.hpp>
+#include <preform/size_class_allocator.hpp>
+
+// Concurrent memory pool.
+typedef pre::concurrent_memory_pool<> ConcurrentMemoryPool;
+
+// Size class memory pool.
+typedef pre::size_class_memory_pool<> SizeClassMemoryPool;
+
+// Test concurrent memory pool.
+void testConcurrent(int nthreads)
+{
+    std::cout << "Testing concurrent memory pool:\n";
+    std::cout << "This test allocates and fills 16384 48-byte elements\n";
+    std::cout << "from each of " << nthreads << " threads at once, in 4 ";
+    std::cout << "rounds, where each\n";
+    std::cout << "thread deallocates half of its own elements and half\n";
+    std::cout << "of its neighbor's from the round before. This should\n";
+    std::cout << "print 0 corruptions, and 0 elements handed out twice.\n";
+    std::cout.flush();
+
+    constexpr std::size_t elem_size = 48;
+    constexpr std::size_t count = 16384;
+    ConcurrentMemoryPool pool(elem_size, 256, 32);
+    std::vector<std::vector<unsigned char*>> ptrs(nthreads);
+    int ncorruptions = 0;
+    int nduplicates = 0;
+    for (int round = 0; round < 4; round++) {
+        // Hand out lists to free, half own and half neighbor's.
+        std::vector<std::vector<unsigned char*>> to_free(nthreads);
+        std::vector<std::vector<unsigned char*>> to_keep(nthreads);
+        for (int thread = 0; thread < nthreads; thread++) {
+            std::vector<unsigned char*>& prev = ptrs[thread];
+            for (std::size_t k = 0; k < prev.size(); k++) {
+                int owner = k % 2 ? thread : (thread + 1) % nthreads;
+                if (k % 4 < 2) {
+                    to_free[owner].push_back(prev[k]);
+                }
+                else {
+                    to_keep[thread].push_back(prev[k]);
+                }
+            }
+        }
+        std::vector<std::thread> threads;
+        for (int thread = 0; thread < nthreads; thread++) {
+            threads.emplace_back([&, thread]() {
+                for (unsigned char* ptr : to_free[thread]) {
+                    pool.deallocate(ptr);
+                }
+                std::vector<unsigned char*>& own = to_keep[thread];
+                for (std::size_t k = 0; k < count; k++) {
+                    unsigned char* ptr =
+                        static_cast<unsigned char*>(pool.allocate());
+                    std::memset(ptr, thread + 16 * round, elem_size);
+                    own.push_back(ptr);
+                }
+            });
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+
+        // Check new elements, and every element live at once.
+        std::vector<unsigned char*> live;
+        for (int thread = 0; thread < nthreads; thread++) {
+            std::vector<unsigned char*>& own = to_keep[thread];
+            for (std::size_t k = own.size() - count; k < own.size(); k++) {
+                for (std::size_t b = 0; b < elem_size; b++) {
+                    if (own[k][b] != thread + 16 * round) {
+                        ncorruptions++;
+                        break;
+                    }
+                }
+            }
+            live.insert(live.end(), own.begin(), own.end());
+            ptrs[thread].swap(own);
+        }
+        std::sort(live.begin(), live.end());
+        for (std::size_t k = 1; k < live.size(); k++) {
+            nduplicates += live[k - 1] + elem_size > live[k];
+        }
+    }
+
+    // Print test result.
+    std::cout << "Result: " << ncorruptions << ", " << nduplicates << "\n\n";
+    std::cout.flush();
+}
+
+// Test size classes.
+void testSizeClasses(int nthreads)
+{
+    std::cout << "Testing size classes:\n";
+    std::cout << "This test maps every size in [1,4096] to its size\n";
+    std::cout << "class, then fills std::map and std::vector containers\n";
+    std::cout << "with size_class_allocator from " << nthreads << " threads ";
+    std::cout << "at once.\n";
+    std::cout << "This should print 0 sizes in the wrong class, at most\n";
+    std::cout << "25% waste above 128 bytes, and 0 container mismatches.\n";
+    std::cout.flush();
+
+    int nwrong = 0;
+    double max_waste = 0;
+    for (std::size_t index = 0;
+                     index < SizeClassMemoryPool::class_count; index++) {
+        nwrong +=
+            SizeClassMemoryPool::class_index(
+            SizeClassMemoryPool::class_size(index)) != index;
+    }
+    nwrong += SizeClassMemoryPool::class_size(
+              SizeClassMemoryPool::class_count - 1) !=
+              SizeClassMemoryPool::max_class_size;
+    for (std::size_t size = 1;
+                     size <= SizeClassMemoryPool::max_class_size; size++) {
+        std::size_t index = SizeClassMemoryPool::class_index(size);
+        std::size_t class_size = SizeClassMemoryPool::class_size(index);
+        nwrong +=
+            index >= SizeClassMemoryPool::class_count ||
+            class_size < size ||
+            (index > 0 && SizeClassMemoryPool::class_size(index - 1) >= size);
+        if (size > 128) {
+            max_waste = std::max(max_waste,
+                double(class_size - size) / double(class_size));
+        }
+    }
+
+    // Containers.
+    std::atomic<int> nmismatches(0);
+    std::vector<std::thread> threads;
+    for (int thread = 0; thread < nthreads; thread++) {
+        threads.emplace_back([&, thread]() {
+            std::map<int, int, std::less<int>,
+                pre::size_class_allocator<std::pair<const int, int>>> map;
+            std::vector<std::vector<int, pre::size_class_allocator<int>>>
+                vectors(64);
+            for (int k = 0; k < 8192; k++) {
+                map[(k * 7919) % 8192] = k + thread;
+                vectors[k % 64].push_back(k + thread);
+            }
+            for (int k = 0; k < 8192; k++) {
+                if (map[(k * 7919) % 8192] != k + thread ||
+                    vectors[k % 64][k / 64] != k + thread) {
+                    nmismatches++;
+                }
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    // Print test result.
+    std::cout << "Result: " << nwrong << ", ";
+    std::cout << (max_waste <= 0.25) << " ";
+    std::cout << "(" << max_waste * 100 << "% at most), ";
+    std::cout << nmismatches << "\n\n";
+    std::cout.flush();
+}
+
+// Test huge pages.
+void testHugePages()
+{
+    std::cout << "Testing huge pages:\n";
+    std::cout << "This test fills 3 MiB vectors with aligned_allocator\n";
+    std::cout << "in each huge page mode, preferring NUMA node 0, then\n";
+    std::cout << "asks for alignment beyond the huge page size. This\n";
+    std::cout << "should print 0 misaligned vectors, 0 mismatches, and 1\n";
+    std::cout << "rejected alignment.\n";
+    std::cout.flush();
+
+    int nmisaligned = 0;
+    int nmismatches = 0;
+    pre::huge_page_mode modes[3] = {
+        pre::huge_page_mode::none,
+        pre::huge_page_mode::transparent,
+        pre::huge_page_mode::explicit_
+    };
+    for (pre::huge_page_mode mode : modes) {
+        std::size_t alignment = 64;
+        std::size_t expect_alignment =
+            mode == pre::huge_page_mode::none ? 64 : pre::huge_page_size;
+        std::vector<std::uint32_t, pre::aligned_allocator<std::uint32_t>>
+            values(3 << 18, 0,
+                pre::aligned_allocator<std::uint32_t>(alignment, mode, 0));
+        nmisaligned +=
+            pre::pointer_to_address(values.data()) % expect_alignment != 0;
+        for (std::size_t k = 0; k < values.size(); k++) {
+            values[k] = std::uint32_t(k * 2654435761u);
+        }
+        for (std::size_t k = 0; k < values.size(); k++) {
+            nmismatches += values[k] != std::uint32_t(k * 2654435761u);
+        }
+    }
+    int nrejected = 0;
+    try {
+        pre::aligned_allocator<char> alloc(
+                pre::huge_page_size * 2,
+                pre::huge_page_mode::transparent);
+    }
+    catch (const std::invalid_argument&) {
+        nrejected++;
+    }
+
+    // Print test result.
+    std::cout << "Result: " << nmisaligned << ", " << nmismatches << ", ";
+    std::cout << nrejected << "\n\n";
+    std::cout.flush();
+}
+
+int main(int argc, char** argv)
+{
+    int nthreads = 4;
+
+    // Option parser.
+    pre::option_parser opt_parser("[OPTIONS]");
+
+    // Specify number of threads.
+    opt_parser.on_option(
+    "-n", "--nthreads", 1,
+    [&](char** argv) {
+        try {
+            nthreads = std::stoi(argv[0]);
+            if (!(nthreads >= 1 &&
+                  nthreads <= 64)) {
+                throw std::exception();
+            }
+        }
+        catch (const std::exception&) {
+            throw
+                std::runtime_error(
+                std::string("-n/--nthreads expects 1 integer in [1,64] ")
+                    .append("(can't parse ").append(argv[0])
+                    .append(")"));
+        }
+    })
+    << "Specify number of threads. By default, 4.\n";
+
+    // Display help.
+    opt_parser.on_option(
+    "-h", "--help", 0,
+    [&](char**) {
+        std::cout << opt_parser << std::endl;
+        std::exit(EXIT_SUCCESS);
+    })
+    << "Display this help and exit.\n";
+
+    try {
+        // Parse args.
+        opt_parser.parse(argc, argv);
+    }
+    catch (const std::exception& exception) {
+        std::cerr << "Unhandled exception!\n";
+        std::cerr << "exception.what(): " << exception.what() << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+
+    // Concurrent memory pool.
+    testConcurrent(nthreads);
+
+    // Size classes.
+    testSizeClasses(nthreads);
+
+    // Huge pages.
+    testHugePages();
+
+    return EXIT_SUCCESS;
+}
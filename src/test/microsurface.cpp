@@ -47,6 +47,13 @@ typedef pre::microsurface_dielectric_bsdf<
         pre::microsurface_uniform_height>
             DielectricBeckmann;
 
+// Dielectric with fast Beckmann slope distribution.
+typedef pre::microsurface_dielectric_bsdf<
+        Float,
+        pre::microsurface_beckmann_slope_fast,
+        pre::microsurface_uniform_height>
+            DielectricBeckmannFast;
+
 // Neumaier sum.
 typedef pre::neumaier_sum<Float> NeumaierSum;
 
@@ -114,6 +121,70 @@ void testFullSphere(const char* name, const Surf& surf)
     delete[] u;
 }
 
+// Test full-sphere scattering, as a wavefront.
+template <typename Surf>
+void testFullSphereMany(const char* name, const Surf& surf)
+{
+    Vec2i n = {512, 512};
+    std::cout << "Testing full-sphere scattering for ";
+    std::cout << name << "::fs_many():\n";
+    std::cout <<
+        "This test uses Monte Carlo integration to estimate the full-sphere\n"
+        "scattering integral, which is equal to 1 for an arbitrary viewing\n"
+        "direction given a non-absorbing BSDF.\n";
+    std::cout.flush();
+
+    // Stratify samples.
+    Vec2f* u = new Vec2f[n.prod()];
+    pre::stratify(u, n, pcg);
+
+    // Generate random viewing direction.
+    Vec3f wo =
+    Vec3f::uniform_sphere_pdf_sample(generateCanonical2());
+
+    // Directions.
+    Vec3f* wos = new Vec3f[n.prod()];
+    Vec3f* wis = new Vec3f[n.prod()];
+    Float* wi_pdfs = new Float[n.prod()];
+    for (int k = 0; k < n.prod(); k++) {
+        wos[k] = wo;
+        wis[k] = Vec3f::cosine_hemisphere_pdf_sample(u[k]);
+        wi_pdfs[k] = Vec3f::cosine_hemisphere_pdf(wis[k][2]) * Float(0.5);
+        wis[k] = pcg(2) == 0 ? +wis[k] : -wis[k];
+    }
+
+    // Evaluate all random walks as a wavefront.
+    Float* fs = new Float[n.prod()];
+    surf.fs_many(pcg, wos, wis, n.prod(), fs);
+
+    // Monte Carlo integration.
+    NeumaierSum f = 0;
+    for (int k = 0; k < n.prod(); k++) {
+
+        // Integrand.
+        Float wi_pdf = wi_pdfs[k];
+        if (wi_pdf > 0) {
+            Float fk = fs[k];
+            fk /= wi_pdf;
+            fk /= n.prod();
+            if (pre::isinf(fk)) {
+                continue;
+            }
+            f += fk;
+        }
+    }
+
+    std::cout << "Result: " << Float(f) << " (should be close to 1)\n";
+    std::cout << "\n\n";
+    std::cout.flush();
+
+    delete[] u;
+    delete[] wos;
+    delete[] wis;
+    delete[] wi_pdfs;
+    delete[] fs;
+}
+
 // Test multi-scatter phase function normalization.
 template <typename Surf, typename Pred>
 void testPhase(const char* name, const Surf& surf, Pred&& pred)
@@ -236,6 +307,26 @@ int main(int argc, char** argv)
     testFullSphere(
         "DielectricBeckmann",
          DielectricBeckmann(1, 1, eta0 / eta1, alpha));
+    testFullSphere(
+        "DielectricBeckmannFast",
+         DielectricBeckmannFast(1, 1, eta0 / eta1, alpha));
+
+    // Test full-sphere scattering, as a wavefront.
+    testFullSphereMany(
+        "LambertianTrowbridgeReitz",
+         LambertianTrowbridgeReitz(0.7, 0.3, alpha));
+    testFullSphereMany(
+        "LambertianBeckmann",
+         LambertianBeckmann(0.2, 0.8, alpha));
+    testFullSphereMany(
+        "DielectricTrowbridgeReitz",
+         DielectricTrowbridgeReitz(1, 1, eta0 / eta1, alpha));
+    testFullSphereMany(
+        "DielectricBeckmann",
+         DielectricBeckmann(1, 1, eta0 / eta1, alpha));
+    testFullSphereMany(
+        "DielectricBeckmannFast",
+         DielectricBeckmannFast(1, 1, eta0 / eta1, alpha));
 
     // Test multi-scatter phase function normalization.
     {
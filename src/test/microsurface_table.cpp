@@ -0,0 +1,293 @@
+#include <complex>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <preform/random.hpp>
+#include <preform/multi.hpp>
+#include <preform/multi_math.hpp>
+#include <preform/multi_random.hpp>
+#include <preform/option_parser.hpp>
+#include <preform/microsurface.hpp>
+#include <preform/microsurface_table.hpp>
+
+// Float type.
+typedef double Float;
+
+// 2-dimensional vector type.
+typedef pre::vec2<Float> Vec2f;
+
+// 3-dimensional vector type.
+typedef pre::vec3<Float> Vec3f;
+
+// Microsurface table.
+typedef pre::microsurface_table<Float> MicrosurfaceTable;
+
+// Conductor with Trowbridge-Reitz slope distribution.
+typedef pre::microsurface_conductive_brdf<
+        Float,
+        pre::microsurface_trowbridge_reitz_slope,
+        pre::microsurface_uniform_height>
+            ConductiveTrowbridgeReitz;
+
+// Permuted congruential generator.
+pre::pcg32 pcg;
+
+// Table sizes.
+const MicrosurfaceTable::sizes_type sizes = {3, 2, 8, 8, 5};
+
+// Roughness range.
+const Vec2f alpha_range = {Float(0.1), Float(0.7)};
+
+// Material parameter range.
+const Vec2f eta_range = {Float(1.2), Float(2.0)};
+
+// Relative azimuth, as in the table.
+Float relativeAzimuth(const Vec3f& wo, const Vec3f& wi)
+{
+    return pre::abs(pre::atan2(
+                    wo[0] * wi[1] - wo[1] * wi[0],
+                    wo[0] * wi[0] + wo[1] * wi[1]));
+}
+
+// Surface with deterministic BSDF, where the BSDF times the absolute
+// incident cosine is multilinear in the table coordinates, so that
+// table interpolation is exact between nodes.
+struct SmoothSurface
+{
+    Float alpha;
+    Float eta;
+
+    Float fs(const Vec3f& wo, const Vec3f& wi) const
+    {
+        return (1 + alpha) * (2 + eta) * (3 + wo[2]) * (3 + wi[2]) *
+               (2 + relativeAzimuth(wo, wi)) / pre::abs(wi[2]);
+    }
+
+    template <typename Tgen>
+    Float fs(Tgen&, const Vec3f& wo, const Vec3f& wi, unsigned, int) const
+    {
+        return fs(wo, wi);
+    }
+};
+
+// Generate direction with cosine between the innermost and outermost
+// cosine nodes of a random hemisphere.
+Vec3f generateDirection(int n)
+{
+    Float cos_theta = 1 / Float(n) +
+        (1 - 2 / Float(n)) * pre::generate_canonical<Float>(pcg);
+    if (pcg(2)) {
+        cos_theta = -cos_theta;
+    }
+    Float sin_theta = pre::sqrt(1 - cos_theta * cos_theta);
+    Float phi = 2 * pre::numeric_constants<Float>::M_pi() *
+                pre::generate_canonical<Float>(pcg);
+    return {sin_theta * pre::cos(phi), sin_theta * pre::sin(phi), cos_theta};
+}
+
+// Generate in range.
+Float generateIn(const Vec2f& range)
+{
+    return range[0] + (range[1] - range[0]) *
+                      pre::generate_canonical<Float>(pcg);
+}
+
+// Test lookups.
+void testLookup(const MicrosurfaceTable& table)
+{
+    std::cout << "Testing lookups:\n";
+    std::cout << "This test tabulates a surface whose BSDF times the\n";
+    std::cout << "absolute incident cosine is multilinear in the table\n";
+    std::cout << "coordinates, and compares 4096 random lookups inside\n";
+    std::cout << "the node ranges against direct evaluation. This should\n";
+    std::cout << "print 0 mismatches beyond a relative error of 1e-6.\n";
+    std::cout.flush();
+
+    int nmismatches = 0;
+    Float max_error = 0;
+    for (int count = 0; count < 4096; count++) {
+        Vec3f wo = generateDirection(sizes[2]);
+        Vec3f wi = generateDirection(sizes[3]);
+        Float alpha = generateIn(alpha_range);
+        Float eta = generateIn(eta_range);
+        Float expect = SmoothSurface{alpha, eta}.fs(wo, wi);
+        Float error =
+            pre::abs(table.fs(wo, wi, alpha, eta) - expect) / expect;
+        nmismatches += !(error <= Float(1e-6));
+        max_error = pre::fmax(max_error, error);
+    }
+
+    // Print test result.
+    std::cout << "Result: " << nmismatches << " ";
+    std::cout << "(" << max_error << ")\n\n";
+    std::cout.flush();
+}
+
+// Test serialization.
+void testSerialization(const MicrosurfaceTable& table)
+{
+    std::cout << "Testing serialization:\n";
+    std::cout << "This test saves and loads the table, and compares the\n";
+    std::cout << "parameters and 4096 random lookups. It then loads\n";
+    std::cout << "garbage, a truncated table, a table with a size out of\n";
+    std::cout << "bounds, and a table with too many nodes. This should\n";
+    std::cout << "print 0 mismatches, and 4 rejected tables.\n";
+    std::cout.flush();
+
+    std::stringstream stream;
+    table.save(stream);
+    std::string bytes = stream.str();
+    MicrosurfaceTable loaded;
+    loaded.load(stream);
+    int nmismatches =
+        !(loaded.sizes() == table.sizes()).all() ||
+        !(loaded.alpha_range() == table.alpha_range()).all() ||
+        !(loaded.eta_range() == table.eta_range()).all() ||
+        loaded.kmin() != table.kmin();
+    for (int count = 0; count < 4096; count++) {
+        Vec3f wo = Vec3f::uniform_sphere_pdf_sample(
+                   pre::generate_canonical<Float, 2>(pcg));
+        Vec3f wi = Vec3f::uniform_sphere_pdf_sample(
+                   pre::generate_canonical<Float, 2>(pcg));
+        Float alpha = generateIn({0, 1});
+        Float eta = generateIn({1, 3});
+        nmismatches +=
+            loaded.fs(wo, wi, alpha, eta) != table.fs(wo, wi, alpha, eta);
+    }
+
+    // Overwrite sizes, after 8 bytes of magic number, and 8 bytes
+    // of version and scattering order minimum.
+    auto withSizes = [&](std::int32_t size0, std::int32_t size) {
+        std::int32_t head[5] = {size0, size, size, size, size};
+        std::string res = bytes;
+        std::memcpy(&res[16], &head[0], sizeof(head));
+        return res;
+    };
+    int nrejected = 0;
+    for (std::string garbage : {
+            std::string("garbage"),
+            bytes.substr(0, bytes.size() / 2),
+            withSizes(1 << 20, 2),
+            withSizes(4096, 4096)}) {
+        try {
+            std::stringstream bad(garbage);
+            loaded.load(bad);
+        }
+        catch (const std::runtime_error&) {
+            nrejected++;
+        }
+    }
+
+    // Print test result.
+    std::cout << "Result: " << nmismatches << ", " << nrejected << "\n\n";
+    std::cout.flush();
+}
+
+// Test random walks.
+void testRandomWalks()
+{
+    std::cout << "Testing random walks:\n";
+    std::cout << "This test tabulates a conductor by random walks, and\n";
+    std::cout << "checks that 1024 random lookups are finite and\n";
+    std::cout << "non-negative. This should print 0 bad values.\n";
+    std::cout.flush();
+
+    MicrosurfaceTable table;
+    table.init(
+        pcg,
+        [](Float alpha, Float eta) {
+            return ConductiveTrowbridgeReitz(
+                   std::complex<Float>(eta, 3), Vec2f(alpha));
+        },
+        {2, 1, 4, 4, 3}, alpha_range, eta_range, 32);
+    int nbad = 0;
+    for (int count = 0; count < 1024; count++) {
+        Vec3f wo = Vec3f::uniform_sphere_pdf_sample(
+                   pre::generate_canonical<Float, 2>(pcg));
+        Vec3f wi = Vec3f::uniform_sphere_pdf_sample(
+                   pre::generate_canonical<Float, 2>(pcg));
+        Float value =
+            table.fs(wo, wi, generateIn(alpha_range), generateIn(eta_range));
+        nbad += !(value >= 0 && pre::isfinite(value));
+    }
+
+    // Print test result.
+    std::cout << "Result: " << nbad << "\n\n";
+    std::cout.flush();
+}
+
+int main(int argc, char** argv)
+{
+    int seed = 0;
+
+    // Option parser.
+    pre::option_parser opt_parser("[OPTIONS]");
+
+    // Specify seed.
+    opt_parser.on_option(
+    "-s", "--seed", 1,
+    [&](char** argv) {
+        try {
+            seed = std::stoi(argv[0]);
+        }
+        catch (const std::exception&) {
+            throw
+                std::runtime_error(
+                std::string("-s/--seed expects 1 integer ")
+                    .append("(can't parse ").append(argv[0])
+                    .append(")"));
+        }
+    })
+    << "Specify seed. By default, random.\n";
+
+    // Display help.
+    opt_parser.on_option(
+    "-h", "--help", 0,
+    [&](char**) {
+        std::cout << opt_parser << std::endl;
+        std::exit(EXIT_SUCCESS);
+    })
+    << "Display this help and exit.\n";
+
+    try {
+        // Parse args.
+        opt_parser.parse(argc, argv);
+    }
+    catch (const std::exception& exception) {
+        std::cerr << "Unhandled exception!\n";
+        std::cerr << "exception.what(): " << exception.what() << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+
+    // Seed.
+    if (seed == 0) {
+        seed = std::random_device()();
+    }
+    std::cout << "seed = " << seed << "\n\n";
+    std::cout.flush();
+    pcg = pre::pcg32(seed);
+
+    // Table of smooth surface.
+    MicrosurfaceTable table;
+    table.init(
+        pcg,
+        [](Float alpha, Float eta) {
+            return SmoothSurface{alpha, eta};
+        },
+        sizes, alpha_range, eta_range, 1);
+
+    // Lookups.
+    testLookup(table);
+
+    // Serialization.
+    testSerialization(table);
+
+    // Random walks.
+    testRandomWalks();
+
+    return EXIT_SUCCESS;
+}
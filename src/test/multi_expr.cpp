@@ -0,0 +1,251 @@
+#include <iostream>
+#include <random>
+#include <type_traits>
+#include <utility>
+#include <preform/random.hpp>
+#include <preform/option_parser.hpp>
+#include <preform/multi.hpp>
+#include <preform/multi_math.hpp>
+#include <preform/multi_expr.hpp>
+
+// Float type.
+typedef double Float;
+
+// 4x3-dimensional matrix type.
+typedef pre::multi<Float, 4, 3> Mat4x3f;
+
+// 4x3-dimensional integer matrix type.
+typedef pre::multi<int, 4, 3> Mat4x3i;
+
+// 4x3-dimensional boolean matrix type.
+typedef pre::multi<bool, 4, 3> Mat4x3b;
+
+// Permuted congruential generator.
+pre::pcg32 pcg;
+
+// Generate random matrix in [-1,1)^(4x3).
+Mat4x3f generateMat4x3f()
+{
+    Mat4x3f res;
+    for (auto& row : res)
+    for (Float& entry : row) {
+        entry = pre::generate_canonical<Float>(pcg) * 2 - 1;
+    }
+    return res;
+}
+
+// Generate random integer matrix in [1,256]^(4x3).
+Mat4x3i generateMat4x3i()
+{
+    Mat4x3i res;
+    for (auto& row : res)
+    for (int& entry : row) {
+        entry = 1 + int(pcg(256));
+    }
+    return res;
+}
+
+// Are matrices equal, up to rounding? The lazy loops may contract
+// multiplies and adds into fused multiply-adds where the eager
+// operators do not.
+bool isClose(const Mat4x3f& res, const Mat4x3f& expect)
+{
+    return !(pre::abs(res - expect) >
+             Float(1e-14) * (pre::abs(expect) + 1)).any();
+}
+
+// Can wrap in lazy()?
+template <typename T, typename = void>
+struct can_lazy : std::false_type
+{
+};
+
+template <typename T>
+struct can_lazy<
+        T, std::void_t<decltype(pre::lazy(std::declval<T>()))>> :
+        std::true_type
+{
+};
+
+// Can multiply expression by argument?
+template <typename T, typename = void>
+struct can_multiply_expr : std::false_type
+{
+};
+
+template <typename T>
+struct can_multiply_expr<
+        T, std::void_t<decltype(
+            pre::lazy(std::declval<const Mat4x3f&>()) *
+            std::declval<T>())>> : std::true_type
+{
+};
+
+// Test arithmetic.
+void testArithmetic()
+{
+    std::cout << "Testing arithmetic:\n";
+    std::cout << "This test evaluates 1024 random lazy expressions of\n";
+    std::cout << "4x3 matrices, with unary, binary, and comparison\n";
+    std::cout << "operators, broadcast entries, lazy_apply(), and compound\n";
+    std::cout << "assignment, including assignment to an operand, and\n";
+    std::cout << "compares against eager evaluation, exactly for integers\n";
+    std::cout << "and booleans, and up to rounding for floats. This should\n";
+    std::cout << "print 0 mismatches for each.\n";
+    std::cout.flush();
+
+    int nmismatches[4] = {};
+    for (int count = 0; count < 1024; count++) {
+        Mat4x3f a = generateMat4x3f();
+        Mat4x3f b = generateMat4x3f();
+        Mat4x3f c = generateMat4x3f();
+        Mat4x3f d = generateMat4x3f();
+        Float s = pre::generate_canonical<Float>(pcg);
+
+        // Floating point operators.
+        Mat4x3f res =
+            pre::lazy(a) * b + pre::lazy(c) * d - s / (pre::lazy(a) + 2);
+        Mat4x3f expect = a * b + c * d - s / (a + 2);
+        nmismatches[0] += !isClose(res, expect);
+        res = -pre::lazy(a) + (+pre::lazy(b)) * (pre::lazy(c) - d) / s;
+        expect = -a + (+b) * (c - d) / s;
+        nmismatches[0] += !isClose(res, expect);
+        res = pre::eval(pre::lazy(a) * s - b);
+        expect = a * s - b;
+        nmismatches[0] += !isClose(res, expect);
+
+        // Integer operators.
+        Mat4x3i i = generateMat4x3i();
+        Mat4x3i j = generateMat4x3i();
+        Mat4x3i ires =
+            (pre::lazy(i) % j) + (pre::lazy(i) & j) - (pre::lazy(i) | j) +
+            (pre::lazy(i) ^ j) + (pre::lazy(i) << 2) + (pre::lazy(j) >> 1) +
+            ~pre::lazy(i);
+        Mat4x3i iexpect =
+            (i % j) + (i & j) - (i | j) +
+            (i ^ j) + (i << 2) + (j >> 1) + ~i;
+        nmismatches[1] += !(ires == iexpect).all();
+
+        // Comparison operators.
+        Mat4x3b bres =
+            ((pre::lazy(a) < b) && (pre::lazy(c) >= d)) ||
+            ((pre::lazy(a) == a) && !(pre::lazy(b) > s)) ||
+            ((pre::lazy(c) <= d) && (pre::lazy(c) != s));
+        Mat4x3b bexpect =
+            ((a < b) && (c >= d)) ||
+            ((a == a) && !(b > s)) ||
+            ((c <= d) && (c != s));
+        nmismatches[2] += !(bres == bexpect).all();
+
+        // Function application.
+        res = pre::lazy_apply([](Float x, Float y, Float z) {
+            return pre::fma(x, y, z);
+        }, a, pre::lazy(b) * 2, s);
+        expect = pre::fma(a, b * 2, Mat4x3f(s));
+        nmismatches[0] += !isClose(res, expect);
+
+        // Compound assignment.
+        res = a;
+        res += pre::lazy(b) * c;
+        res -= pre::lazy(d) / 4;
+        res *= pre::lazy(c) + s;
+        res /= pre::lazy(d) + 3;
+        expect = a;
+        expect += b * c;
+        expect -= d / 4;
+        expect *= c + s;
+        expect /= d + 3;
+        nmismatches[3] += !isClose(res, expect);
+
+        // Assignment to an operand, safe as entry-wise.
+        res = a;
+        res = pre::lazy(res) * b + pre::lazy(res) * res;
+        expect = a * b + a * a;
+        nmismatches[3] += !isClose(res, expect);
+    }
+
+    // Print test result.
+    std::cout << "Result: " << nmismatches[0] << ", " << nmismatches[1];
+    std::cout << ", " << nmismatches[2] << ", " << nmismatches[3] << "\n\n";
+    std::cout.flush();
+}
+
+// Test temporaries.
+void testTemporaries()
+{
+    std::cout << "Testing temporaries:\n";
+    std::cout << "This test checks at compile time that lazy() and the\n";
+    std::cout << "operators accept arrays and reject temporary arrays,\n";
+    std::cout << "which expressions would reference after destruction.\n";
+    std::cout << "This should print 1 1 for arrays, and 0 0 for\n";
+    std::cout << "temporaries.\n";
+    std::cout.flush();
+
+    // Print test result.
+    std::cout << "Result: ";
+    std::cout << can_lazy<const Mat4x3f&>::value << " ";
+    std::cout << can_multiply_expr<const Mat4x3f&>::value << ", ";
+    std::cout << can_lazy<Mat4x3f&&>::value << " ";
+    std::cout << can_multiply_expr<Mat4x3f&&>::value << "\n\n";
+    std::cout.flush();
+}
+
+int main(int argc, char** argv)
+{
+    int seed = 0;
+
+    // Option parser.
+    pre::option_parser opt_parser("[OPTIONS]");
+
+    // Specify seed.
+    opt_parser.on_option(
+    "-s", "--seed", 1,
+    [&](char** argv) {
+        try {
+            seed = std::stoi(argv[0]);
+        }
+        catch (const std::exception&) {
+            throw
+                std::runtime_error(
+                std::string("-s/--seed expects 1 integer ")
+                    .append("(can't parse ").append(argv[0])
+                    .append(")"));
+        }
+    })
+    << "Specify seed. By default, random.\n";
+
+    // Display help.
+    opt_parser.on_option(
+    "-h", "--help", 0,
+    [&](char**) {
+        std::cout << opt_parser << std::endl;
+        std::exit(EXIT_SUCCESS);
+    })
+    << "Display this help and exit.\n";
+
+    try {
+        // Parse args.
+        opt_parser.parse(argc, argv);
+    }
+    catch (const std::exception& exception) {
+        std::cerr << "Unhandled exception!\n";
+        std::cerr << "exception.what(): " << exception.what() << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+
+    // Seed.
+    if (seed == 0) {
+        seed = std::random_device()();
+    }
+    std::cout << "seed = " << seed << "\n\n";
+    std::cout.flush();
+    pcg = pre::pcg32(seed);
+
+    // Arithmetic.
+    testArithmetic();
+
+    // Temporaries.
+    testTemporaries();
+
+    return EXIT_SUCCESS;
+}
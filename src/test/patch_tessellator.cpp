@@ -0,0 +1,195 @@
+#include <iostream>
+#include <map>
+#include <random>
+#include <utility>
+#include <preform/random.hpp>
+#include <preform/option_parser.hpp>
+#include <preform/multi.hpp>
+#include <preform/multi_math.hpp>
+#include <preform/bspline.hpp>
+#include <preform/patch_tessellator.hpp>
+
+// Float type.
+typedef double Float;
+
+// 2-dimensional vector type.
+typedef pre::vec2<Float> Vec2f;
+
+// 3-dimensional vector type.
+typedef pre::vec3<Float> Vec3f;
+
+// B-spline patch.
+typedef pre::bspline_patch<Float, 3> BsplinePatch;
+
+// NURBS patch.
+typedef pre::nurbs_patch<Float, 3> NurbsPatch;
+
+// Patch tessellator.
+typedef pre::patch_tessellator<Float, 3> PatchTessellator;
+
+// Permuted congruential generator.
+pre::pcg32 pcg;
+
+// Error tolerance.
+const Float tol = Float(0.01);
+
+// Generate patch, as a height field over a grid of control points,
+// with random weights in [1/e, e] if rational.
+template <typename Patch>
+Patch generatePatch()
+{
+    Patch patch({6, 5}, {3, 2});
+    patch.basis0().set_knots_open();
+    patch.basis1().set_knots_open();
+    Vec3f* p = patch.control_points_data();
+    for (int i = 0; i < 6; i++)
+    for (int j = 0; j < 5; j++) {
+        p[i * 5 + j] = {
+            Float(i),
+            Float(j),
+            4 * pre::generate_canonical<Float>(pcg) - 2
+        };
+    }
+    if constexpr (std::is_same<Patch, NurbsPatch>::value) {
+        Float* w = patch.weights_data();
+        for (int k = 0; k < 30; k++) {
+            w[k] = pre::exp(2 * pre::generate_canonical<Float>(pcg) - 1);
+        }
+    }
+    return patch;
+}
+
+// Test tessellation.
+template <typename Patch>
+void testTessellation(const char* name)
+{
+    std::cout << "Testing tessellation of " << name << ":\n";
+    std::cout << "This test tessellates 8 random patches, and checks that\n";
+    std::cout << "every edge is shared by two triangles with opposite\n";
+    std::cout << "orientation unless on the domain boundary, that\n";
+    std::cout << "triangles wind counterclockwise in the parameter domain,\n";
+    std::cout << "and measures the distance from each triangle to the\n";
+    std::cout << "surface at 45 barycentric points. This should print 0\n";
+    std::cout << "open edges, 0 inverted triangles, and 1 for errors below\n";
+    std::cout << "1.5 times the tolerance.\n";
+    std::cout.flush();
+
+    int nopen = 0;
+    int ninverted = 0;
+    Float max_error = 0;
+    for (int count = 0; count < 8; count++) {
+        Patch patch = generatePatch<Patch>();
+        PatchTessellator tessellator;
+        tessellator.init(patch, tol, 1024);
+        auto params = tessellator.params();
+        auto points = tessellator.points();
+
+        // Directed edges.
+        std::map<std::pair<int, int>, int> edges;
+        for (auto triangle : tessellator.triangles()) {
+            for (int k = 0; k < 3; k++) {
+                edges[{triangle[k], triangle[(k + 1) % 3]}]++;
+            }
+            Vec2f t0 = params[triangle[0]];
+            Vec2f t1 = params[triangle[1]];
+            Vec2f t2 = params[triangle[2]];
+            Vec2f e1 = t1 - t0;
+            Vec2f e2 = t2 - t0;
+            ninverted += !(e1[0] * e2[1] - e1[1] * e2[0] > 0);
+
+            // Error.
+            for (int i = 0; i <= 8; i++)
+            for (int j = 0; i + j <= 8; j++) {
+                Float b1 = Float(i) / 8;
+                Float b2 = Float(j) / 8;
+                Float b0 = 1 - b1 - b2;
+                Vec3f chord =
+                    b0 * points[triangle[0]] +
+                    b1 * points[triangle[1]] +
+                    b2 * points[triangle[2]];
+                Vec3f surface = patch.evaluate(b0 * t0 + b1 * t1 + b2 * t2);
+                max_error =
+                    pre::fmax(max_error, pre::length(surface - chord) / tol);
+            }
+        }
+        for (auto& [edge, num] : edges) {
+            if (num != 1) {
+                nopen++;
+            }
+            else if (!edges.count({edge.second, edge.first})) {
+                Vec2f t0 = params[edge.first];
+                Vec2f t1 = params[edge.second];
+                bool on_boundary =
+                    (t0[0] == t1[0] && (t0[0] == 0 || t0[0] == 1)) ||
+                    (t0[1] == t1[1] && (t0[1] == 0 || t0[1] == 1));
+                nopen += !on_boundary;
+            }
+        }
+    }
+
+    // Print test result.
+    std::cout << "Result: " << nopen << ", " << ninverted << ", ";
+    std::cout << (max_error < Float(1.5)) << " ";
+    std::cout << "(" << max_error << " times tolerance)\n\n";
+    std::cout.flush();
+}
+
+int main(int argc, char** argv)
+{
+    int seed = 0;
+
+    // Option parser.
+    pre::option_parser opt_parser("[OPTIONS]");
+
+    // Specify seed.
+    opt_parser.on_option(
+    "-s", "--seed", 1,
+    [&](char** argv) {
+        try {
+            seed = std::stoi(argv[0]);
+        }
+        catch (const std::exception&) {
+            throw
+                std::runtime_error(
+                std::string("-s/--seed expects 1 integer ")
+                    .append("(can't parse ").append(argv[0])
+                    .append(")"));
+        }
+    })
+    << "Specify seed. By default, random.\n";
+
+    // Display help.
+    opt_parser.on_option(
+    "-h", "--help", 0,
+    [&](char**) {
+        std::cout << opt_parser << std::endl;
+        std::exit(EXIT_SUCCESS);
+    })
+    << "Display this help and exit.\n";
+
+    try {
+        // Parse args.
+        opt_parser.parse(argc, argv);
+    }
+    catch (const std::exception& exception) {
+        std::cerr << "Unhandled exception!\n";
+        std::cerr << "exception.what(): " << exception.what() << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+
+    // Seed.
+    if (seed == 0) {
+        seed = std::random_device()();
+    }
+    std::cout << "seed = " << seed << "\n\n";
+    std::cout.flush();
+    pcg = pre::pcg32(seed);
+
+    // B-spline patches.
+    testTessellation<BsplinePatch>("bspline_patch");
+
+    // NURBS patches.
+    testTessellation<NurbsPatch>("nurbs_patch");
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,244 @@
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include <preform/random.hpp>
+#include <preform/multi_random.hpp>
+#include <preform/option_parser.hpp>
+#include <preform/piecewise_constant_distribution2.hpp>
+
+// Float type.
+typedef double Float;
+
+// 2-dimensional vector.
+typedef pre::vec2<Float> Vec2f;
+
+// 3-dimensional vector.
+typedef pre::vec3<Float> Vec3f;
+
+// Piecewise constant 2-dimensional distribution.
+typedef pre::piecewise_constant_distribution2<Float>
+        PiecewiseConstantDistribution2;
+
+// Sample mode.
+typedef PiecewiseConstantDistribution2::sample_mode SampleMode;
+
+// Permuted congruential generator.
+pre::pcg32 pcg;
+
+// Grid size.
+const pre::multi<int, 2> size = {37, 23};
+
+// Weights, with an empty row, an empty column, and scattered empty cells.
+std::vector<Float> weights;
+
+// Initialize weights.
+void initWeights()
+{
+    weights.resize(std::size_t(size[0]) * size[1]);
+    Float sum = 0;
+    for (int k0 = 0; k0 < size[0]; k0++)
+    for (int k1 = 0; k1 < size[1]; k1++) {
+        Float& weight = weights[std::size_t(k0) * size[1] + k1];
+        weight =
+            k0 == 5 || k1 == 17 || (k0 * 7 + k1) % 11 == 3 ? 0 :
+            std::pow(pre::generate_canonical<Float>(pcg), Float(3));
+        sum += weight;
+    }
+    for (Float& weight : weights) {
+        weight /= sum;
+    }
+}
+
+// Test sample mode.
+void testMode(SampleMode mode, const char* name)
+{
+    const int n = 1 << 22;
+    const int ncells = size[0] * size[1];
+    std::cout << "Testing " << name << ":\n";
+    std::cout << "This test draws " << n << " samples on a ";
+    std::cout << size[0] << "x" << size[1] << " grid of\n";
+    std::cout << "random weights with empty cells, and compares cell\n";
+    std::cout << "frequencies to cell weights, and densities from batch\n";
+    std::cout << "sampling to pdf() and to the weights. This should print\n";
+    std::cout << "1 for chi-square per cell within 5 standard deviations\n";
+    std::cout << "of 1, 0 samples in empty cells, and 0 mismatches for\n";
+    std::cout << "batch sampling and densities.\n";
+    std::cout.flush();
+
+    PiecewiseConstantDistribution2 dist(size, weights.data(), mode);
+    std::vector<int> counts(ncells);
+    int nbatch_mismatches = 0;
+    int ndensity_mismatches = 0;
+    constexpr int batch = 64;
+    for (int k = 0; k < n; k += batch) {
+        Vec3f u[batch];
+        Vec2f u2[batch];
+        Vec2f x[batch];
+        Float f[batch];
+        for (int j = 0; j < batch; j++) {
+            u[j] = pre::generate_canonical<Float, 3>(pcg);
+            u2[j] = {u[j][0], u[j][1]};
+        }
+        Vec2f expect[batch];
+        switch (mode) {
+            case SampleMode::alias:
+                dist.alias_sample_many(u, batch, x, f);
+                for (int j = 0; j < batch; j++) {
+                    expect[j] = dist.alias_sample(u[j]);
+                }
+                break;
+            case SampleMode::warp:
+                dist.warp_many(u2, batch, x, f);
+                for (int j = 0; j < batch; j++) {
+                    expect[j] = dist.warp(u2[j]);
+                }
+                break;
+            default:
+                dist.cdfinv_many(u2, batch, x, f);
+                for (int j = 0; j < batch; j++) {
+                    expect[j] = dist.cdfinv(u2[j]);
+                }
+                break;
+        }
+        for (int j = 0; j < batch; j++) {
+            nbatch_mismatches += !(x[j] == expect[j]).all();
+            int k0 = std::min(int(x[j][0] * size[0]), size[0] - 1);
+            int k1 = std::min(int(x[j][1] * size[1]), size[1] - 1);
+            Float weight = weights[std::size_t(k0) * size[1] + k1];
+            ndensity_mismatches +=
+                f[j] != dist.pdf(x[j]) ||
+                !(std::fabs(f[j] - weight * ncells) <= 1e-9 * f[j]);
+            counts[k0 * size[1] + k1]++;
+        }
+    }
+
+    // Compare frequencies.
+    Float chi2 = 0;
+    int nnonzero = 0;
+    int nzero_hits = 0;
+    for (int k = 0; k < ncells; k++) {
+        if (weights[k] == 0) {
+            nzero_hits += counts[k];
+        }
+        else {
+            Float expect = weights[k] * n;
+            chi2 += (counts[k] - expect) * (counts[k] - expect) / expect;
+            nnonzero++;
+        }
+    }
+    Float chi2_per_cell = chi2 / nnonzero;
+
+    // Print test result.
+    std::cout << "Result: ";
+    std::cout << (std::fabs(chi2_per_cell - 1) <
+                  5 * std::sqrt(Float(2) / nnonzero)) << " ";
+    std::cout << "(" << chi2_per_cell << "), " << nzero_hits << ", ";
+    std::cout << nbatch_mismatches << ", " << ndensity_mismatches << "\n\n";
+    std::cout.flush();
+}
+
+// Test invalid arguments.
+void testInvalid()
+{
+    std::cout << "Testing invalid arguments:\n";
+    std::cout << "This test constructs distributions with an empty grid,\n";
+    std::cout << "a negative weight, and all zero weights. This should\n";
+    std::cout << "print 3 rejected distributions.\n";
+    std::cout.flush();
+
+    int nrejected = 0;
+    try {
+        PiecewiseConstantDistribution2 dist(
+                {0, 4}, [](int, int) { return Float(1); });
+    }
+    catch (const std::invalid_argument&) {
+        nrejected++;
+    }
+    try {
+        PiecewiseConstantDistribution2 dist(
+                {4, 4}, [](int k0, int k1) {
+                    return k0 == 2 && k1 == 1 ? Float(-1) : Float(1);
+                });
+    }
+    catch (const std::invalid_argument&) {
+        nrejected++;
+    }
+    try {
+        PiecewiseConstantDistribution2 dist(
+                {4, 4}, [](int, int) { return Float(0); });
+    }
+    catch (const std::invalid_argument&) {
+        nrejected++;
+    }
+
+    // Print test result.
+    std::cout << "Result: " << nrejected << "\n\n";
+    std::cout.flush();
+}
+
+int main(int argc, char** argv)
+{
+    int seed = 0;
+
+    // Option parser.
+    pre::option_parser opt_parser("[OPTIONS]");
+
+    // Specify seed.
+    opt_parser.on_option(
+    "-s", "--seed", 1,
+    [&](char** argv) {
+        try {
+            seed = std::stoi(argv[0]);
+        }
+        catch (const std::exception&) {
+            throw
+                std::runtime_error(
+                std::string("-s/--seed expects 1 integer ")
+                    .append("(can't parse ").append(argv[0])
+                    .append(")"));
+        }
+    })
+    << "Specify seed. By default, random.\n";
+
+    // Display help.
+    opt_parser.on_option(
+    "-h", "--help", 0,
+    [&](char**) {
+        std::cout << opt_parser << std::endl;
+        std::exit(EXIT_SUCCESS);
+    })
+    << "Display this help and exit.\n";
+
+    try {
+        // Parse args.
+        opt_parser.parse(argc, argv);
+    }
+    catch (const std::exception& exception) {
+        std::cerr << "Unhandled exception!\n";
+        std::cerr << "exception.what(): " << exception.what() << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+
+    // Seed.
+    if (seed == 0) {
+        seed = std::random_device()();
+    }
+    std::cout << "seed = " << seed << "\n\n";
+    std::cout.flush();
+    pcg = pre::pcg32(seed);
+
+    // Weights.
+    initWeights();
+
+    // Sample modes.
+    testMode(SampleMode::cdfinv, "inverse transform sampling");
+    testMode(SampleMode::alias, "alias table sampling");
+    testMode(SampleMode::warp, "hierarchical warp sampling");
+
+    // Invalid arguments.
+    testInvalid();
+
+    return EXIT_SUCCESS;
+}
@@ -1,5 +1,7 @@
+#include <algorithm>
 #include <iostream>
 #include <random>
+#include <vector>
 #include <preform/random.hpp>
 #include <preform/neumaier_sum.hpp>
 #include <preform/option_parser.hpp>
@@ -41,6 +43,10 @@ typedef pre::tanh_distribution<Float> TanhDistribution;
 // Weibull distribution.
 typedef pre::weibull_distribution<Float> WeibullDistribution;
 
+// Piecewise constant distribution.
+typedef pre::piecewise_constant_distribution<Float>
+        PiecewiseConstantDistribution;
+
 // Timer.
 typedef pre::steady_timer Timer;
 
@@ -226,6 +232,287 @@ void testRealDistribution(
     x = nullptr;
 }
 
+// Test piecewise constant alias table.
+void testPiecewiseConstantAlias(int nbins)
+{
+    const int n = 4194304;
+    std::cout << "Testing alias table for ";
+    std::cout << "PiecewiseConstantDistribution with ";
+    std::cout << nbins << " bins:\n";
+    std::cout <<
+        "This test compares bin frequencies of alias table samples\n"
+        "to bin probabilities, and times alias table sampling\n"
+        "against inverse transform sampling.\n";
+    std::cout.flush();
+
+    // Initialize distribution with uneven bins and weights.
+    std::vector<Float> xs(nbins + 1);
+    std::vector<Float> ys(nbins + 1);
+    xs[0] = 0;
+    for (int k = 0; k < nbins; k++) {
+        xs[k + 1] = xs[k] + 0.5 + pre::generate_canonical<Float>(pcg);
+        ys[k] = k % 7 == 3 ? 0 : pre::pow(
+                pre::generate_canonical<Float>(pcg), Float(4));
+    }
+    ys[nbins] = 0;
+    PiecewiseConstantDistribution distribution(
+            xs.begin(), xs.end(), ys.begin());
+    distribution.init_alias();
+
+    // Sample.
+    std::vector<Float> u0(n);
+    std::vector<Float> u1(n);
+    for (int k = 0; k < n; k++) {
+        u0[k] = pre::generate_canonical<Float>(pcg);
+        u1[k] = pre::generate_canonical<Float>(pcg);
+    }
+    std::vector<int> counts(nbins);
+    Float xsum = 0;
+    int bad = 0;
+    Timer timer;
+    for (int k = 0; k < n; k++) {
+        int j = 0;
+        Float x = distribution.alias_cdfinv(u0[k], u1[k], &j);
+        bad += !(x >= xs[j] && x <= xs[j + 1]);
+        counts[j]++;
+        xsum += x;
+    }
+    Float alias_us = timer.read<std::nano>() * 1e-3 / n;
+    timer = Timer();
+    for (int k = 0; k < n; k++) {
+        xsum += distribution.cdfinv(u0[k]);
+    }
+    Float cdfinv_us = timer.read<std::nano>() * 1e-3 / n;
+
+    // Compare frequencies.
+    Float chi2 = 0;
+    int zero_hits = 0;
+    for (int k = 0; k < nbins; k++) {
+        Float pk = (xs[k + 1] - xs[k]) * distribution.bin_pdf(k);
+        if (pk == 0) {
+            zero_hits += counts[k];
+        }
+        else {
+            Float ek = pk * n;
+            chi2 += (counts[k] - ek) * (counts[k] - ek) / ek;
+        }
+    }
+    std::cout << "Chi-square per bin: " << chi2 / nbins << "\n";
+    std::cout << "Samples in zero bins: " << zero_hits << "\n";
+    std::cout << "Samples outside bins: " << bad << "\n";
+    std::cout << "Alias table: ~" << alias_us << "us per sample\n";
+    std::cout << "Inverse transform: ~" << cdfinv_us << "us per sample\n";
+    std::cout << "(Sum to keep optimizer honest: " << xsum << ")\n\n";
+    std::cout.flush();
+}
+
+// Test PCG lanes.
+void testPcgLanes()
+{
+    const int rounds = 1048576;
+    std::cout << "Testing pcg32x8:\n";
+    std::cout <<
+        "This test compares lanes to scalar engines on the same\n"
+        "streams, and times lanes against a scalar engine.\n";
+    std::cout.flush();
+
+    // Initialize lanes and matching scalar engines.
+    std::uint64_t seed = pcg();
+    pre::pcg32x8 lanes(seed, 17);
+    pre::pcg32 engines[8];
+    for (int k = 0; k < 8; k++) {
+        engines[k] = pre::pcg32(seed, 17 + k);
+    }
+
+    // Compare results and canonical samples.
+    int mismatches = 0;
+    std::vector<std::uint32_t> out(8 * 4096);
+    std::vector<Float> samples(8 * 4096);
+    lanes.generate(&out[0], 4096);
+    lanes.generate_canonical(&samples[0], 4096);
+    for (int r = 0; r < 4096; r++)
+    for (int k = 0; k < 8; k++) {
+        mismatches += out[r * 8 + k] != engines[k]();
+    }
+    for (int r = 0; r < 4096; r++)
+    for (int k = 0; k < 8; k++) {
+        mismatches += samples[r * 8 + k] !=
+            pre::generate_canonical<Float>(engines[k]);
+    }
+    lanes.discard(12345);
+    for (int k = 0; k < 8; k++) {
+        engines[k].discard(12345);
+        mismatches += lanes.lane(k) != engines[k];
+    }
+
+    // Time.
+    std::uint32_t xsum = 0;
+    Timer timer;
+    for (int r = 0; r < rounds; r += 4096) {
+        lanes.generate(&out[0], 4096);
+        xsum += out[r % 4096];
+    }
+    Float lanes_ns = timer.read<std::nano>() / (Float(rounds) * 8);
+    timer = Timer();
+    for (int r = 0; r < rounds; r += 4096) {
+        for (std::uint32_t& x : out) {
+            x = engines[0]();
+        }
+        xsum += out[r % 4096];
+    }
+    Float scalar_ns = timer.read<std::nano>() / (Float(rounds) * 8);
+    std::cout << "Mismatches: " << mismatches << "\n";
+    std::cout << "Lanes: ~" << lanes_ns << "ns per result\n";
+    std::cout << "Scalar: ~" << scalar_ns << "ns per result\n";
+    std::cout << "(Sum to keep optimizer honest: " << xsum << ")\n\n";
+    std::cout.flush();
+}
+
+// Test Philox.
+void testPhilox()
+{
+    const int n = 8388608;
+    std::cout << "Testing philox4x32:\n";
+    std::cout <<
+        "This test checks known answers, compares batched to\n"
+        "one-at-a-time generation, and times both.\n";
+    std::cout.flush();
+
+    // Known answers, from the Random123 distribution.
+    int mismatches = 0;
+    std::uint32_t block[4];
+    pre::philox4x32::block(0, 0, 0, block);
+    mismatches += block[0] != 0x6627E8D5UL || block[1] != 0xE169C58DUL ||
+                  block[2] != 0xBC57AC4CUL || block[3] != 0x9B00DBD8UL;
+    pre::philox4x32::block(~0ULL, ~0ULL, ~0ULL, block);
+    mismatches += block[0] != 0x408F276DUL || block[1] != 0x41C83B0EUL ||
+                  block[2] != 0xA20BC7C6UL || block[3] != 0x6D5451FDUL;
+
+    // Compare batched generation, across a counter carry.
+    pre::philox4x32 gen0(pcg(), 3, ~0ULL - 5);
+    pre::philox4x32 gen1 = gen0;
+    std::vector<std::uint32_t> out(4099);
+    gen0();
+    gen0.generate(&out[0], out.size());
+    gen1();
+    for (std::uint32_t x : out) {
+        mismatches += x != gen1();
+    }
+    pre::philox4x32 gen2(gen0.key(), 3, ~0ULL - 5);
+    gen2.discard(1 + out.size());
+    mismatches += gen0 != gen1 || gen1 != gen2;
+
+    // Time.
+    std::uint32_t xsum = 0;
+    out.resize(4096);
+    Timer timer;
+    for (int k = 0; k < n; k += 4096) {
+        gen0.generate(&out[0], 4096);
+        xsum += out[k % 4096];
+    }
+    Float batched_ns = timer.read<std::nano>() / Float(n);
+    timer = Timer();
+    for (int k = 0; k < n; k += 4096) {
+        for (std::uint32_t& x : out) {
+            x = gen1();
+        }
+        xsum += out[k % 4096];
+    }
+    Float scalar_ns = timer.read<std::nano>() / Float(n);
+    std::cout << "Mismatches: " << mismatches << "\n";
+    std::cout << "Batched: ~" << batched_ns << "ns per result\n";
+    std::cout << "One at a time: ~" << scalar_ns << "ns per result\n";
+    std::cout << "(Sum to keep optimizer honest: " << xsum << ")\n\n";
+    std::cout.flush();
+}
+
+// Test rejection sampling statistics.
+template <typename Distribution>
+void testRejectionDistribution(
+                const char* name,
+                const Distribution& distribution)
+{
+    const int n = 1048576;
+    std::cout << "Testing rejection sampling for ";
+    std::cout << name << ":\n";
+    std::cout <<
+        "This test compares sample statistics of operator() samples\n"
+        "(by transformed rejection) to analytical distribution\n"
+        "statistics, and times sampling.\n";
+    std::cout.flush();
+
+    // Sample.
+    std::vector<int> x(n);
+    Timer timer;
+    distribution.sample_n(pcg, &x[0], n);
+    Float ns = timer.read<std::nano>() / Float(n);
+
+    // Compute sample moments.
+    NeumaierSum s1 = 0;
+    for (int k = 0; k < n; k++) {
+        s1 += x[k];
+    }
+    Float m1 = Float(s1) / n;
+    NeumaierSum s2 = 0;
+    for (int k = 0; k < n; k++) {
+        s2 += (x[k] - m1) * (x[k] - m1);
+    }
+    Float mu2 = Float(s2) / (n - 1);
+    std::cout << "Sample mean: " << m1 << "\n";
+    std::cout << "Sample variance: " << mu2 << "\n";
+    std::cout << "Distribution mean: " << distribution.mean() << "\n";
+    std::cout << "Distribution variance: " << distribution.variance() << "\n";
+    std::cout << "Sampling: ~" << ns << "ns per sample\n\n";
+    std::cout.flush();
+}
+
+// Test normal ziggurat and batch sampling.
+void testNormalZiggurat()
+{
+    const int n = 4194304;
+    std::cout << "Testing ziggurat for NormalDistribution:\n";
+    std::cout <<
+        "This test compares ziggurat samples to the normal CDF, checks\n"
+        "that sample_n() matches operator(), and times ziggurat\n"
+        "sampling against inverse transform sampling.\n";
+    std::cout.flush();
+
+    // Sample.
+    NormalDistribution distribution;
+    std::vector<Float> x(n);
+    distribution.ziggurat_n(pcg, &x[0], n);
+    Timer timer;
+    distribution.ziggurat_n(pcg, &x[0], n);
+    Float ziggurat_ns = timer.read<std::nano>() / Float(n);
+
+    // Kolmogorov-Smirnov statistic.
+    std::vector<Float> sorted = x;
+    std::sort(sorted.begin(), sorted.end());
+    Float ks = 0;
+    for (int k = 0; k < n; k++) {
+        Float cdf = distribution.cdf(sorted[k]);
+        ks = std::max(ks, std::max(
+                cdf - Float(k) / n, Float(k + 1) / n - cdf));
+    }
+    ks *= pre::sqrt(Float(n));
+
+    // Compare sample_n() to operator().
+    int mismatches = 0;
+    pre::pcg32 gen0 = pcg;
+    pre::pcg32 gen1 = pcg;
+    timer = Timer();
+    distribution.sample_n(gen0, &x[0], n);
+    Float inverse_ns = timer.read<std::nano>() / Float(n);
+    for (int k = 0; k < n; k++) {
+        mismatches += x[k] != distribution(gen1);
+    }
+    std::cout << "KS statistic: " << ks << " (should be below ~1.36)\n";
+    std::cout << "Batch mismatches: " << mismatches << "\n";
+    std::cout << "Ziggurat: ~" << ziggurat_ns << "ns per sample\n";
+    std::cout << "Inverse transform: ~" << inverse_ns << "ns per sample\n\n";
+    std::cout.flush();
+}
+
 int main(int argc, char** argv)
 {
     int seed = 0;
@@ -342,5 +629,26 @@ int main(int argc, char** argv)
         "WeibullDistribution(0.9, 0.7)",
          WeibullDistribution(0.9, 0.7));
 
+    // Test piecewise constant alias table.
+    testPiecewiseConstantAlias(100);
+    testPiecewiseConstantAlias(1000000);
+
+    // Test rejection sampling.
+    testRejectionDistribution(
+        "PoissonDistribution(2500)",
+         PoissonDistribution(2500));
+    testRejectionDistribution(
+        "BinomialDistribution(10000, 0.7)",
+         BinomialDistribution(10000, 0.7));
+
+    // Test normal ziggurat.
+    testNormalZiggurat();
+
+    // Test PCG lanes.
+    testPcgLanes();
+
+    // Test Philox.
+    testPhilox();
+
     return EXIT_SUCCESS;
 }
@@ -1,5 +1,6 @@
 #include <iostream>
 #include <random>
+#include <vector>
 #include <preform/random.hpp>
 #include <preform/running_stat.hpp>
 #include <preform/option_parser.hpp>
@@ -35,12 +36,22 @@ void testDistribution(
     // Run.
     RunningStat stat;
     Float term;
+    std::vector<Float> terms;
     for (int k = 0; k < 8388608; k++) {
         if (pre::isfinite((term = distr(pcg)))) {
             stat += term;
+            terms.push_back(term);
         }
     }
 
+    // Run in bulk, in two parts, then merge.
+    RunningStat stat0;
+    RunningStat stat1;
+    std::size_t half = terms.size() / 2 + 3;
+    stat0.add(terms.data(), half);
+    stat1.add(terms.data() + half, terms.size() - half);
+    stat0.merge(stat1);
+
     // Result mean.
     std::cout << "stat.mean(): ";
     std::cout <<  stat.mean();
@@ -59,7 +70,12 @@ void testDistribution(
     // Result kurtosis.
     std::cout << "stat.kurtosis(): ";
     std::cout <<  stat.kurtosis();
-    std::cout << " (this should be close to " << kurtosis << ")\n\n";
+    std::cout << " (this should be close to " << kurtosis << ")\n";
+
+    // Result of bulk and merge.
+    std::cout << "merged stat.kurtosis(): ";
+    std::cout <<  stat0.kurtosis();
+    std::cout << " (this should match the above closely)\n\n";
     std::cout.flush();
 }
 
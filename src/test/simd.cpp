@@ -0,0 +1,415 @@
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <vector>
+#include <preform/random.hpp>
+#include <preform/option_parser.hpp>
+#include <preform/simd.hpp>
+#include <preform/multi.hpp>
+#include <preform/multi_math.hpp>
+#include <preform/quat.hpp>
+#include <preform/aabb.hpp>
+#include <preform/multi_batch.hpp>
+#include <preform/quat_batch.hpp>
+#include <preform/timer.hpp>
+
+// Float type.
+typedef float Float;
+
+// Packet width.
+constexpr std::size_t Width = 8;
+
+// SIMD float type.
+typedef pre::simd<Float, Width> SimdFloat;
+
+// 3-dimensional vector type.
+typedef pre::vec3<Float> Vec3f;
+
+// 3x3-dimensional matrix type.
+typedef pre::mat3<Float> Mat3f;
+
+// 3-dimensional vector packet type.
+typedef pre::vec3<SimdFloat> Vec3fx;
+
+// 3x3-dimensional matrix packet type.
+typedef pre::mat3<SimdFloat> Mat3fx;
+
+// Quaternion type.
+typedef pre::quat<Float> Quat;
+
+// Quaternion packet type.
+typedef pre::quat<SimdFloat> Quatx;
+
+// Timer.
+typedef pre::steady_timer Timer;
+
+// Permuted congruential generator.
+pre::pcg32 pcg;
+
+// Generate canonical random number.
+Float generateCanonical()
+{
+    return pre::generate_canonical<Float>(pcg);
+}
+
+// Generate random vector in [-1,1)^3.
+Vec3f generateVec3()
+{
+    return {
+        generateCanonical() * 2 - 1,
+        generateCanonical() * 2 - 1,
+        generateCanonical() * 2 - 1
+    };
+}
+
+// Gather lane of packet.
+Vec3f lane(const Vec3fx& v, std::size_t k)
+{
+    return {v[0][k], v[1][k], v[2][k]};
+}
+
+// Scatter into lane of packet.
+void setLane(Vec3fx& v, std::size_t k, const Vec3f& u)
+{
+    v[0][k] = u[0];
+    v[1][k] = u[1];
+    v[2][k] = u[2];
+}
+
+void testGeometry()
+{
+    // Print description.
+    std::cout << "Testing geometry:\n";
+    std::cout << "This test evaluates cross, normalize, dot, and build_onb\n";
+    std::cout << "on packets of " << Width << " vectors, and compares each\n";
+    std::cout << "lane against the scalar implementation. Errors should be\n";
+    std::cout << "on the order of float epsilon, as the packet runs the\n";
+    std::cout << "same arithmetic up to contraction into FMA.\n";
+    std::cout.flush();
+
+    // Random vectors, including the degenerate build_onb case.
+    std::size_t n = 1 << 16;
+    std::vector<Vec3f> a(n);
+    std::vector<Vec3f> b(n);
+    for (std::size_t j = 0; j < n; j++) {
+        a[j] = generateVec3();
+        b[j] = generateVec3();
+    }
+    a[3] = {0, 0, -1};
+
+    // Pack.
+    std::vector<Vec3fx> ax(n / Width);
+    std::vector<Vec3fx> bx(n / Width);
+    for (std::size_t j = 0; j < n; j++) {
+        setLane(ax[j / Width], j % Width, a[j]);
+        setLane(bx[j / Width], j % Width, b[j]);
+    }
+
+    // Results.
+    std::vector<Mat3f> onb(n);
+    std::vector<Float> cos_theta(n);
+    std::vector<Mat3fx> onbx(n / Width);
+    std::vector<SimdFloat> cos_thetax(n / Width);
+
+    // Scalar.
+    Timer timer;
+    for (std::size_t j = 0; j < n; j++) {
+        Vec3f hatz = pre::normalize_fast(pre::cross(a[j], b[j]));
+        onb[j] = Mat3f::build_onb(pre::normalize_fast(a[j]));
+        cos_theta[j] = pre::dot(hatz, onb[j][2]);
+    }
+    Float scalar_ns = timer.read<std::nano>() / Float(n);
+
+    // Packet.
+    timer = Timer();
+    for (std::size_t j = 0; j < n / Width; j++) {
+        Vec3fx hatz = pre::normalize_fast(pre::cross(ax[j], bx[j]));
+        onbx[j] = Mat3fx::build_onb(pre::normalize_fast(ax[j]));
+        cos_thetax[j] = pre::dot(hatz, onbx[j][2]);
+    }
+    Float packet_ns = timer.read<std::nano>() / Float(n);
+
+    // Compare.
+    Float err = 0;
+    for (std::size_t j = 0; j < n; j++) {
+        for (std::size_t i = 0; i < 3; i++) {
+            err = std::max(err, pre::length(
+                onb[j][i] - lane(onbx[j / Width][i], j % Width)));
+        }
+        err = std::max(err, pre::abs(
+                cos_theta[j] - cos_thetax[j / Width][j % Width]));
+    }
+    std::cout << "max error = " << err << "\n";
+    std::cout << "scalar = " << scalar_ns << " ns per vector\n";
+    std::cout << "packet = " << packet_ns << " ns per vector\n\n";
+    std::cout.flush();
+}
+
+void testQuatAabb()
+{
+    // Print description.
+    std::cout << "Testing quat and aabb:\n";
+    std::cout << "This test rotates a packet of vectors by a packet of\n";
+    std::cout << "random rotations, and bounds the results. The rotated\n";
+    std::cout << "vectors should match the scalar rotations, and the\n";
+    std::cout << "packet bounds should agree with the union over lanes.\n";
+    std::cout.flush();
+
+    // Random rotations and vectors.
+    Vec3fx u;
+    Vec3fx hatv;
+    SimdFloat theta;
+    for (std::size_t k = 0; k < Width; k++) {
+        setLane(u, k, generateVec3());
+        setLane(hatv, k, pre::normalize(generateVec3()));
+        theta[k] = generateCanonical() * 2 *
+                   pre::numeric_constants<Float>::M_pi();
+    }
+
+    // Rotate.
+    Vec3fx v = Quatx::rotate(theta, hatv)(u);
+    Float err = 0;
+    for (std::size_t k = 0; k < Width; k++) {
+        Vec3f vk = Quat::rotate(theta[k], lane(hatv, k))(lane(u, k));
+        err = std::max(err, pre::length(vk - lane(v, k)));
+    }
+    std::cout << "max rotation error = " << err << "\n";
+
+    // Bound.
+    pre::aabb<SimdFloat, 3> boxx(u);
+    boxx |= v;
+    pre::aabb<Float, 3> box(lane(u, 0));
+    for (std::size_t k = 0; k < Width; k++) {
+        box |= lane(u, k);
+        box |= lane(v, k);
+    }
+    Vec3f boxmin;
+    Vec3f boxmax;
+    for (std::size_t i = 0; i < 3; i++) {
+        boxmin[i] = boxx[0][i].min();
+        boxmax[i] = boxx[1][i].max();
+    }
+    std::cout << "scalar bounds = " << box[0] << " " << box[1] << "\n";
+    std::cout << "packet bounds = " << boxmin << " " << boxmax << "\n\n";
+    std::cout.flush();
+}
+
+void testBatch()
+{
+    // Print description.
+    std::cout << "Testing batch:\n";
+    std::cout << "This test diagonalizes random symmetric 3x3 matrices in\n";
+    std::cout << "batches of " << Width << " with eigh, and Cholesky factors\n";
+    std::cout << "their squares with chol. The reconstructions should match\n";
+    std::cout << "the inputs to within a small multiple of float epsilon.\n";
+    std::cout.flush();
+
+    // Random symmetric matrices, including the zero matrix and a
+    // repeated eigenvalue.
+    std::size_t n = 1 << 12;
+    std::vector<Mat3f> a(n);
+    for (std::size_t j = 0; j < n; j++) {
+        for (std::size_t i = 0; i < 3; i++) {
+            a[j][i] = generateVec3();
+        }
+        a[j] = a[j] + pre::transpose(a[j]);
+    }
+    a[1] = Mat3f{};
+    a[2] = Mat3f{{1, 0, 0}, {0, 2, 0}, {0, 0, 2}};
+
+    // Diagonalize and reconstruct, including a partial final batch.
+    std::vector<Mat3f> b(n);
+    Timer timer;
+    pre::batch_transform<Width>(
+            a.data(), a.data() + n - 3, b.data(),
+            [](const Mat3fx& ax) {
+                Mat3fx v;
+                pre::vec3<SimdFloat> lambda = pre::eigh(ax, v);
+                Mat3fx d = {};
+                for (std::size_t i = 0; i < 3; i++) {
+                    d[i][i] = lambda[i];
+                }
+                return pre::dot(v, pre::dot(d, pre::transpose(v)));
+            });
+    Float eigh_ns = timer.read<std::nano>() / Float(n - 3);
+    Float err = 0;
+    for (std::size_t j = 0; j < n - 3; j++) {
+        for (std::size_t i = 0; i < 3; i++) {
+            err = std::max(err, pre::length(b[j][i] - a[j][i]));
+        }
+    }
+    std::cout << "max eigh error = " << err << "\n";
+    std::cout << "eigh = " << eigh_ns << " ns per matrix\n";
+
+    // Factor and reconstruct.
+    err = 0;
+    for (std::size_t j = 0; j < n; j += Width) {
+        Mat3f aa[Width];
+        for (std::size_t k = 0; k < Width; k++) {
+            aa[k] = pre::dot(a[j + k], a[j + k]);
+            aa[k] += Mat3f::identity();
+        }
+        Mat3fx lx = pre::batch_pack<Width>(&aa[0]);
+        if (!pre::all(pre::chol(lx))) {
+            std::cout << "chol failed\n";
+        }
+        Mat3f l[Width];
+        pre::batch_unpack(lx, &l[0]);
+        for (std::size_t k = 0; k < Width; k++) {
+            Mat3f ll = pre::dot(l[k], pre::transpose(l[k]));
+            for (std::size_t i = 0; i < 3; i++) {
+                err = std::max(err, pre::length(ll[i] - aa[k][i]));
+            }
+        }
+    }
+    std::cout << "max chol error = " << err << "\n\n";
+    std::cout.flush();
+}
+
+void testQuatBatch()
+{
+    // Print description.
+    std::cout << "Testing quat batch:\n";
+    std::cout << "This test interpolates random versor pairs with\n";
+    std::cout << "batch_slerp, and skins random vertices by two random\n";
+    std::cout << "rigid bones with batch_dual_quat_skin. Interpolants\n";
+    std::cout << "should match scalar slerp, and vertices weighted by one\n";
+    std::cout << "bone should match its rigid transform, to within a small\n";
+    std::cout << "multiple of float epsilon.\n";
+    std::cout.flush();
+
+    // Random versors, with a partial final batch.
+    std::size_t n = (1 << 14) - 3;
+    std::vector<Quat> q0(n);
+    std::vector<Quat> q1(n);
+    std::vector<Float> mu(n);
+    for (std::size_t j = 0; j < n; j++) {
+        q0[j] = Quat::rotate(generateCanonical() * 6,
+                             pre::normalize(generateVec3()));
+        q1[j] = Quat::rotate(generateCanonical() * 6,
+                             pre::normalize(generateVec3()));
+        mu[j] = generateCanonical();
+    }
+
+    // Interpolate.
+    std::vector<Quat> q(n);
+    Timer timer;
+    for (std::size_t j = 0; j < n; j++) {
+        q[j] = Quat::slerp(mu[j], q0[j], q1[j]);
+    }
+    Float scalar_ns = timer.read<std::nano>() / Float(n);
+    std::vector<Quat> qx(n);
+    timer = Timer();
+    pre::batch_slerp<Width>(
+            mu.data(), q0.data(), q1.data(), qx.data(), n);
+    Float batch_ns = timer.read<std::nano>() / Float(n);
+    Float err = 0;
+    for (std::size_t j = 0; j < n; j++) {
+        err = std::max(err, pre::length(q[j] - qx[j]));
+    }
+    std::cout << "max slerp error = " << err << "\n";
+    std::cout << "scalar = " << scalar_ns << " ns per versor\n";
+    std::cout << "batch = " << batch_ns << " ns per versor\n";
+
+    // Random bones.
+    typedef pre::quat<pre::dualnum<Float>> DualQuat;
+    DualQuat bones[2];
+    Quat bone_rot[2];
+    Vec3f bone_loc[2];
+    for (int b = 0; b < 2; b++) {
+        bone_rot[b] = Quat::rotate(generateCanonical() * 6,
+                                   pre::normalize(generateVec3()));
+        bone_loc[b] = generateVec3();
+        Quat qd = Quat(0, bone_loc[b]) * bone_rot[b] * Float(0.5);
+        bones[b].quat_real(bone_rot[b]);
+        bones[b].quat_dual(qd);
+    }
+
+    // Random vertices, skinned by one bone or both.
+    std::vector<pre::vec2<int>> index(n);
+    std::vector<pre::vec2<Float>> weight(n);
+    std::vector<Vec3f> p(n);
+    for (std::size_t j = 0; j < n; j++) {
+        index[j] = {0, 1};
+        weight[j][0] = j % 4 == 0 ? 1 : generateCanonical();
+        weight[j][1] = 1 - weight[j][0];
+        p[j] = generateVec3();
+    }
+    std::vector<Vec3f> px(n);
+    pre::batch_dual_quat_skin<Width>(
+            &bones[0], index.data(), weight.data(),
+            p.data(), px.data(), n);
+    err = 0;
+    for (std::size_t j = 0; j < n; j += 4) {
+        Vec3f pj = bone_rot[0](p[j]) + bone_loc[0];
+        err = std::max(err, pre::length(pj - px[j]));
+    }
+    std::cout << "max skin error (one bone) = " << err << "\n\n";
+    std::cout.flush();
+}
+
+int main(int argc, char** argv)
+{
+    // Seed.
+    std::uint64_t seed = 0;
+
+    // Option parser.
+    pre::option_parser opt_parser("Usage: simd [OPTIONS]");
+
+    // Specify seed.
+    opt_parser.on_option("-s", "--seed", 1,
+    [&](char** argv) {
+        try {
+            seed = std::stoi(argv[0]);
+        }
+        catch (const std::exception&) {
+            throw
+                std::runtime_error(
+                std::string("-s/--seed expects 1 integer ")
+                    .append("(can't parse ").append(argv[0])
+                    .append(")"));
+        }
+    })
+    << "Specify seed. By default, random.\n";
+
+    // Display help.
+    opt_parser.on_option(
+    "-h", "--help", 0,
+    [&](char**) {
+        std::cout << opt_parser << std::endl;
+        std::exit(EXIT_SUCCESS);
+    })
+    << "Display this help and exit.\n";
+
+    try {
+        // Parse args.
+        opt_parser.parse(argc, argv);
+    }
+    catch (const std::exception& exception) {
+        std::cerr << "Unhandled exception!\n";
+        std::cerr << "exception.what(): " << exception.what() << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+
+    // Seed.
+    if (seed == 0) {
+        seed = std::random_device()();
+    }
+    std::cout << "seed = " << seed << "\n\n";
+    std::cout.flush();
+    pcg = pre::pcg32(seed);
+
+    // Test geometry.
+    testGeometry();
+
+    // Test quat and aabb.
+    testQuatAabb();
+
+    // Test batch.
+    testBatch();
+
+    // Test quat batch.
+    testQuatBatch();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,245 @@
+#include <iostream>
+#include <random>
+#include <set>
+#include <tuple>
+#include <vector>
+#include <preform/random.hpp>
+#include <preform/multi_random.hpp>
+#include <preform/option_parser.hpp>
+#include <preform/image3.hpp>
+#include <preform/sparse_image3.hpp>
+
+// Float type.
+typedef float Float;
+
+// 3-dimensional vector.
+typedef pre::vec3<Float> Vec3f;
+
+// 3-dimensional index.
+typedef pre::multi<std::size_t, 3> Index3;
+
+// Image.
+typedef pre::image3<Float, Float, 2> Image3;
+
+// Sparse image.
+typedef pre::sparse_image3<Float, Float, 2> SparseImage3;
+
+// Permuted congruential generator.
+pre::pcg32 pcg;
+
+// Generate canonical random 3-dimensional vector.
+Vec3f generateCanonical3()
+{
+    return pre::generate_canonical<Float, 3>(pcg);
+}
+
+// Dense image, 70 by 50 by 40, mostly zero with a few balls.
+Image3 dense;
+
+// Initialize dense image.
+void initDense()
+{
+    dense.resize({70, 50, 40});
+    dense.cycle_mode({0, +1, -1});
+    for (auto& value : dense) {
+        value = {};
+    }
+    for (int ball = 0; ball < 6; ball++) {
+        Vec3f center = generateCanonical3() * Vec3f(dense.user_size());
+        Float radius = 2 + pre::generate_canonical<Float>(pcg) * 4;
+        for (std::size_t i = 0; i < dense.user_size()[0]; i++)
+        for (std::size_t j = 0; j < dense.user_size()[1]; j++)
+        for (std::size_t k = 0; k < dense.user_size()[2]; k++) {
+            Vec3f diff =
+                Vec3f{Float(i), Float(j), Float(k)} + Float(0.5) - center;
+            if (pre::dot(diff, diff) < radius * radius) {
+                dense(i, j, k) = {
+                    pre::generate_canonical<Float>(pcg),
+                    Float(ball + 1)
+                };
+            }
+        }
+    }
+}
+
+// Test entries and sampling.
+void testSampling()
+{
+    std::cout << "Testing entries and sampling:\n";
+    std::cout << "This test converts a mostly empty 70x50x40 volume to\n";
+    std::cout << "bricks, compares every entry, then samples 16384 random\n";
+    std::cout << "locations, partly outside the volume, with each method.\n";
+    std::cout << "This should print as many bricks as occupied bricks,\n";
+    std::cout << "and 0 mismatches for each.\n";
+    std::cout.flush();
+
+    SparseImage3 sparse(dense);
+
+    // Occupied bricks.
+    std::set<std::tuple<std::size_t, std::size_t, std::size_t>> occupied;
+    int nentry_mismatches = 0;
+    for (std::size_t i = 0; i < dense.user_size()[0]; i++)
+    for (std::size_t j = 0; j < dense.user_size()[1]; j++)
+    for (std::size_t k = 0; k < dense.user_size()[2]; k++) {
+        if (!(dense(i, j, k) == Float(0)).all()) {
+            occupied.emplace(i / 8, j / 8, k / 8);
+        }
+        nentry_mismatches += !(sparse(i, j, k) == dense(i, j, k)).all();
+    }
+
+    int nsample_mismatches[3] = {};
+    for (int count = 0; count < 16384; count++) {
+        Vec3f loc =
+            (generateCanonical3() * Float(1.5) - Float(0.25)) *
+             Vec3f(dense.user_size());
+        int pos = 0;
+        for (int samp : {0, 1, 3}) {
+            nsample_mismatches[pos++] +=
+                (pre::abs(sparse.sample(samp, loc) -
+                          dense.sample(samp, loc)) > Float(1e-6)).any();
+        }
+    }
+
+    // Print test result.
+    std::cout << "Result: " << sparse.brick_count() << "/";
+    std::cout << occupied.size() << ", " << nentry_mismatches << ", ";
+    std::cout << nsample_mismatches[0] << ", ";
+    std::cout << nsample_mismatches[1] << ", ";
+    std::cout << nsample_mismatches[2] << " ";
+    std::cout << "(" << sparse.memory_usage() << " bytes)\n\n";
+    std::cout.flush();
+}
+
+// Test modifiers.
+void testModifiers()
+{
+    std::cout << "Testing modifiers:\n";
+    std::cout << "This test sets 256 random entries away from the\n";
+    std::cout << "background and back, then compacts. This should print\n";
+    std::cout << "0 mismatches, and the original brick count after\n";
+    std::cout << "compacting.\n";
+    std::cout.flush();
+
+    SparseImage3 sparse(dense);
+    std::size_t brick_count = sparse.brick_count();
+    int nmismatches = 0;
+    for (int count = 0; count < 256; count++) {
+        Index3 ind = {pcg(70), pcg(50), pcg(40)};
+        SparseImage3::value_type prev = sparse(ind[0], ind[1], ind[2]);
+        sparse.set(ind, {Float(-1), Float(-1)});
+        nmismatches +=
+            !(sparse(ind[0], ind[1], ind[2]) == Float(-1)).all() ||
+            sparse.brick_empty(ind / SparseImage3::brick_size);
+        sparse.set(ind, prev);
+        nmismatches += !(sparse(ind[0], ind[1], ind[2]) == prev).all();
+    }
+    std::size_t grown_count = sparse.brick_count();
+    sparse.compact();
+
+    // Print test result.
+    std::cout << "Result: " << nmismatches << ", ";
+    std::cout << sparse.brick_count() << "/" << brick_count << " ";
+    std::cout << "(" << grown_count << " bricks before compacting)\n\n";
+    std::cout.flush();
+}
+
+// Test empty-space skipping.
+void testSkipEmpty()
+{
+    std::cout << "Testing empty-space skipping:\n";
+    std::cout << "This test skips empty space along 4096 random rays,\n";
+    std::cout << "then samples linearly and cubically at 64 points\n";
+    std::cout << "before each skipped parameter. This should print 0\n";
+    std::cout << "samples other than the background.\n";
+    std::cout.flush();
+
+    SparseImage3 sparse(dense);
+    int nbad = 0;
+    Float skipped = 0;
+    for (int count = 0; count < 4096; count++) {
+        Vec3f loc = generateCanonical3() * Vec3f(dense.user_size());
+        Vec3f dir = pre::generate_canonical<Float, 3>(pcg) - Float(0.5);
+        dir /= pre::length(dir);
+        Float tmax = 100;
+        Float t = sparse.skip_empty(loc, dir, 0, tmax);
+        for (int k = 0; k < 64 && t > 0; k++) {
+            Vec3f pos = loc + (t * (k + Float(0.5)) / 64) * dir;
+            for (int samp : {1, 3}) {
+                nbad += (pre::abs(dense.sample(samp, pos)) >
+                         Float(1e-6)).any();
+            }
+        }
+        skipped += t;
+    }
+
+    // Print test result.
+    std::cout << "Result: " << nbad << " ";
+    std::cout << "(" << skipped / 4096 << " skipped on average)\n\n";
+    std::cout.flush();
+}
+
+int main(int argc, char** argv)
+{
+    int seed = 0;
+
+    // Option parser.
+    pre::option_parser opt_parser("[OPTIONS]");
+
+    // Specify seed.
+    opt_parser.on_option(
+    "-s", "--seed", 1,
+    [&](char** argv) {
+        try {
+            seed = std::stoi(argv[0]);
+        }
+        catch (const std::exception&) {
+            throw
+                std::runtime_error(
+                std::string("-s/--seed expects 1 integer ")
+                    .append("(can't parse ").append(argv[0])
+                    .append(")"));
+        }
+    })
+    << "Specify seed. By default, random.\n";
+
+    // Display help.
+    opt_parser.on_option(
+    "-h", "--help", 0,
+    [&](char**) {
+        std::cout << opt_parser << std::endl;
+        std::exit(EXIT_SUCCESS);
+    })
+    << "Display this help and exit.\n";
+
+    try {
+        // Parse args.
+        opt_parser.parse(argc, argv);
+    }
+    catch (const std::exception& exception) {
+        std::cerr << "Unhandled exception!\n";
+        std::cerr << "exception.what(): " << exception.what() << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+
+    // Seed.
+    if (seed == 0) {
+        seed = std::random_device()();
+    }
+    std::cout << "seed = " << seed << "\n\n";
+    std::cout.flush();
+    pcg = pre::pcg32(seed);
+
+    // Dense image.
+    initDense();
+
+    // Entries and sampling.
+    testSampling();
+
+    // Modifiers.
+    testModifiers();
+
+    // Empty-space skipping.
+    testSkipEmpty();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,242 @@
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <vector>
+#include <preform/random.hpp>
+#include <preform/option_parser.hpp>
+#include <preform/sparse_linalg.hpp>
+
+// Float type.
+typedef double Float;
+
+// Sparse linear algebra.
+typedef pre::sparse_linalg<Float> SparseLinalg;
+
+// Permuted congruential generator.
+pre::pcg32 pcg;
+
+// Sparse matrix in compressed sparse row format.
+struct SparseMatrix
+{
+    std::vector<int> row_ptr = {0};
+    std::vector<int> col_ind;
+    std::vector<Float> val;
+    int n = 0;
+
+    void push(int j, Float value)
+    {
+        col_ind.push_back(j);
+        val.push_back(value);
+    }
+
+    void next_row()
+    {
+        row_ptr.push_back(int(col_ind.size()));
+        n++;
+    }
+
+    pre::csr_matrix_view<const Float> view() const
+    {
+        return {&row_ptr[0], &col_ind[0], &val[0], n, n};
+    }
+};
+
+// Generate shifted Laplacian on m-by-m grid, with random positive
+// conductances, which is symmetric positive definite. The shift
+// controls conditioning.
+SparseMatrix generateLaplacian(int m, Float shift)
+{
+    std::vector<Float> cx(std::size_t(m + 1) * m);
+    std::vector<Float> cy(std::size_t(m + 1) * m);
+    for (Float& c : cx) {
+        c = Float(0.5) + pre::generate_canonical<Float>(pcg);
+    }
+    for (Float& c : cy) {
+        c = Float(0.5) + pre::generate_canonical<Float>(pcg);
+    }
+    SparseMatrix a;
+    for (int i1 = 0; i1 < m; i1++)
+    for (int i0 = 0; i0 < m; i0++) {
+        Float w = cx[i1 * (m + 1) + i0];
+        Float e = cx[i1 * (m + 1) + i0 + 1];
+        Float s = cy[i0 * (m + 1) + i1];
+        Float n = cy[i0 * (m + 1) + i1 + 1];
+        if (i1 > 0) {
+            a.push((i1 - 1) * m + i0, -s);
+        }
+        if (i0 > 0) {
+            a.push(i1 * m + i0 - 1, -w);
+        }
+        a.push(i1 * m + i0, w + e + s + n + shift);
+        if (i0 < m - 1) {
+            a.push(i1 * m + i0 + 1, -e);
+        }
+        if (i1 < m - 1) {
+            a.push((i1 + 1) * m + i0, -n);
+        }
+        a.next_row();
+    }
+    return a;
+}
+
+// Test matrix-vector product.
+void testGemv()
+{
+    std::cout << "Testing matrix-vector product:\n";
+    std::cout << "This test multiplies 16 random shifted Laplacians by\n";
+    std::cout << "random vectors, and compares against dense products.\n";
+    std::cout << "This should print 0 mismatches.\n";
+    std::cout.flush();
+
+    int nmismatches = 0;
+    for (int count = 0; count < 16; count++) {
+        const int m = 1 + int(pcg(16));
+        const int n = m * m;
+        SparseMatrix a = generateLaplacian(m, 1);
+        std::vector<Float> dense(std::size_t(n) * n);
+        for (int i = 0; i < n; i++) {
+            for (int k = a.row_ptr[i]; k < a.row_ptr[i + 1]; k++) {
+                dense[std::size_t(i) * n + a.col_ind[k]] += a.val[k];
+            }
+        }
+        std::vector<Float> x(n);
+        std::vector<Float> y(n);
+        for (Float& value : x) {
+            value = pre::generate_canonical<Float>(pcg) * 2 - 1;
+        }
+        SparseLinalg::gemv(a.view(), {&x[0], 1, n}, {&y[0], 1, n});
+        for (int i = 0; i < n; i++) {
+            Float expect = 0;
+            for (int j = 0; j < n; j++) {
+                expect += dense[std::size_t(i) * n + j] * x[j];
+            }
+            nmismatches +=
+                !(pre::abs(y[i] - expect) <=
+                  Float(1e-12) * (pre::abs(expect) + 1));
+        }
+    }
+
+    // Print test result.
+    std::cout << "Result: " << nmismatches << "\n\n";
+    std::cout.flush();
+}
+
+// Test conjugate gradient.
+void testCg()
+{
+    std::cout << "Testing conjugate gradient:\n";
+    std::cout << "This test solves 16 random shifted Laplacians, on grids\n";
+    std::cout << "of size up to 64x64, with the default tolerance, and\n";
+    std::cout << "computes the true relative residual. This should print\n";
+    std::cout << "1 for convergence before the iteration cap, 1 for\n";
+    std::cout << "residuals below 2 times the tolerance, and 1 for an\n";
+    std::cout << "immediate return on a zero right-hand side.\n";
+    std::cout.flush();
+
+    const Float tol = pre::sqrt(pre::numeric_limits<Float>::epsilon());
+    const int max_iters = 1000;
+    int max_iter = 0;
+    Float max_res = 0;
+    Float max_reported_res = 0;
+    for (int count = 0; count < 16; count++) {
+        const int m = 1 + int(pcg(64));
+        const int n = m * m;
+        SparseMatrix a = generateLaplacian(
+                         m, Float(0.001) + pre::generate_canonical<Float>(pcg));
+        std::vector<Float> b(n);
+        std::vector<Float> x(n);
+        for (Float& value : b) {
+            value = pre::generate_canonical<Float>(pcg) * 2 - 1;
+        }
+        Float reported_res = 0;
+        int iter = SparseLinalg::cg(
+                   a.view(), {&b[0], 1, n}, {&x[0], 1, n},
+                   tol, max_iters, &reported_res);
+
+        // True residual.
+        std::vector<Float> ax(n);
+        SparseLinalg::gemv(a.view(), {&x[0], 1, n}, {&ax[0], 1, n});
+        Float rr = 0;
+        Float bb = 0;
+        for (int i = 0; i < n; i++) {
+            rr += pre::nthpow(b[i] - ax[i], 2);
+            bb += pre::nthpow(b[i], 2);
+        }
+        max_iter = std::max(max_iter, iter);
+        max_res = std::max(max_res, pre::sqrt(rr / bb));
+        max_reported_res = std::max(max_reported_res, reported_res);
+    }
+
+    // Zero right-hand side.
+    SparseMatrix a = generateLaplacian(8, 1);
+    std::vector<Float> b(64);
+    std::vector<Float> x(64);
+    int zero_iter = SparseLinalg::cg(a.view(), {&b[0], 1, 64}, {&x[0], 1, 64});
+
+    // Print test result.
+    std::cout << "Result: " << (max_iter < max_iters) << " ";
+    std::cout << "(" << max_iter << " iterations), ";
+    std::cout << (max_res < 2 * tol && max_reported_res <= tol) << " ";
+    std::cout << "(" << max_res << "), " << (zero_iter == 0) << "\n\n";
+    std::cout.flush();
+}
+
+int main(int argc, char** argv)
+{
+    int seed = 0;
+
+    // Option parser.
+    pre::option_parser opt_parser("[OPTIONS]");
+
+    // Specify seed.
+    opt_parser.on_option(
+    "-s", "--seed", 1,
+    [&](char** argv) {
+        try {
+            seed = std::stoi(argv[0]);
+        }
+        catch (const std::exception&) {
+            throw
+                std::runtime_error(
+                std::string("-s/--seed expects 1 integer ")
+                    .append("(can't parse ").append(argv[0])
+                    .append(")"));
+        }
+    })
+    << "Specify seed. By default, random.\n";
+
+    // Display help.
+    opt_parser.on_option(
+    "-h", "--help", 0,
+    [&](char**) {
+        std::cout << opt_parser << std::endl;
+        std::exit(EXIT_SUCCESS);
+    })
+    << "Display this help and exit.\n";
+
+    try {
+        // Parse args.
+        opt_parser.parse(argc, argv);
+    }
+    catch (const std::exception& exception) {
+        std::cerr << "Unhandled exception!\n";
+        std::cerr << "exception.what(): " << exception.what() << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+
+    // Seed.
+    if (seed == 0) {
+        seed = std::random_device()();
+    }
+    std::cout << "seed = " << seed << "\n\n";
+    std::cout.flush();
+    pcg = pre::pcg32(seed);
+
+    // Matrix-vector product.
+    testGemv();
+
+    // Conjugate gradient.
+    testCg();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,242 @@
+#include <algorithm>
+#include <iostream>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <preform/static_concurrent_queue.hpp>
+#include <preform/timer.hpp>
+#include <preform/option_parser.hpp>
+
+// Single-producer single-consumer queue.
+typedef pre::static_spsc_queue<long long, 64> SpscQueue;
+
+// Multi-producer multi-consumer queue.
+typedef pre::static_mpmc_queue<long long, 64> MpmcQueue;
+
+// Timer.
+typedef pre::steady_timer Timer;
+
+// Test full and empty, and batch operations.
+template <typename Queue>
+void testFullEmpty(const char* name)
+{
+    std::cout << "Testing full and empty with " << name << ":\n";
+    std::cout << "This test pops from the empty queue, pushes 3 batches\n";
+    std::cout << "of 40 values into a queue of capacity 64, then pops 3\n";
+    std::cout << "batches of 40. This should print 0, 64, 0, 64, 0, and\n";
+    std::cout << "0 out-of-order values.\n";
+    std::cout.flush();
+
+    Queue queue;
+    long long value = 0;
+    long long vals[40];
+    bool pop_empty = queue.try_pop(value);
+
+    // Push.
+    std::size_t npushed = 0;
+    for (int batch = 0; batch < 3; batch++) {
+        for (int k = 0; k < 40; k++) {
+            vals[k] = batch * 40 + k;
+        }
+        npushed += queue.push_many(&vals[0], 40);
+    }
+    bool push_full = queue.try_push(value);
+
+    // Pop.
+    std::size_t npopped = 0;
+    long long next = 0;
+    long long mismatches = 0;
+    for (int batch = 0; batch < 3; batch++) {
+        std::size_t m = queue.pop_many(&vals[0], 40);
+        for (std::size_t k = 0; k < m; k++) {
+            mismatches += vals[k] != next++;
+        }
+        npopped += m;
+    }
+
+    // Print test result.
+    std::cout << "Result: " << pop_empty << ", " << npushed << ", ";
+    std::cout << push_full << ", " << npopped << ", ";
+    std::cout << queue.size() << ", " << mismatches << "\n\n";
+    std::cout.flush();
+}
+
+// Test single producer, single consumer ordering.
+void testSpsc(long long count)
+{
+    std::cout << "Testing single-producer single-consumer ordering:\n";
+    std::cout << "This test pushes " << count << " increasing values\n";
+    std::cout << "through the queue from one thread to another, in single\n";
+    std::cout << "and batch operations. This should print 0 out-of-order\n";
+    std::cout << "values.\n";
+    std::cout.flush();
+
+    SpscQueue queue;
+    Timer timer;
+    std::thread producer([&]() {
+        long long vals[8];
+        long long value = 0;
+        while (value < count) {
+            if (value % 3 == 0) {
+                long long n = std::min<long long>(8, count - value);
+                for (long long k = 0; k < n; k++) {
+                    vals[k] = value + k;
+                }
+                long long m = queue.push_many(&vals[0], n);
+                if (m == 0) {
+                    std::this_thread::yield(); // Full.
+                }
+                value += m;
+            }
+            else if (queue.try_push(value)) {
+                value++;
+            }
+            else {
+                std::this_thread::yield(); // Full.
+            }
+        }
+    });
+    long long next = 0;
+    long long mismatches = 0;
+    long long vals[8];
+    while (next < count) {
+        std::size_t m = queue.pop_many(&vals[0], next % 2 ? 8 : 1);
+        if (m == 0) {
+            std::this_thread::yield(); // Empty.
+        }
+        for (std::size_t k = 0; k < m; k++) {
+            mismatches += vals[k] != next++;
+        }
+    }
+    producer.join();
+
+    // Print test result.
+    std::cout << "Result: " << mismatches << " ";
+    std::cout << "(" << timer.read<std::micro>() / 1e3 << " ms)\n\n";
+    std::cout.flush();
+}
+
+// Test multiple producers, multiple consumers.
+void testMpmc(int nthreads, long long count)
+{
+    long long expect = count * (count - 1) / 2;
+    std::cout << "Testing multi-producer multi-consumer with ";
+    std::cout << nthreads << " producers and " << nthreads << " consumers:\n";
+    std::cout << "This test pushes the values in [0," << count << ")\n";
+    std::cout << "from the producers in single and batch operations. This\n";
+    std::cout << "should count to " << count << " and sum to ";
+    std::cout << expect << ".\n";
+    std::cout.flush();
+
+    MpmcQueue queue;
+    std::atomic<long long> next(0);
+    std::atomic<long long> popped(0);
+    std::atomic<long long> sum(0);
+    Timer timer;
+    std::vector<std::thread> threads;
+    for (int thread = 0; thread < nthreads; thread++) {
+        threads.emplace_back([&]() {
+            long long vals[4];
+            long long value;
+            while ((value = next.fetch_add(4)) < count) {
+                long long n = std::min<long long>(4, count - value);
+                for (long long k = 0; k < n; k++) {
+                    vals[k] = value + k;
+                }
+                long long pushed = 0;
+                while (pushed < n) {
+                    long long m = n - pushed == 1 ?
+                        queue.try_push(vals[pushed]) :
+                        queue.push_many(&vals[pushed], n - pushed);
+                    if (m == 0) {
+                        std::this_thread::yield(); // Full.
+                    }
+                    pushed += m;
+                }
+            }
+        });
+        threads.emplace_back([&]() {
+            long long vals[4];
+            long long local_sum = 0;
+            while (popped.load() < count) {
+                long long m = queue.pop_many(&vals[0], 4);
+                if (m == 0) {
+                    std::this_thread::yield(); // Empty.
+                }
+                for (long long k = 0; k < m; k++) {
+                    local_sum += vals[k];
+                }
+                popped += m;
+            }
+            sum += local_sum;
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    // Print test result.
+    std::cout << "Result: " << popped << ", " << sum << " ";
+    std::cout << "(" << timer.read<std::micro>() / 1e3 << " ms)\n\n";
+    std::cout.flush();
+}
+
+int main(int argc, char** argv)
+{
+    int nthreads = 4;
+
+    // Option parser.
+    pre::option_parser opt_parser("[OPTIONS]");
+
+    // Specify number of threads.
+    opt_parser.on_option(
+    "-n", "--nthreads", 1,
+    [&](char** argv) {
+        try {
+            nthreads = std::stoi(argv[0]);
+            if (!(nthreads >= 1 &&
+                  nthreads <= 64)) {
+                throw std::exception();
+            }
+        }
+        catch (const std::exception&) {
+            throw
+                std::runtime_error(
+                std::string("-n/--nthreads expects 1 integer in [1,64] ")
+                    .append("(can't parse ").append(argv[0])
+                    .append(")"));
+        }
+    })
+    << "Specify number of producers and consumers. By default, 4.\n";
+
+    // Display help.
+    opt_parser.on_option(
+    "-h", "--help", 0,
+    [&](char**) {
+        std::cout << opt_parser << std::endl;
+        std::exit(EXIT_SUCCESS);
+    })
+    << "Display this help and exit.\n";
+
+    try {
+        // Parse args.
+        opt_parser.parse(argc, argv);
+    }
+    catch (const std::exception& exception) {
+        std::cerr << "Unhandled exception!\n";
+        std::cerr << "exception.what(): " << exception.what() << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+
+    // Full and empty.
+    testFullEmpty<SpscQueue>("single-producer single-consumer queue");
+    testFullEmpty<MpmcQueue>("multi-producer multi-consumer queue");
+
+    // Single producer, single consumer.
+    testSpsc(1000000);
+
+    // Multiple producers, multiple consumers.
+    testMpmc(nthreads, 1000000);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,243 @@
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+#include <preform/random.hpp>
+#include <preform/multi_random.hpp>
+#include <preform/option_parser.hpp>
+#include <preform/texture_cache.hpp>
+
+// Float type.
+typedef float Float;
+
+// 2-dimensional vector.
+typedef pre::vec2<Float> Vec2f;
+
+// 3-dimensional vector.
+typedef pre::vec3<Float> Vec3f;
+
+// Image.
+typedef pre::image2<Float, Float, 3> Image2;
+
+// Texture cache.
+typedef pre::texture_cache<Float, Float, 3> TextureCache;
+
+// Permuted congruential generator.
+pre::pcg32 pcg;
+
+// Generate canonical random 2-dimensional vector.
+Vec2f generateCanonical2()
+{
+    return pre::generate_canonical<Float, 2>(pcg);
+}
+
+// Generate canonical random 3-dimensional vector.
+Vec3f generateCanonical3()
+{
+    return pre::generate_canonical<Float, 3>(pcg);
+}
+
+// Mip chain.
+std::shared_ptr<std::vector<Image2>> mips;
+
+// Initialize mip chain.
+void initMips()
+{
+    mips = std::make_shared<std::vector<Image2>>();
+    Image2 image;
+    image.resize({256, 192});
+    image.cycle_mode({+1, -1});
+    for (auto& texel : image) {
+        texel = generateCanonical3();
+    }
+    for (int level = 0; level < 5; level++) {
+        mips->push_back(image);
+        image.mip_downsample();
+    }
+}
+
+// Test lookups.
+void testLookups()
+{
+    std::cout << "Testing lookups:\n";
+    std::cout << "This test fetches and bilinearly samples 65536 random\n";
+    std::cout << "locations, partly outside the texture, on random levels\n";
+    std::cout << "of a texture of 16x16 tiles with a budget of 30000\n";
+    std::cout << "bytes, then compares against the mip chain. This should\n";
+    std::cout << "print 0 mismatches, and 0 lookups leaving more than the\n";
+    std::cout << "budget resident.\n";
+    std::cout.flush();
+
+    TextureCache cache(30000, 16);
+    std::size_t tex = cache.add_texture(mips, {+1, -1});
+    int nmismatches = 0;
+    int nover_budget = 0;
+    std::size_t max_bytes = 0;
+    for (int k = 0; k < 65536; k++) {
+        int level = pcg(5);
+        const Image2& mip = (*mips)[level];
+        Vec2f uv = generateCanonical2() * Float(1.5) - Float(0.25);
+        Vec2f loc = uv * Vec2f(mip.user_size());
+        if (k % 2 == 0) {
+            pre::vec2<int> ind = pre::fastfloor(loc);
+            nmismatches +=
+                !(cache.fetch(tex, level, ind) ==
+                  mip.sample0(loc)).all();
+        }
+        else {
+            nmismatches +=
+                (pre::abs(
+                 cache.sample_bilinear(tex, level, uv) -
+                 mip.sample1(loc)) > Float(1e-5)).any();
+        }
+        nover_budget += cache.bytes_used() > 30000;
+        max_bytes = std::max(max_bytes, cache.bytes_used());
+    }
+
+    // Print test result.
+    std::cout << "Result: " << nmismatches << ", " << nover_budget << " ";
+    std::cout << "(" << max_bytes << " bytes at most, ";
+    std::cout << cache.hits() << " hits, " << cache.misses() << " misses, ";
+    std::cout << cache.evictions() << " evictions)\n\n";
+    std::cout.flush();
+}
+
+// Test concurrent lookups.
+void testConcurrent(int nthreads)
+{
+    std::cout << "Testing concurrent lookups:\n";
+    std::cout << "This test samples trilinearly from " << nthreads;
+    std::cout << " threads at once,\n";
+    std::cout << "each with 65536 random locations, with a budget of\n";
+    std::cout << "30000 bytes, then compares against single-threaded\n";
+    std::cout << "lookups. This should print 0 mismatches, and 1 for\n";
+    std::cout << "never exceeding the budget by more than one 3072-byte\n";
+    std::cout << "tile per thread.\n";
+    std::cout.flush();
+
+    TextureCache cache(30000, 16);
+    TextureCache reference_cache(1 << 24, 16);
+    std::size_t tex = cache.add_texture(mips, {+1, -1});
+    reference_cache.add_texture(mips, {+1, -1});
+    std::vector<std::pair<Vec2f, Float>> lookups(65536);
+    for (auto& [uv, lod] : lookups) {
+        uv = generateCanonical2();
+        lod = pre::generate_canonical<Float>(pcg) * 5;
+    }
+    std::atomic<int> nmismatches(0);
+    std::atomic<std::size_t> max_bytes(0);
+    std::vector<std::thread> threads;
+    for (int thread = 0; thread < nthreads; thread++) {
+        threads.emplace_back([&]() {
+            for (const auto& [uv, lod] : lookups) {
+                nmismatches +=
+                    !(cache.sample_trilinear(tex, uv, lod) ==
+                      reference_cache.sample_trilinear(tex, uv, lod)).all();
+                std::size_t bytes = cache.bytes_used();
+                std::size_t prev = max_bytes;
+                while (prev < bytes &&
+                      !max_bytes.compare_exchange_weak(prev, bytes)) {
+                }
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    // Print test result.
+    std::size_t max_over = max_bytes > 30000 ? max_bytes - 30000 : 0;
+    std::cout << "Result: " << nmismatches << ", ";
+    std::cout << (max_over <= std::size_t(nthreads) * 3072) << " ";
+    std::cout << "(" << max_over << " bytes over at most, ";
+    std::cout << cache.bytes_used() << " bytes at end)\n\n";
+    std::cout.flush();
+}
+
+int main(int argc, char** argv)
+{
+    int seed = 0;
+    int nthreads = 4;
+
+    // Option parser.
+    pre::option_parser opt_parser("[OPTIONS]");
+
+    // Specify seed.
+    opt_parser.on_option(
+    "-s", "--seed", 1,
+    [&](char** argv) {
+        try {
+            seed = std::stoi(argv[0]);
+        }
+        catch (const std::exception&) {
+            throw
+                std::runtime_error(
+                std::string("-s/--seed expects 1 integer ")
+                    .append("(can't parse ").append(argv[0])
+                    .append(")"));
+        }
+    })
+    << "Specify seed. By default, random.\n";
+
+    // Specify number of threads.
+    opt_parser.on_option(
+    "-n", "--nthreads", 1,
+    [&](char** argv) {
+        try {
+            nthreads = std::stoi(argv[0]);
+            if (!(nthreads >= 1 &&
+                  nthreads <= 64)) {
+                throw std::exception();
+            }
+        }
+        catch (const std::exception&) {
+            throw
+                std::runtime_error(
+                std::string("-n/--nthreads expects 1 integer in [1,64] ")
+                    .append("(can't parse ").append(argv[0])
+                    .append(")"));
+        }
+    })
+    << "Specify number of threads. By default, 4.\n";
+
+    // Display help.
+    opt_parser.on_option(
+    "-h", "--help", 0,
+    [&](char**) {
+        std::cout << opt_parser << std::endl;
+        std::exit(EXIT_SUCCESS);
+    })
+    << "Display this help and exit.\n";
+
+    try {
+        // Parse args.
+        opt_parser.parse(argc, argv);
+    }
+    catch (const std::exception& exception) {
+        std::cerr << "Unhandled exception!\n";
+        std::cerr << "exception.what(): " << exception.what() << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+
+    // Seed.
+    if (seed == 0) {
+        seed = std::random_device()();
+    }
+    std::cout << "seed = " << seed << "\n\n";
+    std::cout.flush();
+    pcg = pre::pcg32(seed);
+
+    // Mip chain.
+    initMips();
+
+    // Lookups.
+    testLookups();
+
+    // Concurrent lookups.
+    testConcurrent(nthreads);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,392 @@
+#include <iostream>
+#include <atomic>
+#include <stdexcept>
+#include <preform/thread_pool.hpp>
+#include <preform/timer.hpp>
+#include <preform/option_parser.hpp>
+
+// Thread pool.
+typedef pre::thread_pool ThreadPool;
+
+// Thread pool mode.
+typedef pre::thread_pool_mode ThreadPoolMode;
+
+// Thread pool affinity.
+typedef pre::thread_pool_affinity ThreadPoolAffinity;
+
+// Task group.
+typedef pre::task_group TaskGroup;
+
+// Timer.
+typedef pre::steady_timer Timer;
+
+// Test mode.
+void testMode(const char* name, ThreadPoolMode mode, int nthreads)
+{
+    std::cout << "Testing " << name << ":\n";
+    std::cout << "This test submits 64 tasks, each of which submits 256\n";
+    std::cout << "sub-tasks from inside the pool. This should count to\n";
+    std::cout << "16384.\n";
+    std::cout.flush();
+
+    // Thread pool.
+    ThreadPool thread_pool(nthreads, mode);
+
+    // Counter.
+    std::atomic<int> counter(0);
+
+    // Execute.
+    Timer timer;
+    std::future<void> results[64];
+    for (int j = 0; j < 64; j++) {
+        results[j] =
+        thread_pool.submit([&]() {
+            std::future<void> sub_results[256];
+            for (int k = 0; k < 256; k++) {
+                sub_results[k] =
+                thread_pool.submit([&]() {
+                    counter++;
+                });
+            }
+            // Don't block inside the pool, just let the sub-tasks
+            // run eventually.
+        });
+    }
+    for (int j = 0; j < 64; j++) {
+        results[j].wait();
+    }
+    while (counter < 16384) {
+        std::this_thread::yield();
+    }
+
+    // Print test result.
+    std::cout << "Result: " << counter << " ";
+    std::cout << "(" << timer.read<std::micro>() / 1e3 << " ms)\n\n";
+    std::cout.flush();
+}
+
+// Test parallel for and parallel reduce.
+void testParallel(const char* name, ThreadPoolMode mode, int nthreads)
+{
+    std::cout << "Testing parallel for and parallel reduce with " << name;
+    std::cout << ":\n";
+    std::cout << "This test runs a 256 by 256 nested parallel for, then\n";
+    std::cout << "reduces the sum of indices in [0,1048576). These should\n";
+    std::cout << "count to 65536 and sum to 549755289600.\n";
+    std::cout.flush();
+
+    // Thread pool.
+    ThreadPool thread_pool(nthreads, mode);
+
+    // Counter.
+    std::atomic<int> counter(0);
+
+    // Execute nested parallel for.
+    Timer timer;
+    thread_pool.parallel_for(0, 256, 4, [&](int) {
+        thread_pool.parallel_for(0, 256, 16, [&](int) {
+            counter++;
+        });
+    });
+
+    // Execute parallel reduce.
+    long long sum =
+    thread_pool.parallel_reduce(
+        0LL, 1048576LL, 0LL,
+        [](long long index) { return index; },
+        [](long long lhs, long long rhs) { return lhs + rhs; });
+
+    // Print test result.
+    std::cout << "Result: " << counter << ", " << sum << " ";
+    std::cout << "(" << timer.read<std::micro>() / 1e3 << " ms)\n\n";
+    std::cout.flush();
+}
+
+// Test enqueue.
+void testEnqueue(int nthreads)
+{
+    std::cout << "Testing enqueue:\n";
+    std::cout << "This test enqueues 65536 fire-and-forget tasks and\n";
+    std::cout << "65536 tasks with futures. These should count to 65536 and\n";
+    std::cout << "sum to 2147450880.\n";
+    std::cout.flush();
+
+    // Thread pool.
+    ThreadPool thread_pool(nthreads, ThreadPoolMode::work_stealing);
+
+    // Counter.
+    std::atomic<int> counter(0);
+
+    // Execute.
+    Timer timer;
+    for (int k = 0; k < 65536; k++) {
+        thread_pool.enqueue([&]() {
+            counter++;
+        });
+    }
+    std::vector<std::future<long long>> results;
+    results.reserve(65536);
+    for (int k = 0; k < 65536; k++) {
+        results.emplace_back(
+        thread_pool.enqueue_future([](long long index) {
+            return index;
+        }, k));
+    }
+    long long sum = 0;
+    for (std::future<long long>& result : results) {
+        sum += result.get();
+    }
+    while (counter < 65536) {
+        std::this_thread::yield();
+    }
+
+    // Print test result.
+    std::cout << "Result: " << counter << ", " << sum << " ";
+    std::cout << "(" << timer.read<std::micro>() / 1e3 << " ms)\n\n";
+    std::cout.flush();
+}
+
+// Fibonacci number, with nested task groups.
+long long fibonacci(ThreadPool& thread_pool, int n)
+{
+    if (n < 16) {
+        return n < 2 ? n :
+            fibonacci(thread_pool, n - 1) +
+            fibonacci(thread_pool, n - 2);
+    }
+    long long fib1 = 0;
+    long long fib2 = 0;
+    TaskGroup group(thread_pool);
+    group.run([&]() { fib1 = fibonacci(thread_pool, n - 1); });
+    group.run([&]() { fib2 = fibonacci(thread_pool, n - 2); });
+    group.wait();
+    return fib1 + fib2;
+}
+
+// Test task group.
+void testTaskGroup(const char* name, ThreadPoolMode mode, int nthreads)
+{
+    std::cout << "Testing task group with " << name << ":\n";
+    std::cout << "This test computes the 30th Fibonacci number with\n";
+    std::cout << "nested task groups, which wait inside the pool. This\n";
+    std::cout << "should be 832040.\n";
+    std::cout.flush();
+
+    // Thread pool.
+    ThreadPool thread_pool(nthreads, mode);
+
+    // Execute.
+    Timer timer;
+    long long fib = 0;
+    TaskGroup group(thread_pool);
+    group.run([&]() { fib = fibonacci(thread_pool, 30); });
+    group.wait();
+
+    // Print test result.
+    std::cout << "Result: " << fib << " ";
+    std::cout << "(" << timer.read<std::micro>() / 1e3 << " ms)\n\n";
+    std::cout.flush();
+}
+
+// Test exceptions.
+void testExceptions(const char* name, ThreadPoolMode mode, int nthreads)
+{
+    std::cout << "Testing exceptions with " << name << ":\n";
+    std::cout << "This test throws from 256 fire-and-forget tasks, while\n";
+    std::cout << "the calling thread helps in a parallel for and a task\n";
+    std::cout << "group that also throw, then throws from a task with a\n";
+    std::cout << "future. This should catch 4 exceptions, and count to\n";
+    std::cout << "4096 and 64.\n";
+    std::cout.flush();
+
+    // Thread pool.
+    ThreadPool thread_pool(nthreads, mode);
+    int caught = 0;
+
+    // Fire-and-forget.
+    std::atomic<int> finished(0);
+    for (int k = 0; k < 256; k++) {
+        thread_pool.enqueue([&]() {
+            finished++;
+            throw std::runtime_error("enqueue");
+        });
+    }
+
+    // Parallel for, helping with fire-and-forget tasks.
+    std::atomic<int> counter(0);
+    try {
+        thread_pool.parallel_for(0, 4096, 16, [&](int index) {
+            counter++;
+            if (index == 1007) { // Last in its chunk.
+                throw std::runtime_error("parallel_for");
+            }
+        });
+    }
+    catch (const std::runtime_error&) {
+        caught++;
+    }
+
+    // Task group.
+    std::atomic<int> group_counter(0);
+    try {
+        TaskGroup group(thread_pool);
+        for (int k = 0; k < 64; k++) {
+            group.run([&](int index) {
+                group_counter++;
+                if (index % 8 == 0) {
+                    throw std::runtime_error("task_group");
+                }
+            }, k);
+        }
+        group.wait();
+    }
+    catch (const std::runtime_error&) {
+        caught++;
+    }
+
+    // Future.
+    std::future<int> future =
+        thread_pool.submit([]() -> int {
+            throw std::runtime_error("submit");
+        });
+    try {
+        future.get();
+    }
+    catch (const std::runtime_error&) {
+        caught++;
+    }
+
+    // Fire-and-forget, once all have finished.
+    while (finished < 256) {
+        std::this_thread::yield();
+    }
+    thread_pool.shutdown();
+    try {
+        thread_pool.rethrow_if_exception();
+    }
+    catch (const std::runtime_error&) {
+        caught++;
+    }
+
+    // Print test result.
+    std::cout << "Result: " << caught << ", ";
+    std::cout << counter << ", " << group_counter << "\n\n";
+    std::cout.flush();
+}
+
+// Test affinity.
+void testAffinity(const char* name, ThreadPoolAffinity affinity, int nthreads)
+{
+    std::cout << "Testing " << name << " affinity:\n";
+    std::cout << "This test submits 1024 tasks to each node, each of\n";
+    std::cout << "which allocates from the worker arena. This should\n";
+    std::cout << "count to 1024 per node.\n";
+    std::cout.flush();
+
+    // Thread pool.
+    ThreadPool thread_pool(nthreads, ThreadPoolMode::work_stealing, affinity);
+
+    // Execute.
+    Timer timer;
+    std::size_t node_count = thread_pool.node_count();
+    for (std::size_t node = 0; node < node_count; node++) {
+        std::atomic<int> counter(0);
+        TaskGroup group(thread_pool);
+        for (int k = 0; k < 1024; k++) {
+            thread_pool.enqueue_to_node(node, [&]() {
+                int* value =
+                    static_cast<int*>(
+                    ThreadPool::local_arena().allocate(sizeof(int)));
+                *value = 1;
+                counter += *value;
+            });
+        }
+        group.run([&]() {
+            while (counter < 1024) {
+                std::this_thread::yield();
+            }
+        });
+        group.wait();
+
+        // Print test result.
+        std::cout << "Result, node " << node << ": " << counter << "\n";
+    }
+    std::cout << "(" << node_count << " nodes, ";
+    std::cout << timer.read<std::micro>() / 1e3 << " ms)\n\n";
+    std::cout.flush();
+}
+
+int main(int argc, char** argv)
+{
+    int nthreads = 8;
+
+    // Option parser.
+    pre::option_parser opt_parser("[OPTIONS]");
+
+    // Specify number of threads.
+    opt_parser.on_option(
+    "-n", "--nthreads", 1,
+    [&](char** argv) {
+        try {
+            nthreads = std::stoi(argv[0]);
+            if (!(nthreads >= 1 &&
+                  nthreads <= 64)) {
+                throw std::exception();
+            }
+        }
+        catch (const std::exception&) {
+            throw
+                std::runtime_error(
+                std::string("-n/--nthreads expects 1 integer in [1,64] ")
+                    .append("(can't parse ").append(argv[0])
+                    .append(")"));
+        }
+    })
+    << "Specify number of threads. By default, 8.\n";
+
+    // Display help.
+    opt_parser.on_option(
+    "-h", "--help", 0,
+    [&](char**) {
+        std::cout << opt_parser << std::endl;
+        std::exit(EXIT_SUCCESS);
+    })
+    << "Display this help and exit.\n";
+
+    try {
+        // Parse args.
+        opt_parser.parse(argc, argv);
+    }
+    catch (const std::exception& exception) {
+        std::cerr << "Unhandled exception!\n";
+        std::cerr << "exception.what(): " << exception.what() << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+
+    // Shared queue.
+    testMode("shared queue", ThreadPoolMode::shared_queue, nthreads);
+
+    // Work stealing.
+    testMode("work stealing", ThreadPoolMode::work_stealing, nthreads);
+
+    // Parallel for and parallel reduce.
+    testParallel("shared queue", ThreadPoolMode::shared_queue, nthreads);
+    testParallel("work stealing", ThreadPoolMode::work_stealing, nthreads);
+
+    // Enqueue.
+    testEnqueue(nthreads);
+
+    // Task group.
+    testTaskGroup("shared queue", ThreadPoolMode::shared_queue, nthreads);
+    testTaskGroup("work stealing", ThreadPoolMode::work_stealing, nthreads);
+
+    // Exceptions.
+    testExceptions("shared queue", ThreadPoolMode::shared_queue, nthreads);
+    testExceptions("work stealing", ThreadPoolMode::work_stealing, nthreads);
+
+    // Affinity.
+    testAffinity("core", ThreadPoolAffinity::core, nthreads);
+    testAffinity("NUMA node", ThreadPoolAffinity::numa_node, nthreads);
+
+    return EXIT_SUCCESS;
+}